@@ -12,12 +12,15 @@
 
 #include <arrows/ceres/bundle_adjust.h>
 
+#include <arrows/mvg/algo/partitioned_bundle_adjust.h>
 #include <arrows/mvg/metrics.h>
 #include <arrows/mvg/projected_track_set.h>
 
 #include <vital/plugin_loader/plugin_manager.h>
 #include <vital/math_constants.h>
 
+#include <cstdlib>
+
 using namespace kwiver::vital;
 using namespace kwiver::arrows;
 using namespace kwiver::arrows::mvg;
@@ -702,3 +705,90 @@ TEST(bundle_adjust, minimum_hfov)
   cameras = std::make_shared<simple_camera_map>(cams);
   test_ba_min_hfov(cameras, cfg, 1000.0);
 }
+
+// ----------------------------------------------------------------------------
+// Keep only the observations of each landmark from a window of nearby
+// frames, as in a long sequence where landmarks leave the view
+static feature_track_set_sptr
+windowed_tracks(feature_track_set_sptr tracks, frame_id_t num_frames,
+                frame_id_t half_width)
+{
+  std::vector<track_sptr> windowed;
+  auto const all = tracks->tracks();
+  for (size_t i = 0; i < all.size(); ++i)
+  {
+    auto const center = static_cast<frame_id_t>(i * num_frames / all.size());
+    auto trk = track::create();
+    trk->set_id(all[i]->id());
+    for (auto const& ts : *all[i])
+    {
+      if (std::abs(ts->frame() - center) <= half_width)
+      {
+        trk->append(ts->clone());
+      }
+    }
+    windowed.push_back(trk);
+  }
+  return std::make_shared<feature_track_set>(windowed);
+}
+
+// ----------------------------------------------------------------------------
+// Partitioned bundle adjustment with Ceres solving the submaps should reach
+// nearly the reprojection error of solving the whole problem at once
+TEST(bundle_adjust, partitioned_matches_full)
+{
+  plugin_manager::instance().load_all_plugins();
+
+  landmark_map_sptr landmarks = kwiver::testing::init_landmarks(300);
+  camera_map_sptr cameras = kwiver::testing::camera_seq(60);
+  feature_track_set_sptr tracks = kwiver::testing::noisy_tracks(
+    windowed_tracks(projected_tracks(landmarks, cameras), 60, 3), 0.5);
+
+  landmark_map_sptr landmarks0 =
+    kwiver::testing::noisy_landmarks(landmarks, 0.1);
+  camera_map_sptr cameras0 = kwiver::testing::noisy_cameras(cameras, 0.1, 0.1);
+
+  double init_rmse = reprojection_rmse(cameras0->cameras(),
+                                       landmarks0->landmarks(),
+                                       tracks->tracks());
+  std::cout << "initial reprojection RMSE: " << init_rmse << std::endl;
+  EXPECT_GE(init_rmse, 10.0)
+    << "Initial reprojection RMSE should be large before SBA";
+
+  // solve the whole problem
+  camera_map_sptr full_cameras = cameras0;
+  landmark_map_sptr full_landmarks = landmarks0;
+  ceres::bundle_adjust ba;
+  config_block_sptr cfg = ba.get_configuration();
+  cfg->set_value("max_num_iterations", 100);
+  ba.set_configuration(cfg);
+  ba.optimize(full_cameras, full_landmarks, tracks);
+
+  double full_rmse = reprojection_rmse(full_cameras->cameras(),
+                                       full_landmarks->landmarks(),
+                                       tracks->tracks());
+  std::cout << "full reprojection RMSE: " << full_rmse << std::endl;
+
+  // solve the problem as three submaps and a separator pass
+  camera_map_sptr part_cameras = cameras0;
+  landmark_map_sptr part_landmarks = landmarks0;
+  mvg::partitioned_bundle_adjust pba;
+  config_block_sptr pcfg = pba.get_configuration();
+  pcfg->set_value("max_submap_cameras", 20);
+  pcfg->set_value("overlap_cameras", 5);
+  pcfg->set_value("sba_impl:type", "ceres");
+  pcfg->set_value("sba_impl:ceres:max_num_iterations", 100);
+  pba.set_configuration(pcfg);
+  ASSERT_TRUE(pba.check_configuration(pba.get_configuration()));
+  pba.optimize(part_cameras, part_landmarks, tracks);
+
+  ASSERT_EQ(cameras0->size(), part_cameras->size());
+  ASSERT_EQ(landmarks0->size(), part_landmarks->size());
+
+  double part_rmse = reprojection_rmse(part_cameras->cameras(),
+                                       part_landmarks->landmarks(),
+                                       tracks->tracks());
+  std::cout << "partitioned reprojection RMSE: " << part_rmse << std::endl;
+  EXPECT_LE(part_rmse, 1.25 * full_rmse)
+    << "Partitioned RMSE should be close to the full solution";
+}
@@ -0,0 +1,671 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Implementation of the binary object store file format
+ */
+
+#include "binary_object_store.h"
+
+#include <arrows/core/mapped_file.h>
+
+#include <vital/exceptions/base.h>
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+namespace {
+
+/*
+ * File layout
+ *
+ * The file starts with a fixed size header followed by the sections
+ * listed below. Each section is an array of one fixed size type and
+ * starts on an 8 byte boundary; the header gives the offset of each.
+ *
+ *  frame index    frame number, time, name and first record of each frame
+ *  records        track id, bounding box, confidence and first class
+ *                 score of each record
+ *  class scores   class name and score of each entry
+ *  strings        offsets into, and the bytes of, the string table
+ *
+ * The first-record and first-score arrays have one extra entry holding
+ * the total count, so the records of frame i are [first[i], first[i+1]).
+ */
+
+char const file_magic[ 8 ] = { 'K', 'W', 'V', 'R', 'O', 'B', 'J', 0 };
+uint32_t const file_version = 1;
+uint32_t const byte_order_mark = 0x01020304;
+uint32_t const no_string = 0xFFFFFFFF;
+
+enum section_id
+{
+  FRAME_ID = 0,   // int64 [num_frames]
+  FRAME_TIME,     // int64 [num_frames]
+  FRAME_NAME,     // uint32 [num_frames], string index or no_string
+  FRAME_FIRST,    // uint64 [num_frames + 1]
+  TRACK_ID,       // int64 [num_records]
+  MIN_X,          // double [num_records]
+  MIN_Y,          // double [num_records]
+  MAX_X,          // double [num_records]
+  MAX_Y,          // double [num_records]
+  CONFIDENCE,     // double [num_records]
+  CLASS_FIRST,    // uint64 [num_records + 1]
+  CLASS_NAME,     // uint32 [num_scores]
+  CLASS_SCORE,    // double [num_scores]
+  STRING_OFFSET,  // uint64 [num_strings + 1]
+  STRING_DATA,    // char [string_bytes]
+  NUM_SECTIONS
+};
+
+struct file_header
+{
+  char magic[ 8 ];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t kind;
+  uint32_t reserved;
+  uint64_t num_frames;
+  uint64_t num_records;
+  uint64_t num_scores;
+  uint64_t num_strings;
+  uint64_t string_bytes;
+  uint64_t section[ NUM_SECTIONS ];
+};
+
+// ----------------------------------------------------------------------------
+uint64_t
+align8( uint64_t n )
+{
+  return ( n + 7 ) & ~uint64_t( 7 );
+}
+
+// ----------------------------------------------------------------------------
+/// Number of bytes in each section for the counts in \p h
+void
+section_sizes( file_header const& h, uint64_t sizes[ NUM_SECTIONS ] )
+{
+  sizes[ FRAME_ID ] = h.num_frames * sizeof( int64_t );
+  sizes[ FRAME_TIME ] = h.num_frames * sizeof( int64_t );
+  sizes[ FRAME_NAME ] = h.num_frames * sizeof( uint32_t );
+  sizes[ FRAME_FIRST ] = ( h.num_frames + 1 ) * sizeof( uint64_t );
+  sizes[ TRACK_ID ] = h.num_records * sizeof( int64_t );
+  sizes[ MIN_X ] = h.num_records * sizeof( double );
+  sizes[ MIN_Y ] = h.num_records * sizeof( double );
+  sizes[ MAX_X ] = h.num_records * sizeof( double );
+  sizes[ MAX_Y ] = h.num_records * sizeof( double );
+  sizes[ CONFIDENCE ] = h.num_records * sizeof( double );
+  sizes[ CLASS_FIRST ] = ( h.num_records + 1 ) * sizeof( uint64_t );
+  sizes[ CLASS_NAME ] = h.num_scores * sizeof( uint32_t );
+  sizes[ CLASS_SCORE ] = h.num_scores * sizeof( double );
+  sizes[ STRING_OFFSET ] = ( h.num_strings + 1 ) * sizeof( uint64_t );
+  sizes[ STRING_DATA ] = h.string_bytes;
+}
+
+// ----------------------------------------------------------------------------
+template < typename T >
+void
+write_section( std::ostream& os, std::vector< T > const& v )
+{
+  os.write( reinterpret_cast< char const* >( v.data() ),
+            static_cast< std::streamsize >( v.size() * sizeof( T ) ) );
+
+  // pad to an 8 byte boundary
+  char const pad[ 8 ] = { 0 };
+  auto const n = v.size() * sizeof( T );
+  os.write( pad, static_cast< std::streamsize >( align8( n ) - n ) );
+}
+
+} // end namespace
+
+// ============================================================================
+class binary_object_store_writer::priv
+{
+public:
+  explicit priv( binary_object_store_kind k ) : kind( k ) {}
+
+  uint32_t intern( std::string const& s );
+
+  binary_object_store_kind kind;
+
+  std::vector< int64_t > frame_id;
+  std::vector< int64_t > frame_time;
+  std::vector< uint32_t > frame_name;
+  std::vector< uint64_t > frame_first;
+
+  std::vector< int64_t > track_id;
+  std::vector< double > min_x;
+  std::vector< double > min_y;
+  std::vector< double > max_x;
+  std::vector< double > max_y;
+  std::vector< double > confidence;
+  std::vector< uint64_t > class_first;
+
+  std::vector< uint32_t > class_name;
+  std::vector< double > class_score;
+
+  std::unordered_map< std::string, uint32_t > string_index;
+  std::vector< uint64_t > string_offset;
+  std::vector< char > string_data;
+};
+
+// ----------------------------------------------------------------------------
+uint32_t
+binary_object_store_writer::priv
+::intern( std::string const& s )
+{
+  auto const it = string_index.find( s );
+  if( it != string_index.end() )
+  {
+    return it->second;
+  }
+
+  auto const index = static_cast< uint32_t >( string_offset.size() );
+  string_index.emplace( s, index );
+  string_offset.push_back( string_data.size() );
+  string_data.insert( string_data.end(), s.begin(), s.end() );
+  return index;
+}
+
+// ----------------------------------------------------------------------------
+binary_object_store_writer
+::binary_object_store_writer( binary_object_store_kind kind )
+  : d( new priv( kind ) )
+{
+}
+
+binary_object_store_writer
+::~binary_object_store_writer()
+{
+}
+
+// ----------------------------------------------------------------------------
+void
+binary_object_store_writer
+::add_frame( vital::frame_id_t frame, vital::time_usec_t time,
+             std::string const& name )
+{
+  if( !d->frame_id.empty() && frame <= d->frame_id.back() )
+  {
+    VITAL_THROW( vital::invalid_value,
+                 "frames must be added in increasing order; frame "
+                 + std::to_string( frame ) + " follows frame "
+                 + std::to_string( d->frame_id.back() ) );
+  }
+
+  d->frame_id.push_back( frame );
+  d->frame_time.push_back( time );
+  d->frame_name.push_back( name.empty() ? no_string : d->intern( name ) );
+  d->frame_first.push_back( d->track_id.size() );
+}
+
+// ----------------------------------------------------------------------------
+void
+binary_object_store_writer
+::add_record( vital::track_id_t track_id, vital::detected_object const& det )
+{
+  if( d->frame_id.empty() )
+  {
+    VITAL_THROW( vital::invalid_value, "record added before any frame" );
+  }
+
+  auto const& bbox = det.bounding_box();
+  d->track_id.push_back( track_id );
+  d->min_x.push_back( bbox.min_x() );
+  d->min_y.push_back( bbox.min_y() );
+  d->max_x.push_back( bbox.max_x() );
+  d->max_y.push_back( bbox.max_y() );
+  d->confidence.push_back( det.confidence() );
+  d->class_first.push_back( d->class_name.size() );
+
+  if( auto const dot = det.type() )
+  {
+    for( auto const& score : *dot )
+    {
+      d->class_name.push_back( d->intern( *score.first ) );
+      d->class_score.push_back( score.second );
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+size_t
+binary_object_store_writer
+::num_frames() const
+{
+  return d->frame_id.size();
+}
+
+// ----------------------------------------------------------------------------
+size_t
+binary_object_store_writer
+::num_records() const
+{
+  return d->track_id.size();
+}
+
+// ----------------------------------------------------------------------------
+void
+binary_object_store_writer
+::write( std::ostream& os ) const
+{
+  file_header h;
+  std::memset( &h, 0, sizeof( h ) );
+  std::memcpy( h.magic, file_magic, sizeof( file_magic ) );
+  h.version = file_version;
+  h.byte_order = byte_order_mark;
+  h.kind = static_cast< uint32_t >( d->kind );
+  h.num_frames = d->frame_id.size();
+  h.num_records = d->track_id.size();
+  h.num_scores = d->class_name.size();
+  h.num_strings = d->string_offset.size();
+  h.string_bytes = d->string_data.size();
+
+  uint64_t sizes[ NUM_SECTIONS ];
+  section_sizes( h, sizes );
+  uint64_t offset = align8( sizeof( h ) );
+  for( int s = 0; s < NUM_SECTIONS; ++s )
+  {
+    h.section[ s ] = offset;
+    offset += align8( sizes[ s ] );
+  }
+
+  // the first-entry arrays carry the totals as an extra entry
+  auto frame_first = d->frame_first;
+  frame_first.push_back( h.num_records );
+  auto class_first = d->class_first;
+  class_first.push_back( h.num_scores );
+  auto string_offset = d->string_offset;
+  string_offset.push_back( h.string_bytes );
+
+  char const pad[ 8 ] = { 0 };
+  os.write( reinterpret_cast< char const* >( &h ), sizeof( h ) );
+  os.write( pad, static_cast< std::streamsize >( align8( sizeof( h ) ) - sizeof( h ) ) );
+
+  write_section( os, d->frame_id );
+  write_section( os, d->frame_time );
+  write_section( os, d->frame_name );
+  write_section( os, frame_first );
+  write_section( os, d->track_id );
+  write_section( os, d->min_x );
+  write_section( os, d->min_y );
+  write_section( os, d->max_x );
+  write_section( os, d->max_y );
+  write_section( os, d->confidence );
+  write_section( os, class_first );
+  write_section( os, d->class_name );
+  write_section( os, d->class_score );
+  write_section( os, string_offset );
+  write_section( os, d->string_data );
+
+  if( !os )
+  {
+    VITAL_THROW( vital::file_write_exception, "<stream>",
+                 "failed writing binary object store" );
+  }
+}
+
+// ----------------------------------------------------------------------------
+void
+binary_object_store_writer
+::clear()
+{
+  d.reset( new priv( d->kind ) );
+}
+
+// ============================================================================
+class binary_object_store_reader::priv
+{
+public:
+  priv() { reset(); }
+  ~priv() { unmap(); }
+
+  void reset();
+  void unmap();
+  void parse( std::string const& source );
+
+  template < typename T >
+  T const* section( section_id s ) const
+  {
+    return reinterpret_cast< T const* >( base + header.section[ s ] );
+  }
+
+  std::string string_at( uint32_t index ) const
+  {
+    if( index == no_string || index >= header.num_strings )
+    {
+      return std::string();
+    }
+    return std::string( strings + string_offset[ index ],
+                        strings + string_offset[ index + 1 ] );
+  }
+
+  // the mapped file, or the memory holding a loaded stream
+  char const* base;
+  uint64_t size;
+  mapped_file file;
+  std::vector< uint64_t > buffer;
+
+  file_header header;
+
+  int64_t const* frame_id;
+  int64_t const* frame_time;
+  uint32_t const* frame_name;
+  uint64_t const* frame_first;
+  int64_t const* track_id;
+  double const* min_x;
+  double const* min_y;
+  double const* max_x;
+  double const* max_y;
+  double const* confidence;
+  uint64_t const* class_first;
+  uint32_t const* class_name;
+  double const* class_score;
+  uint64_t const* string_offset;
+  char const* strings;
+};
+
+// ----------------------------------------------------------------------------
+void
+binary_object_store_reader::priv
+::reset()
+{
+  base = nullptr;
+  size = 0;
+  std::memset( &header, 0, sizeof( header ) );
+}
+
+// ----------------------------------------------------------------------------
+void
+binary_object_store_reader::priv
+::unmap()
+{
+  file.close();
+  buffer.clear();
+  reset();
+}
+
+// ----------------------------------------------------------------------------
+void
+binary_object_store_reader::priv
+::parse( std::string const& source )
+{
+  if( size < sizeof( file_header ) )
+  {
+    VITAL_THROW( vital::invalid_data,
+                 "too small to be a binary object store: " + source );
+  }
+
+  std::memcpy( &header, base, sizeof( header ) );
+  if( std::memcmp( header.magic, file_magic, sizeof( file_magic ) ) != 0 )
+  {
+    VITAL_THROW( vital::invalid_data,
+                 "not a binary object store: " + source );
+  }
+  if( header.byte_order != byte_order_mark )
+  {
+    VITAL_THROW( vital::invalid_data,
+                 "binary object store was written with a different byte order: "
+                 + source );
+  }
+  if( header.version != file_version )
+  {
+    VITAL_THROW( vital::invalid_data,
+                 "unsupported binary object store version "
+                 + std::to_string( header.version ) + ": " + source );
+  }
+
+  // bound each count by the bytes after the header before computing the
+  // section sizes, so that a corrupt count cannot overflow them
+  uint64_t const available = size - sizeof( file_header );
+  if( header.num_frames > available / sizeof( int64_t ) ||
+      header.num_records > available / sizeof( double ) ||
+      header.num_scores > available / sizeof( uint32_t ) ||
+      header.num_strings > available / sizeof( uint64_t ) ||
+      header.string_bytes > available )
+  {
+    VITAL_THROW( vital::invalid_data,
+                 "truncated or corrupt binary object store: " + source );
+  }
+
+  // every section must lie inside the file
+  uint64_t sizes[ NUM_SECTIONS ];
+  section_sizes( header, sizes );
+  for( int s = 0; s < NUM_SECTIONS; ++s )
+  {
+    if( header.section[ s ] % 8 != 0 ||
+        header.section[ s ] > size ||
+        sizes[ s ] > size - header.section[ s ] )
+    {
+      VITAL_THROW( vital::invalid_data,
+                   "truncated or corrupt binary object store: " + source );
+    }
+  }
+
+  frame_id = section< int64_t >( FRAME_ID );
+  frame_time = section< int64_t >( FRAME_TIME );
+  frame_name = section< uint32_t >( FRAME_NAME );
+  frame_first = section< uint64_t >( FRAME_FIRST );
+  track_id = section< int64_t >( TRACK_ID );
+  min_x = section< double >( MIN_X );
+  min_y = section< double >( MIN_Y );
+  max_x = section< double >( MAX_X );
+  max_y = section< double >( MAX_Y );
+  confidence = section< double >( CONFIDENCE );
+  class_first = section< uint64_t >( CLASS_FIRST );
+  class_name = section< uint32_t >( CLASS_NAME );
+  class_score = section< double >( CLASS_SCORE );
+  string_offset = section< uint64_t >( STRING_OFFSET );
+  strings = section< char >( STRING_DATA );
+
+  // the index arrays must be consistent with the counts
+  if( frame_first[ header.num_frames ] != header.num_records ||
+      class_first[ header.num_records ] != header.num_scores ||
+      string_offset[ header.num_strings ] != header.string_bytes ||
+      !std::is_sorted( frame_first, frame_first + header.num_frames + 1 ) ||
+      !std::is_sorted( string_offset, string_offset + header.num_strings + 1 ) )
+  {
+    VITAL_THROW( vital::invalid_data,
+                 "corrupt index in binary object store: " + source );
+  }
+}
+
+// ----------------------------------------------------------------------------
+binary_object_store_reader
+::binary_object_store_reader()
+  : d( new priv )
+{
+}
+
+binary_object_store_reader
+::~binary_object_store_reader()
+{
+}
+
+// ----------------------------------------------------------------------------
+void
+binary_object_store_reader
+::open( std::string const& filename )
+{
+  close();
+
+  d->file.open( filename );
+  d->base = d->file.data();
+  d->size = d->file.size();
+
+  try
+  {
+    d->parse( filename );
+  }
+  catch( ... )
+  {
+    d->unmap();
+    throw;
+  }
+}
+
+// ----------------------------------------------------------------------------
+void
+binary_object_store_reader
+::load( std::istream& is )
+{
+  close();
+
+  std::vector< char > bytes( ( std::istreambuf_iterator< char >( is ) ),
+                             std::istreambuf_iterator< char >() );
+
+  // keep the copy 8 byte aligned so the sections can be read in place
+  d->buffer.resize( ( bytes.size() + 7 ) / 8 );
+  if( !bytes.empty() )
+  {
+    std::memcpy( d->buffer.data(), bytes.data(), bytes.size() );
+  }
+  d->base = reinterpret_cast< char const* >( d->buffer.data() );
+  d->size = bytes.size();
+
+  try
+  {
+    d->parse( "<stream>" );
+  }
+  catch( ... )
+  {
+    d->unmap();
+    throw;
+  }
+}
+
+// ----------------------------------------------------------------------------
+void
+binary_object_store_reader
+::close()
+{
+  d->unmap();
+}
+
+// ----------------------------------------------------------------------------
+bool
+binary_object_store_reader
+::is_open() const
+{
+  return d->base != nullptr;
+}
+
+// ----------------------------------------------------------------------------
+binary_object_store_kind
+binary_object_store_reader
+::kind() const
+{
+  return static_cast< binary_object_store_kind >( d->header.kind );
+}
+
+// ----------------------------------------------------------------------------
+size_t
+binary_object_store_reader
+::num_frames() const
+{
+  return static_cast< size_t >( d->header.num_frames );
+}
+
+// ----------------------------------------------------------------------------
+size_t
+binary_object_store_reader
+::num_records() const
+{
+  return static_cast< size_t >( d->header.num_records );
+}
+
+// ----------------------------------------------------------------------------
+vital::frame_id_t
+binary_object_store_reader
+::frame_id( size_t i ) const
+{
+  return d->frame_id[ i ];
+}
+
+// ----------------------------------------------------------------------------
+vital::time_usec_t
+binary_object_store_reader
+::frame_time( size_t i ) const
+{
+  return d->frame_time[ i ];
+}
+
+// ----------------------------------------------------------------------------
+std::string
+binary_object_store_reader
+::frame_name( size_t i ) const
+{
+  return d->string_at( d->frame_name[ i ] );
+}
+
+// ----------------------------------------------------------------------------
+size_t
+binary_object_store_reader
+::lower_bound( vital::frame_id_t frame ) const
+{
+  return static_cast< size_t >(
+    std::lower_bound( d->frame_id, d->frame_id + d->header.num_frames, frame )
+    - d->frame_id );
+}
+
+// ----------------------------------------------------------------------------
+size_t
+binary_object_store_reader
+::frame_begin( size_t i ) const
+{
+  return static_cast< size_t >( d->frame_first[ i ] );
+}
+
+// ----------------------------------------------------------------------------
+size_t
+binary_object_store_reader
+::frame_end( size_t i ) const
+{
+  return static_cast< size_t >( d->frame_first[ i + 1 ] );
+}
+
+// ----------------------------------------------------------------------------
+vital::track_id_t
+binary_object_store_reader
+::track_id( size_t r ) const
+{
+  return d->track_id[ r ];
+}
+
+// ----------------------------------------------------------------------------
+vital::detected_object_sptr
+binary_object_store_reader
+::detection( size_t r ) const
+{
+  vital::bounding_box_d const bbox( d->min_x[ r ], d->min_y[ r ],
+                                    d->max_x[ r ], d->max_y[ r ] );
+
+  vital::detected_object_type_sptr dot;
+  auto const first = d->class_first[ r ];
+  auto const last = std::min( d->class_first[ r + 1 ], d->header.num_scores );
+  if( first < last )
+  {
+    dot = std::make_shared< vital::detected_object_type >();
+    for( auto i = first; i < last; ++i )
+    {
+      dot->set_score( d->string_at( d->class_name[ i ] ), d->class_score[ i ] );
+    }
+  }
+
+  return std::make_shared< vital::detected_object >( bbox, d->confidence[ r ],
+                                                     dot );
+}
+
+} } } // end namespace
@@ -0,0 +1,161 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Interface for the binary object store file format
+ */
+
+#ifndef KWIVER_ARROWS_CORE_BINARY_OBJECT_STORE_H
+#define KWIVER_ARROWS_CORE_BINARY_OBJECT_STORE_H
+
+#include <arrows/core/kwiver_algo_core_export.h>
+
+#include <vital/types/detected_object.h>
+#include <vital/vital_types.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+/// What a binary object store file holds
+enum class binary_object_store_kind : uint32_t
+{
+  object_tracks = 1,
+  detections = 2,
+};
+
+// ----------------------------------------------------------------------------
+/// Writer for the binary object store format
+/**
+ * The binary object store is a compact, versioned, column oriented file
+ * for large archives of detections and object tracks. A file holds a
+ * sequence of frames, each with a frame number, a time, an optional
+ * image name and a contiguous run of records. Each record holds a track
+ * id, a bounding box, a confidence and any class scores. Every field is
+ * stored as its own array, and a frame index maps each frame to its
+ * records, so a reader can map the file and decode any range of frames
+ * without touching the rest.
+ *
+ * Data is written in the byte order of the host. Readers reject files
+ * written with a different byte order.
+ *
+ * Frames must be added in increasing frame number order.
+ */
+class KWIVER_ALGO_CORE_EXPORT binary_object_store_writer
+{
+public:
+  explicit binary_object_store_writer( binary_object_store_kind kind );
+  ~binary_object_store_writer();
+
+  /// Start a new frame; records added afterwards belong to it
+  /**
+   * \throws vital::invalid_value if \p frame is not greater than the
+   *         number of the previous frame.
+   */
+  void add_frame( vital::frame_id_t frame, vital::time_usec_t time,
+                  std::string const& name = {} );
+
+  /// Add a record to the current frame
+  /**
+   * \throws vital::invalid_value if no frame has been added.
+   */
+  void add_record( vital::track_id_t track_id,
+                   vital::detected_object const& det );
+
+  /// The number of frames added so far
+  size_t num_frames() const;
+
+  /// The number of records added so far
+  size_t num_records() const;
+
+  /// Write the file to \p os
+  void write( std::ostream& os ) const;
+
+  /// Discard all frames and records
+  void clear();
+
+private:
+  class priv;
+  std::unique_ptr< priv > d;
+};
+
+// ----------------------------------------------------------------------------
+/// Reader for the binary object store format
+/**
+ * Files are memory mapped; only the pages holding the frames and records
+ * which are accessed are read from disk. Frames are addressed by their
+ * position in the file, in increasing frame number order.
+ */
+class KWIVER_ALGO_CORE_EXPORT binary_object_store_reader
+{
+public:
+  binary_object_store_reader();
+  ~binary_object_store_reader();
+
+  /// Map the named file
+  /**
+   * \throws vital::file_not_found_exception if the file can not be read.
+   * \throws vital::invalid_data if the file is not a valid store.
+   */
+  void open( std::string const& filename );
+
+  /// Read a whole store from a stream into memory
+  /**
+   * \throws vital::invalid_data if the data is not a valid store.
+   */
+  void load( std::istream& is );
+
+  /// Release the file or memory
+  void close();
+
+  /// Whether a store is open
+  bool is_open() const;
+
+  /// The kind of data held in the store
+  binary_object_store_kind kind() const;
+
+  /// The number of frames in the store
+  size_t num_frames() const;
+
+  /// The number of records in the store
+  size_t num_records() const;
+
+  /// The frame number of frame \p i
+  vital::frame_id_t frame_id( size_t i ) const;
+
+  /// The time of frame \p i
+  vital::time_usec_t frame_time( size_t i ) const;
+
+  /// The image name of frame \p i, or an empty string
+  std::string frame_name( size_t i ) const;
+
+  /// The position of the first frame whose number is not less than \p frame
+  size_t lower_bound( vital::frame_id_t frame ) const;
+
+  /// The first record of frame \p i
+  size_t frame_begin( size_t i ) const;
+
+  /// One past the last record of frame \p i
+  size_t frame_end( size_t i ) const;
+
+  /// The track id of record \p r
+  vital::track_id_t track_id( size_t r ) const;
+
+  /// Decode record \p r into a new detection
+  vital::detected_object_sptr detection( size_t r ) const;
+
+private:
+  class priv;
+  std::unique_ptr< priv > d;
+};
+
+} } } // end namespace
+
+#endif // KWIVER_ARROWS_CORE_BINARY_OBJECT_STORE_H
@@ -9,6 +9,8 @@
 
 #include "colorize.h"
 
+#include <arrows/core/mesh_color_accumulator.h>
+
 namespace kwiver {
 namespace arrows {
 namespace core {
@@ -113,6 +115,30 @@ vital::landmark_map_sptr compute_landmark_colors(
   return std::make_shared<kwiver::vital::simple_landmark_map>(colored_landmarks);
 }
 
+/// Compute colors for mesh vertices from the frames of a video
+size_t compute_mesh_vertex_colors(
+  vital::mesh_sptr mesh,
+  vital::algo::video_input& video,
+  vital::camera_map const& cameras,
+  std::vector<vital::rgb_color>& mean_colors,
+  std::vector<vital::rgb_color>& median_colors,
+  std::vector<unsigned>& counts,
+  unsigned frame_sampling,
+  vital::algo::video_input* mask,
+  double occlusion_threshold)
+{
+  mesh_color_accumulator accumulator(mesh);
+  accumulator.set_occlusion_threshold(occlusion_threshold);
+
+  auto const num_frames =
+    accumulator.add_video(video, cameras, frame_sampling, mask);
+
+  mean_colors = accumulator.mean_colors();
+  median_colors = accumulator.median_colors();
+  counts = accumulator.counts();
+  return num_frames;
+}
+
 } // end namespace core
 } // end namespace arrows
 } // end namespace kwiver
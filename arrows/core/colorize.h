@@ -16,6 +16,12 @@
 #include <vital/types/image_container.h>
 #include <vital/types/landmark_map.h>
 #include <vital/types/feature_track_set.h>
+#include <vital/types/camera_map.h>
+#include <vital/types/color.h>
+#include <vital/types/mesh.h>
+#include <vital/algo/video_input.h>
+
+#include <vector>
 
 namespace kwiver {
 namespace arrows {
@@ -67,6 +73,38 @@ vital::landmark_map_sptr compute_landmark_colors(
   vital::landmark_map const& landmarks,
   vital::feature_track_set const& tracks);
 
+/// Compute colors for mesh vertices from the frames of a video
+/**
+ * This function reads the frames which have a camera one at a time and
+ * accumulates the color seen at each visible vertex with a
+ * mesh_color_accumulator, so memory use depends on the mesh size and not on
+ * the number of frames.
+ *
+ *  \param [in] mesh the triangular mesh to be colored
+ *  \param [in] video an open video which is read to the end
+ *  \param [in] cameras the cameras indexed by frame number
+ *  \param [out] mean_colors the mean color of each vertex
+ *  \param [out] median_colors the approximate median color of each vertex
+ *  \param [out] counts the number of frames which colored each vertex
+ *  \param [in] frame_sampling use only every n-th frame which has a camera
+ *  \param [in] mask optional open mask video read at the same frames
+ *  \param [in] occlusion_threshold distance a vertex may lie behind the
+ *               rendered depth and still be colored; use infinity to keep
+ *               occluded vertices
+ *  \return the number of frames used
+ */
+KWIVER_ALGO_CORE_EXPORT
+size_t compute_mesh_vertex_colors(
+  vital::mesh_sptr mesh,
+  vital::algo::video_input& video,
+  vital::camera_map const& cameras,
+  std::vector<vital::rgb_color>& mean_colors,
+  std::vector<vital::rgb_color>& median_colors,
+  std::vector<unsigned>& counts,
+  unsigned frame_sampling = 1,
+  vital::algo::video_input* mask = nullptr,
+  double occlusion_threshold = 0.0);
+
 } // end namespace core
 } // end namespace arrows
 } // end namespace kwiver
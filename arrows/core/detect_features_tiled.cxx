@@ -0,0 +1,370 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Implementation of detect_features_tiled algorithm
+ */
+#include "detect_features_tiled.h"
+
+#include <arrows/core/image_tiles.h>
+
+#include <vital/exceptions/algorithm.h>
+#include <vital/exceptions/image.h>
+#include <vital/util/algorithm_pool.h>
+#include <vital/util/parallel_chunks.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+using namespace kwiver::vital;
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+namespace {
+
+// ----------------------------------------------------------------------------
+bool
+stronger(feature_sptr const& l, feature_sptr const& r)
+{
+  return l->magnitude() > r->magnitude();
+}
+
+} // end anonymous namespace
+
+/// Private implementation class
+class detect_features_tiled::priv
+{
+public:
+  /// Constructor
+  priv()
+    : feature_detector(nullptr),
+      tile_width(512),
+      tile_height(512),
+      tile_overlap(32),
+      max_features_per_tile(0),
+      duplicate_distance(1.0)
+  {
+  }
+
+  // --------------------------------------------------------------------------
+  // Detect the features owned by one tile in image coordinates
+  std::vector<feature_sptr>
+  detect_tile(image_container_sptr const& image,
+              image_container_sptr const& mask,
+              image_tile const& tile)
+  {
+    auto detector = detectors.acquire();
+    if (!detector)
+    {
+      VITAL_THROW( algorithm_configuration_exception,
+                   vital::algo::detect_features::static_type_name(),
+                   detect_features_tiled::_plugin_name,
+                   "unable to create an instance of the nested detector" );
+    }
+    feature_set_sptr tile_features;
+    try
+    {
+      tile_features = detector->detect(crop_tile(image, tile),
+                                       crop_tile(mask, tile));
+    }
+    catch (...)
+    {
+      detectors.release(detector);
+      throw;
+    }
+    detectors.release(detector);
+
+    std::vector<feature_sptr> owned;
+    if (!tile_features)
+    {
+      return owned;
+    }
+    vector_2d const offset(static_cast<double>(tile.x),
+                           static_cast<double>(tile.y));
+    for (auto const& f : tile_features->features())
+    {
+      vector_2d const loc = f->loc() + offset;
+      if (tile.owns(loc))
+      {
+        auto const fd = std::make_shared<feature_d>(*f);
+        fd->set_loc(loc);
+        owned.push_back(fd);
+      }
+    }
+
+    // keep the strongest features within the budget
+    if (max_features_per_tile > 0 && owned.size() > max_features_per_tile)
+    {
+      std::partial_sort(owned.begin(), owned.begin() + max_features_per_tile,
+                        owned.end(), stronger);
+      owned.resize(max_features_per_tile);
+    }
+    return owned;
+  }
+
+  // --------------------------------------------------------------------------
+  // Merge features of neighboring tiles closer than duplicate_distance
+  // across a tile border, keeping the stronger
+  std::vector<feature_sptr>
+  merge_duplicates(std::vector<image_tile> const& tiles,
+                   std::vector<std::vector<feature_sptr> > const& tile_features,
+                   size_t width, size_t height) const
+  {
+    double const d = duplicate_distance;
+
+    // only features near an internal tile border can have duplicates
+    struct candidate
+    {
+      feature_sptr feat;
+      size_t tile;
+      bool keep;
+    };
+    std::vector<candidate> candidates;
+    std::vector<feature_sptr> merged;
+    for (size_t t = 0; t < tiles.size(); ++t)
+    {
+      auto const& tile = tiles[t];
+      for (auto const& f : tile_features[t])
+      {
+        auto const& loc = f->loc();
+        if (d > 0.0 &&
+            ((tile.core_x0 > 0 && loc[0] - tile.core_x0 < d) ||
+             (tile.core_x1 < width && tile.core_x1 - loc[0] < d) ||
+             (tile.core_y0 > 0 && loc[1] - tile.core_y0 < d) ||
+             (tile.core_y1 < height && tile.core_y1 - loc[1] < d)))
+        {
+          candidates.push_back({ f, t, true });
+        }
+        else
+        {
+          merged.push_back(f);
+        }
+      }
+    }
+    if (candidates.empty())
+    {
+      return merged;
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](candidate const& l, candidate const& r)
+                     {
+                       return stronger(l.feat, r.feat);
+                     });
+
+    // bucket kept candidates in cells the size of the duplicate distance
+    auto const cell_key = [](int64_t x, int64_t y)
+    {
+      return (y << 32) ^ (x & 0xFFFFFFFF);
+    };
+    std::unordered_map<int64_t, std::vector<size_t> > cells;
+    double const d2 = d * d;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+      auto& c = candidates[i];
+      auto const& loc = c.feat->loc();
+      auto const cx = static_cast<int64_t>(std::floor(loc[0] / d));
+      auto const cy = static_cast<int64_t>(std::floor(loc[1] / d));
+      for (int dy = -1; dy <= 1 && c.keep; ++dy)
+      {
+        for (int dx = -1; dx <= 1 && c.keep; ++dx)
+        {
+          auto const itr = cells.find(cell_key(cx + dx, cy + dy));
+          if (itr == cells.end())
+          {
+            continue;
+          }
+          for (size_t j : itr->second)
+          {
+            if (candidates[j].tile != c.tile &&
+                (candidates[j].feat->loc() - loc).squaredNorm() < d2)
+            {
+              c.keep = false;
+              break;
+            }
+          }
+        }
+      }
+      if (c.keep)
+      {
+        cells[cell_key(cx, cy)].push_back(i);
+        merged.push_back(c.feat);
+      }
+    }
+    return merged;
+  }
+
+  /// The feature detector algorithm configured by the user
+  vital::algo::detect_features_sptr feature_detector;
+
+  /// Instances of the detector for concurrent tiles
+  vital::algorithm_pool<vital::algo::detect_features> detectors;
+
+  // configuration parameters
+  unsigned int tile_width;
+  unsigned int tile_height;
+  unsigned int tile_overlap;
+  unsigned int max_features_per_tile;
+  double duplicate_distance;
+};
+
+// ----------------------------------------------------------------------------
+// Constructor
+detect_features_tiled
+::detect_features_tiled()
+: d_(new priv)
+{
+  attach_logger( "arrows.core.detect_features_tiled" );
+}
+
+// Destructor
+detect_features_tiled
+::~detect_features_tiled()
+{
+}
+
+// ----------------------------------------------------------------------------
+// Get this algorithm's \link vital::config_block configuration block \endlink
+vital::config_block_sptr
+detect_features_tiled
+::get_configuration() const
+{
+  // get base config from base class
+  vital::config_block_sptr config =
+      vital::algo::detect_features::get_configuration();
+
+  config->set_value("tile_width", d_->tile_width,
+                    "The width, in pixels, of the tiles the image is split "
+                    "into.");
+  config->set_value("tile_height", d_->tile_height,
+                    "The height, in pixels, of the tiles the image is split "
+                    "into.");
+  config->set_value("tile_overlap", d_->tile_overlap,
+                    "The number of pixels each tile is extended on each side "
+                    "so the detector sees the context at the tile border. "
+                    "Features found in the overlap are dropped in favor of "
+                    "the neighboring tile.");
+  config->set_value("max_features_per_tile", d_->max_features_per_tile,
+                    "The maximum number of features kept in each tile, "
+                    "choosing the largest magnitudes.  This spreads features "
+                    "evenly over the image.  Zero means no limit.");
+  config->set_value("duplicate_distance", d_->duplicate_distance,
+                    "Features of neighboring tiles closer than this "
+                    "distance, in pixels, are duplicates, and only the "
+                    "strongest is kept.  Zero disables merging.");
+
+  // nested algorithm configurations
+  vital::algo::detect_features
+    ::get_nested_algo_configuration("detector", config, d_->feature_detector);
+
+  return config;
+}
+
+// ----------------------------------------------------------------------------
+// Set this algorithm's properties via a config block
+void
+detect_features_tiled
+::set_configuration(vital::config_block_sptr config)
+{
+#define GET_VALUE(name, type) \
+  d_->name = config->get_value<type>(#name, d_->name)
+
+  GET_VALUE(tile_width, unsigned int);
+  GET_VALUE(tile_height, unsigned int);
+  GET_VALUE(tile_overlap, unsigned int);
+  GET_VALUE(max_features_per_tile, unsigned int);
+  GET_VALUE(duplicate_distance, double);
+
+#undef GET_VALUE
+
+  // nested algorithm configurations
+  vital::algo::detect_features
+    ::set_nested_algo_configuration("detector", config, d_->feature_detector);
+  d_->detectors.configure("detector", config);
+}
+
+// ----------------------------------------------------------------------------
+// Check that the algorithm's configuration vital::config_block is valid
+bool
+detect_features_tiled
+::check_configuration(vital::config_block_sptr config) const
+{
+  bool valid = true;
+  if (config->get_value<unsigned int>("tile_width", d_->tile_width) < 1 ||
+      config->get_value<unsigned int>("tile_height", d_->tile_height) < 1)
+  {
+    LOG_ERROR(logger(), "tile_width and tile_height must be at least 1");
+    valid = false;
+  }
+  if (config->get_value<double>("duplicate_distance",
+                                d_->duplicate_distance) < 0.0)
+  {
+    LOG_ERROR(logger(), "duplicate_distance must not be negative");
+    valid = false;
+  }
+  bool detector_valid = vital::algo::detect_features
+    ::check_nested_algo_configuration("detector", config);
+  return valid && detector_valid;
+}
+
+/// Extract a set of image features from the provided image
+vital::feature_set_sptr
+detect_features_tiled
+::detect(vital::image_container_sptr image_data,
+  vital::image_container_sptr mask) const
+{
+  if (!d_->feature_detector)
+  {
+    LOG_ERROR(logger(), "Nested feature detector not initialized.");
+    return nullptr;
+  }
+  if (!image_data)
+  {
+    return std::make_shared<simple_feature_set>();
+  }
+
+  size_t const width = image_data->width();
+  size_t const height = image_data->height();
+  if (mask && mask->size() > 0)
+  {
+    if (width != mask->width() || height != mask->height())
+    {
+      VITAL_THROW( image_size_mismatch_exception,
+                   "Tiled feature detector given a mask with a different "
+                   "shape than the input image",
+                   width, height, mask->width(), mask->height() );
+    }
+  }
+  else
+  {
+    mask = nullptr;
+  }
+
+  auto const tiles = split_image_tiles(width, height,
+                                       d_->tile_width, d_->tile_height,
+                                       d_->tile_overlap);
+  std::vector<std::vector<feature_sptr> > tile_features(tiles.size());
+  parallel_chunks(tiles.size(), 1, [&](size_t begin, size_t end)
+  {
+    for (size_t t = begin; t < end; ++t)
+    {
+      tile_features[t] = d_->detect_tile(image_data, mask, tiles[t]);
+    }
+  });
+
+  auto const features =
+    d_->merge_duplicates(tiles, tile_features, width, height);
+  LOG_DEBUG(logger(), "Detected " << features.size() << " features in "
+                      << tiles.size() << " tiles");
+  return std::make_shared<simple_feature_set>(features);
+}
+
+} // end namespace core
+} // end namespace arrows
+} // end namespace kwiver
@@ -0,0 +1,77 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief detect_features adaptor that runs a detector on image tiles
+ */
+
+#ifndef KWIVER_ARROWS_CORE_DETECT_FEATURES_TILED_H_
+#define KWIVER_ARROWS_CORE_DETECT_FEATURES_TILED_H_
+
+#include <vital/algo/detect_features.h>
+
+#include <arrows/core/kwiver_algo_core_export.h>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+/// A feature detector that runs another detector on tiles concurrently
+/**
+ * The image is split into a grid of tiles which are each extended by an
+ * overlap so the detector sees the context around the tile edges.  Each
+ * feature is kept only by the tile whose core contains it, optionally
+ * limited to the strongest features of each tile, and features of
+ * neighboring tiles closer than a duplicate distance are merged.  Tiles
+ * run in parallel, each with its own instance of the detector.
+ */
+class KWIVER_ALGO_CORE_EXPORT detect_features_tiled
+  : public kwiver::vital::algo::detect_features
+{
+public:
+  PLUGIN_INFO("tiled",
+              "Wrapper that runs a feature detector on overlapping "
+              "image tiles in parallel and merges the results")
+
+  /// Constructor
+  detect_features_tiled();
+
+  /// Destructor
+  virtual ~detect_features_tiled();
+
+  /// Get this algorithm's \link vital::config_block configuration block \endlink
+  virtual vital::config_block_sptr get_configuration() const;
+  /// Set this algorithm's properties via a config block
+  virtual void set_configuration(vital::config_block_sptr config);
+  /// Check that the algorithm's configuration config_block is valid
+  virtual bool check_configuration(vital::config_block_sptr config) const;
+
+  /// Extract a set of image features from the provided image
+  /**
+   * A given mask image should be one-channel (mask->depth() == 1). If the
+   * given mask image has more than one channel, only the first will be
+   * considered.
+   *
+   * \param image_data contains the image data to process
+   * \param mask Mask image where regions of positive values (boolean true)
+   *             indicate regions to consider. Only the first channel will be
+   *             considered.
+   * \returns a set of image features
+   */
+  virtual vital::feature_set_sptr
+  detect(vital::image_container_sptr image_data,
+         vital::image_container_sptr mask = vital::image_container_sptr()) const;
+
+private:
+  /// private implementation class
+  class priv;
+  const std::unique_ptr<priv> d_;
+};
+
+} // end namespace core
+} // end namespace arrows
+} // end namespace kwiver
+
+#endif // KWIVER_ARROWS_CORE_DETECT_FEATURES_TILED_H_
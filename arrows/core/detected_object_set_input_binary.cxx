@@ -0,0 +1,175 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Implementation of detected_object_set_input_binary
+ */
+
+#include "detected_object_set_input_binary.h"
+
+#include <arrows/core/binary_object_store.h>
+
+#include <vital/vital_config.h>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+// ------------------------------------------------------------------
+class detected_object_set_input_binary::priv
+{
+public:
+  priv( detected_object_set_input_binary* parent )
+    : m_parent( parent )
+    , m_first_frame( -1 )
+    , m_last_frame( -1 )
+    , m_loaded( false )
+    , m_current( 0 )
+    , m_end( 0 )
+  { }
+
+  ~priv() { }
+
+  void load();
+
+  detected_object_set_input_binary* m_parent;
+  binary_object_store_reader m_reader;
+  vital::frame_id_t m_first_frame;
+  vital::frame_id_t m_last_frame;
+
+  bool m_loaded;
+
+  // Positions of the next frame to return and of the end of the range
+  size_t m_current;
+  size_t m_end;
+};
+
+// ------------------------------------------------------------------
+void
+detected_object_set_input_binary::priv
+::load()
+{
+  // files opened by name are already mapped
+  if( !m_reader.is_open() )
+  {
+    m_reader.load( m_parent->stream() );
+  }
+
+  m_current = ( m_first_frame < 0 ? size_t{ 0 }
+                : m_reader.lower_bound( m_first_frame ) );
+  m_end = ( m_last_frame < 0 ? m_reader.num_frames()
+            : m_reader.lower_bound( m_last_frame + 1 ) );
+  m_loaded = true;
+}
+
+// ==================================================================
+detected_object_set_input_binary
+::detected_object_set_input_binary()
+  : d( new detected_object_set_input_binary::priv( this ) )
+{
+}
+
+detected_object_set_input_binary
+::~detected_object_set_input_binary()
+{
+}
+
+// ------------------------------------------------------------------
+vital::config_block_sptr
+detected_object_set_input_binary
+::get_configuration() const
+{
+  auto config = vital::algo::detected_object_set_input::get_configuration();
+
+  config->set_value( "first_frame", d->m_first_frame,
+                     "First frame to read, or -1 to start at the "
+                     "beginning of the file." );
+  config->set_value( "last_frame", d->m_last_frame,
+                     "Last frame to read, or -1 to read to the end of "
+                     "the file." );
+
+  return config;
+}
+
+// ------------------------------------------------------------------
+void
+detected_object_set_input_binary
+::set_configuration( vital::config_block_sptr config )
+{
+  d->m_first_frame =
+    config->get_value< vital::frame_id_t >( "first_frame", d->m_first_frame );
+  d->m_last_frame =
+    config->get_value< vital::frame_id_t >( "last_frame", d->m_last_frame );
+}
+
+// ------------------------------------------------------------------
+bool
+detected_object_set_input_binary
+::check_configuration( VITAL_UNUSED vital::config_block_sptr config ) const
+{
+  return true;
+}
+
+// ------------------------------------------------------------------
+void
+detected_object_set_input_binary
+::open( std::string const& filename )
+{
+  vital::algo::detected_object_set_input::open( filename );
+  d->m_reader.open( filename );
+}
+
+// ------------------------------------------------------------------
+void
+detected_object_set_input_binary
+::close()
+{
+  d->m_reader.close();
+  d->m_loaded = false;
+  vital::algo::detected_object_set_input::close();
+}
+
+// ------------------------------------------------------------------
+void
+detected_object_set_input_binary
+::new_stream()
+{
+  d->m_reader.close();
+  d->m_loaded = false;
+}
+
+// ------------------------------------------------------------------
+bool
+detected_object_set_input_binary
+::read_set( kwiver::vital::detected_object_set_sptr& set,
+            std::string& image_name )
+{
+  if( !d->m_loaded )
+  {
+    d->load();
+  }
+
+  if( d->m_current >= d->m_end )
+  {
+    return false;
+  }
+
+  auto const f = d->m_current++;
+  auto const first = d->m_reader.frame_begin( f );
+  auto const last = d->m_reader.frame_end( f );
+
+  std::vector< vital::detected_object_sptr > dets;
+  dets.reserve( last - first );
+  for( auto r = first; r < last; ++r )
+  {
+    dets.push_back( d->m_reader.detection( r ) );
+  }
+
+  set = std::make_shared< vital::detected_object_set >( dets );
+  image_name = d->m_reader.frame_name( f );
+  return true;
+}
+
+} } } // end namespace
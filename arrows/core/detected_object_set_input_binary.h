@@ -0,0 +1,56 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Interface for detected_object_set_input_binary
+ */
+
+#ifndef KWIVER_ARROWS_CORE_DETECTED_OBJECT_SET_INPUT_BINARY_H
+#define KWIVER_ARROWS_CORE_DETECTED_OBJECT_SET_INPUT_BINARY_H
+
+#include <arrows/core/kwiver_algo_core_export.h>
+
+#include <vital/algo/detected_object_set_input.h>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+/// Detected object set reader for the binary object store format
+/**
+ * Files opened by name are memory mapped and each call to read_set()
+ * decodes only the next frame in the configured range.
+ */
+class KWIVER_ALGO_CORE_EXPORT detected_object_set_input_binary
+  : public vital::algo::detected_object_set_input
+{
+public:
+  PLUGIN_INFO( "binary",
+               "Detected object set reader for the memory mapped binary "
+               "object store format." )
+
+  detected_object_set_input_binary();
+  virtual ~detected_object_set_input_binary();
+
+  virtual vital::config_block_sptr get_configuration() const;
+  virtual void set_configuration( vital::config_block_sptr config );
+  virtual bool check_configuration( vital::config_block_sptr config ) const;
+
+  virtual void open( std::string const& filename );
+  virtual void close();
+
+  virtual bool read_set( kwiver::vital::detected_object_set_sptr& set,
+                         std::string& image_name );
+
+private:
+  virtual void new_stream();
+
+  class priv;
+  std::unique_ptr< priv > d;
+};
+
+} } } // end namespace
+
+#endif // KWIVER_ARROWS_CORE_DETECTED_OBJECT_SET_INPUT_BINARY_H
@@ -0,0 +1,136 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Implementation of detected_object_set_output_binary
+ */
+
+#include "detected_object_set_output_binary.h"
+
+#include <arrows/core/binary_object_store.h>
+
+#include <vital/exceptions/io.h>
+#include <vital/vital_config.h>
+
+#include <fstream>
+#include <memory>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+// ------------------------------------------------------------------
+class detected_object_set_output_binary::priv
+{
+public:
+  priv()
+    : m_writer( binary_object_store_kind::detections )
+    , m_frame_number( 1 )
+    , m_written( false )
+  { }
+
+  ~priv() { }
+
+  binary_object_store_writer m_writer;
+  vital::frame_id_t m_frame_number;
+  bool m_written;
+  std::unique_ptr< std::ofstream > m_file;
+};
+
+// ==================================================================
+detected_object_set_output_binary
+::detected_object_set_output_binary()
+  : d( new detected_object_set_output_binary::priv )
+{
+}
+
+detected_object_set_output_binary
+::~detected_object_set_output_binary()
+{
+}
+
+// ------------------------------------------------------------------
+void
+detected_object_set_output_binary
+::open( std::string const& filename )
+{
+  // the base class opens files in text mode
+  std::unique_ptr< std::ofstream > file(
+    new std::ofstream( filename, std::ios::out | std::ios::binary ) );
+  if( !*file )
+  {
+    VITAL_THROW( vital::file_not_found_exception, filename, "open failed" );
+  }
+
+  use_stream( file.get() );
+  d->m_file = std::move( file );
+}
+
+// ------------------------------------------------------------------
+void
+detected_object_set_output_binary
+::set_configuration( VITAL_UNUSED vital::config_block_sptr config )
+{
+}
+
+// ------------------------------------------------------------------
+bool
+detected_object_set_output_binary
+::check_configuration( VITAL_UNUSED vital::config_block_sptr config ) const
+{
+  return true;
+}
+
+// ------------------------------------------------------------------
+void
+detected_object_set_output_binary
+::write_set( const kwiver::vital::detected_object_set_sptr set,
+             std::string const& image_name )
+{
+  d->m_writer.add_frame( d->m_frame_number, 0, image_name );
+  ++d->m_frame_number;
+
+  if( !set )
+  {
+    return;
+  }
+
+  vital::track_id_t id = 0;
+  for( auto const& det : *set )
+  {
+    d->m_writer.add_record( id++, *det );
+  }
+}
+
+// ------------------------------------------------------------------
+void
+detected_object_set_output_binary
+::complete()
+{
+  if( !d->m_written )
+  {
+    d->m_writer.write( stream() );
+    d->m_writer.clear();
+    d->m_written = true;
+  }
+}
+
+// ------------------------------------------------------------------
+void
+detected_object_set_output_binary
+::close()
+{
+  // an unopened or unused writer has nothing to flush
+  if( d->m_writer.num_frames() > 0 )
+  {
+    complete();
+  }
+  vital::algo::detected_object_set_output::close();
+  d->m_file.reset();
+  d->m_written = false;
+  d->m_frame_number = 1;
+}
+
+} } } // end namespace
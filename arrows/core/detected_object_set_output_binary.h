@@ -0,0 +1,58 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Interface for detected_object_set_output_binary
+ */
+
+#ifndef KWIVER_ARROWS_DETECTED_OBJECT_SET_OUTPUT_BINARY_H
+#define KWIVER_ARROWS_DETECTED_OBJECT_SET_OUTPUT_BINARY_H
+
+#include <arrows/core/kwiver_algo_core_export.h>
+
+#include <vital/algo/detected_object_set_output.h>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+/// Detected object set writer for the binary object store format
+/**
+ * Sets are numbered from one, as in the CSV writer.  The file is written
+ * by complete() or, if that is not called, when the writer is closed.
+ * The store is laid out by field rather than by frame, so the sets are
+ * buffered until then, at about 56 bytes per detection, 12 bytes per
+ * class score and 28 bytes per set, plus each distinct name once.
+ */
+class KWIVER_ALGO_CORE_EXPORT detected_object_set_output_binary
+  : public vital::algo::detected_object_set_output
+{
+public:
+  PLUGIN_INFO( "binary",
+               "Detected object set writer for the memory mapped binary "
+               "object store format." )
+
+  detected_object_set_output_binary();
+  virtual ~detected_object_set_output_binary();
+
+  virtual void open( std::string const& filename );
+
+  virtual void set_configuration( vital::config_block_sptr config );
+  virtual bool check_configuration( vital::config_block_sptr config ) const;
+
+  virtual void close();
+  virtual void complete();
+
+  virtual void write_set( const kwiver::vital::detected_object_set_sptr set,
+                          std::string const& image_name );
+
+private:
+  class priv;
+  std::unique_ptr< priv > d;
+};
+
+} } } // end namespace
+
+#endif // KWIVER_ARROWS_DETECTED_OBJECT_SET_OUTPUT_BINARY_H
@@ -0,0 +1,321 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Implementation of extract_descriptors_tiled algorithm
+ */
+#include "extract_descriptors_tiled.h"
+
+#include <arrows/core/image_tiles.h>
+
+#include <vital/exceptions/algorithm.h>
+#include <vital/exceptions/image.h>
+#include <vital/util/algorithm_pool.h>
+#include <vital/util/parallel_chunks.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace kwiver::vital;
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+/// Private implementation class
+class extract_descriptors_tiled::priv
+{
+public:
+  /// A feature and its descriptor, with the index of the input feature
+  struct tile_result
+  {
+    size_t order;
+    feature_sptr feat;
+    descriptor_sptr desc;
+  };
+
+  /// Constructor
+  priv()
+    : descriptor_extractor(nullptr),
+      tile_width(512),
+      tile_height(512),
+      tile_overlap(32)
+  {
+  }
+
+  // --------------------------------------------------------------------------
+  // Extract descriptors for the features in one tile.  \p indices selects
+  // the tile's features from \p features, in increasing order.  Each result
+  // records the index of the input feature it belongs to so that the input
+  // order can be restored; features added by the extractor take the index
+  // of the result before them.
+  void
+  extract_tile(image_container_sptr const& image,
+               image_container_sptr const& mask,
+               image_tile const& tile,
+               std::vector<feature_sptr> const& features,
+               std::vector<size_t> const& indices,
+               std::vector<tile_result>& results)
+  {
+    if (indices.empty())
+    {
+      return;
+    }
+    auto extractor = extractors.acquire();
+    if (!extractor)
+    {
+      VITAL_THROW( algorithm_configuration_exception,
+                   vital::algo::extract_descriptors::static_type_name(),
+                   extract_descriptors_tiled::_plugin_name,
+                   "unable to create an instance of the nested extractor" );
+    }
+
+    vector_2d const offset(static_cast<double>(tile.x),
+                           static_cast<double>(tile.y));
+    std::vector<feature_sptr> shifted;
+    shifted.reserve(indices.size());
+    std::unordered_map<feature const*, size_t> shifted_index;
+    for (auto const i : indices)
+    {
+      auto const fd = std::make_shared<feature_d>(*features[i]);
+      fd->set_loc(features[i]->loc() - offset);
+      shifted_index[fd.get()] = i;
+      shifted.push_back(fd);
+    }
+    feature_set_sptr tile_features =
+      std::make_shared<simple_feature_set>(shifted);
+
+    descriptor_set_sptr tile_descriptors;
+    try
+    {
+      tile_descriptors = extractor->extract(crop_tile(image, tile),
+                                            tile_features,
+                                            crop_tile(mask, tile));
+    }
+    catch (...)
+    {
+      extractors.release(extractor);
+      throw;
+    }
+    extractors.release(extractor);
+
+    auto const out_features = tile_features
+      ? tile_features->features() : std::vector<feature_sptr>();
+    auto const out_descriptors = tile_descriptors
+      ? tile_descriptors->descriptors() : std::vector<descriptor_sptr>();
+    if (out_features.size() != out_descriptors.size())
+    {
+      VITAL_THROW( algorithm_exception,
+                   vital::algo::extract_descriptors::static_type_name(),
+                   extract_descriptors_tiled::_plugin_name,
+                   "the nested extractor returned "
+                   + std::to_string(out_descriptors.size())
+                   + " descriptors for " + std::to_string(out_features.size())
+                   + " features" );
+    }
+
+    // features the extractor passed through are replaced by the originals;
+    // any it changed or added are moved back to image coordinates
+    size_t order = indices.front();
+    for (size_t k = 0; k < out_features.size(); ++k)
+    {
+      auto const& f = out_features[k];
+      auto const it = shifted_index.find(f.get());
+      feature_sptr result_feature;
+      if (it != shifted_index.end())
+      {
+        order = it->second;
+        result_feature = features[order];
+      }
+      else
+      {
+        auto const fd = std::make_shared<feature_d>(*f);
+        fd->set_loc(f->loc() + offset);
+        result_feature = fd;
+      }
+      results.push_back({ order, result_feature, out_descriptors[k] });
+    }
+  }
+
+  /// The descriptor extractor algorithm configured by the user
+  vital::algo::extract_descriptors_sptr descriptor_extractor;
+
+  /// Instances of the extractor for concurrent tiles
+  vital::algorithm_pool<vital::algo::extract_descriptors> extractors;
+
+  // configuration parameters
+  unsigned int tile_width;
+  unsigned int tile_height;
+  unsigned int tile_overlap;
+};
+
+// ----------------------------------------------------------------------------
+// Constructor
+extract_descriptors_tiled
+::extract_descriptors_tiled()
+: d_(new priv)
+{
+  attach_logger( "arrows.core.extract_descriptors_tiled" );
+}
+
+// Destructor
+extract_descriptors_tiled
+::~extract_descriptors_tiled()
+{
+}
+
+// ----------------------------------------------------------------------------
+// Get this algorithm's \link vital::config_block configuration block \endlink
+vital::config_block_sptr
+extract_descriptors_tiled
+::get_configuration() const
+{
+  // get base config from base class
+  vital::config_block_sptr config =
+      vital::algo::extract_descriptors::get_configuration();
+
+  config->set_value("tile_width", d_->tile_width,
+                    "The width, in pixels, of the tiles the image is split "
+                    "into.");
+  config->set_value("tile_height", d_->tile_height,
+                    "The height, in pixels, of the tiles the image is split "
+                    "into.");
+  config->set_value("tile_overlap", d_->tile_overlap,
+                    "The number of pixels each tile is extended on each "
+                    "side.  This should be at least the radius of the image "
+                    "region used by each descriptor so that features near "
+                    "tile borders are described as in the whole image.");
+
+  // nested algorithm configurations
+  vital::algo::extract_descriptors
+    ::get_nested_algo_configuration("extractor", config,
+                                    d_->descriptor_extractor);
+
+  return config;
+}
+
+// ----------------------------------------------------------------------------
+// Set this algorithm's properties via a config block
+void
+extract_descriptors_tiled
+::set_configuration(vital::config_block_sptr config)
+{
+#define GET_VALUE(name, type) \
+  d_->name = config->get_value<type>(#name, d_->name)
+
+  GET_VALUE(tile_width, unsigned int);
+  GET_VALUE(tile_height, unsigned int);
+  GET_VALUE(tile_overlap, unsigned int);
+
+#undef GET_VALUE
+
+  // nested algorithm configurations
+  vital::algo::extract_descriptors
+    ::set_nested_algo_configuration("extractor", config,
+                                    d_->descriptor_extractor);
+  d_->extractors.configure("extractor", config);
+}
+
+// ----------------------------------------------------------------------------
+// Check that the algorithm's configuration vital::config_block is valid
+bool
+extract_descriptors_tiled
+::check_configuration(vital::config_block_sptr config) const
+{
+  bool valid = true;
+  if (config->get_value<unsigned int>("tile_width", d_->tile_width) < 1 ||
+      config->get_value<unsigned int>("tile_height", d_->tile_height) < 1)
+  {
+    LOG_ERROR(logger(), "tile_width and tile_height must be at least 1");
+    valid = false;
+  }
+  bool extractor_valid = vital::algo::extract_descriptors
+    ::check_nested_algo_configuration("extractor", config);
+  return valid && extractor_valid;
+}
+
+// ----------------------------------------------------------------------------
+// Extract from the image a descriptor corresponding to each feature
+vital::descriptor_set_sptr
+extract_descriptors_tiled
+::extract(vital::image_container_sptr image_data,
+          vital::feature_set_sptr &features,
+          vital::image_container_sptr image_mask) const
+{
+  if (!d_->descriptor_extractor)
+  {
+    LOG_ERROR(logger(), "Nested descriptor extractor not initialized.");
+    return nullptr;
+  }
+  if (!image_data || !features)
+  {
+    return std::make_shared<simple_descriptor_set>();
+  }
+
+  size_t const width = image_data->width();
+  size_t const height = image_data->height();
+  if (image_mask && image_mask->size() > 0)
+  {
+    if (width != image_mask->width() || height != image_mask->height())
+    {
+      VITAL_THROW( image_size_mismatch_exception,
+                   "Tiled descriptor extractor given a mask with a "
+                   "different shape than the input image",
+                   width, height, image_mask->width(), image_mask->height() );
+    }
+  }
+  else
+  {
+    image_mask = nullptr;
+  }
+
+  // assign each feature to the tile containing it
+  auto const tiles = split_image_tiles(width, height,
+                                       d_->tile_width, d_->tile_height,
+                                       d_->tile_overlap);
+  auto const input_features = features->features();
+  std::vector<std::vector<size_t> > tile_indices(tiles.size());
+  for (size_t i = 0; i < input_features.size(); ++i)
+  {
+    tile_indices[tile_index(input_features[i]->loc(), width, height,
+                            d_->tile_width, d_->tile_height)].push_back(i);
+  }
+
+  std::vector<std::vector<priv::tile_result> > tile_results(tiles.size());
+  parallel_chunks(tiles.size(), 1, [&](size_t begin, size_t end)
+  {
+    for (size_t t = begin; t < end; ++t)
+    {
+      d_->extract_tile(image_data, image_mask, tiles[t], input_features,
+                       tile_indices[t], tile_results[t]);
+    }
+  });
+
+  // restore the order of the input features
+  std::vector<priv::tile_result> results;
+  for (auto const& r : tile_results)
+  {
+    results.insert(results.end(), r.begin(), r.end());
+  }
+  std::stable_sort(results.begin(), results.end(),
+                   [](priv::tile_result const& a, priv::tile_result const& b)
+                   { return a.order < b.order; });
+
+  std::vector<feature_sptr> all_features;
+  std::vector<descriptor_sptr> all_descriptors;
+  all_features.reserve(results.size());
+  all_descriptors.reserve(results.size());
+  for (auto const& r : results)
+  {
+    all_features.push_back(r.feat);
+    all_descriptors.push_back(r.desc);
+  }
+  features = std::make_shared<simple_feature_set>(all_features);
+  return std::make_shared<simple_descriptor_set>(all_descriptors);
+}
+
+} // end namespace core
+} // end namespace arrows
+} // end namespace kwiver
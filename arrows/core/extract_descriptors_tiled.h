@@ -0,0 +1,76 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief extract_descriptors adaptor that runs an extractor on image tiles
+ */
+
+#ifndef KWIVER_ARROWS_CORE_EXTRACT_DESCRIPTORS_TILED_H_
+#define KWIVER_ARROWS_CORE_EXTRACT_DESCRIPTORS_TILED_H_
+
+#include <vital/algo/extract_descriptors.h>
+
+#include <arrows/core/kwiver_algo_core_export.h>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+/// A descriptor extractor that runs another extractor on tiles concurrently
+/**
+ * The image is split into a grid of tiles which are each extended by an
+ * overlap, which should cover the extractor's descriptor support.  Each
+ * feature is extracted in the tile whose core contains it, and tiles run
+ * in parallel, each with its own instance of the extractor.  The features
+ * returned keep the order of the input features, and are the input
+ * features themselves unless the nested extractor changed them.
+ */
+class KWIVER_ALGO_CORE_EXPORT extract_descriptors_tiled
+  : public kwiver::vital::algo::extract_descriptors
+{
+public:
+  PLUGIN_INFO("tiled",
+              "Wrapper that runs a descriptor extractor on overlapping "
+              "image tiles in parallel and merges the results")
+
+  /// Constructor
+  extract_descriptors_tiled();
+
+  /// Destructor
+  virtual ~extract_descriptors_tiled();
+
+  /// Get this algorithm's \link vital::config_block configuration block \endlink
+  virtual vital::config_block_sptr get_configuration() const;
+  /// Set this algorithm's properties via a config block
+  virtual void set_configuration(vital::config_block_sptr config);
+  /// Check that the algorithm's configuration config_block is valid
+  virtual bool check_configuration(vital::config_block_sptr config) const;
+
+  /// Extract from the image a descriptor corresponding to each feature
+  /**
+   * \param [in]     image_data contains the image data to process
+   * \param [in,out] features the feature locations at which descriptors
+   *                 are extracted (may be modified).
+   * \param [in]     image_mask Mask image of the same dimensions as
+   *                            \p image_data where positive values indicate
+   *                            regions of \p image_data to consider.
+   * \returns a set of feature descriptors
+   */
+  virtual vital::descriptor_set_sptr
+  extract(vital::image_container_sptr image_data,
+          vital::feature_set_sptr &features,
+          vital::image_container_sptr image_mask = vital::image_container_sptr()) const;
+
+private:
+  /// private implementation class
+  class priv;
+  const std::unique_ptr<priv> d_;
+};
+
+} // end namespace core
+} // end namespace arrows
+} // end namespace kwiver
+
+#endif // KWIVER_ARROWS_CORE_EXTRACT_DESCRIPTORS_TILED_H_
@@ -13,6 +13,7 @@
 
 #include <vital/exceptions.h>
 #include <vital/vital_config.h>
+#include <vital/types/descriptor_matrix_set.h>
 #include <cereal/archives/portable_binary.hpp>
 
 using namespace kwiver::vital;
@@ -135,6 +136,18 @@ template <typename Archive, typename T>
 void
 save_descriptors(Archive & ar, descriptor_set_sptr const& descriptors)
 {
+  // descriptors stored as a matrix are written a row at a time
+  if( auto dm = std::dynamic_pointer_cast<descriptor_matrix_set<T> >(descriptors) )
+  {
+    cereal::size_type dim = dm->cols();
+    ar( cereal::make_size_tag( dim ) );
+    for( size_t i = 0; i < dm->rows(); ++i )
+    {
+      ar( cereal::binary_data( dm->row(i), dim * sizeof(T) ) );
+    }
+    return;
+  }
+
   // dimensionality of each descriptor
   cereal::size_type dim = descriptors->at(0)->size();
   ar( cereal::make_size_tag( dim ) );
@@ -152,11 +165,7 @@ save_descriptors(Archive & ar, descriptor_set_sptr const& descriptors)
     }
     if( auto dt = std::dynamic_pointer_cast<descriptor_array_of<T> >(d) )
     {
-      const T* data = dt->raw_data();
-      for(unsigned i=0; i<dim; ++i, ++data)
-      {
-        ar( *data );
-      }
+      ar( cereal::binary_data( dt->raw_data(), dim * sizeof(T) ) );
     }
     else
     {
@@ -169,6 +178,10 @@ save_descriptors(Archive & ar, descriptor_set_sptr const& descriptors)
 
 // ----------------------------------------------------------------------------
 // Helper function to unserialized a vector of N descriptors of known type
+/*
+ * The descriptors are read into a single matrix rather than one heap
+ * object per descriptor.
+ */
 template <typename Archive, typename T>
 vital::descriptor_set_sptr
 read_descriptors(Archive & ar, size_t num_desc)
@@ -177,31 +190,13 @@ read_descriptors(Archive & ar, size_t num_desc)
   cereal::size_type dim;
   ar( cereal::make_size_tag( dim ) );
 
-  std::vector<descriptor_sptr> descriptors;
-  descriptors.reserve(num_desc);
+  auto descriptors =
+    std::make_shared<vital::descriptor_matrix_set<T> >(num_desc, dim);
   for( size_t i = 0; i < num_desc; ++i )
   {
-    std::shared_ptr<descriptor_array_of<T> > d;
-    // allocate fixed vectors for common dimensions
-    switch( dim )
-    {
-      case 128:
-        d = std::make_shared<descriptor_fixed<T,128> >();
-        break;
-      case 64:
-        d = std::make_shared<descriptor_fixed<T,64> >();
-        break;
-      default:
-        d = std::make_shared<descriptor_dynamic<T> >(dim);
-    }
-    T* data = d->raw_data();
-    for(unsigned x = 0; x < dim; ++x, ++data)
-    {
-      ar( *data );
-    }
-    descriptors.push_back(d);
+    ar( cereal::binary_data( descriptors->row(i), dim * sizeof(T) ) );
   }
-  return std::make_shared<vital::simple_descriptor_set>(descriptors);
+  return descriptors;
 }
 
 // ----------------------------------------------------------------------------
@@ -9,11 +9,13 @@
 #include "filter_features_nonmax.h"
 
 #include <vital/types/image.h>
+#include <vital/util/parallel_chunks.h>
 #include <vital/util/transform_image.h>
 
 #include <Eigen/Geometry>
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 using namespace kwiver::vital;
 
@@ -149,13 +151,92 @@ class nonmax_suppressor
   double m_scale_min;
 };
 
+// ----------------------------------------------------------------------------
+// Compute the adaptive non-max suppression radius of each point: the
+// distance to the nearest point before it, or max_radius if that is closer.
+// Points are bucketed in a grid as they are visited so that only the cells
+// near each point are searched.
+std::vector<double>
+compute_anms_radii(std::vector<vector_2d> const& points,
+                   Eigen::AlignedBox<double, 2> const& bbox,
+                   double max_radius)
+{
+  std::vector<double> radii(points.size(), max_radius);
+  if (points.empty())
+  {
+    return radii;
+  }
+
+  // use cells holding about one point each when all have been added
+  const vector_2d sizes = bbox.sizes();
+  const double n = static_cast<double>(points.size());
+  double cell = std::sqrt(sizes[0] * sizes[1] / n);
+  if (!(cell > 0.0))
+  {
+    cell = std::max(sizes.maxCoeff() / n, 1.0);
+  }
+  const int dim_x = static_cast<int>(sizes[0] / cell) + 1;
+  const int dim_y = static_cast<int>(sizes[1] / cell) + 1;
+  // each cell is a linked list of points through the next array
+  const unsigned none = std::numeric_limits<unsigned>::max();
+  std::vector<unsigned> heads(static_cast<size_t>(dim_x) * dim_y, none);
+  std::vector<unsigned> next(points.size(), none);
+
+  const double max_radius2 = max_radius * max_radius;
+  for (unsigned i = 0; i < points.size(); ++i)
+  {
+    const vector_2d& p = points[i];
+    const int cx = std::min(static_cast<int>((p[0] - bbox.min()[0]) / cell),
+                            dim_x - 1);
+    const int cy = std::min(static_cast<int>((p[1] - bbox.min()[1]) / cell),
+                            dim_y - 1);
+
+    // search rings of cells outward until they are farther than the best
+    double best2 = max_radius2;
+    const int max_ring = std::max(dim_x, dim_y);
+    for (int k = 0; k <= max_ring; ++k)
+    {
+      const double reach = (k - 1) * cell;
+      if (k > 1 && reach * reach >= best2)
+      {
+        break;
+      }
+      for (int y = std::max(cy - k, 0); y <= std::min(cy + k, dim_y - 1); ++y)
+      {
+        // interior rows of the ring only have cells at the two ends
+        const bool edge_row = (y == cy - k || y == cy + k);
+        const int step = (edge_row || k == 0) ? 1 : 2 * k;
+        for (int x = cx - k; x <= cx + k; x += step)
+        {
+          if (x < 0 || x >= dim_x)
+          {
+            continue;
+          }
+          for (unsigned j = heads[y * dim_x + x]; j != none; j = next[j])
+          {
+            best2 = std::min(best2, (points[j] - p).squaredNorm());
+          }
+        }
+      }
+    }
+    if (best2 < max_radius2)
+    {
+      radii[i] = std::sqrt(best2);
+    }
+    next[i] = heads[cy * dim_x + cx];
+    heads[cy * dim_x + cx] = i;
+  }
+  return radii;
+}
+
 /// Private implementation class
 class filter_features_nonmax::priv
 {
 public:
   /// Constructor
   priv()
-    : suppression_radius(0),
+    : method("mask"),
+      suppression_radius(0),
       resolution(3),
       num_features_target(500),
       num_features_range(50)
@@ -219,6 +300,12 @@ class filter_features_nonmax::priv
     double high_radius = (wph + std::sqrt(wph*wph + 4 * m*w*h)) / (2 * m);
     double low_radius = 0.0;
 
+    if (method == "anms")
+    {
+      return filter_anms(feat_vec, indices, bbox, scale_min, scale_steps,
+                         high_radius, ind);
+    }
+
     // initial guess for radius, if not specified
     if (suppression_radius <= 0.0)
     {
@@ -292,7 +379,110 @@ class filter_features_nonmax::priv
       vital::simple_feature_set(filtered));
   }
 
+  // --------------------------------------------------------------------------
+  // Keep the features farthest from any stronger feature at the same scale,
+  // where indices are sorted by descending magnitude
+  feature_set_sptr
+  filter_anms(std::vector<feature_sptr> const& feat_vec,
+              std::vector<std::pair<unsigned int, double> > const& indices,
+              Eigen::AlignedBox<double, 2> const& bbox,
+              double scale_min, unsigned scale_steps,
+              double high_radius,
+              std::vector<unsigned int> &ind) const
+  {
+    // the radius at which to stop searching; with a target count no more
+    // than the target can be spread farther apart than high_radius
+    const double max_radius = num_features_target > 0 ? high_radius
+                                                      : suppression_radius;
+    const size_t num_feat = indices.size();
+
+    // split the features, keeping their magnitude order, into scale bands
+    std::vector<std::vector<unsigned> > bands(scale_steps);
+    for (unsigned i = 0; i < num_feat; ++i)
+    {
+      auto const& f = feat_vec[indices[i].first];
+      auto const s = static_cast<unsigned>(std::log2(f->scale()) - scale_min);
+      bands[s].push_back(i);
+    }
+
+    // compute radii in each band in parallel, measured in units of the
+    // band scale as the masks do
+    std::vector<double> radii(num_feat, max_radius);
+    if (max_radius > 0.0)
+    {
+      vital::parallel_chunks(scale_steps, 1, [&](size_t begin, size_t end)
+      {
+        for (size_t s = begin; s < end; ++s)
+        {
+          const double band_scale = std::ldexp(1.0, static_cast<int>(s));
+          std::vector<vector_2d> points;
+          points.reserve(bands[s].size());
+          for (unsigned i : bands[s])
+          {
+            points.push_back(feat_vec[indices[i].first]->loc());
+          }
+          auto const band_radii =
+            compute_anms_radii(points, bbox, max_radius * band_scale);
+          for (size_t k = 0; k < band_radii.size(); ++k)
+          {
+            radii[bands[s][k]] = band_radii[k] / band_scale;
+          }
+        }
+      });
+    }
+
+    // select the largest radii, preferring stronger features on ties
+    std::vector<unsigned> selected;
+    if (num_features_target > 0)
+    {
+      selected.resize(num_feat);
+      for (unsigned i = 0; i < num_feat; ++i)
+      {
+        selected[i] = i;
+      }
+      auto const num_keep = std::min<size_t>(num_features_target, num_feat);
+      std::nth_element(selected.begin(), selected.begin() + num_keep,
+                       selected.end(),
+                       [&radii](unsigned l, unsigned r)
+                       {
+                         return radii[l] > radii[r] ||
+                                (radii[l] == radii[r] && l < r);
+                       });
+      selected.resize(num_keep);
+      std::sort(selected.begin(), selected.end());
+    }
+    else
+    {
+      for (unsigned i = 0; i < num_feat; ++i)
+      {
+        if (radii[i] >= max_radius)
+        {
+          selected.push_back(i);
+        }
+      }
+    }
+
+    double min_radius = max_radius;
+    std::vector<feature_sptr> filtered;
+    filtered.reserve(selected.size());
+    ind.clear();
+    ind.reserve(selected.size());
+    for (unsigned i : selected)
+    {
+      ind.push_back(indices[i].first);
+      filtered.push_back(feat_vec[indices[i].first]);
+      min_radius = std::min(min_radius, radii[i]);
+    }
+
+    LOG_INFO(m_logger, "Reduced " << feat_vec.size() << " features to "
+                       << filtered.size() << " features with adaptive "
+                       "non-max radius " << min_radius);
+
+    return std::make_shared<vital::simple_feature_set>(filtered);
+  }
+
   // configuration paramters
+  std::string method;
   mutable double suppression_radius;
   unsigned int resolution;
   unsigned int num_features_target;
@@ -329,6 +519,19 @@ ::get_configuration() const
   vital::config_block_sptr config =
       vital::algo::filter_features::get_configuration();
 
+  config->set_value("method", d_->method,
+                    "The suppression method, either \"mask\" or \"anms\". "
+                    "The mask method covers a disk around each kept feature "
+                    "in a mask per scale and searches for the radius "
+                    "giving the target number of features.  The anms "
+                    "(adaptive non-max suppression) method computes, in one "
+                    "pass, the distance from each feature to the nearest "
+                    "stronger feature of similar scale and keeps exactly "
+                    "num_features_target features with the largest "
+                    "distances, or if that is 0 the features with no "
+                    "stronger feature within suppression_radius.  It is "
+                    "faster for many features.");
+
   config->set_value("suppression_radius", d_->suppression_radius,
                     "The radius, in pixels, within which to "
                     "suppress weaker features.  This is an initial guess. "
@@ -365,6 +568,7 @@ ::set_configuration(vital::config_block_sptr config)
 #define GET_VALUE(name, type) \
   d_->name = config->get_value<type>(#name, d_->name)
 
+  GET_VALUE(method, std::string);
   GET_VALUE(suppression_radius, double);
   GET_VALUE(resolution, unsigned int);
   GET_VALUE(num_features_target, unsigned int);
@@ -387,6 +591,14 @@ ::check_configuration(vital::config_block_sptr config) const
     return false;
   }
 
+  std::string method = config->get_value<std::string>("method", d_->method);
+  if (method != "mask" && method != "anms")
+  {
+    LOG_ERROR(logger(), "method must be \"mask\" or \"anms\", not \""
+                        << method << "\"");
+    return false;
+  }
+
   return true;
 }
 
@@ -0,0 +1,88 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Implementation of utilities for running algorithms on image tiles
+ */
+
+#include "image_tiles.h"
+
+#include <algorithm>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+// ----------------------------------------------------------------------------
+std::vector<image_tile>
+split_image_tiles(size_t width, size_t height,
+                  size_t tile_width, size_t tile_height, size_t overlap)
+{
+  tile_width = std::max<size_t>(tile_width, 1);
+  tile_height = std::max<size_t>(tile_height, 1);
+
+  std::vector<image_tile> tiles;
+  for (size_t y0 = 0; y0 < height; y0 += tile_height)
+  {
+    size_t const y1 = std::min(y0 + tile_height, height);
+    for (size_t x0 = 0; x0 < width; x0 += tile_width)
+    {
+      size_t const x1 = std::min(x0 + tile_width, width);
+      image_tile tile;
+      tile.core_x0 = x0;
+      tile.core_y0 = y0;
+      tile.core_x1 = x1;
+      tile.core_y1 = y1;
+      tile.x = x0 > overlap ? x0 - overlap : 0;
+      tile.y = y0 > overlap ? y0 - overlap : 0;
+      tile.width = std::min(x1 + overlap, width) - tile.x;
+      tile.height = std::min(y1 + overlap, height) - tile.y;
+      tiles.push_back(tile);
+    }
+  }
+  return tiles;
+}
+
+// ----------------------------------------------------------------------------
+size_t
+tile_index(vital::vector_2d const& loc, size_t width, size_t height,
+           size_t tile_width, size_t tile_height)
+{
+  tile_width = std::max<size_t>(tile_width, 1);
+  tile_height = std::max<size_t>(tile_height, 1);
+  size_t const cols = (width + tile_width - 1) / tile_width;
+  size_t const rows = (height + tile_height - 1) / tile_height;
+
+  auto const bin = [](double v, size_t size, size_t count)
+  {
+    if (!(v >= 0.0) || count == 0)
+    {
+      return size_t{ 0 };
+    }
+    if (!(v < static_cast<double>(size * count)))
+    {
+      return count - 1;
+    }
+    return static_cast<size_t>(v) / size;
+  };
+  return bin(loc[1], tile_height, rows) * cols +
+         bin(loc[0], tile_width, cols);
+}
+
+// ----------------------------------------------------------------------------
+vital::image_container_sptr
+crop_tile(vital::image_container_sptr const& image, image_tile const& tile)
+{
+  if (!image)
+  {
+    return nullptr;
+  }
+  return std::make_shared<vital::simple_image_container>(
+    image->get_image().crop(tile.x, tile.y, tile.width, tile.height));
+}
+
+} // end namespace core
+} // end namespace arrows
+} // end namespace kwiver
@@ -0,0 +1,76 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Utilities for running algorithms on overlapping image tiles
+ */
+
+#ifndef KWIVER_ARROWS_CORE_IMAGE_TILES_H_
+#define KWIVER_ARROWS_CORE_IMAGE_TILES_H_
+
+#include <arrows/core/kwiver_algo_core_export.h>
+
+#include <vital/types/image_container.h>
+#include <vital/types/vector.h>
+
+#include <vector>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+/// A tile of an image split into a grid
+/**
+ * The cores of the tiles partition the image, so each image location is
+ * owned by exactly one tile.  The region to process extends the core by the
+ * overlap on each side, clipped to the image.
+ */
+struct KWIVER_ALGO_CORE_EXPORT image_tile
+{
+  /// The region to process, including the overlap
+  size_t x, y, width, height;
+
+  /// The owned region, from (core_x0, core_y0) up to (core_x1, core_y1)
+  size_t core_x0, core_y0, core_x1, core_y1;
+
+  /// Whether an image location is in the core of this tile
+  bool owns(vital::vector_2d const& loc) const
+  {
+    return loc[0] >= core_x0 && loc[0] < core_x1 &&
+           loc[1] >= core_y0 && loc[1] < core_y1;
+  }
+};
+
+/// Split an image into a grid of overlapping tiles in raster order
+/**
+ * \param width        the image width
+ * \param height       the image height
+ * \param tile_width   the width of the tile cores, the last column may be
+ *                     narrower
+ * \param tile_height  the height of the tile cores, the last row may be
+ *                     shorter
+ * \param overlap      the number of pixels each tile extends past its core
+ */
+KWIVER_ALGO_CORE_EXPORT
+std::vector<image_tile>
+split_image_tiles(size_t width, size_t height,
+                  size_t tile_width, size_t tile_height, size_t overlap);
+
+/// Index of the tile owning an image location, clamped to the image
+KWIVER_ALGO_CORE_EXPORT
+size_t
+tile_index(vital::vector_2d const& loc, size_t width, size_t height,
+           size_t tile_width, size_t tile_height);
+
+/// Get a view of a tile of an image, or nullptr if \p image is nullptr
+KWIVER_ALGO_CORE_EXPORT
+vital::image_container_sptr
+crop_tile(vital::image_container_sptr const& image, image_tile const& tile);
+
+} // end namespace core
+} // end namespace arrows
+} // end namespace kwiver
+
+#endif // KWIVER_ARROWS_CORE_IMAGE_TILES_H_
@@ -0,0 +1,194 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Implementation of read only memory mapped files
+ */
+
+#include "mapped_file.h"
+
+#include <vital/exceptions/io.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+// ----------------------------------------------------------------------------
+class mapped_file::priv
+{
+public:
+  priv() { reset(); }
+  ~priv() { unmap(); }
+
+  void reset();
+  void unmap();
+
+  char const* base;
+  uint64_t size;
+  bool open;
+#ifdef _WIN32
+  HANDLE file_handle;
+  HANDLE mapping_handle;
+#endif
+};
+
+// ----------------------------------------------------------------------------
+void
+mapped_file::priv
+::reset()
+{
+  base = nullptr;
+  size = 0;
+  open = false;
+#ifdef _WIN32
+  file_handle = INVALID_HANDLE_VALUE;
+  mapping_handle = NULL;
+#endif
+}
+
+// ----------------------------------------------------------------------------
+void
+mapped_file::priv
+::unmap()
+{
+  if( base )
+  {
+#ifdef _WIN32
+    UnmapViewOfFile( base );
+    CloseHandle( mapping_handle );
+#else
+    munmap( const_cast< char* >( base ), size );
+#endif
+  }
+#ifdef _WIN32
+  if( file_handle != INVALID_HANDLE_VALUE )
+  {
+    CloseHandle( file_handle );
+  }
+#endif
+  reset();
+}
+
+// ----------------------------------------------------------------------------
+mapped_file
+::mapped_file()
+  : d( new priv )
+{
+}
+
+mapped_file
+::~mapped_file()
+{
+}
+
+// ----------------------------------------------------------------------------
+void
+mapped_file
+::open( std::string const& filename )
+{
+  close();
+
+#ifdef _WIN32
+  d->file_handle = CreateFileA( filename.c_str(), GENERIC_READ,
+                                FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, NULL );
+  LARGE_INTEGER file_size;
+  if( d->file_handle == INVALID_HANDLE_VALUE ||
+      !GetFileSizeEx( d->file_handle, &file_size ) )
+  {
+    d->unmap();
+    VITAL_THROW( vital::file_not_found_exception, filename, "open failed" );
+  }
+  d->size = static_cast< uint64_t >( file_size.QuadPart );
+  if( d->size > 0 )
+  {
+    d->mapping_handle = CreateFileMapping( d->file_handle, NULL,
+                                           PAGE_READONLY, 0, 0, NULL );
+    void* view = d->mapping_handle
+      ? MapViewOfFile( d->mapping_handle, FILE_MAP_READ, 0, 0, 0 )
+      : NULL;
+    if( !view )
+    {
+      if( d->mapping_handle )
+      {
+        CloseHandle( d->mapping_handle );
+      }
+      d->unmap();
+      VITAL_THROW( vital::file_not_found_exception, filename, "mapping failed" );
+    }
+    d->base = static_cast< char const* >( view );
+  }
+#else
+  int const fd = ::open( filename.c_str(), O_RDONLY );
+  struct stat st;
+  if( fd < 0 || fstat( fd, &st ) != 0 )
+  {
+    if( fd >= 0 )
+    {
+      ::close( fd );
+    }
+    VITAL_THROW( vital::file_not_found_exception, filename, "open failed" );
+  }
+  d->size = static_cast< uint64_t >( st.st_size );
+  if( d->size > 0 )
+  {
+    void* const view = mmap( nullptr, d->size, PROT_READ, MAP_SHARED, fd, 0 );
+    if( view == MAP_FAILED )
+    {
+      ::close( fd );
+      d->reset();
+      VITAL_THROW( vital::file_not_found_exception, filename, "mapping failed" );
+    }
+    d->base = static_cast< char const* >( view );
+  }
+  // the mapping stays valid after the descriptor is closed
+  ::close( fd );
+#endif
+
+  d->open = true;
+}
+
+// ----------------------------------------------------------------------------
+void
+mapped_file
+::close()
+{
+  d->unmap();
+}
+
+// ----------------------------------------------------------------------------
+bool
+mapped_file
+::is_open() const
+{
+  return d->open;
+}
+
+// ----------------------------------------------------------------------------
+char const*
+mapped_file
+::data() const
+{
+  return d->base;
+}
+
+// ----------------------------------------------------------------------------
+uint64_t
+mapped_file
+::size() const
+{
+  return d->size;
+}
+
+} } } // end namespace
@@ -0,0 +1,61 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Interface for read only memory mapped files
+ */
+
+#ifndef KWIVER_ARROWS_CORE_MAPPED_FILE_H
+#define KWIVER_ARROWS_CORE_MAPPED_FILE_H
+
+#include <arrows/core/kwiver_algo_core_export.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+// ----------------------------------------------------------------------------
+/// A read only memory mapping of a whole file
+/**
+ * Pages of the file are read from disk as they are first accessed. The
+ * mapping stays valid until the file is closed or this object is
+ * destroyed; the file should not be modified while it is mapped.
+ */
+class KWIVER_ALGO_CORE_EXPORT mapped_file
+{
+public:
+  mapped_file();
+  ~mapped_file();
+
+  /// Map the named file, closing any file already mapped
+  /**
+   * \throws vital::file_not_found_exception if the file can not be read.
+   */
+  void open( std::string const& filename );
+
+  /// Release the mapping
+  void close();
+
+  /// Whether a file is open
+  bool is_open() const;
+
+  /// The start of the file contents, or null if the file is empty
+  char const* data() const;
+
+  /// The size of the file in bytes
+  uint64_t size() const;
+
+private:
+  class priv;
+  std::unique_ptr< priv > d;
+};
+
+} } } // end namespace
+
+#endif // KWIVER_ARROWS_CORE_MAPPED_FILE_H
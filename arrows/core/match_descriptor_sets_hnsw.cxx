@@ -0,0 +1,984 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Implementation of the core match_descriptor_sets_hnsw algorithm
+ */
+
+#include "match_descriptor_sets_hnsw.h"
+
+#include <arrows/core/mapped_file.h>
+
+#include <vital/exceptions/base.h>
+#include <vital/exceptions/io.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <queue>
+#include <utility>
+#include <vector>
+
+using namespace kwiver::vital;
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+namespace {
+
+/*
+ * Index file layout
+ *
+ * All values are in host byte order.  The header is followed by these
+ * sections, each starting on a multiple of 8 bytes:
+ *
+ *  frames         int64 frame number of each node
+ *  levels         int32 top graph layer of each node
+ *  link offsets   uint64 start of the links of each node, plus the end
+ *  links          uint32; for each node and each layer from 0 up to its
+ *                 level, the number of neighbors followed by their indices
+ *  vectors        float frame descriptor of each node
+ */
+char const file_magic[ 8 ] = { 'K', 'W', 'V', 'R', 'H', 'N', 'S', 'W' };
+uint32_t const file_version = 1;
+uint32_t const byte_order_mark = 0x01020304;
+
+struct file_header
+{
+  char magic[ 8 ];
+  uint32_t version;
+  uint32_t byte_order;
+  uint64_t num_nodes;
+  uint64_t num_links;
+  uint32_t dimension;
+  uint32_t binary;
+  uint32_t entry_point;
+  int32_t max_level;
+  uint64_t frames_offset;
+  uint64_t levels_offset;
+  uint64_t link_offsets_offset;
+  uint64_t links_offset;
+  uint64_t vectors_offset;
+};
+
+uint32_t const no_node = static_cast< uint32_t >( -1 );
+
+// ----------------------------------------------------------------------------
+uint64_t
+align8( uint64_t offset )
+{
+  return ( offset + 7 ) / 8 * 8;
+}
+
+// ----------------------------------------------------------------------------
+// Mix the bits of x; used to draw node levels reproducibly from node indices
+uint64_t
+splitmix64( uint64_t x )
+{
+  x += 0x9e3779b97f4a7c15ull;
+  x = ( x ^ ( x >> 30 ) ) * 0xbf58476d1ce4e5b9ull;
+  x = ( x ^ ( x >> 27 ) ) * 0x94d049bb133111ebull;
+  return x ^ ( x >> 31 );
+}
+
+typedef std::pair< float, uint32_t > dist_node_t;
+
+} // end anonymous namespace
+
+// Private implementation class
+class match_descriptor_sets_hnsw::priv
+{
+public:
+  // Constructor
+  priv()
+  : max_results(10),
+    min_similarity(0.0),
+    max_connections(16),
+    ef_construction(100),
+    ef_search(64),
+    binary_descriptors(true),
+    snapshot_interval(100),
+    dimension(0),
+    num_mapped(0),
+    mapped_vectors(nullptr),
+    entry_point(no_node),
+    max_level(-1),
+    visit_generation(0),
+    num_unsaved(0)
+  {
+  }
+
+  struct node
+  {
+    frame_id_t frame;
+    int level;
+    // neighbor indices on each layer from 0 to level
+    std::vector< std::vector< uint32_t > > links;
+  };
+
+  std::vector< float > aggregate( descriptor_set_sptr const& desc ) const;
+
+  float const* vector( uint32_t i ) const
+  {
+    return i < num_mapped
+      ? mapped_vectors + size_t( i ) * dimension
+      : extra_vectors.data() + size_t( i - num_mapped ) * dimension;
+  }
+
+  float distance( float const* a, float const* b ) const
+  {
+    float dot = 0.0f;
+    for( size_t i = 0; i < dimension; ++i )
+    {
+      dot += a[ i ] * b[ i ];
+    }
+    return 1.0f - dot;
+  }
+
+  size_t max_links( int layer ) const
+  {
+    return layer == 0 ? 2 * max_connections : max_connections;
+  }
+
+  int random_level( size_t index ) const;
+
+  std::vector< dist_node_t >
+  search_layer( float const* q, std::vector< uint32_t > const& entries,
+                size_t ef, int layer );
+
+  std::vector< uint32_t >
+  select_neighbors( std::vector< dist_node_t > const& candidates,
+                    size_t m ) const;
+
+  void insert( std::vector< float > const& vec, frame_id_t frame );
+
+  std::vector< frame_id_t > search( std::vector< float > const& vec );
+
+  void clear();
+  void unmap();
+
+  // configuration
+  size_t max_results;
+  double min_similarity;
+  size_t max_connections;
+  size_t ef_construction;
+  size_t ef_search;
+  bool binary_descriptors;
+  std::string index_path;
+  size_t snapshot_interval;
+
+  // the length of the frame descriptors, or 0 before any are indexed
+  size_t dimension;
+
+  // frame descriptors of the first num_mapped nodes are read in place from
+  // the index file; those of later nodes are held in extra_vectors
+  mapped_file file;
+  size_t num_mapped;
+  float const* mapped_vectors;
+  std::vector< float > extra_vectors;
+
+  std::vector< node > nodes;
+  uint32_t entry_point;
+  int max_level;
+
+  // nodes visited by the current search have this generation
+  std::vector< uint32_t > visited;
+  uint32_t visit_generation;
+
+  // the number of frames appended since the index was last saved
+  size_t num_unsaved;
+
+  vital::logger_handle_t m_logger;
+};
+
+// ----------------------------------------------------------------------------
+// Aggregate a set of descriptors into one unit length frame descriptor
+std::vector< float >
+match_descriptor_sets_hnsw::priv
+::aggregate( descriptor_set_sptr const& desc ) const
+{
+  std::vector< float > vec;
+  if( !desc || desc->empty() )
+  {
+    return vec;
+  }
+
+  size_t count = 0;
+  std::vector< double > sum;
+  for( auto const& d : desc->descriptors() )
+  {
+    if( !d )
+    {
+      continue;
+    }
+    size_t const length = binary_descriptors ? 8 * d->num_bytes() : d->size();
+    if( sum.empty() )
+    {
+      sum.resize( length, 0.0 );
+    }
+    else if( sum.size() != length )
+    {
+      VITAL_THROW( invalid_value,
+                   "descriptors in a set must all have the same length" );
+    }
+
+    if( binary_descriptors )
+    {
+      auto const bytes = d->as_bytes();
+      for( size_t i = 0; i < d->num_bytes(); ++i )
+      {
+        for( unsigned b = 0; b < 8; ++b )
+        {
+          sum[ 8 * i + b ] += ( bytes[ i ] >> b ) & 1;
+        }
+      }
+    }
+    else
+    {
+      auto const values = d->as_double();
+      for( size_t i = 0; i < length; ++i )
+      {
+        sum[ i ] += values[ i ];
+      }
+    }
+    ++count;
+  }
+  if( count == 0 )
+  {
+    return vec;
+  }
+
+  // center bit frequencies on zero so that bits which are set as often as
+  // not carry no weight
+  double const offset = binary_descriptors ? 0.5 : 0.0;
+  double norm = 0.0;
+  vec.resize( sum.size() );
+  for( size_t i = 0; i < sum.size(); ++i )
+  {
+    double const v = sum[ i ] / count - offset;
+    vec[ i ] = static_cast< float >( v );
+    norm += v * v;
+  }
+  if( norm > 0.0 )
+  {
+    float const scale = static_cast< float >( 1.0 / std::sqrt( norm ) );
+    for( auto& v : vec )
+    {
+      v *= scale;
+    }
+  }
+  return vec;
+}
+
+// ----------------------------------------------------------------------------
+// Draw a level from an exponential distribution, so that each layer has
+// about 1 / max_connections as many nodes as the one below
+int
+match_descriptor_sets_hnsw::priv
+::random_level( size_t index ) const
+{
+  double const u =
+    ( ( splitmix64( index ) >> 11 ) + 1.0 ) / 9007199254740993.0;
+  double const scale = 1.0 / std::log( static_cast< double >(
+    std::max< size_t >( max_connections, 2 ) ) );
+  return static_cast< int >( -std::log( u ) * scale );
+}
+
+// ----------------------------------------------------------------------------
+// Find the ef nodes nearest q on one layer, by best first search from the
+// entry nodes; the result is sorted from nearest to farthest
+std::vector< dist_node_t >
+match_descriptor_sets_hnsw::priv
+::search_layer( float const* q, std::vector< uint32_t > const& entries,
+                size_t ef, int layer )
+{
+  if( visited.size() < nodes.size() )
+  {
+    visited.resize( nodes.size(), 0 );
+  }
+  if( ++visit_generation == 0 )
+  {
+    std::fill( visited.begin(), visited.end(), 0 );
+    visit_generation = 1;
+  }
+
+  // candidates to expand, nearest first, and results found, farthest first
+  std::priority_queue< dist_node_t, std::vector< dist_node_t >,
+                       std::greater< dist_node_t > > candidates;
+  std::priority_queue< dist_node_t > results;
+  for( auto const e : entries )
+  {
+    visited[ e ] = visit_generation;
+    dist_node_t const dn( distance( q, vector( e ) ), e );
+    candidates.push( dn );
+    results.push( dn );
+  }
+  while( results.size() > ef )
+  {
+    results.pop();
+  }
+
+  while( !candidates.empty() )
+  {
+    auto const c = candidates.top();
+    if( c.first > results.top().first && results.size() >= ef )
+    {
+      break;
+    }
+    candidates.pop();
+
+    for( auto const n : nodes[ c.second ].links[ layer ] )
+    {
+      if( visited[ n ] == visit_generation )
+      {
+        continue;
+      }
+      visited[ n ] = visit_generation;
+
+      float const dist = distance( q, vector( n ) );
+      if( results.size() < ef || dist < results.top().first )
+      {
+        candidates.push( dist_node_t( dist, n ) );
+        results.push( dist_node_t( dist, n ) );
+        if( results.size() > ef )
+        {
+          results.pop();
+        }
+      }
+    }
+  }
+
+  std::vector< dist_node_t > nearest( results.size() );
+  for( size_t i = nearest.size(); i > 0; --i )
+  {
+    nearest[ i - 1 ] = results.top();
+    results.pop();
+  }
+  return nearest;
+}
+
+// ----------------------------------------------------------------------------
+// Choose up to m neighbors from candidates sorted nearest first, preferring
+// candidates which are nearer the new node than any neighbor already chosen so that
+// links spread out in different directions
+std::vector< uint32_t >
+match_descriptor_sets_hnsw::priv
+::select_neighbors( std::vector< dist_node_t > const& candidates,
+                    size_t m ) const
+{
+  std::vector< uint32_t > selected;
+  std::vector< uint32_t > pruned;
+  for( auto const& c : candidates )
+  {
+    if( selected.size() >= m )
+    {
+      break;
+    }
+    bool diverse = true;
+    for( auto const s : selected )
+    {
+      if( distance( vector( c.second ), vector( s ) ) < c.first )
+      {
+        diverse = false;
+        break;
+      }
+    }
+    ( diverse ? selected : pruned ).push_back( c.second );
+  }
+
+  // keep the graph well connected by filling up with the pruned candidates
+  for( size_t i = 0; i < pruned.size() && selected.size() < m; ++i )
+  {
+    selected.push_back( pruned[ i ] );
+  }
+  return selected;
+}
+
+// ----------------------------------------------------------------------------
+void
+match_descriptor_sets_hnsw::priv
+::insert( std::vector< float > const& vec, frame_id_t frame )
+{
+  if( dimension == 0 )
+  {
+    dimension = vec.size();
+  }
+  else if( vec.size() != dimension )
+  {
+    VITAL_THROW( invalid_value,
+                 "descriptor length differs from the indexed descriptors" );
+  }
+
+  auto const index = static_cast< uint32_t >( nodes.size() );
+  extra_vectors.insert( extra_vectors.end(), vec.begin(), vec.end() );
+
+  node n;
+  n.frame = frame;
+  n.level = random_level( index );
+  n.links.resize( n.level + 1 );
+  nodes.push_back( std::move( n ) );
+  ++num_unsaved;
+
+  if( entry_point == no_node )
+  {
+    entry_point = index;
+    max_level = nodes[ index ].level;
+    return;
+  }
+
+  float const* const q = vector( index );
+  int const level = nodes[ index ].level;
+
+  // descend greedily through the layers above the new node
+  std::vector< uint32_t > entries( 1, entry_point );
+  for( int layer = max_level; layer > level; --layer )
+  {
+    entries[ 0 ] = search_layer( q, entries, 1, layer ).front().second;
+  }
+
+  for( int layer = std::min( level, max_level ); layer >= 0; --layer )
+  {
+    auto const nearest = search_layer( q, entries, ef_construction, layer );
+    auto const neighbors = select_neighbors( nearest, max_connections );
+    nodes[ index ].links[ layer ] = neighbors;
+
+    // link back from each neighbor, pruning its links if there are too many
+    for( auto const nb : neighbors )
+    {
+      auto& links = nodes[ nb ].links[ layer ];
+      links.push_back( index );
+      if( links.size() > max_links( layer ) )
+      {
+        float const* const v = vector( nb );
+        std::vector< dist_node_t > candidates;
+        for( auto const l : links )
+        {
+          candidates.push_back( dist_node_t( distance( v, vector( l ) ), l ) );
+        }
+        std::sort( candidates.begin(), candidates.end() );
+        links = select_neighbors( candidates, max_links( layer ) );
+      }
+    }
+
+    entries.clear();
+    for( auto const& dn : nearest )
+    {
+      entries.push_back( dn.second );
+    }
+  }
+
+  if( level > max_level )
+  {
+    entry_point = index;
+    max_level = level;
+  }
+}
+
+// ----------------------------------------------------------------------------
+std::vector< frame_id_t >
+match_descriptor_sets_hnsw::priv
+::search( std::vector< float > const& vec )
+{
+  std::vector< frame_id_t > frames;
+  if( entry_point == no_node || vec.empty() )
+  {
+    return frames;
+  }
+  if( vec.size() != dimension )
+  {
+    VITAL_THROW( invalid_value,
+                 "descriptor length differs from the indexed descriptors" );
+  }
+
+  float const* const q = vec.data();
+  std::vector< uint32_t > entries( 1, entry_point );
+  for( int layer = max_level; layer > 0; --layer )
+  {
+    entries[ 0 ] = search_layer( q, entries, 1, layer ).front().second;
+  }
+  auto const nearest =
+    search_layer( q, entries, std::max( ef_search, max_results ), 0 );
+
+  for( auto const& dn : nearest )
+  {
+    if( frames.size() >= max_results ||
+        1.0 - dn.first < min_similarity )
+    {
+      break;
+    }
+    frames.push_back( nodes[ dn.second ].frame );
+  }
+  return frames;
+}
+
+// ----------------------------------------------------------------------------
+void
+match_descriptor_sets_hnsw::priv
+::clear()
+{
+  file.close();
+  num_mapped = 0;
+  mapped_vectors = nullptr;
+  extra_vectors.clear();
+  nodes.clear();
+  visited.clear();
+  dimension = 0;
+  entry_point = no_node;
+  max_level = -1;
+  num_unsaved = 0;
+}
+
+// ----------------------------------------------------------------------------
+// Copy the mapped frame descriptors into memory and release the file
+void
+match_descriptor_sets_hnsw::priv
+::unmap()
+{
+  if( num_mapped > 0 )
+  {
+    extra_vectors.insert( extra_vectors.begin(), mapped_vectors,
+                          mapped_vectors + num_mapped * dimension );
+  }
+  num_mapped = 0;
+  mapped_vectors = nullptr;
+  file.close();
+}
+
+// ----------------------------------------------------------------------------
+// Constructor
+match_descriptor_sets_hnsw
+::match_descriptor_sets_hnsw()
+: d_( new priv )
+{
+  attach_logger( "arrows.core.match_descriptor_sets_hnsw" );
+  d_->m_logger = logger();
+}
+
+// Destructor
+match_descriptor_sets_hnsw
+::~match_descriptor_sets_hnsw()
+{
+  if( !d_->index_path.empty() && d_->num_unsaved > 0 )
+  {
+    try
+    {
+      save( d_->index_path );
+    }
+    catch( std::exception const& e )
+    {
+      LOG_ERROR( logger(), "Failed to save index: " << e.what() );
+    }
+    catch( ... )
+    {
+      LOG_ERROR( logger(), "Failed to save index: unknown error" );
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Get this alg's \link vital::config_block configuration block \endlink
+vital::config_block_sptr
+match_descriptor_sets_hnsw
+::get_configuration() const
+{
+  vital::config_block_sptr config = algorithm::get_configuration();
+  config->set_value( "max_results", d_->max_results,
+                     "The maximum number of frames returned by a query." );
+  config->set_value( "min_similarity", d_->min_similarity,
+                     "Frames whose cosine similarity to the query is less "
+                     "than this are not returned." );
+  config->set_value( "max_connections", d_->max_connections,
+                     "The number of neighbors linked to each frame on each "
+                     "graph layer; the bottom layer allows twice as many. "
+                     "More connections improve recall and use more memory." );
+  config->set_value( "ef_construction", d_->ef_construction,
+                     "The number of candidate neighbors considered when "
+                     "inserting a frame. Larger values build a better graph "
+                     "more slowly." );
+  config->set_value( "ef_search", d_->ef_search,
+                     "The number of candidates considered by a query. Larger "
+                     "values improve recall and make queries slower." );
+  config->set_value( "binary_descriptors", d_->binary_descriptors,
+                     "Aggregate descriptors as bit strings, as for ORB, "
+                     "rather than as vectors of numbers." );
+  config->set_value( "index_path", d_->index_path,
+                     "If set, the index is loaded from this file if it "
+                     "exists and is saved to it periodically and on exit." );
+  config->set_value( "snapshot_interval", d_->snapshot_interval,
+                     "Save the index to index_path after this many frames "
+                     "are added. If 0, the index is only saved on exit." );
+  return config;
+}
+
+// ----------------------------------------------------------------------------
+void
+match_descriptor_sets_hnsw
+::set_configuration( vital::config_block_sptr in_config )
+{
+  vital::config_block_sptr config = this->get_configuration();
+  config->merge_config( in_config );
+
+  d_->max_results = config->get_value< size_t >( "max_results" );
+  d_->min_similarity = config->get_value< double >( "min_similarity" );
+  d_->max_connections = config->get_value< size_t >( "max_connections" );
+  d_->ef_construction = config->get_value< size_t >( "ef_construction" );
+  d_->ef_search = config->get_value< size_t >( "ef_search" );
+  d_->binary_descriptors = config->get_value< bool >( "binary_descriptors" );
+  d_->snapshot_interval = config->get_value< size_t >( "snapshot_interval" );
+
+  auto const index_path = config->get_value< std::string >( "index_path" );
+  if( index_path != d_->index_path )
+  {
+    d_->index_path = index_path;
+    if( !index_path.empty() &&
+        kwiversys::SystemTools::FileExists( index_path, true ) )
+    {
+      load( index_path );
+      LOG_INFO( logger(), "Loaded " << size() << " frames from index "
+                          << index_path );
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+bool
+match_descriptor_sets_hnsw
+::check_configuration( vital::config_block_sptr config ) const
+{
+  bool valid = true;
+  if( config->get_value< size_t >( "max_connections",
+                                   d_->max_connections ) < 2 )
+  {
+    LOG_ERROR( logger(), "max_connections must be at least 2" );
+    valid = false;
+  }
+  if( config->get_value< size_t >( "ef_construction",
+                                   d_->ef_construction ) < 1 ||
+      config->get_value< size_t >( "ef_search", d_->ef_search ) < 1 ||
+      config->get_value< size_t >( "max_results", d_->max_results ) < 1 )
+  {
+    LOG_ERROR( logger(), "ef_construction, ef_search and max_results must "
+                         "be positive" );
+    valid = false;
+  }
+  return valid;
+}
+
+// ----------------------------------------------------------------------------
+void
+match_descriptor_sets_hnsw
+::append_to_index( const descriptor_set_sptr desc, frame_id_t frame )
+{
+  auto const vec = d_->aggregate( desc );
+  if( vec.empty() )
+  {
+    LOG_DEBUG( logger(), "No descriptors to index for frame " << frame );
+    return;
+  }
+  d_->insert( vec, frame );
+
+  if( !d_->index_path.empty() && d_->snapshot_interval > 0 &&
+      d_->num_unsaved >= d_->snapshot_interval )
+  {
+    save( d_->index_path );
+  }
+}
+
+// ----------------------------------------------------------------------------
+std::vector< frame_id_t >
+match_descriptor_sets_hnsw
+::query( const descriptor_set_sptr desc )
+{
+  return d_->search( d_->aggregate( desc ) );
+}
+
+// ----------------------------------------------------------------------------
+std::vector< frame_id_t >
+match_descriptor_sets_hnsw
+::query_and_append( const descriptor_set_sptr desc, frame_id_t frame )
+{
+  // aggregate once for both operations
+  auto const vec = d_->aggregate( desc );
+  auto const frames = d_->search( vec );
+  if( !vec.empty() )
+  {
+    d_->insert( vec, frame );
+    if( !d_->index_path.empty() && d_->snapshot_interval > 0 &&
+        d_->num_unsaved >= d_->snapshot_interval )
+    {
+      save( d_->index_path );
+    }
+  }
+  return frames;
+}
+
+// ----------------------------------------------------------------------------
+size_t
+match_descriptor_sets_hnsw
+::size() const
+{
+  return d_->nodes.size();
+}
+
+// ----------------------------------------------------------------------------
+void
+match_descriptor_sets_hnsw
+::save( std::string const& filename )
+{
+  auto const& nodes = d_->nodes;
+
+  std::vector< uint64_t > link_offsets( 1, 0 );
+  for( auto const& n : nodes )
+  {
+    uint64_t count = 0;
+    for( auto const& l : n.links )
+    {
+      count += 1 + l.size();
+    }
+    link_offsets.push_back( link_offsets.back() + count );
+  }
+
+  file_header header;
+  std::memset( &header, 0, sizeof( header ) );
+  std::memcpy( header.magic, file_magic, sizeof( file_magic ) );
+  header.version = file_version;
+  header.byte_order = byte_order_mark;
+  header.num_nodes = nodes.size();
+  header.num_links = link_offsets.back();
+  header.dimension = static_cast< uint32_t >( d_->dimension );
+  header.binary = d_->binary_descriptors ? 1 : 0;
+  header.entry_point = d_->entry_point;
+  header.max_level = d_->max_level;
+  header.frames_offset = align8( sizeof( header ) );
+  header.levels_offset =
+    align8( header.frames_offset + nodes.size() * sizeof( int64_t ) );
+  header.link_offsets_offset =
+    align8( header.levels_offset + nodes.size() * sizeof( int32_t ) );
+  header.links_offset = align8( header.link_offsets_offset +
+                                link_offsets.size() * sizeof( uint64_t ) );
+  header.vectors_offset =
+    align8( header.links_offset + header.num_links * sizeof( uint32_t ) );
+
+  std::string const tmp_name = filename + ".tmp";
+  {
+    std::ofstream ofs( tmp_name, std::ios::binary );
+    if( !ofs )
+    {
+      VITAL_THROW( file_write_exception, tmp_name, "open failed" );
+    }
+
+    uint64_t pos = 0;
+    auto write = [ &ofs, &pos ]( void const* data, size_t bytes )
+    {
+      ofs.write( static_cast< char const* >( data ),
+                 static_cast< std::streamsize >( bytes ) );
+      pos += bytes;
+    };
+    auto pad_to = [ &write, &pos ]( uint64_t offset )
+    {
+      char const zeros[ 8 ] = {};
+      write( zeros, offset - pos );
+    };
+
+    write( &header, sizeof( header ) );
+
+    pad_to( header.frames_offset );
+    for( auto const& n : nodes )
+    {
+      int64_t const frame = n.frame;
+      write( &frame, sizeof( frame ) );
+    }
+
+    pad_to( header.levels_offset );
+    for( auto const& n : nodes )
+    {
+      int32_t const level = n.level;
+      write( &level, sizeof( level ) );
+    }
+
+    pad_to( header.link_offsets_offset );
+    write( link_offsets.data(), link_offsets.size() * sizeof( uint64_t ) );
+
+    pad_to( header.links_offset );
+    for( auto const& n : nodes )
+    {
+      for( auto const& l : n.links )
+      {
+        uint32_t const count = static_cast< uint32_t >( l.size() );
+        write( &count, sizeof( count ) );
+        write( l.data(), l.size() * sizeof( uint32_t ) );
+      }
+    }
+
+    pad_to( header.vectors_offset );
+    for( uint32_t i = 0; i < nodes.size(); ++i )
+    {
+      write( d_->vector( i ), d_->dimension * sizeof( float ) );
+    }
+
+    ofs.close();
+    if( !ofs )
+    {
+      VITAL_THROW( file_write_exception, tmp_name, "write failed" );
+    }
+  }
+
+  if( std::rename( tmp_name.c_str(), filename.c_str() ) != 0 )
+  {
+    // some platforms do not replace existing or mapped files
+    d_->unmap();
+    std::remove( filename.c_str() );
+    if( std::rename( tmp_name.c_str(), filename.c_str() ) != 0 )
+    {
+      VITAL_THROW( file_write_exception, filename, "rename failed" );
+    }
+  }
+  d_->num_unsaved = 0;
+}
+
+// ----------------------------------------------------------------------------
+void
+match_descriptor_sets_hnsw
+::load( std::string const& filename )
+{
+  d_->clear();
+  d_->file.open( filename );
+
+  auto const fail = [ this, &filename ]( std::string const& reason )
+  {
+    d_->clear();
+    VITAL_THROW( invalid_data, reason + ": " + filename );
+  };
+
+  char const* const base = d_->file.data();
+  uint64_t const size = d_->file.size();
+  file_header header;
+  if( size < sizeof( header ) )
+  {
+    fail( "too small to be a descriptor set index" );
+  }
+  std::memcpy( &header, base, sizeof( header ) );
+  if( std::memcmp( header.magic, file_magic, sizeof( file_magic ) ) != 0 )
+  {
+    fail( "not a descriptor set index" );
+  }
+  if( header.byte_order != byte_order_mark )
+  {
+    fail( "descriptor set index was written with a different byte order" );
+  }
+  if( header.version != file_version )
+  {
+    fail( "unsupported descriptor set index version "
+          + std::to_string( header.version ) );
+  }
+  if( ( header.binary != 0 ) != d_->binary_descriptors )
+  {
+    fail( "descriptor set index was built with a different "
+          "binary_descriptors setting" );
+  }
+
+  // bound each count by the bytes after the header before computing the
+  // section sizes, so that a corrupt count cannot overflow them
+  uint64_t const n = header.num_nodes;
+  uint64_t const available = size - sizeof( header );
+  if( n > available / sizeof( int64_t ) ||
+      header.num_links > available / sizeof( uint32_t ) ||
+      ( n > 0 && header.dimension > available / sizeof( float ) / n ) )
+  {
+    fail( "truncated or corrupt descriptor set index" );
+  }
+
+  struct section_t { uint64_t offset, bytes; };
+  section_t const sections[] = {
+    { header.frames_offset, n * sizeof( int64_t ) },
+    { header.levels_offset, n * sizeof( int32_t ) },
+    { header.link_offsets_offset, ( n + 1 ) * sizeof( uint64_t ) },
+    { header.links_offset, header.num_links * sizeof( uint32_t ) },
+    { header.vectors_offset, n * header.dimension * sizeof( float ) },
+  };
+  for( auto const& s : sections )
+  {
+    if( s.offset % 8 != 0 || s.offset > size || s.bytes > size - s.offset )
+    {
+      fail( "truncated or corrupt descriptor set index" );
+    }
+  }
+  if( n > 0 && ( header.entry_point >= n || header.dimension == 0 ) )
+  {
+    fail( "corrupt descriptor set index" );
+  }
+
+  // every layer of a node starts with its number of neighbors, so a node at
+  // the top level needs more link words than the level before its links
+  // can be allocated
+  if( n > 0 && ( header.max_level < 0 ||
+                 static_cast< uint64_t >( header.max_level ) >=
+                   header.num_links ) )
+  {
+    fail( "corrupt descriptor set index" );
+  }
+
+  auto const frames =
+    reinterpret_cast< int64_t const* >( base + header.frames_offset );
+  auto const levels =
+    reinterpret_cast< int32_t const* >( base + header.levels_offset );
+  auto const link_offsets =
+    reinterpret_cast< uint64_t const* >( base + header.link_offsets_offset );
+  auto const links =
+    reinterpret_cast< uint32_t const* >( base + header.links_offset );
+
+  // the graph is copied so that it can be extended; the frame descriptors
+  // stay in the mapped file
+  d_->nodes.resize( n );
+  for( uint64_t i = 0; i < n; ++i )
+  {
+    auto& node = d_->nodes[ i ];
+    node.frame = frames[ i ];
+    node.level = levels[ i ];
+    uint64_t pos = link_offsets[ i ];
+    uint64_t const end = link_offsets[ i + 1 ];
+    if( node.level < 0 || node.level > header.max_level ||
+        pos > end || end > header.num_links ||
+        static_cast< uint64_t >( node.level ) >= end - pos )
+    {
+      fail( "corrupt descriptor set index" );
+    }
+    node.links.resize( node.level + 1 );
+    for( auto& l : node.links )
+    {
+      if( pos >= end || links[ pos ] > end - pos - 1 )
+      {
+        fail( "corrupt descriptor set index" );
+      }
+      l.assign( links + pos + 1, links + pos + 1 + links[ pos ] );
+      pos += 1 + links[ pos ];
+      for( auto const nb : l )
+      {
+        if( nb >= n )
+        {
+          fail( "corrupt descriptor set index" );
+        }
+      }
+    }
+  }
+
+  d_->dimension = n > 0 ? header.dimension : 0;
+  d_->num_mapped = n;
+  d_->mapped_vectors =
+    n > 0 ? reinterpret_cast< float const* >( base + header.vectors_offset )
+          : nullptr;
+  d_->entry_point = n > 0 ? header.entry_point : no_node;
+  d_->max_level = n > 0 ? header.max_level : -1;
+}
+
+} // end namespace core
+} // end namespace arrows
+} // end namespace kwiver
@@ -0,0 +1,114 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Header defining the core match_descriptor_sets_hnsw algorithm
+ */
+
+#ifndef KWIVER_ARROWS_CORE_MATCH_DESCRIPTOR_SETS_HNSW_H_
+#define KWIVER_ARROWS_CORE_MATCH_DESCRIPTOR_SETS_HNSW_H_
+
+#include <arrows/core/kwiver_algo_core_export.h>
+
+#include <vital/algo/match_descriptor_sets.h>
+
+#include <string>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+/// Match descriptor sets with an approximate nearest neighbor graph
+/**
+ *  Each descriptor set is aggregated into one normalized frame descriptor.
+ *  Binary descriptors contribute the mean of each bit, centered on zero;
+ *  other descriptors contribute the mean of each element.  Frame
+ *  descriptors are indexed in a hierarchical navigable small world (HNSW)
+ *  graph and compared by cosine similarity, so both insertion and queries
+ *  take time roughly logarithmic in the number of indexed frames.  No
+ *  vocabulary needs to be trained.
+ *
+ *  When \c index_path is set, the index is reloaded from that file when the
+ *  algorithm is configured and written back to it periodically and when the
+ *  algorithm is destroyed.  The stored frame descriptors are memory mapped
+ *  rather than read, so reloading a large index is fast and frames can be
+ *  appended straight away.
+ */
+class KWIVER_ALGO_CORE_EXPORT match_descriptor_sets_hnsw
+  : public vital::algo::match_descriptor_sets
+{
+public:
+  PLUGIN_INFO( "hnsw",
+               "Approximate nearest neighbor matching of aggregated "
+               "descriptor sets with an HNSW graph index." )
+
+  /// Default Constructor
+  match_descriptor_sets_hnsw();
+
+  /// Destructor, writes the index to \c index_path if it has changed
+  virtual ~match_descriptor_sets_hnsw();
+
+  /// Get this alg's \link vital::config_block configuration block \endlink
+  vital::config_block_sptr get_configuration() const override;
+  /// Set this algo's properties via a config block
+  /**
+   * \throws vital::invalid_data if \c index_path names a file which is not
+   *         a valid index.
+   */
+  void set_configuration( vital::config_block_sptr config ) override;
+  /// Check that the algorithm's currently configuration is valid
+  bool check_configuration( vital::config_block_sptr config ) const override;
+
+  /// Add a descriptor set to the index
+  /**
+   * \throws vital::invalid_value if the descriptors differ in length from
+   *         those already indexed.
+   */
+  void append_to_index( const vital::descriptor_set_sptr desc,
+                        vital::frame_id_t frame ) override;
+
+  /// Return the indexed frames most similar to a descriptor set
+  /**
+   * Frames are ordered from most to least similar.
+   */
+  std::vector< vital::frame_id_t >
+  query( const vital::descriptor_set_sptr desc ) override;
+
+  /// Query the index and then add the descriptor set to it
+  std::vector< vital::frame_id_t >
+  query_and_append( const vital::descriptor_set_sptr desc,
+                    vital::frame_id_t frame ) override;
+
+  /// The number of frames in the index
+  size_t size() const;
+
+  /// Write the index to a file
+  /**
+   * The file is written next to \p filename and then renamed, so an
+   * existing index is replaced only once the new one is complete.
+   *
+   * \throws vital::file_write_exception if the file can not be written.
+   */
+  void save( std::string const& filename );
+
+  /// Replace the index with one read from a file
+  /**
+   * \throws vital::file_not_found_exception if the file can not be read.
+   * \throws vital::invalid_data if the file is not a valid index, or was
+   *         built with different \c binary_descriptors setting.
+   */
+  void load( std::string const& filename );
+
+private:
+  /// private implementation class
+  class priv;
+  const std::unique_ptr< priv > d_;
+};
+
+} // end namespace core
+} // end namespace arrows
+} // end namespace kwiver
+
+#endif
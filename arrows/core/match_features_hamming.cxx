@@ -0,0 +1,460 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Implementation of the core match_features_hamming algorithm
+ */
+
+#include "match_features_hamming.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <vital/exceptions/base.h>
+#include <vital/types/descriptor_matrix_set.h>
+#include <vital/types/match_set.h>
+#include <vital/util/parallel_chunks.h>
+#include <vital/vital_config.h>
+
+#if ( defined( __x86_64__ ) || defined( __i386__ ) ) && \
+    ( defined( __GNUC__ ) || defined( __clang__ ) )
+#define KWIVER_HAMMING_X86
+#include <immintrin.h>
+#if ( defined( __clang__ ) && __clang_major__ >= 7 ) || \
+    ( !defined( __clang__ ) && __GNUC__ >= 8 )
+#define KWIVER_HAMMING_AVX512
+#endif
+#endif
+
+using namespace kwiver::vital;
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+namespace {
+
+// Queries matched by one thread pool task
+constexpr size_t query_block_size = 64;
+
+// Descriptors of the second set compared with each query block at a time;
+// 512 descriptors of 64 bytes fill 32 KB, a typical L1 data cache
+constexpr size_t train_block_size = 512;
+
+// ----------------------------------------------------------------------------
+inline unsigned
+popcount64( uint64_t x )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+  return static_cast< unsigned >( __builtin_popcountll( x ) );
+#else
+  x = x - ( ( x >> 1 ) & 0x5555555555555555ull );
+  x = ( x & 0x3333333333333333ull ) + ( ( x >> 2 ) & 0x3333333333333333ull );
+  x = ( x + ( x >> 4 ) ) & 0x0f0f0f0f0f0f0f0full;
+  return static_cast< unsigned >( ( x * 0x0101010101010101ull ) >> 56 );
+#endif
+}
+
+// ----------------------------------------------------------------------------
+unsigned
+hamming_scalar( uint8_t const* a, uint8_t const* b, size_t n )
+{
+  unsigned dist = 0;
+  size_t i = 0;
+  for( ; i + 8 <= n; i += 8 )
+  {
+    uint64_t x, y;
+    std::memcpy( &x, a + i, 8 );
+    std::memcpy( &y, b + i, 8 );
+    dist += popcount64( x ^ y );
+  }
+  for( ; i < n; ++i )
+  {
+    dist += popcount64( static_cast< uint64_t >( a[i] ^ b[i] ) );
+  }
+  return dist;
+}
+
+#ifdef KWIVER_HAMMING_X86
+// ----------------------------------------------------------------------------
+// Count bits per byte with a nibble lookup table, then sum the bytes of each
+// 64-bit lane with a sum of absolute differences against zero
+__attribute__(( target( "avx2" ) ))
+unsigned
+hamming_avx2( uint8_t const* a, uint8_t const* b, size_t n )
+{
+  __m256i const lut = _mm256_setr_epi8( 0, 1, 1, 2, 1, 2, 2, 3,
+                                        1, 2, 2, 3, 2, 3, 3, 4,
+                                        0, 1, 1, 2, 1, 2, 2, 3,
+                                        1, 2, 2, 3, 2, 3, 3, 4 );
+  __m256i const low_mask = _mm256_set1_epi8( 0x0f );
+  __m256i const zero = _mm256_setzero_si256();
+  __m256i acc = zero;
+
+  size_t i = 0;
+  for( ; i + 32 <= n; i += 32 )
+  {
+    __m256i const x = _mm256_xor_si256(
+      _mm256_loadu_si256( reinterpret_cast< __m256i const* >( a + i ) ),
+      _mm256_loadu_si256( reinterpret_cast< __m256i const* >( b + i ) ) );
+    __m256i const lo = _mm256_and_si256( x, low_mask );
+    __m256i const hi = _mm256_and_si256( _mm256_srli_epi16( x, 4 ), low_mask );
+    __m256i const cnt = _mm256_add_epi8( _mm256_shuffle_epi8( lut, lo ),
+                                         _mm256_shuffle_epi8( lut, hi ) );
+    acc = _mm256_add_epi64( acc, _mm256_sad_epu8( cnt, zero ) );
+  }
+
+  uint64_t lanes[4];
+  _mm256_storeu_si256( reinterpret_cast< __m256i* >( lanes ), acc );
+  auto const dist =
+    static_cast< unsigned >( lanes[0] + lanes[1] + lanes[2] + lanes[3] );
+  return dist + hamming_scalar( a + i, b + i, n - i );
+}
+#endif
+
+#ifdef KWIVER_HAMMING_AVX512
+// ----------------------------------------------------------------------------
+__attribute__(( target( "avx512f,avx512vpopcntdq" ) ))
+unsigned
+hamming_avx512( uint8_t const* a, uint8_t const* b, size_t n )
+{
+  __m512i acc = _mm512_setzero_si512();
+
+  size_t i = 0;
+  for( ; i + 64 <= n; i += 64 )
+  {
+    __m512i const x = _mm512_xor_si512( _mm512_loadu_si512( a + i ),
+                                        _mm512_loadu_si512( b + i ) );
+    acc = _mm512_add_epi64( acc, _mm512_popcnt_epi64( x ) );
+  }
+
+  auto const dist = static_cast< unsigned >( _mm512_reduce_add_epi64( acc ) );
+  return dist + hamming_scalar( a + i, b + i, n - i );
+}
+#endif
+
+typedef unsigned ( *hamming_func_t )( uint8_t const*, uint8_t const*, size_t );
+
+// ----------------------------------------------------------------------------
+// Choose the fastest distance function the processor supports
+hamming_func_t
+select_hamming_func( size_t num_bytes )
+{
+#ifdef KWIVER_HAMMING_AVX512
+  if( num_bytes >= 64 &&
+      __builtin_cpu_supports( "avx512f" ) &&
+      __builtin_cpu_supports( "avx512vpopcntdq" ) )
+  {
+    return hamming_avx512;
+  }
+#endif
+#ifdef KWIVER_HAMMING_X86
+  if( num_bytes >= 32 && __builtin_cpu_supports( "avx2" ) )
+  {
+    return hamming_avx2;
+  }
+#endif
+  (void) num_bytes;
+  return hamming_scalar;
+}
+
+// ----------------------------------------------------------------------------
+// A descriptor set as a byte matrix, packed into one if needed
+struct byte_matrix
+{
+  explicit byte_matrix( descriptor_set_sptr const& desc )
+  {
+    if( !desc )
+    {
+      return;
+    }
+    matrix =
+      std::dynamic_pointer_cast< descriptor_matrix_set< uint8_t > >( desc );
+    if( !matrix )
+    {
+      // throws invalid_value unless all descriptors are byte arrays of the
+      // same length
+      matrix = std::make_shared< descriptor_matrix_set< uint8_t > >(
+        desc->descriptors() );
+    }
+  }
+
+  size_t rows() const { return matrix ? matrix->rows() : 0; }
+  size_t cols() const { return matrix ? matrix->cols() : 0; }
+  uint8_t const* row( size_t r ) const { return matrix->row( r ); }
+
+  std::shared_ptr< descriptor_matrix_set< uint8_t > const > matrix;
+};
+
+// ----------------------------------------------------------------------------
+// The closest match found so far
+struct nearest_t
+{
+  unsigned dist = std::numeric_limits< unsigned >::max();
+  unsigned index = std::numeric_limits< unsigned >::max();
+};
+
+// ----------------------------------------------------------------------------
+// Whether index at dist is closer than n, taking the lower index on a tie
+// so that the result does not depend on the order of comparison
+inline bool
+closer( unsigned dist, unsigned index, nearest_t const& n )
+{
+  return dist < n.dist || ( dist == n.dist && index < n.index );
+}
+
+// ----------------------------------------------------------------------------
+// Buffers for the best query of each train descriptor, one per concurrent
+// task; a task takes a buffer for each query block and returns it after
+class reverse_buffers
+{
+public:
+  explicit reverse_buffers( size_t num_train ) : num_train_( num_train ) {}
+
+  std::vector< nearest_t >* acquire()
+  {
+    std::lock_guard< std::mutex > lock( mutex_ );
+    if( free_.empty() )
+    {
+      all_.emplace_back( new std::vector< nearest_t >( num_train_ ) );
+      return all_.back().get();
+    }
+    auto* const buffer = free_.back();
+    free_.pop_back();
+    return buffer;
+  }
+
+  void release( std::vector< nearest_t >* buffer )
+  {
+    std::lock_guard< std::mutex > lock( mutex_ );
+    free_.push_back( buffer );
+  }
+
+  // the best query of each train descriptor over all buffers
+  std::vector< nearest_t > reduce() const
+  {
+    std::vector< nearest_t > result( num_train_ );
+    for( auto const& buffer : all_ )
+    {
+      for( size_t t = 0; t < num_train_; ++t )
+      {
+        auto const& n = ( *buffer )[ t ];
+        if( closer( n.dist, n.index, result[ t ] ) )
+        {
+          result[ t ] = n;
+        }
+      }
+    }
+    return result;
+  }
+
+private:
+  size_t num_train_;
+  std::mutex mutex_;
+  std::vector< std::unique_ptr< std::vector< nearest_t > > > all_;
+  std::vector< std::vector< nearest_t >* > free_;
+};
+
+} // end anonymous namespace
+
+// Private implementation class
+class match_features_hamming::priv
+{
+public:
+  // Constructor
+  priv()
+  : ratio_test(0.8),
+    cross_check(true),
+    max_distance(0)
+  {
+  }
+
+  // keep matches only if best distance < ratio_test * second best distance
+  double ratio_test;
+
+  // keep matches only if they are also best in the reverse direction
+  bool cross_check;
+
+  // keep matches only if they are within this distance, 0 for no limit
+  unsigned max_distance;
+};
+
+// ----------------------------------------------------------------------------
+// Constructor
+match_features_hamming
+::match_features_hamming()
+: d_(new priv)
+{
+  attach_logger( "arrows.core.match_features_hamming" );
+}
+
+// Destructor
+match_features_hamming
+::~match_features_hamming()
+{
+}
+
+// ----------------------------------------------------------------------------
+// Get this alg's \link vital::config_block configuration block \endlink
+vital::config_block_sptr
+match_features_hamming
+::get_configuration() const
+{
+  vital::config_block_sptr config = algorithm::get_configuration();
+  config->set_value( "ratio_test", d_->ratio_test,
+                     "Keep a match only if its distance is less than this "
+                     "fraction of the distance to the second best match. "
+                     "A value of 1 or more disables the test." );
+  config->set_value( "cross_check", d_->cross_check,
+                     "Keep a match only if each descriptor is the best match "
+                     "of the other." );
+  config->set_value( "max_distance", d_->max_distance,
+                     "Keep a match only if its Hamming distance, in bits, is "
+                     "no more than this. A value of 0 disables the limit." );
+  return config;
+}
+
+// ----------------------------------------------------------------------------
+void
+match_features_hamming
+::set_configuration( vital::config_block_sptr in_config )
+{
+  vital::config_block_sptr config = this->get_configuration();
+  config->merge_config( in_config );
+
+  d_->ratio_test = config->get_value< double >( "ratio_test" );
+  d_->cross_check = config->get_value< bool >( "cross_check" );
+  d_->max_distance = config->get_value< unsigned >( "max_distance" );
+}
+
+// ----------------------------------------------------------------------------
+bool
+match_features_hamming
+::check_configuration( vital::config_block_sptr config ) const
+{
+  double ratio_test =
+    config->get_value< double >( "ratio_test", d_->ratio_test );
+  if( ratio_test <= 0.0 )
+  {
+    LOG_ERROR( logger(), "ratio_test must be positive, got " << ratio_test );
+    return false;
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// Match one set of features and corresponding descriptors to another
+match_set_sptr
+match_features_hamming
+::match(VITAL_UNUSED feature_set_sptr feat1, descriptor_set_sptr desc1,
+        VITAL_UNUSED feature_set_sptr feat2, descriptor_set_sptr desc2) const
+{
+  byte_matrix const query( desc1 );
+  byte_matrix const train( desc2 );
+  size_t const num_query = query.rows();
+  size_t const num_train = train.rows();
+  if( num_query == 0 || num_train == 0 )
+  {
+    return std::make_shared<simple_match_set>();
+  }
+
+  size_t const num_bytes = query.cols();
+  if( train.cols() != num_bytes )
+  {
+    VITAL_THROW( invalid_value,
+                 "descriptor sets to match differ in descriptor length" );
+  }
+  auto const hamming = select_hamming_func( num_bytes );
+
+  // the best and second best match of each query
+  std::vector< nearest_t > best( num_query ), second( num_query );
+
+  // the best query for each train descriptor, found separately by each
+  // concurrent task and reduced afterward
+  reverse_buffers block_reverse( d_->cross_check ? num_train : 0 );
+
+  parallel_chunks( num_query, query_block_size,
+    [&]( size_t q_begin, size_t q_end )
+    {
+      std::vector< nearest_t >* reverse = nullptr;
+      if( d_->cross_check )
+      {
+        reverse = block_reverse.acquire();
+      }
+
+      for( size_t t_begin = 0; t_begin < num_train;
+           t_begin += train_block_size )
+      {
+        size_t const t_end = std::min( num_train, t_begin + train_block_size );
+        for( size_t q = q_begin; q < q_end; ++q )
+        {
+          uint8_t const* q_row = query.row( q );
+          nearest_t& b1 = best[ q ];
+          nearest_t& b2 = second[ q ];
+          for( size_t t = t_begin; t < t_end; ++t )
+          {
+            unsigned const dist = hamming( q_row, train.row( t ), num_bytes );
+            if( dist < b1.dist )
+            {
+              b2 = b1;
+              b1.dist = dist;
+              b1.index = static_cast< unsigned >( t );
+            }
+            else if( dist < b2.dist )
+            {
+              b2.dist = dist;
+              b2.index = static_cast< unsigned >( t );
+            }
+            if( reverse &&
+                closer( dist, static_cast< unsigned >( q ), ( *reverse )[ t ] ) )
+            {
+              ( *reverse )[ t ].dist = dist;
+              ( *reverse )[ t ].index = static_cast< unsigned >( q );
+            }
+          }
+        }
+      }
+
+      if( reverse )
+      {
+        block_reverse.release( reverse );
+      }
+    } );
+
+  std::vector< nearest_t > const reverse_best = block_reverse.reduce();
+
+  std::vector<vital::match> matches;
+  for( size_t q = 0; q < num_query; ++q )
+  {
+    auto const& b1 = best[ q ];
+    if( d_->max_distance > 0 && b1.dist > d_->max_distance )
+    {
+      continue;
+    }
+    if( d_->ratio_test < 1.0 &&
+        second[ q ].dist != std::numeric_limits< unsigned >::max() &&
+        b1.dist >= d_->ratio_test * second[ q ].dist )
+    {
+      continue;
+    }
+    if( d_->cross_check && reverse_best[ b1.index ].index != q )
+    {
+      continue;
+    }
+    matches.push_back( vital::match( static_cast< unsigned >( q ),
+                                     b1.index ) );
+  }
+
+  return std::make_shared<simple_match_set>( matches );
+}
+
+} // end namespace core
+} // end namespace arrows
+} // end namespace kwiver
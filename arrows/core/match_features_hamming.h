@@ -0,0 +1,86 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Header defining the core match_features_hamming algorithm
+ */
+
+#ifndef KWIVER_ARROWS_CORE_MATCH_FEATURES_HAMMING_H_
+#define KWIVER_ARROWS_CORE_MATCH_FEATURES_HAMMING_H_
+
+#include <arrows/core/kwiver_algo_core_export.h>
+
+#include <vital/algo/match_features.h>
+#include <vital/config/config_block.h>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+/// Brute force matching of binary descriptors by Hamming distance
+/**
+ *  This algorithm matches binary descriptors, such as ORB, BRISK or FREAK,
+ *  stored as arrays of bytes (for example descriptor_fixed<uint8_t, N>).
+ *  Every descriptor in the first set is compared with every descriptor in
+ *  the second set.  Descriptors held in a descriptor_matrix_set<uint8_t>
+ *  are used in place; other sets are first packed into one.
+ *
+ *  The distance computation uses AVX-512 VPOPCNTDQ or AVX2 instructions
+ *  when the processor supports them, and a portable population count
+ *  otherwise.  The second set is processed in blocks sized to stay in
+ *  cache, and blocks of the first set are matched in parallel on the
+ *  thread pool.  The results do not depend on which instructions are used
+ *  or how the work is divided.
+ *
+ *  Matches may be filtered by the ratio of the best to second best
+ *  distance, by a maximum distance, and by requiring that the match is
+ *  also the best in the reverse direction (cross check).
+ */
+class KWIVER_ALGO_CORE_EXPORT match_features_hamming
+  : public vital::algo::match_features
+{
+public:
+  PLUGIN_INFO( "hamming",
+               "Brute force matching of binary descriptors"
+               " by Hamming distance." )
+
+  /// Default Constructor
+  match_features_hamming();
+
+  /// Destructor
+  virtual ~match_features_hamming();
+
+  /// Get this alg's \link vital::config_block configuration block \endlink
+  virtual vital::config_block_sptr get_configuration() const;
+  /// Set this algo's properties via a config block
+  virtual void set_configuration(vital::config_block_sptr config);
+  /// Check that the algorithm's currently configuration is valid
+  virtual bool check_configuration(vital::config_block_sptr config) const;
+
+  /// Match one set of features and corresponding descriptors to another
+  /**
+   * \param [in] feat1 the first set of features to match
+   * \param [in] desc1 the descriptors corresponding to \a feat1
+   * \param [in] feat2 the second set of features to match
+   * \param [in] desc2 the descriptors corresponding to \a feat2
+   * \returns a set of matching indices from \a feat1 to \a feat2
+   * \throws vital::invalid_value if the descriptors are not byte arrays
+   *         of a common length
+   */
+  virtual vital::match_set_sptr
+  match(vital::feature_set_sptr feat1, vital::descriptor_set_sptr desc1,
+        vital::feature_set_sptr feat2, vital::descriptor_set_sptr desc2) const;
+
+private:
+  /// private implementation class
+  class priv;
+  const std::unique_ptr<priv> d_;
+};
+
+} // end namespace core
+} // end namespace arrows
+} // end namespace kwiver
+
+#endif
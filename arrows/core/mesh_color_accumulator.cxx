@@ -0,0 +1,416 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Implementation of kwiver::arrows::core::mesh_color_accumulator
+ */
+
+#include "mesh_color_accumulator.h"
+
+#include <arrows/core/render_mesh_depth_map.h>
+
+#include <vital/exceptions/base.h>
+#include <vital/logger/logger.h>
+#include <vital/util/parallel_chunks.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+namespace {
+
+// the number of histogram bins per channel and the levels in each
+enum { num_bins = 16, bin_width = 256 / num_bins };
+
+// the colors accumulated for one vertex
+struct vertex_stats
+{
+  uint32_t count;
+  uint32_t sum[3];
+  uint8_t min[3];
+  uint8_t max[3];
+  uint16_t hist[3][num_bins];
+};
+
+// ----------------------------------------------------------------------------
+vertex_stats
+empty_stats()
+{
+  vertex_stats s = {};
+  std::fill(s.min, s.min + 3, uint8_t{ 255 });
+  return s;
+}
+
+// ----------------------------------------------------------------------------
+void
+add_value(vertex_stats& s, int c, uint8_t v)
+{
+  s.sum[c] += v;
+  s.min[c] = std::min(s.min[c], v);
+  s.max[c] = std::max(s.max[c], v);
+
+  auto* const hist = s.hist[c];
+  auto& bin = hist[v / bin_width];
+  if (bin == std::numeric_limits<uint16_t>::max())
+  {
+    // halve the whole histogram, which keeps the median close, rather
+    // than overflow
+    for (int b = 0; b < num_bins; ++b)
+    {
+      hist[b] = static_cast<uint16_t>((hist[b] + 1) / 2);
+    }
+  }
+  ++bin;
+}
+
+// ----------------------------------------------------------------------------
+// Interpolate the median of one channel assuming values are spread evenly
+// within each histogram bin
+uint8_t
+approx_median(vertex_stats const& s, int c)
+{
+  auto const* const hist = s.hist[c];
+  double total = 0.0;
+  for (int b = 0; b < num_bins; ++b)
+  {
+    total += hist[b];
+  }
+
+  double const half = total / 2.0;
+  double below = 0.0;
+  for (int b = 0; b < num_bins; ++b)
+  {
+    if (hist[b] > 0 && below + hist[b] >= half)
+    {
+      double const v = bin_width * (b + (half - below) / hist[b]);
+      return static_cast<uint8_t>(
+        std::round(std::min<double>(std::max<double>(v, s.min[c]), s.max[c])));
+    }
+    below += hist[b];
+  }
+  return s.max[c];
+}
+
+} // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+class mesh_color_accumulator::priv
+{
+public:
+  priv(vital::mesh_sptr m)
+    : mesh(m),
+      occlusion_threshold(0.0),
+      remove_back_faces(true),
+      num_frames(0),
+      stats(m->num_verts(), empty_stats())
+  {
+  }
+
+  vital::mesh_sptr mesh;
+  double occlusion_threshold;
+  bool remove_back_faces;
+  size_t num_frames;
+  std::vector<vertex_stats> stats;
+};
+
+// ----------------------------------------------------------------------------
+mesh_color_accumulator
+::mesh_color_accumulator(vital::mesh_sptr mesh)
+{
+  if (!mesh || mesh->vertices().dim() != 3)
+  {
+    VITAL_THROW(vital::invalid_value,
+                "mesh_color_accumulator requires a mesh of 3D vertices");
+  }
+  d_.reset(new priv(mesh));
+}
+
+// ----------------------------------------------------------------------------
+mesh_color_accumulator
+::~mesh_color_accumulator()
+{
+}
+
+// ----------------------------------------------------------------------------
+void
+mesh_color_accumulator
+::set_occlusion_threshold(double threshold)
+{
+  d_->occlusion_threshold = threshold;
+}
+
+// ----------------------------------------------------------------------------
+void
+mesh_color_accumulator
+::set_remove_back_faces(bool remove)
+{
+  d_->remove_back_faces = remove;
+}
+
+// ----------------------------------------------------------------------------
+unsigned
+mesh_color_accumulator
+::add_frame(vital::image_container const& image,
+            vital::camera_perspective_sptr camera,
+            vital::image_container_sptr mask)
+{
+  if (!camera)
+  {
+    VITAL_THROW(vital::invalid_value, "mesh_color_accumulator needs a camera");
+  }
+  if (d_->mesh->faces().regularity() != 3)
+  {
+    VITAL_THROW(vital::invalid_value,
+                "mesh_color_accumulator can only render triangular meshes");
+  }
+  auto const depth = render_mesh_depth_map(d_->mesh, camera);
+  return this->add_frame(image, *camera,
+                         vital::image_of<double>(depth->get_image()), mask);
+}
+
+// ----------------------------------------------------------------------------
+unsigned
+mesh_color_accumulator
+::add_frame(vital::image_container const& image,
+            vital::camera_perspective const& camera,
+            vital::image_of<double> const& depth,
+            vital::image_container_sptr mask)
+{
+  const vital::image_of<uint8_t> color_image(image.get_image());
+  int const width = static_cast<int>(color_image.width());
+  int const height = static_cast<int>(color_image.height());
+  if (depth.width() != color_image.width() ||
+      depth.height() != color_image.height())
+  {
+    VITAL_THROW(vital::invalid_value,
+                "mesh_color_accumulator depth map is not the image size");
+  }
+
+  vital::image_of<uint8_t> mask_image;
+  if (mask)
+  {
+    mask_image = vital::image_of<uint8_t>(mask->get_image());
+    if (mask_image.width() != color_image.width() ||
+        mask_image.height() != color_image.height())
+    {
+      VITAL_THROW(vital::invalid_value,
+                  "mesh_color_accumulator mask is not the image size");
+    }
+  }
+
+  auto const& vertices = d_->mesh->vertices<3>();
+  bool const use_normals = d_->remove_back_faces && vertices.has_normals();
+  vital::vector_3d const center = camera.center();
+  double const threshold = d_->occlusion_threshold;
+  std::atomic<unsigned> num_colored{ 0 };
+
+  // each vertex is updated by only one chunk, so no locking is needed
+  vital::parallel_chunks(vertices.size(), 4096,
+    [&](size_t begin, size_t end)
+  {
+    unsigned colored = 0;
+    for (size_t v = begin; v < end; ++v)
+    {
+      auto const& pt = vertices[static_cast<unsigned>(v)];
+      if (use_normals &&
+          (pt - center).dot(vertices.normal(static_cast<unsigned>(v))) > 0.0)
+      {
+        continue;
+      }
+      double const pt_depth = camera.depth(pt);
+      if (!(pt_depth > 0.0))
+      {
+        continue;
+      }
+
+      vital::vector_2d const p = camera.project(pt);
+      int const i = static_cast<int>(std::round(p[0]));
+      int const j = static_cast<int>(std::round(p[1]));
+      if (!(i >= 0 && i < width && j >= 0 && j < height))
+      {
+        continue;
+      }
+      if (mask_image.size() > 0 && mask_image(i, j) == 0)
+      {
+        continue;
+      }
+
+      // the depth map is sampled at integer pixel coordinates, so compare
+      // with the farthest of the samples around the projection
+      int const i0 = static_cast<int>(std::floor(p[0]));
+      int const j0 = static_cast<int>(std::floor(p[1]));
+      double surface = -std::numeric_limits<double>::infinity();
+      for (int jj = std::max(j0, 0); jj <= std::min(j0 + 1, height - 1); ++jj)
+      {
+        for (int ii = std::max(i0, 0); ii <= std::min(i0 + 1, width - 1); ++ii)
+        {
+          surface = std::max(surface, depth(ii, jj));
+        }
+      }
+      if (pt_depth > surface + threshold)
+      {
+        continue;
+      }
+
+      auto const color = color_image.at(i, j);
+      auto& s = d_->stats[v];
+      ++s.count;
+      add_value(s, 0, color.r);
+      add_value(s, 1, color.g);
+      add_value(s, 2, color.b);
+      ++colored;
+    }
+    num_colored += colored;
+  });
+
+  ++d_->num_frames;
+  return num_colored;
+}
+
+// ----------------------------------------------------------------------------
+size_t
+mesh_color_accumulator
+::add_video(vital::algo::video_input& video,
+            vital::camera_map const& cameras,
+            unsigned frame_sampling,
+            vital::algo::video_input* mask)
+{
+  auto logger = vital::get_logger("arrows.core.mesh_color_accumulator");
+  auto const all_cameras = cameras.cameras();
+  frame_sampling = std::max(frame_sampling, 1u);
+
+  size_t num_added = 0;
+  size_t num_with_camera = 0;
+  vital::timestamp ts;
+  while (video.next_frame(ts))
+  {
+    auto const frame = ts.get_frame();
+    auto const cam_itr = all_cameras.find(frame);
+    if (cam_itr == all_cameras.end())
+    {
+      continue;
+    }
+    auto const camera =
+      std::dynamic_pointer_cast<vital::camera_perspective>(cam_itr->second);
+    if (!camera || num_with_camera++ % frame_sampling != 0)
+    {
+      continue;
+    }
+
+    auto const image = video.frame_image();
+    if (!image)
+    {
+      LOG_WARN(logger, "No image for frame " << frame);
+      continue;
+    }
+
+    vital::image_container_sptr mask_image;
+    if (mask)
+    {
+      vital::timestamp mask_ts;
+      if (mask->seek_frame(mask_ts, frame))
+      {
+        mask_image = mask->frame_image();
+      }
+      if (!mask_image)
+      {
+        LOG_WARN(logger, "No mask for frame " << frame);
+        continue;
+      }
+    }
+
+    auto const num_colored = this->add_frame(*image, camera, mask_image);
+    LOG_DEBUG(logger, "Frame " << frame << " colored "
+                      << num_colored << " vertices");
+    ++num_added;
+  }
+  return num_added;
+}
+
+// ----------------------------------------------------------------------------
+size_t
+mesh_color_accumulator
+::num_frames() const
+{
+  return d_->num_frames;
+}
+
+// ----------------------------------------------------------------------------
+std::vector<unsigned>
+mesh_color_accumulator
+::counts() const
+{
+  std::vector<unsigned> result;
+  result.reserve(d_->stats.size());
+  for (auto const& s : d_->stats)
+  {
+    result.push_back(s.count);
+  }
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+std::vector<vital::rgb_color>
+mesh_color_accumulator
+::mean_colors() const
+{
+  std::vector<vital::rgb_color> result(d_->stats.size(),
+                                       vital::rgb_color(0, 0, 0));
+  for (size_t v = 0; v < d_->stats.size(); ++v)
+  {
+    auto const& s = d_->stats[v];
+    if (s.count == 0)
+    {
+      continue;
+    }
+    auto const mean = [&s](int c)
+    {
+      return static_cast<uint8_t>(std::round(
+        static_cast<double>(s.sum[c]) / s.count));
+    };
+    result[v] = vital::rgb_color(mean(0), mean(1), mean(2));
+  }
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+std::vector<vital::rgb_color>
+mesh_color_accumulator
+::median_colors() const
+{
+  std::vector<vital::rgb_color> result(d_->stats.size(),
+                                       vital::rgb_color(0, 0, 0));
+  for (size_t v = 0; v < d_->stats.size(); ++v)
+  {
+    auto const& s = d_->stats[v];
+    if (s.count == 0)
+    {
+      continue;
+    }
+    result[v] = vital::rgb_color(approx_median(s, 0),
+                                 approx_median(s, 1),
+                                 approx_median(s, 2));
+  }
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+void
+mesh_color_accumulator
+::reset()
+{
+  std::fill(d_->stats.begin(), d_->stats.end(), empty_stats());
+  d_->num_frames = 0;
+}
+
+} // end namespace core
+} // end namespace arrows
+} // end namespace kwiver
@@ -0,0 +1,141 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Header for kwiver::arrows::core::mesh_color_accumulator
+ */
+
+#ifndef KWIVER_ARROWS_CORE_MESH_COLOR_ACCUMULATOR_H
+#define KWIVER_ARROWS_CORE_MESH_COLOR_ACCUMULATOR_H
+
+#include <arrows/core/kwiver_algo_core_export.h>
+
+#include <vital/algo/video_input.h>
+#include <vital/types/camera_map.h>
+#include <vital/types/camera_perspective.h>
+#include <vital/types/color.h>
+#include <vital/types/image_container.h>
+#include <vital/types/mesh.h>
+
+#include <memory>
+#include <vector>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+/// Incrementally compute the colors of mesh vertices from many frames
+/**
+ * Frames are added one at a time and only a fixed size summary of the
+ * colors seen is kept for each vertex: the count, the per channel sum and
+ * range, and a coarse per channel histogram from which the median is
+ * approximated.  Memory use is therefore proportional to the number of mesh
+ * vertices no matter how many frames are added, and no frame needs to be
+ * kept once it has been added.
+ *
+ * A vertex is colored by a frame if it is in front of the camera, projects
+ * inside the image (and inside the mask, if any), is not back facing when
+ * the mesh has vertex normals, and is not farther than the depth map
+ * around its projection plus the occlusion threshold.
+ */
+class KWIVER_ALGO_CORE_EXPORT mesh_color_accumulator
+{
+public:
+  /// Constructor
+  /**
+   * \param mesh  the triangular mesh to colorize
+   */
+  explicit mesh_color_accumulator(vital::mesh_sptr mesh);
+
+  /// Destructor
+  ~mesh_color_accumulator();
+
+  /// Set the distance a vertex may lie behind the depth map and be visible
+  /**
+   * The default of zero is only suitable for convex surfaces; a value
+   * around the mesh resolution avoids holes in concave regions.
+   */
+  void set_occlusion_threshold(double threshold);
+
+  /// Set whether vertices with normals facing away from the camera are skipped
+  /**
+   * This is on by default and has no effect on meshes without vertex
+   * normals.
+   */
+  void set_remove_back_faces(bool remove);
+
+  /// Accumulate the colors of one frame, rendering its depth map
+  /**
+   * \param image   an 8-bit RGB or luminance frame image
+   * \param camera  the camera which took \p image
+   * \param mask    optional 8-bit mask the size of \p image; only pixels
+   *                with a non-zero first channel are used
+   * \return the number of vertices colored by the frame
+   */
+  unsigned add_frame(vital::image_container const& image,
+                     vital::camera_perspective_sptr camera,
+                     vital::image_container_sptr mask = nullptr);
+
+  /// Accumulate the colors of one frame using a precomputed depth map
+  /**
+   * \param image   an 8-bit RGB or luminance frame image
+   * \param camera  the camera which took \p image
+   * \param depth   the depth map of the mesh seen by \p camera, with
+   *                infinite depth where the mesh is not seen
+   * \param mask    optional 8-bit mask the size of \p image
+   * \return the number of vertices colored by the frame
+   */
+  unsigned add_frame(vital::image_container const& image,
+                     vital::camera_perspective const& camera,
+                     vital::image_of<double> const& depth,
+                     vital::image_container_sptr mask = nullptr);
+
+  /// Accumulate the colors of every frame of a video which has a camera
+  /**
+   * Frames are read and added one at a time.
+   *
+   * \param video           an open video to read to the end
+   * \param cameras         the cameras indexed by frame number
+   * \param frame_sampling  use only every n-th frame which has a camera
+   * \param mask            optional open mask video, read at the same
+   *                        frames as \p video
+   * \return the number of frames added
+   */
+  size_t add_video(vital::algo::video_input& video,
+                   vital::camera_map const& cameras,
+                   unsigned frame_sampling = 1,
+                   vital::algo::video_input* mask = nullptr);
+
+  /// The number of frames added so far
+  size_t num_frames() const;
+
+  /// The number of frames which colored each vertex
+  std::vector<unsigned> counts() const;
+
+  /// The mean color of each vertex, black where the count is zero
+  std::vector<vital::rgb_color> mean_colors() const;
+
+  /// The approximate median color of each vertex, black where the count
+  /// is zero
+  /**
+   * Each channel is interpolated within a 16 level histogram bin and
+   * clamped to the range of values seen, so is exact for vertices with a
+   * single color.
+   */
+  std::vector<vital::rgb_color> median_colors() const;
+
+  /// Discard all accumulated colors
+  void reset();
+
+private:
+  class priv;
+  std::unique_ptr<priv> d_;
+};
+
+} // end namespace core
+} // end namespace arrows
+} // end namespace kwiver
+
+#endif
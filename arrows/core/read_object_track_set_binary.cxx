@@ -0,0 +1,246 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Implementation of read_object_track_set_binary
+ */
+
+#include "read_object_track_set_binary.h"
+
+#include <arrows/core/binary_object_store.h>
+
+#include <vital/types/object_track_set.h>
+#include <vital/vital_config.h>
+
+#include <map>
+#include <vector>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+// -------------------------------------------------------------------------------
+class read_object_track_set_binary::priv
+{
+public:
+  priv( read_object_track_set_binary* parent )
+    : m_parent( parent )
+    , m_batch_load( true )
+    , m_first_frame( -1 )
+    , m_last_frame( -1 )
+    , m_loaded( false )
+    , m_done( false )
+    , m_current( 0 )
+  {}
+
+  ~priv() {}
+
+  void reset();
+  void load();
+
+  read_object_track_set_binary* m_parent;
+  binary_object_store_reader m_reader;
+  bool m_batch_load;
+  vital::frame_id_t m_first_frame;
+  vital::frame_id_t m_last_frame;
+
+  bool m_loaded;
+  bool m_done;
+
+  // Position of the next frame to return when not batch loading
+  size_t m_current;
+
+  // Tracks active on each frame in the range, in file order
+  std::vector< std::vector< vital::track_sptr > > m_tracks_by_frame;
+
+  // Compilation of all loaded tracks, track id -> track sptr mapping
+  std::map< vital::track_id_t, vital::track_sptr > m_all_tracks;
+};
+
+// -------------------------------------------------------------------------------
+void
+read_object_track_set_binary::priv
+::reset()
+{
+  m_loaded = false;
+  m_done = false;
+  m_current = 0;
+  m_tracks_by_frame.clear();
+  m_all_tracks.clear();
+}
+
+// -------------------------------------------------------------------------------
+void
+read_object_track_set_binary::priv
+::load()
+{
+  // files opened by name are already mapped
+  if( !m_reader.is_open() )
+  {
+    m_reader.load( m_parent->stream() );
+  }
+
+  // only the frames in the configured range are decoded
+  auto const first = ( m_first_frame < 0 ? size_t{ 0 }
+                       : m_reader.lower_bound( m_first_frame ) );
+  auto const last = ( m_last_frame < 0 ? m_reader.num_frames()
+                      : m_reader.lower_bound( m_last_frame + 1 ) );
+
+  for( auto f = first; f < last; ++f )
+  {
+    auto const frame = m_reader.frame_id( f );
+    auto const time = m_reader.frame_time( f );
+
+    std::vector< vital::track_sptr > active;
+    for( auto r = m_reader.frame_begin( f ); r < m_reader.frame_end( f ); ++r )
+    {
+      auto const id = m_reader.track_id( r );
+      auto& trk = m_all_tracks[ id ];
+      if( !trk )
+      {
+        trk = vital::track::create();
+        trk->set_id( id );
+      }
+
+      trk->append( std::make_shared< vital::object_track_state >(
+                     frame, time, m_reader.detection( r ) ) );
+
+      if( !m_batch_load )
+      {
+        active.push_back( trk );
+      }
+    }
+
+    if( !m_batch_load )
+    {
+      m_tracks_by_frame.push_back( std::move( active ) );
+    }
+  }
+
+  m_loaded = true;
+}
+
+// ===============================================================================
+read_object_track_set_binary
+::read_object_track_set_binary()
+  : d( new read_object_track_set_binary::priv( this ) )
+{
+}
+
+read_object_track_set_binary
+::~read_object_track_set_binary()
+{
+}
+
+// -------------------------------------------------------------------------------
+vital::config_block_sptr
+read_object_track_set_binary
+::get_configuration() const
+{
+  auto config = vital::algo::read_object_track_set::get_configuration();
+
+  config->set_value( "batch_load", d->m_batch_load,
+                     "Return all tracks from the first call to read_set. "
+                     "Otherwise each call returns the tracks active on "
+                     "the next frame." );
+  config->set_value( "first_frame", d->m_first_frame,
+                     "First frame to read, or -1 to start at the "
+                     "beginning of the file." );
+  config->set_value( "last_frame", d->m_last_frame,
+                     "Last frame to read, or -1 to read to the end of "
+                     "the file." );
+
+  return config;
+}
+
+// -------------------------------------------------------------------------------
+void
+read_object_track_set_binary
+::set_configuration( vital::config_block_sptr config )
+{
+  d->m_batch_load = config->get_value< bool >( "batch_load", d->m_batch_load );
+  d->m_first_frame =
+    config->get_value< vital::frame_id_t >( "first_frame", d->m_first_frame );
+  d->m_last_frame =
+    config->get_value< vital::frame_id_t >( "last_frame", d->m_last_frame );
+}
+
+// -------------------------------------------------------------------------------
+bool
+read_object_track_set_binary
+::check_configuration( VITAL_UNUSED vital::config_block_sptr config ) const
+{
+  return true;
+}
+
+// -------------------------------------------------------------------------------
+void
+read_object_track_set_binary
+::open( std::string const& filename )
+{
+  vital::algo::read_object_track_set::open( filename );
+  d->m_reader.open( filename );
+}
+
+// -------------------------------------------------------------------------------
+void
+read_object_track_set_binary
+::close()
+{
+  d->m_reader.close();
+  d->reset();
+  vital::algo::read_object_track_set::close();
+}
+
+// -------------------------------------------------------------------------------
+void
+read_object_track_set_binary
+::new_stream()
+{
+  d->m_reader.close();
+  d->reset();
+}
+
+// -------------------------------------------------------------------------------
+bool
+read_object_track_set_binary
+::read_set( vital::object_track_set_sptr& set )
+{
+  if( d->m_done )
+  {
+    return false;
+  }
+
+  if( !d->m_loaded )
+  {
+    d->load();
+  }
+
+  if( d->m_batch_load )
+  {
+    std::vector< vital::track_sptr > trks;
+    trks.reserve( d->m_all_tracks.size() );
+    for( auto const& it : d->m_all_tracks )
+    {
+      trks.push_back( it.second );
+    }
+
+    set = std::make_shared< vital::object_track_set >( trks );
+    d->m_done = true;
+    return true;
+  }
+
+  if( d->m_current >= d->m_tracks_by_frame.size() )
+  {
+    d->m_done = true;
+    return false;
+  }
+
+  set = std::make_shared< vital::object_track_set >(
+    d->m_tracks_by_frame[ d->m_current++ ] );
+  return true;
+}
+
+} } } // end namespace
@@ -0,0 +1,58 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Interface for read_object_track_set_binary
+ */
+
+#ifndef KWIVER_ARROWS_READ_OBJECT_TRACK_SET_BINARY_H
+#define KWIVER_ARROWS_READ_OBJECT_TRACK_SET_BINARY_H
+
+#include <vital/vital_config.h>
+#include <arrows/core/kwiver_algo_core_export.h>
+
+#include <vital/algo/read_object_track_set.h>
+
+#include <memory>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+/// Object track set reader for the binary object store format
+/**
+ * Files opened by name are memory mapped and only the frames in the
+ * configured range are decoded.  Streams are read into memory first.
+ */
+class KWIVER_ALGO_CORE_EXPORT read_object_track_set_binary
+  : public vital::algo::read_object_track_set
+{
+public:
+  PLUGIN_INFO( "binary",
+               "Object track set reader for the memory mapped binary "
+               "object store format." )
+
+  read_object_track_set_binary();
+  virtual ~read_object_track_set_binary();
+
+  virtual vital::config_block_sptr get_configuration() const;
+  virtual void set_configuration( vital::config_block_sptr config );
+  virtual bool check_configuration( vital::config_block_sptr config ) const;
+
+  virtual void open( std::string const& filename );
+  virtual void close();
+
+  virtual bool read_set( kwiver::vital::object_track_set_sptr& set );
+
+private:
+  virtual void new_stream();
+
+  class priv;
+  std::unique_ptr< priv > d;
+};
+
+} } } // end namespace
+
+#endif // KWIVER_ARROWS_READ_OBJECT_TRACK_SET_BINARY_H
@@ -24,14 +24,18 @@
 #include <arrows/core/create_detection_grid.h>
 #include <arrows/core/derive_metadata.h>
 #include <arrows/core/detect_features_filtered.h>
+#include <arrows/core/detect_features_tiled.h>
+#include <arrows/core/detected_object_set_input_binary.h>
 #include <arrows/core/detected_object_set_input_csv.h>
 #include <arrows/core/detected_object_set_input_kw18.h>
 #include <arrows/core/detected_object_set_input_simulator.h>
+#include <arrows/core/detected_object_set_output_binary.h>
 #include <arrows/core/detected_object_set_output_csv.h>
 #include <arrows/core/detected_object_set_output_kw18.h>
 #include <arrows/core/dynamic_config_none.h>
 #include <arrows/core/estimate_canonical_transform.h>
 #include <arrows/core/example_detector.h>
+#include <arrows/core/extract_descriptors_tiled.h>
 #include <arrows/core/feature_descriptor_io.h>
 #include <arrows/core/filter_features_magnitude.h>
 #include <arrows/core/filter_features_nonmax.h>
@@ -41,9 +45,12 @@
 #include <arrows/core/initialize_object_tracks_threshold.h>
 #include <arrows/core/interpolate_track_spline.h>
 #include <arrows/core/keyframe_selector_basic.h>
+#include <arrows/core/match_descriptor_sets_hnsw.h>
 #include <arrows/core/match_features_fundamental_matrix.h>
+#include <arrows/core/match_features_hamming.h>
 #include <arrows/core/match_features_homography.h>
 #include <arrows/core/metadata_map_io_csv.h>
+#include <arrows/core/read_object_track_set_binary.h>
 #include <arrows/core/read_object_track_set_kw18.h>
 #include <arrows/core/read_track_descriptor_set_csv.h>
 #include <arrows/core/track_features_augment_keyframes.h>
@@ -56,6 +63,7 @@
 #include <arrows/core/video_input_pos.h>
 #include <arrows/core/video_input_splice.h>
 #include <arrows/core/video_input_split.h>
+#include <arrows/core/write_object_track_set_binary.h>
 #include <arrows/core/write_object_track_set_kw18.h>
 #include <arrows/core/write_track_descriptor_set_csv.h>
 
@@ -89,14 +97,18 @@ register_factories( kwiver::vital::plugin_loader& vpm )
   reg.register_algorithm< create_detection_grid >();
   reg.register_algorithm< derive_metadata >();
   reg.register_algorithm< detect_features_filtered >();
+  reg.register_algorithm< detect_features_tiled >();
+  reg.register_algorithm< detected_object_set_input_binary >();
   reg.register_algorithm< detected_object_set_input_csv >();
   reg.register_algorithm< detected_object_set_input_kw18 >();
   reg.register_algorithm< detected_object_set_input_simulator >();
+  reg.register_algorithm< detected_object_set_output_binary >();
   reg.register_algorithm< detected_object_set_output_csv >();
   reg.register_algorithm< detected_object_set_output_kw18 >();
   reg.register_algorithm< dynamic_config_none >();
   reg.register_algorithm< estimate_canonical_transform >();
   reg.register_algorithm< example_detector >();
+  reg.register_algorithm< extract_descriptors_tiled >();
   reg.register_algorithm< feature_descriptor_io >();
   reg.register_algorithm< filter_features_magnitude >();
   reg.register_algorithm< filter_features_nonmax >();
@@ -106,9 +118,12 @@ register_factories( kwiver::vital::plugin_loader& vpm )
   reg.register_algorithm< initialize_object_tracks_threshold >();
   reg.register_algorithm< interpolate_track_spline >();
   reg.register_algorithm< keyframe_selector_basic >();
+  reg.register_algorithm< match_descriptor_sets_hnsw >();
   reg.register_algorithm< match_features_fundamental_matrix >();
+  reg.register_algorithm< match_features_hamming >();
   reg.register_algorithm< match_features_homography >();
   reg.register_algorithm< metadata_map_io_csv >();
+  reg.register_algorithm< read_object_track_set_binary >();
   reg.register_algorithm< read_object_track_set_kw18 >();
   reg.register_algorithm< read_track_descriptor_set_csv >();
   reg.register_algorithm< track_features_augment_keyframes >();
@@ -121,6 +136,7 @@ register_factories( kwiver::vital::plugin_loader& vpm )
   reg.register_algorithm< video_input_pos >();
   reg.register_algorithm< video_input_splice >();
   reg.register_algorithm< video_input_split >();
+  reg.register_algorithm< write_object_track_set_binary >();
   reg.register_algorithm< write_object_track_set_kw18 >();
   reg.register_algorithm< write_track_descriptor_set_csv >();
 
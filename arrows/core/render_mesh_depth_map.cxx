@@ -12,25 +12,228 @@
 #include <vital/types/camera_perspective.h>
 #include <vital/types/image.h>
 #include <vital/types/vector.h>
+#include <vital/util/parallel_chunks.h>
 #include <vital/util/transform_image.h>
+
+#include <cmath>
 #include <memory>
 
 namespace kwiver {
 namespace arrows {
 namespace core {
 
+namespace {
+
+// Width and height in pixels of the tiles which are rendered in parallel
+int const tile_size = 64;
+
+// The number of triangles set up and binned by each task
+size_t const triangle_chunk_size = 4096;
+
+// A triangle which covers at least one pixel center in the image
+struct raster_triangle
+{
+  unsigned face;
+  // linear interpolation vector of the rendered value
+  vital::vector_3d attrib;
+  // bounding box of the covered pixels, clipped to the image
+  int x0, y0, x1, y1;
+};
+
+// ----------------------------------------------------------------------------
+// Render the minimum over all triangles of a value interpolated linearly
+// between the vertices into img, which must be initialized
+//
+// Triangles with a vertex which is not valid, or which cover no pixel
+// centers in the image, are culled.  The remaining triangles are binned into
+// image tiles and the tiles are rendered in parallel, each by one thread.
+// Each pixel gets the same value as if the triangles were rendered in turn
+// with render_triangle.
+void
+render_triangles_min(std::vector<vital::vector_2d> const& points,
+                     std::vector<double> const& values,
+                     std::vector<char> const& valid,
+                     vital::mesh_regular_face_array<3> const& triangles,
+                     vital::image_of<double>& img)
+{
+  int const width = static_cast<int>(img.width());
+  int const height = static_cast<int>(img.height());
+  if (width == 0 || height == 0 || triangles.size() == 0)
+  {
+    return;
+  }
+  int const tiles_x = (width + tile_size - 1) / tile_size;
+  int const tiles_y = (height + tile_size - 1) / tile_size;
+  size_t const num_tiles = static_cast<size_t>(tiles_x) * tiles_y;
+
+  // set up the triangles which survive culling, in parallel chunks
+  size_t const num_chunks =
+    (triangles.size() + triangle_chunk_size - 1) / triangle_chunk_size;
+  std::vector<std::vector<raster_triangle>> chunk_tris(num_chunks);
+  vital::parallel_chunks(triangles.size(), triangle_chunk_size,
+    [&](size_t begin, size_t end)
+  {
+    auto& tris = chunk_tris[begin / triangle_chunk_size];
+    for (size_t f = begin; f < end; ++f)
+    {
+      auto const& tri = triangles[f];
+      if (!valid[tri[0]] || !valid[tri[1]] || !valid[tri[2]])
+      {
+        continue;
+      }
+      vital::vector_2d const& v1 = points[tri[0]];
+      vital::vector_2d const& v2 = points[tri[1]];
+      vital::vector_2d const& v3 = points[tri[2]];
+      double const min_x = std::min(std::min(v1.x(), v2.x()), v3.x());
+      double const max_x = std::max(std::max(v1.x(), v2.x()), v3.x());
+      double const min_y = std::min(std::min(v1.y(), v2.y()), v3.y());
+      double const max_y = std::max(std::max(v1.y(), v2.y()), v3.y());
+      // also rejects non-finite coordinates
+      if (!(max_x >= 0.0 && min_x <= width - 1 &&
+            max_y >= 0.0 && min_y <= height - 1))
+      {
+        continue;
+      }
+
+      raster_triangle rt;
+      rt.x0 = static_cast<int>(std::ceil(std::max(min_x, 0.0)));
+      rt.x1 = static_cast<int>(std::floor(std::min(max_x, width - 1.0)));
+      rt.y0 = static_cast<int>(std::ceil(std::max(min_y, 0.0)));
+      rt.y1 = static_cast<int>(std::floor(std::min(max_y, height - 1.0)));
+      if (rt.x0 > rt.x1 || rt.y0 > rt.y1)
+      {
+        continue;
+      }
+      rt.face = static_cast<unsigned>(f);
+      rt.attrib = triangle_attribute_vector(v1, v2, v3,
+                                            values[tri[0]],
+                                            values[tri[1]],
+                                            values[tri[2]]);
+      tris.push_back(rt);
+    }
+  });
+
+  // count the triangles overlapping each tile from each chunk, then lay
+  // out the bins so that each tile lists its triangles in chunk order
+  std::vector<size_t> bin_offsets(num_chunks * num_tiles + 1, 0);
+  auto const count = [&](size_t chunk, size_t tile) -> size_t&
+  {
+    return bin_offsets[tile * num_chunks + chunk + 1];
+  };
+  vital::parallel_chunks(num_chunks, 1, [&](size_t begin, size_t end)
+  {
+    for (size_t c = begin; c < end; ++c)
+    {
+      for (auto const& rt : chunk_tris[c])
+      {
+        for (int ty = rt.y0 / tile_size; ty <= rt.y1 / tile_size; ++ty)
+        {
+          for (int tx = rt.x0 / tile_size; tx <= rt.x1 / tile_size; ++tx)
+          {
+            ++count(c, ty * tiles_x + tx);
+          }
+        }
+      }
+    }
+  });
+  for (size_t i = 1; i < bin_offsets.size(); ++i)
+  {
+    bin_offsets[i] += bin_offsets[i - 1];
+  }
+
+  std::vector<raster_triangle const*> bins(bin_offsets.back());
+  vital::parallel_chunks(num_chunks, 1, [&](size_t begin, size_t end)
+  {
+    for (size_t c = begin; c < end; ++c)
+    {
+      for (auto const& rt : chunk_tris[c])
+      {
+        for (int ty = rt.y0 / tile_size; ty <= rt.y1 / tile_size; ++ty)
+        {
+          for (int tx = rt.x0 / tile_size; tx <= rt.x1 / tile_size; ++tx)
+          {
+            bins[bin_offsets[(ty * tiles_x + tx) * num_chunks + c]++] = &rt;
+          }
+        }
+      }
+    }
+  });
+  // the fill advanced each offset to the start of the next bin
+  auto const bin_begin = [&](size_t tile)
+  {
+    return tile == 0 ? 0 : bin_offsets[tile * num_chunks - 1];
+  };
+
+  // render the tiles, each of which is written by only one thread
+  vital::parallel_chunks(num_tiles, 1, [&](size_t begin, size_t end)
+  {
+    for (size_t tile = begin; tile < end; ++tile)
+    {
+      int const tile_x0 = static_cast<int>(tile % tiles_x) * tile_size;
+      int const tile_y0 = static_cast<int>(tile / tiles_x) * tile_size;
+      int const tile_x1 = std::min(tile_x0 + tile_size, width) - 1;
+      int const tile_y1 = std::min(tile_y0 + tile_size, height) - 1;
+      size_t const bin_end = bin_offsets[(tile + 1) * num_chunks - 1];
+      for (size_t b = bin_begin(tile); b < bin_end; ++b)
+      {
+        raster_triangle const& rt = *bins[b];
+        auto const& tri = triangles[rt.face];
+        auto const& Vd = rt.attrib;
+        triangle_scan_iterator tsi(points[tri[0]], points[tri[1]],
+                                   points[tri[2]]);
+        for (tsi.reset(); tsi.next(); )
+        {
+          int const y = tsi.scan_y();
+          if (y < tile_y0)
+          {
+            continue;
+          }
+          if (y > tile_y1)
+          {
+            break;
+          }
+          int const min_x = std::max(tile_x0, tsi.start_x());
+          int const max_x = std::min(tile_x1, tsi.end_x());
+
+          double const new_i = Vd.y() * y + Vd.z();
+          for (int x = min_x; x <= max_x; ++x)
+          {
+            double const value = new_i + Vd.x() * x;
+            if (value < img(x, y))
+            {
+              img(x, y) = value;
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+} // end anonymous namespace
+
 /// This function renders a depth map of a triangular mesh seen by a camera
 vital::image_container_sptr render_mesh_depth_map(vital::mesh_sptr mesh, vital::camera_perspective_sptr camera)
 {
   vital::mesh_vertex_array<3>& vertices = dynamic_cast< vital::mesh_vertex_array<3>& >(mesh->vertices());
 
+  // project each vertex once, rendering the reciprocal of depth which is
+  // linear in image space; for now, skip any triangle that is even partly
+  // behind the camera
+  // TODO clip triangles that are partly behind the camera
   std::vector<vital::vector_2d> points_2d(vertices.size());
-  std::vector<double> depths(vertices.size());
-  for (unsigned int i = 0; i < vertices.size(); ++i)
+  std::vector<double> inv_depths(vertices.size());
+  std::vector<char> in_front(vertices.size());
+  vital::parallel_chunks(vertices.size(), 4096, [&](size_t begin, size_t end)
   {
-    points_2d[i] = camera->project(vertices[i]);
-    depths[i] = camera->depth(vertices[i]);
-  }
+    for (size_t i = begin; i < end; ++i)
+    {
+      points_2d[i] = camera->project(vertices[i]);
+      double const depth = camera->depth(vertices[i]);
+      inv_depths[i] = -1.0 / depth;
+      in_front[i] = depth > 0.0;
+    }
+  });
 
   vital::image_of<double> zbuffer(camera->image_width(), camera->image_height(), 1);
   // fill each pixel with infinity
@@ -39,26 +242,7 @@ vital::image_container_sptr render_mesh_depth_map(vital::mesh_sptr mesh, vital::
   if (mesh->faces().regularity() == 3)
   {
     auto const& triangles = static_cast< const vital::mesh_regular_face_array<3>& >(mesh->faces());
-    for (auto const& tri : triangles)
-    {
-      double const& d1 = depths[tri[0]];
-      double const& d2 = depths[tri[1]];
-      double const& d3 = depths[tri[2]];
-      // for now, skip any triangle that is even partly behind the camera
-      // TODO clip triangles that are partly behind the camera
-      if (d1 <= 0.0 || d2 <= 0.0 || d3 <= 0.0)
-      {
-        continue;
-      }
-
-      vital::vector_2d const& v1 = points_2d[tri[0]];
-      vital::vector_2d const& v2 = points_2d[tri[1]];
-      vital::vector_2d const& v3 = points_2d[tri[2]];
-
-      render_triangle(v1, v2, v3,
-                      -1.0 / d1, -1.0 / d2, -1.0 / d3,
-                      zbuffer);
-    }
+    render_triangles_min(points_2d, inv_depths, in_front, triangles, zbuffer);
     transform_image(zbuffer, [](double d){ return std::isinf(d) ? d : (-1.0 / d); } );
   }
   else
@@ -90,25 +274,19 @@ vital::image_container_sptr render_mesh_height_map(vital::mesh_sptr mesh, vital:
       vital::mesh_vertex_array<3>& vertices = dynamic_cast< vital::mesh_vertex_array<3>& >(mesh->vertices());
 
       std::vector<vital::vector_2d> points_2d(vertices.size());
-      for (unsigned int i = 0; i < vertices.size(); ++i)
+      std::vector<double> neg_heights(vertices.size());
+      vital::parallel_chunks(vertices.size(), 4096, [&](size_t begin, size_t end)
       {
-        points_2d[i] = camera->project(vertices[i]);
-      }
+        for (size_t i = begin; i < end; ++i)
+        {
+          points_2d[i] = camera->project(vertices[i]);
+          neg_heights[i] = -vertices[i](2);
+        }
+      });
 
       auto const& triangles = static_cast< const vital::mesh_regular_face_array<3>& >(mesh->faces());
-      double h1, h2, h3;
-      for (unsigned int f = 0; f < triangles.size(); ++f)
-      {
-        vital::vector_2d& v1 = points_2d[triangles(f, 0)];
-        vital::vector_2d& v2 = points_2d[triangles(f, 1)];
-        vital::vector_2d& v3 = points_2d[triangles(f, 2)];
-
-        h1 = -vertices[triangles(f, 0)](2);
-        h2 = -vertices[triangles(f, 1)](2);
-        h3 = -vertices[triangles(f, 2)](2);
-
-        render_triangle(v1, v2, v3, h1, h2, h3, height_map);
-      }
+      std::vector<char> all_valid(vertices.size(), 1);
+      render_triangles_min(points_2d, neg_heights, all_valid, triangles, height_map);
       transform_image(height_map, [](double h){ return std::isinf(h) ? h : -h; } );
     }
   }
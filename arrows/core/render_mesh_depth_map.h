@@ -23,6 +23,10 @@ namespace core {
 
 /// This function renders a depth map of a triangular mesh seen by a camera
 /**
+ * Triangles which are partly behind the camera or cover no pixels are
+ * culled, and the rest are binned into image tiles which are rendered in
+ * parallel.
+ *
  * \param mesh [in]
  * \param camera [in]
  * \return a depth map
@@ -33,6 +37,8 @@ vital::image_container_sptr render_mesh_depth_map(kwiver::vital::mesh_sptr mesh,
 
 /// This function renders a height map of a triangular mesh
 /**
+ * Rendering is parallel over image tiles as for render_mesh_depth_map().
+ *
  * \param mesh [in]
  * \param camera [in]
  * \return height map
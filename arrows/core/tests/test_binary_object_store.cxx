@@ -0,0 +1,245 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Tests for the binary object store format
+ */
+
+#include <test_tmpfn.h>
+
+#include <arrows/core/binary_object_store.h>
+#include <arrows/core/read_object_track_set_binary.h>
+#include <arrows/core/write_object_track_set_binary.h>
+
+#include <vital/exceptions/base.h>
+#include <vital/exceptions/io.h>
+#include <vital/types/object_track_set.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace kwiver::vital;
+namespace kac = kwiver::arrows::core;
+
+// ----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// Tracks 1..n, track i covering frames i..i+4
+object_track_set_sptr
+make_tracks( int n )
+{
+  std::vector< track_sptr > tracks;
+  for( int i = 1; i <= n; ++i )
+  {
+    auto trk = track::create();
+    trk->set_id( i );
+    for( frame_id_t f = i; f < i + 5; ++f )
+    {
+      auto const dot = std::make_shared< detected_object_type >( "kind", 0.5 );
+      auto const det = std::make_shared< detected_object >(
+        bounding_box_d( f, i, f + 10, i + 10 ), 0.1 * i, dot );
+      trk->append(
+        std::make_shared< object_track_state >( f, 1000 * f, det ) );
+    }
+    tracks.push_back( trk );
+  }
+  return std::make_shared< object_track_set >( tracks );
+}
+
+// ----------------------------------------------------------------------------
+void
+write_tracks( std::ostream& os, object_track_set_sptr const& tracks )
+{
+  kac::write_object_track_set_binary writer;
+  writer.use_stream( &os );
+  writer.write_set( tracks );
+  writer.close();
+}
+
+} // end namespace
+
+// ----------------------------------------------------------------------------
+TEST(binary_object_store, frame_index)
+{
+  kac::binary_object_store_writer writer(
+    kac::binary_object_store_kind::detections );
+
+  detected_object const det( bounding_box_d( 1, 2, 3, 4 ), 0.5 );
+  writer.add_frame( 10, 100, "a.png" );
+  writer.add_record( 7, det );
+  writer.add_record( 8, det );
+  writer.add_frame( 20, 200 );
+  writer.add_frame( 30, 300, "a.png" );
+  writer.add_record( 9, det );
+  EXPECT_THROW( writer.add_frame( 30, 400 ), invalid_value );
+
+  std::stringstream str;
+  writer.write( str );
+
+  kac::binary_object_store_reader reader;
+  reader.load( str );
+  ASSERT_TRUE( reader.is_open() );
+  EXPECT_EQ( kac::binary_object_store_kind::detections, reader.kind() );
+  ASSERT_EQ( 3, reader.num_frames() );
+  EXPECT_EQ( 3, reader.num_records() );
+
+  EXPECT_EQ( 20, reader.frame_id( 1 ) );
+  EXPECT_EQ( 300, reader.frame_time( 2 ) );
+  EXPECT_EQ( "a.png", reader.frame_name( 0 ) );
+  EXPECT_EQ( "", reader.frame_name( 1 ) );
+  EXPECT_EQ( "a.png", reader.frame_name( 2 ) );
+
+  EXPECT_EQ( 0, reader.lower_bound( 5 ) );
+  EXPECT_EQ( 1, reader.lower_bound( 11 ) );
+  EXPECT_EQ( 2, reader.lower_bound( 30 ) );
+  EXPECT_EQ( 3, reader.lower_bound( 31 ) );
+
+  EXPECT_EQ( 2, reader.frame_end( 0 ) );
+  EXPECT_EQ( reader.frame_begin( 1 ), reader.frame_end( 1 ) );
+  EXPECT_EQ( 9, reader.track_id( reader.frame_begin( 2 ) ) );
+
+  auto const d = reader.detection( 2 );
+  EXPECT_EQ( det.bounding_box(), d->bounding_box() );
+  EXPECT_EQ( 0.5, d->confidence() );
+  EXPECT_EQ( nullptr, d->type() );
+}
+
+// ----------------------------------------------------------------------------
+TEST(binary_object_store, reject_invalid)
+{
+  kac::binary_object_store_reader reader;
+
+  std::stringstream empty;
+  EXPECT_THROW( reader.load( empty ), invalid_data );
+
+  std::stringstream str;
+  kac::binary_object_store_writer(
+    kac::binary_object_store_kind::object_tracks ).write( str );
+
+  auto bytes = str.str();
+  bytes[ 0 ] = 'X';
+  std::stringstream bad_magic( bytes );
+  EXPECT_THROW( reader.load( bad_magic ), invalid_data );
+  EXPECT_FALSE( reader.is_open() );
+
+  bytes = str.str();
+  std::stringstream truncated( bytes.substr( 0, bytes.size() - 8 ) );
+  EXPECT_THROW( reader.load( truncated ), invalid_data );
+
+  // a string count whose section size overflows to zero
+  bytes = str.str();
+  uint64_t const num_strings = ( uint64_t( 1 ) << 61 ) - 1;
+  std::memcpy( &bytes[ 56 ], &num_strings, sizeof( num_strings ) );
+  std::stringstream overflow( bytes );
+  EXPECT_THROW( reader.load( overflow ), invalid_data );
+  EXPECT_FALSE( reader.is_open() );
+}
+
+// ----------------------------------------------------------------------------
+TEST(binary_object_store, track_stream_io)
+{
+  auto const tracks = make_tracks( 4 );
+
+  std::stringstream str;
+  write_tracks( str, tracks );
+
+  kac::read_object_track_set_binary reader;
+  reader.use_stream( &str );
+
+  object_track_set_sptr loaded;
+  ASSERT_TRUE( reader.read_set( loaded ) );
+  EXPECT_FALSE( reader.read_set( loaded ) );
+
+  ASSERT_EQ( 4, loaded->size() );
+  for( auto const& trk : tracks->tracks() )
+  {
+    auto const other = loaded->get_track( trk->id() );
+    ASSERT_NE( nullptr, other );
+    ASSERT_EQ( trk->size(), other->size() );
+
+    auto it = other->begin();
+    for( auto const& ts : *trk )
+    {
+      auto const a = std::static_pointer_cast< object_track_state >( ts );
+      auto const b = std::static_pointer_cast< object_track_state >( *it++ );
+      EXPECT_EQ( a->frame(), b->frame() );
+      EXPECT_EQ( a->time(), b->time() );
+      EXPECT_EQ( a->detection()->bounding_box(),
+                 b->detection()->bounding_box() );
+      EXPECT_EQ( a->detection()->confidence(), b->detection()->confidence() );
+      EXPECT_EQ( 0.5, b->detection()->type()->score( "kind" ) );
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+TEST(binary_object_store, track_frame_range)
+{
+  std::stringstream str;
+  write_tracks( str, make_tracks( 4 ) );
+
+  kac::read_object_track_set_binary reader;
+  auto config = reader.get_configuration();
+  config->set_value( "batch_load", false );
+  config->set_value( "first_frame", 6 );
+  config->set_value( "last_frame", 7 );
+  reader.set_configuration( config );
+  reader.use_stream( &str );
+
+  // Track i covers frames i..i+4, so frame 6 has tracks 2..4 and frame 7
+  // has tracks 3 and 4
+  object_track_set_sptr loaded;
+  ASSERT_TRUE( reader.read_set( loaded ) );
+  EXPECT_EQ( 3, loaded->size() );
+  ASSERT_TRUE( reader.read_set( loaded ) );
+  EXPECT_EQ( 2, loaded->size() );
+  EXPECT_FALSE( reader.read_set( loaded ) );
+
+  // Only states inside the range are decoded
+  auto const trk = loaded->get_track( 3 );
+  ASSERT_NE( nullptr, trk );
+  EXPECT_EQ( 2, trk->size() );
+  EXPECT_EQ( 6, trk->first_frame() );
+  EXPECT_EQ( 7, trk->last_frame() );
+}
+
+// ----------------------------------------------------------------------------
+TEST(binary_object_store, mapped_file)
+{
+  auto const filename = kwiver::testing::temp_file_name( "test-", ".kwbin" );
+  {
+    std::ofstream ofs( filename, std::ios::binary );
+    write_tracks( ofs, make_tracks( 3 ) );
+  }
+
+  kac::binary_object_store_reader store;
+  store.open( filename );
+  EXPECT_EQ( kac::binary_object_store_kind::object_tracks, store.kind() );
+  EXPECT_EQ( 7, store.num_frames() );
+  EXPECT_EQ( 15, store.num_records() );
+  store.close();
+  EXPECT_FALSE( store.is_open() );
+
+  kac::read_object_track_set_binary reader;
+  reader.open( filename );
+  object_track_set_sptr loaded;
+  ASSERT_TRUE( reader.read_set( loaded ) );
+  EXPECT_EQ( 3, loaded->size() );
+  reader.close();
+
+  EXPECT_EQ( 0, std::remove( filename.c_str() ) );
+  EXPECT_THROW( store.open( filename ), file_not_found_exception );
+}
@@ -7,7 +7,9 @@
  * \brief test detected object io
  */
 
+#include <arrows/core/detected_object_set_input_binary.h>
 #include <arrows/core/detected_object_set_input_csv.h>
+#include <arrows/core/detected_object_set_output_binary.h>
 #include <arrows/core/detected_object_set_output_csv.h>
 
 #include <gtest/gtest.h>
@@ -119,3 +121,87 @@ TEST(detected_object_io, stream_io)
   EXPECT_FALSE( reader.read_set( idos, name ) );
   EXPECT_TRUE( reader.at_eof() );
 }
+
+// ----------------------------------------------------------------------------
+TEST(detected_object_io, binary_stream_io)
+{
+  kac::detected_object_set_input_binary reader;
+  kac::detected_object_set_output_binary writer;
+
+  auto dos = make_dos();
+
+  std::stringstream str;
+  writer.use_stream( &str );
+
+  writer.write_set( dos, "image_name_1" );
+  writer.write_set( std::make_shared< kwiver::vital::detected_object_set >(),
+                    "image_name_2" );
+  writer.write_set( dos, "image_name_3" );
+  writer.complete();
+  writer.close();
+
+  reader.use_stream( &str );
+  kwiver::vital::detected_object_set_sptr idos;
+  std::string name;
+
+  ASSERT_TRUE( reader.read_set( idos, name ) );
+  EXPECT_EQ( "image_name_1", name );
+  ASSERT_EQ( dos->size(), idos->size() );
+  for( size_t i = 0; i < dos->size(); ++i )
+  {
+    auto const& expected = *dos->at( i );
+    auto const& actual = *idos->at( i );
+    EXPECT_EQ( expected.bounding_box(), actual.bounding_box() );
+    EXPECT_EQ( expected.confidence(), actual.confidence() );
+    ASSERT_EQ( !!expected.type(), !!actual.type() );
+    if( expected.type() )
+    {
+      EXPECT_EQ( expected.type()->class_names(), actual.type()->class_names() );
+      for( auto const& n : expected.type()->class_names() )
+      {
+        EXPECT_EQ( expected.type()->score( n ), actual.type()->score( n ) );
+      }
+    }
+  }
+
+  ASSERT_TRUE( reader.read_set( idos, name ) );
+  EXPECT_EQ( "image_name_2", name );
+  EXPECT_TRUE( idos->empty() );
+
+  ASSERT_TRUE( reader.read_set( idos, name ) );
+  EXPECT_EQ( "image_name_3", name );
+  EXPECT_EQ( dos->size(), idos->size() );
+
+  EXPECT_FALSE( reader.read_set( idos, name ) );
+}
+
+// ----------------------------------------------------------------------------
+TEST(detected_object_io, binary_frame_range)
+{
+  kac::detected_object_set_input_binary reader;
+  kac::detected_object_set_output_binary writer;
+
+  auto dos = make_dos();
+
+  std::stringstream str;
+  writer.use_stream( &str );
+  for( int i = 1; i <= 5; ++i )
+  {
+    writer.write_set( dos, "image_" + std::to_string( i ) );
+  }
+  writer.close();
+
+  auto config = reader.get_configuration();
+  config->set_value( "first_frame", 2 );
+  config->set_value( "last_frame", 3 );
+  reader.set_configuration( config );
+
+  reader.use_stream( &str );
+  kwiver::vital::detected_object_set_sptr idos;
+  std::string name;
+  ASSERT_TRUE( reader.read_set( idos, name ) );
+  EXPECT_EQ( "image_2", name );
+  ASSERT_TRUE( reader.read_set( idos, name ) );
+  EXPECT_EQ( "image_3", name );
+  EXPECT_FALSE( reader.read_set( idos, name ) );
+}
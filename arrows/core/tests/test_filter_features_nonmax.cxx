@@ -0,0 +1,212 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Tests for the non-max suppression feature filter
+ */
+
+#include <arrows/core/filter_features_nonmax.h>
+
+#include <vital/plugin_loader/plugin_manager.h>
+#include <vital/types/feature_set.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace kwiver::vital;
+using kwiver::arrows::core::filter_features_nonmax;
+
+// ----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// Random features with distinct magnitudes over three octaves of scale
+feature_set_sptr
+random_features( size_t count, unsigned seed )
+{
+  std::mt19937 rng( seed );
+  std::uniform_real_distribution< double > x_dist( 0.0, 1000.0 );
+  std::uniform_real_distribution< double > y_dist( 0.0, 800.0 );
+  std::uniform_int_distribution< int > scale_dist( 0, 5 );
+  double const scales[] = { 1.0, 1.5, 2.0, 3.0, 4.0, 6.0 };
+
+  std::vector< double > magnitudes( count );
+  for( size_t i = 0; i < count; ++i )
+  {
+    magnitudes[ i ] = static_cast< double >( i );
+  }
+  std::shuffle( magnitudes.begin(), magnitudes.end(), rng );
+
+  std::vector< feature_sptr > features;
+  for( size_t i = 0; i < count; ++i )
+  {
+    features.push_back(
+      std::make_shared< feature_d >( vector_2d( x_dist( rng ), y_dist( rng ) ),
+                                     magnitudes[ i ],
+                                     scales[ scale_dist( rng ) ] ) );
+  }
+  return std::make_shared< simple_feature_set >( features );
+}
+
+// ----------------------------------------------------------------------------
+// The distance from each feature to the nearest stronger feature in the
+// same octave of scale, in units of the octave
+std::vector< double >
+brute_force_radii( std::vector< feature_sptr > const& features )
+{
+  std::vector< double > radii;
+  for( auto const& f : features )
+  {
+    auto const band = std::floor( std::log2( f->scale() ) );
+    double r = std::numeric_limits< double >::infinity();
+    for( auto const& g : features )
+    {
+      if( g->magnitude() > f->magnitude() &&
+          std::floor( std::log2( g->scale() ) ) == band )
+      {
+        r = std::min( r, ( g->loc() - f->loc() ).norm() );
+      }
+    }
+    radii.push_back( r / std::exp2( band ) );
+  }
+  return radii;
+}
+
+// ----------------------------------------------------------------------------
+class test_filter : public filter_features_nonmax
+{
+public:
+  using filter_features_nonmax::filter;
+};
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< test_filter >
+make_filter( unsigned target, double radius = 0.0 )
+{
+  auto filter = std::make_shared< test_filter >();
+  auto config = filter->get_configuration();
+  config->set_value( "method", "anms" );
+  config->set_value( "num_features_target", target );
+  config->set_value( "suppression_radius", radius );
+  EXPECT_TRUE( filter->check_configuration( config ) );
+  filter->set_configuration( config );
+  return filter;
+}
+
+} // end namespace
+
+// ----------------------------------------------------------------------------
+TEST(filter_features_nonmax, create)
+{
+  plugin_manager::instance().load_all_plugins();
+
+  EXPECT_NE( nullptr, algo::filter_features::create( "nonmax" ) );
+}
+
+// ----------------------------------------------------------------------------
+TEST(filter_features_nonmax, invalid_method)
+{
+  filter_features_nonmax filter;
+  auto config = filter.get_configuration();
+  EXPECT_TRUE( filter.check_configuration( config ) );
+  config->set_value( "method", "grid" );
+  EXPECT_FALSE( filter.check_configuration( config ) );
+}
+
+// ----------------------------------------------------------------------------
+// Exactly the target number of features with the largest radii are kept
+TEST(filter_features_nonmax, anms_target)
+{
+  auto const input = random_features( 3000, 7 );
+  auto const features = input->features();
+  auto const radii = brute_force_radii( features );
+
+  std::vector< unsigned > expected( features.size() );
+  for( unsigned i = 0; i < expected.size(); ++i )
+  {
+    expected[ i ] = i;
+  }
+  std::sort( expected.begin(), expected.end(),
+             [ & ]( unsigned l, unsigned r ){ return radii[ l ] > radii[ r ]; } );
+  expected.resize( 200 );
+  std::sort( expected.begin(), expected.end() );
+
+  std::vector< unsigned > indices;
+  auto const output = make_filter( 200 )->filter( input, indices );
+  ASSERT_EQ( 200, output->size() );
+  ASSERT_EQ( 200, indices.size() );
+
+  // output is in order of descending magnitude
+  auto const out_features = output->features();
+  for( size_t i = 0; i < indices.size(); ++i )
+  {
+    EXPECT_EQ( features[ indices[ i ] ], out_features[ i ] );
+    if( i > 0 )
+    {
+      EXPECT_GT( out_features[ i - 1 ]->magnitude(),
+                 out_features[ i ]->magnitude() );
+    }
+  }
+
+  std::sort( indices.begin(), indices.end() );
+  EXPECT_EQ( expected, indices );
+}
+
+// ----------------------------------------------------------------------------
+// Without a target, features with no stronger feature within the radius
+// are kept, so no two kept features of an octave are closer than that
+TEST(filter_features_nonmax, anms_radius)
+{
+  auto const input = random_features( 2000, 3 );
+  auto const features = input->features();
+  auto const radii = brute_force_radii( features );
+  double const radius = 20.0;
+
+  std::vector< unsigned > expected;
+  for( unsigned i = 0; i < features.size(); ++i )
+  {
+    if( radii[ i ] >= radius )
+    {
+      expected.push_back( i );
+    }
+  }
+
+  std::vector< unsigned > indices;
+  auto const output = make_filter( 0, radius )->filter( input, indices );
+  EXPECT_EQ( expected.size(), output->size() );
+  std::sort( indices.begin(), indices.end() );
+  EXPECT_EQ( expected, indices );
+
+  for( auto const& f : output->features() )
+  {
+    for( auto const& g : output->features() )
+    {
+      if( f != g && std::floor( std::log2( f->scale() ) ) ==
+                    std::floor( std::log2( g->scale() ) ) )
+      {
+        EXPECT_GE( ( f->loc() - g->loc() ).norm(), radius );
+      }
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Sets no larger than the target are returned unchanged
+TEST(filter_features_nonmax, anms_small_set)
+{
+  auto const input = random_features( 100, 1 );
+  std::vector< unsigned > indices;
+  EXPECT_EQ( input, make_filter( 100 )->filter( input, indices ) );
+}
@@ -0,0 +1,416 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Tests for the tiled feature detector and descriptor extractor
+ */
+
+#include <arrows/core/detect_features_tiled.h>
+#include <arrows/core/extract_descriptors_tiled.h>
+#include <arrows/core/image_tiles.h>
+
+#include <vital/algo/algorithm_factory.h>
+#include <vital/plugin_loader/plugin_manager.h>
+#include <vital/types/descriptor.h>
+#include <vital/types/descriptor_set.h>
+#include <vital/types/feature_set.h>
+#include <vital/types/image_container.h>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+
+using namespace kwiver::vital;
+using namespace kwiver::arrows::core;
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// Detects pixels at least as bright as their neighbors in the given image
+class local_max_detector
+  : public algo::detect_features
+{
+public:
+  PLUGIN_INFO( "test_local_max", "Test detector of bright pixels" )
+
+  void set_configuration( config_block_sptr ) override {}
+  bool check_configuration( config_block_sptr ) const override
+  { return true; }
+
+  feature_set_sptr
+  detect( image_container_sptr image_data,
+          image_container_sptr mask ) const override
+  {
+    image_of< uint8_t > const img( image_data->get_image() );
+    image_of< uint8_t > mask_img;
+    if( mask )
+    {
+      mask_img = image_of< uint8_t >( mask->get_image() );
+    }
+
+    std::vector< feature_sptr > features;
+    int const w = static_cast< int >( img.width() );
+    int const h = static_cast< int >( img.height() );
+    for( int j = 0; j < h; ++j )
+    {
+      for( int i = 0; i < w; ++i )
+      {
+        auto const v = img( i, j );
+        if( v == 0 || ( mask && mask_img( i, j ) == 0 ) )
+        {
+          continue;
+        }
+        bool is_max = true;
+        for( int y = std::max( j - 1, 0 ); y <= std::min( j + 1, h - 1 ); ++y )
+        {
+          for( int x = std::max( i - 1, 0 ); x <= std::min( i + 1, w - 1 );
+               ++x )
+          {
+            is_max = is_max && img( x, y ) <= v;
+          }
+        }
+        if( is_max )
+        {
+          features.push_back( std::make_shared< feature_d >(
+            vector_2d( i, j ), static_cast< double >( v ) ) );
+        }
+      }
+    }
+    return std::make_shared< simple_feature_set >( features );
+  }
+};
+
+// ----------------------------------------------------------------------------
+// Describes each feature by the sum of the 5x5 patch around it, dropping
+// features too close to the image border
+class patch_sum_extractor
+  : public algo::extract_descriptors
+{
+public:
+  PLUGIN_INFO( "test_patch_sum", "Test extractor of patch sums" )
+
+  void set_configuration( config_block_sptr ) override {}
+  bool check_configuration( config_block_sptr ) const override
+  { return true; }
+
+  descriptor_set_sptr
+  extract( image_container_sptr image_data, feature_set_sptr& features,
+           image_container_sptr ) const override
+  {
+    image_of< uint8_t > const img( image_data->get_image() );
+    std::vector< feature_sptr > kept;
+    std::vector< descriptor_sptr > descriptors;
+    for( auto const& f : features->features() )
+    {
+      int const i = static_cast< int >( f->loc()[ 0 ] );
+      int const j = static_cast< int >( f->loc()[ 1 ] );
+      if( i < 2 || j < 2 || i + 2 >= static_cast< int >( img.width() ) ||
+          j + 2 >= static_cast< int >( img.height() ) )
+      {
+        continue;
+      }
+      auto const d = std::make_shared< descriptor_fixed< double, 1 > >();
+      d->raw_data()[ 0 ] = 0.0;
+      for( int y = j - 2; y <= j + 2; ++y )
+      {
+        for( int x = i - 2; x <= i + 2; ++x )
+        {
+          d->raw_data()[ 0 ] += img( x, y );
+        }
+      }
+      kept.push_back( f );
+      descriptors.push_back( d );
+    }
+    features = std::make_shared< simple_feature_set >( kept );
+    return std::make_shared< simple_descriptor_set >( descriptors );
+  }
+};
+
+// ----------------------------------------------------------------------------
+// A dark image with scattered bright pixels
+image_container_sptr
+test_image( unsigned seed )
+{
+  std::mt19937 rng( seed );
+  std::uniform_int_distribution< int > value_dist( 1, 255 );
+  std::bernoulli_distribution bright_dist( 0.02 );
+  image_of< uint8_t > img( 300, 200, 1 );
+  for( size_t j = 0; j < img.height(); ++j )
+  {
+    for( size_t i = 0; i < img.width(); ++i )
+    {
+      img( i, j ) = bright_dist( rng )
+                    ? static_cast< uint8_t >( value_dist( rng ) ) : 0;
+    }
+  }
+  return std::make_shared< simple_image_container >( img );
+}
+
+// ----------------------------------------------------------------------------
+std::map< std::pair< int, int >, double >
+by_location( feature_set_sptr const& features )
+{
+  std::map< std::pair< int, int >, double > result;
+  for( auto const& f : features->features() )
+  {
+    result[ { static_cast< int >( f->loc()[ 0 ] ),
+              static_cast< int >( f->loc()[ 1 ] ) } ] = f->magnitude();
+  }
+  EXPECT_EQ( features->size(), result.size() );
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< detect_features_tiled >
+make_detector( unsigned overlap, unsigned budget, double duplicate_distance )
+{
+  auto detector = std::make_shared< detect_features_tiled >();
+  auto config = detector->get_configuration();
+  config->set_value( "detector:type", "test_local_max" );
+  config->set_value( "tile_width", 64 );
+  config->set_value( "tile_height", 48 );
+  config->set_value( "tile_overlap", overlap );
+  config->set_value( "max_features_per_tile", budget );
+  config->set_value( "duplicate_distance", duplicate_distance );
+  EXPECT_TRUE( detector->check_configuration( config ) );
+  detector->set_configuration( config );
+  return detector;
+}
+
+} // end namespace
+
+// ----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest( &argc, argv );
+
+  auto& pm = plugin_manager::instance();
+  pm.load_all_plugins();
+  pm.add_factory( new algorithm_factory_0< local_max_detector >(
+    local_max_detector::static_type_name(),
+    local_max_detector::_plugin_name ) );
+  pm.add_factory( new algorithm_factory_0< patch_sum_extractor >(
+    patch_sum_extractor::static_type_name(),
+    patch_sum_extractor::_plugin_name ) );
+
+  return RUN_ALL_TESTS();
+}
+
+// ----------------------------------------------------------------------------
+TEST(image_tiles, split)
+{
+  auto const tiles = split_image_tiles( 300, 200, 64, 48, 5 );
+  ASSERT_EQ( 5 * 5, tiles.size() );
+
+  // the cores cover each pixel once
+  std::vector< int > covered( 300 * 200, 0 );
+  for( auto const& t : tiles )
+  {
+    EXPECT_LE( t.x + t.width, 300 );
+    EXPECT_LE( t.y + t.height, 200 );
+    for( size_t j = t.core_y0; j < t.core_y1; ++j )
+    {
+      for( size_t i = t.core_x0; i < t.core_x1; ++i )
+      {
+        ++covered[ j * 300 + i ];
+        EXPECT_EQ( &t - tiles.data(),
+                   tile_index( vector_2d( i + 0.5, j + 0.5 ), 300, 200,
+                               64, 48 ) );
+      }
+    }
+  }
+  EXPECT_EQ( std::vector< int >( 300 * 200, 1 ), covered );
+
+  EXPECT_EQ( 0, tiles[ 0 ].x );
+  EXPECT_EQ( 64 + 5, tiles[ 0 ].width );
+  EXPECT_EQ( 128 - 5, tiles[ 7 ].x );
+  EXPECT_EQ( 64 + 10, tiles[ 7 ].width );
+  EXPECT_EQ( 300 - 256 + 5, tiles[ 4 ].width );
+
+  // locations outside the image belong to the nearest tile
+  EXPECT_EQ( 0, tile_index( vector_2d( -3, -1 ), 300, 200, 64, 48 ) );
+  EXPECT_EQ( 24, tile_index( vector_2d( 400, 250 ), 300, 200, 64, 48 ) );
+}
+
+// ----------------------------------------------------------------------------
+TEST(detect_features_tiled, create)
+{
+  EXPECT_NE( nullptr, algo::detect_features::create( "tiled" ) );
+  EXPECT_NE( nullptr, algo::extract_descriptors::create( "tiled" ) );
+}
+
+// ----------------------------------------------------------------------------
+// With enough overlap the tiles find the same features as the whole image
+TEST(detect_features_tiled, matches_full_image)
+{
+  auto const image = test_image( 1 );
+  auto const expected = by_location( local_max_detector().detect( image,
+                                                                  nullptr ) );
+  ASSERT_GT( expected.size(), 500 );
+
+  auto const features = make_detector( 2, 0, 0.0 )->detect( image );
+  EXPECT_EQ( expected, by_location( features ) );
+}
+
+// ----------------------------------------------------------------------------
+// Only the strongest features of each tile are kept
+TEST(detect_features_tiled, tile_budget)
+{
+  auto const image = test_image( 2 );
+  auto const all = make_detector( 2, 0, 0.0 )->detect( image );
+  auto const features = make_detector( 2, 3, 0.0 )->detect( image );
+
+  auto const tiles = split_image_tiles( 300, 200, 64, 48, 2 );
+  std::vector< std::vector< double > > tile_magnitudes( tiles.size() );
+  for( auto const& f : all->features() )
+  {
+    tile_magnitudes[ tile_index( f->loc(), 300, 200, 64, 48 ) ].push_back(
+      f->magnitude() );
+  }
+  std::vector< size_t > counts( tiles.size(), 0 );
+  for( auto const& f : features->features() )
+  {
+    auto const t = tile_index( f->loc(), 300, 200, 64, 48 );
+    ++counts[ t ];
+    // no more than two stronger features in the tile
+    auto const& mags = tile_magnitudes[ t ];
+    EXPECT_LE( std::count_if( mags.begin(), mags.end(),
+                              [ & ]( double m ){ return m > f->magnitude(); } ),
+               2 );
+  }
+  for( size_t t = 0; t < tiles.size(); ++t )
+  {
+    EXPECT_EQ( std::min< size_t >( 3, tile_magnitudes[ t ].size() ),
+               counts[ t ] );
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Close features on opposite sides of a tile border are merged
+TEST(detect_features_tiled, merge_duplicates)
+{
+  image_of< uint8_t > img( 300, 200, 1 );
+  for( size_t j = 0; j < img.height(); ++j )
+  {
+    for( size_t i = 0; i < img.width(); ++i )
+    {
+      img( i, j ) = 0;
+    }
+  }
+  // equal pairs across the borders at x = 64 and y = 48, and one within a
+  // tile
+  img( 63, 10 ) = 150;
+  img( 64, 10 ) = 150;
+  img( 20, 47 ) = 180;
+  img( 20, 48 ) = 180;
+  img( 30, 30 ) = 50;
+  img( 31, 30 ) = 50;
+  auto const image = std::make_shared< simple_image_container >( img );
+
+  auto const all = by_location( make_detector( 2, 0, 0.0 )->detect( image ) );
+  EXPECT_EQ( 6, all.size() );
+
+  auto const merged =
+    by_location( make_detector( 2, 0, 1.5 )->detect( image ) );
+  EXPECT_EQ( 4, merged.size() );
+  EXPECT_EQ( 1, merged.count( { 63, 10 } ) );
+  EXPECT_EQ( 1, merged.count( { 20, 47 } ) );
+  EXPECT_EQ( 1, merged.count( { 30, 30 } ) );
+  EXPECT_EQ( 1, merged.count( { 31, 30 } ) );
+}
+
+// ----------------------------------------------------------------------------
+TEST(detect_features_tiled, mask)
+{
+  auto const image = test_image( 3 );
+  image_of< uint8_t > mask( 300, 200, 1 );
+  for( size_t j = 0; j < mask.height(); ++j )
+  {
+    for( size_t i = 0; i < mask.width(); ++i )
+    {
+      mask( i, j ) = i < 150 ? 0 : 1;
+    }
+  }
+  auto const mask_image = std::make_shared< simple_image_container >( mask );
+
+  auto const expected =
+    by_location( local_max_detector().detect( image, mask_image ) );
+  auto const features = make_detector( 2, 0, 0.0 )->detect( image,
+                                                            mask_image );
+  EXPECT_EQ( expected, by_location( features ) );
+  for( auto const& f : features->features() )
+  {
+    EXPECT_GE( f->loc()[ 0 ], 150 );
+  }
+
+  auto const small_mask = std::make_shared< simple_image_container >(
+    image_of< uint8_t >( 30, 20, 1 ) );
+  EXPECT_THROW( make_detector( 2, 0, 0.0 )->detect( image, small_mask ),
+                image_size_mismatch_exception );
+}
+
+// ----------------------------------------------------------------------------
+// A nested algorithm which can not be created is an error
+TEST(detect_features_tiled, missing_detector)
+{
+  auto const image = test_image( 5 );
+
+  auto detector = std::make_shared< detect_features_tiled >();
+  auto config = detector->get_configuration();
+  config->set_value( "detector:type", "test_local_max" );
+  detector->set_configuration( config );
+  config->set_value( "detector:type", "no_such_detector" );
+  detector->set_configuration( config );
+  EXPECT_THROW( detector->detect( image ), algorithm_exception );
+}
+
+// ----------------------------------------------------------------------------
+// Descriptors extracted in tiles match those of the whole image
+TEST(extract_descriptors_tiled, matches_full_image)
+{
+  auto const image = test_image( 4 );
+  auto const detected = local_max_detector().detect( image, nullptr );
+
+  auto expected_features = detected;
+  auto const expected_descriptors =
+    patch_sum_extractor().extract( image, expected_features, nullptr );
+  std::map< std::pair< int, int >, double > expected;
+  for( size_t i = 0; i < expected_features->size(); ++i )
+  {
+    auto const& loc = expected_features->features()[ i ]->loc();
+    expected[ { static_cast< int >( loc[ 0 ] ),
+                static_cast< int >( loc[ 1 ] ) } ] =
+      expected_descriptors->descriptors()[ i ]->as_double()[ 0 ];
+  }
+  // features at the image border are dropped
+  EXPECT_LT( expected.size(), detected->size() );
+
+  auto extractor = std::make_shared< extract_descriptors_tiled >();
+  auto config = extractor->get_configuration();
+  config->set_value( "extractor:type", "test_patch_sum" );
+  config->set_value( "tile_width", 50 );
+  config->set_value( "tile_height", 40 );
+  config->set_value( "tile_overlap", 2 );
+  EXPECT_TRUE( extractor->check_configuration( config ) );
+  extractor->set_configuration( config );
+
+  auto features = detected;
+  auto const descriptors = extractor->extract( image, features );
+  ASSERT_EQ( features->size(), descriptors->size() );
+
+  // the input features are returned in their original order
+  EXPECT_EQ( expected_features->features(), features->features() );
+
+  std::map< std::pair< int, int >, double > result;
+  for( size_t i = 0; i < features->size(); ++i )
+  {
+    auto const& loc = features->features()[ i ]->loc();
+    result[ { static_cast< int >( loc[ 0 ] ),
+              static_cast< int >( loc[ 1 ] ) } ] =
+      descriptors->descriptors()[ i ]->as_double()[ 0 ];
+  }
+  EXPECT_EQ( expected, result );
+}
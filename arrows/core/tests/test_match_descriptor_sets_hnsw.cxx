@@ -0,0 +1,409 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Tests for the HNSW descriptor set matcher
+ */
+
+#include <test_tmpfn.h>
+
+#include <arrows/core/match_descriptor_sets_hnsw.h>
+
+#include <vital/exceptions/base.h>
+#include <vital/exceptions/io.h>
+#include <vital/plugin_loader/plugin_manager.h>
+#include <vital/types/descriptor_set.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <random>
+
+using namespace kwiver::vital;
+using kwiver::arrows::core::match_descriptor_sets_hnsw;
+
+// ----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
+
+namespace {
+
+typedef std::vector< std::vector< uint8_t > > frame_bytes_t;
+
+// ----------------------------------------------------------------------------
+// Random bytes for the descriptors of one frame
+frame_bytes_t
+random_frame( size_t count, std::mt19937& rng )
+{
+  std::uniform_int_distribution< int > byte_dist( 0, 255 );
+  frame_bytes_t frame( count, std::vector< uint8_t >( 32 ) );
+  for( auto& d : frame )
+  {
+    for( auto& b : d )
+    {
+      b = static_cast< uint8_t >( byte_dist( rng ) );
+    }
+  }
+  return frame;
+}
+
+// ----------------------------------------------------------------------------
+// A view of the same scene: most descriptors are kept with a few bits
+// flipped and the rest are replaced
+frame_bytes_t
+revisit_frame( frame_bytes_t frame, std::mt19937& rng )
+{
+  std::uniform_int_distribution< int > byte_dist( 0, 255 );
+  std::uniform_int_distribution< size_t > index_dist( 0, 31 );
+  for( size_t i = 0; i < frame.size(); ++i )
+  {
+    if( i % 4 == 0 )
+    {
+      for( auto& b : frame[ i ] )
+      {
+        b = static_cast< uint8_t >( byte_dist( rng ) );
+      }
+    }
+    else
+    {
+      frame[ i ][ index_dist( rng ) ] ^= 0x01;
+    }
+  }
+  return frame;
+}
+
+// ----------------------------------------------------------------------------
+descriptor_set_sptr
+make_set( frame_bytes_t const& frame )
+{
+  std::vector< descriptor_sptr > desc;
+  for( auto const& bytes : frame )
+  {
+    auto d = std::make_shared< descriptor_fixed< uint8_t, 32 > >();
+    std::copy( bytes.begin(), bytes.end(), d->raw_data() );
+    desc.push_back( d );
+  }
+  return std::make_shared< simple_descriptor_set >( desc );
+}
+
+// ----------------------------------------------------------------------------
+// Frames whose descriptors are drawn with different bit biases, so that each
+// has a distinct aggregate descriptor
+std::vector< frame_bytes_t >
+random_frames( size_t count, std::mt19937& rng )
+{
+  std::uniform_int_distribution< int > byte_dist( 0, 255 );
+  std::vector< frame_bytes_t > frames;
+  for( size_t f = 0; f < count; ++f )
+  {
+    auto frame = random_frame( 200, rng );
+    auto const mask = random_frame( 1, rng ).front();
+    for( auto& d : frame )
+    {
+      for( size_t i = 0; i < d.size(); ++i )
+      {
+        // take each bit from the frame's mask three times in four
+        auto const keep = byte_dist( rng ) & byte_dist( rng );
+        d[ i ] = static_cast< uint8_t >( ( d[ i ] & keep ) |
+                                         ( mask[ i ] & ~keep ) );
+      }
+    }
+    frames.push_back( frame );
+  }
+  return frames;
+}
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< match_descriptor_sets_hnsw >
+make_matcher( std::string const& index_path = "",
+              size_t snapshot_interval = 0 )
+{
+  auto matcher = std::make_shared< match_descriptor_sets_hnsw >();
+  auto config = matcher->get_configuration();
+  config->set_value( "max_results", 3 );
+  config->set_value( "max_connections", 8 );
+  config->set_value( "index_path", index_path );
+  config->set_value( "snapshot_interval", snapshot_interval );
+  EXPECT_TRUE( matcher->check_configuration( config ) );
+  matcher->set_configuration( config );
+  return matcher;
+}
+
+} // end namespace
+
+// ----------------------------------------------------------------------------
+TEST(match_descriptor_sets_hnsw, create)
+{
+  plugin_manager::instance().load_all_plugins();
+
+  EXPECT_NE( nullptr, algo::match_descriptor_sets::create( "hnsw" ) );
+}
+
+// ----------------------------------------------------------------------------
+// Revisits of indexed frames find the original frame first
+TEST(match_descriptor_sets_hnsw, find_revisits)
+{
+  std::mt19937 rng( 3 );
+  auto const frames = random_frames( 300, rng );
+
+  auto matcher = make_matcher();
+  EXPECT_TRUE( matcher->query( make_set( frames[ 0 ] ) ).empty() );
+  for( size_t f = 0; f < frames.size(); ++f )
+  {
+    matcher->append_to_index( make_set( frames[ f ] ), 10 * f );
+  }
+  EXPECT_EQ( frames.size(), matcher->size() );
+
+  for( size_t f = 0; f < frames.size(); f += 7 )
+  {
+    auto const result =
+      matcher->query( make_set( revisit_frame( frames[ f ], rng ) ) );
+    ASSERT_FALSE( result.empty() );
+    EXPECT_EQ( 10 * f, result.front() );
+    EXPECT_LE( result.size(), 3 );
+  }
+}
+
+// ----------------------------------------------------------------------------
+TEST(match_descriptor_sets_hnsw, query_and_append)
+{
+  std::mt19937 rng( 5 );
+  auto const frames = random_frames( 50, rng );
+
+  // return the nearest frames however dissimilar
+  auto matcher = make_matcher();
+  auto config = matcher->get_configuration();
+  config->set_value( "min_similarity", -1.0 );
+  matcher->set_configuration( config );
+  for( size_t f = 0; f < frames.size(); ++f )
+  {
+    auto const result =
+      matcher->query_and_append( make_set( frames[ f ] ), f );
+    EXPECT_EQ( f, matcher->size() - 1 );
+    EXPECT_EQ( std::min< size_t >( f, 3 ), result.size() );
+  }
+
+  auto const result =
+    matcher->query_and_append( make_set( revisit_frame( frames[ 20 ], rng ) ),
+                               100 );
+  ASSERT_FALSE( result.empty() );
+  EXPECT_EQ( 20, result.front() );
+
+  // the revisit is now indexed too
+  auto const result2 =
+    matcher->query( make_set( revisit_frame( frames[ 20 ], rng ) ) );
+  ASSERT_EQ( 3, result2.size() );
+  EXPECT_TRUE( ( result2[ 0 ] == 20 && result2[ 1 ] == 100 ) ||
+               ( result2[ 0 ] == 100 && result2[ 1 ] == 20 ) );
+}
+
+// ----------------------------------------------------------------------------
+TEST(match_descriptor_sets_hnsw, empty_sets)
+{
+  std::mt19937 rng( 1 );
+  auto matcher = make_matcher();
+  auto const empty = std::make_shared< simple_descriptor_set >();
+
+  matcher->append_to_index( empty, 0 );
+  EXPECT_EQ( 0, matcher->size() );
+
+  matcher->append_to_index( make_set( random_frame( 10, rng ) ), 1 );
+  EXPECT_TRUE( matcher->query( empty ).empty() );
+  EXPECT_TRUE( matcher->query( nullptr ).empty() );
+}
+
+// ----------------------------------------------------------------------------
+TEST(match_descriptor_sets_hnsw, dimension_mismatch)
+{
+  std::mt19937 rng( 1 );
+  auto matcher = make_matcher();
+  matcher->append_to_index( make_set( random_frame( 10, rng ) ), 0 );
+
+  auto const other = std::make_shared< simple_descriptor_set >(
+    std::vector< descriptor_sptr >(
+      1, std::make_shared< descriptor_fixed< uint8_t, 64 > >() ) );
+  EXPECT_THROW( matcher->append_to_index( other, 1 ), invalid_value );
+  EXPECT_THROW( matcher->query( other ), invalid_value );
+}
+
+// ----------------------------------------------------------------------------
+// A saved index answers queries as before and can be extended
+TEST(match_descriptor_sets_hnsw, save_load)
+{
+  std::mt19937 rng( 11 );
+  auto const frames = random_frames( 120, rng );
+  std::vector< descriptor_set_sptr > queries;
+  for( size_t f = 0; f < frames.size(); f += 5 )
+  {
+    queries.push_back( make_set( revisit_frame( frames[ f ], rng ) ) );
+  }
+
+  auto const path = kwiver::testing::temp_file_name( "test-hnsw-", ".idx" );
+  auto matcher = make_matcher();
+  for( size_t f = 0; f < 100; ++f )
+  {
+    matcher->append_to_index( make_set( frames[ f ] ), f );
+  }
+  matcher->save( path );
+
+  auto loaded = make_matcher();
+  loaded->load( path );
+  EXPECT_EQ( matcher->size(), loaded->size() );
+  for( auto const& q : queries )
+  {
+    EXPECT_EQ( matcher->query( q ), loaded->query( q ) );
+  }
+
+  // appending to both gives the same graph
+  for( size_t f = 100; f < frames.size(); ++f )
+  {
+    matcher->append_to_index( make_set( frames[ f ] ), f );
+    loaded->append_to_index( make_set( frames[ f ] ), f );
+  }
+  for( auto const& q : queries )
+  {
+    EXPECT_EQ( matcher->query( q ), loaded->query( q ) );
+  }
+
+  // saving over the mapped file keeps the loaded index usable
+  loaded->save( path );
+  for( auto const& q : queries )
+  {
+    EXPECT_EQ( matcher->query( q ), loaded->query( q ) );
+  }
+
+  std::remove( path.c_str() );
+}
+
+// ----------------------------------------------------------------------------
+// An index_path is written periodically and on destruction, and reloaded
+// when configured
+TEST(match_descriptor_sets_hnsw, index_path)
+{
+  std::mt19937 rng( 13 );
+  auto const frames = random_frames( 25, rng );
+  auto const path = kwiver::testing::temp_file_name( "test-hnsw-", ".idx" );
+
+  {
+    auto matcher = make_matcher( path, 10 );
+    for( size_t f = 0; f < 15; ++f )
+    {
+      matcher->append_to_index( make_set( frames[ f ] ), f );
+    }
+    EXPECT_EQ( 10, make_matcher( path )->size() );
+
+    for( size_t f = 15; f < frames.size(); ++f )
+    {
+      matcher->append_to_index( make_set( frames[ f ] ), f );
+    }
+  }
+
+  auto matcher = make_matcher( path );
+  EXPECT_EQ( frames.size(), matcher->size() );
+  auto const result =
+    matcher->query( make_set( revisit_frame( frames[ 17 ], rng ) ) );
+  ASSERT_FALSE( result.empty() );
+  EXPECT_EQ( 17, result.front() );
+
+  std::remove( path.c_str() );
+}
+
+// ----------------------------------------------------------------------------
+TEST(match_descriptor_sets_hnsw, invalid_file)
+{
+  auto const path = kwiver::testing::temp_file_name( "test-hnsw-", ".idx" );
+  auto matcher = make_matcher();
+
+  EXPECT_THROW( matcher->load( path ), file_not_found_exception );
+
+  {
+    std::ofstream ofs( path, std::ios::binary );
+    ofs << "not an index file, but long enough to hold a header........."
+           "..............................................................";
+  }
+  EXPECT_THROW( matcher->load( path ), invalid_data );
+  EXPECT_EQ( 0, matcher->size() );
+
+  // a truncated index
+  std::mt19937 rng( 1 );
+  auto const frames = random_frames( 20, rng );
+  for( size_t f = 0; f < frames.size(); ++f )
+  {
+    matcher->append_to_index( make_set( frames[ f ] ), f );
+  }
+  matcher->save( path );
+  std::string contents;
+  {
+    std::ifstream ifs( path, std::ios::binary );
+    contents.assign( std::istreambuf_iterator< char >( ifs ), {} );
+  }
+  {
+    std::ofstream ofs( path, std::ios::binary );
+    ofs.write( contents.data(), contents.size() / 2 );
+  }
+  EXPECT_THROW( matcher->load( path ), invalid_data );
+
+  // a node count whose section sizes overflow to almost nothing
+  {
+    auto corrupt = contents;
+    uint64_t const num_nodes = uint64_t( 1 ) << 62;
+    std::memcpy( &corrupt[ 16 ], &num_nodes, sizeof( num_nodes ) );
+    std::ofstream ofs( path, std::ios::binary );
+    ofs.write( corrupt.data(), corrupt.size() );
+  }
+  EXPECT_THROW( matcher->load( path ), invalid_data );
+  EXPECT_EQ( 0, matcher->size() );
+
+  // a graph level far beyond what the links in the file can hold
+  {
+    auto corrupt = contents;
+    int32_t const max_level = std::numeric_limits< int32_t >::max();
+    uint64_t levels_offset;
+    std::memcpy( &corrupt[ 44 ], &max_level, sizeof( max_level ) );
+    std::memcpy( &levels_offset, &corrupt[ 56 ], sizeof( levels_offset ) );
+    std::memcpy( &corrupt[ levels_offset ], &max_level, sizeof( max_level ) );
+    std::ofstream ofs( path, std::ios::binary );
+    ofs.write( corrupt.data(), corrupt.size() );
+  }
+  EXPECT_THROW( matcher->load( path ), invalid_data );
+  EXPECT_EQ( 0, matcher->size() );
+
+  // a node level above its links, within a plausible maximum level
+  {
+    auto corrupt = contents;
+    int32_t max_level;
+    uint64_t levels_offset;
+    std::memcpy( &max_level, &corrupt[ 44 ], sizeof( max_level ) );
+    std::memcpy( &levels_offset, &corrupt[ 56 ], sizeof( levels_offset ) );
+    for( size_t i = 0; i < frames.size(); ++i )
+    {
+      std::memcpy( &corrupt[ levels_offset + i * sizeof( int32_t ) ],
+                   &max_level, sizeof( max_level ) );
+    }
+    std::ofstream ofs( path, std::ios::binary );
+    ofs.write( corrupt.data(), corrupt.size() );
+  }
+  EXPECT_THROW( matcher->load( path ), invalid_data );
+  EXPECT_EQ( 0, matcher->size() );
+
+  // an index built from non-binary descriptors
+  {
+    std::ofstream ofs( path, std::ios::binary );
+    ofs.write( contents.data(), contents.size() );
+  }
+  auto real_matcher = std::make_shared< match_descriptor_sets_hnsw >();
+  auto config = real_matcher->get_configuration();
+  config->set_value( "binary_descriptors", false );
+  real_matcher->set_configuration( config );
+  EXPECT_THROW( real_matcher->load( path ), invalid_data );
+
+  std::remove( path.c_str() );
+}
@@ -0,0 +1,260 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Tests for the Hamming distance feature matcher
+ */
+
+#include <arrows/core/match_features_hamming.h>
+
+#include <vital/exceptions/base.h>
+#include <vital/plugin_loader/plugin_manager.h>
+#include <vital/types/descriptor_matrix_set.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+using namespace kwiver::vital;
+using kwiver::arrows::core::match_features_hamming;
+
+// ----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
+
+namespace {
+
+// ----------------------------------------------------------------------------
+std::vector< descriptor_sptr >
+random_descriptors( size_t count, size_t num_bytes, std::mt19937& rng )
+{
+  std::uniform_int_distribution< int > byte_dist( 0, 255 );
+  std::vector< descriptor_sptr > desc;
+  for( size_t i = 0; i < count; ++i )
+  {
+    auto d = std::make_shared< descriptor_dynamic< uint8_t > >( num_bytes );
+    for( size_t j = 0; j < num_bytes; ++j )
+    {
+      d->raw_data()[ j ] = static_cast< uint8_t >( byte_dist( rng ) );
+    }
+    desc.push_back( d );
+  }
+  return desc;
+}
+
+// ----------------------------------------------------------------------------
+unsigned
+reference_distance( descriptor_sptr const& a, descriptor_sptr const& b )
+{
+  unsigned dist = 0;
+  for( size_t i = 0; i < a->num_bytes(); ++i )
+  {
+    for( unsigned x = a->as_bytes()[ i ] ^ b->as_bytes()[ i ]; x; x >>= 1 )
+    {
+      dist += x & 1;
+    }
+  }
+  return dist;
+}
+
+// ----------------------------------------------------------------------------
+// The distance from each query to each train descriptor
+std::vector< std::vector< unsigned > >
+reference_distances( std::vector< descriptor_sptr > const& query,
+                     std::vector< descriptor_sptr > const& train )
+{
+  std::vector< std::vector< unsigned > > dist( query.size() );
+  for( size_t q = 0; q < query.size(); ++q )
+  {
+    for( auto const& t : train )
+    {
+      dist[ q ].push_back( reference_distance( query[ q ], t ) );
+    }
+  }
+  return dist;
+}
+
+// ----------------------------------------------------------------------------
+// Straightforward implementation of the matching rules
+std::vector< match >
+reference_match( std::vector< std::vector< unsigned > > const& dist,
+                 double ratio, bool cross_check, unsigned max_distance )
+{
+  std::vector< match > matches;
+  for( unsigned q = 0; q < dist.size(); ++q )
+  {
+    auto const& row = dist[ q ];
+    auto const best_train = static_cast< unsigned >(
+      std::min_element( row.begin(), row.end() ) - row.begin() );
+    auto const best = row[ best_train ];
+
+    auto second = std::numeric_limits< unsigned >::max();
+    for( unsigned t = 0; t < row.size(); ++t )
+    {
+      if( t != best_train )
+      {
+        second = std::min( second, row[ t ] );
+      }
+    }
+
+    unsigned best_query = 0;
+    for( unsigned q2 = 1; q2 < dist.size(); ++q2 )
+    {
+      if( dist[ q2 ][ best_train ] < dist[ best_query ][ best_train ] )
+      {
+        best_query = q2;
+      }
+    }
+
+    if( ( max_distance > 0 && best > max_distance ) ||
+        ( ratio < 1.0 && row.size() > 1 && best >= ratio * second ) ||
+        ( cross_check && best_query != q ) )
+    {
+      continue;
+    }
+    matches.push_back( match( q, best_train ) );
+  }
+  return matches;
+}
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< match_features_hamming >
+make_matcher( double ratio, bool cross_check, unsigned max_distance = 0 )
+{
+  auto matcher = std::make_shared< match_features_hamming >();
+  auto config = matcher->get_configuration();
+  config->set_value( "ratio_test", ratio );
+  config->set_value( "cross_check", cross_check );
+  config->set_value( "max_distance", max_distance );
+  matcher->set_configuration( config );
+  return matcher;
+}
+
+} // end namespace
+
+// ----------------------------------------------------------------------------
+TEST(match_features_hamming, create)
+{
+  plugin_manager::instance().load_all_plugins();
+
+  EXPECT_NE( nullptr, algo::match_features::create( "hamming" ) );
+}
+
+// ----------------------------------------------------------------------------
+// Permuted copies with a few flipped bits match back to the originals
+TEST(match_features_hamming, permuted_copies)
+{
+  std::mt19937 rng( 42 );
+  auto const desc1 = random_descriptors( 300, 32, rng );
+
+  std::vector< unsigned > perm( desc1.size() );
+  for( unsigned i = 0; i < perm.size(); ++i )
+  {
+    perm[ i ] = i;
+  }
+  std::shuffle( perm.begin(), perm.end(), rng );
+
+  std::vector< descriptor_sptr > desc2( desc1.size() );
+  for( unsigned i = 0; i < perm.size(); ++i )
+  {
+    auto d = std::make_shared< descriptor_fixed< uint8_t, 32 > >();
+    std::copy( desc1[ i ]->as_bytes(), desc1[ i ]->as_bytes() + 32,
+               d->raw_data() );
+    d->raw_data()[ i % 32 ] ^= 0x11;
+    desc2[ perm[ i ] ] = d;
+  }
+
+  auto matcher = make_matcher( 0.8, true );
+  auto const matches = matcher->match(
+    nullptr, std::make_shared< simple_descriptor_set >( desc1 ),
+    nullptr, std::make_shared< descriptor_matrix_set< uint8_t > >( desc2 )
+    )->matches();
+
+  ASSERT_EQ( desc1.size(), matches.size() );
+  for( auto const& m : matches )
+  {
+    EXPECT_EQ( perm[ m.first ], m.second );
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Results agree with a direct implementation for lengths which exercise the
+// vector and scalar code paths, and for all combinations of filters
+TEST(match_features_hamming, matches_reference)
+{
+  std::mt19937 rng( 7 );
+  for( size_t num_bytes : { 8, 32, 61, 64, 96 } )
+  {
+    // many near duplicates so that the filters have something to remove
+    auto desc1 = random_descriptors( 150, num_bytes, rng );
+    auto desc2 = random_descriptors( 650, num_bytes, rng );
+    for( size_t i = 0; i < desc1.size(); i += 2 )
+    {
+      std::copy( desc1[ i ]->as_bytes(),
+                 desc1[ i ]->as_bytes() + num_bytes,
+                 std::dynamic_pointer_cast< descriptor_dynamic< uint8_t > >(
+                   desc2[ i * 3 ] )->raw_data() );
+    }
+
+    auto const dist = reference_distances( desc1, desc2 );
+    auto const set1 = std::make_shared< simple_descriptor_set >( desc1 );
+    auto const set2 = std::make_shared< simple_descriptor_set >( desc2 );
+    for( double ratio : { 0.7, 1.0 } )
+    {
+      for( bool cross_check : { false, true } )
+      {
+        for( unsigned max_distance : { 0u, unsigned( num_bytes * 3 ) } )
+        {
+          SCOPED_TRACE( "bytes " + std::to_string( num_bytes ) +
+                        " ratio " + std::to_string( ratio ) +
+                        " cross_check " + std::to_string( cross_check ) +
+                        " max_distance " + std::to_string( max_distance ) );
+          auto matcher = make_matcher( ratio, cross_check, max_distance );
+          auto const matches =
+            matcher->match( nullptr, set1, nullptr, set2 )->matches();
+          EXPECT_EQ( reference_match( dist, ratio, cross_check, max_distance ),
+                     matches );
+        }
+      }
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+TEST(match_features_hamming, empty_sets)
+{
+  std::mt19937 rng( 1 );
+  auto matcher = make_matcher( 0.8, true );
+  auto const desc = std::make_shared< simple_descriptor_set >(
+    random_descriptors( 10, 32, rng ) );
+  auto const empty = std::make_shared< simple_descriptor_set >();
+
+  EXPECT_EQ( 0, matcher->match( nullptr, desc, nullptr, empty )->size() );
+  EXPECT_EQ( 0, matcher->match( nullptr, empty, nullptr, desc )->size() );
+}
+
+// ----------------------------------------------------------------------------
+TEST(match_features_hamming, invalid_descriptors)
+{
+  std::mt19937 rng( 1 );
+  auto matcher = make_matcher( 0.8, true );
+  auto const desc32 = std::make_shared< simple_descriptor_set >(
+    random_descriptors( 10, 32, rng ) );
+  auto const desc64 = std::make_shared< simple_descriptor_set >(
+    random_descriptors( 10, 64, rng ) );
+  auto const real = std::make_shared< simple_descriptor_set >(
+    std::vector< descriptor_sptr >(
+      1, std::make_shared< descriptor_fixed< double, 4 > >() ) );
+
+  EXPECT_THROW( matcher->match( nullptr, desc32, nullptr, desc64 ),
+                invalid_value );
+  EXPECT_THROW( matcher->match( nullptr, desc32, nullptr, real ),
+                invalid_value );
+}
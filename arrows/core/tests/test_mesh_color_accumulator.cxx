@@ -0,0 +1,379 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Tests for the streaming mesh color accumulator
+ */
+
+#include <test_scene.h>
+
+#include <arrows/core/colorize.h>
+#include <arrows/core/mesh_color_accumulator.h>
+
+#include <vital/exceptions/base.h>
+#include <vital/types/camera_perspective.h>
+#include <vital/types/image_container.h>
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+using namespace kwiver::vital;
+using kwiver::arrows::core::mesh_color_accumulator;
+using kwiver::testing::grid_mesh;
+
+// ----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// A 4x4 plane at z = 0 made of 8x8 cells, with a 1x1 plane at z = 1 above
+// its center; the first 81 vertices are those of the lower plane
+mesh_sptr
+occluded_plane()
+{
+  auto const plane = grid_mesh( 8, 8, 0.5, { -2.0, -2.0, 0.0 } );
+  auto const occluder = grid_mesh( 2, 2, 0.5, { -0.5, -0.5, 1.0 } );
+  plane->merge( *occluder );
+  return plane;
+}
+
+// ----------------------------------------------------------------------------
+// A camera centered above (or below) the origin looking at it
+camera_perspective_sptr
+camera_at( double z,
+           simple_camera_intrinsics const& K =
+             simple_camera_intrinsics( 1000, { 320, 240 }, 1.0, 0.0, {},
+                                       640, 480 ) )
+{
+  auto const cam =
+    std::make_shared< simple_camera_perspective >( vector_3d( 0, 0, z ),
+                                                   rotation_d(), K.clone() );
+  cam->look_at( { 0, 0, 0 }, { 0, 1, 0 } );
+  return cam;
+}
+
+// ----------------------------------------------------------------------------
+image_container_sptr
+solid_image( rgb_color const& c, size_t width = 640, size_t height = 480 )
+{
+  image_of< uint8_t > img( width, height, 3 );
+  for( size_t j = 0; j < height; ++j )
+  {
+    for( size_t i = 0; i < width; ++i )
+    {
+      img( i, j, 0 ) = c.r;
+      img( i, j, 1 ) = c.g;
+      img( i, j, 2 ) = c.b;
+    }
+  }
+  return std::make_shared< simple_image_container >( img );
+}
+
+// ----------------------------------------------------------------------------
+// A video of in-memory images with frame numbers starting at 1
+class memory_video
+  : public algo::video_input
+{
+public:
+  explicit memory_video( std::vector< image_container_sptr > const& frames )
+    : frames_( frames )
+  {
+  }
+
+  config_block_sptr get_configuration() const override
+  { return algo::video_input::get_configuration(); }
+  void set_configuration( config_block_sptr ) override {}
+  bool check_configuration( config_block_sptr ) const override
+  { return true; }
+
+  void open( std::string ) override { current_ = 0; }
+  void close() override {}
+  bool end_of_video() const override { return current_ > frames_.size(); }
+  bool good() const override
+  { return current_ > 0 && current_ <= frames_.size(); }
+  bool seekable() const override { return true; }
+  size_t num_frames() const override { return frames_.size(); }
+
+  bool next_frame( timestamp& ts, uint32_t = 0 ) override
+  {
+    return seek_frame( ts, static_cast< timestamp::frame_t >( current_ + 1 ) );
+  }
+
+  bool seek_frame( timestamp& ts, timestamp::frame_t frame,
+                   uint32_t = 0 ) override
+  {
+    current_ = static_cast< size_t >( frame );
+    ts = frame_timestamp();
+    return good();
+  }
+
+  timestamp frame_timestamp() const override
+  {
+    timestamp ts;
+    ts.set_frame( static_cast< timestamp::frame_t >( current_ ) );
+    return ts;
+  }
+
+  image_container_sptr frame_image() override
+  { return good() ? frames_[ current_ - 1 ] : nullptr; }
+  metadata_vector frame_metadata() override { return {}; }
+  metadata_map_sptr metadata_map() override { return nullptr; }
+
+private:
+  std::vector< image_container_sptr > frames_;
+  size_t current_ = 0;
+};
+
+} // end namespace
+
+// ----------------------------------------------------------------------------
+// Only vertices not hidden by the occluder are colored
+TEST(mesh_color_accumulator, occlusion)
+{
+  auto const mesh = occluded_plane();
+  mesh_color_accumulator accumulator( mesh );
+  accumulator.set_occlusion_threshold( 0.01 );
+
+  rgb_color const color( 200, 100, 50 );
+  auto const num_colored =
+    accumulator.add_frame( *solid_image( color ), camera_at( 10.0 ) );
+  EXPECT_EQ( 1, accumulator.num_frames() );
+
+  auto const counts = accumulator.counts();
+  auto const means = accumulator.mean_colors();
+  auto const& verts = mesh->vertices< 3 >();
+  ASSERT_EQ( mesh->num_verts(), counts.size() );
+  unsigned num_hidden = 0;
+  for( unsigned v = 0; v < mesh->num_verts(); ++v )
+  {
+    bool const hidden = v < 81 && std::abs( verts[ v ].x() ) < 0.6 &&
+                                  std::abs( verts[ v ].y() ) < 0.6;
+    num_hidden += hidden;
+    EXPECT_EQ( hidden ? 0 : 1, counts[ v ] ) << "vertex " << verts[ v ];
+    EXPECT_EQ( hidden ? rgb_color( 0, 0, 0 ) : color, means[ v ] );
+  }
+  EXPECT_EQ( 9, num_hidden );
+  EXPECT_EQ( mesh->num_verts() - num_hidden, num_colored );
+}
+
+// ----------------------------------------------------------------------------
+// Vertices with normals away from the camera are skipped unless disabled
+TEST(mesh_color_accumulator, back_faces)
+{
+  auto const mesh = grid_mesh( 4, 4, 0.5, { -1.0, -1.0, 0.0 } );
+  auto& verts = mesh->vertices< 3 >();
+  verts.set_normals(
+    std::vector< vector_3d >( verts.size(), vector_3d( 0, 0, 1 ) ) );
+  auto const image = solid_image( { 1, 2, 3 } );
+
+  mesh_color_accumulator accumulator( mesh );
+  accumulator.set_occlusion_threshold( 0.01 );
+  EXPECT_EQ( verts.size(), accumulator.add_frame( *image, camera_at( 5.0 ) ) );
+  EXPECT_EQ( 0, accumulator.add_frame( *image, camera_at( -5.0 ) ) );
+
+  accumulator.set_remove_back_faces( false );
+  EXPECT_EQ( verts.size(), accumulator.add_frame( *image, camera_at( -5.0 ) ) );
+  for( auto const c : accumulator.counts() )
+  {
+    EXPECT_EQ( 2, c );
+  }
+}
+
+// ----------------------------------------------------------------------------
+// The median is robust to an outlier frame and exact for a single color
+TEST(mesh_color_accumulator, mean_and_median)
+{
+  auto const mesh = grid_mesh( 2, 2, 0.5, { -0.5, -0.5, 0.0 } );
+  auto const camera = camera_at( 5.0 );
+  mesh_color_accumulator accumulator( mesh );
+  accumulator.set_occlusion_threshold( 0.01 );
+
+  for( uint8_t value : { 10, 20, 30, 200, 40 } )
+  {
+    accumulator.add_frame( *solid_image( { value, 77, 77 } ), camera );
+  }
+  for( auto const& c : accumulator.mean_colors() )
+  {
+    EXPECT_EQ( 60, c.r );
+    EXPECT_EQ( 77, c.g );
+  }
+  for( auto const& c : accumulator.median_colors() )
+  {
+    EXPECT_NEAR( 30, c.r, 4 );
+    EXPECT_EQ( 77, c.g );
+    EXPECT_EQ( 77, c.b );
+  }
+
+  accumulator.reset();
+  EXPECT_EQ( 0, accumulator.num_frames() );
+  for( auto const c : accumulator.counts() )
+  {
+    EXPECT_EQ( 0, c );
+  }
+}
+
+// ----------------------------------------------------------------------------
+// The median stays close after many frames saturate the histogram
+TEST(mesh_color_accumulator, many_frames)
+{
+  auto const mesh = grid_mesh( 1, 1, 0.5, { -0.25, -0.25, 0.0 } );
+  auto const camera = camera_at(
+    5.0, simple_camera_intrinsics( 100, { 32, 24 }, 1.0, 0.0, {}, 64, 48 ) );
+  image_of< double > depth( 64, 48, 1 );
+  for( size_t j = 0; j < depth.height(); ++j )
+  {
+    for( size_t i = 0; i < depth.width(); ++i )
+    {
+      depth( i, j ) = 5.0;
+    }
+  }
+
+  mesh_color_accumulator accumulator( mesh );
+  accumulator.set_occlusion_threshold( 0.01 );
+  auto const dark = solid_image( { 40, 40, 40 }, 64, 48 );
+  auto const light = solid_image( { 90, 90, 90 }, 64, 48 );
+  for( unsigned f = 0; f < 100000; ++f )
+  {
+    accumulator.add_frame( f % 3 ? *light : *dark, *camera, depth );
+  }
+  for( auto const& c : accumulator.median_colors() )
+  {
+    EXPECT_NEAR( 90, c.r, 8 );
+  }
+  for( auto const& c : accumulator.mean_colors() )
+  {
+    EXPECT_NEAR( 73, c.r, 1 );
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Frames are read from a video, sampled and masked
+TEST(mesh_color_accumulator, add_video)
+{
+  auto const mesh = grid_mesh( 2, 2, 0.5, { -0.5, -0.5, 0.0 } );
+  std::vector< image_container_sptr > frames;
+  std::vector< image_container_sptr > masks;
+  for( uint8_t f = 1; f <= 8; ++f )
+  {
+    frames.push_back( solid_image( { f, f, f } ) );
+    masks.push_back( solid_image( f == 5 ? rgb_color( 0, 0, 0 )
+                                         : rgb_color() ) );
+  }
+
+  // frames 2 and 6 have no camera
+  camera_map::map_camera_t cam_map;
+  for( frame_id_t f : { 1, 3, 4, 5, 7, 8 } )
+  {
+    cam_map[ f ] = camera_at( 5.0 );
+  }
+  simple_camera_map const cameras( cam_map );
+
+  memory_video video( frames );
+  video.open( "" );
+  mesh_color_accumulator accumulator( mesh );
+  accumulator.set_occlusion_threshold( 0.01 );
+  EXPECT_EQ( 6, accumulator.add_video( video, cameras ) );
+  for( auto const& c : accumulator.mean_colors() )
+  {
+    EXPECT_EQ( 5, c.r ); // ( 1 + 3 + 4 + 5 + 7 + 8 ) / 6 rounded
+  }
+
+  // every other frame with a camera: 1, 4 and 7
+  accumulator.reset();
+  video.open( "" );
+  EXPECT_EQ( 3, accumulator.add_video( video, cameras, 2 ) );
+  for( auto const& c : accumulator.mean_colors() )
+  {
+    EXPECT_EQ( 4, c.r );
+  }
+
+  accumulator.reset();
+  video.open( "" );
+  memory_video mask_video( masks );
+  mask_video.open( "" );
+  EXPECT_EQ( 6, accumulator.add_video( video, cameras, 1, &mask_video ) );
+  for( auto const c : accumulator.counts() )
+  {
+    EXPECT_EQ( 5, c );
+  }
+  for( auto const& c : accumulator.mean_colors() )
+  {
+    EXPECT_EQ( 5, c.r ); // ( 1 + 3 + 4 + 7 + 8 ) / 5 rounded
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Mesh vertex colors are computed from a video with and without occlusion
+TEST(mesh_color_accumulator, compute_mesh_vertex_colors)
+{
+  using kwiver::arrows::core::compute_mesh_vertex_colors;
+
+  auto const mesh = occluded_plane();
+  std::vector< image_container_sptr > frames;
+  camera_map::map_camera_t cam_map;
+  for( uint8_t f = 1; f <= 4; ++f )
+  {
+    frames.push_back( solid_image( { uint8_t( 10 * f ), 0, 0 } ) );
+    cam_map[ f ] = camera_at( 10.0 );
+  }
+  simple_camera_map const cameras( cam_map );
+  memory_video video( frames );
+
+  std::vector< rgb_color > means;
+  std::vector< rgb_color > medians;
+  std::vector< unsigned > counts;
+  video.open( "" );
+  EXPECT_EQ( 4, compute_mesh_vertex_colors( mesh, video, cameras,
+                                            means, medians, counts,
+                                            1, nullptr, 0.01 ) );
+  ASSERT_EQ( mesh->num_verts(), counts.size() );
+  ASSERT_EQ( mesh->num_verts(), means.size() );
+  ASSERT_EQ( mesh->num_verts(), medians.size() );
+
+  auto const& verts = mesh->vertices< 3 >();
+  for( unsigned v = 0; v < mesh->num_verts(); ++v )
+  {
+    bool const hidden = v < 81 && std::abs( verts[ v ].x() ) < 0.6 &&
+                                  std::abs( verts[ v ].y() ) < 0.6;
+    EXPECT_EQ( hidden ? 0 : 4, counts[ v ] ) << "vertex " << verts[ v ];
+    EXPECT_EQ( hidden ? 0 : 25, means[ v ].r );
+    EXPECT_EQ( 0, medians[ v ].g );
+  }
+
+  // every other frame, keeping occluded vertices
+  video.open( "" );
+  EXPECT_EQ( 2, compute_mesh_vertex_colors(
+                  mesh, video, cameras, means, medians, counts, 2, nullptr,
+                  std::numeric_limits< double >::infinity() ) );
+  for( unsigned v = 0; v < mesh->num_verts(); ++v )
+  {
+    EXPECT_EQ( 2, counts[ v ] ) << "vertex " << verts[ v ];
+    EXPECT_EQ( 20, means[ v ].r ); // ( 10 + 30 ) / 2
+  }
+}
+
+// ----------------------------------------------------------------------------
+TEST(mesh_color_accumulator, invalid_input)
+{
+  EXPECT_THROW( mesh_color_accumulator( nullptr ), invalid_value );
+
+  auto const mesh = grid_mesh( 2, 2 );
+  mesh_color_accumulator accumulator( mesh );
+  auto const camera = camera_at( 5.0 );
+  EXPECT_THROW( accumulator.add_frame( *solid_image( {} ), nullptr ),
+                invalid_value );
+  EXPECT_THROW( accumulator.add_frame( *solid_image( {} ), *camera,
+                                       image_of< double >( 10, 10, 1 ) ),
+                invalid_value );
+  EXPECT_THROW( accumulator.add_frame( *solid_image( {} ), camera,
+                                       solid_image( {}, 10, 10 ) ),
+                invalid_value );
+}
@@ -13,7 +13,10 @@
 #include <vital/types/image_container.h>
 #include <vital/types/mesh.h>
 #include <vital/types/vector.h>
+#include <vital/util/transform_image.h>
+
 #include <memory>
+#include <random>
 
 using namespace kwiver::vital;
 
@@ -242,3 +245,77 @@ TEST(render_mesh_height_map, camera_rpc)
 
   EXPECT_NEAR( real_height_bary, measured_height_bary, 1e-2 );
 }
+
+// ----------------------------------------------------------------------------
+// Rendering agrees exactly with rendering each triangle in turn
+TEST(render_mesh_depth_map, matches_serial_rendering)
+{
+  // triangles of many sizes around the view, some behind the camera, some
+  // outside the image and some spanning several tiles
+  std::mt19937 rng(17);
+  std::uniform_real_distribution<double> center_dist(-8.0, 8.0);
+  std::uniform_real_distribution<double> height_dist(-3.0, 12.0);
+  std::uniform_real_distribution<double> offset_dist(-1.0, 1.0);
+  std::vector<vector_3d> verts;
+  std::unique_ptr<mesh_regular_face_array<3>> faces(new mesh_regular_face_array<3>());
+  for (unsigned t = 0; t < 3000; ++t)
+  {
+    double const scale = (t % 100 == 0) ? 6.0 : 0.3;
+    vector_3d const center(center_dist(rng), center_dist(rng), height_dist(rng));
+    for (unsigned v = 0; v < 3; ++v)
+    {
+      verts.push_back(center + scale * vector_3d(offset_dist(rng),
+                                                 offset_dist(rng),
+                                                 offset_dist(rng)));
+    }
+    faces->push_back(std::vector<unsigned int>({3 * t, 3 * t + 1, 3 * t + 2}));
+  }
+  std::unique_ptr<mesh_vertex_array_base> mesh_verts(new mesh_vertex_array<3>(verts));
+  mesh_sptr mesh(new kwiver::vital::mesh(std::move(mesh_verts), std::move(faces)));
+
+  // an image size which is not a multiple of the tile size
+  camera_intrinsics_sptr camera_intrinsic(new simple_camera_intrinsics(300, {150, 100},
+                                                                       1.0, 0.0, {},
+                                                                       300, 200));
+  matrix_3x3d rot = matrix_3x3d::Zero();
+  rot(0, 0) = 1.0;
+  rot(1, 1) = -1.0;
+  rot(2, 2) = -1.0;
+  camera_perspective_sptr camera(new simple_camera_perspective(vector_3d(0.0, 0.0, 10.0),
+                                                               rotation_d(rot).inverse(),
+                                                               camera_intrinsic));
+
+  image_of<double> reference(300, 200, 1);
+  transform_image(reference, [](double){ return std::numeric_limits<double>::infinity(); } );
+  for (unsigned t = 0; t < 3000; ++t)
+  {
+    double const d1 = camera->depth(verts[3 * t]);
+    double const d2 = camera->depth(verts[3 * t + 1]);
+    double const d3 = camera->depth(verts[3 * t + 2]);
+    if (d1 <= 0.0 || d2 <= 0.0 || d3 <= 0.0)
+    {
+      continue;
+    }
+    kwiver::arrows::core::render_triangle(camera->project(verts[3 * t]),
+                                          camera->project(verts[3 * t + 1]),
+                                          camera->project(verts[3 * t + 2]),
+                                          -1.0 / d1, -1.0 / d2, -1.0 / d3,
+                                          reference);
+  }
+  transform_image(reference, [](double d){ return std::isinf(d) ? d : (-1.0 / d); } );
+
+  image_of<double> depth_map(
+    kwiver::arrows::core::render_mesh_depth_map(mesh, camera)->get_image());
+  ASSERT_EQ(reference.width(), depth_map.width());
+  ASSERT_EQ(reference.height(), depth_map.height());
+  size_t num_rendered = 0;
+  for (unsigned j = 0; j < reference.height(); ++j)
+  {
+    for (unsigned i = 0; i < reference.width(); ++i)
+    {
+      EXPECT_EQ(reference(i, j), depth_map(i, j)) << "at " << i << ", " << j;
+      num_rendered += std::isinf(reference(i, j)) ? 0 : 1;
+    }
+  }
+  EXPECT_GT(num_rendered, reference.width() * reference.height() / 2);
+}
@@ -108,4 +108,146 @@ TEST(frame_index_track_set_impl, merge_functions)
   test_set_2 = make_track_set_impl(test_set_2->tracks());
 
   test_track_set_merge(test_set_1, test_set_2);
-}
\ No newline at end of file
+}
+
+namespace {
+
+// ----------------------------------------------------------------------------
+track_set_sptr make_columnar_track_set_impl(
+  std::vector< track_sptr > const& tracks )
+{
+  auto tsi = std::unique_ptr<track_set_implementation>{
+    new kwiver::arrows::core::frame_columnar_track_set_impl{ tracks } };
+  return std::make_shared<track_set>( std::move( tsi ) );
+}
+
+}
+
+// ----------------------------------------------------------------------------
+TEST(frame_columnar_track_set_impl, accessor_functions)
+{
+  auto test_set = kwiver::vital::testing::make_simple_track_set(1);
+
+  test_set = make_columnar_track_set_impl( test_set->tracks() );
+
+  kwiver::vital::testing::test_track_set_accessors( test_set );
+}
+
+// ----------------------------------------------------------------------------
+TEST(frame_columnar_track_set_impl, modifier_functions)
+{
+  auto test_set = kwiver::vital::testing::make_simple_track_set(1);
+
+  test_set = make_columnar_track_set_impl( test_set->tracks() );
+
+  kwiver::vital::testing::test_track_set_modifiers( test_set );
+}
+
+// ----------------------------------------------------------------------------
+TEST(frame_columnar_track_set_impl, merge_functions)
+{
+  using namespace kwiver::vital::testing;
+
+  auto test_set_1 = kwiver::vital::testing::make_simple_track_set(1);
+  test_set_1 = make_columnar_track_set_impl(test_set_1->tracks());
+
+  auto test_set_2 = kwiver::vital::testing::make_simple_track_set(2);
+  test_set_2 = make_columnar_track_set_impl(test_set_2->tracks());
+
+  // Build the index first so the merge has to update it
+  EXPECT_FALSE(test_set_1->active_tracks(1).empty());
+
+  test_track_set_merge(test_set_1, test_set_2);
+
+  auto const simple_set = std::make_shared<track_set>(test_set_1->tracks());
+  for (frame_id_t f = 0; f <= 11; ++f)
+  {
+    SCOPED_TRACE("frame " + std::to_string(f));
+    EXPECT_TRACKS_EQ(simple_set->active_tracks(f),
+                     test_set_1->active_tracks(f));
+    EXPECT_TRACKS_EQ(simple_set->new_tracks(f),
+                     test_set_1->new_tracks(f));
+    EXPECT_TRACKS_EQ(simple_set->terminated_tracks(f),
+                     test_set_1->terminated_tracks(f));
+    EXPECT_EQ(simple_set->frame_states(f).size(),
+              test_set_1->frame_states(f).size());
+  }
+}
+
+// ----------------------------------------------------------------------------
+TEST(frame_columnar_track_set_impl, matches_simple)
+{
+  auto tracks = kwiver::testing::generate_tracks();
+
+  auto ctracks = make_columnar_track_set_impl( tracks->tracks() );
+
+  EXPECT_EQ( tracks->size(), ctracks->size() );
+  EXPECT_EQ( tracks->empty(), ctracks->empty() );
+  EXPECT_EQ( tracks->first_frame(), ctracks->first_frame() );
+  EXPECT_EQ( tracks->last_frame(), ctracks->last_frame() );
+
+  auto all_frames_s = tracks->all_frame_ids();
+  auto all_frames_c = ctracks->all_frame_ids();
+  EXPECT_TRUE( std::equal( all_frames_s.begin(), all_frames_s.end(),
+                           all_frames_c.begin() ) );
+
+  EXPECT_IDS_EQ( tracks->all_track_ids(), ctracks->all_track_ids() );
+  for ( frame_id_t f = tracks->first_frame(); f <= tracks->last_frame(); ++f )
+  {
+    SCOPED_TRACE( "frame " + std::to_string( f ) );
+    EXPECT_TRACKS_EQ( tracks->active_tracks( f ),
+                      ctracks->active_tracks( f ) );
+    EXPECT_TRACKS_EQ( tracks->inactive_tracks( f ),
+                      ctracks->inactive_tracks( f ) );
+    EXPECT_TRACKS_EQ( tracks->new_tracks( f ),
+                      ctracks->new_tracks( f ) );
+    EXPECT_TRACKS_EQ( tracks->terminated_tracks( f ),
+                      ctracks->terminated_tracks( f ) );
+    EXPECT_EQ( tracks->frame_states( f ).size(),
+               ctracks->frame_states( f ).size() );
+  }
+  EXPECT_EQ( tracks->percentage_tracked( 10, 50 ),
+             ctracks->percentage_tracked( 10, 50 ) );
+}
+
+// ----------------------------------------------------------------------------
+TEST(frame_columnar_track_set_impl, state_notifications)
+{
+  auto tracks = kwiver::testing::generate_tracks();
+  auto ctracks = make_columnar_track_set_impl( tracks->tracks() );
+
+  // Build the index, then modify a track and notify the set
+  auto const t = ctracks->active_tracks( 10 ).front();
+  EXPECT_EQ( tracks->active_tracks( 10 ).size(),
+             ctracks->active_tracks( 10 ).size() );
+
+  auto const last = t->last_frame();
+  auto ts = std::make_shared<track_state>( last + 5 );
+  ASSERT_TRUE( t->append( ts ) );
+  ctracks->notify_new_state( ts );
+
+  EXPECT_TRACKS_EQ( tracks->active_tracks( last + 5 ),
+                    ctracks->active_tracks( last + 5 ) );
+  EXPECT_TRACKS_EQ( tracks->terminated_tracks( last + 5 ),
+                    ctracks->terminated_tracks( last + 5 ) );
+  EXPECT_TRACKS_EQ( tracks->inactive_tracks( last + 2 ),
+                    ctracks->inactive_tracks( last + 2 ) );
+
+  // Removing the state again restores the original end of the track
+  ASSERT_TRUE( t->remove( ts ) );
+  ctracks->notify_removed_state( ts );
+
+  EXPECT_TRACKS_EQ( tracks->terminated_tracks( last ),
+                    ctracks->terminated_tracks( last ) );
+  EXPECT_EQ( tracks->frame_states( last + 5 ).size(),
+             ctracks->frame_states( last + 5 ).size() );
+
+  // Removing a track removes it from every frame
+  ASSERT_TRUE( tracks->remove( t ) );
+  ASSERT_TRUE( ctracks->remove( t ) );
+  for ( frame_id_t f = tracks->first_frame(); f <= tracks->last_frame(); ++f )
+  {
+    EXPECT_TRACKS_EQ( tracks->active_tracks( f ),
+                      ctracks->active_tracks( f ) );
+  }
+}
@@ -539,6 +539,680 @@ ::clone( vital::clone_type ct ) const
 #endif
 }
 
+namespace {
+
+typedef std::pair< frame_id_t, frame_id_t > frame_interval_t;
+typedef std::vector< frame_interval_t > frame_intervals_t;
+
+/// Return the interval in \p iv containing \p frame, or iv.end()
+frame_intervals_t::iterator
+find_interval( frame_intervals_t& iv, frame_id_t frame )
+{
+  auto it = std::upper_bound( iv.begin(), iv.end(), frame,
+    []( frame_id_t f, frame_interval_t const& i ){ return f < i.first; } );
+  if ( it == iv.begin() )
+  {
+    return iv.end();
+  }
+  --it;
+  return it->second >= frame ? it : iv.end();
+}
+
+/// Return true if \p frame lies in one of the intervals \p iv
+bool
+covers_frame( frame_intervals_t const& iv, frame_id_t frame )
+{
+  auto it = std::upper_bound( iv.begin(), iv.end(), frame,
+    []( frame_id_t f, frame_interval_t const& i ){ return f < i.first; } );
+  return it != iv.begin() && std::prev( it )->second >= frame;
+}
+
+/// Add \p frame to the intervals \p iv, merging neighbors as needed
+/**
+ * Return false if \p frame was already covered.
+ */
+bool
+add_frame( frame_intervals_t& iv, frame_id_t frame )
+{
+  auto next = std::upper_bound( iv.begin(), iv.end(), frame,
+    []( frame_id_t f, frame_interval_t const& i ){ return f < i.first; } );
+  auto prev = ( next == iv.begin() ) ? iv.end() : std::prev( next );
+
+  if ( prev != iv.end() && prev->second >= frame )
+  {
+    return false;
+  }
+
+  bool const join_prev = prev != iv.end() && prev->second + 1 == frame;
+  bool const join_next = next != iv.end() && next->first - 1 == frame;
+  if ( join_prev && join_next )
+  {
+    prev->second = next->second;
+    iv.erase( next );
+  }
+  else if ( join_prev )
+  {
+    prev->second = frame;
+  }
+  else if ( join_next )
+  {
+    next->first = frame;
+  }
+  else
+  {
+    iv.insert( next, frame_interval_t( frame, frame ) );
+  }
+  return true;
+}
+
+/// Remove \p frame from the intervals \p iv, splitting one if needed
+void
+remove_frame( frame_intervals_t& iv, frame_id_t frame )
+{
+  auto it = find_interval( iv, frame );
+  if ( it == iv.end() )
+  {
+    return;
+  }
+
+  if ( it->first == it->second )
+  {
+    iv.erase( it );
+  }
+  else if ( it->first == frame )
+  {
+    ++it->first;
+  }
+  else if ( it->second == frame )
+  {
+    --it->second;
+  }
+  else
+  {
+    frame_interval_t const tail( frame + 1, it->second );
+    it->second = frame - 1;
+    iv.insert( std::next( it ), tail );
+  }
+}
+
+} // end namespace
+
+// ----------------------------------------------------------------------------
+frame_columnar_track_set_impl
+::frame_columnar_track_set_impl()
+  : index_built_( false )
+{
+}
+
+/// Constructor from a vector of tracks
+frame_columnar_track_set_impl
+::frame_columnar_track_set_impl( const std::vector< track_sptr >& tracks )
+  : index_built_( false )
+{
+  for ( auto const& t : tracks )
+  {
+    if ( t )
+    {
+      all_tracks_.insert( std::make_pair( t->id(), t ) );
+    }
+  }
+}
+
+/// Build the frame columns and track intervals from all_tracks_
+void
+frame_columnar_track_set_impl
+::build_index() const
+{
+  columns_.clear();
+  intervals_.clear();
+  for ( auto const& t : all_tracks_ )
+  {
+    index_track( t.second );
+  }
+  index_built_ = true;
+}
+
+/// Build the index only if it has not been built yet
+void
+frame_columnar_track_set_impl
+::build_index_on_demand() const
+{
+  if ( !index_built_ )
+  {
+    build_index();
+  }
+}
+
+/// Add the states of one track to the index
+void
+frame_columnar_track_set_impl
+::index_track( track_sptr const& t ) const
+{
+  auto& iv = intervals_[ t->id() ];
+  for ( auto const& ts : *t )
+  {
+    if ( add_frame( iv, ts->frame() ) )
+    {
+      auto& column = columns_[ ts->frame() ];
+      column.states.push_back( ts );
+      column.tracks.push_back( t );
+    }
+  }
+}
+
+/// Add one state of track \p t to the index
+void
+frame_columnar_track_set_impl
+::index_state( track_sptr const& t, track_state_sptr const& ts ) const
+{
+  auto& column = columns_[ ts->frame() ];
+  if ( add_frame( intervals_[ t->id() ], ts->frame() ) )
+  {
+    column.states.push_back( ts );
+    column.tracks.push_back( t );
+    return;
+  }
+
+  // The track already has a state on this frame; replace it
+  for ( size_t i = 0; i < column.tracks.size(); ++i )
+  {
+    if ( column.tracks[ i ] == t )
+    {
+      column.states[ i ] = ts;
+      return;
+    }
+  }
+}
+
+/// Return the number of tracks in the set
+size_t
+frame_columnar_track_set_impl
+::size() const
+{
+  return this->all_tracks_.size();
+}
+
+/// Return whether or not there are any tracks in the set
+bool
+frame_columnar_track_set_impl
+::empty() const
+{
+  return this->all_tracks_.empty();
+}
+
+/// Return true if the set contains a specific track
+bool
+frame_columnar_track_set_impl
+::contains( vital::track_sptr t ) const
+{
+  if ( !t )
+  {
+    return false;
+  }
+  auto itr = all_tracks_.find( t->id() );
+  return itr != all_tracks_.end() && itr->second == t;
+}
+
+/// Assign a vector of track shared pointers to this container
+void
+frame_columnar_track_set_impl
+::set_tracks( std::vector< vital::track_sptr > const& tracks )
+{
+  all_tracks_.clear();
+
+  for ( auto const& t : tracks )
+  {
+    if ( t )
+    {
+      all_tracks_.insert( std::make_pair( t->id(), t ) );
+    }
+  }
+
+  columns_.clear();
+  intervals_.clear();
+  index_built_ = false;
+}
+
+/// Insert a track shared pointer into this container
+void
+frame_columnar_track_set_impl
+::insert( vital::track_sptr const& t )
+{
+  if ( !t )
+  {
+    return;
+  }
+
+  if ( all_tracks_.emplace( t->id(), t ).second && index_built_ )
+  {
+    index_track( t );
+  }
+}
+
+/// Insert a track shared pointer into this container
+void
+frame_columnar_track_set_impl
+::insert( vital::track_sptr&& t )
+{
+  if ( !t )
+  {
+    return;
+  }
+
+  auto const result = all_tracks_.emplace( t->id(), std::move( t ) );
+  if ( result.second && index_built_ )
+  {
+    index_track( result.first->second );
+  }
+}
+
+/// Notify the container that a new state has been added to an existing track
+void
+frame_columnar_track_set_impl
+::notify_new_state( vital::track_state_sptr ts )
+{
+  if ( !index_built_ )
+  {
+    return;
+  }
+
+  auto t = ts->track();
+  if ( !t || !contains( t ) )
+  {
+    return;
+  }
+  index_state( t, ts );
+}
+
+/// Notify the container that a state has been removed from an existing track
+void
+frame_columnar_track_set_impl
+::notify_removed_state( vital::track_state_sptr ts )
+{
+  if ( !index_built_ )
+  {
+    return;
+  }
+
+  auto const fn = ts->frame();
+  auto c_it = columns_.find( fn );
+  if ( c_it == columns_.end() )
+  {
+    return;
+  }
+
+  auto& column = c_it->second;
+  auto s_it = std::find( column.states.begin(), column.states.end(), ts );
+  if ( s_it == column.states.end() )
+  {
+    return;
+  }
+
+  // Swap the last entry into the hole to keep the column contiguous
+  auto const i = static_cast< size_t >( s_it - column.states.begin() );
+  auto const tid = column.tracks[ i ]->id();
+  column.states[ i ] = std::move( column.states.back() );
+  column.tracks[ i ] = std::move( column.tracks.back() );
+  column.states.pop_back();
+  column.tracks.pop_back();
+
+  if ( column.states.empty() )
+  {
+    // no track states for this frame so remove the frame's column
+    columns_.erase( c_it );
+  }
+
+  auto iv_it = intervals_.find( tid );
+  if ( iv_it != intervals_.end() )
+  {
+    remove_frame( iv_it->second, fn );
+  }
+}
+
+/// Remove a track from the set and return true if successful
+bool
+frame_columnar_track_set_impl
+::remove( vital::track_sptr t )
+{
+  if ( !t )
+  {
+    return false;
+  }
+  auto itr = all_tracks_.find( t->id() );
+  if ( itr == all_tracks_.end() || itr->second != t )
+  {
+    return false;
+  }
+  all_tracks_.erase( itr );
+
+  if ( !index_built_ )
+  {
+    return true;
+  }
+
+  // remove the track from the column of every frame it covers
+  auto iv_it = intervals_.find( t->id() );
+  if ( iv_it != intervals_.end() )
+  {
+    for ( auto const& interval : iv_it->second )
+    {
+      for ( auto c_it = columns_.lower_bound( interval.first );
+            c_it != columns_.end() && c_it->first <= interval.second; )
+      {
+        auto& column = c_it->second;
+        for ( size_t i = 0; i < column.tracks.size(); ++i )
+        {
+          if ( column.tracks[ i ] == t )
+          {
+            column.states[ i ] = std::move( column.states.back() );
+            column.tracks[ i ] = std::move( column.tracks.back() );
+            column.states.pop_back();
+            column.tracks.pop_back();
+            break;
+          }
+        }
+
+        if ( column.states.empty() )
+        {
+          c_it = columns_.erase( c_it );
+        }
+        else
+        {
+          ++c_it;
+        }
+      }
+    }
+    intervals_.erase( iv_it );
+  }
+
+  return true;
+}
+
+/// Return a vector of track shared pointers
+std::vector< track_sptr >
+frame_columnar_track_set_impl
+::tracks() const
+{
+  std::vector< track_sptr > tks( all_tracks_.size() );
+  size_t i = 0;
+  for ( auto const& t : all_tracks_ )
+  {
+    tks[ i++ ] = t.second;
+  }
+  return tks;
+}
+
+/// Return the set of all frame IDs covered by these tracks
+std::set< frame_id_t >
+frame_columnar_track_set_impl
+::all_frame_ids() const
+{
+  build_index_on_demand();
+
+  std::set< frame_id_t > ids;
+  for ( auto const& c : columns_ )
+  {
+    ids.insert( ids.end(), c.first );
+  }
+  return ids;
+}
+
+/// Return the set of all track IDs in this track set
+std::set< track_id_t >
+frame_columnar_track_set_impl
+::all_track_ids() const
+{
+  std::set< track_id_t > ids;
+  for ( auto const& t : all_tracks_ )
+  {
+    ids.insert( t.first );
+  }
+  return ids;
+}
+
+/// Return the first (smallest) frame number containing tracks
+frame_id_t
+frame_columnar_track_set_impl
+::first_frame() const
+{
+  build_index_on_demand();
+
+  if ( columns_.empty() )
+  {
+    return track_set_implementation::first_frame();
+  }
+  return columns_.begin()->first;
+}
+
+/// Return the last (largest) frame number containing tracks
+frame_id_t
+frame_columnar_track_set_impl
+::last_frame() const
+{
+  build_index_on_demand();
+
+  if ( columns_.empty() )
+  {
+    return track_set_implementation::last_frame();
+  }
+  return columns_.rbegin()->first;
+}
+
+/// Return the track in the set with the specified id.
+track_sptr const
+frame_columnar_track_set_impl
+::get_track( track_id_t tid ) const
+{
+  auto t_it = all_tracks_.find( tid );
+  if ( t_it != all_tracks_.end() )
+  {
+    return t_it->second;
+  }
+
+  return track_sptr();
+}
+
+/// Return all tracks active on a frame.
+std::vector< track_sptr >
+frame_columnar_track_set_impl
+::active_tracks( frame_id_t offset ) const
+{
+  build_index_on_demand();
+
+  auto const c_it = columns_.find( offset_to_frame( offset ) );
+  if ( c_it == columns_.end() )
+  {
+    return std::vector< track_sptr >();
+  }
+  return c_it->second.tracks;
+}
+
+/// Return all tracks not active on a frame.
+std::vector< track_sptr >
+frame_columnar_track_set_impl
+::inactive_tracks( frame_id_t offset ) const
+{
+  build_index_on_demand();
+
+  std::vector< track_sptr > inactive_tracks;
+  frame_id_t const frame_number = offset_to_frame( offset );
+  for ( auto const& t : all_tracks_ )
+  {
+    auto const iv_it = intervals_.find( t.first );
+    if ( iv_it == intervals_.end() ||
+         !covers_frame( iv_it->second, frame_number ) )
+    {
+      inactive_tracks.push_back( t.second );
+    }
+  }
+  return inactive_tracks;
+}
+
+/// Return all new tracks on a given frame.
+std::vector< track_sptr >
+frame_columnar_track_set_impl
+::new_tracks( frame_id_t offset ) const
+{
+  build_index_on_demand();
+
+  std::vector< track_sptr > new_tracks;
+  frame_id_t const frame_number = offset_to_frame( offset );
+  auto const c_it = columns_.find( frame_number );
+  if ( c_it != columns_.end() )
+  {
+    for ( auto const& t : c_it->second.tracks )
+    {
+      if ( intervals_[ t->id() ].front().first == frame_number )
+      {
+        new_tracks.push_back( t );
+      }
+    }
+  }
+  return new_tracks;
+}
+
+/// Return all terminated tracks on a given frame.
+std::vector< track_sptr >
+frame_columnar_track_set_impl
+::terminated_tracks( frame_id_t offset ) const
+{
+  build_index_on_demand();
+
+  std::vector< track_sptr > terminated_tracks;
+  frame_id_t const frame_number = offset_to_frame( offset );
+  auto const c_it = columns_.find( frame_number );
+  if ( c_it != columns_.end() )
+  {
+    for ( auto const& t : c_it->second.tracks )
+    {
+      if ( intervals_[ t->id() ].back().second == frame_number )
+      {
+        terminated_tracks.push_back( t );
+      }
+    }
+  }
+  return terminated_tracks;
+}
+
+/// Return the percentage of tracks successfully tracked to the next frame.
+double
+frame_columnar_track_set_impl
+::percentage_tracked( frame_id_t offset1, frame_id_t offset2 ) const
+{
+  std::vector< track_sptr > tracks1 = this->active_tracks( offset1 );
+  std::sort( tracks1.begin(), tracks1.end(), track_less );
+  std::vector< track_sptr > tracks2 = this->active_tracks( offset2 );
+  std::sort( tracks2.begin(), tracks2.end(), track_less );
+
+  std::vector< track_sptr > isect_tracks;
+  std::set_intersection( tracks1.begin(), tracks1.end(),
+                         tracks2.begin(), tracks2.end(),
+                         std::back_inserter( isect_tracks ), track_less );
+
+  size_t const union_size =
+    tracks1.size() + tracks2.size() - isect_tracks.size();
+  if ( union_size == 0 )
+  {
+    return 0.0;
+  }
+  return static_cast< double >( isect_tracks.size() ) / union_size;
+}
+
+/// Return a vector of state data corresponding to the tracks on the given frame.
+std::vector< track_state_sptr >
+frame_columnar_track_set_impl
+::frame_states( frame_id_t offset ) const
+{
+  build_index_on_demand();
+
+  auto const c_it = columns_.find( offset_to_frame( offset ) );
+  if ( c_it == columns_.end() )
+  {
+    return std::vector< track_state_sptr >();
+  }
+  return c_it->second.states;
+}
+
+/// Return the additional data associated with all tracks on the given frame
+track_set_frame_data_sptr
+frame_columnar_track_set_impl
+::frame_data( frame_id_t offset ) const
+{
+  frame_id_t frame_number = offset_to_frame( offset );
+  auto itr = frame_data_.find( frame_number );
+  if ( itr != frame_data_.end() )
+  {
+    return itr->second;
+  }
+  return nullptr;
+}
+
+/// Removes the frame data for the frame offset
+bool
+frame_columnar_track_set_impl
+::remove_frame_data( frame_id_t offset )
+{
+  frame_id_t frame_number = offset_to_frame( offset );
+  auto itr = frame_data_.find( frame_number );
+  if ( itr != frame_data_.end() )
+  {
+    frame_data_.erase( itr );
+    return true;
+  }
+  return false;
+}
+
+/// Set additional data associated with all tracks on the given frame
+bool
+frame_columnar_track_set_impl
+::set_frame_data( track_set_frame_data_sptr data,
+                  frame_id_t offset )
+{
+  frame_id_t frame_number = offset_to_frame( offset );
+  if ( !data )
+  {
+    // remove the data on the specified frame
+    auto itr = frame_data_.find( frame_number );
+    if ( itr == frame_data_.end() )
+    {
+      return false;
+    }
+    frame_data_.erase( itr );
+  }
+  else
+  {
+    frame_data_[ frame_number ] = data;
+  }
+  return true;
+}
+
+track_set_implementation_uptr
+frame_columnar_track_set_impl
+::clone( vital::clone_type ct ) const
+{
+  std::unique_ptr< frame_columnar_track_set_impl > the_clone =
+    std::unique_ptr< frame_columnar_track_set_impl >(
+      new frame_columnar_track_set_impl() );
+
+  // clone the track data; the index is rebuilt on first use
+  for ( auto const& trk : all_tracks_ )
+  {
+    the_clone->all_tracks_.emplace( trk.first, trk.second->clone( ct ) );
+  }
+
+  // clone the frame data
+  for ( auto const& fd : frame_data_ )
+  {
+    the_clone->frame_data_.emplace( fd.first, fd.second->clone() );
+  }
+
+#if __GNUC__ > 4 || __clang_major__ > 3
+  return the_clone;
+#else
+  return std::move( the_clone );
+#endif
+}
+
 } // end namespace core
 } // end namespace arrows
 } // end namespace kwiver
@@ -16,6 +16,8 @@
 
 #include <map>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace kwiver {
 namespace arrows {
@@ -156,6 +158,175 @@ class KWIVER_ALGO_CORE_EXPORT frame_index_track_set_impl
   mutable std::map<vital::frame_id_t, std::set<vital::track_state_sptr> > frame_map_;
 };
 
+/// A track set implementation storing track states in per-frame columns
+/**
+ * This track_set_implementation targets long feature tracking runs with
+ * many track states.  Rather than a set of states per frame, it keeps each
+ * frame's states and their tracks in two parallel contiguous arrays, and
+ * describes each track by the sorted runs of consecutive frames it covers.
+ * Per-frame queries are a single ordered map lookup followed by a linear
+ * pass over contiguous memory, and whether a track is active, new or
+ * terminated on a frame is answered from its frame intervals without
+ * touching its states.
+ *
+ * Like frame_index_track_set_impl, the index is built on first use and
+ * then kept up to date by insert(), remove() and the state notifications.
+ */
+class KWIVER_ALGO_CORE_EXPORT frame_columnar_track_set_impl
+  : public vital::track_set_implementation
+{
+public:
+  /// Default Constructor
+  frame_columnar_track_set_impl();
+
+  /// Constructor from a vector of tracks
+  explicit frame_columnar_track_set_impl(
+    const std::vector< vital::track_sptr >& tracks );
+
+  /// Destructor
+  virtual ~frame_columnar_track_set_impl() = default;
+
+  /// Return the number of tracks in the set
+  virtual size_t size() const;
+
+  /// Return whether or not there are any tracks in the set
+  virtual bool empty() const;
+
+  /// Return true if the set contains a specific track
+  virtual bool contains( vital::track_sptr t ) const;
+
+  /// Assign a vector of track shared pointers to this container
+  virtual void set_tracks( std::vector< vital::track_sptr > const& tracks );
+
+  /// Insert a track shared pointer into this container
+  //@{
+  virtual void insert( vital::track_sptr const& t );
+  virtual void insert( vital::track_sptr&& t );
+  //@}
+
+  /// Notify the container that a new state has been added to an existing track
+  virtual void notify_new_state( vital::track_state_sptr ts );
+
+  /// Notify the container that a state has been removed from an existing track
+  virtual void notify_removed_state( vital::track_state_sptr ts );
+
+  /// Remove a track from the set and return true if successful
+  virtual bool remove( vital::track_sptr t );
+
+  /// Return a vector of track shared pointers
+  virtual std::vector< vital::track_sptr > tracks() const;
+
+  /// Return the set of all frame IDs covered by these tracks
+  virtual std::set< vital::frame_id_t > all_frame_ids() const;
+
+  /// Return the set of all track IDs in this track set
+  virtual std::set< vital::track_id_t > all_track_ids() const;
+
+  /// Return the first (smallest) frame number containing tracks
+  virtual vital::frame_id_t first_frame() const;
+
+  /// Return the last (largest) frame number containing tracks
+  virtual vital::frame_id_t last_frame() const;
+
+  /// Return the track in this set with the specified id.
+  virtual vital::track_sptr const get_track( vital::track_id_t tid ) const;
+
+  /// Return all tracks active on a frame.
+  virtual std::vector< vital::track_sptr>
+  active_tracks( vital::frame_id_t offset = -1 ) const;
+
+  /// Return all tracks inactive on a frame.
+  virtual std::vector< vital::track_sptr >
+  inactive_tracks( vital::frame_id_t offset = -1 ) const;
+
+  /// Return all tracks newly initialized on the given frame.
+  virtual std::vector< vital::track_sptr >
+  new_tracks( vital::frame_id_t offset = -1 ) const;
+
+  /// Return all tracks terminated on the given frame.
+  virtual std::vector< vital::track_sptr >
+  terminated_tracks( vital::frame_id_t offset = -1 ) const;
+
+  /// Return the percentage of tracks successfully tracked between two frames.
+  virtual double percentage_tracked( vital::frame_id_t offset1 = -2,
+                                     vital::frame_id_t offset2 = -1 ) const;
+
+  /// Return a vector of state data corresponding to the tracks on the given frame.
+  virtual std::vector< vital::track_state_sptr >
+  frame_states( vital::frame_id_t offset = -1 ) const;
+
+  /// Returns all frame data as map of frame index to track_set_frame_data
+  virtual vital::track_set_frame_data_map_t all_frame_data() const
+  {
+    return frame_data_;
+  }
+
+  /// Return the additional data associated with all tracks on the given frame
+  virtual vital::track_set_frame_data_sptr
+  frame_data( vital::frame_id_t offset = -1 ) const;
+
+  /// Removes the frame data for the frame offset
+  virtual bool remove_frame_data( vital::frame_id_t offset );
+
+  /// Set additional frame data associated with all tracks for all frames
+  virtual bool set_frame_data( vital::track_set_frame_data_map_t const& fmap )
+  {
+    frame_data_ = fmap;
+    return true;
+  }
+
+  /// Set additional data associated with all tracks on the given frame
+  virtual bool set_frame_data( vital::track_set_frame_data_sptr data,
+                               vital::frame_id_t offset = -1 );
+
+  vital::track_set_implementation_uptr clone(
+    vital::clone_type = vital::clone_type::DEEP ) const override;
+
+protected:
+  /// An inclusive range of consecutive frames
+  typedef std::pair< vital::frame_id_t, vital::frame_id_t > frame_interval_t;
+
+  /// The sorted, disjoint frame intervals covered by a track
+  typedef std::vector< frame_interval_t > frame_intervals_t;
+
+  /// The states on one frame and the tracks they belong to
+  struct frame_column
+  {
+    std::vector< vital::track_state_sptr > states;
+    std::vector< vital::track_sptr > tracks;
+  };
+
+  /// Build the frame columns and track intervals from all_tracks_
+  void build_index() const;
+
+  /// Build the index only if it has not been built yet
+  void build_index_on_demand() const;
+
+  /// Add the states of one track to the index
+  void index_track( vital::track_sptr const& t ) const;
+
+  /// Add one state of track \p t to the index
+  void index_state( vital::track_sptr const& t,
+                    vital::track_state_sptr const& ts ) const;
+
+  /// The frame data map
+  vital::track_set_frame_data_map_t frame_data_;
+
+private:
+  /// The map of all tracks by id
+  std::unordered_map< vital::track_id_t, vital::track_sptr > all_tracks_;
+
+  /// Whether columns_ and intervals_ reflect all_tracks_
+  mutable bool index_built_;
+
+  /// The track states on each frame
+  mutable std::map< vital::frame_id_t, frame_column > columns_;
+
+  /// The frames covered by each track
+  mutable std::unordered_map< vital::track_id_t,
+                              frame_intervals_t > intervals_;
+};
+
 } // end namespace core
 } // end namespace arrows
 } // end namespace kwiver
@@ -0,0 +1,166 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Implementation of write_object_track_set_binary
+ */
+
+#include "write_object_track_set_binary.h"
+
+#include <arrows/core/binary_object_store.h>
+
+#include <vital/exceptions/io.h>
+#include <vital/types/object_track_set.h>
+#include <vital/vital_config.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+// -------------------------------------------------------------------------------
+class write_object_track_set_binary::priv
+{
+public:
+  priv()
+    : m_logger( kwiver::vital::get_logger( "write_object_track_set_binary" ) )
+  { }
+
+  ~priv() { }
+
+  void write( std::ostream& os );
+
+  kwiver::vital::logger_handle_t m_logger;
+  std::map< vital::track_id_t, vital::track_sptr > m_tracks;
+  std::unique_ptr< std::ofstream > m_file;
+};
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_binary::priv
+::write( std::ostream& os )
+{
+  // the store is frame major, so gather the states of every track and
+  // order them by frame
+  using state_ref =
+    std::tuple< vital::frame_id_t, vital::track_id_t,
+                vital::object_track_state const* >;
+  std::vector< state_ref > states;
+
+  for( auto const& trk_pair : m_tracks )
+  {
+    auto const& trk_ptr = trk_pair.second;
+    for( auto const& ts_ptr : *trk_ptr )
+    {
+      auto const* ts =
+        dynamic_cast< vital::object_track_state const* >( ts_ptr.get() );
+      if( !ts || !ts->detection() )
+      {
+        LOG_WARN( m_logger, "Skipping state of track " << trk_ptr->id()
+                            << " on frame " << ts_ptr->frame()
+                            << " which has no detection" );
+        continue;
+      }
+      states.emplace_back( ts->frame(), trk_ptr->id(), ts );
+    }
+  }
+  std::sort( states.begin(), states.end() );
+
+  binary_object_store_writer writer( binary_object_store_kind::object_tracks );
+  vital::frame_id_t last_frame = 0;
+  for( auto const& s : states )
+  {
+    auto const frame = std::get< 0 >( s );
+    auto const* ts = std::get< 2 >( s );
+    if( writer.num_frames() == 0 || frame != last_frame )
+    {
+      writer.add_frame( frame, ts->time() );
+      last_frame = frame;
+    }
+    writer.add_record( std::get< 1 >( s ), *ts->detection() );
+  }
+
+  writer.write( os );
+  m_tracks.clear();
+}
+
+// ===============================================================================
+write_object_track_set_binary
+::write_object_track_set_binary()
+  : d( new write_object_track_set_binary::priv )
+{
+}
+
+write_object_track_set_binary
+::~write_object_track_set_binary()
+{
+}
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_binary
+::open( std::string const& filename )
+{
+  // the base class opens files in text mode
+  std::unique_ptr< std::ofstream > file(
+    new std::ofstream( filename, std::ios::out | std::ios::binary ) );
+  if( !*file )
+  {
+    VITAL_THROW( vital::file_not_found_exception, filename, "open failed" );
+  }
+
+  use_stream( file.get() );
+  d->m_file = std::move( file );
+}
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_binary
+::close()
+{
+  // an unopened or unused writer has nothing to flush
+  if( !d->m_tracks.empty() )
+  {
+    d->write( stream() );
+  }
+  write_object_track_set::close();
+  d->m_file.reset();
+}
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_binary
+::set_configuration( VITAL_UNUSED vital::config_block_sptr config )
+{
+}
+
+// -------------------------------------------------------------------------------
+bool
+write_object_track_set_binary
+::check_configuration( VITAL_UNUSED vital::config_block_sptr config ) const
+{
+  return true;
+}
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_binary
+::write_set(
+  kwiver::vital::object_track_set_sptr const& set,
+  VITAL_UNUSED kwiver::vital::timestamp const& ts,
+  VITAL_UNUSED std::string const& frame_identifier )
+{
+  for( auto const& trk : set->tracks() )
+  {
+    d->m_tracks[ trk->id() ] = trk;
+  }
+}
+
+} } } // end namespace
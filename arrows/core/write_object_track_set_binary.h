@@ -0,0 +1,62 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Interface for write_object_track_set_binary
+ */
+
+#ifndef KWIVER_ARROWS_WRITE_OBJECT_TRACK_SET_BINARY_H
+#define KWIVER_ARROWS_WRITE_OBJECT_TRACK_SET_BINARY_H
+
+#include <vital/vital_config.h>
+#include <arrows/core/kwiver_algo_core_export.h>
+
+#include <vital/algo/write_object_track_set.h>
+
+#include <memory>
+
+namespace kwiver {
+namespace arrows {
+namespace core {
+
+/// Object track set writer for the binary object store format
+/**
+ * Tracks are collected as they are written and the file is produced
+ * when the writer is closed.  The store is laid out by field rather
+ * than by frame, and a track may gain states on any later frame, so
+ * nothing can be written earlier.  Until close() the writer holds a
+ * reference to every track written, and while writing it holds about
+ * 80 bytes per state plus 12 bytes per class score.
+ */
+class KWIVER_ALGO_CORE_EXPORT write_object_track_set_binary
+  : public vital::algo::write_object_track_set
+{
+public:
+  PLUGIN_INFO( "binary",
+               "Object track set writer for the memory mapped binary "
+               "object store format." )
+
+  write_object_track_set_binary();
+  virtual ~write_object_track_set_binary();
+
+  virtual void open( std::string const& filename );
+
+  virtual void set_configuration( vital::config_block_sptr config );
+  virtual bool check_configuration( vital::config_block_sptr config ) const;
+
+  virtual void close();
+
+  virtual void write_set( kwiver::vital::object_track_set_sptr const& set,
+                          kwiver::vital::timestamp const& ts = {},
+                          std::string const& frame_identifier = {} );
+
+private:
+  class priv;
+  std::unique_ptr< priv > d;
+};
+
+} } } // end namespace
+
+#endif // KWIVER_ARROWS_WRITE_OBJECT_TRACK_SET_BINARY_H
@@ -12,12 +12,13 @@
 
 #include <arrows/klv/convert_metadata.h>
 #include <arrows/klv/misp_time.h>
-#include <arrows/klv/klv_data.h>
+#include <arrows/klv/klv_parse.h>
 
 #include <vital/exceptions/io.h>
 #include <vital/exceptions/video.h>
 
 #include <vital/types/image_container.h>
+#include <vital/types/image_memory_pool.h>
 #include <vital/types/timestamp.h>
 
 #include <vital/util/tokenize.h>
@@ -37,10 +38,14 @@ extern "C" {
 #include <libswscale/swscale.h>
 }
 
+#include <algorithm>
+#include <condition_variable>
 #include <deque>
+#include <fstream>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 namespace kwiver {
@@ -93,10 +98,10 @@ class ffmpeg_video_input::priv
 
   // The buffers of raw metadata from the data streams tagged with the
   // timestamp
-  std::map< int, std::multimap< int64_t, std::deque< uint8_t > > > metadata;
+  std::map< int, std::multimap< int64_t, std::vector< uint8_t > > > metadata;
 
   // Storage for current frame's raw metadata
-  std::map< int, std::deque< uint8_t > > curr_metadata;
+  std::map< int, std::vector< uint8_t > > curr_metadata;
 
   // metadata converter object
   kwiver::arrows::klv::convert_metadata converter;
@@ -124,6 +129,56 @@ class ffmpeg_video_input::priv
   bool sync_metadata = true;
   size_t max_seek_back_attempts = 10;
 
+  // Whether to index the keyframes of the video for seeking and counting
+  bool use_keyframe_index = true;
+
+  // Whether to keep the keyframe index in a file next to the video
+  bool cache_keyframe_index = false;
+
+  // Set once the keyframe index has been built or loaded
+  bool keyframe_index_built = false;
+
+  // Sorted presentation timestamps of the video's keyframes
+  // (in stream time base)
+  std::vector< int64_t > keyframe_pts;
+
+  // Number of timestamped video packets, and so of frames, in the video
+  size_t packet_count = 0;
+
+  // Number of threads the decoder may use; 0 lets libav choose
+  int decoder_threads = 1;
+
+  // Set once the decoder has been sent the end of stream
+  bool draining = false;
+
+  // A frame decoded ahead of the caller by the read-ahead thread
+  struct prefetched_frame
+  {
+    kwiver::vital::timestamp ts;
+    kwiver::vital::image_container_sptr image;
+    kwiver::vital::metadata_vector metadata;
+  };
+  using prefetched_frame_sptr = std::shared_ptr< prefetched_frame >;
+
+  // Number of frames to decode ahead of the caller; 0 disables read-ahead
+  size_t read_ahead = 0;
+
+  // While the read-ahead thread runs it owns all of the decoder state
+  // above; the caller only sees the frames it has queued.
+  std::thread read_ahead_thread;
+  std::mutex read_ahead_mutex;
+  std::condition_variable read_ahead_have_frame;
+  std::condition_variable read_ahead_have_space;
+  // A null entry marks the end of the video
+  std::deque< prefetched_frame_sptr > read_ahead_queue;
+  bool read_ahead_stop = false;
+  // Set when the decoder has moved past the caller's current frame
+  bool read_ahead_decoder_moved = false;
+  // Set when the caller has reached the end of the video
+  bool read_ahead_end = false;
+  // The caller's current frame, when it came from the read-ahead thread
+  prefetched_frame_sptr current_prefetched;
+
   // ==================================================================
 
   /*
@@ -180,8 +235,8 @@ class ffmpeg_video_input::priv
       else if( params->codec_type == AVMEDIA_TYPE_DATA )
       {
         this->metadata.emplace(
-            i, std::multimap< int64_t, std::deque< uint8_t > >() );
-        this->curr_metadata.emplace( i, std::deque< uint8_t >() );
+            i, std::multimap< int64_t, std::vector< uint8_t > >() );
+        this->curr_metadata.emplace( i, std::vector< uint8_t >() );
       }
     }
 
@@ -204,8 +259,8 @@ class ffmpeg_video_input::priv
         if( params->codec_type == AVMEDIA_TYPE_UNKNOWN )
         {
           this->metadata.emplace(
-              i, std::multimap< int64_t, std::deque< uint8_t > >() );
-          this->curr_metadata.emplace( i, std::deque< uint8_t >() );
+              i, std::multimap< int64_t, std::vector< uint8_t > >() );
+          this->curr_metadata.emplace( i, std::vector< uint8_t >() );
           LOG_INFO( this->logger,
                     "Using AVMEDIA_TYPE_UNKNOWN stream as a data stream" );
         }
@@ -236,6 +291,13 @@ class ffmpeg_video_input::priv
       return false;
     }
 
+    // Let the decoder work on several frames or slices at once
+    this->f_video_encoding->thread_count = this->decoder_threads;
+    if( this->decoder_threads != 1 )
+    {
+      this->f_video_encoding->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    }
+
     // Open codec
     if( avcodec_open2( this->f_video_encoding, codec, NULL ) < 0 )
     {
@@ -281,6 +343,7 @@ class ffmpeg_video_input::priv
 
     this->f_start_time = this->f_video_stream->start_time;
     this->frame_advanced = false;
+    this->draining = false;
     this->f_frame->data[ 0 ] = NULL;
     return true;
   }
@@ -421,6 +484,21 @@ class ffmpeg_video_input::priv
 
   // ==================================================================
 
+  /*
+   * @brief Take the presentation timestamp from the decoded frame.
+   */
+  void
+  set_frame_pts()
+  {
+    this->f_pts = av_frame_get_best_effort_timestamp( this->f_frame );
+    if( this->f_pts == AV_NOPTS_VALUE )
+    {
+      this->f_pts = 0;
+    }
+  }
+
+  // ==================================================================
+
   /*
    * @brief Advance to the next frame (but don't acquire an image).
    *
@@ -444,9 +522,30 @@ class ffmpeg_video_input::priv
       md.second.clear();
     }
 
-    while( !this->frame_advanced &&
-           av_read_frame( this->f_format_context, this->f_packet ) >= 0 )
+    while( !this->frame_advanced )
     {
+      if( av_read_frame( this->f_format_context, this->f_packet ) < 0 )
+      {
+        // With frame threading the decoder holds on to the last few frames
+        // until it is told that the stream has ended.
+        if( this->decoder_threads != 1 )
+        {
+          if( !this->draining )
+          {
+            avcodec_send_packet( this->f_video_encoding, nullptr );
+            this->draining = true;
+          }
+
+          if( avcodec_receive_frame( this->f_video_encoding,
+                                     this->f_frame ) >= 0 )
+          {
+            this->set_frame_pts();
+            this->frame_advanced = true;
+          }
+        }
+        break;
+      }
+
       // Make sure that the packet is from the actual video stream.
       if( this->f_packet->stream_index == this->f_video_index )
       {
@@ -473,12 +572,7 @@ class ffmpeg_video_input::priv
           return false;
         }
 
-        this->f_pts = av_frame_get_best_effort_timestamp( this->f_frame );
-        if( this->f_pts == AV_NOPTS_VALUE )
-        {
-          this->f_pts = 0;
-        }
-
+        this->set_frame_pts();
         this->frame_advanced = true;
       }
 
@@ -488,9 +582,9 @@ class ffmpeg_video_input::priv
       {
         md_iter->second.emplace(
             this->f_packet->pts,
-            std::deque< uint8_t >( this->f_packet->data,
-                                   this->f_packet->data +
-                                   this->f_packet->size ) );
+            std::vector< uint8_t >( this->f_packet->data,
+                                    this->f_packet->data +
+                                    this->f_packet->size ) );
       }
 
       // De-reference previous packet
@@ -549,6 +643,18 @@ class ffmpeg_video_input::priv
       ( static_cast< int >( f_frame_number_offset ) + frame - 1 ) *
       this->stream_time_base_to_frame() + this->f_start_time;
 
+    // Jump straight to the keyframe which starts the requested frame's GOP.
+    // The back-step below still applies if this does not land early enough.
+    if( this->build_keyframe_index() )
+    {
+      auto const kf = std::upper_bound( this->keyframe_pts.begin(),
+                                        this->keyframe_pts.end(), frame_ts );
+      if( kf != this->keyframe_pts.begin() )
+      {
+        frame_ts = *( kf - 1 );
+      }
+    }
+
     bool advance_successful = false;
     size_t num_of_attempts = 0;
     do
@@ -557,6 +663,7 @@ class ffmpeg_video_input::priv
                                       this->f_video_index, frame_ts,
                                       AVSEEK_FLAG_BACKWARD );
       avcodec_flush_buffers( this->f_video_encoding );
+      this->draining = false;
 
       if( seek_rslt < 0 )
       {
@@ -596,6 +703,367 @@ class ffmpeg_video_input::priv
 
   // ==================================================================
 
+  /*
+   * @brief Name of the file which caches the keyframe index.
+   */
+  std::string
+  keyframe_index_path() const
+  {
+    return this->video_path + ".kfidx";
+  }
+
+  // ==================================================================
+
+  /*
+   * @brief Make sure the keyframe index is available, building it if
+   *  needed.
+   *
+   * @return \b true if the index is available and not empty.
+   */
+  bool
+  build_keyframe_index()
+  {
+    if( !this->use_keyframe_index || !this->is_opened() )
+    {
+      return false;
+    }
+
+    if( this->keyframe_index_built )
+    {
+      return !this->keyframe_pts.empty();
+    }
+
+    // Only try once per video, whether or not it works
+    this->keyframe_index_built = true;
+
+    if( this->cache_keyframe_index && this->load_keyframe_index() )
+    {
+      return !this->keyframe_pts.empty();
+    }
+
+    if( !this->scan_keyframes() )
+    {
+      LOG_WARN( this->logger, "Unable to index keyframes of "
+                << this->video_path );
+      return false;
+    }
+
+    if( this->cache_keyframe_index )
+    {
+      this->save_keyframe_index();
+    }
+
+    return !this->keyframe_pts.empty();
+  }
+
+  // ==================================================================
+
+  /*
+   * @brief Read every packet of the video stream to find the keyframes.
+   *
+   * Packets are only demuxed, not decoded, and a separate demuxer is used
+   * so that the current position is not disturbed.
+   *
+   * @return \b true if the video could be scanned.
+   */
+  bool
+  scan_keyframes()
+  {
+    std::lock_guard< std::mutex > lock( open_mutex );
+
+    AVFormatContext* context = nullptr;
+    if( avformat_open_input( &context, this->video_path.c_str(),
+                             NULL, NULL ) != 0 )
+    {
+      return false;
+    }
+
+    AVPacket* packet = av_packet_alloc();
+
+    this->keyframe_pts.clear();
+    this->packet_count = 0;
+
+    while( av_read_frame( context, packet ) >= 0 )
+    {
+      if( packet->stream_index == this->f_video_index )
+      {
+        int64_t const pts =
+          ( packet->pts != AV_NOPTS_VALUE ) ? packet->pts : packet->dts;
+
+        if( pts != AV_NOPTS_VALUE )
+        {
+          if( packet->flags & AV_PKT_FLAG_KEY )
+          {
+            this->keyframe_pts.push_back( pts );
+          }
+
+          // Each video packet holds one frame, so counting them gives the
+          // number of frames even when the frame rate varies.
+          ++this->packet_count;
+        }
+      }
+      av_packet_unref( packet );
+    }
+
+    av_packet_free( &packet );
+    avformat_close_input( &context );
+
+    std::sort( this->keyframe_pts.begin(), this->keyframe_pts.end() );
+
+    LOG_DEBUG( this->logger,
+               "Indexed " << this->keyframe_pts.size() << " keyframes in "
+               << this->video_path );
+
+    return true;
+  }
+
+  // ==================================================================
+
+  /*
+   * @brief Identify the video file so that a stale cache is not used.
+   */
+  std::string
+  keyframe_index_signature() const
+  {
+    std::ostringstream signature;
+    signature << "kwiver-keyframe-index 2 "
+              << kwiversys::SystemTools::FileLength( this->video_path ) << " "
+              << kwiversys::SystemTools::ModifiedTime( this->video_path ) << " "
+              << this->f_video_index;
+    return signature.str();
+  }
+
+  // ==================================================================
+
+  /*
+   * @brief Load the keyframe index from its cache file.
+   *
+   * @return \b true if a valid index for this video was loaded.
+   */
+  bool
+  load_keyframe_index()
+  {
+    std::ifstream in( this->keyframe_index_path() );
+    if( !in )
+    {
+      return false;
+    }
+
+    std::string signature;
+    if( !std::getline( in, signature ) ||
+        signature != this->keyframe_index_signature() )
+    {
+      LOG_DEBUG( this->logger, "Ignoring stale keyframe index "
+                 << this->keyframe_index_path() );
+      return false;
+    }
+
+    size_t count = 0;
+    size_t packets = 0;
+    if( !( in >> packets >> count ) )
+    {
+      return false;
+    }
+
+    std::vector< int64_t > pts( count );
+    for( auto& p : pts )
+    {
+      if( !( in >> p ) )
+      {
+        return false;
+      }
+    }
+
+    this->packet_count = packets;
+    this->keyframe_pts.swap( pts );
+    return true;
+  }
+
+  // ==================================================================
+
+  /*
+   * @brief Write the keyframe index to its cache file.
+   */
+  void
+  save_keyframe_index() const
+  {
+    std::ofstream out( this->keyframe_index_path() );
+    if( !out )
+    {
+      LOG_WARN( this->logger, "Unable to write keyframe index "
+                << this->keyframe_index_path() );
+      return;
+    }
+
+    out << this->keyframe_index_signature() << "\n"
+        << this->packet_count << " " << this->keyframe_pts.size() << "\n";
+    for( auto const p : this->keyframe_pts )
+    {
+      out << p << "\n";
+    }
+  }
+
+  // ==================================================================
+
+  /*
+   * @brief Convert the current decoded frame into an image.
+   *
+   * @return \b The image, or \c nullptr if there is no valid frame.
+   */
+  kwiver::vital::image_container_sptr
+  convert_image()
+  {
+    // Quick return if the stream isn't valid
+    if( !this->is_valid() )
+    {
+      return nullptr;
+    }
+
+    AVCodecParameters* params =
+      this->f_format_context->streams[ this->f_video_index ]->codecpar;
+
+    // If we have not already converted this frame, try to convert it
+    if( !this->current_image_memory && this->f_frame->data[ 0 ] != 0 )
+    {
+      int width = params->width;
+      int height = params->height;
+      int depth = 3;
+      vital::image_pixel_traits pixel_trait =
+        vital::image_pixel_traits_of< unsigned char >();
+      bool direct_copy;
+      AVFrame* frame = this->f_frame;
+      auto filtered_frame_ref =
+        std::unique_ptr< AVFrame, void ( * )( AVFrame* ) >{ nullptr, nullptr };
+
+      if( this->f_filter_src_context && this->f_filter_sink_context )
+      {
+        // Since we are only reading one frame at a time we need to push this
+        // frame into the filter pipeline repeatedly until the same frame comes
+        // out the other side.
+        do
+        {
+          // Push the decoded frame into the filter graph
+          if( av_buffersrc_add_frame_flags( this->f_filter_src_context,
+                                            this->f_frame,
+                                            AV_BUFFERSRC_FLAG_KEEP_REF ) < 0 )
+          {
+            LOG_ERROR( this->logger, "Error while feeding the filter graph" );
+            return nullptr;
+          }
+          // Pull a filtered frame from the filter graph
+          filtered_frame_ref = { this->f_filtered_frame, &av_frame_unref };
+
+          auto const ret = av_buffersink_get_frame( this->f_filter_sink_context,
+                                                    this->f_filtered_frame );
+          if( ret == AVERROR_EOF )
+          {
+            return nullptr;
+          }
+          if( ret == AVERROR( EAGAIN ) )
+          {
+            continue;
+          }
+        } while( this->f_frame->best_effort_timestamp !=
+                 this->f_filtered_frame->best_effort_timestamp );
+        frame = this->f_filtered_frame;
+      }
+
+      AVPixelFormat pix_fmt = static_cast< AVPixelFormat >( frame->format );
+      switch( pix_fmt )
+      {
+        case AV_PIX_FMT_GRAY8:
+        {
+          depth = 1;
+          direct_copy = true;
+          break;
+        }
+        case AV_PIX_FMT_RGB24:
+        {
+          depth = 3;
+          direct_copy = true;
+          break;
+        }
+        case AV_PIX_FMT_RGBA:
+        {
+          depth = 4;
+          direct_copy = true;
+          break;
+        }
+        case AV_PIX_FMT_MONOWHITE:
+        case AV_PIX_FMT_MONOBLACK:
+        {
+          depth = 1;
+          pixel_trait = vital::image_pixel_traits_of< bool >();
+          direct_copy = true;
+          break;
+        }
+        default:
+        {
+          direct_copy = false;
+        }
+      }
+
+      if( direct_copy )
+      {
+        int size = av_image_get_buffer_size( pix_fmt, width, height, 1 );
+        this->current_image_memory =
+          vital::image_memory_pool::instance().allocate( size );
+
+        AVFrame picture;
+        av_image_fill_arrays(
+          picture.data, picture.linesize,
+          static_cast< uint8_t* >( this->current_image_memory->data() ),
+          pix_fmt, width, height, 1 );
+
+        auto framedata = const_cast< const uint8_t** >( frame->data );
+        av_image_copy( picture.data, picture.linesize,
+                       framedata, frame->linesize,
+                       pix_fmt, width, height );
+      }
+      else
+      // If the pixel format is not recognized, convert the data into RGB_24
+      {
+        int size = width * height * depth;
+        this->current_image_memory =
+          vital::image_memory_pool::instance().allocate( size );
+
+        this->f_software_context = sws_getCachedContext(
+          this->f_software_context,
+          width, height, pix_fmt,
+          width, height, AV_PIX_FMT_RGB24,
+          SWS_BILINEAR,
+          NULL, NULL, NULL );
+
+        if( !this->f_software_context )
+        {
+          LOG_ERROR( this->logger, "Couldn't create conversion context" );
+          return nullptr;
+        }
+
+        AVFrame rgb_frame;
+        av_image_fill_arrays(
+          rgb_frame.data, rgb_frame.linesize,
+          static_cast< uint8_t* >( this->current_image_memory->data() ),
+          AV_PIX_FMT_RGB24, width, height, 1 );
+
+        sws_scale( this->f_software_context, frame->data, frame->linesize,
+                   0, height, rgb_frame.data, rgb_frame.linesize );
+      }
+
+      vital::image image(
+        this->current_image_memory,
+        this->current_image_memory->data(),
+        width, height, depth,
+        depth, depth * width, 1 );
+      this->current_image =
+        std::make_shared< vital::simple_image_container >( image );
+    }
+
+    return this->current_image;
+  }
+
+  // ==================================================================
+
   /*
    * @brief Get the current timestamp
    *
@@ -684,15 +1152,17 @@ class ffmpeg_video_input::priv
   {
     kwiver::vital::metadata_vector retval;
 
-    for( auto md : this->curr_metadata )
+    for( auto const& md : this->curr_metadata )
     {
-      // Copy the current raw metadata
-      std::deque< uint8_t > md_buffer = md.second;
+      // Parse the current raw metadata in place
+      uint8_t const* md_data = md.second.data();
+      size_t md_size = md.second.size();
 
-      kwiver::arrows::klv::klv_data klv_packet;
+      kwiver::arrows::klv::klv_packet_view klv_packet;
 
       // If we have collected enough of the stream to make a KLV packet
-      while( klv_pop_next_packet( md_buffer, klv_packet ) )
+      while( kwiver::arrows::klv::klv_next_packet( md_data, md_size,
+                                                   klv_packet ) )
       {
         auto meta = std::make_shared< kwiver::vital::metadata >();
 
@@ -748,6 +1218,8 @@ class ffmpeg_video_input::priv
 
     if( !collected_all_metadata )
     {
+      this->stop_read_ahead( true );
+
       std::lock_guard< std::mutex > lock( open_mutex );
 
       auto initial_frame_number = this->frame_number();
@@ -803,8 +1275,17 @@ class ffmpeg_video_input::priv
                    "Video not open" );
     }
 
+    if( !estimated_num_frames && this->build_keyframe_index() &&
+        this->packet_count )
+    {
+      number_of_frames = this->packet_count;
+      estimated_num_frames = true;
+    }
+
     if( !estimated_num_frames )
     {
+      this->stop_read_ahead( true );
+
       std::lock_guard< std::mutex > lock( open_mutex );
 
       auto initial_frame_number = this->frame_number();
@@ -824,6 +1305,7 @@ class ffmpeg_video_input::priv
                                         frame_ts,
                                         AVSEEK_FLAG_BACKWARD );
         avcodec_flush_buffers( this->f_video_encoding );
+        this->draining = false;
 
         if( seek_rslt < 0 )
         {
@@ -863,10 +1345,156 @@ class ffmpeg_video_input::priv
       }
       else
       {
-        this->seek( initial_frame_number );
+        // seek() takes one-based frame numbers
+        this->seek( initial_frame_number + 1 );
       }
     }
   }
+
+  // ==================================================================
+
+  /*
+   * @brief Return the timestamp of the current decoded frame.
+   */
+  kwiver::vital::timestamp
+  current_timestamp() const
+  {
+    // We don't always have all components of a timestamp, so start with
+    // an invalid TS and add the data we have.
+    kwiver::vital::timestamp ts;
+    ts.set_frame( this->frame_number() + this->f_frame_number_offset + 1 );
+
+    return ts;
+  }
+
+  // ==================================================================
+
+  /*
+   * @brief Decode frames into the read-ahead queue until stopped or the
+   *  video ends.
+   */
+  void
+  read_ahead_loop()
+  {
+    while( true )
+    {
+      {
+        std::unique_lock< std::mutex > lock( this->read_ahead_mutex );
+        this->read_ahead_have_space.wait( lock, [ this ]{
+          return this->read_ahead_stop ||
+                 this->read_ahead_queue.size() < this->read_ahead;
+        } );
+
+        if( this->read_ahead_stop )
+        {
+          return;
+        }
+      }
+
+      prefetched_frame_sptr frame;
+
+      try
+      {
+        if( this->advance() )
+        {
+          frame = std::make_shared< prefetched_frame >();
+          frame->ts = this->current_timestamp();
+          frame->image = this->convert_image();
+          frame->metadata = this->current_metadata();
+        }
+      }
+      catch( std::exception const& e )
+      {
+        LOG_ERROR( this->logger, "Read-ahead stopped: " << e.what() );
+        frame = nullptr;
+      }
+
+      {
+        std::lock_guard< std::mutex > lock( this->read_ahead_mutex );
+        this->read_ahead_queue.push_back( frame );
+      }
+      this->read_ahead_have_frame.notify_one();
+
+      if( !frame )
+      {
+        return;
+      }
+    }
+  }
+
+  // ==================================================================
+
+  /*
+   * @brief Take the next frame from the read-ahead queue, starting the
+   *  read-ahead thread if needed.
+   *
+   * @return \b The next frame, or \c nullptr at the end of the video.
+   */
+  prefetched_frame_sptr
+  next_prefetched()
+  {
+    if( !this->read_ahead_thread.joinable() )
+    {
+      this->read_ahead_decoder_moved = true;
+      this->read_ahead_thread =
+        std::thread( &priv::read_ahead_loop, this );
+    }
+
+    std::unique_lock< std::mutex > lock( this->read_ahead_mutex );
+    this->read_ahead_have_frame.wait( lock, [ this ]{
+      return !this->read_ahead_queue.empty();
+    } );
+
+    auto const frame = this->read_ahead_queue.front();
+    this->read_ahead_queue.pop_front();
+    lock.unlock();
+
+    this->read_ahead_have_space.notify_one();
+    return frame;
+  }
+
+  // ==================================================================
+
+  /*
+   * @brief Stop the read-ahead thread and discard the frames it queued.
+   *
+   * @param restore_position Whether to move the decoder back to the
+   *  caller's current frame so that it can be used directly.
+   */
+  void
+  stop_read_ahead( bool restore_position )
+  {
+    if( !this->read_ahead_thread.joinable() )
+    {
+      return;
+    }
+
+    {
+      std::lock_guard< std::mutex > lock( this->read_ahead_mutex );
+      this->read_ahead_stop = true;
+    }
+    this->read_ahead_have_space.notify_one();
+    this->read_ahead_thread.join();
+
+    this->read_ahead_queue.clear();
+    this->read_ahead_stop = false;
+
+    if( restore_position && this->read_ahead_decoder_moved &&
+        !this->read_ahead_end )
+    {
+      if( this->current_prefetched )
+      {
+        this->seek( this->current_prefetched->ts.get_frame() );
+      }
+      else
+      {
+        // The caller has not read a frame yet
+        this->close();
+        this->open( this->video_path );
+      }
+    }
+    this->read_ahead_decoder_moved = false;
+  }
 }; // end of internal class.
 
 // static open interlocking mutex
@@ -925,6 +1553,35 @@ ::get_configuration() const
     "current frame's timestamp until a frame is reached with timestamp "
     "that is equal or greater than the metadata's timestamp." );
 
+  config->set_value(
+    "read_ahead", d->read_ahead,
+    "Number of frames to decode ahead of the caller on a background "
+    "thread.  Each frame is demuxed, decoded, filtered and has its "
+    "metadata parsed before it is requested, so reading a frame only "
+    "waits when the queue is empty.  A setting of 0 decodes each frame "
+    "when it is requested." );
+
+  config->set_value(
+    "use_keyframe_index", d->use_keyframe_index,
+    "When set to true, the keyframes of the video are indexed the first "
+    "time a seek or the number of frames is requested.  Seeks then jump "
+    "directly to the keyframe before the requested frame, and the number "
+    "of frames is the number of timestamped video packets instead of "
+    "being found by decoding to the end of the video.  Building the index "
+    "reads, but does not decode, the whole video." );
+
+  config->set_value(
+    "cache_keyframe_index", d->cache_keyframe_index,
+    "When set to true, the keyframe index is saved next to the video in "
+    "a file with the extension \".kfidx\" and reused when the video is "
+    "opened again.  The cache is ignored if the video has changed." );
+
+  config->set_value(
+    "decoder_threads", d->decoder_threads,
+    "Number of threads the decoder may use for frame and slice "
+    "threading.  A setting of 0 lets FFmpeg choose based on the number "
+    "of CPUs." );
+
   return config;
 }
 
@@ -947,6 +1604,19 @@ ::set_configuration( vital::config_block_sptr in_config )
 
   d->sync_metadata = config->get_value< bool >( "sync_metadata",
                                                 d->sync_metadata );
+
+  d->read_ahead = config->get_value< size_t >( "read_ahead",
+                                               d->read_ahead );
+
+  d->use_keyframe_index =
+    config->get_value< bool >( "use_keyframe_index", d->use_keyframe_index );
+
+  d->cache_keyframe_index =
+    config->get_value< bool >( "cache_keyframe_index",
+                               d->cache_keyframe_index );
+
+  d->decoder_threads = config->get_value< int >( "decoder_threads",
+                                                 d->decoder_threads );
 }
 
 // -----------------------------------------------------------------
@@ -995,6 +1665,10 @@ void
 ffmpeg_video_input
 ::close()
 {
+  d->stop_read_ahead( false );
+  d->current_prefetched = nullptr;
+  d->read_ahead_end = false;
+
   d->close();
 
   d->video_path = "";
@@ -1004,6 +1678,9 @@ ::close()
   d->collected_all_metadata = false;
   d->estimated_num_frames = false;
   d->metadata.clear();
+  d->keyframe_index_built = false;
+  d->keyframe_pts.clear();
+  d->packet_count = 0;
 }
 
 // -----------------------------------------------------------------
@@ -1018,7 +1695,21 @@ ::next_frame( kwiver::vital::timestamp& ts,
                  "Video not open" );
   }
 
-  bool ret = d->advance();
+  bool ret = false;
+
+  if( d->read_ahead > 0 )
+  {
+    if( !d->read_ahead_end )
+    {
+      d->current_prefetched = d->next_prefetched();
+      d->read_ahead_end = !d->current_prefetched;
+    }
+    ret = !d->read_ahead_end;
+  }
+  else
+  {
+    ret = d->advance();
+  }
 
   d->end_of_video = !ret;
   if( ret )
@@ -1052,6 +1743,11 @@ ::seek_frame( kwiver::vital::timestamp& ts,
     LOG_WARN( this->logger(), "Timeout argument is not supported." );
   }
 
+  // Frames decoded ahead of the old position are of no use
+  d->stop_read_ahead( false );
+  d->current_prefetched = nullptr;
+  d->read_ahead_end = false;
+
   bool ret = d->seek( frame_number );
   d->end_of_video = !ret;
   if( ret )
@@ -1066,152 +1762,12 @@ kwiver::vital::image_container_sptr
 ffmpeg_video_input
 ::frame_image()
 {
-  // Quick return if the stream isn't valid
-  if( !d->is_valid() )
+  if( d->current_prefetched )
   {
-    return nullptr;
-  }
-
-  AVCodecParameters* params =
-    d->f_format_context->streams[ d->f_video_index ]->codecpar;
-
-  // If we have not already converted this frame, try to convert it
-  if( !d->current_image_memory && d->f_frame->data[ 0 ] != 0 )
-  {
-    int width = params->width;
-    int height = params->height;
-    int depth = 3;
-    vital::image_pixel_traits pixel_trait =
-      vital::image_pixel_traits_of< unsigned char >();
-    bool direct_copy;
-    AVFrame* frame = d->f_frame;
-    auto filtered_frame_ref =
-      std::unique_ptr< AVFrame, void ( * )( AVFrame* ) >{ nullptr, nullptr };
-
-    if( d->f_filter_src_context && d->f_filter_sink_context )
-    {
-      // Since we are only reading one frame at a time we need to push this
-      // frame into the filter pipeline repeatedly until the same frame comes
-      // out the other side.
-      do
-      {
-        // Push the decoded frame into the filter graph
-        if( av_buffersrc_add_frame_flags( d->f_filter_src_context, d->f_frame,
-                                          AV_BUFFERSRC_FLAG_KEEP_REF ) < 0 )
-        {
-          LOG_ERROR( this->logger(), "Error while feeding the filter graph" );
-          return nullptr;
-        }
-        // Pull a filtered frame from the filter graph
-        filtered_frame_ref = { d->f_filtered_frame, &av_frame_unref };
-
-        auto const ret = av_buffersink_get_frame( d->f_filter_sink_context,
-                                                  d->f_filtered_frame );
-        if( ret == AVERROR_EOF )
-        {
-          return nullptr;
-        }
-        if( ret == AVERROR( EAGAIN ) )
-        {
-          continue;
-        }
-      } while( d->f_frame->best_effort_timestamp !=
-               d->f_filtered_frame->best_effort_timestamp );
-      frame = d->f_filtered_frame;
-    }
-
-    AVPixelFormat pix_fmt = static_cast< AVPixelFormat >( frame->format );
-    switch( pix_fmt )
-    {
-      case AV_PIX_FMT_GRAY8:
-      {
-        depth = 1;
-        direct_copy = true;
-        break;
-      }
-      case AV_PIX_FMT_RGB24:
-      {
-        depth = 3;
-        direct_copy = true;
-        break;
-      }
-      case AV_PIX_FMT_RGBA:
-      {
-        depth = 4;
-        direct_copy = true;
-        break;
-      }
-      case AV_PIX_FMT_MONOWHITE:
-      case AV_PIX_FMT_MONOBLACK:
-      {
-        depth = 1;
-        pixel_trait = vital::image_pixel_traits_of< bool >();
-        direct_copy = true;
-        break;
-      }
-      default:
-      {
-        direct_copy = false;
-      }
-    }
-
-    if( direct_copy )
-    {
-      int size = av_image_get_buffer_size( pix_fmt, width, height, 1 );
-      d->current_image_memory =
-        std::make_shared< vital::image_memory >( size );
-
-      AVFrame picture;
-      av_image_fill_arrays(
-        picture.data, picture.linesize,
-        static_cast< uint8_t* >( d->current_image_memory->data() ),
-        pix_fmt, width, height, 1 );
-
-      auto framedata = const_cast< const uint8_t** >( frame->data );
-      av_image_copy( picture.data, picture.linesize,
-                     framedata, frame->linesize,
-                     pix_fmt, width, height );
-    }
-    else
-    // If the pixel format is not recognized, convert the data into RGB_24
-    {
-      int size = width * height * depth;
-      d->current_image_memory =
-        std::make_shared< vital::image_memory >( size );
-
-      d->f_software_context = sws_getCachedContext(
-        d->f_software_context,
-        width, height, pix_fmt,
-        width, height, AV_PIX_FMT_RGB24,
-        SWS_BILINEAR,
-        NULL, NULL, NULL );
-
-      if( !d->f_software_context )
-      {
-        LOG_ERROR( this->logger(), "Couldn't create conversion context" );
-        return nullptr;
-      }
-
-      AVFrame rgb_frame;
-      av_image_fill_arrays(
-        rgb_frame.data, rgb_frame.linesize,
-        static_cast< uint8_t* >( d->current_image_memory->data() ),
-        AV_PIX_FMT_RGB24, width, height, 1 );
-
-      sws_scale( d->f_software_context, frame->data, frame->linesize,
-                 0, height, rgb_frame.data, rgb_frame.linesize );
-    }
-
-    vital::image image(
-      d->current_image_memory,
-      d->current_image_memory->data(),
-      width, height, depth,
-      depth, depth * width, 1 );
-    d->current_image =
-      std::make_shared< vital::simple_image_container >( image );
+    return d->current_prefetched->image;
   }
 
-  return d->current_image;
+  return d->convert_image();
 }
 
 // -----------------------------------------------------------------
@@ -1224,12 +1780,12 @@ ::frame_timestamp() const
     return {};
   }
 
-  // We don't always have all components of a timestamp, so start with
-  // an invalid TS and add the data we have.
-  kwiver::vital::timestamp ts;
-  ts.set_frame( d->frame_number() + d->f_frame_number_offset + 1 );
+  if( d->current_prefetched )
+  {
+    return d->current_prefetched->ts;
+  }
 
-  return ts;
+  return d->current_timestamp();
 }
 
 // -----------------------------------------------------------------
@@ -1237,6 +1793,11 @@ kwiver::vital::metadata_vector
 ffmpeg_video_input
 ::frame_metadata()
 {
+  if( d->current_prefetched )
+  {
+    return d->current_prefetched->metadata;
+  }
+
   return d->current_metadata();
 }
 
@@ -1264,6 +1825,11 @@ bool
 ffmpeg_video_input
 ::good() const
 {
+  if( d->current_prefetched )
+  {
+    return true;
+  }
+
   return d->is_valid() && d->frame_advanced;
 }
 
@@ -18,6 +18,8 @@
 
 #include <arrows/vxl/vidl_ffmpeg_video_input.h>
 
+#include <kwiversys/SystemTools.hxx>
+
 #include <iostream>
 #include <memory>
 #include <string>
@@ -158,6 +160,61 @@ TEST_F ( ffmpeg_video_input, seek_frame )
   input.close();
 }
 
+// ---------------------------------------------------------------------------
+TEST_F ( ffmpeg_video_input, seek_frame_without_keyframe_index )
+{
+  kwiver::arrows::ffmpeg::ffmpeg_video_input input;
+
+  auto config = input.get_configuration();
+  config->set_value( "use_keyframe_index", false );
+  input.set_configuration( config );
+
+  kwiver::vital::path_t correct_file = data_dir + "/video.mp4";
+
+  // open the video
+  input.open( correct_file );
+
+  EXPECT_EQ( TOTAL_NUMBER_OF_FRAMES, input.num_frames() );
+  test_seek_frame( input );
+
+  input.close();
+}
+
+// ---------------------------------------------------------------------------
+TEST_F ( ffmpeg_video_input, cached_keyframe_index )
+{
+  // Work on a copy so that the cache is not written into the source tree
+  kwiver::vital::path_t const video_file =
+    kwiversys::SystemTools::GetCurrentWorkingDirectory() +
+    "/cached_keyframe_index.mp4";
+  kwiver::vital::path_t const index_file = video_file + ".kfidx";
+
+  kwiversys::SystemTools::CopyFileAlways( data_dir + "/video.mp4",
+                                          video_file );
+  kwiversys::SystemTools::RemoveFile( index_file );
+
+  for( int pass = 0; pass < 2; ++pass )
+  {
+    kwiver::arrows::ffmpeg::ffmpeg_video_input input;
+
+    auto config = input.get_configuration();
+    config->set_value( "cache_keyframe_index", true );
+    input.set_configuration( config );
+
+    input.open( video_file );
+
+    EXPECT_EQ( TOTAL_NUMBER_OF_FRAMES, input.num_frames() );
+    EXPECT_TRUE( kwiversys::SystemTools::FileExists( index_file ) );
+
+    test_seek_frame( input );
+
+    input.close();
+  }
+
+  kwiversys::SystemTools::RemoveFile( index_file );
+  kwiversys::SystemTools::RemoveFile( video_file );
+}
+
 // ---------------------------------------------------------------------------
 TEST_F ( ffmpeg_video_input, seek_then_next_frame )
 {
@@ -296,6 +353,66 @@ TEST_F ( ffmpeg_video_input, read_video )
     TOTAL_NUMBER_OF_FRAMES;
 }
 
+// ---------------------------------------------------------------------------
+TEST_F ( ffmpeg_video_input, read_video_read_ahead )
+{
+  kwiver::arrows::ffmpeg::ffmpeg_video_input input;
+
+  auto config = input.get_configuration();
+  config->set_value( "read_ahead", 4 );
+  config->set_value( "decoder_threads", 2 );
+  input.set_configuration( config );
+
+  kwiver::vital::path_t correct_file = data_dir + "/video.mp4";
+
+  input.open( correct_file );
+
+  kwiver::vital::timestamp ts;
+
+  int num_frames = 0;
+  while( input.next_frame( ts ) )
+  {
+    auto img = input.frame_image();
+    ASSERT_NE( nullptr, img );
+
+    ++num_frames;
+    EXPECT_EQ( num_frames, ts.get_frame() ) <<
+      "Frame numbers should be sequential";
+    EXPECT_EQ( ts.get_frame(), decode_barcode( *img ) ) <<
+      "Frame number should match barcode in frame image";
+    EXPECT_EQ( ts, input.frame_timestamp() );
+
+    // Counting frames must not disturb the read-ahead position
+    if( num_frames == 10 )
+    {
+      EXPECT_EQ( TOTAL_NUMBER_OF_FRAMES, input.num_frames() );
+      EXPECT_EQ( 10, input.frame_timestamp().get_frame() );
+    }
+  }
+  EXPECT_EQ( TOTAL_NUMBER_OF_FRAMES, num_frames ) <<
+    "Number of frames found should be " <<
+    TOTAL_NUMBER_OF_FRAMES;
+  EXPECT_TRUE( input.end_of_video() );
+}
+
+// ---------------------------------------------------------------------------
+TEST_F ( ffmpeg_video_input, next_then_seek_then_next_read_ahead )
+{
+  kwiver::arrows::ffmpeg::ffmpeg_video_input input;
+
+  auto config = input.get_configuration();
+  config->set_value( "read_ahead", 4 );
+  input.set_configuration( config );
+
+  kwiver::vital::path_t correct_file = data_dir + "/video.mp4";
+
+  input.open( correct_file );
+
+  test_next_then_seek_then_next( input );
+
+  input.close();
+}
+
 // ---------------------------------------------------------------------------
 TEST_F ( ffmpeg_video_input, read_video_nth_frame_output )
 {
@@ -119,7 +119,7 @@ ::normalize_0104_tag_data( VITAL_UNUSED klv_0104::tag tag,
 
 // ------------------------------------------------------------------
 void convert_metadata
-::convert_0104_metadata( klv_uds_vector_t const& uds,
+::convert_0104_metadata( klv_uds_cursor uds,
                          kwiver::vital::metadata& md )
 {
   //
@@ -140,21 +140,22 @@ ::convert_0104_metadata( klv_uds_vector_t const& uds,
   //
   md.add< kwiver::vital::VITAL_META_METADATA_ORIGIN >( MISB_0104 );
 
-  for ( auto itr = uds.begin(); itr != uds.end(); ++itr )
+  while ( uds.next() )
   {
+    klv_uds_key const key = uds.key();
     klv_0104::tag tag;
     kwiver::vital::any data;
 
     try
     {
-      tag = klv_0104::instance()->get_tag( itr->first );
+      tag = klv_0104::instance()->get_tag( key );
       if ( tag == klv_0104::UNKNOWN )
       {
-        LOG_DEBUG( m_logger, "Unknown key: " << itr->first << "Length: " << itr->second.size() << " bytes" );
+        LOG_DEBUG( m_logger, "Unknown key: " << key << "Length: " << uds.value_size() << " bytes" );
         continue;
       }
 
-      data = klv_0104::instance()->get_value( tag, &itr->second[0], itr->second.size() );
+      data = klv_0104::instance()->get_value( tag, uds.value(), uds.value_size() );
     }
     catch ( kwiver::vital::metadata_exception const& e )
     {
@@ -267,11 +268,11 @@ case klv_0104::KN:                                        \
       break;
 
     default:
-      LOG_DEBUG( m_logger, "Unprocessed key: " << itr->first << "Length: " << itr->second.size() << " bytes" );
+      LOG_DEBUG( m_logger, "Unprocessed key: " << key << "Length: " << uds.value_size() << " bytes" );
       break;
     } // end switch
 
-  } // end for
+  } // end while
 
   //
   // Process composite metadata
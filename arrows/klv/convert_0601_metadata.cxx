@@ -138,7 +138,7 @@ ::normalize_0601_tag_data( klv_0601_tag tag,
 // ------------------------------------------------------------------
 void
 convert_metadata
-::convert_0601_metadata( klv_lds_vector_t const& lds, kwiver::vital::metadata& md )
+::convert_0601_metadata( klv_lds_cursor lds, kwiver::vital::metadata& md )
 {
   static kwiver::vital::logger_handle_t logger( kwiver::vital::get_logger( "vital.convert_metadata" ) );
 
@@ -157,23 +157,24 @@ ::convert_0601_metadata( klv_lds_vector_t const& lds, kwiver::vital::metadata& m
   auto raw_corner_pt4 = empty_vector<2>();
   auto raw_target_location = empty_vector<3>();
 
-  for ( auto itr = lds.begin(); itr != lds.end(); ++itr )
+  while ( lds.next() )
   {
-    if ( ( itr->first <= KLV_0601_UNKNOWN ) || ( itr->first >= KLV_0601_ENUM_END ) )
+    klv_lds_key const key = lds.key();
+    if ( ( key <= KLV_0601_UNKNOWN ) || ( key >= KLV_0601_ENUM_END ) )
     {
-      LOG_DEBUG( logger, "KLV 0601 key: " << int(itr->first) << " is not supported" );
+      LOG_DEBUG( logger, "KLV 0601 key: " << int(key) << " is not supported" );
       continue;
     }
 
     // Convert a single tag
-    const klv_0601_tag tag( klv_0601_get_tag( itr->first ) ); // get tag code from key
+    const klv_0601_tag tag( klv_0601_get_tag( key ) ); // get tag code from key
 
     LOG_TRACE( logger, "Processing 0601 tag: "
                << klv_0601_tag_to_string( tag ) );
 
     // Extract relevant data from associated data bytes.
     kwiver::vital::any data = klv_0601_value( tag,
-                                              &itr->second[0], itr->second.size() );
+                                              lds.value(), lds.value_size() );
     switch (tag)
     {
 // Refine simple case to a define
@@ -378,10 +379,10 @@ ::convert_0601_metadata( klv_lds_vector_t const& lds, kwiver::vital::metadata& m
     case KLV_0601_ENUM_END:
     case KLV_0601_GENERIC_FLAG_DATA_01:
     default:
-      LOG_DEBUG( logger, "KLV 0601 key: " << int(itr->first) << " is not supported." );
+      LOG_DEBUG( logger, "KLV 0601 key: " << int(key) << " is not supported." );
       break;
     } // end switch
-  } // end for
+  } // end while
 
   //
   // Process composite metadata
@@ -61,7 +61,14 @@ convert_metadata
 void convert_metadata
 ::convert( klv_data const& klv, kwiver::vital::metadata& md )
 {
-  klv_uds_key uds_key( klv ); // create key from raw data
+  this->convert( klv_view( klv ), md );
+}
+
+// ------------------------------------------------------------------
+void convert_metadata
+::convert( klv_packet_view const& klv, kwiver::vital::metadata& md )
+{
+  klv_uds_key uds_key = klv.key(); // create key from raw data
 
   if ( is_klv_0601_key( uds_key ) )
   {
@@ -72,13 +79,13 @@ ::convert( klv_data const& klv, kwiver::vital::metadata& md )
                    "checksum error on 0601 packet");
     }
 
-    klv_lds_vector_t lds = parse_klv_lds( klv );
-    convert_0601_metadata( lds, md );
+    convert_0601_metadata( klv_lds_cursor( klv.value_begin(), klv.value_size() ),
+                           md );
   }
   else if ( klv_0104::is_key( uds_key ) )
   {
-    klv_uds_vector_t uds = parse_klv_uds( klv );
-    convert_0104_metadata( uds,  md );
+    convert_0104_metadata( klv_uds_cursor( klv.value_begin(), klv.value_size() ),
+                           md );
   }
   else
   {
@@ -49,6 +49,19 @@ class KWIVER_ALGO_KLV_EXPORT convert_metadata
    */
    void convert( klv_data const& klv, kwiver::vital::metadata& md );
 
+  /**
+   * @brief Convert raw metadata packet into vital metadata entries.
+   *
+   * The packet is decoded in place; its local set items are visited
+   * one at a time rather than being copied out first.
+   *
+   * @param[in] klv View of raw metadata packet containing UDS key
+   * @param[in,out] metadata Collection of metadata this updated.
+   *
+   * @throws metadata_exception When error encountered.
+   */
+   void convert( klv_packet_view const& klv, kwiver::vital::metadata& md );
+
   /**
    * \brief Get type representation for vital metadata tag.
    *
@@ -84,8 +97,8 @@ class KWIVER_ALGO_KLV_EXPORT convert_metadata
 
 private:
 
-  void convert_0601_metadata( klv_lds_vector_t const& lds, kwiver::vital::metadata& md );
-  void convert_0104_metadata( klv_uds_vector_t const& uds, kwiver::vital::metadata& md );
+  void convert_0601_metadata( klv_lds_cursor lds, kwiver::vital::metadata& md );
+  void convert_0104_metadata( klv_uds_cursor uds, kwiver::vital::metadata& md );
 
   kwiver::vital::any normalize_0601_tag_data( klv_0601_tag tag,
                                               kwiver::vital::vital_metadata_tag vital_tag,
@@ -5,6 +5,7 @@
 #include "klv_0601.h"
 #include "klv_0601_traits.h"
 #include "klv_data.h"
+#include "klv_parse.h"
 
 #include <vital/logger/logger.h>
 
@@ -326,7 +327,19 @@ klv_0601_get_tag( klv_lds_key key )
 bool
 klv_0601_checksum( klv_data const& data )
 {
-  klv_data::const_iterator_t eit = data.klv_end();
+  return klv_0601_checksum( klv_view( data ) );
+}
+
+// ----------------------------------------------------------------
+bool
+klv_0601_checksum( klv_packet_view const& data )
+{
+  if ( data.klv_size() < 4 )
+  {
+    return false;
+  }
+
+  uint8_t const* eit = data.klv_end();
 
   // if checksum tag is not where expected then terminate early
   if ( ( *( eit - 4 ) != 0x01 ) && //
@@ -340,7 +353,7 @@ klv_0601_checksum( klv_data const& data )
 
   uint16_t bcc( 0 );
   size_t len = data.klv_size() - 2;
-  klv_data::const_iterator_t cit = data.klv_begin();
+  uint8_t const* cit = data.klv_begin();
 
   // Sum each 16-bit chunk within the buffer into a checksum
   for ( unsigned i = 0; i < len; i++ )
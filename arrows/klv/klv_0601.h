@@ -24,10 +24,16 @@ namespace kwiver {
 namespace arrows {
 namespace klv {
 
+struct klv_packet_view;
+
 /// Validate a KLV 0601 data packet using the checksum at the end
 /// @param[in] data is the klv packet to checksum
 KWIVER_ALGO_KLV_EXPORT bool klv_0601_checksum( klv_data const& data );
 
+/// Validate a KLV 0601 data packet held in a caller owned buffer
+/// @param[in] data is a view of the klv packet to checksum
+KWIVER_ALGO_KLV_EXPORT bool klv_0601_checksum( klv_packet_view const& data );
+
 /// Enumeration of tags in the MISB 0601 KLV standard
 enum klv_0601_tag {KLV_0601_UNKNOWN                     = 0,
                    KLV_0601_CHECKSUM                    = 1,
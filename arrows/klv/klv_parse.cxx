@@ -17,6 +17,7 @@
 
 #include <vital/logger/logger.h>
 
+#include <algorithm>
 #include <cctype>
 
 namespace kwiver {
@@ -120,49 +121,46 @@ klv_ber_length( ITERATOR buffer,
 }
 
 // ----------------------------------------------------------------
-/** @brief Pop the first KLV UDS key-value pair found in the data buffer.
+/** Locate the first KLV UDS packet in a run of bytes.
  *
- * The first valid KLV packet found in the data stream is returned.
- * Leading bytes that do not belong to a KLV pair are dropped. The
- * input byte stream is modified internally and unprocessed partial
- * packets are left there so more raw data can be added to the stream
- * and packet parsing can be attempted later.
+ * This is the common scanner behind klv_next_packet() and
+ * klv_pop_next_packet(). It works on any random access iterator so
+ * the same code serves contiguous buffers and the deque interface.
  *
- * @param[in,out] data Byte stream to be parsed.
- * @param[out] klv_packet Full klv packet with key and data fields
- * specified.
+ * @param[in] data start of the bytes to scan
+ * @param[in] size number of bytes available
+ * @param[out] skipped number of leading bytes that do not belong to a
+ *   packet; when a packet is found it starts at this offset
+ * @param[out] value_offset offset of the value from the packet start
+ * @param[out] value_len number of bytes in the value
  *
- * @return \c true if packet returned; \c false if no packet returned.
+ * @returns True if a complete packet was found.
  */
+template < class ITERATOR >
 bool
-klv_pop_next_packet( std::deque< uint8_t >&  data,
-                     klv_data&               klv_packet )
+klv_find_packet( ITERATOR data,
+                 size_t size,
+                 size_t& skipped,
+                 size_t& value_offset,
+                 size_t& value_len )
 {
   const std::size_t klv_key_length = klv_uds_key::size();
 
-  while ( data.size() > klv_key_length + 1 )
+  skipped = 0;
+  while ( size - skipped > klv_key_length + 1 )
   {
+    ITERATOR it = data + skipped;
+
     // The buffer must start with key prefix for best results.
-    // Would be nice if this could be done by method call
-    // if (uds_key::matches_prefix(data) ) ...
-    if ( ( data[0] == klv_uds_key::prefix[0] ) &&
-         ( data[1] == klv_uds_key::prefix[1] ) &&
-         ( data[2] == klv_uds_key::prefix[2] ) &&
-         ( data[3] == klv_uds_key::prefix[3] ) )
+    if ( ( it[0] == klv_uds_key::prefix[0] ) &&
+         ( it[1] == klv_uds_key::prefix[1] ) &&
+         ( it[2] == klv_uds_key::prefix[2] ) &&
+         ( it[3] == klv_uds_key::prefix[3] ) )
     {
-      // This is a little wierd, but it is this approach or I write
-      // another constructor signature. The data needs to be copied
-      // from the dqueue one element at a time because &data[1] is not
-      // always equal to (&data[0] +1) due to memory management
-      // practices in the dqueue (although sometimes it is).
-      //
-      // We are guaranteed enough bytes in the dqueue because of the
+      // We are guaranteed enough bytes in the buffer because of the
       // preceeding test in while()
       uint8_t temp[16];
-      for ( int i = 0; i < 16; ++i )
-      {
-        temp[i] = data[i];
-      } // end for
+      std::copy( it, it + klv_key_length, temp );
 
       klv_uds_key temp_key( temp );
 
@@ -170,34 +168,23 @@ klv_pop_next_packet( std::deque< uint8_t >&  data,
       {
         if ( temp_key.category() == klv_uds_key::CATEGORY_LABEL )
         {
-          // collect bytes that make up the key
-          klv_data::container_t raw_data( data.begin(), data.begin() + klv_key_length );
-          klv_packet = klv_data( raw_data, 0, klv_key_length, 0, 0 );
-
           // Keys with category "Label" have no length or value data
-          data.erase( data.begin(), data.begin() + klv_key_length );
+          value_offset = klv_key_length;
+          value_len = 0;
           return true;
         }
 
         uint8_t offset;
         unsigned int length;
-        if ( klv_ber_length( data.begin() + klv_key_length,
-                             data.size() - klv_key_length,
+        if ( klv_ber_length( it + klv_key_length,
+                             size - skipped - klv_key_length,
                              offset, length ) )
         {
-          size_t total_len = klv_key_length + offset + length;
-
           // Is the full packet in the input buffer?
-          if ( data.size() >= total_len )
+          if ( size - skipped >= klv_key_length + offset + length )
           {
-            klv_data::container_t raw_data( data.begin(), data.begin() + total_len ); // extract the key bytes
-            klv_packet = klv_data( raw_data,       // total raw data
-                                   0,              // key offset
-                                   klv_key_length, // length of key in bytes
-                                   klv_key_length + offset, // value offset (start of value bytes)
-                                   length );                // length of value in bytes
-
-            data.erase( data.begin(), data.begin() + total_len );
+            value_offset = klv_key_length + offset;
+            value_len = length;
             return true;
           }
         }
@@ -206,84 +193,249 @@ klv_pop_next_packet( std::deque< uint8_t >&  data,
 
     } // end valid key
 
-    // If prefix does not match or key not valid
-    // Delete byte from top of input and try again
-    kwiver::vital::logger_handle_t logger( kwiver::vital::get_logger( "vital.klv_parse" ) );
-    LOG_DEBUG( logger, "discarding klv byte - 0x" << std::hex << int(data[0])
-               //  << " rest of prefix: 0x"
-               // << int(data[1]) << " 0x"
-               // << int(data[2]) << " 0x"
-               // << int(data[3]) << " -- 0x"
-               // << int(data[4]) << " 0x"
-               // << int(data[5]) << " 0x"
-               // << int(data[6]) << " 0x"
-               // << int(data[7])
-             );
-    data.pop_front();
+    // If prefix does not match or key not valid skip the byte and
+    // try again
+    ++skipped;
 
   } // end while
 
+  if ( skipped > 0 )
+  {
+    kwiver::vital::logger_handle_t logger( kwiver::vital::get_logger( "vital.klv_parse" ) );
+    LOG_DEBUG( logger, "discarding " << skipped << " klv bytes" );
+  }
+
   return false;
-} // pop_klv_uds_pair
+}
 
 // ----------------------------------------------------------------
-/** Parse out Local Data Set (LDS) packet.
+klv_packet_view
+::klv_packet_view()
+  : data( nullptr ),
+    key_len( 0 ),
+    value_offset( 0 ),
+    value_len( 0 )
+{ }
+
+// ----------------------------------------------------------------
+klv_uds_key
+klv_packet_view
+::key() const
+{
+  uint8_t temp[16] = { 0 };
+  std::copy( this->key_begin(),
+             this->key_begin() + std::min< size_t >( this->key_len, 16 ),
+             temp );
+  return klv_uds_key( temp );
+}
+
+// ----------------------------------------------------------------
+klv_data
+klv_packet_view
+::to_klv_data() const
+{
+  klv_data::container_t raw_data( this->klv_begin(), this->klv_end() );
+  return klv_data( raw_data, 0, this->key_len,
+                   this->value_offset, this->value_len );
+}
+
+// ----------------------------------------------------------------
+bool
+klv_next_packet( uint8_t const*&   data,
+                 size_t&           size,
+                 klv_packet_view&  klv_packet )
+{
+  size_t skipped;
+  size_t value_offset;
+  size_t value_len;
+  bool const found = klv_find_packet( data, size, skipped,
+                                      value_offset, value_len );
+
+  data += skipped;
+  size -= skipped;
+  if ( ! found )
+  {
+    return false;
+  }
+
+  klv_packet.data = data;
+  klv_packet.key_len = klv_uds_key::size();
+  klv_packet.value_offset = value_offset;
+  klv_packet.value_len = value_len;
+
+  data += klv_packet.klv_size();
+  size -= klv_packet.klv_size();
+  return true;
+}
+
+// ----------------------------------------------------------------
+klv_packet_view
+klv_view( klv_data const& klv_packet )
+{
+  klv_packet_view view;
+  if ( klv_packet.klv_size() > 0 )
+  {
+    view.data = &*klv_packet.klv_begin();
+    view.key_len = klv_packet.key_size();
+    view.value_offset = klv_packet.value_begin() - klv_packet.klv_begin();
+    view.value_len = klv_packet.value_size();
+  }
+  return view;
+}
+
+// ----------------------------------------------------------------
+/** @brief Pop the first KLV UDS key-value pair found in the data buffer.
  *
- * The data portion of the raw KLV packet is parsed into LDS packets.
+ * The first valid KLV packet found in the data stream is returned.
+ * Leading bytes that do not belong to a KLV pair are dropped. The
+ * input byte stream is modified internally and unprocessed partial
+ * packets are left there so more raw data can be added to the stream
+ * and packet parsing can be attempted later.
+ *
+ * @param[in,out] data Byte stream to be parsed.
+ * @param[out] klv_packet Full klv packet with key and data fields
+ * specified.
+ *
+ * @return \c true if packet returned; \c false if no packet returned.
  */
-std::vector< klv_lds_pair >
-parse_klv_lds( klv_data const& data )
+bool
+klv_pop_next_packet( std::deque< uint8_t >&  data,
+                     klv_data&               klv_packet )
+{
+  size_t skipped;
+  size_t value_offset;
+  size_t value_len;
+  bool const found = klv_find_packet( data.begin(), data.size(), skipped,
+                                      value_offset, value_len );
+
+  data.erase( data.begin(), data.begin() + skipped );
+  if ( ! found )
+  {
+    return false;
+  }
+
+  size_t const total_len = value_offset + value_len;
+  klv_data::container_t raw_data( data.begin(), data.begin() + total_len );
+  klv_packet = klv_data( raw_data,            // total raw data
+                         0,                   // key offset
+                         klv_uds_key::size(), // length of key in bytes
+                         value_offset,        // value offset (start of value bytes)
+                         value_len );         // length of value in bytes
+
+  data.erase( data.begin(), data.begin() + total_len );
+  return true;
+} // pop_klv_uds_pair
+
+// ----------------------------------------------------------------
+klv_lds_cursor
+::klv_lds_cursor( uint8_t const* data, size_t size )
+  : m_data( data ),
+    m_size( size ),
+    m_value( nullptr ),
+    m_value_len( 0 )
+{ }
+
+// ----------------------------------------------------------------
+bool
+klv_lds_cursor
+::next()
 {
-  std::vector< klv_lds_pair > lds_pairs;
   uint8_t offset;
   unsigned int value_len;
-  size_t len = data.value_size();
-  klv_data::const_iterator_t it = data.value_begin();
 
-  while ( ( len > 3 ) &&
-          klv_ber_length( it + 1, len - 1, offset, value_len ) &&
-          ( offset + 1 + value_len <= len ) )
+  if ( ( m_size > 3 ) &&
+       klv_ber_length( m_data + 1, m_size - 1, offset, value_len ) &&
+       ( offset + 1 + value_len <= m_size ) )
   {
-    klv_lds_key key( *it ); // one byte key
-    std::vector< uint8_t > value( it + offset + 1, it + offset + 1 + value_len );
-    lds_pairs.push_back( klv_lds_pair( key, value ) );
+    m_key = klv_lds_key( *m_data ); // one byte key
+    m_value = m_data + 1 + offset;
+    m_value_len = value_len;
 
     // update pointer into data
-    it = it + 1 + offset + value_len;
-    len -= 1 + offset + value_len;
+    m_data += 1 + offset + value_len;
+    m_size -= 1 + offset + value_len;
+    return true;
+  }
+
+  return false;
+}
+
+// ----------------------------------------------------------------
+klv_uds_cursor
+::klv_uds_cursor( uint8_t const* data, size_t size )
+  : m_data( data ),
+    m_size( size )
+{ }
+
+// ----------------------------------------------------------------
+bool
+klv_uds_cursor
+::next()
+{
+  return klv_next_packet( m_data, m_size, m_packet );
+}
+
+// ----------------------------------------------------------------
+/** Parse out Local Data Set (LDS) packet.
+ *
+ * The data portion of the raw KLV packet is parsed into LDS packets.
+ */
+klv_lds_vector_t
+parse_klv_lds( klv_packet_view const& data )
+{
+  klv_lds_vector_t lds_pairs;
+  klv_lds_cursor cursor( data.value_begin(), data.value_size() );
+
+  while ( cursor.next() )
+  {
+    lds_pairs.push_back(
+      klv_lds_pair( cursor.key(),
+                    std::vector< uint8_t >( cursor.value(),
+                                            cursor.value() + cursor.value_size() ) ) );
   }
 
-  if ( len != 0 )
+  if ( cursor.remaining() != 0 )
   {
     kwiver::vital::logger_handle_t logger( kwiver::vital::get_logger( "vital.klv_parse" ) );
-    LOG_WARN( logger, len << " bytes left over when parsing LDS" );
+    LOG_WARN( logger, cursor.remaining() << " bytes left over when parsing LDS" );
   }
 
   return lds_pairs;
 }
 
+// ----------------------------------------------------------------
+klv_lds_vector_t
+parse_klv_lds( klv_data const& data )
+{
+  return parse_klv_lds( klv_view( data ) );
+}
+
 // ----------------------------------------------------------------
 /** Parse data set with universal keys */
 klv_uds_vector_t
-parse_klv_uds( klv_data const& data )
+parse_klv_uds( klv_packet_view const& data )
 {
-  std::vector< klv_uds_pair > uds_pairs;
-
-  klv_data pk;
+  klv_uds_vector_t uds_pairs;
+  klv_uds_cursor cursor( data.value_begin(), data.value_size() );
 
-  // create queue of data portion of packet.
-  std::deque< uint8_t > deq( data.value_begin(), data.value_end() );
-
-  while ( klv_pop_next_packet( deq, pk ) )
+  while ( cursor.next() )
   {
-    klv_uds_key uds_key( pk ); // 16 byte key
-    uds_pairs.push_back( klv_uds_pair( uds_key,
-         std::vector< uint8_t > ( pk.value_begin(), pk.value_end() ) ) );
+    uds_pairs.push_back(
+      klv_uds_pair( cursor.key(),
+                    std::vector< uint8_t >( cursor.value(),
+                                            cursor.value() + cursor.value_size() ) ) );
   }
 
   return uds_pairs;
 }
 
+// ----------------------------------------------------------------
+klv_uds_vector_t
+parse_klv_uds( klv_data const& data )
+{
+  return parse_klv_uds( klv_view( data ) );
+}
+
 // ----------------------------------------------------------------
 std::ostream&
 print_klv( std::ostream& str, klv_data const& klv )
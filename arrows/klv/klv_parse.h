@@ -15,6 +15,7 @@
 #include <vector>
 #include <deque>
 #include <ostream>
+#include <cstddef>
 #include <cstdint>
 
 namespace kwiver {
@@ -31,6 +32,153 @@ typedef std::vector< klv_lds_pair > klv_lds_vector_t;
 typedef std::pair<klv_uds_key, std::vector<uint8_t> > klv_uds_pair;
 typedef std::vector< klv_uds_pair > klv_uds_vector_t;
 
+// ----------------------------------------------------------------
+/** A view of a single KLV packet held in a caller owned buffer.
+ *
+ * This is the non-owning counterpart of klv_data. It only refers to
+ * the bytes of the packet, so the buffer it was found in must outlive
+ * the view.
+ */
+struct KWIVER_ALGO_KLV_EXPORT klv_packet_view
+{
+  klv_packet_view();
+
+  /// Number of bytes in the key
+  std::size_t key_size() const { return key_len; }
+
+  /// Number of bytes in the value portion
+  std::size_t value_size() const { return value_len; }
+
+  /// Number of bytes in whole packet
+  std::size_t klv_size() const { return value_offset + value_len; }
+
+  /// Pointers into the raw packet
+  uint8_t const* klv_begin() const { return data; }
+  uint8_t const* klv_end() const { return data + klv_size(); }
+  uint8_t const* key_begin() const { return data; }
+  uint8_t const* key_end() const { return data + key_len; }
+  uint8_t const* value_begin() const { return data + value_offset; }
+  uint8_t const* value_end() const { return data + klv_size(); }
+
+  /// The 16 byte universal key of this packet
+  klv_uds_key key() const;
+
+  /// Copy the packet into an owning klv_data object
+  klv_data to_klv_data() const;
+
+  uint8_t const* data;
+  std::size_t key_len;
+  std::size_t value_offset;
+  std::size_t value_len;
+};
+
+// ----------------------------------------------------------------
+/** Iterate over the items of a Local Data Set without copying them.
+ *
+ * The cursor decodes one LDS item each time next() is called. The
+ * value accessors point into the buffer the cursor was created on.
+ *
+ * \code
+ klv_lds_cursor cursor( packet.value_begin(), packet.value_size() );
+ while ( cursor.next() )
+ {
+   use( cursor.key(), cursor.value(), cursor.value_size() );
+ }
+ \endcode
+ */
+class KWIVER_ALGO_KLV_EXPORT klv_lds_cursor
+{
+public:
+  klv_lds_cursor( uint8_t const* data, std::size_t size );
+
+  /**
+   * @brief Advance to the next LDS item.
+   *
+   * @return \c true if an item is available; \c false when the end of
+   * the set, or a malformed item, has been reached.
+   */
+  bool next();
+
+  /// Key of the current item
+  klv_lds_key key() const { return m_key; }
+
+  /// Value bytes of the current item
+  uint8_t const* value() const { return m_value; }
+  std::size_t value_size() const { return m_value_len; }
+
+  /// Number of bytes not yet consumed by next()
+  std::size_t remaining() const { return m_size; }
+
+private:
+  uint8_t const* m_data;
+  std::size_t m_size;
+  klv_lds_key m_key;
+  uint8_t const* m_value;
+  std::size_t m_value_len;
+};
+
+// ----------------------------------------------------------------
+/** Iterate over the items of a Universal Data Set without copying them.
+ *
+ * This is the UDS counterpart of klv_lds_cursor. Each item is a full
+ * KLV packet with a 16 byte key.
+ */
+class KWIVER_ALGO_KLV_EXPORT klv_uds_cursor
+{
+public:
+  klv_uds_cursor( uint8_t const* data, std::size_t size );
+
+  /**
+   * @brief Advance to the next UDS item.
+   *
+   * @return \c true if an item is available; \c false at the end of
+   * the set.
+   */
+  bool next();
+
+  /// Key of the current item
+  klv_uds_key key() const { return m_packet.key(); }
+
+  /// Value bytes of the current item
+  uint8_t const* value() const { return m_packet.value_begin(); }
+  std::size_t value_size() const { return m_packet.value_size(); }
+
+private:
+  uint8_t const* m_data;
+  std::size_t m_size;
+  klv_packet_view m_packet;
+};
+
+/**
+ * @brief Find the next KLV UDS packet in a contiguous buffer.
+ *
+ * This is the zero copy version of klv_pop_next_packet(). The first
+ * valid KLV packet in the buffer is returned as a view into the
+ * buffer. On return \p data and \p size are advanced past the
+ * returned packet and any leading bytes that do not belong to a KLV
+ * packet. If the buffer ends with a partial packet, \p data is left
+ * pointing at its start and no packet is returned.
+ *
+ * @param[in,out] data Start of the bytes to be parsed.
+ * @param[in,out] size Number of bytes available at \p data.
+ * @param[out] klv_packet View of the packet found.
+ *
+ * @return \c true if packet returned; \c false if no packet returned.
+ */
+KWIVER_ALGO_KLV_EXPORT bool
+klv_next_packet( uint8_t const*& data, std::size_t& size,
+                 klv_packet_view& klv_packet );
+
+/**
+ * @brief Make a view of a KLV packet.
+ *
+ * @param klv_packet Packet to view; it must outlive the returned view.
+ *
+ * @return View over the bytes of \p klv_packet.
+ */
+KWIVER_ALGO_KLV_EXPORT klv_packet_view
+klv_view( klv_data const& klv_packet );
+
 /**
  * @brief Pop the first KLV UDS key-value pair found in the data buffer.
  *
@@ -62,6 +210,10 @@ klv_pop_next_packet( std::deque< uint8_t >& data, klv_data& klv_packet);
 KWIVER_ALGO_KLV_EXPORT klv_lds_vector_t
 parse_klv_lds(klv_data const& data);
 
+/// \copydoc parse_klv_lds
+KWIVER_ALGO_KLV_EXPORT klv_lds_vector_t
+parse_klv_lds(klv_packet_view const& data);
+
 /**
  * @brief Parse KLV UDS (Universal Data Set) from an array of bytes.
  *
@@ -78,6 +230,10 @@ parse_klv_lds(klv_data const& data);
 KWIVER_ALGO_KLV_EXPORT klv_uds_vector_t
 parse_klv_uds( klv_data const& data );
 
+/// \copydoc parse_klv_uds
+KWIVER_ALGO_KLV_EXPORT klv_uds_vector_t
+parse_klv_uds( klv_packet_view const& data );
+
 /**
  * @brief Print KLV packet.
  *
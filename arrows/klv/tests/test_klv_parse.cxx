@@ -0,0 +1,512 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Tests for the KLV packet and data set parsers
+ */
+
+#include <arrows/klv/klv_0104.h>
+#include <arrows/klv/klv_0601.h>
+#include <arrows/klv/klv_data.h>
+#include <arrows/klv/klv_parse.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace kwiver::arrows::klv;
+
+// ----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
+
+namespace {
+
+typedef std::vector< uint8_t > bytes_t;
+
+// ----------------------------------------------------------------------------
+// The example UAS Datalink Local Set packet from MISB ST 0601, with 26
+// items and a long form (0x81) length of 145 bytes.
+bytes_t const st0601_packet = {
+  0x06, 0x0E, 0x2B, 0x34, 0x02, 0x0B, 0x01, 0x01,
+  0x0E, 0x01, 0x03, 0x01, 0x01, 0x00, 0x00, 0x00,
+  0x81, 0x91,
+  0x02, 0x08, 0x00, 0x04, 0x6C, 0x8E, 0x20, 0x03, 0x83, 0x85,
+  0x41, 0x01, 0x01,
+  0x05, 0x02, 0x3D, 0x3B,
+  0x06, 0x02, 0x15, 0x80,
+  0x07, 0x02, 0x01, 0x52,
+  0x0B, 0x03, 0x45, 0x4F, 0x4E,
+  0x0C, 0x0E, 0x47, 0x65, 0x6F, 0x64, 0x65, 0x74, 0x69, 0x63, 0x20,
+              0x57, 0x47, 0x53, 0x38, 0x34,
+  0x0D, 0x04, 0x4D, 0xC4, 0xDC, 0xBB,
+  0x0E, 0x04, 0xB1, 0xA8, 0x6C, 0xFE,
+  0x0F, 0x02, 0x1F, 0x4A,
+  0x10, 0x02, 0x00, 0x85,
+  0x11, 0x02, 0x00, 0x4B,
+  0x12, 0x04, 0x20, 0xC8, 0xD2, 0x7D,
+  0x13, 0x04, 0xFC, 0xDD, 0x02, 0xD8,
+  0x14, 0x04, 0xFE, 0xB8, 0xCB, 0x61,
+  0x15, 0x04, 0x00, 0x8F, 0x3E, 0x61,
+  0x16, 0x04, 0x00, 0x00, 0x01, 0xC9,
+  0x17, 0x04, 0x4D, 0xDD, 0x8C, 0x2A,
+  0x18, 0x04, 0xB1, 0xBE, 0x9E, 0xF4,
+  0x19, 0x02, 0x0B, 0x85,
+  0x28, 0x04, 0x4D, 0xDD, 0x8C, 0x2A,
+  0x29, 0x04, 0xB1, 0xBE, 0x9E, 0xF4,
+  0x2A, 0x02, 0x0B, 0x85,
+  0x38, 0x01, 0x2E,
+  0x39, 0x04, 0x00, 0x8D, 0xD4, 0x29,
+  0x01, 0x02, 0x1C, 0x5F };
+
+// Bytes which are not part of any packet, including a partial key prefix
+bytes_t const garbage = { 0x00, 0xFF, 0x06, 0x0E, 0x2B, 0x00, 0x34, 0x06 };
+
+// A valid single item key
+bytes_t const item_key = {
+  0x06, 0x0E, 0x2B, 0x34, 0x01, 0x01, 0x01, 0x01,
+  0x0E, 0x01, 0x01, 0x02, 0x01, 0x01, 0x00, 0x00 };
+
+// ----------------------------------------------------------------------------
+bytes_t
+concat( std::vector< bytes_t > const& parts )
+{
+  bytes_t result;
+  for ( auto const& part : parts )
+  {
+    result.insert( result.end(), part.begin(), part.end() );
+  }
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+// A packet with the given key and value, using a long form length of
+// length_bytes bytes, or the short form if length_bytes is 0
+bytes_t
+make_packet( bytes_t const& key, bytes_t const& value, int length_bytes = 0 )
+{
+  bytes_t packet = key;
+  if ( length_bytes == 0 )
+  {
+    packet.push_back( static_cast< uint8_t >( value.size() ) );
+  }
+  else
+  {
+    packet.push_back( static_cast< uint8_t >( 0x80 | length_bytes ) );
+    for ( int i = length_bytes - 1; i >= 0; --i )
+    {
+      packet.push_back( static_cast< uint8_t >( value.size() >> ( 8 * i ) ) );
+    }
+  }
+  packet.insert( packet.end(), value.begin(), value.end() );
+  return packet;
+}
+
+// ----------------------------------------------------------------------------
+bytes_t
+key_bytes( klv_uds_key const& key )
+{
+  bytes_t result;
+  for ( unsigned i = 0; i < klv_uds_key::size(); ++i )
+  {
+    result.push_back( key[ i ] );
+  }
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+bytes_t
+packet_bytes( klv_packet_view const& packet )
+{
+  return bytes_t( packet.klv_begin(), packet.klv_end() );
+}
+
+// ----------------------------------------------------------------------------
+bytes_t
+packet_bytes( klv_data const& packet )
+{
+  return bytes_t( packet.klv_begin(), packet.klv_end() );
+}
+
+// ----------------------------------------------------------------------------
+// The BER length decoding of the copying parser, which the tests below
+// compare the current parser against
+bool
+reference_ber_length( std::deque< uint8_t >::const_iterator buffer,
+                      size_t buffer_len, size_t& offset, size_t& value_len )
+{
+  if ( ! ( 0x80 & *buffer ) )
+  {
+    offset = 1;
+    value_len = *buffer;
+    return true;
+  }
+  offset = ( 0x7F & *buffer ) + 1;
+  if ( offset > 5 || offset > buffer_len )
+  {
+    return false;
+  }
+  value_len = 0;
+  for ( size_t i = 1; i < offset; ++i )
+  {
+    value_len = ( value_len << 8 ) + *( buffer + i );
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// The copying klv_pop_next_packet(), which removed one byte at a time
+// from the deque until a packet was found
+bool
+reference_pop_next_packet( std::deque< uint8_t >& data, bytes_t& packet )
+{
+  size_t const key_length = klv_uds_key::size();
+  while ( data.size() > key_length + 1 )
+  {
+    if ( data[ 0 ] == klv_uds_key::prefix[ 0 ] &&
+         data[ 1 ] == klv_uds_key::prefix[ 1 ] &&
+         data[ 2 ] == klv_uds_key::prefix[ 2 ] &&
+         data[ 3 ] == klv_uds_key::prefix[ 3 ] )
+    {
+      uint8_t temp[ 16 ];
+      std::copy( data.begin(), data.begin() + 16, temp );
+      klv_uds_key const key( temp );
+      if ( key.is_valid() )
+      {
+        if ( key.category() == klv_uds_key::CATEGORY_LABEL )
+        {
+          packet.assign( data.begin(), data.begin() + key_length );
+          data.erase( data.begin(), data.begin() + key_length );
+          return true;
+        }
+
+        size_t offset, length;
+        if ( reference_ber_length( data.begin() + key_length,
+                                   data.size() - key_length,
+                                   offset, length ) )
+        {
+          size_t const total_len = key_length + offset + length;
+          if ( data.size() >= total_len )
+          {
+            packet.assign( data.begin(), data.begin() + total_len );
+            data.erase( data.begin(), data.begin() + total_len );
+            return true;
+          }
+        }
+        break;
+      }
+    }
+    data.pop_front();
+  }
+  return false;
+}
+
+// ----------------------------------------------------------------------------
+// The copying parse_klv_lds(), over the value of a packet
+klv_lds_vector_t
+reference_parse_lds( bytes_t const& packet, size_t value_offset )
+{
+  std::deque< uint8_t > const value( packet.begin() + value_offset,
+                                     packet.end() );
+  klv_lds_vector_t lds_pairs;
+  size_t offset, value_len;
+  size_t len = value.size();
+  auto it = value.begin();
+  while ( len > 3 &&
+          reference_ber_length( it + 1, len - 1, offset, value_len ) &&
+          offset + 1 + value_len <= len )
+  {
+    lds_pairs.push_back(
+      klv_lds_pair( klv_lds_key( *it ),
+                    bytes_t( it + offset + 1, it + offset + 1 + value_len ) ) );
+    it += 1 + offset + value_len;
+    len -= 1 + offset + value_len;
+  }
+  return lds_pairs;
+}
+
+// ----------------------------------------------------------------------------
+// Packets found in a buffer by klv_next_packet()
+std::vector< bytes_t >
+next_packets( bytes_t const& buffer )
+{
+  std::vector< bytes_t > packets;
+  uint8_t const* data = buffer.data();
+  size_t size = buffer.size();
+  klv_packet_view packet;
+  while ( klv_next_packet( data, size, packet ) )
+  {
+    packets.push_back( packet_bytes( packet ) );
+  }
+  return packets;
+}
+
+} // end namespace
+
+// ----------------------------------------------------------------------------
+TEST(klv_parse, long_form_length)
+{
+  uint8_t const* data = st0601_packet.data();
+  size_t size = st0601_packet.size();
+  klv_packet_view packet;
+  ASSERT_TRUE( klv_next_packet( data, size, packet ) );
+
+  EXPECT_EQ( st0601_packet.data(), packet.klv_begin() );
+  EXPECT_EQ( 16, packet.key_size() );
+  EXPECT_EQ( 145, packet.value_size() );
+  EXPECT_EQ( st0601_packet.size(), packet.klv_size() );
+  EXPECT_EQ( st0601_packet.data() + 18, packet.value_begin() );
+  EXPECT_TRUE( is_klv_0601_key( packet.key() ) );
+  EXPECT_TRUE( klv_0601_checksum( packet ) );
+
+  // the whole buffer was consumed
+  EXPECT_EQ( 0, size );
+  EXPECT_EQ( st0601_packet.data() + st0601_packet.size(), data );
+
+  // lengths of two to four bytes
+  bytes_t const value( 300, 0x5A );
+  for ( int length_bytes = 2; length_bytes <= 4; ++length_bytes )
+  {
+    auto const buffer = make_packet( item_key, value, length_bytes );
+    data = buffer.data();
+    size = buffer.size();
+    ASSERT_TRUE( klv_next_packet( data, size, packet ) );
+    EXPECT_EQ( 17 + length_bytes, packet.value_begin() - packet.klv_begin() );
+    EXPECT_EQ( value, bytes_t( packet.value_begin(), packet.value_end() ) );
+  }
+}
+
+// ----------------------------------------------------------------------------
+TEST(klv_parse, resync_after_garbage)
+{
+  auto const second = make_packet( item_key, { 1, 2, 3 } );
+  auto const buffer = concat( { garbage, st0601_packet, garbage, second } );
+
+  uint8_t const* data = buffer.data();
+  size_t size = buffer.size();
+  klv_packet_view packet;
+
+  ASSERT_TRUE( klv_next_packet( data, size, packet ) );
+  EXPECT_EQ( buffer.data() + garbage.size(), packet.klv_begin() );
+  EXPECT_EQ( st0601_packet, packet_bytes( packet ) );
+
+  ASSERT_TRUE( klv_next_packet( data, size, packet ) );
+  EXPECT_EQ( second, packet_bytes( packet ) );
+
+  EXPECT_FALSE( klv_next_packet( data, size, packet ) );
+  EXPECT_EQ( 0, size );
+
+  // garbage is discarded up to the last few bytes, which could still be
+  // the start of a key
+  bytes_t const noise( 100, 0xFF );
+  data = noise.data();
+  size = noise.size();
+  EXPECT_FALSE( klv_next_packet( data, size, packet ) );
+  EXPECT_EQ( klv_uds_key::size() + 1, size );
+  EXPECT_EQ( noise.data() + noise.size() - size, data );
+}
+
+// ----------------------------------------------------------------------------
+TEST(klv_parse, truncated_ber_length)
+{
+  // a long form length of two bytes, with only one present
+  auto const full = make_packet( item_key, bytes_t( 300, 0x11 ), 2 );
+  bytes_t const truncated( full.begin(), full.begin() + 18 );
+
+  uint8_t const* data = truncated.data();
+  size_t size = truncated.size();
+  klv_packet_view packet;
+  EXPECT_FALSE( klv_next_packet( data, size, packet ) );
+
+  // the partial packet is kept so that it can be completed
+  EXPECT_EQ( truncated.data(), data );
+  EXPECT_EQ( truncated.size(), size );
+
+  std::deque< uint8_t > stream( truncated.begin(), truncated.end() );
+  klv_data klv_packet;
+  EXPECT_FALSE( klv_pop_next_packet( stream, klv_packet ) );
+  EXPECT_EQ( truncated.size(), stream.size() );
+
+  // lengths of more than four bytes are not accepted
+  auto too_long = item_key;
+  too_long.insert( too_long.end(), { 0x85, 0, 0, 0, 0, 1, 0xAA } );
+  data = too_long.data();
+  size = too_long.size();
+  EXPECT_FALSE( klv_next_packet( data, size, packet ) );
+
+  // a complete length with the value missing is also kept
+  bytes_t const short_value( full.begin(), full.end() - 1 );
+  data = short_value.data();
+  size = short_value.size();
+  EXPECT_FALSE( klv_next_packet( data, size, packet ) );
+  EXPECT_EQ( short_value.size(), size );
+}
+
+// ----------------------------------------------------------------------------
+TEST(klv_parse, split_across_buffers)
+{
+  auto const stream_bytes = concat( { garbage, st0601_packet, garbage } );
+
+  // feed the stream in small pieces, parsing after each one as a reader
+  // of a transport stream would
+  for ( size_t chunk : { 1, 5, 17, 64 } )
+  {
+    std::deque< uint8_t > stream;
+    bytes_t pending;
+    std::vector< bytes_t > popped;
+    std::vector< bytes_t > viewed;
+    for ( size_t start = 0; start < stream_bytes.size(); start += chunk )
+    {
+      auto const end = std::min( start + chunk, stream_bytes.size() );
+      stream.insert( stream.end(),
+                     stream_bytes.begin() + start, stream_bytes.begin() + end );
+      pending.insert( pending.end(),
+                      stream_bytes.begin() + start, stream_bytes.begin() + end );
+
+      klv_data klv_packet;
+      while ( klv_pop_next_packet( stream, klv_packet ) )
+      {
+        popped.push_back( packet_bytes( klv_packet ) );
+      }
+
+      uint8_t const* data = pending.data();
+      size_t size = pending.size();
+      klv_packet_view packet;
+      while ( klv_next_packet( data, size, packet ) )
+      {
+        viewed.push_back( packet_bytes( packet ) );
+      }
+      pending.erase( pending.begin(),
+                     pending.begin() + ( data - pending.data() ) );
+    }
+
+    ASSERT_EQ( 1, popped.size() ) << "chunk size " << chunk;
+    EXPECT_EQ( st0601_packet, popped[ 0 ] );
+    ASSERT_EQ( 1, viewed.size() ) << "chunk size " << chunk;
+    EXPECT_EQ( st0601_packet, viewed[ 0 ] );
+  }
+}
+
+// ----------------------------------------------------------------------------
+TEST(klv_parse, lds_iteration)
+{
+  uint8_t const* data = st0601_packet.data();
+  size_t size = st0601_packet.size();
+  klv_packet_view packet;
+  ASSERT_TRUE( klv_next_packet( data, size, packet ) );
+
+  std::vector< int > keys;
+  klv_lds_cursor cursor( packet.value_begin(), packet.value_size() );
+  while ( cursor.next() )
+  {
+    keys.push_back( cursor.key() );
+    if ( cursor.key() == 0x0B )
+    {
+      EXPECT_EQ( "EON", std::string( cursor.value(),
+                                     cursor.value() + cursor.value_size() ) );
+    }
+  }
+  EXPECT_EQ( 0, cursor.remaining() );
+  ASSERT_EQ( 26, keys.size() );
+  EXPECT_EQ( 0x02, keys.front() );
+  EXPECT_EQ( 0x01, keys.back() );
+
+  auto const lds = parse_klv_lds( packet );
+  ASSERT_EQ( 26, lds.size() );
+  EXPECT_EQ( ( bytes_t{ 0x1C, 0x5F } ), lds.back().second );
+
+  // an item whose length runs past the end of the set stops iteration
+  bytes_t const bad_set = { 0x02, 0x01, 0xAA, 0x03, 0x05, 0x01, 0x02, 0x03 };
+  klv_lds_cursor bad_cursor( bad_set.data(), bad_set.size() );
+  EXPECT_TRUE( bad_cursor.next() );
+  EXPECT_EQ( 0x02, bad_cursor.key() );
+  EXPECT_FALSE( bad_cursor.next() );
+  EXPECT_EQ( 5, bad_cursor.remaining() );
+}
+
+// ----------------------------------------------------------------------------
+TEST(klv_parse, uds_iteration)
+{
+  bytes_t const first_value = { 1, 2, 3, 4 };
+  bytes_t const second_value( 200, 0x33 );
+  auto const items = concat( { make_packet( item_key, first_value ),
+                               make_packet( item_key, second_value, 1 ) } );
+  klv_uds_key const set_key = klv_0104::key();
+  auto const set = make_packet( key_bytes( set_key ), items, 2 );
+
+  uint8_t const* data = set.data();
+  size_t size = set.size();
+  klv_packet_view packet;
+  ASSERT_TRUE( klv_next_packet( data, size, packet ) );
+  EXPECT_TRUE( klv_0104::is_key( packet.key() ) );
+
+  klv_uds_cursor cursor( packet.value_begin(), packet.value_size() );
+  ASSERT_TRUE( cursor.next() );
+  EXPECT_EQ( item_key, key_bytes( cursor.key() ) );
+  EXPECT_EQ( first_value,
+             bytes_t( cursor.value(), cursor.value() + cursor.value_size() ) );
+  ASSERT_TRUE( cursor.next() );
+  EXPECT_EQ( second_value,
+             bytes_t( cursor.value(), cursor.value() + cursor.value_size() ) );
+  EXPECT_FALSE( cursor.next() );
+
+  auto const uds = parse_klv_uds( packet );
+  ASSERT_EQ( 2, uds.size() );
+  EXPECT_EQ( first_value, uds[ 0 ].second );
+  EXPECT_EQ( second_value, uds[ 1 ].second );
+}
+
+// ----------------------------------------------------------------------------
+TEST(klv_parse, matches_copying_parser)
+{
+  auto const small = make_packet( item_key, { 9, 8, 7 } );
+  auto const large = make_packet( item_key, bytes_t( 1000, 0x42 ), 3 );
+  auto const stream_bytes =
+    concat( { garbage, st0601_packet, small, garbage, large,
+              st0601_packet, garbage } );
+
+  std::deque< uint8_t > reference_stream( stream_bytes.begin(),
+                                          stream_bytes.end() );
+  std::vector< bytes_t > reference;
+  bytes_t reference_packet;
+  while ( reference_pop_next_packet( reference_stream, reference_packet ) )
+  {
+    reference.push_back( reference_packet );
+  }
+  ASSERT_EQ( 4, reference.size() );
+
+  // the view based parser
+  EXPECT_EQ( reference, next_packets( stream_bytes ) );
+
+  // the deque interface, which now shares the scanner
+  std::deque< uint8_t > stream( stream_bytes.begin(), stream_bytes.end() );
+  std::vector< bytes_t > popped;
+  klv_data klv_packet;
+  while ( klv_pop_next_packet( stream, klv_packet ) )
+  {
+    popped.push_back( packet_bytes( klv_packet ) );
+  }
+  EXPECT_EQ( reference, popped );
+  EXPECT_EQ( reference_stream.size(), stream.size() );
+
+  // LDS items of the 0601 packet match those of a copy of it
+  uint8_t const* data = st0601_packet.data();
+  size_t size = st0601_packet.size();
+  klv_packet_view view;
+  ASSERT_TRUE( klv_next_packet( data, size, view ) );
+  auto const expected_lds = reference_parse_lds( st0601_packet, 18 );
+  ASSERT_EQ( 26, expected_lds.size() );
+  EXPECT_EQ( expected_lds, parse_klv_lds( view ) );
+
+  klv_data const copy = view.to_klv_data();
+  EXPECT_EQ( st0601_packet, packet_bytes( copy ) );
+  EXPECT_EQ( expected_lds, parse_klv_lds( copy ) );
+}
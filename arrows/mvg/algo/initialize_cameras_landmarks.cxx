@@ -16,10 +16,13 @@
 #include <Eigen/StdVector>
 #include <fstream>
 #include <ctime>
+#include <mutex>
 
 #include <vital/exceptions.h>
 #include <vital/io/eigen_io.h>
 #include <vital/math_constants.h>
+#include <vital/util/algorithm_pool.h>
+#include <vital/util/parallel_chunks.h>
 #include <vital/vital_config.h>
 
 #include <vital/algo/bundle_adjust.h>
@@ -193,7 +196,9 @@ class initialize_cameras_landmarks::priv
 
   rel_pose
   calc_rel_pose(frame_id_t frame_0, frame_id_t frame_1,
-    const std::vector<track_sptr>& trks) const;
+    const std::vector<track_sptr>& trks,
+    vital::algo::estimate_essential_matrix_sptr const& estimator,
+    vital::algo::triangulate_landmarks_sptr const& triangulator) const;
 
   bool write_rel_poses(std::string file_path) const;
 
@@ -215,6 +220,15 @@ class initialize_cameras_landmarks::priv
     unsigned int min_inlier_observations = 2,
     double inlier_threshold = 0.0) const;
 
+  /// Re-triangulate all landmarks for provided tracks with \p triangulator
+  void retriangulate(vital::algo::triangulate_landmarks_sptr const& triangulator,
+    landmark_map::map_landmark_t& lms,
+    simple_camera_perspective_map_sptr cams,
+    const std::vector<track_sptr>& trks,
+    std::set<landmark_id_t>& inlier_lm_ids,
+    unsigned int min_inlier_observations = 2,
+    double inlier_threshold = 0.0) const;
+
   void triangulate_landmarks_visible_in_frames(
     landmark_map::map_landmark_t& lmks,
     simple_camera_perspective_map_sptr cams,
@@ -382,8 +396,12 @@ class initialize_cameras_landmarks::priv
   std::set<frame_id_t> m_frames_removed_from_sfm_solution;
   vital::track_map_t m_track_map;
 
-  // random-number engine used (Mersenne-Twister in this case)
-  std::mt19937 m_rng{std::random_device{}()};
+  // random-number engine used (Mersenne-Twister in this case), with the
+  // default seed so that reconstructions are repeatable
+  std::mt19937 m_rng;
+
+  // serializes use of the bundle adjuster, which need not be re-entrant
+  mutable std::mutex m_ba_mutex;
 
   double m_reverse_ba_error_ratio = 0.0;
   bool m_solution_was_fit_to_constraints = false;
@@ -550,6 +568,21 @@ ::retriangulate(landmark_map::map_landmark_t& lms,
   std::set<landmark_id_t>& inlier_lm_ids,
   unsigned int min_inlier_observations,
   double inlier_threshold) const
+{
+  retriangulate(lm_triangulator, lms, cams, trks, inlier_lm_ids,
+                min_inlier_observations, inlier_threshold);
+}
+
+/// Re-triangulate all landmarks for provided tracks with \p triangulator
+void
+initialize_cameras_landmarks::priv
+::retriangulate(vital::algo::triangulate_landmarks_sptr const& triangulator,
+  landmark_map::map_landmark_t& lms,
+  simple_camera_perspective_map_sptr cams,
+  const std::vector<track_sptr>& trks,
+  std::set<landmark_id_t>& inlier_lm_ids,
+  unsigned int min_inlier_observations,
+  double inlier_threshold) const
 {
   typedef landmark_map::map_landmark_t lm_map_t;
   lm_map_t init_lms;
@@ -569,24 +602,24 @@ ::retriangulate(landmark_map::map_landmark_t& lms,
     }
   }
 
-  auto triang_config = lm_triangulator->get_configuration();
+  auto triang_config = triangulator->get_configuration();
   double triang_thresh_orig = triang_config->get_value<double>("inlier_threshold_pixels", 2.0);
   if (inlier_threshold > 0.0)
   {
     triang_config->set_value<double>("inlier_threshold_pixels",
                                      inlier_threshold);
-    lm_triangulator->set_configuration(triang_config);
+    triangulator->set_configuration(triang_config);
   }
 
   landmark_map_sptr lm_map = std::make_shared<simple_landmark_map>(init_lms);
   auto tracks = std::make_shared<feature_track_set>(trks);
-  this->lm_triangulator->triangulate(cams, tracks, lm_map);
+  triangulator->triangulate(cams, tracks, lm_map);
 
   if (inlier_threshold > 0.0)
   {
     triang_config->set_value<double>("inlier_threshold_pixels",
                                      triang_thresh_orig);
-    lm_triangulator->set_configuration(triang_config);
+    triangulator->set_configuration(triang_config);
   }
 
   inlier_lm_ids.clear();
@@ -773,10 +806,9 @@ ::down_select_landmarks(
     lm_to_downsample.push_back(t);
   }
 
-  // Will be used to obtain a seed for the random number engine
-  std::random_device rd;
-  // Standard mersenne_twister_engine seeded with rd()
-  std::mt19937 gen(rd());
+  // Standard mersenne_twister_engine with its default seed so that the
+  // selection is repeatable
+  std::mt19937 gen;
   const int good_enough_size = 10;
   std::uniform_int_distribution<> dis(2, good_enough_size);
 
@@ -788,10 +820,9 @@ ::down_select_landmarks(
     auto &t1 = lm_to_downsample.back();
     for(int ns = 0; ns < 20; ++ns)
     {
-      int rand_idx = std::min<int>(static_cast<int>(
-                                     (double(std::rand()) / double(RAND_MAX)) *
-                                     lm_to_downsample.size()),
-                                   static_cast<int>(lm_to_downsample.size()) - 1);
+      std::uniform_int_distribution<size_t> idx_dis(
+        0, lm_to_downsample.size() - 1);
+      auto rand_idx = idx_dis(gen);
       t1 = lm_to_downsample[rand_idx];
       int length_thresh = dis(gen);
       int t1_effective_len = std::min<int>(static_cast<int>(t1->size()),
@@ -841,7 +872,9 @@ ::down_select_landmarks(
 rel_pose
 initialize_cameras_landmarks::priv
 ::calc_rel_pose(frame_id_t frame_0, frame_id_t frame_1,
-  const std::vector<track_sptr>& trks) const
+  const std::vector<track_sptr>& trks,
+  vital::algo::estimate_essential_matrix_sptr const& estimator,
+  vital::algo::triangulate_landmarks_sptr const& triangulator) const
 {
   // extract coresponding image points and landmarks
   std::vector<vector_2d> pts_right, pts_left;
@@ -876,7 +909,7 @@ ::calc_rel_pose(frame_id_t frame_0, frame_id_t frame_1,
   }
 
   std::vector<bool> inliers;
-  essential_matrix_sptr E_sptr = e_estimator->estimate(pts_right, pts_left,
+  essential_matrix_sptr E_sptr = estimator->estimate(pts_right, pts_left,
     cal_right, cal_left,
     inliers, interim_reproj_thresh);
   const essential_matrix_d E(*E_sptr);
@@ -920,22 +953,22 @@ ::calc_rel_pose(frame_id_t frame_0, frame_id_t frame_1,
   auto trk_set = std::make_shared<feature_track_set>(trks);
 
   std::set<frame_id_t> inlier_lm_ids;
-  retriangulate(lms, cam_map, trks, inlier_lm_ids);
+  retriangulate(triangulator, lms, cam_map, trks, inlier_lm_ids);
   size_t inlier_count_prev = 0;
 
   // optimizing loop
   while (inlier_lm_ids.size() > inlier_count_prev)
   {
     inlier_count_prev = inlier_lm_ids.size();
-#pragma omp critical
     {
+      std::lock_guard<std::mutex> lock(m_ba_mutex);
       std::set<frame_id_t> empty_fixed_cams;
       std::set<landmark_id_t> empty_fixed_lms;
       global_bundle_adjuster->optimize(*cam_map, lms, trk_set,
                                        empty_fixed_cams, empty_fixed_lms);
     }
     inlier_lm_ids.clear();
-    retriangulate(lms, cam_map, trks, inlier_lm_ids);
+    retriangulate(triangulator, lms, cam_map, trks, inlier_lm_ids);
   }
 
   rel_pose rp;
@@ -1016,6 +1049,23 @@ ::calc_rel_poses(
 
   unsigned frames_skip = std::max(1u, static_cast<unsigned>(frames.size() / 2));
 
+  // The pairs are estimated concurrently and the estimator and triangulator
+  // need not be re-entrant, so each task uses its own copy of them.  If a
+  // copy can not be created (e.g. the implementation is not a registered
+  // plugin) the task uses the shared instances one at a time instead.
+  std::string const e_name = "essential_mat_estimator";
+  std::string const triang_name = "lm_triangulator";
+  auto pool_config = vital::config_block::empty_config();
+  vital::algo::estimate_essential_matrix
+    ::get_nested_algo_configuration(e_name, pool_config, e_estimator);
+  vital::algo::triangulate_landmarks
+    ::get_nested_algo_configuration(triang_name, pool_config, lm_triangulator);
+  vital::algorithm_pool<vital::algo::estimate_essential_matrix> e_estimators;
+  vital::algorithm_pool<vital::algo::triangulate_landmarks> triangulators;
+  e_estimators.configure(e_name, pool_config);
+  triangulators.configure(triang_name, pool_config);
+  std::mutex shared_algo_mutex;
+
   do {
     std::vector<frame_id_t> kf_mm_frames;
     unsigned fid_idx = 0;
@@ -1059,10 +1109,13 @@ ::calc_rel_poses(
       }
     }
 
-#pragma omp parallel for schedule(dynamic, 10)
-    for (int64_t i = 0; i < static_cast<int64_t>(pairs_to_process.size()); ++i)
+    // Each pair is estimated independently on the thread pool.  The common
+    // tracks are found up front because track set queries may build indices
+    // on demand and are not safe to call concurrently.
+    std::vector<std::vector<track_sptr>> pair_tracks;
+    pair_tracks.reserve(pairs_to_process.size());
+    for (auto const& tp : pairs_to_process)
     {
-      const auto &tp = pairs_to_process[i];
       auto fid_0 = tp.first;
       auto fid_1 = tp.second;
       auto tks0 = tracks->active_tracks(fid_0);
@@ -1074,15 +1127,46 @@ ::calc_rel_poses(
                             tks1.begin(), tks1.end(),
                             std::back_inserter(tks_01));
 
-      // ok now we have the common tracks between the two frames.
-      // make the essential matrix, decompose it and store it in a relative pose
-      rel_pose rp = calc_rel_pose(fid_0, fid_1, tks_01);
-#pragma omp critical
+      pair_tracks.push_back(std::move(tks_01));
+    }
+
+    // ok now we have the common tracks between the two frames.
+    // make the essential matrix, decompose it and store it in a relative pose
+    std::vector<rel_pose> poses(pairs_to_process.size());
+    vital::parallel_chunks(pairs_to_process.size(), 1,
+      [&](size_t begin, size_t end)
       {
-        if (rp.well_conditioned_landmark_count > 100)
+        auto estimator = e_estimators.acquire();
+        auto triangulator = triangulators.acquire();
+        std::unique_lock<std::mutex> lock(shared_algo_mutex, std::defer_lock);
+        if (!estimator || !triangulator)
         {
-          m_rel_poses.insert(rp);
+          lock.lock();
+          e_estimators.release(estimator);
+          triangulators.release(triangulator);
+          estimator = e_estimator;
+          triangulator = lm_triangulator;
         }
+        for (size_t i = begin; i < end; ++i)
+        {
+          poses[i] = calc_rel_pose(pairs_to_process[i].first,
+                                   pairs_to_process[i].second,
+                                   pair_tracks[i], estimator, triangulator);
+        }
+        if (!lock.owns_lock())
+        {
+          e_estimators.release(estimator);
+          triangulators.release(triangulator);
+        }
+      });
+
+    // collect the results in pair order so the outcome does not depend on
+    // which pair finishes first
+    for (auto const& rp : poses)
+    {
+      if (rp.well_conditioned_landmark_count > 100)
+      {
+        m_rel_poses.insert(rp);
       }
     }
 
@@ -1181,9 +1265,11 @@ ::select_next_camera(
     // We can't use the relative pose scores any more to do the selection.
     // Score each remaining camera accordint to how far it is temporally from
     // the reconstructed cameras and how many 3D landmarks it sees.
-    long best_score = -1;
-
-    for (auto rc : frames_to_resection)
+    // The candidates are scored in parallel.  Their tracks are looked up
+    // first because track set queries may build indices on demand and are
+    // not safe to call concurrently.
+    auto const score_candidate =
+      [&](frame_id_t rc, std::set<track_id_t> const& rc_tracks_ids) -> long
     {
       auto closest_frame_diff = std::numeric_limits<frame_id_t>::max();
       for (auto c : reconstructed_cam_ids)
@@ -1199,10 +1285,9 @@ ::select_next_camera(
       {
         // reconstruction has not successfully included a camera spaced out
         // much more than max_existing_spacing so don't try this one.
-        continue;
+        return -1;
       }
 
-      auto rc_tracks_ids = tracks->active_track_ids(rc);
       std::vector<landmark_id_t> intersect_lmks;
       std::set_intersection(currently_reconstructed_landmarks.begin(),
                             currently_reconstructed_landmarks.end(),
@@ -1213,15 +1298,41 @@ ::select_next_camera(
       {
         // without enough landmarks in common
         // there is no reason to try this frame
-        continue;
+        return -1;
       }
-      long score = static_cast<long>(intersect_lmks.size() * closest_frame_diff);
-      if (score > best_score)
+
+      return static_cast<long>(intersect_lmks.size() * closest_frame_diff);
+    };
+
+    std::vector<frame_id_t> candidates(frames_to_resection.begin(),
+                                       frames_to_resection.end());
+    std::vector<std::set<track_id_t>> candidate_track_ids;
+    candidate_track_ids.reserve(candidates.size());
+    for (auto rc : candidates)
+    {
+      candidate_track_ids.push_back(tracks->active_track_ids(rc));
+    }
+
+    std::vector<long> scores(candidates.size(), -1);
+    vital::parallel_chunks(candidates.size(), 16,
+      [&](size_t begin, size_t end)
       {
-        best_score = score;
-        selected_frame = rc;
-      }
+        for (size_t i = begin; i < end; ++i)
+        {
+          scores[i] = score_candidate(candidates[i], candidate_track_ids[i]);
+        }
+      });
 
+    // pick the best candidate in frame order so that ties are broken as
+    // in a serial search
+    long best_score = -1;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+      if (scores[i] > best_score)
+      {
+        best_score = scores[i];
+        selected_frame = candidates[i];
+      }
     }
 
   }
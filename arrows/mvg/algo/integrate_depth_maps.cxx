@@ -8,10 +8,12 @@
 */
 
 #include <arrows/mvg/algo/integrate_depth_maps.h>
+#include <arrows/mvg/sparse_tsdf_volume.h>
 #include <arrows/core/depth_utils.h>
 
 #include <vital/util/transform_image.h>
 
+#include <limits>
 #include <sstream>
 
 using namespace kwiver::vital;
@@ -33,6 +35,8 @@ class integrate_depth_maps::priv
       ray_potential_delta(10.0),
       grid_spacing {1.0, 1.0, 1.0},
       voxel_spacing_factor(1.0),
+      sparse(false),
+      sparse_unknown_nan(false),
       m_logger(vital::get_logger("arrows.mvg.integrate_depth_maps"))
   {
   }
@@ -84,6 +88,12 @@ class integrate_depth_maps::priv
   // multiplier on all dimensions of grid spacing
   double voxel_spacing_factor;
 
+  // integrate only into blocks of voxels near the depth map surfaces
+  bool sparse;
+
+  // mark voxels in unallocated blocks unknown with NaN instead of zero
+  bool sparse_unknown_nan;
+
   double const_thickness;
   double const_delta;
   double const_slope;
@@ -310,6 +320,18 @@ integrate_depth_maps::get_configuration() const
   config->set_value("voxel_spacing_factor", d_->voxel_spacing_factor,
                     "Multiplier on voxel spacing.  Set to 1.0 for voxel "
                     "sizes that project to 1 pixel on average.");
+  config->set_value("sparse", d_->sparse,
+                    "Integrate only into blocks of voxels within "
+                    "ray_potential_delta of some depth map surface, storing "
+                    "them sparsely.  This uses far less memory for large "
+                    "scenes.  Voxels far from all surfaces are zero rather "
+                    "than holding free space or occluded values.");
+  config->set_value("sparse_unknown_nan", d_->sparse_unknown_nan,
+                    "With sparse integration, give voxels far from all "
+                    "surfaces the value NaN instead of zero.  Zero is the "
+                    "level of the surface, so these voxels can form "
+                    "spurious surfaces next to free space; NaN marks them "
+                    "as unknown for consumers which check for it.");
 
   std::ostringstream stream;
   stream << d_->grid_spacing[0] << " "
@@ -346,6 +368,9 @@ integrate_depth_maps::set_configuration(vital::config_block_sptr in_config)
     config->get_value<double>("ray_potential_delta", d_->ray_potential_delta);
   d_->voxel_spacing_factor =
     config->get_value<double>("voxel_spacing_factor", d_->voxel_spacing_factor);
+  d_->sparse = config->get_value<bool>("sparse", d_->sparse);
+  d_->sparse_unknown_nan =
+    config->get_value<bool>("sparse_unknown_nan", d_->sparse_unknown_nan);
 
   std::ostringstream ostream;
   ostream << d_->grid_spacing[0] << " "
@@ -368,6 +393,34 @@ integrate_depth_maps::check_configuration(vital::config_block_sptr) const
 
 // ----------------------------------------------------------------------------
 
+namespace {
+
+// Get depth map i as a double image, and its weight map if it has one of
+// the same size
+void
+get_depth_map(std::vector<image_container_sptr> const& depth_maps,
+              std::vector<image_container_sptr> const& weight_maps,
+              size_t i,
+              image_of<double>& depth,
+              image_of<double>& weight)
+{
+  depth = image_of<double>(depth_maps[i]->get_image());
+  weight = image_of<double>();
+  if (i < weight_maps.size())
+  {
+    auto const& w = weight_maps[i];
+    if (w && w->width() == depth.width() &&
+        w->height() == depth.height())
+    {
+      weight = w->get_image();
+    }
+  }
+}
+
+} // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
 void
 integrate_depth_maps::integrate(
   vector_3d const& minpt_bound,
@@ -409,6 +462,49 @@ integrate_depth_maps::integrate(
                        << " "   << d_->grid_dims[1]
                        << " "   << d_->grid_dims[2] );
 
+  if (d_->sparse)
+  {
+    tsdf_potential const potential = { d_->ray_potential_rho,
+                                       d_->const_thickness,
+                                       d_->const_delta,
+                                       d_->const_freespace_val,
+                                       d_->const_occluded_val };
+    auto sparse_volume = std::make_shared<sparse_tsdf_volume>(
+      orig, spacing,
+      Eigen::Vector3i(d_->grid_dims[0], d_->grid_dims[1], d_->grid_dims[2]),
+      potential,
+      d_->sparse_unknown_nan ? std::numeric_limits<float>::quiet_NaN()
+                             : 0.0f);
+
+    // allocate for all depth maps first so that every depth map is
+    // integrated into every block
+    image_of<double> depth, weight;
+    for (size_t i = 0; i < depth_maps.size(); ++i)
+    {
+      if (i < cameras.size() && cameras[i])
+      {
+        get_depth_map(depth_maps, weight_maps, i, depth, weight);
+        sparse_volume->allocate(*cameras[i], depth, weight);
+      }
+    }
+    LOG_DEBUG( logger(), "allocated " << sparse_volume->num_blocks()
+                         << " voxel blocks" );
+
+    for (size_t i = 0; i < depth_maps.size(); ++i)
+    {
+      if (i < cameras.size() && cameras[i])
+      {
+        LOG_INFO( logger(), "depth map " << i );
+        get_depth_map(depth_maps, weight_maps, i, depth, weight);
+        sparse_volume->integrate(*cameras[i], depth, weight);
+      }
+    }
+
+    // the dense volume is only built if the caller asks for the image
+    volume = std::make_shared<sparse_tsdf_image_container>(sparse_volume);
+    return;
+  }
+
   LOG_INFO( logger(), "initialize volume" );
   image_of<double> voxel_grid;
   if (volume)
@@ -424,21 +520,12 @@ integrate_depth_maps::integrate(
 
   for (size_t i = 0; i < depth_maps.size(); ++i)
   {
-    image_of<double> depth{ depth_maps[i]->get_image() };
-    image_of<double> weight;
-    if (i < weight_maps.size())
-    {
-      auto const& w = weight_maps[i];
-      if (w->width() == depth.width() &&
-          w->height() == depth.height())
-      {
-        weight = weight_maps[i]->get_image();
-      }
-    }
     if (i >= cameras.size() || !cameras[i])
     {
       continue;
     }
+    image_of<double> depth, weight;
+    get_depth_map(depth_maps, weight_maps, i, depth, weight);
 
     // integrate depthms
     LOG_INFO( logger(), "depth map " << i );
@@ -0,0 +1,608 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Implementation of partitioned_bundle_adjust
+ */
+
+#include "partitioned_bundle_adjust.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include <vital/util/cpu_timer.h>
+#include <vital/util/parallel_chunks.h>
+
+#include <arrows/mvg/transform.h>
+
+#include <vital/types/camera_perspective.h>
+#include <vital/exceptions.h>
+#include <vital/vital_types.h>
+
+using namespace kwiver::vital;
+
+namespace kwiver {
+namespace arrows {
+namespace mvg {
+
+namespace // anonymous
+{
+
+// Landmarks observed by each camera and cameras observing each landmark,
+// restricted to the cameras and landmarks being optimized
+struct observation_index
+{
+  std::map<frame_id_t, std::vector<landmark_id_t> > frame_landmarks;
+  std::map<landmark_id_t, std::vector<frame_id_t> > landmark_frames;
+  std::map<landmark_id_t, track_sptr> tracks;
+};
+
+// One sub-problem: the cameras it owns, the extra cameras constraining its
+// border, and the landmarks observed by the cameras it owns
+struct submap
+{
+  std::set<frame_id_t> core;
+  std::set<frame_id_t> overlap;
+  std::set<landmark_id_t> landmarks;
+};
+
+// The optimized cameras and landmarks of one sub-problem
+struct submap_solution
+{
+  simple_camera_perspective_map cameras;
+  landmark_map::map_landmark_t landmarks;
+};
+
+// ----------------------------------------------------------------------------
+observation_index
+index_observations(camera_map::map_camera_t const& cameras,
+                   landmark_map::map_landmark_t const& landmarks,
+                   feature_track_set_sptr tracks)
+{
+  observation_index index;
+  for (auto const& trk : tracks->tracks())
+  {
+    auto const lm_id = static_cast<landmark_id_t>(trk->id());
+    if (landmarks.find(lm_id) == landmarks.end())
+    {
+      continue;
+    }
+    for (auto const& ts : *trk)
+    {
+      if (cameras.find(ts->frame()) != cameras.end())
+      {
+        index.frame_landmarks[ts->frame()].push_back(lm_id);
+        index.landmark_frames[lm_id].push_back(ts->frame());
+      }
+    }
+    if (index.landmark_frames.count(lm_id))
+    {
+      index.tracks[lm_id] = trk;
+    }
+  }
+  return index;
+}
+
+// ----------------------------------------------------------------------------
+// Split the observed cameras into connected regions of at most max_size
+/**
+ * Each region is grown from its lowest unassigned frame by repeatedly
+ * adding the unassigned camera sharing the most observations with the
+ * region, as long as it shares at least min_covisibility of them.
+ */
+std::vector<submap>
+partition_cameras(observation_index const& index,
+                  size_t max_size, unsigned min_covisibility)
+{
+  std::set<frame_id_t> unassigned;
+  for (auto const& p : index.frame_landmarks)
+  {
+    unassigned.insert(p.first);
+  }
+
+  std::vector<submap> submaps;
+  while (!unassigned.empty())
+  {
+    submap sm;
+    std::map<frame_id_t, unsigned> scores;
+
+    auto add_camera = [&](frame_id_t f)
+    {
+      sm.core.insert(f);
+      unassigned.erase(f);
+      scores.erase(f);
+      for (auto const lm_id : index.frame_landmarks.at(f))
+      {
+        sm.landmarks.insert(lm_id);
+        for (auto const g : index.landmark_frames.at(lm_id))
+        {
+          if (unassigned.count(g))
+          {
+            ++scores[g];
+          }
+        }
+      }
+    };
+
+    add_camera(*unassigned.begin());
+    while (sm.core.size() < max_size && !scores.empty())
+    {
+      // ties go to the lowest frame
+      auto const best = std::max_element(
+        scores.begin(), scores.end(),
+        [](std::pair<frame_id_t const, unsigned> const& a,
+           std::pair<frame_id_t const, unsigned> const& b)
+        { return a.second < b.second; });
+      if (best->second < min_covisibility)
+      {
+        break;
+      }
+      add_camera(best->first);
+    }
+    submaps.push_back(std::move(sm));
+  }
+  return submaps;
+}
+
+// ----------------------------------------------------------------------------
+// Add to the submap the cameras outside it observing the most of its landmarks
+void
+add_overlap(submap& sm, observation_index const& index,
+            size_t max_overlap, unsigned min_covisibility)
+{
+  std::map<frame_id_t, unsigned> scores;
+  for (auto const lm_id : sm.landmarks)
+  {
+    for (auto const f : index.landmark_frames.at(lm_id))
+    {
+      if (!sm.core.count(f))
+      {
+        ++scores[f];
+      }
+    }
+  }
+
+  std::vector<std::pair<unsigned, frame_id_t> > ranked;
+  for (auto const& p : scores)
+  {
+    if (p.second >= min_covisibility)
+    {
+      ranked.emplace_back(p.second, p.first);
+    }
+  }
+  std::sort(ranked.begin(), ranked.end(),
+            [](std::pair<unsigned, frame_id_t> const& a,
+               std::pair<unsigned, frame_id_t> const& b)
+            {
+              return a.first != b.first ? a.first > b.first
+                                        : a.second < b.second;
+            });
+  if (ranked.size() > max_overlap)
+  {
+    ranked.resize(max_overlap);
+  }
+  for (auto const& r : ranked)
+  {
+    sm.overlap.insert(r.second);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Similarity transform taking the points in from onto those in to
+/**
+ * Returns the identity when there are too few points to fit a transform.
+ */
+similarity_d
+fit_similarity(std::vector<vector_3d> const& from,
+               std::vector<vector_3d> const& to)
+{
+  if (from.size() < 3 || from.size() != to.size())
+  {
+    return similarity_d();
+  }
+
+  Eigen::Matrix<double, 3, Eigen::Dynamic> src(3, from.size());
+  Eigen::Matrix<double, 3, Eigen::Dynamic> dst(3, to.size());
+  for (size_t i = 0; i < from.size(); ++i)
+  {
+    src.col(i) = from[i];
+    dst.col(i) = to[i];
+  }
+  Eigen::Matrix4d const m = Eigen::umeyama(src, dst, true);
+  if (!m.allFinite())
+  {
+    return similarity_d();
+  }
+  return similarity_d(m);
+}
+
+// ----------------------------------------------------------------------------
+// Optimize a subset of the cameras and landmarks
+/**
+ * The inputs are cloned so that concurrent solves never share objects.
+ * The solution is mapped back into the coordinate frame of the input with
+ * a similarity transform fit to the fixed camera centers, if at least
+ * three cameras are fixed, or else to the landmarks.
+ */
+submap_solution
+solve_subproblem(algo::bundle_adjust_sptr ba,
+                 camera_map::map_camera_t const& all_cameras,
+                 landmark_map::map_landmark_t const& all_landmarks,
+                 observation_index const& index,
+                 std::set<frame_id_t> const& cameras,
+                 std::set<frame_id_t> const& fixed_cameras,
+                 std::set<landmark_id_t> const& landmarks,
+                 sfm_constraints_sptr constraints)
+{
+  submap_solution sol;
+  for (auto const f : cameras)
+  {
+    auto cam = std::dynamic_pointer_cast<simple_camera_perspective>(
+      all_cameras.at(f)->clone());
+    if (cam)
+    {
+      sol.cameras.insert(f, cam);
+    }
+  }
+  for (auto const lm_id : landmarks)
+  {
+    sol.landmarks[lm_id] = all_landmarks.at(lm_id)->clone();
+  }
+
+  std::vector<track_sptr> sub_tracks;
+  sub_tracks.reserve(landmarks.size());
+  for (auto const lm_id : landmarks)
+  {
+    sub_tracks.push_back(index.tracks.at(lm_id));
+  }
+  auto const sub_track_set = std::make_shared<feature_track_set>(sub_tracks);
+
+  // the fixed cameras, or else the landmarks, anchor the coordinate frame
+  auto const anchors = [&]()
+  {
+    std::vector<vector_3d> pts;
+    for (auto const f : fixed_cameras)
+    {
+      if (auto const cam = sol.cameras.find(f))
+      {
+        pts.push_back(cam->center());
+      }
+    }
+    if (pts.size() < 3)
+    {
+      pts.clear();
+      for (auto const& p : sol.landmarks)
+      {
+        pts.push_back(p.second->loc());
+      }
+    }
+    return pts;
+  };
+
+  auto const before = anchors();
+  ba->optimize(sol.cameras, sol.landmarks, sub_track_set,
+               fixed_cameras, std::set<landmark_id_t>(), constraints);
+  auto const after = anchors();
+
+  auto const xform = fit_similarity(after, before);
+  transform_inplace(sol.cameras, xform);
+  transform_inplace(sol.landmarks, xform);
+
+  return sol;
+}
+
+} // end anonymous namespace
+
+// ============================================================================
+// private implementation / data container for partitioned_bundle_adjust
+class partitioned_bundle_adjust::priv
+{
+public:
+  priv()
+    : max_submap_cameras(100)
+    , overlap_cameras(10)
+    , min_covisibility(10)
+    , separator_pass(true)
+  {
+  }
+
+  ~priv() { }
+
+  // create an independent instance of the nested bundle adjuster
+  vital::algo::bundle_adjust_sptr create_sba() const
+  {
+    vital::algo::bundle_adjust_sptr ba;
+    vital::algo::bundle_adjust::set_nested_algo_configuration(
+      "sba_impl", sba_config, ba);
+    return ba;
+  }
+
+  unsigned int max_submap_cameras;
+  unsigned int overlap_cameras;
+  unsigned int min_covisibility;
+  bool separator_pass;
+
+  // nested algorithm instance, used for reporting its configuration
+  vital::algo::bundle_adjust_sptr sba;
+
+  // configuration used to create one nested instance per submap, since
+  // bundle adjusters keep per-problem state and are not re-entrant
+  vital::config_block_sptr sba_config;
+};
+
+// ----------------------------------------------------------------------------
+// Constructor
+partitioned_bundle_adjust
+::partitioned_bundle_adjust()
+  : d_(new priv)
+{
+  attach_logger( "arrows.mvg.partitioned_bundle_adjust" );
+}
+
+// Destructor
+partitioned_bundle_adjust
+::~partitioned_bundle_adjust() noexcept
+{
+}
+
+// ----------------------------------------------------------------------------
+// Get this algorithm's \link kwiver::vital::config_block configuration block \endlink
+vital::config_block_sptr
+partitioned_bundle_adjust
+::get_configuration() const
+{
+  vital::config_block_sptr config = vital::algo::bundle_adjust::get_configuration();
+
+  config->set_value("max_submap_cameras", d_->max_submap_cameras,
+                    "Maximum number of cameras owned by each submap. "
+                    "Problems with no more cameras than this are passed "
+                    "directly to the nested algorithm.");
+
+  config->set_value("overlap_cameras", d_->overlap_cameras,
+                    "Number of cameras from outside each submap that are "
+                    "added to it to constrain its border. These cameras "
+                    "are optimized with the submap but their results are "
+                    "taken from the submap that owns them.");
+
+  config->set_value("min_covisibility", d_->min_covisibility,
+                    "Minimum number of landmark observations a camera must "
+                    "share with a submap to join it or its overlap.");
+
+  config->set_value("separator_pass", d_->separator_pass,
+                    "After merging the submaps, refine the cameras on submap "
+                    "boundaries and the landmarks they observe while holding "
+                    "the neighboring cameras fixed.");
+
+  vital::algo::bundle_adjust::get_nested_algo_configuration(
+      "sba_impl", config, d_->sba
+      );
+
+  return config;
+}
+
+// ----------------------------------------------------------------------------
+// Set this algorithm's properties via a config block
+void
+partitioned_bundle_adjust
+::set_configuration(vital::config_block_sptr config)
+{
+  d_->max_submap_cameras = config->get_value<unsigned int>("max_submap_cameras", d_->max_submap_cameras);
+  d_->overlap_cameras = config->get_value<unsigned int>("overlap_cameras", d_->overlap_cameras);
+  d_->min_covisibility = config->get_value<unsigned int>("min_covisibility", d_->min_covisibility);
+  d_->separator_pass = config->get_value<bool>("separator_pass", d_->separator_pass);
+
+  vital::algo::bundle_adjust::set_nested_algo_configuration(
+      "sba_impl", config, d_->sba
+      );
+
+  d_->sba_config = vital::config_block::empty_config();
+  d_->sba_config->merge_config(config);
+}
+
+// ----------------------------------------------------------------------------
+// Check that the algorithm's configuration vital::config_block is valid
+bool
+partitioned_bundle_adjust
+::check_configuration(vital::config_block_sptr config) const
+{
+  bool valid = true;
+
+  if (config->has_value("max_submap_cameras")
+      && config->get_value<long>("max_submap_cameras") < 2)
+  {
+    LOG_DEBUG(logger(), "Config Check Fail: \"max_submap_cameras\" must be "
+                        "at least 2. Given: "
+                        << config->get_value<long>("max_submap_cameras"));
+    valid = false;
+  }
+
+  if (!vital::algo::bundle_adjust::check_nested_algo_configuration("sba_impl", config))
+  {
+    LOG_DEBUG(logger(), "Config Check Fail: sba_impl configuration invalid.");
+    valid = false;
+  }
+
+  return valid;
+}
+
+// ----------------------------------------------------------------------------
+// Optimize the camera and landmark parameters given a set of feature tracks
+void
+partitioned_bundle_adjust
+::optimize(camera_map_sptr & cameras,
+           landmark_map_sptr & landmarks,
+           feature_track_set_sptr tracks,
+           sfm_constraints_sptr constraints) const
+{
+  if (!d_->sba)
+  {
+    VITAL_THROW( invalid_value, "No nested bundle adjustment algorithm (sba_impl) "
+                                "has been configured.");
+  }
+
+  if (!cameras || !landmarks || !tracks)
+  {
+    return;
+  }
+
+  // small problems are solved directly
+  if (cameras->size() <= d_->max_submap_cameras)
+  {
+    d_->sba->optimize(cameras, landmarks, tracks, constraints);
+    return;
+  }
+
+  auto const input_cams = cameras->cameras();
+  auto const input_lms = landmarks->landmarks();
+  auto const index = index_observations(input_cams, input_lms, tracks);
+
+  std::vector<submap> submaps;
+  { // scope block
+    kwiver::vital::scoped_cpu_timer t( "partitioning cameras" );
+    submaps = partition_cameras(index, d_->max_submap_cameras,
+                                d_->min_covisibility);
+    for (auto& sm : submaps)
+    {
+      add_overlap(sm, index, d_->overlap_cameras, d_->min_covisibility);
+    }
+  }
+  LOG_INFO(logger(), "Optimizing " << index.frame_landmarks.size()
+                     << " cameras in " << submaps.size() << " submaps");
+
+  // solve all submaps concurrently, each with its own nested instance; the
+  // calling thread solves submaps too, so this may itself run on the pool
+  std::vector<submap_solution> solutions(submaps.size());
+  { // scope block
+    kwiver::vital::scoped_cpu_timer t( "submap optimization" );
+    // the instances are created up front since creation goes through the
+    // shared configuration and plugin factory
+    std::vector<vital::algo::bundle_adjust_sptr> sbas;
+    for (size_t i = 0; i < submaps.size(); ++i)
+    {
+      sbas.push_back(d_->create_sba());
+    }
+    vital::parallel_chunks(submaps.size(), 1,
+      [&](size_t begin, size_t end)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          auto const& sm = submaps[i];
+          std::set<frame_id_t> cams = sm.core;
+          cams.insert(sm.overlap.begin(), sm.overlap.end());
+          solutions[i] = solve_subproblem(sbas[i], input_cams, input_lms,
+                                          index, cams, std::set<frame_id_t>(),
+                                          sm.landmarks, constraints);
+        }
+      });
+  }
+
+  // merge: cameras come from the submap that owns them and landmarks seen
+  // by more than one submap are averaged
+  camera_map::map_camera_t out_cams = input_cams;
+  landmark_map::map_landmark_t out_lms = input_lms;
+  std::map<frame_id_t, size_t> owner;
+  std::map<landmark_id_t, std::vector<vector_3d> > lm_locs;
+  for (size_t i = 0; i < submaps.size(); ++i)
+  {
+    auto const& sol_cams = solutions[i].cameras.T_cameras();
+    for (auto const f : submaps[i].core)
+    {
+      owner[f] = i;
+      auto const it = sol_cams.find(f);
+      if (it != sol_cams.end())
+      {
+        out_cams[f] = it->second;
+      }
+    }
+    for (auto const& p : solutions[i].landmarks)
+    {
+      lm_locs[p.first].push_back(p.second->loc());
+      out_lms[p.first] = p.second;
+    }
+  }
+
+  std::set<landmark_id_t> shared_lms;
+  for (auto const& p : lm_locs)
+  {
+    if (p.second.size() > 1)
+    {
+      vector_3d mean = vector_3d::Zero();
+      for (auto const& x : p.second)
+      {
+        mean += x;
+      }
+      mean /= static_cast<double>(p.second.size());
+
+      auto lm = std::make_shared<landmark_d>(*out_lms[p.first]);
+      lm->set_loc(mean);
+      out_lms[p.first] = lm;
+      shared_lms.insert(p.first);
+    }
+  }
+
+  // separator pass: refine the boundary cameras, which observe landmarks
+  // shared between submaps, and every landmark they observe
+  if (d_->separator_pass && !shared_lms.empty())
+  {
+    kwiver::vital::scoped_cpu_timer t( "separator optimization" );
+
+    std::set<frame_id_t> boundary;
+    for (auto const lm_id : shared_lms)
+    {
+      auto const& frames = index.landmark_frames.at(lm_id);
+      boundary.insert(frames.begin(), frames.end());
+    }
+
+    std::set<landmark_id_t> sep_lms;
+    for (auto const f : boundary)
+    {
+      auto const& lms = index.frame_landmarks.at(f);
+      sep_lms.insert(lms.begin(), lms.end());
+    }
+
+    // the other cameras observing those landmarks anchor the solution
+    std::set<frame_id_t> sep_cams = boundary;
+    std::set<frame_id_t> fixed;
+    for (auto const lm_id : sep_lms)
+    {
+      for (auto const f : index.landmark_frames.at(lm_id))
+      {
+        if (!boundary.count(f))
+        {
+          fixed.insert(f);
+          sep_cams.insert(f);
+        }
+      }
+    }
+    LOG_INFO(logger(), "Refining " << boundary.size() << " boundary cameras "
+                       << "and " << sep_lms.size() << " landmarks");
+
+    auto const sol = solve_subproblem(d_->create_sba(), out_cams, out_lms,
+                                      index, sep_cams, fixed, sep_lms,
+                                      constraints);
+    for (auto const& p : sol.cameras.T_cameras())
+    {
+      if (boundary.count(p.first))
+      {
+        out_cams[p.first] = p.second;
+      }
+    }
+    for (auto const& p : sol.landmarks)
+    {
+      out_lms[p.first] = p.second;
+    }
+  }
+
+  cameras = std::make_shared<simple_camera_map>(out_cams);
+  landmarks = std::make_shared<simple_landmark_map>(out_lms);
+}
+
+} // end namespace mvg
+} // end namespace arrows
+} // end namespace kwiver
@@ -9,14 +9,15 @@
 
 #include "triangulate_landmarks.h"
 
+#include <cstdint>
 #include <set>
 #include <random>
-#include <ctime>
 
 #include <arrows/mvg/metrics.h>
 #include <arrows/mvg/triangulate.h>
 
 #include <vital/math_constants.h>
+#include <vital/util/parallel_chunks.h>
 #include <vital/vital_config.h>
 
 namespace kwiver {
@@ -48,7 +49,8 @@ class triangulate_landmarks::priv
       m_inlier_threshold_pixels_sq(other.m_inlier_threshold_pixels_sq),
       m_frac_track_inliers_to_keep_triangulated_point(
         other.m_frac_track_inliers_to_keep_triangulated_point),
-      m_max_ransac_samples(other.m_max_ransac_samples)
+      m_max_ransac_samples(other.m_max_ransac_samples),
+      m_conf_thresh(other.m_conf_thresh)
   {
   }
 
@@ -56,7 +58,26 @@ class triangulate_landmarks::priv
   ransac_triangulation(const std::vector<vital::simple_camera_perspective> &lm_cams,
                        const std::vector<vital::vector_2d> &lm_image_pts,
                        int &best_inlier_count,
-                       vital::vector_3d const* guess) const;
+                       vital::vector_3d const* guess,
+                       std::uint64_t seed) const;
+
+  /// Outcome of triangulating one landmark
+  enum class lm_result
+  {
+    triangulated,
+    skipped,
+    failed,
+    failed_outlier,
+    failed_angle,
+  };
+
+  lm_result
+  triangulate_landmark(vital::landmark_id_t lm_id,
+                       vital::landmark_sptr const& lm_in,
+                       vital::track_map_t const& track_map,
+                       vital::camera_map::map_camera_t const& cams,
+                       double thresh_triang_cos_ang,
+                       vital::landmark_sptr& lm_out) const;
 
   bool
   triangulate(const std::vector<vital::simple_camera_perspective> &lm_cams,
@@ -207,7 +228,8 @@ triangulate_landmarks::priv
 ::ransac_triangulation(const std::vector<vital::simple_camera_perspective> &lm_cams,
                        const std::vector<vital::vector_2d> &lm_image_pts,
                        int &best_inlier_count,
-                       vital::vector_3d const* guess) const
+                       vital::vector_3d const* guess,
+                       std::uint64_t seed) const
 {
   double conf = 0;
   std::vector<vital::simple_camera_perspective> cam_sample(2);
@@ -216,10 +238,7 @@ ::ransac_triangulation(const std::vector<vital::simple_camera_perspective> &lm_c
   best_inlier_count = 0;
   double best_inlier_ratio = 0;
 
-  std::random_device rd;
-  std::mt19937_64 gen(rd());
-  std::time_t time_res = std::time(nullptr);
-  gen.seed(time_res);
+  std::mt19937_64 gen(seed);
   std::uniform_int_distribution<> dis(0, int(lm_cams.size() - 1));
 
   best_pt3d.setZero();
@@ -314,208 +333,260 @@ ::triangulate(vital::camera_map_sptr cameras,
   triangulate(cameras, track_map, landmarks);
 }
 
-// Triangulate the landmark locations given sets of cameras and tracks
-void
-triangulate_landmarks
-::triangulate(vital::camera_map_sptr cameras,
-              vital::track_map_t track_map,
-              vital::landmark_map_sptr& landmarks) const
+// Triangulate a single landmark from the observations in its track
+triangulate_landmarks::priv::lm_result
+triangulate_landmarks::priv
+::triangulate_landmark(vital::landmark_id_t lm_id,
+                       vital::landmark_sptr const& lm_in,
+                       vital::track_map_t const& track_map,
+                       vital::camera_map::map_camera_t const& cams,
+                       double thresh_triang_cos_ang,
+                       vital::landmark_sptr& lm_out) const
 {
-  using namespace kwiver;
-  if( !cameras || !landmarks )
-  {
-    // TODO throw an exception for missing input data
-    return;
-  }
-
   typedef vital::camera_map::map_camera_t map_camera_t;
-  typedef vital::landmark_map::map_landmark_t map_landmark_t;
-
-  // extract data from containers
-  map_camera_t cams = cameras->cameras();
-  map_landmark_t lms = landmarks->landmarks();
-
-  // the set of landmark ids which failed to triangulate
-  std::set<vital::landmark_id_t> failed_landmarks;
-  std::set<vital::landmark_id_t> failed_outlier, failed_angle;
-
-  //minimum triangulation angle
-  double thresh_triang_cos_ang = cos(vital::deg_to_rad * d_->m_min_angle_deg);
 
   std::vector<vital::simple_camera_perspective> lm_cams;
   std::vector<vital::simple_camera_rpc> lm_cams_rpc;
   std::vector<vital::vector_2d> lm_image_pts;
   std::vector<vital::feature_track_state_sptr> lm_features;
 
-  map_landmark_t triangulated_lms;
-  for(const map_landmark_t::value_type& p : lms)
+  // extract the cameras and image points for this landmarks
+  auto lm_observations = unsigned{ 0 };
+
+  // get the corresponding track
+  vital::track_map_t::const_iterator t_itr = track_map.find(lm_id);
+  if (t_itr == track_map.end())
   {
-    lm_cams.clear();
-    lm_cams_rpc.clear();
-    lm_image_pts.clear();
-    lm_features.clear();
-    // extract the cameras and image points for this landmarks
-    auto lm_observations = unsigned{ 0 };
-
-    // get the corresponding track
-    vital::track_map_t::const_iterator t_itr = track_map.find(p.first);
-    if (t_itr == track_map.end())
+    // there is no track for the provided landmark
+    return lm_result::failed;
+  }
+  const vital::track& t = *t_itr->second;
+
+  for (vital::track::history_const_itr tsi = t.begin(); tsi != t.end(); ++tsi)
+  {
+    auto fts = std::static_pointer_cast<vital::feature_track_state>(*tsi);
+    if (!fts && !fts->feature)
+    {
+      // there is no valid feature for this track state
+      continue;
+    }
+    map_camera_t::const_iterator c_itr = cams.find((*tsi)->frame());
+    if (c_itr == cams.end())
     {
-      // there is no track for the provided landmark
-      failed_landmarks.insert(p.first);
+      // there is no camera for this track state.
       continue;
     }
-    const vital::track& t = *t_itr->second;
+    auto cam_ptr =
+      std::dynamic_pointer_cast<vital::camera_perspective>(c_itr->second);
+    if (cam_ptr)
+    {
+      lm_cams.push_back(vital::simple_camera_perspective(*cam_ptr));
+    }
+    auto rpc_ptr =
+      std::dynamic_pointer_cast<vital::camera_rpc>(c_itr->second);
+    if (rpc_ptr)
+    {
+      lm_cams_rpc.push_back( vital::simple_camera_rpc( *rpc_ptr ) );
+    }
+    if (cam_ptr || rpc_ptr)
+    {
+      lm_image_pts.push_back(fts->feature->loc());
+      lm_features.push_back(fts);
+      ++lm_observations;
+    }
+  }
 
-    for (vital::track::history_const_itr tsi = t.begin(); tsi != t.end(); ++tsi)
+  // if we found at least two views of this landmark, triangulate
+  if (lm_cams.size() > 1)
+  {
+    int inlier_count = 0;
+    vital::vector_3d pt3d;
+    if (m_ransac)
     {
-      auto fts = std::static_pointer_cast<vital::feature_track_state>(*tsi);
-      if (!fts && !fts->feature)
-      {
-        // there is no valid feature for this track state
-        continue;
-      }
-      map_camera_t::const_iterator c_itr = cams.find((*tsi)->frame());
-      if (c_itr == cams.end())
-      {
-        // there is no camera for this track state.
-        continue;
-      }
-      auto cam_ptr =
-        std::dynamic_pointer_cast<vital::camera_perspective>(c_itr->second);
-      if (cam_ptr)
-      {
-        lm_cams.push_back(vital::simple_camera_perspective(*cam_ptr));
-      }
-      auto rpc_ptr =
-        std::dynamic_pointer_cast<vital::camera_rpc>(c_itr->second);
-      if (rpc_ptr)
+      vital::vector_3d lm_cur_pt3d = lm_in->loc();
+      auto triang_guess = &lm_cur_pt3d;
+      if (lm_cur_pt3d.x() == 0 && lm_cur_pt3d.y() == 0 && lm_cur_pt3d.z() == 0)
       {
-        lm_cams_rpc.push_back( vital::simple_camera_rpc( *rpc_ptr ) );
+        triang_guess = NULL;
       }
-      if (cam_ptr || rpc_ptr)
+
+      // seed with the landmark id so results do not depend on which thread
+      // triangulates which landmark, or when
+      pt3d = ransac_triangulation(lm_cams, lm_image_pts, inlier_count,
+                                  triang_guess,
+                                  static_cast<std::uint64_t>(lm_id));
+      if (inlier_count < lm_image_pts.size() * m_frac_track_inliers_to_keep_triangulated_point)
       {
-        lm_image_pts.push_back(fts->feature->loc());
-        lm_features.push_back(fts);
-        ++lm_observations;
+        return lm_result::failed_outlier;
       }
     }
-
-    // if we found at least two views of this landmark, triangulate
-    if (lm_cams.size() > 1)
+    else
     {
-      int inlier_count = 0;
-      vital::vector_3d pt3d;
-      if (d_->m_ransac)
+      if (!triangulate(lm_cams, lm_image_pts, pt3d))
       {
-        vital::vector_3d lm_cur_pt3d = p.second->loc();
-        auto triang_guess = &lm_cur_pt3d;
-        if (lm_cur_pt3d.x() == 0 && lm_cur_pt3d.y() == 0 && lm_cur_pt3d.z() == 0)
-        {
-          triang_guess = NULL;
-        }
-
-        pt3d = d_->ransac_triangulation(lm_cams, lm_image_pts, inlier_count, triang_guess);
-        if (inlier_count < lm_image_pts.size() * d_->m_frac_track_inliers_to_keep_triangulated_point)
-        {
-          failed_landmarks.insert(p.first);
-          failed_outlier.insert(p.first);
-          continue;
-        }
+        return lm_result::failed;
       }
-      else
+      //test if the point is behind any of the cameras
+      bool behind = false;
+      for (auto const& lm_cam : lm_cams)
       {
-        if (!d_->triangulate(lm_cams, lm_image_pts, pt3d))
+        auto depth = lm_cam.depth(pt3d);
+        if (depth <= 0)
         {
-          failed_landmarks.insert(p.first);
-          continue;
-        }
-        //test if the point is behind any of the cameras
-        bool behind = false;
-        for (auto const& lm_cam : lm_cams)
-        {
-          auto depth = lm_cam.depth(pt3d);
-          if (depth <= 0)
-          {
-            behind = true;
-            break;
-          }
-        }
-        if (behind)
-        {
-          for (auto lm_feat : lm_features)
-          {
-            lm_feat->inlier = false;
-          }
-          failed_landmarks.insert(p.first);
-          continue;
+          behind = true;
+          break;
         }
       }
-
-      //set inlier/outlier states for the measurements
-      for (unsigned int idx = 0; idx < lm_cams.size(); ++idx)
-      {
-        vital::landmark_d lm;
-        lm.set_loc(pt3d);
-        double reproj_err_sq = reprojection_error_sqr(lm_cams[idx], lm, *lm_features[idx]->feature);
-        if (reproj_err_sq < d_->m_inlier_threshold_pixels_sq)
-        {
-          lm_features[idx]->inlier = true;
-        }
-        else
-        {
-          lm_features[idx]->inlier = false;
-        }
-      }
-      if (!pt3d.allFinite())
+      if (behind)
       {
         for (auto lm_feat : lm_features)
         {
           lm_feat->inlier = false;
         }
-        failed_landmarks.insert(p.first);
-        continue;
+        return lm_result::failed;
       }
+    }
 
-      double triang_cos_ang = bundle_angle_max(lm_cams, pt3d);
-      bool bad_triangulation = triang_cos_ang > thresh_triang_cos_ang;
-      if (bad_triangulation)
+    //set inlier/outlier states for the measurements
+    for (unsigned int idx = 0; idx < lm_cams.size(); ++idx)
+    {
+      vital::landmark_d lm;
+      lm.set_loc(pt3d);
+      double reproj_err_sq = reprojection_error_sqr(lm_cams[idx], lm, *lm_features[idx]->feature);
+      if (reproj_err_sq < m_inlier_threshold_pixels_sq)
       {
-        failed_landmarks.insert(p.first);
-        failed_angle.insert(p.first);
-        for (auto lm_feat : lm_features)
-        {
-          lm_feat->inlier = false;
-        }
-        continue;
+        lm_features[idx]->inlier = true;
       }
-
-      std::shared_ptr<vital::landmark_d> lm;
-      // if the landmark already exists, copy it
-      if (p.second)
+      else
       {
-        lm = std::make_shared<vital::landmark_d>(*p.second);  //automatically copies the tracks_ data
-        lm->set_loc(pt3d);
+        lm_features[idx]->inlier = false;
       }
-      // otherwise make a new landmark
-      else
+    }
+    if (!pt3d.allFinite())
+    {
+      for (auto lm_feat : lm_features)
       {
-        lm = std::make_shared<vital::landmark_d>(pt3d);
+        lm_feat->inlier = false;
       }
-      lm->set_cos_observation_angle(triang_cos_ang);
-      lm->set_observations(lm_observations);
-      triangulated_lms[p.first] = lm;
+      return lm_result::failed;
     }
-    else if ( lm_cams_rpc.size() > 1 )
+
+    double triang_cos_ang = bundle_angle_max(lm_cams, pt3d);
+    bool bad_triangulation = triang_cos_ang > thresh_triang_cos_ang;
+    if (bad_triangulation)
     {
-      vital::vector_3d pt3d =
-        triangulate_rpc(lm_cams_rpc, lm_image_pts);
+      for (auto lm_feat : lm_features)
+      {
+        lm_feat->inlier = false;
+      }
+      return lm_result::failed_angle;
+    }
 
-      // TODO: is there a way to check for bad triangulations for RPC cameras?
-      auto lm = std::make_shared<vital::landmark_d>(*p.second);
+    std::shared_ptr<vital::landmark_d> lm;
+    // if the landmark already exists, copy it
+    if (lm_in)
+    {
+      lm = std::make_shared<vital::landmark_d>(*lm_in);  //automatically copies the tracks_ data
       lm->set_loc(pt3d);
-      lm->set_observations(lm_observations);
-      triangulated_lms[p.first] = lm;
+    }
+    // otherwise make a new landmark
+    else
+    {
+      lm = std::make_shared<vital::landmark_d>(pt3d);
+    }
+    lm->set_cos_observation_angle(triang_cos_ang);
+    lm->set_observations(lm_observations);
+    lm_out = lm;
+    return lm_result::triangulated;
+  }
+  else if ( lm_cams_rpc.size() > 1 )
+  {
+    vital::vector_3d pt3d =
+      triangulate_rpc(lm_cams_rpc, lm_image_pts);
+
+    // TODO: is there a way to check for bad triangulations for RPC cameras?
+    auto lm = std::make_shared<vital::landmark_d>(*lm_in);
+    lm->set_loc(pt3d);
+    lm->set_observations(lm_observations);
+    lm_out = lm;
+    return lm_result::triangulated;
+  }
+  return lm_result::skipped;
+}
+
+// Triangulate the landmark locations given sets of cameras and tracks
+void
+triangulate_landmarks
+::triangulate(vital::camera_map_sptr cameras,
+              vital::track_map_t track_map,
+              vital::landmark_map_sptr& landmarks) const
+{
+  using namespace kwiver;
+  if( !cameras || !landmarks )
+  {
+    // TODO throw an exception for missing input data
+    return;
+  }
+
+  typedef vital::camera_map::map_camera_t map_camera_t;
+  typedef vital::landmark_map::map_landmark_t map_landmark_t;
+
+  // extract data from containers
+  map_camera_t cams = cameras->cameras();
+  map_landmark_t lms = landmarks->landmarks();
+
+  //minimum triangulation angle
+  double thresh_triang_cos_ang = cos(vital::deg_to_rad * d_->m_min_angle_deg);
+
+  // Landmarks are independent of each other; each one only touches the
+  // inlier flags of the states in its own track.  Triangulate them in
+  // parallel and collect the results in landmark order.
+  std::vector<map_landmark_t::const_iterator> lm_itrs;
+  lm_itrs.reserve(lms.size());
+  for (auto it = lms.cbegin(); it != lms.cend(); ++it)
+  {
+    lm_itrs.push_back(it);
+  }
+  std::vector<priv::lm_result> results(lm_itrs.size());
+  std::vector<vital::landmark_sptr> results_lms(lm_itrs.size());
+
+  vital::parallel_chunks(lm_itrs.size(), 64,
+    [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        results[i] = d_->triangulate_landmark(
+          lm_itrs[i]->first, lm_itrs[i]->second, track_map, cams,
+          thresh_triang_cos_ang, results_lms[i]);
+      }
+    });
+
+  // the set of landmark ids which failed to triangulate
+  std::set<vital::landmark_id_t> failed_landmarks;
+  std::set<vital::landmark_id_t> failed_outlier, failed_angle;
+
+  map_landmark_t triangulated_lms;
+  for (size_t i = 0; i < lm_itrs.size(); ++i)
+  {
+    auto const lm_id = lm_itrs[i]->first;
+    switch (results[i])
+    {
+      case priv::lm_result::triangulated:
+        triangulated_lms[lm_id] = results_lms[i];
+        break;
+      case priv::lm_result::failed_outlier:
+        failed_outlier.insert(lm_id);
+        failed_landmarks.insert(lm_id);
+        break;
+      case priv::lm_result::failed_angle:
+        failed_angle.insert(lm_id);
+        failed_landmarks.insert(lm_id);
+        break;
+      case priv::lm_result::failed:
+        failed_landmarks.insert(lm_id);
+        break;
+      case priv::lm_result::skipped:
+        break;
     }
   }
   if( !failed_landmarks.empty() )
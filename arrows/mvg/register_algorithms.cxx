@@ -15,6 +15,7 @@
 #include <arrows/mvg/algo/integrate_depth_maps.h>
 #include <arrows/mvg/algo/initialize_cameras_landmarks.h>
 #include <arrows/mvg/algo/initialize_cameras_landmarks_basic.h>
+#include <arrows/mvg/algo/partitioned_bundle_adjust.h>
 #include <arrows/mvg/algo/triangulate_landmarks.h>
 
 // TODO: These are files that should move to MVG from Core
@@ -56,6 +57,7 @@ register_factories( kwiver::vital::plugin_loader& vpm )
   reg.register_algorithm< integrate_depth_maps >();
   reg.register_algorithm< initialize_cameras_landmarks >();
   reg.register_algorithm< initialize_cameras_landmarks_basic >();
+  reg.register_algorithm< partitioned_bundle_adjust >();
   reg.register_algorithm< triangulate_landmarks >();
 
   reg.mark_module_as_loaded();
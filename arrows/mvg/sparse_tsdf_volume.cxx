@@ -0,0 +1,519 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+* \file
+* \brief Source file for a sparse voxel block volume for depth map fusion
+*/
+
+#include <arrows/mvg/sparse_tsdf_volume.h>
+
+#include <vital/util/parallel_chunks.h>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+using namespace kwiver::vital;
+
+namespace kwiver {
+namespace arrows {
+namespace mvg {
+
+namespace {
+
+int const bs = sparse_tsdf_volume::block_size;
+int const voxels_per_block = bs * bs * bs;
+
+} // end anonymous namespace
+
+/// Private implementation class
+class sparse_tsdf_volume::priv
+{
+public:
+  priv(vector_3d const& o, vector_3d const& s, Eigen::Vector3i const& d,
+       tsdf_potential const& p, float u)
+    : origin(o),
+      spacing(s),
+      dims(d.cwiseMax(0)),
+      potential(p),
+      unallocated(u)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      num_blocks[i] = static_cast<uint64_t>((dims[i] + bs - 1) / bs);
+    }
+  }
+
+  uint64_t block_key(uint64_t bi, uint64_t bj, uint64_t bk) const
+  {
+    return (bk * num_blocks[1] + bj) * num_blocks[0] + bi;
+  }
+
+  // find the block containing a voxel, or return null
+  float const* find_block(int i, int j, int k) const
+  {
+    if (i < 0 || j < 0 || k < 0 ||
+        i >= dims[0] || j >= dims[1] || k >= dims[2])
+    {
+      return nullptr;
+    }
+    auto const itr = index.find(block_key(i / bs, j / bs, k / bs));
+    return itr == index.end()
+      ? nullptr : values.data() + itr->second * voxels_per_block;
+  }
+
+  // add the potential of one depth map to the voxels of block b
+  void integrate_block(size_t b, float* block_values, matrix_3x4d const& P,
+                       camera_intrinsics const* K,
+                       image_of<double> const& depth,
+                       image_of<double> const& weight) const;
+
+  vector_3d origin;
+  vector_3d spacing;
+  Eigen::Vector3i dims;
+  tsdf_potential potential;
+  float unallocated;
+  uint64_t num_blocks[3];
+
+  // block keys in the order allocated, their index, and their voxels; the
+  // voxels of each block are stored with i varying fastest, then j, then k
+  std::vector<uint64_t> keys;
+  std::unordered_map<uint64_t, size_t> index;
+  std::vector<float> values;
+};
+
+// ----------------------------------------------------------------------------
+
+void
+sparse_tsdf_volume::priv
+::integrate_block(size_t b, float* block_values, matrix_3x4d const& P,
+                  camera_intrinsics const* K,
+                  image_of<double> const& depth,
+                  image_of<double> const& weight) const
+{
+  uint64_t const key = keys[b];
+  Eigen::Vector3d const first_voxel(
+    static_cast<double>(bs * (key % num_blocks[0])),
+    static_cast<double>(bs * (key / num_blocks[0] % num_blocks[1])),
+    static_cast<double>(bs * (key / num_blocks[0] / num_blocks[1])));
+
+  // voxel centers are offset by half a step
+  vector_3d const block_origin =
+    origin + spacing.cwiseProduct(first_voxel + vector_3d::Constant(0.5));
+  vector_3d const x_step = spacing[0] * P.col(0);
+  vector_3d const y_step = spacing[1] * P.col(1);
+  vector_3d const z_step = spacing[2] * P.col(2);
+  vector_3d const homog_base = P.leftCols<3>() * block_origin + P.col(3);
+
+  int const width = static_cast<int>(depth.width());
+  int const height = static_cast<int>(depth.height());
+
+  // skip blocks which project entirely to one side of the image; without
+  // distortion the projection of the block lies within that of its corners
+  if (!K)
+  {
+    bool all_left = true, all_right = true, all_above = true,
+         all_below = true;
+    for (int c = 0; c < 8 && (all_left || all_right || all_above ||
+                              all_below); ++c)
+    {
+      vector_3d const hpt = homog_base +
+                            ((c & 1) ? bs - 1 : 0) * x_step +
+                            ((c & 2) ? bs - 1 : 0) * y_step +
+                            ((c & 4) ? bs - 1 : 0) * z_step;
+      if (hpt[2] <= 0.0)
+      {
+        all_left = all_right = all_above = all_below = false;
+        break;
+      }
+      double const u = hpt[0] / hpt[2];
+      double const v = hpt[1] / hpt[2];
+      // pixels are found by truncating u + 0.5 so u in (-1.5, -0.5) maps
+      // to column 0
+      all_left = all_left && u <= -1.5;
+      all_right = all_right && u >= width - 0.5;
+      all_above = all_above && v <= -1.5;
+      all_below = all_below && v >= height - 0.5;
+    }
+    if (all_left || all_right || all_above || all_below)
+    {
+      return;
+    }
+  }
+
+  double const rho = potential.rho;
+  double const delta = potential.delta;
+  double const occluded = potential.occluded;
+  double const freespace = potential.freespace;
+  double const slope = rho / potential.thickness;
+  bool const weighted = weight.size() > 0;
+
+  // each row of the block is processed as fixed length arrays with the
+  // pixel lookups separated from the arithmetic, so that the compiler can
+  // vectorize the projection and potential across the row
+  for (int k = 0; k < bs; ++k)
+  {
+    for (int j = 0; j < bs; ++j)
+    {
+      vector_3d const row = homog_base + j * y_step + k * z_step;
+      double hx[bs], hy[bs], hz[bs], u[bs], v[bs];
+      for (int l = 0; l < bs; ++l)
+      {
+        hx[l] = row[0] + l * x_step[0];
+        hy[l] = row[1] + l * x_step[1];
+        hz[l] = row[2] + l * x_step[2];
+      }
+      if (K)
+      {
+        for (int l = 0; l < bs; ++l)
+        {
+          vector_2d const pt = K->map(vector_3d(hx[l], hy[l], hz[l]));
+          u[l] = pt[0];
+          v[l] = pt[1];
+        }
+      }
+      else
+      {
+        for (int l = 0; l < bs; ++l)
+        {
+          u[l] = hx[l] / hz[l];
+          v[l] = hy[l] / hz[l];
+        }
+      }
+
+      double est[bs], w[bs];
+      for (int l = 0; l < bs; ++l)
+      {
+        int const pu = static_cast<int>(u[l] + 0.5);
+        int const pv = static_cast<int>(v[l] + 0.5);
+        est[l] = 0.0;
+        w[l] = 0.0;
+        if (pu >= 0 && pu < width && pv >= 0 && pv < height)
+        {
+          est[l] = depth(pu, pv);
+          w[l] = weighted ? weight(pu, pv) : 1.0;
+          // pixels without a valid depth or weight contribute nothing
+          if (est[l] <= 0.0 || w[l] <= 0.0)
+          {
+            w[l] = 0.0;
+          }
+        }
+      }
+
+      float* const row_values = block_values + (k * bs + j) * bs;
+      for (int l = 0; l < bs; ++l)
+      {
+        double const diff = hz[l] - est[l];
+        double const abs_diff = std::abs(diff);
+        // the slope reaches rho at the thickness, so clamping it gives the
+        // potential inside the truncation band without a branch
+        double const band_val = std::min(std::max(slope * diff, -rho), rho);
+        double const far_val = diff > 0.0 ? occluded : freespace;
+        double const val = abs_diff > delta ? far_val : band_val;
+        row_values[l] += static_cast<float>(w[l] * val);
+      }
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+sparse_tsdf_volume
+::sparse_tsdf_volume(vector_3d const& origin,
+                     vector_3d const& spacing,
+                     Eigen::Vector3i const& dims,
+                     tsdf_potential const& potential,
+                     float unallocated_value)
+  : d_(new priv(origin, spacing, dims, potential, unallocated_value))
+{
+}
+
+// ----------------------------------------------------------------------------
+
+sparse_tsdf_volume
+::~sparse_tsdf_volume()
+{
+}
+
+// ----------------------------------------------------------------------------
+
+size_t
+sparse_tsdf_volume
+::allocate(camera_perspective const& camera,
+           image_of<double> const& depth,
+           image_of<double> const& weight)
+{
+  size_t const width = depth.width();
+  size_t const height = depth.height();
+  bool const weighted = weight.size() > 0;
+  auto const K = camera.intrinsics();
+  bool const distorted = !K->dist_coeffs().empty();
+  vector_3d const center = camera.center();
+
+  // maps homogeneous pixels, or normalized points if there is distortion,
+  // to world ray directions with unit depth
+  matrix_3x3d const back_project = distorted
+    ? matrix_3x3d(camera.rotation().inverse().matrix())
+    : matrix_3x3d(camera.as_matrix().leftCols<3>().inverse());
+  double const delta = d_->potential.delta;
+  double const step = d_->spacing.minCoeff();
+  priv const& p = *d_;
+
+  // find the blocks touched by each row of pixels in parallel, stepping a
+  // voxel at a time through the truncation band along each pixel ray
+  std::vector<std::vector<uint64_t> > row_keys(height);
+  parallel_chunks(height, 4, [&](size_t begin, size_t end)
+  {
+    for (size_t y = begin; y < end; ++y)
+    {
+      auto& found = row_keys[y];
+      for (size_t x = 0; x < width; ++x)
+      {
+        // depths of infinity mark pixels which see no surface
+        double const d = depth(x, y);
+        if (d <= 0.0 || !std::isfinite(d) ||
+            (weighted && weight(x, y) <= 0.0))
+        {
+          continue;
+        }
+        vector_2d const pt =
+          distorted ? K->unmap(vector_2d(x, y)) : vector_2d(x, y);
+        vector_3d const ray = back_project * vector_3d(pt[0], pt[1], 1.0);
+        double const z_min = std::max(d - delta, 0.0);
+        int const num_steps = static_cast<int>((d + delta - z_min) / step);
+        for (int s = 0; s <= num_steps; ++s)
+        {
+          double const z = z_min + s * step;
+          vector_3d const idx =
+            (center + z * ray - p.origin).cwiseQuotient(p.spacing);
+          if (idx[0] < 0.0 || idx[1] < 0.0 || idx[2] < 0.0 ||
+              idx[0] >= p.dims[0] || idx[1] >= p.dims[1] ||
+              idx[2] >= p.dims[2])
+          {
+            continue;
+          }
+          uint64_t const key =
+            p.block_key(static_cast<uint64_t>(idx[0]) / bs,
+                        static_cast<uint64_t>(idx[1]) / bs,
+                        static_cast<uint64_t>(idx[2]) / bs);
+          if (found.empty() || found.back() != key)
+          {
+            found.push_back(key);
+          }
+        }
+      }
+      std::sort(found.begin(), found.end());
+      found.erase(std::unique(found.begin(), found.end()), found.end());
+    }
+  });
+
+  size_t const old_size = d_->keys.size();
+  for (auto const& found : row_keys)
+  {
+    for (auto const key : found)
+    {
+      if (d_->index.emplace(key, d_->keys.size()).second)
+      {
+        d_->keys.push_back(key);
+      }
+    }
+  }
+  d_->values.resize(d_->keys.size() * voxels_per_block, 0.0f);
+  return d_->keys.size() - old_size;
+}
+
+// ----------------------------------------------------------------------------
+
+void
+sparse_tsdf_volume
+::integrate(camera_perspective const& camera,
+            image_of<double> const& depth,
+            image_of<double> const& weight)
+{
+  // For imagery without distortion we can combine the intrinsic and
+  // extrinsic paramters into a single 3x4 projection for faster iteration
+  auto const K = camera.intrinsics();
+  bool const distorted = !K->dist_coeffs().empty();
+  matrix_3x4d const P = distorted ? camera.pose_matrix() : camera.as_matrix();
+  camera_intrinsics const* const K_ptr = distorted ? K.get() : nullptr;
+
+  // blocks are independent, so each is updated by exactly one thread
+  priv const& p = *d_;
+  float* const values = d_->values.data();
+  parallel_chunks(d_->keys.size(), 16, [&](size_t begin, size_t end)
+  {
+    for (size_t b = begin; b < end; ++b)
+    {
+      p.integrate_block(b, values + b * voxels_per_block, P, K_ptr,
+                        depth, weight);
+    }
+  });
+}
+
+// ----------------------------------------------------------------------------
+
+size_t
+sparse_tsdf_volume
+::num_blocks() const
+{
+  return d_->keys.size();
+}
+
+// ----------------------------------------------------------------------------
+
+bool
+sparse_tsdf_volume
+::is_allocated(int i, int j, int k) const
+{
+  return d_->find_block(i, j, k) != nullptr;
+}
+
+// ----------------------------------------------------------------------------
+
+float
+sparse_tsdf_volume
+::value(int i, int j, int k) const
+{
+  float const* block = d_->find_block(i, j, k);
+  return block ? block[((k % bs) * bs + j % bs) * bs + i % bs]
+               : d_->unallocated;
+}
+
+// ----------------------------------------------------------------------------
+
+float
+sparse_tsdf_volume
+::unallocated_value() const
+{
+  return d_->unallocated;
+}
+
+// ----------------------------------------------------------------------------
+
+Eigen::Vector3i const&
+sparse_tsdf_volume
+::dimensions() const
+{
+  return d_->dims;
+}
+
+// ----------------------------------------------------------------------------
+
+void
+sparse_tsdf_volume
+::to_image(image_of<double>& volume) const
+{
+  auto const& dims = d_->dims;
+  volume.set_size(dims[0], dims[1], dims[2]);
+  copy_to(volume.first_pixel(), volume.w_step(), volume.h_step(),
+          volume.d_step());
+}
+
+// ----------------------------------------------------------------------------
+
+void
+sparse_tsdf_volume
+::copy_to(double* data, ptrdiff_t i_step, ptrdiff_t j_step,
+          ptrdiff_t k_step) const
+{
+  size_t const ni = static_cast<size_t>(d_->dims[0]);
+  size_t const nj = static_cast<size_t>(d_->dims[1]);
+  size_t const nk = static_cast<size_t>(d_->dims[2]);
+  double const unallocated = d_->unallocated;
+  for (size_t k = 0; k < nk; ++k)
+  {
+    for (size_t j = 0; j < nj; ++j)
+    {
+      double* const row = data + static_cast<ptrdiff_t>(k) * k_step +
+                            static_cast<ptrdiff_t>(j) * j_step;
+      for (size_t i = 0; i < ni; ++i)
+      {
+        row[static_cast<ptrdiff_t>(i) * i_step] = unallocated;
+      }
+    }
+  }
+
+  for (size_t b = 0; b < d_->keys.size(); ++b)
+  {
+    uint64_t const key = d_->keys[b];
+    size_t const i0 = bs * (key % d_->num_blocks[0]);
+    size_t const j0 = bs * (key / d_->num_blocks[0] % d_->num_blocks[1]);
+    size_t const k0 = bs * (key / d_->num_blocks[0] / d_->num_blocks[1]);
+    float const* const block = d_->values.data() + b * voxels_per_block;
+    for (size_t k = k0; k < std::min(k0 + bs, nk); ++k)
+    {
+      for (size_t j = j0; j < std::min(j0 + bs, nj); ++j)
+      {
+        float const* const src = block + ((k - k0) * bs + (j - j0)) * bs;
+        double* const row = data + static_cast<ptrdiff_t>(k) * k_step +
+                            static_cast<ptrdiff_t>(j) * j_step;
+        for (size_t i = i0; i < std::min(i0 + bs, ni); ++i)
+        {
+          row[static_cast<ptrdiff_t>(i) * i_step] = src[i - i0];
+        }
+      }
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+sparse_tsdf_image_container
+::sparse_tsdf_image_container(std::shared_ptr<sparse_tsdf_volume const> volume)
+  : volume_(volume)
+{
+}
+
+// ----------------------------------------------------------------------------
+
+size_t
+sparse_tsdf_image_container
+::size() const
+{
+  return width() * height() * depth() * sizeof(double);
+}
+
+// ----------------------------------------------------------------------------
+
+size_t
+sparse_tsdf_image_container
+::width() const
+{
+  return static_cast<size_t>(volume_->dimensions()[0]);
+}
+
+// ----------------------------------------------------------------------------
+
+size_t
+sparse_tsdf_image_container
+::height() const
+{
+  return static_cast<size_t>(volume_->dimensions()[1]);
+}
+
+// ----------------------------------------------------------------------------
+
+size_t
+sparse_tsdf_image_container
+::depth() const
+{
+  return static_cast<size_t>(volume_->dimensions()[2]);
+}
+
+// ----------------------------------------------------------------------------
+
+image
+sparse_tsdf_image_container
+::get_image() const
+{
+  image_of<double> dense;
+  volume_->to_image(dense);
+  return dense;
+}
+
+}  // end namespace mvg
+}  // end namespace arrows
+}  // end namespace kwiver
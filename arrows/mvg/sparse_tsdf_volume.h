@@ -0,0 +1,178 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+* \file
+* \brief Header for a sparse voxel block volume for depth map fusion
+*/
+
+#ifndef KWIVER_ARROWS_MVG_SPARSE_TSDF_VOLUME_H_
+#define KWIVER_ARROWS_MVG_SPARSE_TSDF_VOLUME_H_
+
+#include <arrows/mvg/kwiver_algo_mvg_export.h>
+
+#include <vital/types/camera_perspective.h>
+#include <vital/types/image.h>
+#include <vital/types/image_container.h>
+#include <vital/types/vector.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace kwiver {
+namespace arrows {
+namespace mvg {
+
+/// Parameters of the truncated signed distance ray potential
+/**
+ * All distances are in world units.  The potential rises linearly from zero
+ * at the surface to +/- \c rho at \c thickness, and beyond \c delta takes
+ * the constant \c occluded value behind the surface or \c freespace value
+ * in front of it.
+ */
+struct KWIVER_ALGO_MVG_EXPORT tsdf_potential
+{
+  double rho;
+  double thickness;
+  double delta;
+  double freespace;
+  double occluded;
+};
+
+/// A truncated signed distance volume stored in sparse blocks of voxels
+/**
+ * The volume covers a regular grid of voxels like a dense volume image, but
+ * voxels are only stored, as floats, in cubic blocks which have been
+ * allocated near the surface of some depth map.  Unallocated voxels read as
+ * a constant value, zero by default.  This keeps the memory used by large
+ * scenes roughly proportional to their surface area rather than their
+ * volume.
+ *
+ * Depth maps are used in two passes: allocate() adds the blocks within the
+ * truncation distance of each depth map surface, and integrate() adds the
+ * ray potential of a depth map to every allocated voxel.  When all depth
+ * maps are allocated before any are integrated, each allocated voxel has
+ * the same value as in a dense volume.
+ */
+class KWIVER_ALGO_MVG_EXPORT sparse_tsdf_volume
+{
+public:
+  /// The number of voxels along each edge of a block
+  enum { block_size = 8 };
+
+  /// Constructor
+  /**
+   * \param origin    the minimum corner of the voxel grid
+   * \param spacing   the size of a voxel in each dimension
+   * \param dims      the number of voxels in each dimension
+   * \param potential the ray potential to integrate
+   * \param unallocated_value the value of voxels in unallocated blocks;
+   *                  zero is the level of the surface, so NaN may be used
+   *                  to mark these voxels unknown instead
+   */
+  sparse_tsdf_volume(vital::vector_3d const& origin,
+                     vital::vector_3d const& spacing,
+                     Eigen::Vector3i const& dims,
+                     tsdf_potential const& potential,
+                     float unallocated_value = 0.0f);
+
+  /// Destructor
+  ~sparse_tsdf_volume();
+
+  /// Allocate the blocks near the surface of a depth map
+  /**
+   * Pixels with non-positive depth, or non-positive weight if \p weight is
+   * not empty, are ignored.
+   *
+   * \returns the number of blocks added
+   */
+  size_t allocate(vital::camera_perspective const& camera,
+                  vital::image_of<double> const& depth,
+                  vital::image_of<double> const& weight =
+                    vital::image_of<double>());
+
+  /// Add the ray potential of a depth map to all allocated voxels
+  /**
+   * If \p weight is not empty it must be the size of \p depth and scales
+   * the potential of each pixel.
+   */
+  void integrate(vital::camera_perspective const& camera,
+                 vital::image_of<double> const& depth,
+                 vital::image_of<double> const& weight =
+                   vital::image_of<double>());
+
+  /// The number of allocated blocks
+  size_t num_blocks() const;
+
+  /// Whether the voxel at grid index (i, j, k) is allocated
+  bool is_allocated(int i, int j, int k) const;
+
+  /// The value of the voxel at grid index (i, j, k)
+  float value(int i, int j, int k) const;
+
+  /// The value of voxels in unallocated blocks
+  float unallocated_value() const;
+
+  /// The number of voxels in each dimension
+  Eigen::Vector3i const& dimensions() const;
+
+  /// Write the whole volume into a dense image
+  void to_image(vital::image_of<double>& volume) const;
+
+  /// Write the whole volume into a strided array
+  /**
+   * The voxel at grid index (i, j, k) is written to
+   * <tt>data[i * i_step + j * j_step + k * k_step]</tt>.  This lets
+   * consumers fill their own dense storage without an intermediate image.
+   */
+  void copy_to(double* data, ptrdiff_t i_step, ptrdiff_t j_step,
+               ptrdiff_t k_step) const;
+
+private:
+  class priv;
+  std::unique_ptr<priv> d_;
+};
+
+/// An image container presenting a sparse volume as a dense volume image
+/**
+ * The dense image is only built when get_image() is called, so a sparse
+ * volume can be passed through interfaces taking an image container
+ * without allocating the whole grid.  Consumers which understand sparse
+ * volumes can use volume() directly.
+ */
+class KWIVER_ALGO_MVG_EXPORT sparse_tsdf_image_container
+  : public vital::image_container
+{
+public:
+  /// Constructor
+  explicit sparse_tsdf_image_container(
+    std::shared_ptr<sparse_tsdf_volume const> volume);
+
+  /// The size of the dense image data in bytes
+  size_t size() const override;
+
+  /// The width of the volume in voxels
+  size_t width() const override;
+
+  /// The height of the volume in voxels
+  size_t height() const override;
+
+  /// The depth of the volume in voxels
+  size_t depth() const override;
+
+  /// Build a dense image of the volume
+  vital::image get_image() const override;
+
+  /// The sparse volume
+  std::shared_ptr<sparse_tsdf_volume const> volume() const { return volume_; }
+
+private:
+  std::shared_ptr<sparse_tsdf_volume const> volume_;
+};
+
+}  // end namespace mvg
+}  // end namespace arrows
+}  // end namespace kwiver
+
+#endif
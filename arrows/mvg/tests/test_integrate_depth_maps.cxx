@@ -5,6 +5,7 @@
 #include <test_scene.h>
 
 #include <arrows/mvg/algo/integrate_depth_maps.h>
+#include <arrows/mvg/sparse_tsdf_volume.h>
 #include <arrows/core/render_mesh_depth_map.h>
 #include <arrows/core/mesh_operations.h>
 
@@ -16,6 +17,9 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
 
 using namespace kwiver::vital;
 
@@ -205,3 +209,220 @@ TEST(integrate_depth_maps, integrate_distorted)
 
   evaluate_volume(volume, min_pt, max_pt, spacing);
 }
+
+// ----------------------------------------------------------------------------
+// Test sparse integration agrees with dense integration near the surfaces
+TEST(integrate_depth_maps, integrate_sparse)
+{
+  namespace mvg = kwiver::arrows::mvg;
+
+  std::vector< image_container_sptr > depth_maps;
+  std::vector< camera_perspective_sptr > cams;
+  vector_3d min_pt, max_pt;
+  auto K = simple_camera_intrinsics(
+    200, { 80, 60 }, 1.0, 0.0, {}, 160, 120);
+  make_test_data(depth_maps, cams, min_pt, max_pt, K);
+
+  mvg::integrate_depth_maps algorithm;
+  config_block_sptr config = algorithm.get_configuration();
+  config->set_value("voxel_spacing_factor", 1.0);
+  algorithm.set_configuration(config);
+  image_container_sptr dense_volume = nullptr;
+  vector_3d spacing{ 1.0, 1.0, 1.0 };
+  algorithm.integrate(min_pt, max_pt,
+                      depth_maps, {}, cams, dense_volume, spacing);
+
+  config->set_value("sparse", true);
+  config->set_value("sparse_unknown_nan", true);
+  algorithm.set_configuration(config);
+  image_container_sptr volume = nullptr;
+  vector_3d sparse_spacing{ 1.0, 1.0, 1.0 };
+  cpu_timer timer;
+  timer.start();
+  algorithm.integrate(min_pt, max_pt,
+                      depth_maps, {}, cams, volume, sparse_spacing);
+  timer.stop();
+  std::cout << "integration time: " << timer.elapsed() << std::endl;
+
+  EXPECT_EQ(spacing, sparse_spacing);
+  ASSERT_EQ(dense_volume->width(), volume->width());
+  ASSERT_EQ(dense_volume->height(), volume->height());
+  ASSERT_EQ(dense_volume->depth(), volume->depth());
+
+  // the sparse volume is returned without building a dense copy
+  EXPECT_NE(nullptr,
+            dynamic_cast<mvg::sparse_tsdf_image_container*>(volume.get()));
+
+  // voxels which are stored match the dense volume; rarely a voxel center
+  // rounds to a different pixel
+  image_of<double> dense_data(dense_volume->get_image());
+  image_of<double> sparse_data(volume->get_image());
+  size_t num_stored = 0;
+  size_t num_different = 0;
+  for (size_t k = 0; k < sparse_data.depth(); ++k)
+  {
+    for (size_t j = 0; j < sparse_data.height(); ++j)
+    {
+      for (size_t i = 0; i < sparse_data.width(); ++i)
+      {
+        double const v = sparse_data(i, j, k);
+        if (!std::isnan(v))
+        {
+          ++num_stored;
+          if (std::abs(v - dense_data(i, j, k)) > 1e-4)
+          {
+            ++num_different;
+          }
+        }
+      }
+    }
+  }
+  EXPECT_GT(num_stored, 0);
+  EXPECT_LT(num_stored, sparse_data.size());
+  EXPECT_LT(num_different, num_stored / 1000 + 1);
+
+  // compare the surfaces, the zero crossings between neighboring voxels;
+  // unknown voxels must not form a surface, and every surface of the dense
+  // volume must lie in the stored voxels
+  size_t num_dense_crossings = 0;
+  size_t num_missed = 0;
+  size_t num_spurious = 0;
+  auto compare_edge = [&](size_t i0, size_t j0, size_t k0,
+                          size_t i1, size_t j1, size_t k1)
+  {
+    bool const dense_crossing =
+      (dense_data(i0, j0, k0) < 0.0) != (dense_data(i1, j1, k1) < 0.0);
+    double const s0 = sparse_data(i0, j0, k0);
+    double const s1 = sparse_data(i1, j1, k1);
+    num_dense_crossings += dense_crossing;
+    if (std::isnan(s0) || std::isnan(s1))
+    {
+      num_missed += dense_crossing;
+    }
+    else if (((s0 < 0.0) != (s1 < 0.0)) != dense_crossing)
+    {
+      dense_crossing ? ++num_missed : ++num_spurious;
+    }
+  };
+  for (size_t k = 0; k < sparse_data.depth(); ++k)
+  {
+    for (size_t j = 0; j < sparse_data.height(); ++j)
+    {
+      for (size_t i = 0; i < sparse_data.width(); ++i)
+      {
+        if (i + 1 < sparse_data.width())
+        {
+          compare_edge(i, j, k, i + 1, j, k);
+        }
+        if (j + 1 < sparse_data.height())
+        {
+          compare_edge(i, j, k, i, j + 1, k);
+        }
+        if (k + 1 < sparse_data.depth())
+        {
+          compare_edge(i, j, k, i, j, k + 1);
+        }
+      }
+    }
+  }
+  std::cout << "dense crossings: " << num_dense_crossings
+            << " missed: " << num_missed
+            << " spurious: " << num_spurious << std::endl;
+  EXPECT_GT(num_dense_crossings, 0);
+  EXPECT_LT(num_missed, num_dense_crossings / 100 + 1);
+  EXPECT_LT(num_spurious, num_dense_crossings / 100 + 1);
+}
+
+// ----------------------------------------------------------------------------
+// Test blocks of a sparse volume are only allocated near the surface
+TEST(integrate_depth_maps, sparse_volume_blocks)
+{
+  namespace mvg = kwiver::arrows::mvg;
+
+  std::vector< image_container_sptr > depth_maps;
+  std::vector< camera_perspective_sptr > cams;
+  vector_3d min_pt, max_pt;
+  auto K = simple_camera_intrinsics(
+    200, { 80, 60 }, 1.0, 0.0, {}, 160, 120);
+  make_test_data(depth_maps, cams, min_pt, max_pt, K);
+
+  // 0.02 unit voxels with a truncation band of 0.1 units
+  vector_3d const spacing{ 0.02, 0.02, 0.02 };
+  Eigen::Vector3i const dims =
+    ((max_pt - min_pt).array() / spacing.array()).cast<int>();
+  mvg::tsdf_potential const potential = { 1.0, 0.1, 0.1, -1.0, 0.01 };
+  mvg::sparse_tsdf_volume volume(min_pt, spacing, dims, potential);
+  EXPECT_EQ(0, volume.num_blocks());
+
+  image_of<double> depth(depth_maps[0]->get_image());
+  auto const num_added = volume.allocate(*cams[0], depth);
+  EXPECT_EQ(num_added, volume.num_blocks());
+  EXPECT_EQ(0, volume.allocate(*cams[0], depth));
+
+  // the block near the top face of the upper box is allocated, the blocks
+  // at the center of the lower box and in the corner of the region are not
+  auto index = [&](vector_3d const& pt)
+  {
+    return Eigen::Vector3i(
+      ((pt - min_pt).array() / spacing.array()).cast<int>());
+  };
+  auto const top = index({ 0.0, 0.0, 1.0 });
+  auto const center = index({ 0.0, 0.0, 0.0 });
+  auto const corner = index({ 0.99, 0.99, 1.19 });
+  EXPECT_TRUE(volume.is_allocated(top[0], top[1], top[2]));
+  EXPECT_FALSE(volume.is_allocated(center[0], center[1], center[2]));
+  EXPECT_FALSE(volume.is_allocated(corner[0], corner[1], corner[2]));
+
+  int const bs = mvg::sparse_tsdf_volume::block_size;
+  size_t const num_grid_blocks = static_cast<size_t>(
+    ((dims.array() + bs - 1) / bs).prod());
+  EXPECT_LT(volume.num_blocks(), num_grid_blocks / 2);
+
+  // just above the top surface is free space and just below is inside
+  volume.integrate(*cams[0], depth);
+  auto const above = index({ 0.0, 0.0, 1.05 });
+  auto const below = index({ 0.0, 0.0, 0.95 });
+  EXPECT_LT(volume.value(above[0], above[1], above[2]), 0.0f);
+  EXPECT_GT(volume.value(below[0], below[1], below[2]), 0.0f);
+  EXPECT_EQ(0.0f, volume.value(center[0], center[1], center[2]));
+
+  image_of<double> dense;
+  volume.to_image(dense);
+  EXPECT_EQ(dims[0], dense.width());
+  EXPECT_EQ(dims[1], dense.height());
+  EXPECT_EQ(dims[2], dense.depth());
+  EXPECT_EQ(volume.value(below[0], below[1], below[2]),
+            dense(below[0], below[1], below[2]));
+  EXPECT_EQ(0.0, dense(center[0], center[1], center[2]));
+
+  // copying into an array with k varying fastest matches the image
+  std::vector<double> data(dense.size());
+  ptrdiff_t const i_step = dims[1] * dims[2];
+  ptrdiff_t const j_step = dims[2];
+  volume.copy_to(data.data(), i_step, j_step, 1);
+  size_t num_different = 0;
+  for (int k = 0; k < dims[2]; ++k)
+  {
+    for (int j = 0; j < dims[1]; ++j)
+    {
+      for (int i = 0; i < dims[0]; ++i)
+      {
+        num_different += data[i * i_step + j * j_step + k] != dense(i, j, k);
+      }
+    }
+  }
+  EXPECT_EQ(0, num_different);
+
+  // unallocated voxels may be marked unknown instead
+  mvg::sparse_tsdf_volume unknown_volume(
+    min_pt, spacing, dims, potential,
+    std::numeric_limits<float>::quiet_NaN());
+  unknown_volume.allocate(*cams[0], depth);
+  unknown_volume.integrate(*cams[0], depth);
+  EXPECT_EQ(volume.value(below[0], below[1], below[2]),
+            unknown_volume.value(below[0], below[1], below[2]));
+  EXPECT_TRUE(std::isnan(
+    unknown_volume.value(center[0], center[1], center[2])));
+  unknown_volume.to_image(dense);
+  EXPECT_TRUE(std::isnan(dense(center[0], center[1], center[2])));
+}
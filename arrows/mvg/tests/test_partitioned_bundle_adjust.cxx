@@ -0,0 +1,187 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include <test_scene.h>
+
+#include <arrows/mvg/algo/partitioned_bundle_adjust.h>
+#include <arrows/mvg/metrics.h>
+#include <arrows/mvg/projected_track_set.h>
+#include <arrows/mvg/transform.h>
+
+#include <vital/algo/algorithm_factory.h>
+#include <vital/plugin_loader/plugin_manager.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <atomic>
+
+using namespace kwiver::vital;
+using namespace kwiver::arrows::mvg;
+
+namespace {
+
+std::atomic<size_t> num_calls;
+std::atomic<size_t> max_cameras;
+
+// ----------------------------------------------------------------------------
+// Bundle adjuster that leaves the solution unchanged except for moving it
+// to a different coordinate frame, as a solver free of gauge constraints may
+class drift_bundle_adjust
+  : public algo::bundle_adjust
+{
+public:
+  PLUGIN_INFO( "test_drift", "Moves the solution by a similarity transform" )
+
+  void set_configuration(config_block_sptr) override { }
+  bool check_configuration(config_block_sptr) const override { return true; }
+
+  void optimize(camera_map_sptr& cameras,
+                landmark_map_sptr& landmarks,
+                feature_track_set_sptr,
+                sfm_constraints_sptr) const override
+  {
+    ++num_calls;
+    size_t n = max_cameras;
+    while (n < cameras->size() &&
+           !max_cameras.compare_exchange_weak(n, cameras->size())) { }
+
+    similarity_d const drift(1.5, rotation_d(vector_3d(0.1, -0.2, 0.3)),
+                             vector_3d(2, -1, 4));
+    cameras = transform(cameras, drift);
+    landmarks = transform(landmarks, drift);
+  }
+
+  using algo::bundle_adjust::optimize;
+};
+
+// ----------------------------------------------------------------------------
+void
+register_drift_bundle_adjust()
+{
+  static bool registered = false;
+  if (!registered)
+  {
+    auto& vpm = plugin_manager::instance();
+    vpm.load_all_plugins();
+    vpm.ADD_ALGORITHM("test_drift", drift_bundle_adjust);
+    registered = true;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Keep only the observations of each landmark from a window of nearby
+// frames, as in a long sequence where landmarks leave the view
+feature_track_set_sptr
+windowed_tracks(feature_track_set_sptr tracks, frame_id_t num_frames,
+                frame_id_t half_width)
+{
+  std::vector<track_sptr> windowed;
+  auto const all = tracks->tracks();
+  for (size_t i = 0; i < all.size(); ++i)
+  {
+    auto const center = static_cast<frame_id_t>(i * num_frames / all.size());
+    auto trk = track::create();
+    trk->set_id(all[i]->id());
+    for (auto const& ts : *all[i])
+    {
+      if (std::abs(ts->frame() - center) <= half_width)
+      {
+        trk->append(ts->clone());
+      }
+    }
+    windowed.push_back(trk);
+  }
+  return std::make_shared<feature_track_set>(windowed);
+}
+
+} // end namespace
+
+// ----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
+
+// ----------------------------------------------------------------------------
+TEST(partitioned_bundle_adjust, create)
+{
+  plugin_manager::instance().load_all_plugins();
+
+  EXPECT_NE(nullptr, algo::bundle_adjust::create("partitioned"));
+}
+
+// ----------------------------------------------------------------------------
+// Submaps are solved separately and mapped back to the input frame
+TEST(partitioned_bundle_adjust, merge_submaps)
+{
+  register_drift_bundle_adjust();
+
+  partitioned_bundle_adjust ba;
+  auto cfg = ba.get_configuration();
+  cfg->set_value("max_submap_cameras", 20);
+  cfg->set_value("overlap_cameras", 2);
+  cfg->set_value("sba_impl:type", "test_drift");
+  ba.set_configuration(cfg);
+  ASSERT_TRUE(ba.check_configuration(ba.get_configuration()));
+
+  landmark_map_sptr landmarks =
+    kwiver::testing::noisy_landmarks(kwiver::testing::init_landmarks(300), 1.0);
+  camera_map_sptr cameras = kwiver::testing::camera_seq(60);
+  feature_track_set_sptr tracks =
+    windowed_tracks(projected_tracks(landmarks, cameras), 60, 2);
+
+  auto const input_cams = cameras->cameras();
+  auto const input_lms = landmarks->landmarks();
+
+  num_calls = 0;
+  max_cameras = 0;
+  ba.optimize(cameras, landmarks, tracks);
+
+  // three submaps and the separator pass, none of them the whole problem
+  EXPECT_EQ(4, num_calls);
+  EXPECT_GT(cameras->size(), max_cameras);
+
+  ASSERT_EQ(input_cams.size(), cameras->size());
+  ASSERT_EQ(input_lms.size(), landmarks->size());
+  for (auto const& p : cameras->cameras())
+  {
+    auto const a = std::dynamic_pointer_cast<camera_perspective>(p.second);
+    auto const b = std::dynamic_pointer_cast<camera_perspective>(
+      input_cams.at(p.first));
+    EXPECT_TRUE(a->center().isApprox(b->center(), 1e-8)) << p.first;
+  }
+  for (auto const& p : landmarks->landmarks())
+  {
+    EXPECT_TRUE(p.second->loc().isApprox(input_lms.at(p.first)->loc(), 1e-8))
+      << p.first;
+  }
+
+  double const rmse = reprojection_rmse(cameras->cameras(),
+                                        landmarks->landmarks(),
+                                        tracks->tracks());
+  EXPECT_NEAR(0.0, rmse, 1e-6);
+}
+
+// ----------------------------------------------------------------------------
+// Problems no larger than one submap go straight to the nested algorithm
+TEST(partitioned_bundle_adjust, small_problem)
+{
+  register_drift_bundle_adjust();
+
+  partitioned_bundle_adjust ba;
+  auto cfg = ba.get_configuration();
+  cfg->set_value("sba_impl:type", "test_drift");
+  ba.set_configuration(cfg);
+
+  landmark_map_sptr landmarks = kwiver::testing::cube_corners(2.0);
+  camera_map_sptr cameras = kwiver::testing::camera_seq(20);
+  feature_track_set_sptr tracks = projected_tracks(landmarks, cameras);
+
+  num_calls = 0;
+  ba.optimize(cameras, landmarks, tracks);
+  EXPECT_EQ(1, num_calls);
+}
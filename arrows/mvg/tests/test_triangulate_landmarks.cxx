@@ -360,3 +360,38 @@ TEST(triangulate_landmarks, noisy_tracks_homog_ransac)
   tri_lm.set_configuration(cfg);
   kwiver::testing::test_noisy_tracks(tri_lm);
 }
+
+// ----------------------------------------------------------------------------
+// RANSAC triangulation gives the same answer every time, however the
+// landmarks are spread over threads
+TEST(triangulate_landmarks, repeatable_ransac)
+{
+  using namespace kwiver::vital;
+
+  kwiver::arrows::mvg::triangulate_landmarks tri_lm;
+  kwiver::vital::config_block_sptr cfg = tri_lm.get_configuration();
+  cfg->set_value("homogeneous", "false");
+  cfg->set_value("ransac", "true");
+  tri_lm.set_configuration(cfg);
+
+  landmark_map_sptr landmarks = kwiver::testing::init_landmarks(500);
+  camera_map_sptr cameras = kwiver::testing::camera_seq();
+  feature_track_set_sptr tracks = kwiver::testing::add_outliers_to_tracks(
+    kwiver::arrows::mvg::projected_tracks(landmarks, cameras), 0.2);
+
+  landmark_map_sptr landmarks0 = kwiver::testing::init_landmarks(500);
+  landmark_map_sptr landmarks1 = kwiver::testing::init_landmarks(500);
+  tri_lm.triangulate(cameras, tracks, landmarks0);
+  tri_lm.triangulate(cameras, tracks, landmarks1);
+
+  auto const lms0 = landmarks0->landmarks();
+  auto const lms1 = landmarks1->landmarks();
+  ASSERT_FALSE(lms0.empty());
+  ASSERT_EQ(lms0.size(), lms1.size());
+  for (auto const& p : lms0)
+  {
+    auto const it = lms1.find(p.first);
+    ASSERT_NE(lms1.end(), it);
+    EXPECT_EQ(p.second->loc(), it->second->loc()) << p.first;
+  }
+}
@@ -10,6 +10,7 @@
 #include "descriptor_set.h"
 
 #include <vital/exceptions.h>
+#include <vital/types/descriptor_matrix_set.h>
 
 /// This macro applies another macro to all of the types listed below.
 #define APPLY_TO_TYPES(MACRO) \
@@ -48,6 +49,25 @@ ocv_to_vital_descriptor(const cv::Mat& v)
   return vital::descriptor_sptr(d);
 }
 
+/// Templated helper function to convert a descriptor matrix into a cv::Mat
+/**
+ * The rows are copied with one memcpy each rather than being visited as
+ * individual descriptors.
+ */
+template <typename T>
+cv::Mat
+vital_descriptor_matrix_to_ocv(const vital::descriptor_matrix_set<T>& desc)
+{
+  const int num = static_cast<int>(desc.rows());
+  const int dim = static_cast<int>(desc.cols());
+  cv::Mat_<T> mat(num, dim);
+  for( int i=0; i<num; ++i )
+  {
+    std::memcpy(mat.ptr(i), desc.row(i), dim * sizeof(T));
+  }
+  return mat;
+}
+
 /// Templated helper function to convert descriptors into a cv::Mat
 template <typename T>
 cv::Mat
@@ -154,6 +174,16 @@ descriptors_to_ocv_matrix(const vital::descriptor_set& desc_set)
   {
     return d->ocv_desc_matrix();
   }
+  // if the descriptor set is a dense matrix then copy its rows directly
+  /// \cond DoxygenSuppress
+#define CONVERT_CASE(T) \
+  if( auto dm = dynamic_cast<const vital::descriptor_matrix_set<T>*>(&desc_set) ) \
+  { \
+    return vital_descriptor_matrix_to_ocv<T>(*dm); \
+  }
+  APPLY_TO_TYPES(CONVERT_CASE);
+#undef CONVERT_CASE
+  /// \endcond
   std::vector<vital::descriptor_sptr> desc = desc_set.descriptors();
   if( desc.empty() || !desc[0] )
   {
@@ -0,0 +1,47 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "activity.h"
+
+#include "load_save.h"
+
+#include <vital/types/activity.h>
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+// ----------------------------------------------------------------------------
+activity::
+activity()
+{ }
+
+activity::
+~activity()
+{ }
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< std::string >
+activity::
+serialize( const vital::any& element )
+{
+  const kwiver::vital::activity obj =
+    kwiver::vital::any_cast< kwiver::vital::activity > ( element );
+
+  return save_message( "activity", obj );
+}
+
+// ----------------------------------------------------------------------------
+vital::any
+activity::
+deserialize( const std::string& message )
+{
+  kwiver::vital::activity obj;
+  load_message( message, "activity", obj, logger() );
+
+  return kwiver::vital::any( obj );
+}
+
+} } } }       // end namespace kwiver
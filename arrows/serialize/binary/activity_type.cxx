@@ -0,0 +1,47 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "activity_type.h"
+
+#include "load_save.h"
+
+#include <vital/types/activity_type.h>
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+// ----------------------------------------------------------------------------
+activity_type::
+activity_type()
+{ }
+
+activity_type::
+~activity_type()
+{ }
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< std::string >
+activity_type::
+serialize( const vital::any& element )
+{
+  const kwiver::vital::activity_type obj =
+    kwiver::vital::any_cast< kwiver::vital::activity_type > ( element );
+
+  return save_message( "activity_type", obj );
+}
+
+// ----------------------------------------------------------------------------
+vital::any
+activity_type::
+deserialize( const std::string& message )
+{
+  kwiver::vital::activity_type obj;
+  load_message( message, "activity_type", obj, logger() );
+
+  return kwiver::vital::any( obj );
+}
+
+} } } }       // end namespace kwiver
@@ -0,0 +1,47 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "bounding_box.h"
+
+#include "load_save.h"
+
+#include <vital/types/bounding_box.h>
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+// ----------------------------------------------------------------------------
+bounding_box::
+bounding_box()
+{ }
+
+bounding_box::
+~bounding_box()
+{ }
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< std::string >
+bounding_box::
+serialize( const vital::any& element )
+{
+  const kwiver::vital::bounding_box_d obj =
+    kwiver::vital::any_cast< kwiver::vital::bounding_box_d > ( element );
+
+  return save_message( "bounding_box", obj );
+}
+
+// ----------------------------------------------------------------------------
+vital::any
+bounding_box::
+deserialize( const std::string& message )
+{
+  kwiver::vital::bounding_box_d obj{ 0, 0, 0, 0 };
+  load_message( message, "bounding_box", obj, logger() );
+
+  return kwiver::vital::any( obj );
+}
+
+} } } }       // end namespace kwiver
@@ -0,0 +1,48 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "detected_object.h"
+
+#include "load_save.h"
+
+#include <vital/types/detected_object.h>
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+// ----------------------------------------------------------------------------
+detected_object::
+detected_object()
+{ }
+
+detected_object::
+~detected_object()
+{ }
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< std::string >
+detected_object::
+serialize( const vital::any& element )
+{
+  const kwiver::vital::detected_object_sptr obj =
+    kwiver::vital::any_cast< kwiver::vital::detected_object_sptr > ( element );
+
+  return save_message( "detected_object", *obj );
+}
+
+// ----------------------------------------------------------------------------
+vital::any
+detected_object::
+deserialize( const std::string& message )
+{
+  auto obj = std::make_shared< kwiver::vital::detected_object >(
+    kwiver::vital::bounding_box_d{ 0, 0, 0, 0 } );
+  load_message( message, "detected_object", *obj, logger() );
+
+  return kwiver::vital::any( obj );
+}
+
+} } } }       // end namespace kwiver
@@ -0,0 +1,47 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "detected_object_set.h"
+
+#include "load_save.h"
+
+#include <vital/types/detected_object_set.h>
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+// ----------------------------------------------------------------------------
+detected_object_set::
+detected_object_set()
+{ }
+
+detected_object_set::
+~detected_object_set()
+{ }
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< std::string >
+detected_object_set::
+serialize( const vital::any& element )
+{
+  const kwiver::vital::detected_object_set_sptr obj =
+    kwiver::vital::any_cast< kwiver::vital::detected_object_set_sptr > ( element );
+
+  return save_message( "detected_object_set", *obj );
+}
+
+// ----------------------------------------------------------------------------
+vital::any
+detected_object_set::
+deserialize( const std::string& message )
+{
+  auto obj = std::make_shared< kwiver::vital::detected_object_set >();
+  load_message( message, "detected_object_set", *obj, logger() );
+
+  return kwiver::vital::any( obj );
+}
+
+} } } }       // end namespace kwiver
@@ -0,0 +1,47 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "detected_object_type.h"
+
+#include "load_save.h"
+
+#include <vital/types/detected_object_type.h>
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+// ----------------------------------------------------------------------------
+detected_object_type::
+detected_object_type()
+{ }
+
+detected_object_type::
+~detected_object_type()
+{ }
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< std::string >
+detected_object_type::
+serialize( const vital::any& element )
+{
+  const kwiver::vital::detected_object_type obj =
+    kwiver::vital::any_cast< kwiver::vital::detected_object_type > ( element );
+
+  return save_message( "detected_object_type", obj );
+}
+
+// ----------------------------------------------------------------------------
+vital::any
+detected_object_type::
+deserialize( const std::string& message )
+{
+  kwiver::vital::detected_object_type obj;
+  load_message( message, "detected_object_type", obj, logger() );
+
+  return kwiver::vital::any( obj );
+}
+
+} } } }       // end namespace kwiver
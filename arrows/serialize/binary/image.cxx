@@ -0,0 +1,47 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "image.h"
+
+#include "load_save.h"
+
+#include <vital/types/image_container.h>
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+// ----------------------------------------------------------------------------
+image::
+image()
+{ }
+
+image::
+~image()
+{ }
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< std::string >
+image::
+serialize( const vital::any& element )
+{
+  const kwiver::vital::image_container_sptr obj =
+    kwiver::vital::any_cast< kwiver::vital::image_container_sptr > ( element );
+
+  return save_message( "image", obj );
+}
+
+// ----------------------------------------------------------------------------
+vital::any
+image::
+deserialize( const std::string& message )
+{
+  kwiver::vital::image_container_sptr obj;
+  load_message( message, "image", obj, logger() );
+
+  return kwiver::vital::any( obj );
+}
+
+} } } }       // end namespace kwiver
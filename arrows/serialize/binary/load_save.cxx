@@ -0,0 +1,796 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "load_save.h"
+
+#include <vital/types/detected_object.h>
+#include <vital/types/detected_object_set.h>
+#include <vital/types/geo_point.h>
+#include <vital/types/object_track_set.h>
+#include <vital/types/timestamp.h>
+#include <vital/types/track.h>
+#include <vital/types/track_set.h>
+#include <vital/vital_types.h>
+
+#include <vital/internal/cereal/types/map.hpp>
+#include <vital/internal/cereal/types/vector.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace cereal {
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// Write a fixed size array of values.  Multi-byte values are byte
+// swapped as needed by the archive, so this is portable.
+//
+// The pointer is passed to binary_data() as an rvalue so it deduces the
+// element type, which sets the size of the values to swap.
+template < typename T >
+void save_values( ::cereal::PortableBinaryOutputArchive& archive,
+                  const T* data, size_t count )
+{
+  archive( ::cereal::binary_data( std::move( data ), count * sizeof( T ) ) );
+}
+
+// ----------------------------------------------------------------------------
+template < typename T >
+void load_values( ::cereal::PortableBinaryInputArchive& archive,
+                  T* data, size_t count )
+{
+  archive( ::cereal::binary_data( std::move( data ), count * sizeof( T ) ) );
+}
+
+// ----------------------------------------------------------------------------
+// Write a block of pixels as values of their size, so multi-byte
+// pixels are read back correctly on a host of either byte order.
+void save_pixels( ::cereal::PortableBinaryOutputArchive& archive,
+                  const void* data, size_t size, size_t num_bytes )
+{
+  switch ( num_bytes )
+  {
+    case 2:
+      save_values( archive, static_cast< const uint16_t* >( data ), size / 2 );
+      break;
+
+    case 4:
+      save_values( archive, static_cast< const uint32_t* >( data ), size / 4 );
+      break;
+
+    case 8:
+      save_values( archive, static_cast< const uint64_t* >( data ), size / 8 );
+      break;
+
+    default:
+      save_values( archive, static_cast< const uint8_t* >( data ), size );
+      break;
+  }
+}
+
+// ----------------------------------------------------------------------------
+void load_pixels( ::cereal::PortableBinaryInputArchive& archive,
+                  void* data, size_t size, size_t num_bytes )
+{
+  switch ( num_bytes )
+  {
+    case 2:
+      load_values( archive, static_cast< uint16_t* >( data ), size / 2 );
+      break;
+
+    case 4:
+      load_values( archive, static_cast< uint32_t* >( data ), size / 4 );
+      break;
+
+    case 8:
+      load_values( archive, static_cast< uint64_t* >( data ), size / 8 );
+      break;
+
+    default:
+      load_values( archive, static_cast< uint8_t* >( data ), size );
+      break;
+  }
+}
+
+// ----------------------------------------------------------------------------
+template < class P >
+void save_point( ::cereal::PortableBinaryOutputArchive& archive, const P& pt )
+{
+  const typename P::vector_type value = pt.value();
+  save_values( archive, value.data(), value.size() );
+
+  const typename P::covariance_type cov = pt.covariance();
+  save_values( archive, cov.data(), P::covariance_type::data_size );
+}
+
+// ----------------------------------------------------------------------------
+template < class P >
+void load_point( ::cereal::PortableBinaryInputArchive& archive, P& pt )
+{
+  typename P::vector_type value;
+  load_values( archive, value.data(), value.size() );
+  pt.set_value( value );
+
+  typename P::covariance_type cov;
+  typename P::covariance_type::data_type
+    cov_values[ P::covariance_type::data_size ];
+  load_values( archive, cov_values, P::covariance_type::data_size );
+  cov.set_data( cov_values );
+  pt.set_covariance( cov );
+}
+
+// ----------------------------------------------------------------------------
+// Scores of a detected_object_type or activity_type, written as
+// (name, score) pairs.
+template < class C >
+void save_scores( ::cereal::PortableBinaryOutputArchive& archive, const C& scores )
+{
+  archive( ::cereal::make_size_tag( static_cast< ::cereal::size_type >( scores.size() ) ) );
+  for ( const auto& entry : scores )
+  {
+    archive( *entry.first, entry.second );
+  }
+}
+
+// ----------------------------------------------------------------------------
+template < class C >
+void load_scores( ::cereal::PortableBinaryInputArchive& archive, C& scores )
+{
+  ::cereal::size_type size;
+  archive( ::cereal::make_size_tag( size ) );
+
+  std::string name;
+  double score;
+  for ( ::cereal::size_type i = 0; i < size; ++i )
+  {
+    archive( name, score );
+    scores.set_score( name, score );
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Tracks of a track set, each followed by its states
+template < class S >
+void save_tracks( ::cereal::PortableBinaryOutputArchive& archive, const S& trk_set )
+{
+  const auto tracks = trk_set.tracks();
+  archive( ::cereal::make_size_tag( static_cast< ::cereal::size_type >( tracks.size() ) ) );
+  for ( const auto& trk : tracks )
+  {
+    save( archive, *trk );
+  }
+}
+
+// ----------------------------------------------------------------------------
+template < class S >
+void load_tracks( ::cereal::PortableBinaryInputArchive& archive, S& trk_set )
+{
+  ::cereal::size_type size;
+  archive( ::cereal::make_size_tag( size ) );
+
+  std::vector< ::kwiver::vital::track_sptr > tracks;
+  tracks.reserve( size );
+  for ( ::cereal::size_type i = 0; i < size; ++i )
+  {
+    auto trk = ::kwiver::vital::track::create();
+    load( archive, *trk );
+    tracks.push_back( trk );
+  }
+  trk_set.set_tracks( tracks );
+}
+
+} // end namespace
+
+// ============================================================================
+void save( ::cereal::PortableBinaryOutputArchive& archive,
+           const ::kwiver::vital::activity& activity )
+{
+  archive( activity.id(), activity.label(), activity.confidence() );
+  save( archive, activity.start() );
+  save( archive, activity.end() );
+
+  // These may be null
+  const auto act_type = activity.type();
+  archive( static_cast< bool >( act_type ) );
+  if ( act_type )
+  {
+    save( archive, *act_type );
+  }
+
+  const auto participants = activity.participants();
+  archive( static_cast< bool >( participants ) );
+  if ( participants )
+  {
+    save( archive, *participants );
+  }
+}
+
+// ----------------------------------------------------------------------------
+void load( ::cereal::PortableBinaryInputArchive& archive,
+           ::kwiver::vital::activity& activity )
+{
+  ::kwiver::vital::activity_id_t id;
+  ::kwiver::vital::activity_label_t label;
+  double confidence;
+  ::kwiver::vital::timestamp start_frame, end_frame;
+
+  archive( id, label, confidence );
+  load( archive, start_frame );
+  load( archive, end_frame );
+
+  activity.set_id( id );
+  activity.set_label( label );
+  activity.set_confidence( confidence );
+  activity.set_start( start_frame );
+  activity.set_end( end_frame );
+
+  bool has_type;
+  archive( has_type );
+  ::kwiver::vital::activity_type_sptr act_type;
+  if ( has_type )
+  {
+    act_type = std::make_shared< ::kwiver::vital::activity_type >();
+    load( archive, *act_type );
+  }
+  activity.set_type( act_type );
+
+  bool has_participants;
+  archive( has_participants );
+  ::kwiver::vital::object_track_set_sptr participants;
+  if ( has_participants )
+  {
+    participants = std::make_shared< ::kwiver::vital::object_track_set >();
+    load( archive, *participants );
+  }
+  activity.set_participants( participants );
+}
+
+// ============================================================================
+void save( ::cereal::PortableBinaryOutputArchive& archive,
+           const ::kwiver::vital::activity_type& at )
+{
+  save_scores( archive, at );
+}
+
+// ----------------------------------------------------------------------------
+void load( ::cereal::PortableBinaryInputArchive& archive,
+           ::kwiver::vital::activity_type& at )
+{
+  load_scores( archive, at );
+}
+
+// ============================================================================
+void save( ::cereal::PortableBinaryOutputArchive& archive,
+           const ::kwiver::vital::bounding_box_d& bbox )
+{
+  archive( bbox.min_x(), bbox.min_y(), bbox.max_x(), bbox.max_y() );
+}
+
+// ----------------------------------------------------------------------------
+void load( ::cereal::PortableBinaryInputArchive& archive,
+           ::kwiver::vital::bounding_box_d& bbox )
+{
+  double min_x, min_y, max_x, max_y;
+  archive( min_x, min_y, max_x, max_y );
+
+  bbox = ::kwiver::vital::bounding_box_d( min_x, min_y, max_x, max_y );
+}
+
+// ============================================================================
+void save( ::cereal::PortableBinaryOutputArchive& archive,
+           const ::kwiver::vital::detected_object& obj )
+{
+  save( archive, obj.bounding_box() );
+
+  archive( obj.confidence(),
+           obj.index(),
+           obj.detector_name(),
+           obj.notes(),
+           obj.keypoints() );
+  save( archive, obj.geo_point() );
+
+  // This pointer may be null
+  const auto dot_ptr = obj.type();
+  archive( static_cast< bool >( dot_ptr ) );
+  if ( dot_ptr )
+  {
+    save( archive, *dot_ptr );
+  }
+
+  // Currently skipping the image chip and descriptor, as JSON does.
+}
+
+// ----------------------------------------------------------------------------
+void load( ::cereal::PortableBinaryInputArchive& archive,
+           ::kwiver::vital::detected_object& obj )
+{
+  ::kwiver::vital::bounding_box_d bbox { 0, 0, 0, 0 };
+  load( archive, bbox );
+  obj.set_bounding_box( bbox );
+
+  double confidence;
+  uint64_t index;
+  std::string detector_name;
+  ::kwiver::vital::detected_object::notes_t notes;
+  ::kwiver::vital::detected_object::keypoints_t keypoints;
+  ::kwiver::vital::geo_point geo_point;
+
+  archive( confidence,
+           index,
+           detector_name,
+           notes,
+           keypoints );
+  load( archive, geo_point );
+
+  obj.set_confidence( confidence );
+  obj.set_index( index );
+  obj.set_detector_name( detector_name );
+  obj.set_geo_point( geo_point );
+
+  for ( const auto& n : notes )
+  {
+    obj.add_note( n );
+  }
+
+  for ( const auto& kp : keypoints )
+  {
+    obj.add_keypoint( kp.first, kp.second );
+  }
+
+  bool has_type;
+  archive( has_type );
+  ::kwiver::vital::detected_object_type_sptr dot;
+  if ( has_type )
+  {
+    dot = std::make_shared< ::kwiver::vital::detected_object_type >();
+    load( archive, *dot );
+  }
+  obj.set_type( dot );
+}
+
+// ============================================================================
+void save( ::cereal::PortableBinaryOutputArchive& archive,
+           const ::kwiver::vital::detected_object_set& obj )
+{
+  archive( ::cereal::make_size_tag( static_cast< ::cereal::size_type >( obj.size() ) ) );
+
+  for ( auto element = obj.cbegin(); element != obj.cend(); ++element )
+  {
+    save( archive, **element );
+  }
+
+  // currently not handling attributes
+}
+
+// ----------------------------------------------------------------------------
+void load( ::cereal::PortableBinaryInputArchive& archive,
+           ::kwiver::vital::detected_object_set& obj )
+{
+  ::cereal::size_type size;
+  archive( ::cereal::make_size_tag( size ) );
+
+  for ( ::cereal::size_type i = 0; i < size; ++i )
+  {
+    auto new_obj = std::make_shared< ::kwiver::vital::detected_object >(
+      ::kwiver::vital::bounding_box_d { 0, 0, 0, 0 } );
+    load( archive, *new_obj );
+
+    obj.add( new_obj );
+  }
+}
+
+// ============================================================================
+void save( ::cereal::PortableBinaryOutputArchive& archive,
+           const ::kwiver::vital::detected_object_type& dot )
+{
+  save_scores( archive, dot );
+}
+
+// ----------------------------------------------------------------------------
+void load( ::cereal::PortableBinaryInputArchive& archive,
+           ::kwiver::vital::detected_object_type& dot )
+{
+  load_scores( archive, dot );
+}
+
+// ============================================================================
+void save( ::cereal::PortableBinaryOutputArchive& archive,
+           const ::kwiver::vital::geo_point& point )
+{
+  if ( point.is_empty() )
+  {
+    const int crs( -1 ); // empty marker
+    archive( crs );
+  }
+  else
+  {
+    const auto loc = point.location( point.crs() );
+    archive( point.crs(), loc[0], loc[1], loc[2] );
+  }
+}
+
+// ----------------------------------------------------------------------------
+void load( ::cereal::PortableBinaryInputArchive& archive,
+           ::kwiver::vital::geo_point& point )
+{
+  int crs;
+  archive( crs );
+
+  if ( crs != -1 ) // empty marker
+  {
+    double x, y, z;
+    archive( x, y, z );
+
+    const ::kwiver::vital::geo_point::geo_3d_point_t raw( x, y, z );
+    point.set_location( raw, crs );
+  }
+}
+
+// ============================================================================
+// Pixels are written uncompressed; compressing costs more than it
+// saves for local transport.  Use the protobuf serializer's zlib codec
+// for images sent over slow links.
+void save( ::cereal::PortableBinaryOutputArchive& archive,
+           const ::kwiver::vital::image_container_sptr& ctr )
+{
+  archive( static_cast< bool >( ctr ) );
+  if ( ! ctr )
+  {
+    return;
+  }
+
+  const ::kwiver::vital::image vital_image = ctr->get_image();
+  ::kwiver::vital::image local_image;
+
+  // The pixels can be written straight from the input when they fill a
+  // block of memory starting at the first pixel.  Otherwise they must
+  // be consolidated into a contiguous block first.
+  if ( vital_image.is_contiguous() &&
+       vital_image.w_step() >= 0 &&
+       vital_image.h_step() >= 0 &&
+       vital_image.d_step() >= 0 )
+  {
+    local_image = vital_image;
+  }
+  else
+  {
+    local_image.copy_from( vital_image );
+  }
+
+  const auto pixel_trait = local_image.pixel_traits();
+  const size_t local_size = local_image.width() * local_image.height()
+    * local_image.depth() * pixel_trait.num_bytes;
+
+  archive( static_cast< uint64_t >( local_image.width() ),
+           static_cast< uint64_t >( local_image.height() ),
+           static_cast< uint64_t >( local_image.depth() ),
+
+           static_cast< int64_t >( local_image.w_step() ),
+           static_cast< int64_t >( local_image.h_step() ),
+           static_cast< int64_t >( local_image.d_step() ),
+
+           static_cast< int32_t >( pixel_trait.type ),
+           static_cast< uint32_t >( pixel_trait.num_bytes ) );
+
+  save_pixels( archive, local_image.first_pixel(), local_size,
+               pixel_trait.num_bytes );
+}
+
+// ----------------------------------------------------------------------------
+void load( ::cereal::PortableBinaryInputArchive& archive,
+           ::kwiver::vital::image_container_sptr& ctr )
+{
+  bool has_image;
+  archive( has_image );
+  if ( ! has_image )
+  {
+    ctr = nullptr;
+    return;
+  }
+
+  uint64_t width, height, depth;
+  int64_t w_step, h_step, d_step;
+  int32_t trait_type;
+  uint32_t trait_num_bytes;
+
+  archive( width, height, depth,
+           w_step, h_step, d_step,
+           trait_type, trait_num_bytes );
+
+  const ::kwiver::vital::image_pixel_traits pix_trait(
+    static_cast< ::kwiver::vital::image_pixel_traits::pixel_type >( trait_type ),
+    trait_num_bytes );
+
+  // check the size against what is left of the message before
+  // allocating for it, taking care that the product does not overflow
+  uint64_t img_size = trait_num_bytes;
+  const uint64_t max_size = std::min< uint64_t >(
+    ::kwiver::arrows::serialize::binary::input_source_scope::remaining(),
+    std::numeric_limits< size_t >::max() );
+  for ( const uint64_t n : { width, height, depth } )
+  {
+    if ( n != 0 && img_size > max_size / n )
+    {
+      VITAL_THROW( ::kwiver::vital::serialization_exception,
+                   "Image size exceeds the size of the message" );
+    }
+    img_size *= n;
+  }
+  if ( trait_num_bytes == 0 || img_size > max_size )
+  {
+    VITAL_THROW( ::kwiver::vital::serialization_exception,
+                 "Image size exceeds the size of the message" );
+  }
+
+  // read the pixels directly into the image memory
+  auto img_mem = std::make_shared< ::kwiver::vital::image_memory >(
+    static_cast< size_t >( img_size ) );
+  load_pixels( archive, img_mem->data(), static_cast< size_t >( img_size ),
+               trait_num_bytes );
+
+  auto vital_image = ::kwiver::vital::image( img_mem, img_mem->data(),
+                                             width, height, depth,
+                                             w_step, h_step, d_step,
+                                             pix_trait );
+
+  // the pixels are saved as one contiguous block, so any other steps
+  // would address memory outside of it
+  if ( img_size > 0 && ! vital_image.is_contiguous() )
+  {
+    VITAL_THROW( ::kwiver::vital::serialization_exception,
+                 "Image steps do not describe a contiguous block of pixels" );
+  }
+
+  ctr = std::make_shared< ::kwiver::vital::simple_image_container >( vital_image );
+}
+
+// ============================================================================
+void save( ::cereal::PortableBinaryOutputArchive& archive,
+           const ::kwiver::vital::object_track_set& obj_trk_set )
+{
+  save_tracks( archive, obj_trk_set );
+}
+
+// ----------------------------------------------------------------------------
+void load( ::cereal::PortableBinaryInputArchive& archive,
+           ::kwiver::vital::object_track_set& obj_trk_set )
+{
+  load_tracks( archive, obj_trk_set );
+}
+
+// ============================================================================
+void save( ::cereal::PortableBinaryOutputArchive& archive,
+           const ::kwiver::vital::object_track_state& obj_trk_state )
+{
+  save( archive, static_cast< const ::kwiver::vital::track_state& >( obj_trk_state ) );
+  archive( obj_trk_state.time() );
+  save( archive, obj_trk_state.image_point() );
+  save( archive, obj_trk_state.track_point() );
+
+  // This pointer may be null
+  const auto detection = obj_trk_state.detection();
+  archive( static_cast< bool >( detection ) );
+  if ( detection )
+  {
+    save( archive, *detection );
+  }
+}
+
+// ----------------------------------------------------------------------------
+void load( ::cereal::PortableBinaryInputArchive& archive,
+           ::kwiver::vital::object_track_state& obj_trk_state )
+{
+  load( archive, static_cast< ::kwiver::vital::track_state& >( obj_trk_state ) );
+
+  ::kwiver::vital::time_usec_t track_time;
+  archive( track_time );
+  obj_trk_state.set_time( track_time );
+
+  ::kwiver::vital::point_2d image_point;
+  load( archive, image_point );
+  obj_trk_state.set_image_point( image_point );
+
+  ::kwiver::vital::point_3d track_point;
+  load( archive, track_point );
+  obj_trk_state.set_track_point( track_point );
+
+  bool has_detection;
+  archive( has_detection );
+  ::kwiver::vital::detected_object_sptr detection;
+  if ( has_detection )
+  {
+    detection = std::make_shared< ::kwiver::vital::detected_object >(
+      ::kwiver::vital::bounding_box_d{ 0, 0, 0, 0 } );
+    load( archive, *detection );
+  }
+  obj_trk_state.set_detection( detection );
+}
+
+// ============================================================================
+void save( ::cereal::PortableBinaryOutputArchive& archive,
+           const ::kwiver::vital::timestamp& tstamp )
+{
+  archive( tstamp.has_valid_time(),
+           tstamp.has_valid_frame(),
+           tstamp.get_time_usec(),
+           tstamp.get_frame(),
+           tstamp.get_time_domain_index() );
+}
+
+// ----------------------------------------------------------------------------
+void load( ::cereal::PortableBinaryInputArchive& archive,
+           ::kwiver::vital::timestamp& tstamp )
+{
+  bool valid_time, valid_frame;
+  ::kwiver::vital::time_usec_t time;
+  ::kwiver::vital::frame_id_t frame;
+  int time_domain_index;
+
+  archive( valid_time, valid_frame, time, frame, time_domain_index );
+
+  tstamp = ::kwiver::vital::timestamp();
+  if ( valid_time )
+  {
+    tstamp.set_time_usec( time );
+  }
+  if ( valid_frame )
+  {
+    tstamp.set_frame( frame );
+  }
+  tstamp.set_time_domain_index( time_domain_index );
+}
+
+// ============================================================================
+// The states of a track are written with a flag marking object track
+// states, so they are restored with their detections.  Other kinds of
+// track state are reduced to their frame number.
+void save( ::cereal::PortableBinaryOutputArchive& archive,
+           const ::kwiver::vital::track& trk )
+{
+  archive( trk.id() );
+  archive( ::cereal::make_size_tag( static_cast< ::cereal::size_type >( trk.size() ) ) );
+
+  for ( const auto& trk_state : trk )
+  {
+    const auto obj_trk_state =
+      dynamic_cast< const ::kwiver::vital::object_track_state* >( trk_state.get() );
+    archive( obj_trk_state != nullptr );
+    if ( obj_trk_state )
+    {
+      save( archive, *obj_trk_state );
+    }
+    else
+    {
+      save( archive, *trk_state );
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+void load( ::cereal::PortableBinaryInputArchive& archive,
+           ::kwiver::vital::track& trk )
+{
+  ::kwiver::vital::track_id_t track_id;
+  ::cereal::size_type size;
+  archive( track_id );
+  archive( ::cereal::make_size_tag( size ) );
+  trk.set_id( track_id );
+
+  for ( ::cereal::size_type i = 0; i < size; ++i )
+  {
+    bool is_object_state;
+    archive( is_object_state );
+
+    ::kwiver::vital::track_state_sptr trk_state;
+    if ( is_object_state )
+    {
+      auto obj_trk_state = std::make_shared< ::kwiver::vital::object_track_state >();
+      load( archive, *obj_trk_state );
+      trk_state = obj_trk_state;
+    }
+    else
+    {
+      trk_state = std::make_shared< ::kwiver::vital::track_state >();
+      load( archive, *trk_state );
+    }
+
+    if ( ! trk.insert( trk_state ) )
+    {
+      LOG_ERROR( ::kwiver::vital::get_logger( "data_serializer" ),
+                 "Failed to insert track state in track" );
+    }
+  }
+}
+
+// ============================================================================
+void save( ::cereal::PortableBinaryOutputArchive& archive,
+           const ::kwiver::vital::track_set& trk_set )
+{
+  save_tracks( archive, trk_set );
+}
+
+// ----------------------------------------------------------------------------
+void load( ::cereal::PortableBinaryInputArchive& archive,
+           ::kwiver::vital::track_set& trk_set )
+{
+  load_tracks( archive, trk_set );
+}
+
+// ============================================================================
+void save( ::cereal::PortableBinaryOutputArchive& archive,
+           const ::kwiver::vital::track_state& trk_state )
+{
+  archive( trk_state.frame() );
+}
+
+// ----------------------------------------------------------------------------
+void load( ::cereal::PortableBinaryInputArchive& archive,
+           ::kwiver::vital::track_state& trk_state )
+{
+  ::kwiver::vital::frame_id_t track_frame;
+  archive( track_frame );
+  trk_state.set_frame( track_frame );
+}
+
+// ============================================================================
+#define LOAD_SAVE( P )                                                  \
+  void save( ::cereal::PortableBinaryOutputArchive& archive, const P& pt ) \
+  { save_point< P >( archive, pt ); }                                   \
+  void load( ::cereal::PortableBinaryInputArchive& archive, P& pt )     \
+  { load_point< P >( archive, pt ); }
+
+LOAD_SAVE( ::kwiver::vital::point_2i )
+LOAD_SAVE( ::kwiver::vital::point_2d )
+LOAD_SAVE( ::kwiver::vital::point_2f )
+LOAD_SAVE( ::kwiver::vital::point_3d )
+LOAD_SAVE( ::kwiver::vital::point_3f )
+LOAD_SAVE( ::kwiver::vital::point_4d )
+LOAD_SAVE( ::kwiver::vital::point_4f )
+
+#undef LOAD_SAVE
+
+} // end namespace cereal
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+namespace {
+
+// The source of the message being loaded on this thread
+thread_local std::streambuf* current_input_source = nullptr;
+
+} // end namespace
+
+// ----------------------------------------------------------------------------
+input_source_scope
+::input_source_scope( std::streambuf& buffer )
+  : m_previous( current_input_source )
+{
+  current_input_source = &buffer;
+}
+
+input_source_scope
+::~input_source_scope()
+{
+  current_input_source = m_previous;
+}
+
+// ----------------------------------------------------------------------------
+size_t
+input_source_scope
+::remaining()
+{
+  if ( ! current_input_source )
+  {
+    return std::numeric_limits< size_t >::max();
+  }
+  const auto n = current_input_source->in_avail();
+  return n > 0 ? static_cast< size_t >( n ) : 0;
+}
+
+} } } }       // end namespace kwiver
@@ -0,0 +1,227 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Private interface for saving and loading vital types with
+ * cereal portable binary archives.
+ *
+ * Each message is the type tag, a space, and the archive. Values are
+ * written in a fixed order without names, so save and load for a type
+ * must be kept in step.
+ */
+
+#ifndef ARROWS_SERIALIZATION_BINARY_LOAD_SAVE_H
+#define ARROWS_SERIALIZATION_BINARY_LOAD_SAVE_H
+
+#include <arrows/serialize/binary/kwiver_serialize_binary_export.h>
+
+#include <vital/exceptions.h>
+#include <vital/logger/logger.h>
+#include <vital/types/activity.h>
+#include <vital/types/activity_type.h>
+#include <vital/types/bounding_box.h>
+#include <vital/types/detected_object_type.h>
+#include <vital/types/image_container.h>
+#include <vital/types/point.h>
+
+#include <vital/internal/cereal/cereal.hpp>
+#include <vital/internal/cereal/archives/portable_binary.hpp>
+#include <vital/internal/cereal/types/string.hpp>
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+namespace kwiver {
+
+namespace vital {
+
+class detected_object;
+class detected_object_set;
+class geo_point;
+class object_track_set;
+class object_track_state;
+class timestamp;
+class track;
+class track_set;
+class track_state;
+
+} // namespace vital
+
+} // namespace kwiver
+
+namespace cereal {
+
+#define KWIVER_BINARY_LOAD_SAVE( T )                                    \
+  KWIVER_SERIALIZE_BINARY_EXPORT                                        \
+  void save( ::cereal::PortableBinaryOutputArchive& archive, T const& obj ); \
+  KWIVER_SERIALIZE_BINARY_EXPORT                                        \
+  void load( ::cereal::PortableBinaryInputArchive& archive, T& obj )
+
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::activity );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::activity_type );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::bounding_box_d );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::detected_object );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::detected_object_set );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::detected_object_type );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::geo_point );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::image_container_sptr );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::object_track_set );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::object_track_state );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::timestamp );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::track );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::track_set );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::track_state );
+
+// ---- points
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::point_2i );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::point_2d );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::point_2f );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::point_3d );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::point_3f );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::point_4d );
+KWIVER_BINARY_LOAD_SAVE( ::kwiver::vital::point_4f );
+
+#undef KWIVER_BINARY_LOAD_SAVE
+
+} // namespace cereal
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+// ----------------------------------------------------------------------------
+/// Stream buffer that appends to a string, so a message is written
+/// into its final buffer.
+class string_output_buffer
+  : public std::streambuf
+{
+public:
+  explicit string_output_buffer( std::string& str )
+    : m_str( str )
+  { }
+
+protected:
+  std::streamsize xsputn( const char* s, std::streamsize n ) override
+  {
+    m_str.append( s, static_cast< size_t >( n ) );
+    return n;
+  }
+
+  int_type overflow( int_type c ) override
+  {
+    if ( ! traits_type::eq_int_type( c, traits_type::eof() ) )
+    {
+      m_str.push_back( traits_type::to_char_type( c ) );
+    }
+    return traits_type::not_eof( c );
+  }
+
+private:
+  std::string& m_str;
+};
+
+// ----------------------------------------------------------------------------
+/// Read-only stream buffer over a block of memory, so a message can be
+/// loaded without copying it.
+class memory_input_buffer
+  : public std::streambuf
+{
+public:
+  memory_input_buffer( const char* data, size_t size )
+  {
+    char* p = const_cast< char* >( data );
+    setg( p, p, p + size );
+  }
+};
+
+// ----------------------------------------------------------------------------
+/// Make \p buffer the source of the archives loaded on this thread while
+/// this object exists, so that loaders can check a size read from a
+/// message against the bytes left in it before allocating for it.
+class KWIVER_SERIALIZE_BINARY_EXPORT input_source_scope
+{
+public:
+  explicit input_source_scope( std::streambuf& buffer );
+  ~input_source_scope();
+
+  /// The number of bytes left in the current source, or the largest
+  /// size_t when not loading within a scope.
+  static size_t remaining();
+
+private:
+  input_source_scope( const input_source_scope& ) = delete;
+  input_source_scope& operator=( const input_source_scope& ) = delete;
+
+  std::streambuf* m_previous;
+};
+
+// ----------------------------------------------------------------------------
+/// Make a message holding \p tag and the binary archive of \p obj.
+template < typename T >
+std::shared_ptr< std::string >
+save_message( const std::string& tag, const T& obj )
+{
+  auto msg = std::make_shared< std::string >( tag );
+  msg->push_back( ' ' );
+
+  string_output_buffer buffer( *msg );
+  std::ostream stream( &buffer );
+  {
+    ::cereal::PortableBinaryOutputArchive ar( stream );
+    save( ar, obj );
+  }
+
+  return msg;
+}
+
+// ----------------------------------------------------------------------------
+/// Load \p obj from a message made by save_message().
+///
+/// An error is logged and \p obj is left unchanged if the message does
+/// not have the expected tag.
+///
+/// \returns \b true if the message was loaded.
+/// \throws vital::serialization_exception if the archive is malformed.
+template < typename T >
+bool
+load_message( const std::string& message, const std::string& tag, T& obj,
+              vital::logger_handle_t logger )
+{
+  if ( message.size() <= tag.size() ||
+       message.compare( 0, tag.size(), tag ) != 0 ||
+       message[ tag.size() ] != ' ' )
+  {
+    LOG_ERROR( logger, "Invalid data type tag received. Expected \""
+               << tag << "\", received \""
+               << message.substr( 0, message.find( ' ' ) )
+               << "\". Message dropped." );
+    return false;
+  }
+
+  const size_t offset = tag.size() + 1;
+  memory_input_buffer buffer( message.data() + offset, message.size() - offset );
+  std::istream stream( &buffer );
+  input_source_scope scope( buffer );
+  try
+  {
+    ::cereal::PortableBinaryInputArchive ar( stream );
+    load( ar, obj );
+  }
+  catch ( const ::cereal::Exception& e )
+  {
+    VITAL_THROW( vital::serialization_exception,
+                 "Error deserializing " + tag + ": " + e.what() );
+  }
+
+  return true;
+}
+
+} } } }       // end namespace kwiver
+
+#endif // ARROWS_SERIALIZATION_BINARY_LOAD_SAVE_H
@@ -0,0 +1,47 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "object_track_set.h"
+
+#include "load_save.h"
+
+#include <vital/types/object_track_set.h>
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+// ----------------------------------------------------------------------------
+object_track_set::
+object_track_set()
+{ }
+
+object_track_set::
+~object_track_set()
+{ }
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< std::string >
+object_track_set::
+serialize( const vital::any& element )
+{
+  const kwiver::vital::object_track_set_sptr obj =
+    kwiver::vital::any_cast< kwiver::vital::object_track_set_sptr > ( element );
+
+  return save_message( "object_track_set", *obj );
+}
+
+// ----------------------------------------------------------------------------
+vital::any
+object_track_set::
+deserialize( const std::string& message )
+{
+  auto obj = std::make_shared< kwiver::vital::object_track_set >();
+  load_message( message, "object_track_set", *obj, logger() );
+
+  return kwiver::vital::any( obj );
+}
+
+} } } }       // end namespace kwiver
@@ -0,0 +1,45 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "string.h"
+
+#include "load_save.h"
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+// ----------------------------------------------------------------------------
+string::
+string()
+{ }
+
+string::
+~string()
+{ }
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< std::string >
+string::
+serialize( const vital::any& element )
+{
+  const std::string obj =
+    kwiver::vital::any_cast< std::string > ( element );
+
+  return save_message( "string", obj );
+}
+
+// ----------------------------------------------------------------------------
+vital::any
+string::
+deserialize( const std::string& message )
+{
+  std::string obj;
+  load_message( message, "string", obj, logger() );
+
+  return kwiver::vital::any( obj );
+}
+
+} } } }       // end namespace kwiver
@@ -0,0 +1,47 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "timestamp.h"
+
+#include "load_save.h"
+
+#include <vital/types/timestamp.h>
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+// ----------------------------------------------------------------------------
+timestamp::
+timestamp()
+{ }
+
+timestamp::
+~timestamp()
+{ }
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< std::string >
+timestamp::
+serialize( const vital::any& element )
+{
+  const kwiver::vital::timestamp obj =
+    kwiver::vital::any_cast< kwiver::vital::timestamp > ( element );
+
+  return save_message( "timestamp", obj );
+}
+
+// ----------------------------------------------------------------------------
+vital::any
+timestamp::
+deserialize( const std::string& message )
+{
+  kwiver::vital::timestamp obj;
+  load_message( message, "timestamp", obj, logger() );
+
+  return kwiver::vital::any( obj );
+}
+
+} } } }       // end namespace kwiver
@@ -0,0 +1,47 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "track.h"
+
+#include "load_save.h"
+
+#include <vital/types/track.h>
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+// ----------------------------------------------------------------------------
+track::
+track()
+{ }
+
+track::
+~track()
+{ }
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< std::string >
+track::
+serialize( const vital::any& element )
+{
+  const kwiver::vital::track_sptr obj =
+    kwiver::vital::any_cast< kwiver::vital::track_sptr > ( element );
+
+  return save_message( "track", *obj );
+}
+
+// ----------------------------------------------------------------------------
+vital::any
+track::
+deserialize( const std::string& message )
+{
+  auto obj = kwiver::vital::track::create();
+  load_message( message, "track", *obj, logger() );
+
+  return kwiver::vital::any( obj );
+}
+
+} } } }       // end namespace kwiver
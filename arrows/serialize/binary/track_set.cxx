@@ -0,0 +1,47 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "track_set.h"
+
+#include "load_save.h"
+
+#include <vital/types/track_set.h>
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+// ----------------------------------------------------------------------------
+track_set::
+track_set()
+{ }
+
+track_set::
+~track_set()
+{ }
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< std::string >
+track_set::
+serialize( const vital::any& element )
+{
+  const kwiver::vital::track_set_sptr obj =
+    kwiver::vital::any_cast< kwiver::vital::track_set_sptr > ( element );
+
+  return save_message( "track_set", *obj );
+}
+
+// ----------------------------------------------------------------------------
+vital::any
+track_set::
+deserialize( const std::string& message )
+{
+  auto obj = std::make_shared< kwiver::vital::track_set >();
+  load_message( message, "track_set", *obj, logger() );
+
+  return kwiver::vital::any( obj );
+}
+
+} } } }       // end namespace kwiver
@@ -0,0 +1,47 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "track_state.h"
+
+#include "load_save.h"
+
+#include <vital/types/track.h>
+
+namespace kwiver {
+namespace arrows {
+namespace serialize {
+namespace binary {
+
+// ----------------------------------------------------------------------------
+track_state::
+track_state()
+{ }
+
+track_state::
+~track_state()
+{ }
+
+// ----------------------------------------------------------------------------
+std::shared_ptr< std::string >
+track_state::
+serialize( const vital::any& element )
+{
+  const kwiver::vital::track_state obj =
+    kwiver::vital::any_cast< kwiver::vital::track_state > ( element );
+
+  return save_message( "track_state", obj );
+}
+
+// ----------------------------------------------------------------------------
+vital::any
+track_state::
+deserialize( const std::string& message )
+{
+  kwiver::vital::track_state obj;
+  load_message( message, "track_state", obj, logger() );
+
+  return kwiver::vital::any( obj );
+}
+
+} } } }       // end namespace kwiver
@@ -336,41 +336,57 @@ void convert_protobuf( const ::kwiver::protobuf::image&      proto_img,
   const size_t img_size( proto_img.size() );
   auto mem_sptr = std::make_shared<vital::image_memory>( img_size );
 
-  // decompress the data
-  uLongf out_size( img_size );
-  Bytef* out_buf = reinterpret_cast< Bytef* >( mem_sptr->data() );
-  Bytef const *in_buf = reinterpret_cast< Bytef const* >( proto_img.data().data() );
-  uLongf in_size = proto_img.data().size(); // compressed size
-
-  int z_rc = uncompress(out_buf, &out_size, // outputs
-                        in_buf, in_size);   // inputs
-  if (Z_OK != z_rc )
+  if ( proto_img.codec() == ::kwiver::protobuf::image::RAW )
   {
-    switch (z_rc)
+    if ( proto_img.data().size() != img_size )
     {
-    case Z_MEM_ERROR:
-      LOG_ERROR( ::kwiver::vital::get_logger( "data_serializer" ),
-                 "Error decompressing image data. Not enough memory." );
-      break;
-
-    case Z_BUF_ERROR:
-      LOG_ERROR( ::kwiver::vital::get_logger( "data_serializer" ),
-                 "Error decompressing image data. Not enough room in output buffer." );
-      break;
-
-    default:
-      LOG_ERROR( ::kwiver::vital::get_logger( "data_serializer" ),
-                 "Error decompressing image data." );
-      break;
-    } // end switch
-    return;
+      LOG_ERROR( ::kwiver::vital::get_logger( "image_container" ),
+                 "Raw image data not expected size. Possible data corruption.");
+      return;
+    }
+    if ( img_size > 0 )
+    {
+      std::memcpy( mem_sptr->data(), proto_img.data().data(), img_size );
+    }
   }
-
-  if (static_cast<uLongf>( img_size ) != out_size)
+  else
   {
-    LOG_ERROR( ::kwiver::vital::get_logger( "image_container" ),
-               "Uncompressed data not expected size. Possible data corruption.");
-    return;
+    // decompress the data
+    uLongf out_size( img_size );
+    Bytef* out_buf = reinterpret_cast< Bytef* >( mem_sptr->data() );
+    Bytef const *in_buf = reinterpret_cast< Bytef const* >( proto_img.data().data() );
+    uLongf in_size = proto_img.data().size(); // compressed size
+
+    int z_rc = uncompress(out_buf, &out_size, // outputs
+                          in_buf, in_size);   // inputs
+    if (Z_OK != z_rc )
+    {
+      switch (z_rc)
+      {
+      case Z_MEM_ERROR:
+        LOG_ERROR( ::kwiver::vital::get_logger( "data_serializer" ),
+                   "Error decompressing image data. Not enough memory." );
+        break;
+
+      case Z_BUF_ERROR:
+        LOG_ERROR( ::kwiver::vital::get_logger( "data_serializer" ),
+                   "Error decompressing image data. Not enough room in output buffer." );
+        break;
+
+      default:
+        LOG_ERROR( ::kwiver::vital::get_logger( "data_serializer" ),
+                   "Error decompressing image data." );
+        break;
+      } // end switch
+      return;
+    }
+
+    if (static_cast<uLongf>( img_size ) != out_size)
+    {
+      LOG_ERROR( ::kwiver::vital::get_logger( "image_container" ),
+                 "Uncompressed data not expected size. Possible data corruption.");
+      return;
+    }
   }
 
   // create pixel trait
@@ -402,85 +418,175 @@ void convert_protobuf( const ::kwiver::protobuf::image&      proto_img,
   }
 }
 
+namespace {
+
 // ----------------------------------------------------------------------------
-void convert_protobuf( const ::kwiver::vital::image_container_sptr img,
+// True if the pixels fill a block of memory starting at the first pixel.
+bool is_in_place( const ::kwiver::vital::image& vital_image )
+{
+  return vital_image.is_contiguous() &&
+    vital_image.w_step() >= 0 &&
+    vital_image.h_step() >= 0 &&
+    vital_image.d_step() >= 0;
+}
+
+// ----------------------------------------------------------------------------
+// Set every field of the message except the encoded pixels.
+void set_image_fields( const ::kwiver::vital::image_container_sptr img,
+                       const ::kwiver::vital::image&               local_image,
+                       size_t                                      local_size,
+                       image_codec                                 codec,
                        ::kwiver::protobuf::image&                  proto_img )
 {
-  ::kwiver::vital::image vital_image = img->get_image();
-  ::kwiver::vital::image local_image;
+  const auto pixel_trait = local_image.pixel_traits();
+
+  proto_img.set_width( static_cast< int64_t > ( local_image.width() ) );
+  proto_img.set_height( static_cast< int64_t > ( local_image.height() ) );
+  proto_img.set_depth( static_cast< int64_t > ( local_image.depth() ) );
+
+  proto_img.set_w_step( static_cast< int64_t > ( local_image.w_step() ) );
+  proto_img.set_h_step( static_cast< int64_t > ( local_image.h_step() ) );
+  proto_img.set_d_step( static_cast< int64_t > ( local_image.d_step() ) );
+
+  // Get pixel trait
+  proto_img.set_trait_type( pixel_trait.type );
+  proto_img.set_trait_num_bytes( pixel_trait.num_bytes );
 
-  if ( vital_image.memory() == nullptr || ! vital_image.is_contiguous() )
+  proto_img.set_size( local_size ); // uncompressed size
+  proto_img.set_codec( codec == image_codec::raw
+                       ? ::kwiver::protobuf::image::RAW
+                       : ::kwiver::protobuf::image::ZLIB );
+
+  // serialize the metadata if there is any.
+  if ( img->get_metadata() )
   {
-    // Either we do not own the memory or it is not contiguous.  We
-    // need to consolidate the input image into a contiguous memory
-    // block before it can be serialized.
-    local_image.copy_from( vital_image );
+    auto* proto_meta = proto_img.mutable_image_metadata();
+    convert_protobuf( *img->get_metadata(), *proto_meta );
   }
   else
   {
-    local_image = vital_image;
+    proto_img.clear_image_metadata();
   }
+}
 
-  // Compress raw pixel data
-  const uLongf size = compressBound( local_image.size() );
-  uLongf out_size(size);
-  std::vector<uint8_t> image_data( size );
-  Bytef *out_buf = new Bytef[size];
-  Bytef const* in_buf = reinterpret_cast< Bytef * >(local_image.memory()->data());
+} // end namespace
 
-  // Since the image is contiguous, we can calculate the size
-  size_t local_size = local_image.width() * local_image.height()
-    * local_image.depth() * local_image.pixel_traits().num_bytes;
+// ----------------------------------------------------------------------------
+void convert_protobuf( const ::kwiver::vital::image_container_sptr img,
+                       ::kwiver::protobuf::image&                  proto_img )
+{
+  convert_protobuf( img, proto_img, image_codec::zlib );
+}
 
-  int z_rc = compress( out_buf, &out_size, // outputs
-                       in_buf, local_size ); // inputs
-  if (Z_OK != z_rc )
-  {
-    switch (z_rc)
-    {
-    case Z_MEM_ERROR:
-      LOG_ERROR( ::kwiver::vital::get_logger( "image_container" ),
-                 "Error compressing image data. Not enough memory." );
-      break;
+// ----------------------------------------------------------------------------
+void convert_protobuf( const ::kwiver::vital::image_container_sptr img,
+                       ::kwiver::protobuf::image&                  proto_img,
+                       image_codec                                 codec,
+                       int                                         level )
+{
+  const ::kwiver::vital::image vital_image = img->get_image();
+  const auto pixel_trait = vital_image.pixel_traits();
+  const size_t local_size = vital_image.width() * vital_image.height()
+    * vital_image.depth() * pixel_trait.num_bytes;
 
-    case Z_BUF_ERROR:
-      LOG_ERROR( ::kwiver::vital::get_logger( "image_container" ),
-                 "Error compressing image data. Not enough room in output buffer." );
-      break;
+  // The pixels can be encoded straight from the input when they fill
+  // a block of memory starting at the first pixel.  Otherwise they
+  // must be consolidated into a contiguous block first.
+  const bool in_place = is_in_place( vital_image );
 
-    default:
-      LOG_ERROR( ::kwiver::vital::get_logger( "image_container" ),
-                 "Error compressing image data." );
-      break;
-    } // end switch
+  ::kwiver::vital::image local_image;
+  std::string& data = *proto_img.mutable_data();
+
+  if ( codec == image_codec::raw )
+  {
+    data.resize( local_size );
+    if ( in_place )
+    {
+      if ( local_size > 0 )
+      {
+        std::memcpy( &data[0], vital_image.first_pixel(), local_size );
+      }
+      local_image = vital_image;
+    }
+    else
+    {
+      // consolidate directly into the message
+      local_image = ::kwiver::vital::image(
+        &data[0], vital_image.width(), vital_image.height(), vital_image.depth(),
+        1, vital_image.width(), vital_image.width() * vital_image.height(),
+        pixel_trait );
+      local_image.copy_from( vital_image );
+    }
   }
   else
   {
+    if ( in_place )
+    {
+      local_image = vital_image;
+    }
+    else
+    {
+      local_image.copy_from( vital_image );
+    }
 
-    proto_img.set_width( static_cast< int64_t > ( local_image.width() ) );
-    proto_img.set_height( static_cast< int64_t > ( local_image.height() ) );
-    proto_img.set_depth( static_cast< int64_t > ( local_image.depth() ) );
-
-    proto_img.set_w_step( static_cast< int64_t > ( local_image.w_step() ) );
-    proto_img.set_h_step( static_cast< int64_t > ( local_image.h_step() ) );
-    proto_img.set_d_step( static_cast< int64_t > ( local_image.d_step() ) );
-
-    // Get pixel trait
-    auto pixel_trait = local_image.pixel_traits();
-    proto_img.set_trait_type( pixel_trait.type );
-    proto_img.set_trait_num_bytes( pixel_trait.num_bytes );
-
-    proto_img.set_size( local_image.size() ); // uncompressed size
-    proto_img.set_data( out_buf, size );
+    // Compress raw pixel data into the message
+    uLongf out_size = compressBound( local_size );
+    data.resize( out_size );
+    Bytef *out_buf = reinterpret_cast< Bytef* >( &data[0] );
+    Bytef const* in_buf = reinterpret_cast< Bytef const* >( local_image.first_pixel() );
 
-    // serialize the metadata if there is any.
-    if ( img->get_metadata() )
+    int z_rc = compress2( out_buf, &out_size, // outputs
+                          in_buf, local_size, level ); // inputs
+    if (Z_OK != z_rc )
     {
-      auto* proto_meta = proto_img.mutable_image_metadata();
-      convert_protobuf( *img->get_metadata(), *proto_meta );
+      switch (z_rc)
+      {
+      case Z_MEM_ERROR:
+        LOG_ERROR( ::kwiver::vital::get_logger( "image_container" ),
+                   "Error compressing image data. Not enough memory." );
+        break;
+
+      case Z_BUF_ERROR:
+        LOG_ERROR( ::kwiver::vital::get_logger( "image_container" ),
+                   "Error compressing image data. Not enough room in output buffer." );
+        break;
+
+      case Z_STREAM_ERROR:
+        LOG_ERROR( ::kwiver::vital::get_logger( "image_container" ),
+                   "Error compressing image data. Invalid compression level "
+                   << level << "." );
+        break;
+
+      default:
+        LOG_ERROR( ::kwiver::vital::get_logger( "image_container" ),
+                   "Error compressing image data." );
+        break;
+      } // end switch
+      data.clear();
+      return;
     }
+    data.resize( out_size );
   }
-  delete []out_buf;
+
+  set_image_fields( img, local_image, local_size, codec, proto_img );
+}
+
+// ----------------------------------------------------------------------------
+const void* convert_protobuf_fields( const ::kwiver::vital::image_container_sptr img,
+                                     ::kwiver::protobuf::image&                  proto_img )
+{
+  const ::kwiver::vital::image vital_image = img->get_image();
+  if ( ! is_in_place( vital_image ) )
+  {
+    return nullptr;
+  }
+
+  const size_t local_size = vital_image.width() * vital_image.height()
+    * vital_image.depth() * vital_image.pixel_traits().num_bytes;
+
+  proto_img.clear_data();
+  set_image_fields( img, vital_image, local_size, image_codec::raw, proto_img );
+  return vital_image.first_pixel();
 }
 
 // ----------------------------------------------------------------------------
@@ -147,6 +147,34 @@ KWIVER_SERIALIZE_PROTOBUF_EXPORT
 void convert_protobuf( const ::kwiver::vital::image_container_sptr  img,
                        ::kwiver::protobuf::image&                   proto_img  );
 
+/// Encodings for the pixels of a serialized image.
+enum class image_codec
+{
+  raw,  ///< pixels copied as is; cheapest for local transport
+  zlib, ///< deflate; level 1 is fast, level 9 is smallest
+};
+
+/// Convert an image, encoding its pixels with the given codec.
+///
+/// The pixels are encoded directly into the data field of \p proto_img,
+/// so a message reused across calls keeps its buffer.  \p level is the
+/// zlib compression level, where -1 selects the zlib default.
+KWIVER_SERIALIZE_PROTOBUF_EXPORT
+void convert_protobuf( const ::kwiver::vital::image_container_sptr  img,
+                       ::kwiver::protobuf::image&                   proto_img,
+                       image_codec                                  codec,
+                       int                                          level = -1 );
+
+/// Convert an image, leaving its pixels to be written by the caller.
+///
+/// Every field of \p proto_img but data is set as the raw codec would
+/// set it, and the first pixel is returned; the pixels are the next
+/// size bytes.  If the pixels do not fill one block of memory in order,
+/// nullptr is returned and the message should be converted in full.
+KWIVER_SERIALIZE_PROTOBUF_EXPORT
+const void* convert_protobuf_fields( const ::kwiver::vital::image_container_sptr  img,
+                                     ::kwiver::protobuf::image&                   proto_img );
+
 // ---- timestamp
 KWIVER_SERIALIZE_PROTOBUF_EXPORT
 void convert_protobuf( const ::kwiver::protobuf::timestamp& proto_tstamp,
@@ -9,13 +9,56 @@
 #include <vital/types/protobuf/image.pb.h>
 #include <vital/exceptions.h>
 
+#include <google/protobuf/io/coded_stream.h>
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+
 namespace kwiver {
 namespace arrows {
 namespace serialize {
 namespace protobuf {
 
+namespace {
+
+const std::string image_tag( "image" );
+
+// Wire tag of the data field: its number, then wire type 2 for a
+// length delimited field.
+const uint32_t data_tag = ( kwiver::protobuf::image::kDataFieldNumber << 3 ) | 2;
+
+using google::protobuf::io::CodedOutputStream;
+
+} // end namespace
+
+// ----------------------------------------------------------------------------
+class image::priv
+{
+public:
+  priv()
+    : codec( "zlib" )
+    , compression_level( -1 )
+  { }
+
+  image_codec get_codec() const
+  {
+    return ( codec == "raw" ) ? image_codec::raw : image_codec::zlib;
+  }
+
+  // configuration
+  std::string codec;
+  int compression_level;
+
+  // Message reused between calls so the pixel buffer is only
+  // reallocated when a larger image arrives.
+  std::mutex proto_lock;
+  kwiver::protobuf::image proto_img;
+};
+
 // --------------------------------------------------------------------------
 image::image()
+  : d( new priv )
 {
   // Verify that the version of the library that we linked against is
   // compatible with the version of the headers we compiled against.
@@ -25,26 +68,138 @@ image::image()
 image::~image()
 { }
 
+// ----------------------------------------------------------------------------
+vital::config_block_sptr
+image::
+get_configuration() const
+{
+  vital::config_block_sptr config = vital::algo::data_serializer::get_configuration();
+
+  config->set_value( "codec", d->codec,
+                     "Encoding of the image pixels. Must be one of the following:\n"
+                     " - raw : pixels are copied as is. Fastest, and best for "
+                     "transport between processes on the same host.\n"
+                     " - zlib : pixels are compressed with zlib." );
+  config->set_value( "compression_level", d->compression_level,
+                     "zlib compression level, from 1 (fastest) to 9 (smallest). "
+                     "The value -1 selects the zlib default. Only used by the "
+                     "zlib codec." );
+
+  return config;
+}
+
+// ----------------------------------------------------------------------------
+void
+image::
+set_configuration( vital::config_block_sptr config )
+{
+  d->codec = config->get_value< std::string >( "codec", d->codec );
+  d->compression_level = config->get_value< int >( "compression_level",
+                                                   d->compression_level );
+}
+
+// ----------------------------------------------------------------------------
+bool
+image::
+check_configuration( vital::config_block_sptr config ) const
+{
+  bool valid = true;
+
+  const std::string codec = config->get_value< std::string >( "codec", d->codec );
+  if ( codec != "raw" && codec != "zlib" )
+  {
+    LOG_ERROR( logger(), "Invalid image codec \"" << codec
+               << "\". Must be \"raw\" or \"zlib\"." );
+    valid = false;
+  }
+
+  const int level = config->get_value< int >( "compression_level",
+                                              d->compression_level );
+  if ( level != -1 && ( level < 0 || level > 9 ) )
+  {
+    LOG_ERROR( logger(), "Invalid compression_level " << level
+               << ". Must be -1 or from 0 to 9." );
+    valid = false;
+  }
+
+  return valid;
+}
+
 // ----------------------------------------------------------------------------
 std::shared_ptr< std::string >
 image::
 serialize( const vital::any& element )
+{
+  auto msg = std::make_shared< std::string >();
+  serialize_to( element, *msg );
+  return msg;
+}
+
+// ----------------------------------------------------------------------------
+void
+image::
+serialize_to( const vital::any& element, std::string& out )
 {
   kwiver::vital::image_container_sptr img_sptr =
     kwiver::vital::any_cast< kwiver::vital::image_container_sptr > ( element );
 
-  std::ostringstream msg;
-  msg << "image ";   // add type tag
-  kwiver::protobuf::image proto_img;
-  convert_protobuf( img_sptr, proto_img );
+  std::lock_guard< std::mutex > lock( d->proto_lock );
+  auto& proto_img = d->proto_img;
+  proto_img.Clear();
+
+  // Raw pixels which fill one block of memory are not copied into the
+  // message. They are written to the output after the other fields,
+  // as the data field, which a parser accepts in any position.
+  const void* pixels = nullptr;
+  if ( d->get_codec() == image_codec::raw )
+  {
+    pixels = convert_protobuf_fields( img_sptr, proto_img );
+  }
+  if ( ! pixels )
+  {
+    convert_protobuf( img_sptr, proto_img, d->get_codec(), d->compression_level );
+  }
+
+  const size_t fields_size = proto_img.ByteSizeLong();
+  size_t data_size = 0;
+  size_t data_header_size = 0;
+  if ( pixels )
+  {
+    data_size = static_cast< size_t >( proto_img.size() );
+    data_header_size = CodedOutputStream::VarintSize32( data_tag )
+      + CodedOutputStream::VarintSize64( data_size );
+  }
 
-  if ( ! proto_img.SerializeToOstream( &msg ) )
+  // Append the type tag, delimiter, then the protobuf.
+  const size_t start = out.size();
+  out.resize( start + image_tag.size() + 1 + fields_size
+              + data_header_size + data_size );
+  char* const msg = &out[ start ];
+  std::memcpy( msg, image_tag.data(), image_tag.size() );
+  msg[ image_tag.size() ] = ' ';
+
+  uint8_t* target = reinterpret_cast< uint8_t* >( msg + image_tag.size() + 1 );
+  const int target_size = static_cast< int >( fields_size );
+  const bool okay = pixels
+    ? proto_img.SerializePartialToArray( target, target_size )
+    : proto_img.SerializeToArray( target, target_size );
+  if ( ! okay )
   {
+    out.resize( start );
     VITAL_THROW( kwiver::vital::serialization_exception,
-                 "Error serializing detected_object_set from protobuf" );
+                 "Error serializing image_container to protobuf" );
   }
 
-  return std::make_shared< std::string > ( msg.str() );
+  if ( pixels )
+  {
+    target += fields_size;
+    target = CodedOutputStream::WriteTagToArray( data_tag, target );
+    target = CodedOutputStream::WriteVarint64ToArray( data_size, target );
+    if ( data_size > 0 )
+    {
+      std::memcpy( target, pixels, data_size );
+    }
+  }
 }
 
 // ----------------------------------------------------------------------------
@@ -53,13 +208,11 @@ image::
 deserialize( const std::string& message )
 {
   kwiver::vital::image_container_sptr img_container_sptr;
-  std::istringstream msg( message );
 
-  std::string tag;
-  msg >> tag;
-  msg.get();    // Eat delimiter
+  const auto delim = message.find( ' ' );
+  const std::string tag = message.substr( 0, delim );
 
-  if ( tag != "image" )
+  if ( tag != image_tag )
   {
     LOG_ERROR(
       logger(), "Invalid data type tag received. Expected \"image\", received \""
@@ -67,9 +220,11 @@ deserialize( const std::string& message )
   }
   else
   {
-    // define our protobuf
+    // parse the protobuf in place, after the delimiter
+    const auto offset = ( delim == std::string::npos ) ? message.size() : delim + 1;
     kwiver::protobuf::image proto_img;
-    if ( ! proto_img.ParseFromIstream(&msg) )
+    if ( ! proto_img.ParseFromArray( message.data() + offset,
+                                     static_cast< int >( message.size() - offset ) ) )
     {
       VITAL_THROW(kwiver::vital::serialization_exception,
                   "Error deserializing image_container from protobuf");
@@ -8,6 +8,8 @@
 #include <arrows/serialize/protobuf/kwiver_serialize_protobuf_export.h>
 #include <vital/algo/data_serializer.h>
 
+#include <memory>
+
 namespace kwiver {
 namespace arrows {
 namespace serialize {
@@ -23,8 +25,17 @@ class KWIVER_SERIALIZE_PROTOBUF_EXPORT image
   image();
   virtual ~image();
 
+  vital::config_block_sptr get_configuration() const override;
+  void set_configuration( vital::config_block_sptr config ) override;
+  bool check_configuration( vital::config_block_sptr config ) const override;
+
   std::shared_ptr< std::string > serialize( const vital::any& elements ) override;
+  void serialize_to( const vital::any& element, std::string& out ) override;
   vital::any deserialize( const std::string& message ) override;
+
+private:
+  class priv;
+  std::unique_ptr< priv > d;
 };
 
 } } } }       // end namespace kwiver
@@ -38,6 +38,8 @@
 #include <vital/util/hex_dump.h>
 #include <vital/util/string.h>
 
+#include <cstring>
+
 namespace kasp = kwiver::arrows::serialize::protobuf;
 
 // ----------------------------------------------------------------------------
@@ -491,6 +493,113 @@ TEST( serialize, image )
   }
 }
 
+// ----------------------------------------------------------------------------
+TEST( serialize, image_codecs )
+{
+  kwiver::vital::image img{200, 300, 3};
+
+  char* cp = static_cast< char* >(img.memory()->data() );
+  for ( size_t i = 0; i < img.size(); ++i )
+  {
+    *cp++ = i;
+  }
+
+  // a flipped view is not laid out in memory from the first pixel
+  kwiver::vital::image flipped( img.memory(),
+                                ((char *)img.first_pixel() + (img.height() - 1) * img.h_step()),
+                                img.width(), img.height(), img.depth(),
+                                img.w_step(), -img.h_step(), img.d_step(),
+                                img.pixel_traits() );
+
+  for ( auto const& codec : { "raw", "zlib" } )
+  {
+    SCOPED_TRACE( codec );
+
+    kasp::image image_ser;
+    auto config = image_ser.get_configuration();
+    config->set_value( "codec", codec );
+    config->set_value( "compression_level", 1 );
+    ASSERT_TRUE( image_ser.check_configuration( config ) );
+    image_ser.set_configuration( config );
+
+    // serialize repeatedly to exercise reuse of the message buffer
+    for ( auto const& src : { img, flipped, img.crop( 10, 20, 50, 60 ) } )
+    {
+      kwiver::vital::image_container_sptr img_container =
+        std::make_shared< kwiver::vital::simple_image_container >( src );
+      kwiver::vital::any img_any(img_container);
+
+      auto mes = image_ser.serialize( img_any );
+      auto dser = image_ser.deserialize( *mes );
+
+      auto img_dser = kwiver::vital::any_cast< kwiver::vital::image_container_sptr > ( dser );
+
+      // Check the content of images
+      EXPECT_TRUE( kwiver::vital::equal_content( src, img_dser->get_image()) );
+    }
+  }
+
+  // the default codec compresses; raw does not
+  kasp::image zlib_ser;
+  kasp::image raw_ser;
+  auto config = raw_ser.get_configuration();
+  config->set_value( "codec", "raw" );
+  raw_ser.set_configuration( config );
+
+  kwiver::vital::image blank{200, 300, 3};
+  std::memset( blank.memory()->data(), 0, blank.size() );
+  kwiver::vital::any blank_any(
+    kwiver::vital::image_container_sptr(
+      std::make_shared< kwiver::vital::simple_image_container >( blank ) ) );
+  EXPECT_LT( zlib_ser.serialize( blank_any )->size(), blank.size() / 10 );
+  EXPECT_GT( raw_ser.serialize( blank_any )->size(), blank.size() );
+
+  config->set_value( "codec", "lz4" );
+  EXPECT_FALSE( raw_ser.check_configuration( config ) );
+}
+
+// ----------------------------------------------------------------------------
+TEST( serialize, image_serialize_to )
+{
+  kwiver::vital::image img{200, 300, 3};
+
+  char* cp = static_cast< char* >(img.memory()->data() );
+  for ( size_t i = 0; i < img.size(); ++i )
+  {
+    *cp++ = i;
+  }
+
+  for ( auto const& codec : { "raw", "zlib" } )
+  {
+    SCOPED_TRACE( codec );
+
+    kasp::image image_ser;
+    auto config = image_ser.get_configuration();
+    config->set_value( "codec", codec );
+    image_ser.set_configuration( config );
+
+    for ( auto const& src : { img, img.crop( 10, 20, 50, 60 ) } )
+    {
+      kwiver::vital::any img_any(
+        kwiver::vital::image_container_sptr(
+          std::make_shared< kwiver::vital::simple_image_container >( src ) ) );
+
+      // the message is appended after what the buffer already holds
+      const std::string prefix( "header " );
+      std::string buffer( prefix );
+      image_ser.serialize_to( img_any, buffer );
+      ASSERT_EQ( prefix, buffer.substr( 0, prefix.size() ) );
+
+      const std::string mes = buffer.substr( prefix.size() );
+      EXPECT_EQ( *image_ser.serialize( img_any ), mes );
+
+      auto dser = image_ser.deserialize( mes );
+      auto img_dser = kwiver::vital::any_cast< kwiver::vital::image_container_sptr > ( dser );
+      EXPECT_TRUE( kwiver::vital::equal_content( src, img_dser->get_image()) );
+    }
+  }
+}
+
 // ----------------------------------------------------------------------------
 TEST ( serialize, string )
 {
@@ -443,6 +443,9 @@ class fuse_depth::priv
       contour_filter->Update();
 
       isosurface_mesh = contour_filter->GetOutput();
+
+      // sparse integration may mark voxels far from all surfaces unknown
+      remove_unknown_voxel_cells(isosurface_mesh, fused_volume);
     }
   }
 };
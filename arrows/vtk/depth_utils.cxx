@@ -9,14 +9,25 @@
 
 #include <arrows/vtk/depth_utils.h>
 
+#include <arrows/mvg/sparse_tsdf_volume.h>
+
 #include <vital/types/bounding_box.h>
 
+#include <vtkDataArray.h>
 #include <vtkDoubleArray.h>
+#include <vtkIdList.h>
 #include <vtkIntArray.h>
+#include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkUnsignedCharArray.h>
 #include <vtkXMLImageDataReader.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
 namespace kwiver {
 namespace arrows {
 namespace vtk {
@@ -242,16 +253,29 @@ volume_to_vtk(kwiver::vital::image_container_sptr volume,
   vals->SetNumberOfComponents(1);
   vals->SetNumberOfTuples(volume->width() * volume->height() * volume->depth());
 
-  vtkIdType pt_id = 0;
-  const kwiver::vital::image &vol = volume->get_image();
-
-  for (unsigned int k = 0; k < volume->depth(); k++)
+  // a sparse volume is written straight into the output array, without
+  // building a dense volume image first
+  auto const sparse =
+    std::dynamic_pointer_cast<mvg::sparse_tsdf_image_container>(volume);
+  if (sparse)
   {
-    for (unsigned int j = 0; j < volume->height(); j++)
+    ptrdiff_t const j_step = static_cast<ptrdiff_t>(volume->width());
+    ptrdiff_t const k_step = j_step * static_cast<ptrdiff_t>(volume->height());
+    sparse->volume()->copy_to(vals->GetPointer(0), 1, j_step, k_step);
+  }
+  else
+  {
+    vtkIdType pt_id = 0;
+    const kwiver::vital::image &vol = volume->get_image();
+
+    for (unsigned int k = 0; k < volume->depth(); k++)
     {
-      for (unsigned int i = 0; i < volume->width(); i++)
+      for (unsigned int j = 0; j < volume->height(); j++)
       {
-        vals->SetTuple1(pt_id++, vol.at<double>(i, j, k));
+        for (unsigned int i = 0; i < volume->width(); i++)
+        {
+          vals->SetTuple1(pt_id++, vol.at<double>(i, j, k));
+        }
       }
     }
   }
@@ -261,6 +285,75 @@ volume_to_vtk(kwiver::vital::image_container_sptr volume,
   return grid;
 }
 
+/// Remove the parts of an isosurface which touch voxels with no value
+void
+remove_unknown_voxel_cells(vtkPolyData* mesh, vtkImageData* volume)
+{
+  vtkDataArray* const scalars = volume->GetPointData()->GetScalars();
+  vtkPoints* const points = mesh->GetPoints();
+  if (!scalars || !points)
+  {
+    return;
+  }
+
+  int dims[3];
+  double origin[3];
+  double spacing[3];
+  volume->GetDimensions(dims);
+  volume->GetOrigin(origin);
+  volume->GetSpacing(spacing);
+
+  // a vertex is on the edge between the voxels at the floor and ceiling
+  // of its grid coordinates
+  vtkIdType const num_points = points->GetNumberOfPoints();
+  std::vector<bool> unknown(num_points, false);
+  for (vtkIdType p = 0; p < num_points; ++p)
+  {
+    double pt[3];
+    points->GetPoint(p, pt);
+    int lo[3], hi[3];
+    bool finite = true;
+    for (int c = 0; c < 3; ++c)
+    {
+      double const x = (pt[c] - origin[c]) / spacing[c];
+      finite = finite && std::isfinite(x);
+      lo[c] = std::min(std::max(static_cast<int>(std::floor(x)), 0),
+                       dims[c] - 1);
+      hi[c] = std::min(std::max(static_cast<int>(std::ceil(x)), 0),
+                       dims[c] - 1);
+    }
+    if (!finite)
+    {
+      unknown[p] = true;
+      continue;
+    }
+    for (int corner = 0; corner < 8 && !unknown[p]; ++corner)
+    {
+      int ijk[3] = { (corner & 1) ? hi[0] : lo[0],
+                     (corner & 2) ? hi[1] : lo[1],
+                     (corner & 4) ? hi[2] : lo[2] };
+      unknown[p] = std::isnan(scalars->GetTuple1(volume->ComputePointId(ijk)));
+    }
+  }
+
+  mesh->BuildLinks();
+  vtkNew<vtkIdList> cell_points;
+  vtkIdType const num_cells = mesh->GetNumberOfCells();
+  for (vtkIdType c = 0; c < num_cells; ++c)
+  {
+    mesh->GetCellPoints(c, cell_points);
+    for (vtkIdType i = 0; i < cell_points->GetNumberOfIds(); ++i)
+    {
+      if (unknown[cell_points->GetId(i)])
+      {
+        mesh->DeleteCell(c);
+        break;
+      }
+    }
+  }
+  mesh->RemoveDeletedCells();
+}
+
 } //end namespace vtk
 } //end namespace arrows
 } //end namespace kwiver
@@ -18,6 +18,7 @@
 #include <vital/types/image.h>
 
 #include <vtkImageData.h>
+#include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
 
 namespace kwiver {
@@ -72,6 +73,9 @@ load_depth_map(const std::string& filename,
 
 /// Convert a volume and metadata to the VTK format
 /**
+ * A sparse volume from integrate_depth_maps is copied into the VTK array
+ * directly, without building a dense volume image.
+ *
  * \param [in] volume   The volumetric data to convert
  * \param [in] origin   The local coordinate system origin of the data
  * \param [in] spacing  The voxel spacing per axis
@@ -82,6 +86,21 @@ volume_to_vtk(kwiver::vital::image_container_sptr volume,
               kwiver::vital::vector_3d const& origin,
               kwiver::vital::vector_3d const& spacing);
 
+/// Remove the parts of an isosurface which touch voxels with no value
+/**
+ * Sparse volumes integrated with sparse_unknown_nan set hold NaN in voxels
+ * far from every surface.  Contouring
+ * does not know these are unknown, so it can place a surface between an
+ * unknown voxel and its neighbor.  This removes every cell of \p mesh with
+ * a vertex on a grid edge of \p volume ending at a NaN voxel.
+ *
+ * \param [in,out] mesh   The isosurface extracted from \p volume
+ * \param [in] volume     The volume from volume_to_vtk()
+ */
+KWIVER_ALGO_VTK_EXPORT
+void
+remove_unknown_voxel_cells(vtkPolyData* mesh, vtkImageData* volume);
+
 } //end namespace vtk
 } //end namespace arrows
 } //end namespace kwiver
@@ -6,13 +6,18 @@
 
 #include "vtkKwiverCamera.h"
 
+#include <arrows/core/colorize.h>
+
 #include <kwiversys/SystemTools.hxx>
 
 #include <vital/range/iota.h>
+#include <vital/types/mesh.h>
 
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
+#include "vtkIdList.h"
 #include "vtkImageData.h"
 #include "vtkNew.h"
 #include "vtkPointData.h"
@@ -25,6 +30,7 @@
 #include "vtkRenderWindow.h"
 #include "vtkSequencePass.h"
 #include "vtkSmartPointer.h"
+#include "vtkTriangleFilter.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkVector.h"
 #include "vtkWindowToImageFilter.h"
@@ -33,6 +39,7 @@
 
 #include <algorithm>
 #include <iomanip>
+#include <limits>
 #include <numeric>
 #include <sstream>
 
@@ -197,6 +204,11 @@ bool
 mesh_coloration
 ::colorize()
 {
+  if( !all_frames_ && frame_ < 0 )
+  {
+    return colorize_streaming();
+  }
+
   LOG_INFO( logger_, "Initialize camera and image list: frame " << frame_ );
   initialize_data_list( frame_ );
 
@@ -489,6 +501,133 @@ ::colorize()
   return true;
 }
 
+// ----------------------------------------------------------------------------
+bool
+mesh_coloration
+::colorize_streaming()
+{
+  if( input_ == 0 || input_->GetPoints() == 0 )
+  {
+    LOG_ERROR( logger_, "invalid mesh points" );
+    return false;
+  }
+  report_progress_changed( "Preparing mesh", 0 );
+
+  if( !input_->GetPointData()->GetNormals() )
+  {
+    LOG_INFO( logger_, "Generating normals ..." );
+
+    vtkNew< vtkPolyDataNormals > compute_normals;
+    compute_normals->SetInputDataObject( input_ );
+    compute_normals->Update();
+    input_ = compute_normals->GetOutput();
+  }
+  vtkDataArray* normals = input_->GetPointData()->GetNormals();
+  vtkPoints* meshPointList = input_->GetPoints();
+  vtkIdType const nbMeshPoint = meshPointList->GetNumberOfPoints();
+
+  // The colors are accumulated on a triangulated copy of the mesh; the
+  // triangle filter keeps the points, so vertex ids match the input.
+  std::vector< kwiver::vital::vector_3d > points( nbMeshPoint );
+  std::vector< kwiver::vital::vector_3d > pointNormals( nbMeshPoint );
+  for( auto const id : kvr::iota( nbMeshPoint ) )
+  {
+    meshPointList->GetPoint( id, points[ id ].data() );
+    normals->GetTuple( id, pointNormals[ id ].data() );
+  }
+
+  vtkNew< vtkTriangleFilter > triangulate;
+  triangulate->SetInputDataObject( input_ );
+  triangulate->PassVertsOff();
+  triangulate->PassLinesOff();
+  triangulate->Update();
+
+  std::vector< kwiver::vital::mesh_regular_face< 3 > > triangles;
+  vtkCellArray* polys = triangulate->GetOutput()->GetPolys();
+  vtkNew< vtkIdList > cell;
+  polys->InitTraversal();
+  while( polys->GetNextCell( cell ) )
+  {
+    triangles.push_back( { static_cast< unsigned >( cell->GetId( 0 ) ),
+                           static_cast< unsigned >( cell->GetId( 1 ) ),
+                           static_cast< unsigned >( cell->GetId( 2 ) ) } );
+  }
+
+  std::unique_ptr< kwiver::vital::mesh_vertex_array< 3 > > verts(
+    new kwiver::vital::mesh_vertex_array< 3 >( points ) );
+  verts->set_normals( pointNormals );
+  std::unique_ptr< kwiver::vital::mesh_regular_face_array< 3 > > faces(
+    new kwiver::vital::mesh_regular_face_array< 3 >( triangles ) );
+  auto const mesh = std::make_shared< kwiver::vital::mesh >(
+    std::move( verts ), std::move( faces ) );
+
+  video_reader_->open( video_path_ );
+  bool has_mask = remove_masked_ && !mask_path_.empty();
+  if( has_mask )
+  {
+    try
+    {
+      mask_reader_->open( mask_path_ );
+    }
+    catch ( std::exception const& )
+    {
+      has_mask = false;
+      LOG_ERROR( logger_, "Cannot open mask file: " << mask_path_ );
+    }
+  }
+
+  report_progress_changed( "Coloring Mesh Points", 0 );
+
+  std::vector< kwiver::vital::rgb_color > means;
+  std::vector< kwiver::vital::rgb_color > medians;
+  std::vector< unsigned > counts;
+  auto const numFrames = kwiver::arrows::core::compute_mesh_vertex_colors(
+    mesh, *video_reader_, *cameras_, means, medians, counts,
+    static_cast< unsigned >( sampling_ ),
+    has_mask ? mask_reader_.get() : nullptr,
+    remove_occluded_ ? occlusion_threshold_
+                     : std::numeric_limits< double >::infinity() );
+
+  video_reader_->close();
+  if( has_mask )
+  {
+    mask_reader_->close();
+  }
+  LOG_INFO( logger_, "Colored mesh from " << numFrames << " frames" );
+
+  vtkNew< vtkUnsignedCharArray > meanValues;
+  meanValues->SetNumberOfComponents( 3 );
+  meanValues->SetNumberOfTuples( nbMeshPoint );
+  meanValues->SetName( "mean" );
+
+  vtkNew< vtkUnsignedCharArray > medianValues;
+  medianValues->SetNumberOfComponents( 3 );
+  medianValues->SetNumberOfTuples( nbMeshPoint );
+  medianValues->SetName( "median" );
+
+  vtkNew< vtkIntArray > countValues;
+  countValues->SetNumberOfComponents( 1 );
+  countValues->SetNumberOfTuples( nbMeshPoint );
+  countValues->SetName( "count" );
+
+  for( auto const id : kvr::iota( nbMeshPoint ) )
+  {
+    auto const& mean = means[ id ];
+    auto const& median = medians[ id ];
+    unsigned char const meanRGB[] = { mean.r, mean.g, mean.b };
+    unsigned char const medianRGB[] = { median.r, median.g, median.b };
+    meanValues->SetTypedTuple( id, meanRGB );
+    medianValues->SetTypedTuple( id, medianRGB );
+    countValues->SetValue( id, static_cast< int >( counts[ id ] ) );
+  }
+
+  output_->GetPointData()->AddArray( meanValues );
+  output_->GetPointData()->AddArray( medianValues );
+  output_->GetPointData()->AddArray( countValues );
+  report_progress_changed( "Done", 100 );
+  return numFrames > 0;
+}
+
 // ----------------------------------------------------------------------------
 void
 mesh_coloration
@@ -116,7 +116,9 @@ class KWIVER_ALGO_VTK_EXPORT mesh_coloration :
   /// Color the mesh.
   ///
   /// Adds mean and median colors to \c output_ if \c all_frames is \c false,
-  /// or adds an array of colors for each camera (frame) otherwise.
+  /// or adds an array of colors for each camera (frame) otherwise. Mean and
+  /// median colors over the sampled frames are computed by streaming the
+  /// video, keeping one frame in memory at a time.
   ///
   /// \return \c true if successful, \c false if an error occurred.
   bool colorize();
@@ -126,6 +128,7 @@ class KWIVER_ALGO_VTK_EXPORT mesh_coloration :
                                         int percentage ) = 0;
 
 protected:
+  bool colorize_streaming();
   void initialize_data_list( int frame_id );
   void push_data( kwiver::vital::camera_map::map_camera_t::value_type cam_itr,
                   kwiver::vital::timestamp& ts, bool has_mask );
@@ -9,6 +9,8 @@
 
 #include "vil_image_memory.h"
 
+#include <vital/types/image_memory_pool.h>
+
 namespace kwiver {
 namespace arrows {
 namespace vxl {
@@ -20,7 +22,7 @@ ::set_size(unsigned long n, vil_pixel_format pixel_format)
 {
   if( n != size_ )
   {
-    image_data_ = vital::image_memory_sptr(new vital::image_memory(n));
+    image_data_ = vital::image_memory_pool::instance().allocate(n);
     size_ = n;
   }
   pixel_format_ = pixel_format;
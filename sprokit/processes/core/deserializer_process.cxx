@@ -28,7 +28,7 @@ namespace kwiver {
 // (config-key, value-type, default-value, description )
 create_config_trait( serialization_type, std::string, "",
                      "Specifies the method used to serialize the data object. "
-                     "For example this could be \"json\", or \"protobuf\".");
+                     "For example this could be \"json\", \"protobuf\", or \"binary\".");
 
 create_config_trait( dump_message, bool, "false",
                      "Dump printable version of serialized messages of set to true." );
@@ -84,7 +84,7 @@ void
 deserializer_process
 ::_init()
 {
-  base_init();
+  base_init( get_config() );
 
   // Now that we have a "normal" output port, let Sprokit manage it
   this->set_data_checking_level( check_valid );
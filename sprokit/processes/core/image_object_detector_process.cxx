@@ -67,6 +67,30 @@ void
 image_object_detector_process::
 _step()
 {
+  size_t const batch_size = input_batch_size();
+
+  if ( batch_size > 1 )
+  {
+    // Move the whole batch through the edges at once.
+    sprokit::edge_data_t const inputs =
+      grab_batch_from_port( image_port_trait::port_name, batch_size );
+    std::vector< sprokit::datum_t > results;
+
+    {
+      scoped_step_instrumentation();
+
+      for ( auto const& input : inputs )
+      {
+        auto const image = input.datum->get_datum< vital::image_container_sptr >();
+
+        results.push_back( sprokit::datum::new_datum( d->m_detector->detect( image ) ) );
+      }
+    }
+
+    push_batch_to_port( detected_object_set_port_trait::port_name, results );
+    return;
+  }
+
   vital::image_container_sptr input = grab_from_port_using_trait( image );
 
   vital::detected_object_set_sptr result;
@@ -80,6 +104,18 @@ _step()
   push_to_port_using_trait( detected_object_set, result );
 }
 
+// ------------------------------------------------------------------
+sprokit::process::properties_t
+image_object_detector_process::
+_properties() const
+{
+  properties_t consts = process::_properties();
+
+  consts.insert( property_batch_input );
+
+  return consts;
+}
+
 // ------------------------------------------------------------------
 void
 image_object_detector_process::
@@ -23,6 +23,9 @@ namespace kwiver {
  * \oports
  *
  * \oport{detected_object_set}
+ *
+ * The process accepts batches of images; set \c _batch_size in its
+ * config to grab several queued images per step.
  */
 class KWIVER_PROCESSES_NO_EXPORT image_object_detector_process
   : public sprokit::process
@@ -37,6 +40,7 @@ class KWIVER_PROCESSES_NO_EXPORT image_object_detector_process
 protected:
   virtual void _configure();
   virtual void _step();
+  virtual properties_t _properties() const;
 
 private:
   void make_ports();
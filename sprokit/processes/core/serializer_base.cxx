@@ -31,7 +31,7 @@ serializer_base::
 // ----------------------------------------------------------------------------
 void
 serializer_base
-::base_init()
+::base_init( kwiver::vital::config_block_sptr const& proc_config )
 {
   // Scan through our port groups to make sure it all makes sense.
   // The port group name is used as the message-name
@@ -69,6 +69,17 @@ ::base_init()
                                   vital::config_block::block_sep() +
                                   "type" );
 
+      // pass serializer parameters through from the process config
+      if ( proc_config )
+      {
+        auto ser_params = proc_config->subblock( ser_algo_type );
+        for ( auto const& key : ser_params->available_values() )
+        {
+          algo_config->set_value( ser_algo_type + vital::config_block::block_sep() + key,
+                                  ser_params->get_value< std::string >( key ) );
+        }
+      }
+
       algo_config->set_value( ser_type, elem_spec.m_algo_name );
 
       {
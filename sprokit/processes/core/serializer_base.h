@@ -31,7 +31,18 @@ class serializer_base
                    kwiver::vital::logger_handle_t log );
   virtual ~serializer_base();
 
-  void base_init();
+  /**
+   * @brief Create the serializer algorithms for all message elements.
+   *
+   * Parameters for the serializers are taken from the \c
+   * serialize-<type> block of \p proc_config, where \c <type> is the
+   * serialization type. For example \c
+   * serialize-protobuf:kwiver:image:codec selects the codec for
+   * protobuf images.
+   *
+   * @param proc_config Configuration of the associated process.
+   */
+  void base_init( kwiver::vital::config_block_sptr const& proc_config = nullptr );
 
   /**
    * @brief Processes a port with a vital type.
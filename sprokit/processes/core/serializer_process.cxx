@@ -18,7 +18,11 @@
 #include <sprokit/pipeline/datum.h>
 #include <sprokit/pipeline/process_exception.h>
 
+#include <map>
 #include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 // ----------------------------------------------------------------------------
 namespace kwiver {
@@ -48,6 +52,10 @@ namespace kwiver {
  # select the serializing method to apply to all data elements.
  serialization_type = json
 
+ # optional parameters for the serializers of each data type, e.g.
+ # send protobuf images without compression.
+ # serialize-protobuf:kwiver:image:codec = raw
+
  # -- connect inputs to algo that generates image and mask messages
  connect from foo.image to ser.imgmask/image  # supplies image to imgmask message
  connect from bar.image to ser.imgmask/mask   # supplies mask to imgmask message
@@ -62,11 +70,27 @@ namespace kwiver {
 // (config-key, value-type, default-value, description )
 create_config_trait( serialization_type, std::string, "",
                      "Specifies the method used to serialize the data object. "
-                     "For example this could be \"json\", or \"protobuf\".");
+                     "For example this could be \"json\", \"protobuf\", or \"binary\".");
 
 create_config_trait( dump_message, bool, "false",
                      "Dump printable version of serialized messages of set to true." );
 
+namespace {
+
+// Width of the size fields in a message, enough for any size_t.
+const size_t size_field_width = 20;
+
+// ----------------------------------------------------------------------------
+// Write a size right aligned into the field at pos.
+void
+write_size_field( std::string& buffer, size_t pos, size_t value )
+{
+  const std::string digits = std::to_string( value );
+  buffer.replace( pos + size_field_width - digits.size(), digits.size(), digits );
+}
+
+} // end namespace
+
 class serializer_process::priv
 {
 public:
@@ -74,6 +98,9 @@ class serializer_process::priv
   ~priv();
 
   bool opt_dump_message;
+
+  // Size of the last message of each type, to reserve for the next.
+  std::map< std::string, size_t > message_capacity;
 };
 
 // ============================================================================
@@ -117,7 +144,7 @@ void
 serializer_process
 ::_init()
 {
-  base_init();
+  base_init( get_config() );
 
   // Now that we have a "normal" input ports let Sprokit manager them
   this->set_data_checking_level( check_valid );
@@ -146,13 +173,26 @@ ::_step()
     // element ::= <element-name> <port-type> <length> <serialized-bytes>
     //         |
 
-    std::ostringstream message_str;
+    //
+    // The sizes are written as fixed width fields padded with leading
+    // spaces, so each element can be serialized straight into the
+    // message after its header and its size filled in afterwards.
+    // Readers skip the padding as whitespace.
+
     const auto & msg_spec = m_message_spec_list[msg_spec_it.first];
 
-    // Add message type string
-    message_str << msg_spec_it.first << " ";
+    // The whole message is assembled in one buffer, reserved at the
+    // size of the last message of this type.
+    auto msg_buffer = std::make_shared< std::string >();
+    size_t& capacity = d->message_capacity[msg_spec_it.first];
+    msg_buffer->reserve( capacity );
 
-    std::ostringstream ser_elements;
+    // Add message type string and space for the payload length before
+    // the serialized elements.
+    msg_buffer->append( msg_spec_it.first );
+    msg_buffer->push_back( ' ' );
+    const size_t payload_size_pos = msg_buffer->size();
+    msg_buffer->append( size_field_width + 1, ' ' );
 
     // loop over all elements that are part of this group.
     // This assembles the output byte string from one or more concrete data types.
@@ -162,51 +202,59 @@ ::_step()
       LOG_TRACE( logger(), "Processing port: \"" << element.m_port_name
                  << "\" of type \"" << element.m_port_type << "\"" );
 
+      // Element name and port type precede the serialized data
+      const size_t element_pos = msg_buffer->size();
+      msg_buffer->append( element.m_element_name );
+      msg_buffer->push_back( ' ' );
+      msg_buffer->append( element.m_port_type );
+      msg_buffer->push_back( ' ' );
+      const size_t element_size_pos = msg_buffer->size();
+      msg_buffer->append( size_field_width + 1, ' ' );
+      const size_t data_pos = msg_buffer->size();
+
       // Convert input datum to a serialized message
       auto datum = grab_datum_from_port( element.m_port_name );
       auto local_datum = datum->get_datum<kwiver::vital::any>();
-      std::shared_ptr< std::string > message;
       try
       {
         // Serialize the collected set of inputs
-        message = element.m_serializer->serialize( local_datum );
+        element.m_serializer->serialize_to( local_datum, *msg_buffer );
       }
       catch ( const kwiver::vital::vital_exception& e )
       {
         // can be kwiver::vital::serialization_exception or kwiver::vital::bad_any_cast
         LOG_ERROR( logger(), "Error serializing data element \"" << element.m_element_name
                    << "\" for message type \"" << msg_spec_it.first << "\" : " << e.what() );
+        msg_buffer->resize( element_pos );
         break;
       }
 
+      const size_t data_size = msg_buffer->size() - data_pos;
       LOG_TRACE( logger(), "Adding element: \"" << element.m_element_name
                  << "\"  Port type: \"" << element.m_port_type << "\"  Size: "
-                 << message->size() );
+                 << data_size );
 
-      if ( message->empty() )
+      if ( data_size == 0 )
       {
         LOG_WARN( logger(), "Serializer for message element \"" << element.m_element_name
                    << "\" for port name \"" << element.m_port_name
                    << "\" returned a null string. This is not expected." );
       }
 
-      // Add element name and port type to output followed by serialized data
-      ser_elements << element.m_element_name << " "
-                   << element.m_port_type << " "
-                   << message->size() << " "
-                   << *message;
+      write_size_field( *msg_buffer, element_size_pos, data_size );
     } // end for
 
-    // Add payload length to output buffer before the serialized elements.
-    message_str << ser_elements.str().size()+1 << " " << ser_elements.str();
+    // The payload length counts from the delimiter after it.
+    write_size_field( *msg_buffer, payload_size_pos,
+                      msg_buffer->size() - ( payload_size_pos + size_field_width ) );
+    capacity = msg_buffer->size();
 
     if (d->opt_dump_message)
     {
-      decode_message( message_str.str() );
+      decode_message( *msg_buffer );
     }
 
     // Push whole serialized message to port
-    auto msg_buffer = std::make_shared< std::string >( message_str.str() );
     push_to_port_as < serialized_message_port_trait::type >( msg_spec.m_serialized_port_name, msg_buffer );
 
   } // end for
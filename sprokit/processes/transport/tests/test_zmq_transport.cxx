@@ -0,0 +1,199 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include <test_common.h>
+
+#include <vital/plugin_loader/plugin_manager.h>
+
+#include <sprokit/pipeline_util/literal_pipeline.h>
+
+#include <sprokit/processes/adapters/embedded_pipeline.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#define TEST_ARGS ()
+
+DECLARE_TEST_MAP();
+
+int
+main(int argc, char* argv[])
+{
+  CHECK_ARGS(1);
+
+  testname_t const testname = argv[1];
+
+  kwiver::vital::plugin_manager::instance().load_all_plugins();
+
+  RUN_TEST(testname);
+}
+
+// ==================================================================
+// The sender pipeline ends in the send process
+class sender_ep
+  : public kwiver::embedded_pipeline
+{
+protected:
+  virtual bool connect_output_adapter() override { return true; }
+};
+
+// The receiver pipeline starts with the receive process
+class receiver_ep
+  : public kwiver::embedded_pipeline
+{
+protected:
+  virtual bool connect_input_adapter() override { return true; }
+};
+
+static void build_loopback( kwiver::embedded_pipeline& sender,
+                            kwiver::embedded_pipeline& receiver,
+                            std::string const& pattern,
+                            std::string const& port );
+static void send_messages( kwiver::embedded_pipeline& sender, int count );
+static bool receive_messages( kwiver::embedded_pipeline& receiver, int count );
+static std::string message_text( int i );
+
+// ------------------------------------------------------------------
+IMPLEMENT_TEST( pubsub )
+{
+  sender_ep sender;
+  receiver_ep receiver;
+  build_loopback( sender, receiver, "pubsub", "5590" );
+
+  sender.start();
+  receiver.start();
+
+  // PUB/SUB has no end of stream, so the receiver will be stopped.
+  // Its threads can only be joined by a wait begun before the stop.
+  std::thread receiver_thread( [&]() { receiver.wait(); } );
+
+  int const count = 10;
+  send_messages( sender, count );
+  receive_messages( receiver, count );
+
+  // The receiver is waiting for a message, so send one more to let it
+  // see the stop.
+  receiver.stop();
+  send_messages( sender, 1 );
+
+  sender.send_end_of_input();
+  sender.wait();
+  receiver_thread.join();
+}
+
+// ------------------------------------------------------------------
+IMPLEMENT_TEST( dealer )
+{
+  sender_ep sender;
+  receiver_ep receiver;
+  build_loopback( sender, receiver, "dealer", "5592" );
+
+  sender.start();
+  receiver.start();
+
+  // Not a multiple of the batch size, so the last batch is partial
+  int const count = 10;
+  send_messages( sender, count );
+  sender.send_end_of_input();
+
+  if ( ! receive_messages( receiver, count ) )
+  {
+    return;
+  }
+
+  // The end of stream from the sender completes the receiver
+  auto const ods = receiver.receive();
+  if ( ! ods->is_end_of_data() )
+  {
+    TEST_ERROR( "Receiver did not end after the last message" );
+  }
+
+  sender.wait();
+  receiver.wait();
+}
+
+// ------------------------------------------------------------------
+void
+build_loopback( kwiver::embedded_pipeline& sender,
+                kwiver::embedded_pipeline& receiver,
+                std::string const& pattern,
+                std::string const& port )
+{
+  std::stringstream sender_desc;
+  sender_desc << SPROKIT_PROCESS( "input_adapter", "ia" )
+
+              << SPROKIT_PROCESS( "zmq_transport_send", "send" )
+              << SPROKIT_CONFIG( "port", port )
+              << SPROKIT_CONFIG( "pattern", pattern )
+              << SPROKIT_CONFIG( "batch_size", "3" )
+
+              << SPROKIT_CONNECT( "ia", "serialized_message",
+                                  "send", "serialized_message" )
+    ;
+
+  std::stringstream receiver_desc;
+  receiver_desc << SPROKIT_PROCESS( "zmq_transport_receive", "receive" )
+                << SPROKIT_CONFIG( "port", port )
+                << SPROKIT_CONFIG( "pattern", pattern )
+                << SPROKIT_CONFIG( "credit", "2" )
+
+                << SPROKIT_PROCESS( "output_adapter", "oa" )
+
+                << SPROKIT_CONNECT( "receive", "serialized_message",
+                                    "oa", "serialized_message" )
+    ;
+
+  // Each side waits for the other while its pipeline is set up
+  std::thread sender_thread( [&]() { sender.build_pipeline( sender_desc ); } );
+  receiver.build_pipeline( receiver_desc );
+  sender_thread.join();
+}
+
+// ------------------------------------------------------------------
+void
+send_messages( kwiver::embedded_pipeline& sender, int count )
+{
+  for ( int i = 0; i < count; ++i )
+  {
+    auto ds = kwiver::adapter::adapter_data_set::create();
+    ds->add_value( "serialized_message",
+                   std::shared_ptr< std::string >(
+                     std::make_shared< std::string >( message_text( i ) ) ) );
+    sender.send( ds );
+  }
+}
+
+// ------------------------------------------------------------------
+bool
+receive_messages( kwiver::embedded_pipeline& receiver, int count )
+{
+  for ( int i = 0; i < count; ++i )
+  {
+    auto const ods = receiver.receive();
+    if ( ods->is_end_of_data() )
+    {
+      TEST_ERROR( "Receiver ended after " << i << " of " << count << " messages" );
+      return false;
+    }
+
+    auto const msg =
+      ods->get_port_data< std::shared_ptr< std::string > >( "serialized_message" );
+    if ( *msg != message_text( i ) )
+    {
+      TEST_ERROR( "Received \"" << *msg << "\" where \""
+                  << message_text( i ) << "\" was sent" );
+    }
+  }
+
+  return true;
+}
+
+// ------------------------------------------------------------------
+std::string
+message_text( int i )
+{
+  return "message " + std::to_string( i );
+}
@@ -4,10 +4,14 @@
 
 #include "zmq_transport_receive_process.h"
 
+#include <sprokit/pipeline/datum.h>
 #include <sprokit/pipeline/process_exception.h>
 
 #include <kwiver_type_traits.h>
 
+#include <cstring>
+#include <deque>
+
 namespace kwiver {
 
 // (config-key, value-type, default-value, description )
@@ -20,6 +24,17 @@ create_config_trait( connect_host, std::string, "localhost",
 create_config_trait( num_publishers, int, "1",
                      "Number of publishers to subscribe to. ");
 
+create_config_trait( pattern, std::string, "pubsub",
+                     "Messaging pattern to use. \"pubsub\" subscribes to all "
+                     "messages, which are dropped if this process falls behind. "
+                     "\"dealer\" receives batches of messages as credit is "
+                     "granted for them, so no message is lost. "
+                     "Sender and receivers must use the same pattern." );
+
+create_config_trait( credit, int, "4",
+                     "Number of batches each publisher may send before they "
+                     "are taken by the pipeline, when pattern is \"dealer\"." );
+
 /**
  * \class zmq_transport_receive_process
  *
@@ -43,6 +58,21 @@ create_config_trait( num_publishers, int, "1",
  * synchronization.  A subsequent publisher will be connected
  * at port+2 and so on.
  *
+ * With the "dealer" pattern the process instead connects a DEALER
+ * socket to each publisher's ROUTER socket, at the same ports used
+ * for PUB/SUB, and grants each publisher credit for a number of
+ * batches.  Messages are pushed one per step; once a batch has been
+ * taken by the pipeline, one more batch of credit is returned to the
+ * publisher it came from.  A publisher therefore never sends more
+ * than the pipeline can take, and a slow pipeline slows the
+ * publishers down rather than losing data.
+ *
+ * With the "dealer" pattern each publisher sends an empty message
+ * when its input is complete.  Once this has been received from every
+ * publisher the process marks itself complete.  PUB/SUB has no end of
+ * stream, since a dropped one would leave the process waiting, so the
+ * process runs until the pipeline is stopped.
+ *
  * \iports
  *
  * \iport{serialized_message} the incoming byte is sent to a
@@ -57,6 +87,11 @@ create_config_trait( num_publishers, int, "1",
  *
  * \config{connect_host} The name of the host to connect
  * to.  May be a DNS name or an IP address.
+ *
+ * \config{pattern} "pubsub" or "dealer".
+ *
+ * \config{credit} the number of batches each publisher may have in
+ * flight when using the "dealer" pattern.
  */
 
 //----------------------------------------------------------------
@@ -68,16 +103,32 @@ class zmq_transport_receive_process::priv
   ~priv();
 
   void connect();
+  void connect_dealers();
+  void receive_batch();
+  void send_credit( zmq::socket_t& socket, int count );
+  bool all_publishers_done() const;
 
   // Configuration values
   int m_port;
   int m_num_publishers;
   std::string m_connect_host;
+  bool m_use_credit;
+  int m_credit;
 
   // any other connection related data goes here
   zmq::context_t m_context;
   zmq::socket_t m_sub_socket;
   std::vector< std::shared_ptr<zmq::socket_t> > m_sync_sockets;
+  std::vector< std::shared_ptr<zmq::socket_t> > m_dealer_sockets;
+
+  // Messages of the current batch not yet pushed, and the index of
+  // the dealer socket it came from (-1 before the first batch)
+  std::deque< std::shared_ptr< std::string > > m_batch;
+  int m_batch_source;
+
+  // Publishers that have sent the end of their stream
+  std::vector< bool > m_publisher_done;
+  int m_num_done;
 
   vital::logger_handle_t m_logger; // for logging in priv methods
 
@@ -111,6 +162,22 @@ ::_configure()
   d->m_num_publishers = config_value_using_trait( num_publishers );
   d->m_connect_host = config_value_using_trait( connect_host );
 
+  const std::string pattern = config_value_using_trait( pattern );
+  if ( pattern != "pubsub" && pattern != "dealer" )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Unknown pattern \"" + pattern + "\". "
+                 "Expected \"pubsub\" or \"dealer\"." );
+  }
+  d->m_use_credit = ( pattern == "dealer" );
+
+  d->m_credit = config_value_using_trait( credit );
+  if ( d->m_credit < 1 )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "credit must be at least 1" );
+  }
+
   int major, minor, patch;
   zmq_version(&major, &minor, &patch);
   LOG_DEBUG( logger(), "ZeroMQ Version: " << major << "." << minor << "." << patch );
@@ -120,13 +187,40 @@ ::_configure()
 void zmq_transport_receive_process
 ::_init()
 {
-  d->connect();
+  if ( d->m_use_credit )
+  {
+    d->connect_dealers();
+  }
+  else
+  {
+    d->connect();
+  }
 }
 
 // ----------------------------------------------------------------
 void zmq_transport_receive_process
 ::_step()
 {
+  if ( d->m_use_credit )
+  {
+    if ( d->m_batch.empty() )
+    {
+      d->receive_batch();
+    }
+
+    if ( d->m_batch.empty() )
+    {
+      // Every publisher has finished
+      mark_complete();
+      return;
+    }
+
+    auto msg = d->m_batch.front();
+    d->m_batch.pop_front();
+    push_to_port_using_trait( serialized_message, msg );
+    return;
+  }
+
   LOG_TRACE( logger(), "Waiting for datagram..." );
 
   zmq::message_t datagram;
@@ -139,6 +233,17 @@ ::_step()
   push_to_port_using_trait( serialized_message, msg );
 }
 
+// ----------------------------------------------------------------
+void zmq_transport_receive_process
+::mark_complete()
+{
+  LOG_DEBUG( logger(), "End of stream reached, process terminating" );
+
+  mark_process_as_complete();
+  const sprokit::datum_t dat = sprokit::datum::complete_datum();
+  push_datum_to_port_using_trait( serialized_message, dat );
+}
+
 // ----------------------------------------------------------------
 void zmq_transport_receive_process
 ::make_ports()
@@ -157,13 +262,19 @@ ::make_config()
   declare_config_using_trait( port );
   declare_config_using_trait( num_publishers );
   declare_config_using_trait( connect_host );
+  declare_config_using_trait( pattern );
+  declare_config_using_trait( credit );
 }
 
 // ================================================================
 zmq_transport_receive_process::priv
 ::priv()
-  : m_context( 1 )
+  : m_use_credit( false )
+  , m_credit( 4 )
+  , m_context( 1 )
   , m_sub_socket( m_context, ZMQ_SUB )
+  , m_batch_source( -1 )
+  , m_num_done( 0 )
 {
 }
 
@@ -207,4 +318,116 @@ ::connect()
   }
 }
 
+// ----------------------------------------------------------------------------
+void
+zmq_transport_receive_process::priv
+::connect_dealers()
+{
+  LOG_DEBUG( m_logger, "Number of publishers " << m_num_publishers );
+
+  // Publishers are at the same ports as for PUB/SUB, so the same
+  // port layout works for either pattern.
+  for ( int i = 0; i < m_num_publishers * 2; i+=2 )
+  {
+    std::shared_ptr< zmq::socket_t > dealer_socket = std::make_shared< zmq::socket_t >( m_context, ZMQ_DEALER );
+    m_dealer_sockets.push_back( dealer_socket );
+    m_publisher_done.push_back( false );
+
+    std::ostringstream dealer_connect_string;
+    dealer_connect_string << "tcp://" << m_connect_host << ":" << m_port + i;
+    LOG_TRACE( m_logger, "DEALER Connect for " << dealer_connect_string.str() );
+    dealer_socket->connect( dealer_connect_string.str() );
+
+    // The first credit also tells the publisher we are ready
+    send_credit( *dealer_socket, m_credit );
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Wait for the next batch from any publisher
+void
+zmq_transport_receive_process::priv
+::receive_batch()
+{
+  // The previous batch has been taken, so its publisher may send another
+  if ( m_batch_source >= 0 && ! m_publisher_done[ m_batch_source ] )
+  {
+    send_credit( *m_dealer_sockets[ m_batch_source ], 1 );
+  }
+
+  LOG_TRACE( m_logger, "Waiting for batch..." );
+  const int count = static_cast< int >( m_dealer_sockets.size() );
+  while ( m_batch.empty() && ! all_publishers_done() )
+  {
+    // Only wait on publishers which are still sending
+    std::vector< zmq::pollitem_t > items;
+    for ( int i = 0; i < count; ++i )
+    {
+      short events = m_publisher_done[ i ] ? 0 : ZMQ_POLLIN;
+      zmq::pollitem_t item = { static_cast< void* >( *m_dealer_sockets[ i ] ), 0, events, 0 };
+      items.push_back( item );
+    }
+
+    zmq::poll( items.data(), items.size(), -1 );
+
+    // Start after the last source so a busy publisher cannot starve
+    // the others
+    for ( int k = 1; k <= count; ++k )
+    {
+      const int i = ( m_batch_source + k ) % count;
+      if ( ! ( items[ i ].revents & ZMQ_POLLIN ) )
+      {
+        continue;
+      }
+
+      zmq::socket_t& socket = *m_dealer_sockets[ i ];
+      int more = 0;
+      do
+      {
+        zmq::message_t datagram;
+        socket.recv( &datagram );
+        m_batch.push_back( std::make_shared< std::string >(
+                             static_cast< char* >( datagram.data() ), datagram.size() ) );
+
+        size_t more_size = sizeof( more );
+        socket.getsockopt( ZMQ_RCVMORE, &more, &more_size );
+      } while ( more );
+
+      if ( m_batch.size() == 1 && m_batch.front()->empty() )
+      {
+        // An empty message marks the end of this publisher's stream
+        m_batch.clear();
+        m_publisher_done[ i ] = true;
+        ++m_num_done;
+        LOG_DEBUG( m_logger, "End of stream received from publisher " << i );
+        continue;
+      }
+
+      LOG_TRACE( m_logger, "Received batch of " << m_batch.size()
+                 << " messages from publisher " << i );
+      m_batch_source = i;
+      break;
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+bool
+zmq_transport_receive_process::priv
+::all_publishers_done() const
+{
+  return m_num_done >= m_num_publishers;
+}
+
+// ----------------------------------------------------------------------------
+void
+zmq_transport_receive_process::priv
+::send_credit( zmq::socket_t& socket, int count )
+{
+  const std::string text = std::to_string( count );
+  zmq::message_t datagram( text.size() );
+  std::memcpy( datagram.data(), text.data(), text.size() );
+  socket.send( datagram );
+}
+
 } // end namespace
@@ -37,6 +37,7 @@ class KWIVER_PROCESSES_TRANSPORT_NO_EXPORT zmq_transport_receive_process
 private:
   void make_ports();
   void make_config();
+  void mark_complete();
 
   class priv;
   const std::unique_ptr<priv> d;
@@ -7,10 +7,27 @@
 #include <sprokit/pipeline/process_exception.h>
 
 #include <kwiver_type_traits.h>
-#include <memory.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <set>
 
 namespace kwiver {
 
+namespace {
+
+// ----------------------------------------------------------------------------
+// Release the serialized message once ZeroMQ has finished sending it
+void release_message( void* /*data*/, void* hint )
+{
+  delete static_cast< kwiver::vital::string_sptr* >( hint );
+}
+
+} // end namespace
+
 // (config-key, value-type, default-value, description )
 create_config_trait( port, int, "5550",
                      "Port number to connect/bind to.");
@@ -18,6 +35,18 @@ create_config_trait( port, int, "5550",
 create_config_trait( expected_subscribers, int, "1",
                      "Number of subscribers to wait for before starting to publish");
 
+create_config_trait( pattern, std::string, "pubsub",
+                     "Messaging pattern to use. \"pubsub\" publishes each message "
+                     "to all subscribers and drops messages a subscriber is too slow "
+                     "to take. \"dealer\" hands out batches of messages to receivers "
+                     "as they grant credit, so no message is lost. "
+                     "Sender and receivers must use the same pattern." );
+
+create_config_trait( batch_size, int, "1",
+                     "Number of messages sent together as one multipart message "
+                     "when pattern is \"dealer\". A partial batch is sent when "
+                     "the input is complete." );
+
 /**
  * \class zmq_transport_send_process
  *
@@ -41,6 +70,22 @@ create_config_trait( expected_subscribers, int, "1",
  * the configuration. One above that port is used to handle
  * subscription handshaking.
  *
+ * PUB/SUB drops messages for a subscriber that falls behind.  When
+ * every message must be delivered, set the pattern to "dealer".  The
+ * process then binds a ROUTER socket on the configured port, and each
+ * receiver connects a DEALER socket and grants credit for the number
+ * of batches it can accept.  Messages are collected into batches of
+ * batch_size, each batch is sent as one multipart message to a
+ * receiver holding credit, and sending blocks while no receiver has
+ * credit.  Each batch goes to a single receiver, so several receivers
+ * share the work rather than each seeing all of the data.
+ *
+ * When the input is complete any partial batch is sent, followed by
+ * an empty message that tells the receivers the stream has ended.
+ * PUB/SUB sends no such message, as a subscriber that has fallen
+ * behind could drop it and wait forever; its receivers run until
+ * their pipelines are stopped.
+ *
  * \iports
  *
  * \iport{serialized_message} the incoming byte string to publish.
@@ -51,6 +96,11 @@ create_config_trait( expected_subscribers, int, "1",
  *
  * \config{expected_subscribers} the number of subscribers that must
  * connect before publication commences.
+ *
+ * \config{pattern} "pubsub" or "dealer".
+ *
+ * \config{batch_size} the number of messages in each batch when using
+ * the "dealer" pattern.
  */
 
 //----------------------------------------------------------------
@@ -62,15 +112,32 @@ class zmq_transport_send_process::priv
   ~priv();
 
   void connect();
+  void connect_router();
+  void receive_credit( bool wait );
+  void send_batch();
+  void send_end_of_stream();
 
   // Configuration values
   int m_port;
   int m_expected_subscribers;
+  bool m_use_credit;
+  size_t m_batch_size;
 
   //+ any other connection related data goes here
   zmq::context_t m_context;
   zmq::socket_t m_pub_socket;
   zmq::socket_t m_sync_socket;
+  std::unique_ptr< zmq::socket_t > m_router_socket;
+
+  // Every receiver that has granted credit
+  std::set< std::string > m_receivers;
+
+  // One entry per batch a receiver has granted credit for, in the
+  // order the credit arrived.
+  std::deque< std::string > m_credit;
+
+  // Messages waiting to be sent as a batch
+  std::vector< kwiver::vital::string_sptr > m_batch;
 
   vital::logger_handle_t m_logger; // for logging in priv methods
 
@@ -104,6 +171,23 @@ ::_configure()
   d->m_port = config_value_using_trait( port );
   d->m_expected_subscribers = config_value_using_trait( expected_subscribers );
 
+  const std::string pattern = config_value_using_trait( pattern );
+  if ( pattern != "pubsub" && pattern != "dealer" )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Unknown pattern \"" + pattern + "\". "
+                 "Expected \"pubsub\" or \"dealer\"." );
+  }
+  d->m_use_credit = ( pattern == "dealer" );
+
+  const int batch_size = config_value_using_trait( batch_size );
+  if ( batch_size < 1 )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "batch_size must be at least 1" );
+  }
+  d->m_batch_size = static_cast< size_t >( batch_size );
+
   int major, minor, patch;
   zmq_version(&major, &minor, &patch);
   LOG_DEBUG( logger(), "ZeroMQ Version: " << major << "." << minor << "." << patch );
@@ -113,7 +197,14 @@ ::_configure()
 void zmq_transport_send_process
 ::_init()
 {
-  d->connect();
+  if ( d->m_use_credit )
+  {
+    d->connect_router();
+  }
+  else
+  {
+    d->connect();
+  }
 }
 
 // ----------------------------------------------------------------
@@ -124,14 +215,40 @@ ::_step()
 
   scoped_step_instrumentation();
 
+  if ( d->m_use_credit )
+  {
+    d->m_batch.push_back( mess );
+    if ( d->m_batch.size() >= d->m_batch_size )
+    {
+      d->send_batch();
+    }
+    return;
+  }
+
   // We know that the message is a pointer to a std::string
   // send mess to the transport
   LOG_TRACE( logger(), "Sending datagram of size " << mess->size() );
-  zmq::message_t datagram(mess->size());
-  memcpy((void *) datagram.data(), (mess->c_str()), mess->size());
+
+  // The datagram refers to the serialized bytes rather than copying
+  // them, and keeps the message alive until it has been sent.
+  auto* hint = new kwiver::vital::string_sptr( mess );
+  zmq::message_t datagram( const_cast< char* >( mess->data() ), mess->size(),
+                           release_message, hint );
   d->m_pub_socket.send(datagram);
 }
 
+// ----------------------------------------------------------------
+void zmq_transport_send_process
+::_finalize()
+{
+  if ( d->m_use_credit )
+  {
+    // Send what is left of the last batch
+    d->send_batch();
+    d->send_end_of_stream();
+  }
+}
+
 // ----------------------------------------------------------------
 void zmq_transport_send_process
 ::make_ports()
@@ -149,13 +266,17 @@ ::make_config()
 {
   declare_config_using_trait( port );
   declare_config_using_trait( expected_subscribers );
+  declare_config_using_trait( pattern );
+  declare_config_using_trait( batch_size );
 }
 
 // ================================================================
 zmq_transport_send_process::priv
 ::priv()
-  : m_context( 1 )
-  , m_pub_socket( m_context, ZMQ_PUB )
+  : m_use_credit( false )
+  , m_batch_size( 1 )
+  , m_context( 1 )
+  , m_pub_socket( m_context, ZMQ_XPUB )
   , m_sync_socket( m_context, ZMQ_REP )
 {
 }
@@ -170,7 +291,11 @@ void
 zmq_transport_send_process::priv
 ::connect()
 {
-  // Bind to the publisher socket
+  // Bind to the publisher socket.  It is an XPUB socket, which passes
+  // each subscription up to us, so we can tell when the subscribers
+  // will see what is published.
+  int verbose = 1;
+  m_pub_socket.setsockopt( ZMQ_XPUB_VERBOSE, &verbose, sizeof( verbose ) );
   std::ostringstream pub_connect_string;
   pub_connect_string << "tcp://*:" << m_port;
   LOG_TRACE( m_logger, "PUB Connect for " << pub_connect_string.str() );
@@ -197,6 +322,179 @@ ::connect()
     ++subscribers;
   }
   LOG_TRACE( m_logger, "SYNC Loop done, all " << subscribers << " received" );
+
+  // A subscription can arrive after its subscriber's sync request, and
+  // messages published before it are dropped, so wait for them too.
+  // The first byte of each is 1 to subscribe or 0 to unsubscribe.
+  int subscriptions = 0;
+  while ( subscriptions < m_expected_subscribers )
+  {
+    zmq::message_t datagram;
+    m_pub_socket.recv( &datagram );
+    if ( datagram.size() > 0 && static_cast< char* >( datagram.data() )[0] == 1 )
+    {
+      ++subscriptions;
+    }
+  }
+  LOG_TRACE( m_logger, "All " << subscriptions << " subscriptions received" );
+}
+
+// ----------------------------------------------------------------------------
+void
+zmq_transport_send_process::priv
+::connect_router()
+{
+  std::ostringstream router_connect_string;
+  router_connect_string << "tcp://*:" << m_port;
+  LOG_TRACE( m_logger, "ROUTER Connect for " << router_connect_string.str() );
+
+  m_router_socket.reset( new zmq::socket_t( m_context, ZMQ_ROUTER ) );
+
+  // Fail rather than drop a batch addressed to a receiver that has gone
+  int mandatory = 1;
+  m_router_socket->setsockopt( ZMQ_ROUTER_MANDATORY, &mandatory, sizeof( mandatory ) );
+  m_router_socket->bind( router_connect_string.str() );
+
+  // A receiver has connected once it has granted credit
+  LOG_TRACE( m_logger, "Waiting for credit from "
+             << m_expected_subscribers << " receivers" );
+  while ( static_cast< int >( m_receivers.size() ) < m_expected_subscribers )
+  {
+    receive_credit( true );
+  }
+  LOG_TRACE( m_logger, "Credit received from " << m_receivers.size() << " receivers" );
+}
+
+// ----------------------------------------------------------------------------
+// Receive credit messages from receivers.  Each is the receiver identity
+// followed by the number of batches granted.  If wait is true, block
+// until at least one has arrived.
+void
+zmq_transport_send_process::priv
+::receive_credit( bool wait )
+{
+  int flags = wait ? 0 : ZMQ_DONTWAIT;
+  zmq::message_t identity;
+  while ( m_router_socket->recv( &identity, flags ) )
+  {
+    int more = 0;
+    size_t more_size = sizeof( more );
+    m_router_socket->getsockopt( ZMQ_RCVMORE, &more, &more_size );
+    if ( ! more )
+    {
+      LOG_WARN( m_logger, "Dropping credit message without a count" );
+      continue;
+    }
+
+    zmq::message_t count;
+    m_router_socket->recv( &count );
+    const std::string receiver( static_cast< char* >( identity.data() ), identity.size() );
+    const int granted = std::atoi( std::string( static_cast< char* >( count.data() ),
+                                                count.size() ).c_str() );
+    LOG_TRACE( m_logger, "Received credit for " << granted << " batches" );
+
+    m_receivers.insert( receiver );
+    for ( int i = 0; i < granted; ++i )
+    {
+      m_credit.push_back( receiver );
+    }
+
+    // Only wait for the first message
+    flags = ZMQ_DONTWAIT;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Send the collected messages as one multipart message to a receiver
+// with credit, waiting for credit if there is none.
+void
+zmq_transport_send_process::priv
+::send_batch()
+{
+  if ( m_batch.empty() )
+  {
+    return;
+  }
+
+  while ( true )
+  {
+    receive_credit( m_credit.empty() );
+
+    const std::string receiver = m_credit.front();
+    m_credit.pop_front();
+
+    zmq::message_t identity( receiver.size() );
+    std::memcpy( identity.data(), receiver.data(), receiver.size() );
+    try
+    {
+      m_router_socket->send( identity, ZMQ_SNDMORE );
+    }
+    catch ( const zmq::error_t& e )
+    {
+      if ( e.num() != EHOSTUNREACH )
+      {
+        throw;
+      }
+
+      // The receiver has disconnected; its credit is no longer usable
+      LOG_WARN( m_logger, "Receiver disconnected, sending batch to another" );
+      m_credit.erase( std::remove( m_credit.begin(), m_credit.end(), receiver ),
+                      m_credit.end() );
+      m_receivers.erase( receiver );
+      continue;
+    }
+    break;
+  }
+
+  LOG_TRACE( m_logger, "Sending batch of " << m_batch.size() << " messages" );
+  for ( size_t i = 0; i < m_batch.size(); ++i )
+  {
+    // As in _step(), the frame refers to the serialized bytes and keeps
+    // the message alive until it has been sent.
+    auto const& mess = m_batch[ i ];
+    auto* hint = new kwiver::vital::string_sptr( mess );
+    zmq::message_t datagram( const_cast< char* >( mess->data() ), mess->size(),
+                             release_message, hint );
+    m_router_socket->send( datagram, ( i + 1 < m_batch.size() ) ? ZMQ_SNDMORE : 0 );
+  }
+  m_batch.clear();
+}
+
+// ----------------------------------------------------------------------------
+// Tell the dealer receivers that no more messages will be sent.  The
+// end of the stream is marked by an empty message, which a serializer
+// never produces.
+void
+zmq_transport_send_process::priv
+::send_end_of_stream()
+{
+  // Pick up credit from receivers that connected late, so they are
+  // told as well
+  receive_credit( false );
+
+  for ( auto const& receiver : m_receivers )
+  {
+    LOG_TRACE( m_logger, "Sending end of stream to receiver" );
+    zmq::message_t identity( receiver.size() );
+    std::memcpy( identity.data(), receiver.data(), receiver.size() );
+    try
+    {
+      m_router_socket->send( identity, ZMQ_SNDMORE );
+    }
+    catch ( const zmq::error_t& e )
+    {
+      if ( e.num() != EHOSTUNREACH )
+      {
+        throw;
+      }
+
+      // Nothing to tell a receiver that has gone
+      continue;
+    }
+
+    zmq::message_t datagram;
+    m_router_socket->send( datagram );
+  }
 }
 
 } // end namespace
@@ -32,6 +32,7 @@ class KWIVER_PROCESSES_TRANSPORT_NO_EXPORT zmq_transport_send_process
   virtual void _configure();
   virtual void _init();
   virtual void _step();
+  virtual void _finalize();
 
 private:
   void make_ports();
@@ -13,11 +13,18 @@
 #include <sprokit/pipeline/pipeline.h>
 #include <sprokit/pipeline/scheduler.h>
 #include <sprokit/pipeline/scheduler_factory.h>
+#include <sprokit/pipeline_util/export_edge_statistics.h>
 #include <sprokit/pipeline_util/pipe_display.h>
 #include <sprokit/pipeline_util/pipeline_builder.h>
 
+#include <chrono>
+#include <condition_variable>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace sprokit {
 
@@ -26,6 +33,54 @@ namespace tools {
 static const auto scheduler_block =
   kwiver::vital::config_block_key_t( "_scheduler" );
 
+namespace {
+
+// ----------------------------------------------------------------------------
+/// Writes snapshots of the pipeline's edge statistics to a file.
+class edge_stats_writer
+{
+public:
+  edge_stats_writer( sprokit::pipeline_t const& pipe,
+                     std::string const& file_name )
+    : m_pipe( pipe )
+    , m_file( file_name )
+    , m_json( file_name.size() >= 5 &&
+              file_name.compare( file_name.size() - 5, 5, ".json" ) == 0 )
+    , m_header( true )
+    , m_start( std::chrono::steady_clock::now() )
+  {
+  }
+
+  bool good() const { return m_file.good(); }
+
+  void write()
+  {
+    std::chrono::duration< double > const elapsed =
+      std::chrono::steady_clock::now() - m_start;
+    auto const stats = m_pipe->edge_statistics();
+
+    if( m_json )
+    {
+      sprokit::export_edge_statistics_json( m_file, stats, elapsed.count() );
+    }
+    else
+    {
+      sprokit::export_edge_statistics_csv( m_file, stats, elapsed.count(),
+                                           m_header );
+      m_header = false;
+    }
+  }
+
+private:
+  sprokit::pipeline_t const m_pipe;
+  std::ofstream m_file;
+  bool const m_json;
+  bool m_header;
+  std::chrono::steady_clock::time_point const m_start;
+};
+
+} // namespace
+
 // ----------------------------------------------------------------------------
 pipeline_runner
 ::pipeline_runner()
@@ -57,6 +112,12 @@ ::add_command_options()
     ( "S,scheduler", "Scheduler type to use.", cxxopts::value<std::string>() )
     ( "D,dump-pipe", "Dump final pipeline configuration. This is useful for "
       "debugging config related problems." )
+    ( "edge-stats", "File to write edge occupancy and latency statistics to. "
+      "Files ending in .json are written as JSON lines, others as CSV.",
+      cxxopts::value<std::string>() )
+    ( "edge-stats-interval", "Seconds between edge statistics snapshots. "
+      "A setting of 0 only writes the final snapshot.",
+      cxxopts::value<double>()->default_value( "1" ) )
     ;
 
     // positional parameters
@@ -198,9 +259,63 @@ ::run()
     return EXIT_FAILURE;
   }
 
+  std::unique_ptr< edge_stats_writer > stats_writer;
+
+  if( cmd_args.count( "edge-stats" ) > 0 )
+  {
+    std::string const stats_file = cmd_args[ "edge-stats" ].as< std::string >();
+
+    stats_writer.reset( new edge_stats_writer( pipe, stats_file ) );
+
+    if( !stats_writer->good() )
+    {
+      std::cerr << "Error: Unable to open edge statistics file \""
+                << stats_file << "\"" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  double const stats_interval = cmd_args[ "edge-stats-interval" ].as< double >();
+
+  std::mutex stats_mutex;
+  std::condition_variable stats_cond;
+  bool done = false;
+  std::thread stats_thread;
+
   scheduler->start();
+
+  if( stats_writer && stats_interval > 0 )
+  {
+    stats_thread = std::thread( [&]()
+    {
+      auto const interval = std::chrono::duration< double >( stats_interval );
+      std::unique_lock< std::mutex > lock( stats_mutex );
+
+      while( !stats_cond.wait_for( lock, interval, [&]{ return done; } ) )
+      {
+        stats_writer->write();
+      }
+    } );
+  }
+
   scheduler->wait();
 
+  if( stats_thread.joinable() )
+  {
+    {
+      std::lock_guard< std::mutex > const lock( stats_mutex );
+      done = true;
+    }
+
+    stats_cond.notify_one();
+    stats_thread.join();
+  }
+
+  if( stats_writer )
+  {
+    stats_writer->write();
+  }
+
   return EXIT_SUCCESS;
 }
 
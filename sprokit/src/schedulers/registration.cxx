@@ -6,6 +6,7 @@
 
 #include "sync_scheduler.h"
 #include "thread_per_process_scheduler.h"
+#include "thread_pool_scheduler.h"
 
 #include <schedulers/schedulers_export.h>
 
@@ -39,5 +40,12 @@ register_factories( kwiver::vital::plugin_loader& vpm )
     .add_attribute( kwiver::vital::plugin_factory::PLUGIN_DESCRIPTION, "Run each process in its own thread" )
     .add_attribute( kwiver::vital::plugin_factory::PLUGIN_VERSION, "1.0" );
 
+  fact = vpm.ADD_SCHEDULER( sprokit::thread_pool_scheduler );
+  fact->add_attribute( kwiver::vital::plugin_factory::PLUGIN_NAME, "thread_pool" )
+    .add_attribute( kwiver::vital::plugin_factory::PLUGIN_MODULE_NAME, module_name )
+    .add_attribute( kwiver::vital::plugin_factory::PLUGIN_DESCRIPTION,
+                    "Step ready processes on a fixed pool of work-stealing threads" )
+    .add_attribute( kwiver::vital::plugin_factory::PLUGIN_VERSION, "1.0" );
+
   sprokit::mark_scheduler_module_as_loaded( vpm, module_name );
 }
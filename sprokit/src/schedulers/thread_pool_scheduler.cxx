@@ -0,0 +1,697 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "thread_pool_scheduler.h"
+
+#include <vital/config/config_block.h>
+
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/pipeline.h>
+#include <sprokit/pipeline/process.h>
+#include <sprokit/pipeline/scheduler_exception.h>
+#include <sprokit/pipeline/utils.h>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+/**
+ * \file thread_pool_scheduler.cxx
+ *
+ * \brief Implementation of the thread pool scheduler.
+ */
+
+namespace sprokit
+{
+
+static thread_name_t const thread_name = thread_name_t("thread_pool");
+
+class thread_pool_scheduler::priv
+{
+  public:
+    priv(size_t num_threads_);
+    ~priv();
+
+    typedef boost::mutex mutex_t;
+    typedef boost::unique_lock<mutex_t> unique_lock_t;
+
+    typedef boost::shared_mutex pause_mutex_t;
+    typedef boost::shared_lock<pause_mutex_t> shared_lock_t;
+
+    // An edge along with the number of data packets a single step
+    // consumes from it or produces into it.
+    class edge_requirement
+    {
+      public:
+        edge_requirement(edge_t const& edge_, size_t count_);
+
+        edge_t edge;
+        size_t count;
+    };
+
+    enum task_state
+    {
+      task_idle,
+      task_queued,
+      task_running,
+      task_complete
+    };
+
+    // Scheduling information for a single process.
+    class task
+    {
+      public:
+        task(process_t const& proc_);
+
+        process_t const proc;
+        edge_t monitor_edge;
+
+        std::vector<edge_requirement> inputs;
+        std::vector<edge_requirement> outputs;
+
+        // Processes whose readiness may change after this one steps.
+        std::vector<size_t> neighbours;
+
+        bool unsync_input;
+        // The most data packets a step consumes from each input.
+        size_t max_batch;
+
+        mutex_t mut;
+        task_state state;
+    };
+
+    // A queue of ready tasks owned by a single worker thread.
+    class work_queue
+    {
+      public:
+        mutex_t mut;
+        std::deque<size_t> tasks;
+    };
+
+    void build_tasks(pipeline_t const& pipe);
+
+    void run_worker(size_t worker);
+    bool next_task(size_t worker, size_t& t);
+    void wait_for_work(size_t worker);
+    void run_task(size_t worker, size_t t);
+
+    void notify(size_t worker, size_t t);
+    void schedule(size_t worker, size_t t);
+    bool is_ready(task const& tsk) const;
+
+    size_t const num_threads;
+
+    std::vector<std::unique_ptr<task>> tasks;
+    std::vector<std::unique_ptr<work_queue>> queues;
+
+    // Number of processes which have not completed yet.
+    std::atomic<size_t> remaining;
+    // Number of tasks sitting in the worker queues.
+    std::atomic<size_t> pending;
+    std::atomic<bool> stopped;
+
+    mutex_t idle_mut;
+    boost::condition_variable idle_cond;
+
+    mutable pause_mutex_t pause_mut;
+
+    boost::thread_group thread_pool;
+
+    static kwiver::vital::config_block_key_t const config_num_threads;
+};
+
+kwiver::vital::config_block_key_t const thread_pool_scheduler::priv::config_num_threads = kwiver::vital::config_block_key_t("num_threads");
+
+static kwiver::vital::config_block_sptr monitor_edge_config();
+
+// ------------------------------------------------------------------
+thread_pool_scheduler
+::thread_pool_scheduler(pipeline_t const& pipe, kwiver::vital::config_block_sptr const& config)
+  : scheduler(pipe, config)
+  , d()
+{
+  m_logger = kwiver::vital::get_logger( "scheduler.thread_pool" );
+
+  pipeline_t const p = pipeline();
+
+  processes_t procs = p->get_python_processes();
+  if( ! procs.empty() )
+  {
+    std::stringstream str;
+    str << "This pipeline contains the following python processes which are not supported by this scheduler.\n";
+    for ( auto proc : procs )
+    {
+      str << "      \"" << proc->name() << "\" of type \"" << proc->type() << "\"\n";
+    }
+
+    VITAL_THROW( incompatible_pipeline_exception, str.str());
+  }
+
+  process::names_t const names = p->process_names();
+
+  // Processes migrate between the worker threads, so those which
+  // must stay on a single thread can not be run.
+  for (process::name_t const& name : names)
+  {
+    auto proc = p->process_by_name(name);
+    process::properties_t const consts = proc->properties();
+
+    if (consts.count(process::property_no_threads))
+    {
+      std::string const reason =
+        "The process \'" + name + "\' does not support being run from multiple threads.";
+
+      VITAL_THROW( incompatible_pipeline_exception, reason);
+    }
+  }
+
+  size_t num_threads = config->get_value<size_t>(priv::config_num_threads, 0);
+
+  if (!num_threads)
+  {
+    num_threads = boost::thread::hardware_concurrency();
+  }
+
+  // There is no use for more threads than there are processes.
+  num_threads = std::max<size_t>(1, std::min(num_threads, names.size()));
+
+  LOG_DEBUG( m_logger, "Using " << num_threads << " worker threads" );
+
+  d.reset(new priv(num_threads));
+}
+
+// ------------------------------------------------------------------
+thread_pool_scheduler
+::~thread_pool_scheduler()
+{
+  shutdown();
+}
+
+// ------------------------------------------------------------------
+void
+thread_pool_scheduler
+::_start()
+{
+  d->build_tasks(pipeline());
+
+  // Seed the worker queues round-robin so that stealing only needs to
+  // balance the load from there on.
+  for (size_t t = 0; t < d->tasks.size(); ++t)
+  {
+    d->notify(t % d->num_threads, t);
+  }
+
+  for (size_t w = 0; w < d->num_threads; ++w)
+  {
+    d->thread_pool.create_thread(std::bind(&priv::run_worker, d.get(), w));
+  }
+}
+
+// ------------------------------------------------------------------
+void
+thread_pool_scheduler
+::_wait()
+{
+  d->thread_pool.join_all();
+}
+
+// ------------------------------------------------------------------
+void
+thread_pool_scheduler
+::_pause()
+{
+  d->pause_mut.lock();
+}
+
+// ------------------------------------------------------------------
+void
+thread_pool_scheduler
+::_resume()
+{
+  d->pause_mut.unlock();
+}
+
+// ------------------------------------------------------------------
+void
+thread_pool_scheduler
+::_stop()
+{
+  d->stopped = true;
+
+  {
+    priv::unique_lock_t const lock(d->idle_mut);
+
+    (void)lock;
+  }
+
+  d->idle_cond.notify_all();
+  d->thread_pool.interrupt_all();
+}
+
+// ============================================================================
+thread_pool_scheduler::priv
+::priv(size_t num_threads_)
+  : num_threads(num_threads_)
+  , tasks()
+  , queues()
+  , remaining(0)
+  , pending(0)
+  , stopped(false)
+  , idle_mut()
+  , idle_cond()
+  , pause_mut()
+  , thread_pool()
+{
+  for (size_t w = 0; w < num_threads; ++w)
+  {
+    queues.emplace_back(new work_queue);
+  }
+}
+
+// ------------------------------------------------------------------
+thread_pool_scheduler::priv
+::~priv()
+{
+}
+
+// ------------------------------------------------------------------
+thread_pool_scheduler::priv::edge_requirement
+::edge_requirement(edge_t const& edge_, size_t count_)
+  : edge(edge_)
+  , count(count_)
+{
+}
+
+// ------------------------------------------------------------------
+thread_pool_scheduler::priv::task
+::task(process_t const& proc_)
+  : proc(proc_)
+  , monitor_edge()
+  , inputs()
+  , outputs()
+  , neighbours()
+  , unsync_input(false)
+  , max_batch(1)
+  , mut()
+  , state(task_idle)
+{
+}
+
+// ------------------------------------------------------------------
+/*
+ * Map every process to the edges which gate its execution and to the
+ * processes which share those edges.
+ */
+void
+thread_pool_scheduler::priv
+::build_tasks(pipeline_t const& pipe)
+{
+  process::names_t const names = pipe->process_names();
+  std::map<process::name_t, size_t> index;
+
+  kwiver::vital::config_block_sptr const edge_conf = monitor_edge_config();
+
+  for (process::name_t const& name : names)
+  {
+    process_t const proc = pipe->process_by_name(name);
+    std::unique_ptr<task> tsk(new task(proc));
+
+    tsk->monitor_edge = std::make_shared<edge>(edge_conf);
+    proc->connect_output_port(process::port_heartbeat, tsk->monitor_edge);
+
+    tsk->unsync_input = (proc->properties().count(process::property_unsync_input) != 0);
+    tsk->max_batch = proc->max_batch_size();
+
+    for (process::port_t const& port : proc->input_ports())
+    {
+      edge_t const iedge = pipe->input_edge_for_port(name, port);
+
+      if (!iedge)
+      {
+        continue;
+      }
+
+      // Ports with a frequency of 0 are irregular, so there is no way
+      // to know how much data a step wants.
+      process::port_frequency_t const freq = proc->input_port_info(port)->frequency;
+      size_t const count = (freq ? freq.numerator() : 0);
+
+      tsk->inputs.push_back(edge_requirement(iedge, count));
+    }
+
+    for (process::port_t const& port : proc->output_ports())
+    {
+      process::port_frequency_t const freq = proc->output_port_info(port)->frequency;
+      size_t const count = (freq ? freq.numerator() : 1);
+
+      for (edge_t const& oedge : pipe->output_edges_for_port(name, port))
+      {
+        tsk->outputs.push_back(edge_requirement(oedge, count));
+      }
+    }
+
+    index[name] = tasks.size();
+    tasks.push_back(std::move(tsk));
+  }
+
+  for (process::name_t const& name : names)
+  {
+    std::vector<size_t>& neighbours = tasks[index[name]]->neighbours;
+
+    for (process_t const& up : pipe->upstream_for_process(name))
+    {
+      neighbours.push_back(index[up->name()]);
+    }
+
+    for (process_t const& down : pipe->downstream_for_process(name))
+    {
+      neighbours.push_back(index[down->name()]);
+    }
+
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+  }
+
+  remaining = tasks.size();
+}
+
+// ------------------------------------------------------------------
+void
+thread_pool_scheduler::priv
+::run_worker(size_t worker)
+{
+  name_thread(thread_name);
+
+  while (remaining && !stopped)
+  {
+    // This call allows an exception to be thrown (boost::thread_interrupted)
+    // Since this exception is not caught, it causes the thread to terminate.
+    boost::this_thread::interruption_point();
+
+    size_t t;
+
+    if (!next_task(worker, t))
+    {
+      wait_for_work(worker);
+      continue;
+    }
+
+    run_task(worker, t);
+  }
+
+  // Let any sleeping workers notice that the pipeline is done.
+  {
+    unique_lock_t const lock(idle_mut);
+
+    (void)lock;
+  }
+
+  idle_cond.notify_all();
+}
+
+// ------------------------------------------------------------------
+/*
+ * Take the most recently queued task from our own queue, which is the
+ * most likely to have its data still in cache. Failing that, steal the
+ * oldest task from another worker.
+ */
+bool
+thread_pool_scheduler::priv
+::next_task(size_t worker, size_t& t)
+{
+  for (size_t i = 0; i < num_threads; ++i)
+  {
+    work_queue& queue = *queues[(worker + i) % num_threads];
+    unique_lock_t const lock(queue.mut);
+
+    (void)lock;
+
+    if (queue.tasks.empty())
+    {
+      continue;
+    }
+
+    if (i == 0)
+    {
+      t = queue.tasks.back();
+      queue.tasks.pop_back();
+    }
+    else
+    {
+      t = queue.tasks.front();
+      queue.tasks.pop_front();
+    }
+
+    --pending;
+
+    return true;
+  }
+
+  return false;
+}
+
+// ------------------------------------------------------------------
+void
+thread_pool_scheduler::priv
+::wait_for_work(size_t worker)
+{
+  static boost::chrono::milliseconds const rescan_interval(10);
+
+  bool woken;
+
+  {
+    unique_lock_t lock(idle_mut);
+
+    woken = idle_cond.wait_for(lock, rescan_interval, [this]()
+    {
+      return pending || !remaining || stopped;
+    });
+  }
+
+  // Readiness is re-evaluated whenever a neighbour steps, so this
+  // should find nothing. It is kept as a safety net for edges which
+  // change outside of a step.
+  if (!woken)
+  {
+    for (size_t t = 0; t < tasks.size(); ++t)
+    {
+      notify(worker, t);
+    }
+  }
+}
+
+// ------------------------------------------------------------------
+void
+thread_pool_scheduler::priv
+::run_task(size_t worker, size_t t)
+{
+  task& tsk = *tasks[t];
+
+  {
+    // This locking will cause this thread to pause if the scheduler
+    // pause() method is called.
+    shared_lock_t const lock(pause_mut);
+
+    (void)lock;
+
+    tsk.proc->step();
+  }
+
+  bool complete = false;
+
+  // Check the monitor edge to see if the process is still running
+  // or has completed.
+  while (tsk.monitor_edge->has_data())
+  {
+    edge_datum_t const edat = tsk.monitor_edge->get_datum();
+
+    if (edat.datum->type() == datum::complete)
+    {
+      complete = true;
+    }
+  }
+
+  {
+    unique_lock_t const lock(tsk.mut);
+
+    (void)lock;
+
+    if (complete)
+    {
+      tsk.state = task_complete;
+    }
+    else
+    {
+      // Anything pushed while this process was running was not able to
+      // queue it, so readiness must be checked again under the lock.
+      tsk.state = task_idle;
+      schedule(worker, t);
+    }
+  }
+
+  if (complete && !--remaining)
+  {
+    {
+      unique_lock_t const lock(idle_mut);
+
+      (void)lock;
+    }
+
+    idle_cond.notify_all();
+  }
+
+  // The step consumed data from upstream edges and produced data for
+  // downstream edges, so the neighbours may be ready now.
+  for (size_t const n : tsk.neighbours)
+  {
+    notify(worker, n);
+  }
+}
+
+// ------------------------------------------------------------------
+void
+thread_pool_scheduler::priv
+::notify(size_t worker, size_t t)
+{
+  task& tsk = *tasks[t];
+  unique_lock_t const lock(tsk.mut);
+
+  (void)lock;
+
+  schedule(worker, t);
+}
+
+// ------------------------------------------------------------------
+/*
+ * Queue the task on the given worker if it is idle and ready. The
+ * caller must hold the task's mutex.
+ */
+void
+thread_pool_scheduler::priv
+::schedule(size_t worker, size_t t)
+{
+  task& tsk = *tasks[t];
+
+  if (tsk.state != task_idle || !is_ready(tsk))
+  {
+    return;
+  }
+
+  tsk.state = task_queued;
+
+  {
+    work_queue& queue = *queues[worker];
+    unique_lock_t const lock(queue.mut);
+
+    (void)lock;
+
+    queue.tasks.push_back(t);
+    ++pending;
+  }
+
+  {
+    unique_lock_t const lock(idle_mut);
+
+    (void)lock;
+  }
+
+  idle_cond.notify_one();
+}
+
+// ------------------------------------------------------------------
+/*
+ * A process is ready when a step will neither wait on its inputs nor
+ * on its outputs.
+ */
+bool
+thread_pool_scheduler::priv
+::is_ready(task const& tsk) const
+{
+  bool any_input = tsk.inputs.empty();
+  // A batch process pushes a datum per input packet it consumes, so the
+  // step may need room for up to that many on each output.
+  size_t batch = (tsk.inputs.empty() ? tsk.max_batch : 1);
+
+  for (edge_requirement const& input : tsk.inputs)
+  {
+    size_t const count = input.edge->datum_count();
+
+    batch = std::max(batch, std::min(count, tsk.max_batch));
+
+    if (count && count >= input.count)
+    {
+      any_input = true;
+      continue;
+    }
+
+    // Control packets are only ever consumed one at a time.
+    if (count && (datum::flush <= input.edge->peek_datum().datum->type()))
+    {
+      any_input = true;
+      continue;
+    }
+
+    // Processes which do not need synchronized inputs may step with
+    // data on any input.
+    if (!tsk.unsync_input)
+    {
+      return false;
+    }
+  }
+
+  if (!any_input)
+  {
+    return false;
+  }
+
+  for (edge_requirement const& output : tsk.outputs)
+  {
+    edge_t const& oedge = output.edge;
+    size_t const capacity = oedge->capacity();
+
+    if (!capacity || !oedge->is_blocking() || oedge->is_downstream_complete())
+    {
+      continue;
+    }
+
+    size_t const needed = std::min(std::max<size_t>(output.count, 1) * batch, capacity);
+
+    if (capacity < oedge->datum_count() + needed)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// ------------------------------------------------------------------
+/**
+ * This function returns the config block for the "monitor_edge". The
+ * monitor_edge being the one where the process generates a heart beat datum.
+ *
+ * Currently there is no config for these edges.
+ */
+kwiver::vital::config_block_sptr
+monitor_edge_config()
+{
+  kwiver::vital::config_block_sptr conf = kwiver::vital::config_block::empty_config();
+
+  // Empty config will create a default edge.
+
+  return conf;
+}
+
+}
@@ -2,15 +2,13 @@
 // OSI-approved BSD 3-Clause License. See top-level LICENSE file or
 // https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
 
-#ifndef SPROKIT_SCHEDULERS_EXAMPLES_SCHEDULERS_THREAD_POOL_SCHEDULER_H
-#define SPROKIT_SCHEDULERS_EXAMPLES_SCHEDULERS_THREAD_POOL_SCHEDULER_H
+#ifndef SPROKIT_SCHEDULERS_SCHEDULERS_THREAD_POOL_SCHEDULER_H
+#define SPROKIT_SCHEDULERS_SCHEDULERS_THREAD_POOL_SCHEDULER_H
 
-#include <schedulers/examples/schedulers_examples_export.h>
+#include <schedulers/schedulers_export.h>
 
 #include <sprokit/pipeline/scheduler.h>
 
-#include <cstddef>
-
 /**
  * \file thread_pool_scheduler.h
  *
@@ -23,7 +21,18 @@ namespace sprokit
 /**
  * \class thread_pool_scheduler
  *
- * \brief A scheduler which process execution among a group of threads.
+ * \brief A scheduler which steps processes on a fixed pool of threads.
+ *
+ * Each worker thread owns a queue of processes which are ready to be
+ * stepped. A process is considered ready when its input edges hold
+ * enough data for one step and its output edges have room for the
+ * results. After stepping a process, the worker re-evaluates the
+ * process and its neighbours and queues those which became ready on
+ * its own queue. Workers which run out of work steal from the queues
+ * of the other workers.
+ *
+ * A process is never stepped by more than one thread at a time, but
+ * consecutive steps may run on different threads.
  *
  * \scheduler Manages execution using a set number of threads.
  *
@@ -31,47 +40,54 @@ namespace sprokit
  *
  * \config{num_threads} The number of threads to run. A setting of \c 0 means "auto".
  */
-class SCHEDULERS_EXAMPLES_NO_EXPORT thread_pool_scheduler
+class SCHEDULERS_NO_EXPORT thread_pool_scheduler
   : public scheduler
 {
   public:
     /**
      * \brief Constructor.
      *
-     * \param config Contains config for the edge.
      * \param pipe The pipeline to scheduler.
+     * \param config Contains config for the scheduler.
      */
     thread_pool_scheduler(pipeline_t const& pipe, kwiver::vital::config_block_sptr const& config);
+
     /**
      * \brief Destructor.
      */
     ~thread_pool_scheduler();
+
   protected:
     /**
      * \brief Starts execution.
      */
     void _start();
+
     /**
      * \brief Waits until execution is finished.
      */
     void _wait();
+
     /**
      * \brief Pauses execution.
      */
     void _pause();
+
     /**
      * \brief Resumes execution.
      */
     void _resume();
+
     /**
      * \brief Stop execution of the pipeline.
      */
     void _stop();
+
   private:
     class priv;
     std::unique_ptr<priv> d;
 };
 
-} // end namespace
+}
 
-#endif // SPROKIT_SCHEDULERS_EXAMPLES_SCHEDULERS_THREAD_POOL_SCHEDULER_H
+#endif // SPROKIT_SCHEDULERS_SCHEDULERS_THREAD_POOL_SCHEDULER_H
@@ -15,8 +15,14 @@
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <deque>
+#include <vector>
 
 /**
  * \file edge.cxx
@@ -72,22 +78,55 @@ ::operator == (edge_datum_t const& rhs) const
 kwiver::vital::config_block_key_t const edge::config_dependency = kwiver::vital::config_block_key_t("_dependency");
 kwiver::vital::config_block_key_t const edge::config_capacity   = kwiver::vital::config_block_key_t("capacity");
 kwiver::vital::config_block_key_t const edge::config_blocking   = kwiver::vital::config_block_key_t("blocking");
+kwiver::vital::config_block_key_t const edge::config_lock_free  = kwiver::vital::config_block_key_t("lock_free");
 
 // ==================================================================
 class edge::priv
 {
   public:
-    priv(bool depends_, size_t capacity_, bool blocking_);
+    priv(bool depends_, size_t capacity_, bool blocking_, bool lock_free_);
     ~priv();
 
     typedef std::weak_ptr<process> process_ref_t;
 
     bool full_of_data() const;
+    size_t size() const;
     void complete_check() const;
 
     bool push(edge_datum_t const& datum, kwiver::vital::optional<duration_t> const& duration = kwiver::vital::nullopt);
     kwiver::vital::optional<edge_datum_t> pop(kwiver::vital::optional<duration_t> const& duration = kwiver::vital::nullopt);
 
+    bool push_batch(edge_data_t const& data);
+    edge_data_t pop_batch(size_t max_count);
+
+    typedef std::atomic<int64_t> counter_t;
+
+    void record_push();
+    void record_pop(clock_t::time_point const& pushed, clock_t::time_point const& now);
+
+    // Adds the lifetime of the timer to a counter if a wait is about
+    // to block.
+    class wait_timer
+    {
+      public:
+        wait_timer(counter_t& total_, bool blocked_);
+        ~wait_timer();
+
+      private:
+        counter_t& total;
+        bool const blocked;
+        clock_t::time_point const start;
+    };
+
+    bool ring_push(edge_datum_t const& datum, kwiver::vital::optional<duration_t> const& duration);
+    kwiver::vital::optional<edge_datum_t> ring_pop(kwiver::vital::optional<duration_t> const& duration);
+    edge_datum_t ring_peek(size_t idx) const;
+    void ring_clear();
+    template <typename Predicate>
+    bool ring_wait(Predicate const& pred, kwiver::vital::optional<duration_t> const& duration,
+                   counter_t& blocked) const;
+    void ring_wake() const;
+
     /// This flag indicates that this edge connection should or should
     /// not imply a dependency. Generally set to false if a backwards
     /// edge.
@@ -99,14 +138,21 @@ class edge::priv
     /// Set to indicate if this edge will block if its buffer is full.
     bool const blocking;
 
-    bool downstream_complete;
+    /// Set to indicate that the buffer is a lock-free single-producer,
+    /// single-consumer ring rather than a locked queue.
+    bool const lock_free;
+
+    std::atomic<bool> downstream_complete;
 
     process_ref_t upstream;
     process_ref_t downstream;
 
     typedef std::deque<edge_datum_t> edge_queue_t;
+    typedef std::deque<clock_t::time_point> time_queue_t;
 
     edge_queue_t q;
+    // When each datum in the queue was pushed.
+    time_queue_t q_times;
 
     boost::condition_variable_any cond_have_data;
     boost::condition_variable_any cond_have_space;
@@ -120,9 +166,67 @@ class edge::priv
     mutable mutex_t mutex;
     mutable mutex_t complete_mutex;
 
+    // The lock-free ring. The producer only writes \c tail and the
+    // consumer only writes \c head; both count up monotonically and
+    // are reduced modulo the capacity to index the slots.
+    std::vector<edge_datum_t> ring;
+    std::vector<clock_t::time_point> ring_times;
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+
+    // Threads which gave up spinning wait here until the other side
+    // moves the ring along.
+    mutable boost::mutex park_mutex;
+    mutable boost::condition_variable park_cond;
+    mutable std::atomic<size_t> parked;
+
+    // Telemetry. These are only ever updated with relaxed atomics so
+    // that they stay off the critical path.
+    std::atomic<size_t> high_water_mark;
+    std::atomic<size_t> push_count;
+    std::atomic<size_t> pop_count;
+    mutable counter_t blocked_push_ns;
+    mutable counter_t blocked_pop_ns;
+    counter_t latency_total_ns;
+    counter_t latency_max_ns;
+
     kwiver::vital::logger_handle_t m_logger;
 };
 
+// ==================================================================
+edge_statistics_t
+::edge_statistics_t()
+  : depth(0)
+  , capacity(0)
+  , high_water_mark(0)
+  , push_count(0)
+  , pop_count(0)
+  , blocked_push_time(duration_t::zero())
+  , blocked_pop_time(duration_t::zero())
+  , total_latency(duration_t::zero())
+  , max_latency(duration_t::zero())
+{
+}
+
+// ------------------------------------------------------------------
+edge_statistics_t
+::~edge_statistics_t()
+{
+}
+
+// ------------------------------------------------------------------
+edge_statistics_t::duration_t
+edge_statistics_t
+::mean_latency() const
+{
+  if (!pop_count)
+  {
+    return duration_t::zero();
+  }
+
+  return total_latency / static_cast<duration_t::rep>(pop_count);
+}
+
 // ==================================================================
 edge
 ::edge(kwiver::vital::config_block_sptr const& config)
@@ -136,13 +240,22 @@ ::edge(kwiver::vital::config_block_sptr const& config)
   bool const depends    = config->get_value<bool>(config_dependency, true);
   size_t const capacity = config->get_value<size_t>(config_capacity, SPROKIT_DEFAULT_EDGE_CAPACITY );
   bool const blocking   = config->get_value<bool>(config_blocking, true);
+  bool lock_free        = config->get_value<bool>(config_lock_free, false);
+
+  if ( lock_free && 0 == capacity )
+  {
+    LOG_WARN( kwiver::vital::get_logger( "sprokit.edge" ),
+              "Lock-free edges must have a capacity; using a locked queue instead" );
+    lock_free = false;
+  }
 
-  d.reset(new priv(depends, capacity, blocking));
+  d.reset(new priv(depends, capacity, blocking, lock_free));
 
-  if ( 0 != capacity || ! blocking )
+  if ( 0 != capacity || ! blocking || lock_free )
   {
     LOG_DEBUG( d->m_logger, "Edge capacity set to: " << capacity
-               << "   " << (blocking ? "" : "non-" ) << "blocking: ");
+               << "   " << (blocking ? "" : "non-" ) << "blocking: "
+               << "   " << (lock_free ? "lock-free" : "locked" ) );
   }
 }
 
@@ -160,11 +273,64 @@ ::makes_dependency() const
   return d->depends;
 }
 
+// ------------------------------------------------------------------
+size_t
+edge
+::capacity() const
+{
+  return d->capacity;
+}
+
+// ------------------------------------------------------------------
+bool
+edge
+::is_blocking() const
+{
+  return d->blocking;
+}
+
+// ------------------------------------------------------------------
+edge_statistics_t
+edge
+::statistics() const
+{
+  edge_statistics_t stats;
+
+  if (d->lock_free)
+  {
+    stats.depth = d->size();
+  }
+  else
+  {
+    priv::shared_lock_t const lock(d->mutex);
+
+    (void)lock;
+
+    stats.depth = d->q.size();
+  }
+
+  stats.capacity = d->capacity;
+  stats.high_water_mark = d->high_water_mark.load(std::memory_order_relaxed);
+  stats.push_count = d->push_count.load(std::memory_order_relaxed);
+  stats.pop_count = d->pop_count.load(std::memory_order_relaxed);
+  stats.blocked_push_time = edge_statistics_t::duration_t(d->blocked_push_ns.load(std::memory_order_relaxed));
+  stats.blocked_pop_time = edge_statistics_t::duration_t(d->blocked_pop_ns.load(std::memory_order_relaxed));
+  stats.total_latency = edge_statistics_t::duration_t(d->latency_total_ns.load(std::memory_order_relaxed));
+  stats.max_latency = edge_statistics_t::duration_t(d->latency_max_ns.load(std::memory_order_relaxed));
+
+  return stats;
+}
+
 // ------------------------------------------------------------------
 bool
 edge
 ::has_data() const
 {
+  if (d->lock_free)
+  {
+    return (0 != d->size());
+  }
+
   priv::shared_lock_t const lock(d->mutex);
 
   (void)lock;
@@ -177,6 +343,11 @@ bool
 edge
 ::full_of_data() const
 {
+  if (d->lock_free)
+  {
+    return d->full_of_data();
+  }
+
   priv::shared_lock_t const lock(d->mutex);
 
   (void)lock;
@@ -189,6 +360,11 @@ size_t
 edge
 ::datum_count() const
 {
+  if (d->lock_free)
+  {
+    return d->size();
+  }
+
   priv::shared_lock_t const lock(d->mutex);
 
   (void)lock;
@@ -229,10 +405,19 @@ ::peek_datum(size_t idx) const
 {
   d->complete_check();
 
+  if (d->lock_free)
+  {
+    return d->ring_peek(idx);
+  }
+
   priv::shared_lock_t lock(d->mutex);
 
-  d->cond_have_data.wait(lock,
-      boost::bind(&priv::edge_queue_t::size, &d->q) > idx);
+  {
+    priv::wait_timer const timer(d->blocked_pop_ns, d->q.size() <= idx);
+
+    d->cond_have_data.wait(lock,
+        boost::bind(&priv::edge_queue_t::size, &d->q) > idx);
+  }
 
   return d->q.at(idx);
 }
@@ -244,24 +429,87 @@ ::pop_datum()
 {
   d->complete_check();
 
+  if (d->lock_free)
+  {
+    d->ring_pop(kwiver::vital::nullopt);
+
+    return;
+  }
+
   {
     priv::upgrade_lock_t lock(d->mutex);
 
-    d->cond_have_data.wait(lock,
-        !boost::bind(&priv::edge_queue_t::empty, &d->q));
+    {
+      priv::wait_timer const timer(d->blocked_pop_ns, d->q.empty());
+
+      d->cond_have_data.wait(lock,
+          !boost::bind(&priv::edge_queue_t::empty, &d->q));
+    }
 
     {
       priv::upgrade_to_unique_lock_t const write_lock(lock);
 
       (void)write_lock;
 
+      d->record_pop(d->q_times.front(), clock_t::now());
+
       d->q.pop_front();
+      d->q_times.pop_front();
     }
   }
 
   d->cond_have_space.notify_one();
 }
 
+// ------------------------------------------------------------------
+void
+edge
+::push_data(edge_data_t const& data)
+{
+  d->push_batch(data);
+}
+
+// ------------------------------------------------------------------
+edge_data_t
+edge
+::get_data(size_t max_count)
+{
+  return d->pop_batch(max_count);
+}
+
+// ------------------------------------------------------------------
+edge_data_t
+edge
+::peek_data(size_t max_count) const
+{
+  d->complete_check();
+
+  edge_data_t data;
+
+  if (d->lock_free)
+  {
+    size_t const h = d->head.load(std::memory_order_relaxed);
+    size_t const count = std::min(max_count, d->size());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      data.push_back(d->ring[(h + i) % d->capacity]);
+    }
+
+    return data;
+  }
+
+  priv::shared_lock_t const lock(d->mutex);
+
+  (void)lock;
+
+  size_t const count = std::min(max_count, d->q.size());
+
+  data.assign(d->q.begin(), d->q.begin() + count);
+
+  return data;
+}
+
 // ------------------------------------------------------------------
 bool
 edge
@@ -283,6 +531,14 @@ void
 edge
 ::mark_downstream_as_complete()
 {
+  if (d->lock_free)
+  {
+    d->downstream_complete = true;
+    d->ring_clear();
+
+    return;
+  }
+
   priv::unique_lock_t const complete_lock(d->complete_mutex);
   priv::unique_lock_t const lock(d->mutex);
 
@@ -291,10 +547,8 @@ ::mark_downstream_as_complete()
 
   d->downstream_complete = true;
 
-  while (!d->q.empty())
-  {
-    d->q.pop_front();
-  }
+  d->q.clear();
+  d->q_times.clear();
 
   d->cond_have_space.notify_one();
 }
@@ -304,6 +558,11 @@ bool
 edge
 ::is_downstream_complete() const
 {
+  if (d->lock_free)
+  {
+    return d->downstream_complete;
+  }
+
   priv::shared_lock_t const lock(d->complete_mutex);
 
   (void)lock;
@@ -355,10 +614,11 @@ ::set_downstream_process(process_t process)
 
 // ==================================================================
 edge::priv
-::priv(bool depends_, size_t capacity_, bool blocking_)
+::priv(bool depends_, size_t capacity_, bool blocking_, bool lock_free_)
   : depends(depends_)
   , capacity(capacity_)
   , blocking(blocking_)
+  , lock_free(lock_free_)
   , downstream_complete(false)
   , upstream()
   , downstream()
@@ -367,6 +627,20 @@ ::priv(bool depends_, size_t capacity_, bool blocking_)
   , cond_have_space()
   , mutex()
   , complete_mutex()
+  , ring(lock_free_ ? capacity_ : 0)
+  , ring_times(lock_free_ ? capacity_ : 0)
+  , head(0)
+  , tail(0)
+  , park_mutex()
+  , park_cond()
+  , parked(0)
+  , high_water_mark(0)
+  , push_count(0)
+  , pop_count(0)
+  , blocked_push_ns(0)
+  , blocked_pop_ns(0)
+  , latency_total_ns(0)
+  , latency_max_ns(0)
   , m_logger( kwiver::vital::get_logger( "sprokit.edge" ))
 {
 }
@@ -387,7 +661,24 @@ ::full_of_data() const
     return false;
   }
 
-  return (capacity <= q.size());
+  return (capacity <= size());
+}
+
+// ------------------------------------------------------------------
+size_t
+edge::priv
+::size() const
+{
+  if (!lock_free)
+  {
+    return q.size();
+  }
+
+  // Read the head first so that the difference can never go negative.
+  size_t const h = head.load(std::memory_order_acquire);
+  size_t const t = tail.load(std::memory_order_acquire);
+
+  return std::min(t - h, capacity);
 }
 
 // ------------------------------------------------------------------
@@ -395,6 +686,16 @@ void
 edge::priv
 ::complete_check() const
 {
+  if (lock_free)
+  {
+    if (downstream_complete)
+    {
+      VITAL_THROW( datum_requested_after_complete );
+    }
+
+    return;
+  }
+
   shared_lock_t const lock(complete_mutex);
 
   (void)lock;
@@ -410,6 +711,11 @@ bool
 edge::priv
 ::push(edge_datum_t const& datum, kwiver::vital::optional<duration_t> const& duration)
 {
+  if (lock_free)
+  {
+    return ring_push(datum, duration);
+  }
+
   {
     shared_lock_t const lock(complete_mutex);
 
@@ -426,17 +732,21 @@ ::push(edge_datum_t const& datum, kwiver::vital::optional<duration_t> const& dur
     upgrade_lock_t lock(mutex);
     boost::function<bool ()> const predicate = !boost::bind(&sprokit::edge::priv::full_of_data, this);
 
-    if (duration)
     {
-      // Wait for specified duration before giving up
-      if (!cond_have_space.wait_for(lock, *duration, predicate))
+      wait_timer const timer(blocked_push_ns, !predicate());
+
+      if (duration)
       {
-        return false;
+        // Wait for specified duration before giving up
+        if (!cond_have_space.wait_for(lock, *duration, predicate))
+        {
+          return false;
+        }
+      }
+      else
+      {
+        cond_have_space.wait(lock, predicate);
       }
-    }
-    else
-    {
-      cond_have_space.wait(lock, predicate);
     }
 
     {
@@ -444,7 +754,11 @@ ::push(edge_datum_t const& datum, kwiver::vital::optional<duration_t> const& dur
 
       (void)write_lock;
 
+      clock_t::time_point const now = clock_t::now();
+
       q.push_back(datum);
+      q_times.push_back(now);
+      record_push();
     }
   }
 
@@ -460,22 +774,31 @@ ::pop(kwiver::vital::optional<duration_t> const& duration)
 {
   complete_check();
 
+  if (lock_free)
+  {
+    return ring_pop(duration);
+  }
+
   edge_datum_t dat;
 
   {
     upgrade_lock_t lock(mutex);
     boost::function<bool ()> const predicate = !boost::bind(&edge_queue_t::empty, &q);
 
-    if (duration)
     {
-      if (!cond_have_data.wait_for(lock, *duration, predicate))
+      wait_timer const timer(blocked_pop_ns, q.empty());
+
+      if (duration)
       {
-        return kwiver::vital::nullopt;
+        if (!cond_have_data.wait_for(lock, *duration, predicate))
+        {
+          return kwiver::vital::nullopt;
+        }
+      }
+      else
+      {
+        cond_have_data.wait(lock, predicate);
       }
-    }
-    else
-    {
-      cond_have_data.wait(lock, predicate);
     }
 
     dat = q.front();
@@ -485,7 +808,10 @@ ::pop(kwiver::vital::optional<duration_t> const& duration)
 
       (void)write_lock;
 
+      record_pop(q_times.front(), clock_t::now());
+
       q.pop_front();
+      q_times.pop_front();
     }
   }
 
@@ -494,6 +820,394 @@ ::pop(kwiver::vital::optional<duration_t> const& duration)
   return dat;
 }
 
+// ------------------------------------------------------------------
+bool
+edge::priv
+::push_batch(edge_data_t const& data)
+{
+  // Non-blocking edges decide whether to drop each packet on its own
+  // and the lock-free ring has no lock to amortize.
+  if (!blocking || lock_free)
+  {
+    for (edge_datum_t const& datum : data)
+    {
+      if (!blocking && (datum.datum->type() == datum::data))
+      {
+        push(datum, duration_t(0));
+      }
+      else
+      {
+        push(datum);
+      }
+    }
+
+    return true;
+  }
+
+  {
+    shared_lock_t const lock(complete_mutex);
+
+    (void)lock;
+
+    // If downstream process has marked itself as complete, do nothing
+    if (downstream_complete)
+    {
+      return true;
+    }
+  }
+
+  {
+    upgrade_lock_t lock(mutex);
+    boost::function<bool ()> const predicate = !boost::bind(&sprokit::edge::priv::full_of_data, this);
+
+    for (edge_datum_t const& datum : data)
+    {
+      if (full_of_data())
+      {
+        wait_timer const timer(blocked_push_ns, true);
+
+        // Let the downstream process drain what has been added so far.
+        cond_have_data.notify_one();
+        cond_have_space.wait(lock, predicate);
+      }
+
+      upgrade_to_unique_lock_t const write_lock(lock);
+
+      (void)write_lock;
+
+      clock_t::time_point const now = clock_t::now();
+
+      q.push_back(datum);
+      q_times.push_back(now);
+      record_push();
+    }
+  }
+
+  cond_have_data.notify_one();
+
+  return true;
+}
+
+// ------------------------------------------------------------------
+edge_data_t
+edge::priv
+::pop_batch(size_t max_count)
+{
+  complete_check();
+
+  edge_data_t data;
+
+  if (lock_free)
+  {
+    data.push_back(*ring_pop(kwiver::vital::nullopt));
+
+    while ((data.size() < max_count) &&
+           (data.front().datum->type() == datum::data) &&
+           (tail.load(std::memory_order_acquire) != head.load(std::memory_order_relaxed)) &&
+           (ring[head.load(std::memory_order_relaxed) % capacity].datum->type() == datum::data))
+    {
+      data.push_back(*ring_pop(kwiver::vital::nullopt));
+    }
+
+    return data;
+  }
+
+  {
+    upgrade_lock_t lock(mutex);
+
+    {
+      wait_timer const timer(blocked_pop_ns, q.empty());
+
+      cond_have_data.wait(lock,
+          !boost::bind(&edge_queue_t::empty, &q));
+    }
+
+    upgrade_to_unique_lock_t const write_lock(lock);
+
+    (void)write_lock;
+
+    clock_t::time_point const now = clock_t::now();
+
+    do
+    {
+      data.push_back(q.front());
+      record_pop(q_times.front(), now);
+
+      q.pop_front();
+      q_times.pop_front();
+    } while ((data.size() < max_count) &&
+             (data.front().datum->type() == datum::data) &&
+             !q.empty() &&
+             (q.front().datum->type() == datum::data));
+  }
+
+  cond_have_space.notify_one();
+
+  return data;
+}
+
+// ------------------------------------------------------------------
+/*
+ * Only the upstream process pushes into the edge, so the slot at the
+ * tail can be written without synchronization once there is space.
+ */
+bool
+edge::priv
+::ring_push(edge_datum_t const& datum, kwiver::vital::optional<duration_t> const& duration)
+{
+  // If downstream process has marked itself as complete, do nothing
+  if (downstream_complete)
+  {
+    return true;
+  }
+
+  bool const have_space = ring_wait([this]()
+  {
+    return downstream_complete ||
+      (tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire) < capacity);
+  }, duration, blocked_push_ns);
+
+  if (!have_space)
+  {
+    return false;
+  }
+
+  if (downstream_complete)
+  {
+    return true;
+  }
+
+  size_t const t = tail.load(std::memory_order_relaxed);
+  clock_t::time_point const now = clock_t::now();
+
+  ring[t % capacity] = datum;
+  ring_times[t % capacity] = now;
+  tail.store(t + 1, std::memory_order_release);
+
+  record_push();
+
+  ring_wake();
+
+  return true;
+}
+
+// ------------------------------------------------------------------
+/*
+ * Only the downstream process takes data out of the edge, so the slot
+ * at the head can be read without synchronization once it is filled.
+ */
+kwiver::vital::optional<edge_datum_t>
+edge::priv
+::ring_pop(kwiver::vital::optional<duration_t> const& duration)
+{
+  bool const have_data = ring_wait([this]()
+  {
+    return (tail.load(std::memory_order_acquire) != head.load(std::memory_order_relaxed));
+  }, duration, blocked_pop_ns);
+
+  if (!have_data)
+  {
+    return kwiver::vital::nullopt;
+  }
+
+  size_t const h = head.load(std::memory_order_relaxed);
+  edge_datum_t& slot = ring[h % capacity];
+  edge_datum_t const dat = slot;
+
+  record_pop(ring_times[h % capacity], clock_t::now());
+
+  // Release the datum now rather than when the slot is reused.
+  slot = edge_datum_t();
+  head.store(h + 1, std::memory_order_release);
+
+  ring_wake();
+
+  return dat;
+}
+
+// ------------------------------------------------------------------
+edge_datum_t
+edge::priv
+::ring_peek(size_t idx) const
+{
+  ring_wait([this, idx]()
+  {
+    return (idx < tail.load(std::memory_order_acquire) - head.load(std::memory_order_relaxed));
+  }, kwiver::vital::nullopt, blocked_pop_ns);
+
+  return ring[(head.load(std::memory_order_relaxed) + idx) % capacity];
+}
+
+// ------------------------------------------------------------------
+void
+edge::priv
+::ring_clear()
+{
+  size_t h = head.load(std::memory_order_relaxed);
+  size_t const t = tail.load(std::memory_order_acquire);
+
+  for (; h != t; ++h)
+  {
+    ring[h % capacity] = edge_datum_t();
+  }
+
+  head.store(h, std::memory_order_release);
+
+  ring_wake();
+}
+
+// ------------------------------------------------------------------
+/*
+ * Spin for a short while since the other side of the edge is usually
+ * only a moment away from making progress, then park the thread.
+ */
+template <typename Predicate>
+bool
+edge::priv
+::ring_wait(Predicate const& pred, kwiver::vital::optional<duration_t> const& duration,
+            counter_t& blocked) const
+{
+  static size_t const spin_count = 64;
+  static size_t const yield_after = 16;
+
+  if (pred())
+  {
+    return true;
+  }
+
+  if (duration && (duration_t::zero() >= *duration))
+  {
+    return false;
+  }
+
+  wait_timer const timer(blocked, true);
+  clock_t::time_point const start = clock_t::now();
+
+  for (size_t i = 0; i < spin_count; ++i)
+  {
+    if (yield_after <= i)
+    {
+      boost::this_thread::yield();
+    }
+
+    if (pred())
+    {
+      return true;
+    }
+  }
+
+  boost::unique_lock<boost::mutex> lock(park_mutex);
+
+  ++parked;
+
+  // Pairs with the fence in ring_wake so that either the waker sees
+  // this thread parked or this thread sees the waker's update.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  bool ready = true;
+
+  try
+  {
+    if (duration)
+    {
+      duration_t const elapsed = clock_t::now() - start;
+
+      ready = (elapsed < *duration) &&
+        park_cond.wait_for(lock, *duration - elapsed, pred);
+      ready = ready || pred();
+    }
+    else
+    {
+      park_cond.wait(lock, pred);
+    }
+  }
+  catch (...)
+  {
+    // Waiting is an interruption point.
+    --parked;
+    throw;
+  }
+
+  --parked;
+
+  return ready;
+}
+
+// ------------------------------------------------------------------
+void
+edge::priv
+::ring_wake() const
+{
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  if (!parked.load(std::memory_order_relaxed))
+  {
+    return;
+  }
+
+  {
+    boost::unique_lock<boost::mutex> const lock(park_mutex);
+
+    (void)lock;
+  }
+
+  park_cond.notify_all();
+}
+
+// ------------------------------------------------------------------
+void
+edge::priv
+::record_push()
+{
+  push_count.fetch_add(1, std::memory_order_relaxed);
+
+  size_t const depth = size();
+  size_t mark = high_water_mark.load(std::memory_order_relaxed);
+
+  while ((mark < depth) &&
+         !high_water_mark.compare_exchange_weak(mark, depth, std::memory_order_relaxed))
+  {
+  }
+}
+
+// ------------------------------------------------------------------
+void
+edge::priv
+::record_pop(clock_t::time_point const& pushed, clock_t::time_point const& now)
+{
+  int64_t const latency = boost::chrono::duration_cast<boost::chrono::nanoseconds>(now - pushed).count();
+
+  pop_count.fetch_add(1, std::memory_order_relaxed);
+  latency_total_ns.fetch_add(latency, std::memory_order_relaxed);
+
+  int64_t longest = latency_max_ns.load(std::memory_order_relaxed);
+
+  while ((longest < latency) &&
+         !latency_max_ns.compare_exchange_weak(longest, latency, std::memory_order_relaxed))
+  {
+  }
+}
+
+// ------------------------------------------------------------------
+edge::priv::wait_timer
+::wait_timer(counter_t& total_, bool blocked_)
+  : total(total_)
+  , blocked(blocked_)
+  , start(blocked_ ? clock_t::now() : clock_t::time_point())
+{
+}
+
+// ------------------------------------------------------------------
+edge::priv::wait_timer
+::~wait_timer()
+{
+  if (blocked)
+  {
+    total.fetch_add(boost::chrono::duration_cast<boost::chrono::nanoseconds>(clock_t::now() - start).count(),
+                    std::memory_order_relaxed);
+  }
+}
+
 // ------------------------------------------------------------------
 template <typename T>
 bool
@@ -76,6 +76,57 @@ class SPROKIT_PIPELINE_EXPORT edge_datum_t
   stamp_t stamp;
 };
 
+// ------------------------------------------------------------------
+/**
+ * \class edge_statistics_t <sprokit/pipeline/edge.h>
+ *
+ * \brief A snapshot of the traffic through an \ref edge.
+ *
+ * Blocked times only include waits which actually had to wait; latency
+ * is measured from when a packet is pushed to when it is popped.
+ */
+class SPROKIT_PIPELINE_EXPORT edge_statistics_t
+{
+public:
+  /**
+   * \brief Constructor.
+   */
+  edge_statistics_t();
+
+  /**
+   * \brief Destructor.
+   */
+  ~edge_statistics_t();
+
+  typedef boost::chrono::nanoseconds duration_t;
+
+  /**
+   * \brief The mean time packets spent in the edge.
+   *
+   * \returns The mean latency, or zero if nothing has been popped.
+   */
+  duration_t mean_latency() const;
+
+  /// The number of packets in the edge.
+  size_t depth;
+  /// The capacity of the edge; \c 0 if the edge is unbounded.
+  size_t capacity;
+  /// The largest number of packets the edge has held.
+  size_t high_water_mark;
+  /// The number of packets which have been pushed into the edge.
+  size_t push_count;
+  /// The number of packets which have been popped from the edge.
+  size_t pop_count;
+  /// The total time upstream spent waiting for space.
+  duration_t blocked_push_time;
+  /// The total time downstream spent waiting for data.
+  duration_t blocked_pop_time;
+  /// The total time popped packets spent in the edge.
+  duration_t total_latency;
+  /// The longest time a popped packet spent in the edge.
+  duration_t max_latency;
+};
+
 /// A typedef for a multiple packets which go through an \ref edge.
 typedef std::vector< edge_datum_t > edge_data_t;
 /// A group of \link edge edges\endlink.
@@ -118,6 +169,29 @@ class SPROKIT_PIPELINE_EXPORT edge
    */
   bool makes_dependency() const;
 
+  /**
+   * \brief Query the maximum number of data items the edge can hold.
+   *
+   * \returns The capacity of the edge, or \c 0 if the edge is unbounded.
+   */
+  size_t capacity() const;
+
+  /**
+   * \brief Query whether pushing data into a full edge blocks.
+   *
+   * \returns True if pushing data waits for space, false if data is dropped.
+   */
+  bool is_blocking() const;
+
+  /**
+   * \brief Query the traffic statistics of the edge.
+   *
+   * This may be called from any thread while the pipeline is running.
+   *
+   * \returns A snapshot of the edge's statistics.
+   */
+  edge_statistics_t statistics() const;
+
   /**
    * \brief Query whether the edge has any data in it or not.
    *
@@ -227,6 +301,49 @@ class SPROKIT_PIPELINE_EXPORT edge
    */
   void pop_datum();
 
+  /**
+   * \brief Push a batch of data into the edge.
+   *
+   * The data are added under a single lock acquisition unless the edge
+   * fills up part way through, in which case the call blocks until the
+   * downstream process makes room, just as \ref push_datum does.
+   *
+   * \param data The data to put into the edge, in order.
+   */
+  void push_data( edge_data_t const& data );
+
+  /**
+   * \brief Extract a batch of data from the edge.
+   *
+   * \note This call blocks if \c has_data is \c false.
+   *
+   * Up to \p max_count packets are removed from the front of the edge.
+   * Control packets (anything other than \c datum::data) are never
+   * batched: one is only returned on its own, and a run of data stops
+   * before the next control packet so that it is seen by the next
+   * call.
+   *
+   * \throws datum_requested_after_complete Thrown if called after \ref mark_downstream_as_complete.
+   *
+   * \param max_count The largest number of packets to return.
+   *
+   * \returns The packets removed from the edge; never empty.
+   */
+  edge_data_t get_data( size_t max_count );
+
+  /**
+   * \brief Look at the data at the front of the edge.
+   *
+   * Unlike \ref peek_datum, this call does not block.
+   *
+   * \throws datum_requested_after_complete Thrown if called after \ref mark_downstream_as_complete.
+   *
+   * \param max_count The largest number of packets to return.
+   *
+   * \returns Up to \p max_count packets from the front of the edge.
+   */
+  edge_data_t peek_data( size_t max_count ) const;
+
   typedef boost::chrono::high_resolution_clock clock_t;
   typedef clock_t::duration duration_t;
 
@@ -313,6 +430,9 @@ class SPROKIT_PIPELINE_EXPORT edge
   /// Configuration for edge blocking behaviour
   static kwiver::vital::config_block_key_t const config_blocking;
 
+  /// Configuration to use a lock-free single-producer, single-consumer buffer.
+  static kwiver::vital::config_block_key_t const config_lock_free;
+
 private:
   class SPROKIT_PIPELINE_NO_EXPORT priv;
   std::unique_ptr< priv > d;
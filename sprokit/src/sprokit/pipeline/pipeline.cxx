@@ -982,6 +982,23 @@ ::edge_for_connection(process::name_t const& upstream_name,
   return edge_t();
 }
 
+// ------------------------------------------------------------------
+pipeline::edge_statistics_map_t
+pipeline
+::edge_statistics() const
+{
+  d->ensure_setup();
+
+  edge_statistics_map_t stats;
+
+  for (priv::edge_map_t::value_type const& edge_index : d->edge_map)
+  {
+    stats[d->connections[edge_index.first]] = edge_index.second->statistics();
+  }
+
+  return stats;
+}
+
 // ------------------------------------------------------------------
 edges_t
 pipeline
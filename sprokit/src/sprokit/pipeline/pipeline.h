@@ -12,6 +12,8 @@
 
 #include <vital/noncopyable.h>
 
+#include <map>
+
 /**
  * \file pipeline.h
  *
@@ -416,6 +418,21 @@ class SPROKIT_PIPELINE_EXPORT pipeline
                                process::name_t const& downstream_name,
                                process::port_t const& downstream_port) const;
 
+    /// A mapping of connections to the statistics of their edges.
+    typedef std::map<process::connection_t, edge_statistics_t> edge_statistics_map_t;
+
+    /**
+     * \brief Take a snapshot of the traffic through every edge.
+     *
+     * This may be called while the pipeline is running.
+     *
+     * \throws pipeline_not_setup_exception Thrown when the pipeline has not been setup.
+     * \throws pipeline_not_ready_exception Thrown when the pipeline has not been setup successfully.
+     *
+     * \returns The statistics of each edge, keyed by its connection.
+     */
+    edge_statistics_map_t edge_statistics() const;
+
     /**
      * \brief Find edges that are feeding data directly into a process.
      *
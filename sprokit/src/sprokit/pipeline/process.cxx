@@ -18,6 +18,7 @@
 #include <boost/thread/locks.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
+#include <algorithm>
 #include <map>
 #include <utility>
 #include <memory>
@@ -48,11 +49,13 @@ process::property_t const process::property_unsync_input = property_t("_unsync_i
 process::property_t const process::property_unsync_output = property_t("_unsync_output");
 process::property_t const process::property_instrumented = property_t("_instrumented");
 process::property_t const process::property_python = property_t("_python");
+process::property_t const process::property_batch_input = property_t("_batch_input");
 
 process::port_t const process::port_heartbeat = port_t("_heartbeat");
 
 kwiver::vital::config_block_key_t const process::config_name = kwiver::vital::config_block_key_t("_name");
 kwiver::vital::config_block_key_t const process::config_type = kwiver::vital::config_block_key_t("_type");
+kwiver::vital::config_block_key_t const process::config_batch_size = kwiver::vital::config_block_key_t("_batch_size");
 
 process::port_type_t const process::type_any = port_type_t("_any");
 process::port_type_t const process::type_none = port_type_t("_none");
@@ -124,6 +127,7 @@ class process::priv
     void connect_output_port(port_t const& port, edge_t const& edge);
 
     datum_t check_required_input();
+    size_t available_batch_size() const;
     void grab_from_input_edges();
     void push_to_output_edges(datum_t const& dat) const;
     bool required_outputs_done() const;
@@ -217,6 +221,11 @@ class process::priv
 
     stamp_t stamp_for_inputs;
 
+    // Largest batch the process consumes in a step and the size of the
+    // batch for the current step.
+    size_t max_batch_size;
+    size_t batch_size;
+
     mutex_t reconfigure_mut;
 
     kwiver::vital::logger_handle_t m_logger;
@@ -272,6 +281,11 @@ ::init()
 
   _init();
 
+  if (properties().count(property_batch_input))
+  {
+    d->max_batch_size = std::max<size_t>(1, d->conf->get_value<size_t>(config_batch_size, 1));
+  }
+
   d->initialized = true;
 }
 
@@ -356,10 +370,13 @@ ::step()
 
       (void)lock;
 
+      d->batch_size = d->available_batch_size();
+
       _step();
     }
 
     d->stamp_for_inputs = stamp_t();
+    d->batch_size = 1;
   }
 
   /// \todo Are there any post-_step actions?
@@ -1399,6 +1416,22 @@ ::count_output_port_edges(port_t const& port) const
   return edges.size();
 }
 
+// ------------------------------------------------------------------
+size_t
+process
+::input_batch_size() const
+{
+  return d->batch_size;
+}
+
+// ------------------------------------------------------------------
+size_t
+process
+::max_batch_size() const
+{
+  return d->max_batch_size;
+}
+
 // ------------------------------------------------------------------
 edge_datum_t
 process
@@ -1473,6 +1506,33 @@ ::grab_datum_from_port(port_t const& port) const
   return edat.datum;
 }
 
+// ------------------------------------------------------------------
+edge_data_t
+process
+::grab_batch_from_port(port_t const& port, size_t max_count) const
+{
+  if (!d->input_ports.count(port))
+  {
+    VITAL_THROW( no_such_port_exception,
+                 d->name, port);
+  }
+
+  priv::input_edge_map_t::const_iterator const e = d->input_edges.find(port);
+
+  if (e == d->input_edges.end())
+  {
+    static std::string const reason = "Data was requested from the port";
+
+    VITAL_THROW( missing_connection_exception,
+                 d->name, port, reason);
+  }
+
+  priv::input_port_info_t const& info = *e->second;
+  edge_t const& edge = info.edge;
+
+  return edge->get_data(max_count);
+}
+
 // ------------------------------------------------------------------
 void
 process
@@ -1511,6 +1571,67 @@ ::push_to_port(port_t const& port, edge_datum_t const& dat) const
   }
 }
 
+// ------------------------------------------------------------------
+void
+process
+::push_batch_to_port(port_t const& port, std::vector<datum_t> const& data) const
+{
+  if (!d->output_ports.count(port))
+  {
+    VITAL_THROW( no_such_port_exception,
+                 d->name, port);
+  }
+
+  edge_data_t batch;
+  edges_t edges;
+
+  {
+    priv::shared_lock_t lock(d->output_edges_mut);
+
+    (void)lock;
+
+    priv::output_edge_map_t::iterator const e = d->output_edges.find(port);
+
+    if (e == d->output_edges.end())
+    {
+      return;
+    }
+
+    priv::mutex_t& mut = d->output_mutexes[port];
+
+    priv::unique_lock_t const port_lock(mut);
+
+    (void)port_lock;
+
+    priv::output_port_info_t& info = *e->second;
+    stamp_t& port_stamp = info.stamp;
+
+    if (!port_stamp)
+    {
+      static std::string const reason = "The stamp for an output port was not initialized in ";
+
+      throw std::runtime_error(reason + this->name());
+    }
+
+    batch.reserve(data.size());
+
+    for (datum_t const& dat : data)
+    {
+      batch.push_back(edge_datum_t(dat, port_stamp));
+      port_stamp = stamp::incremented_stamp(port_stamp);
+    }
+
+    edges = info.edges;
+  }
+
+  // Push without holding the port lock since a full edge blocks until
+  // the downstream process makes room, and it may need the lock first.
+  for (edge_t const& edge : edges)
+  {
+    edge->push_data(batch);
+  }
+}
+
 // ------------------------------------------------------------------
 void
 process
@@ -1895,6 +2016,8 @@ ::priv(process* proc,kwiver::vital::config_block_sptr const& c)
   , is_complete(false)
   , check_input_level(check_valid)
   , stamp_for_inputs()
+  , max_batch_size(1)
+  , batch_size(1)
   , m_logger( kwiver::vital::get_logger( "sprokit.process" ))
 {
 }
@@ -2120,6 +2243,47 @@ ::check_required_input()
   return datum_t();
 }
 
+// ------------------------------------------------------------------
+/*
+ * The batch is limited by the shortest run of data packets across the
+ * required inputs so that every port gives up the same number of
+ * packets and the inputs stay synchronized.
+ */
+size_t
+process::priv
+::available_batch_size() const
+{
+  if (max_batch_size <= 1)
+  {
+    return 1;
+  }
+
+  size_t count = max_batch_size;
+
+  for (port_t const& port : required_inputs)
+  {
+    input_edge_map_t::const_iterator const i = input_edges.find(port);
+
+    if (i == input_edges.end())
+    {
+      continue;
+    }
+
+    edge_data_t const data = i->second->edge->peek_data(count);
+
+    size_t run = 0;
+
+    while ((run < data.size()) && (data[run].datum->type() == datum::data))
+    {
+      ++run;
+    }
+
+    count = std::min(count, run);
+  }
+
+  return std::max<size_t>(1, count);
+}
+
 // ------------------------------------------------------------------
 void
 process::priv
@@ -340,6 +340,14 @@ class SPROKIT_PIPELINE_EXPORT process
      */
     virtual properties_t properties() const;
 
+    /**
+     * \brief Query for the largest batch a step of the process consumes.
+     *
+     * \returns The configured \key _batch_size for processes with the
+     * \ref property_batch_input property, and \c 1 otherwise.
+     */
+    size_t max_batch_size() const;
+
     /**
      * \brief Connect an edge to an input port on the process.
      *
@@ -550,6 +558,9 @@ class SPROKIT_PIPELINE_EXPORT process
     /// Indicates the process is written in Python
     static property_t const property_python;
 
+    /// A property which indicates that the process can consume a batch of inputs in one step.
+    static property_t const property_batch_input;
+
     /// The name of the heartbeat port.
     static port_t const port_heartbeat;
 
@@ -559,6 +570,9 @@ class SPROKIT_PIPELINE_EXPORT process
     /// The name of the configuration value for the type.
     static kwiver::vital::config_block_key_t const config_type;
 
+    /// The name of the configuration value for the largest batch a step consumes.
+    static kwiver::vital::config_block_key_t const config_batch_size;
+
     /*
      * Port types.
      */
@@ -1111,6 +1125,20 @@ class SPROKIT_PIPELINE_EXPORT process
      */
     size_t count_output_port_edges(port_t const& port) const;
 
+    /**
+     * \brief Get the number of packets the current step should consume.
+     *
+     * For processes with the \ref property_batch_input property, this
+     * is the number of data packets waiting on every connected required
+     * input port, limited by the \key _batch_size configuration value.
+     * Such a process without required inputs gets the full configured
+     * batch size. It is only meaningful from within \c _step(), and is
+     * always \c 1 for other processes.
+     *
+     * \returns The number of packets to grab from each required port.
+     */
+    size_t input_batch_size() const;
+
     /**
      * \brief Peek at an edge datum packet from a port.
      *
@@ -1180,6 +1208,28 @@ class SPROKIT_PIPELINE_EXPORT process
      */
     datum_t grab_datum_from_port(port_t const& port) const;
 
+    /**
+     * \brief Grab a batch of edge datum packets from a port.
+     *
+     * This method removes up to \p max_count packets from the edge
+     * queue connected to this port while only locking the edge once. If
+     * no data is available from the port, this call blocks until data
+     * becomes available. Control packets are never part of a batch of
+     * data; see edge::get_data for details.
+     *
+     * Processes with the \ref property_batch_input property should pass
+     * input_batch_size() so that all required ports stay synchronized.
+     *
+     * \param port The port to get data from.
+     * \param max_count The largest number of packets to grab.
+     *
+     * \throws no_such_port_exception if the named port does not exist.
+     * \throws missing_connection_exception if port not connected.
+     *
+     * \returns The packets grabbed from the port.
+     */
+    edge_data_t grab_batch_from_port(port_t const& port, size_t max_count) const;
+
     /**
      * \brief Grab a datum from a port as a certain type.
      *
@@ -1257,6 +1307,17 @@ class SPROKIT_PIPELINE_EXPORT process
      */
     void push_datum_to_port(port_t const& port, datum_t const& dat) const;
 
+    /**
+     * \brief Output a batch of datum packets on a port.
+     *
+     * Each datum is given the next stamp for the port, and the batch is
+     * pushed into each connected edge with a single lock acquisition.
+     *
+     * \param port The port to push to.
+     * \param data The data to push, in order.
+     */
+    void push_batch_to_port(port_t const& port, std::vector<datum_t> const& data) const;
+
     /**
      * \brief Output a result on a port.
      *
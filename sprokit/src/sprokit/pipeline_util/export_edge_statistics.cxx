@@ -0,0 +1,148 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include "export_edge_statistics.h"
+
+#include <ostream>
+#include <string>
+
+/**
+ * \file export_edge_statistics.cxx
+ *
+ * \brief Implementation of edge statistics exporting.
+ */
+
+namespace sprokit {
+
+namespace {
+
+// ------------------------------------------------------------------
+double
+to_ms(edge_statistics_t::duration_t const& d)
+{
+  return static_cast<double>(d.count()) / 1e6;
+}
+
+// ------------------------------------------------------------------
+std::string
+connection_name(process::connection_t const& connection)
+{
+  return connection.first.first + "." + connection.first.second + "->" +
+    connection.second.first + "." + connection.second.second;
+}
+
+// ------------------------------------------------------------------
+// Process and port names are restricted, but escape anyway so the
+// output is always valid JSON.
+std::string
+json_escape(std::string const& str)
+{
+  static char const hex[] = "0123456789abcdef";
+
+  std::string escaped;
+
+  for (char const c : str)
+  {
+    unsigned char const u = static_cast<unsigned char>(c);
+
+    if ((c == '"') || (c == '\\'))
+    {
+      escaped += '\\';
+      escaped += c;
+    }
+    else if (u < 0x20)
+    {
+      escaped += "\\u00";
+      escaped += hex[u >> 4];
+      escaped += hex[u & 0xf];
+    }
+    else
+    {
+      escaped += c;
+    }
+  }
+
+  return escaped;
+}
+
+}
+
+// ------------------------------------------------------------------
+void
+export_edge_statistics_csv(std::ostream& ostr,
+                           pipeline::edge_statistics_map_t const& stats,
+                           double elapsed,
+                           bool header)
+{
+  if (header)
+  {
+    ostr << "time_s,edge,depth,capacity,high_water_mark,push_count,pop_count,"
+            "blocked_push_ms,blocked_pop_ms,mean_latency_ms,max_latency_ms\n";
+  }
+
+  for (pipeline::edge_statistics_map_t::value_type const& entry : stats)
+  {
+    edge_statistics_t const& s = entry.second;
+
+    ostr << elapsed << ","
+         << connection_name(entry.first) << ","
+         << s.depth << ","
+         << s.capacity << ","
+         << s.high_water_mark << ","
+         << s.push_count << ","
+         << s.pop_count << ","
+         << to_ms(s.blocked_push_time) << ","
+         << to_ms(s.blocked_pop_time) << ","
+         << to_ms(s.mean_latency()) << ","
+         << to_ms(s.max_latency) << "\n";
+  }
+
+  ostr.flush();
+}
+
+// ------------------------------------------------------------------
+void
+export_edge_statistics_json(std::ostream& ostr,
+                            pipeline::edge_statistics_map_t const& stats,
+                            double elapsed)
+{
+  ostr << "{\"time_s\": " << elapsed << ", \"edges\": [";
+
+  bool first = true;
+
+  for (pipeline::edge_statistics_map_t::value_type const& entry : stats)
+  {
+    process::port_addr_t const& up = entry.first.first;
+    process::port_addr_t const& down = entry.first.second;
+    edge_statistics_t const& s = entry.second;
+
+    if (!first)
+    {
+      ostr << ", ";
+    }
+
+    first = false;
+
+    ostr << "{"
+         << "\"upstream\": \"" << json_escape(up.first) << "\", "
+         << "\"upstream_port\": \"" << json_escape(up.second) << "\", "
+         << "\"downstream\": \"" << json_escape(down.first) << "\", "
+         << "\"downstream_port\": \"" << json_escape(down.second) << "\", "
+         << "\"depth\": " << s.depth << ", "
+         << "\"capacity\": " << s.capacity << ", "
+         << "\"high_water_mark\": " << s.high_water_mark << ", "
+         << "\"push_count\": " << s.push_count << ", "
+         << "\"pop_count\": " << s.pop_count << ", "
+         << "\"blocked_push_ms\": " << to_ms(s.blocked_push_time) << ", "
+         << "\"blocked_pop_ms\": " << to_ms(s.blocked_pop_time) << ", "
+         << "\"mean_latency_ms\": " << to_ms(s.mean_latency()) << ", "
+         << "\"max_latency_ms\": " << to_ms(s.max_latency)
+         << "}";
+  }
+
+  ostr << "]}\n";
+  ostr.flush();
+}
+
+}
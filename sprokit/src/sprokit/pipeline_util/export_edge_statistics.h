@@ -0,0 +1,56 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#ifndef SPROKIT_PIPELINE_UTIL_EXPORT_EDGE_STATISTICS_H
+#define SPROKIT_PIPELINE_UTIL_EXPORT_EDGE_STATISTICS_H
+
+#include<sprokit/pipeline_util/sprokit_pipeline_util_export.h>
+
+#include <sprokit/pipeline/pipeline.h>
+
+#include <iosfwd>
+
+/**
+ * \file export_edge_statistics.h
+ *
+ * \brief Functions to export snapshots of pipeline edge statistics.
+ */
+
+namespace sprokit
+{
+
+/**
+ * \brief Exports edge statistics as CSV.
+ *
+ * Writes one row per edge. Successive snapshots may be written to the
+ * same stream to build a time series; only the first should include
+ * the header.
+ *
+ * \param ostr The stream to export to.
+ * \param stats The statistics to export.
+ * \param elapsed The time since the pipeline started, in seconds.
+ * \param header Whether to write the column names first.
+ */
+SPROKIT_PIPELINE_UTIL_EXPORT void export_edge_statistics_csv(std::ostream& ostr,
+                                                             pipeline::edge_statistics_map_t const& stats,
+                                                             double elapsed,
+                                                             bool header);
+
+/**
+ * \brief Exports edge statistics as JSON.
+ *
+ * Writes the snapshot as a single line holding one JSON object so
+ * that successive snapshots form a JSON lines file.
+ *
+ * \param ostr The stream to export to.
+ * \param stats The statistics to export.
+ * \param elapsed The time since the pipeline started, in seconds.
+ */
+SPROKIT_PIPELINE_UTIL_EXPORT void export_edge_statistics_json(std::ostream& ostr,
+                                                              pipeline::edge_statistics_map_t const& stats,
+                                                              double elapsed);
+
+}
+
+#endif // SPROKIT_PIPELINE_UTIL_EXPORT_EDGE_STATISTICS_H
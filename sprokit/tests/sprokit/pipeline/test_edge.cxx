@@ -567,6 +567,340 @@ IMPLEMENT_TEST(try_get_datum)
   check_time(duration, WAIT_DURATION, "trying to get a datum from an edge");
 }
 
+static sprokit::edge_t create_lock_free_edge(size_t capacity);
+
+IMPLEMENT_TEST(lock_free_push_get)
+{
+  sprokit::edge_t const edge = create_lock_free_edge(4);
+
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+
+  sprokit::datum_t const dat1 = sprokit::datum::empty_datum();
+  sprokit::datum_t const dat2 = sprokit::datum::complete_datum();
+  sprokit::stamp_t const stamp1 = sprokit::stamp::new_stamp(inc);
+  sprokit::stamp_t const stamp2 = sprokit::stamp::incremented_stamp(stamp1);
+
+  sprokit::edge_datum_t const edat1 = sprokit::edge_datum_t(dat1, stamp1);
+  sprokit::edge_datum_t const edat2 = sprokit::edge_datum_t(dat2, stamp2);
+
+  // Wrap around the ring a few times.
+  for (size_t i = 0; i < 10; ++i)
+  {
+    edge->push_datum(edat1);
+    edge->push_datum(edat2);
+
+    if (edge->datum_count() != 2)
+    {
+      TEST_ERROR("A lock-free edge with two pushed data does not have a count of two");
+    }
+
+    if (edge->peek_datum(1).datum != dat2)
+    {
+      TEST_ERROR("A lock-free edge returned the wrong datum on an indexed peek");
+    }
+
+    if (edge->get_datum().datum != dat1)
+    {
+      TEST_ERROR("A lock-free edge did not return data in order");
+    }
+
+    edge->pop_datum();
+
+    if (edge->has_data())
+    {
+      TEST_ERROR("A lock-free edge did not remove data on a get and a pop");
+    }
+  }
+}
+
+IMPLEMENT_TEST(lock_free_capacity)
+{
+  sprokit::edge_t const edge = create_lock_free_edge(1);
+
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+
+  sprokit::datum_t const dat1 = sprokit::datum::empty_datum();
+  sprokit::datum_t const dat2 = sprokit::datum::complete_datum();
+  sprokit::stamp_t const stamp1 = sprokit::stamp::new_stamp(inc);
+  sprokit::stamp_t const stamp2 = sprokit::stamp::incremented_stamp(stamp1);
+
+  sprokit::edge_datum_t const edat1 = sprokit::edge_datum_t(dat1, stamp1);
+  sprokit::edge_datum_t const edat2 = sprokit::edge_datum_t(dat2, stamp2);
+
+  // Fill the edge.
+  edge->push_datum(edat1);
+
+  if (!edge->full_of_data())
+  {
+    TEST_ERROR("A lock-free edge at capacity is not full");
+  }
+
+  boost::thread thread = boost::thread(std::bind(&push_datum, edge, edat2));
+
+  // Give the other thread some time.
+  boost::this_thread::sleep_for(WAIT_DURATION);
+
+  // Make sure the edge still is at capacity.
+  if (edge->datum_count() != 1)
+  {
+    TEST_ERROR("A datum was pushed into a full lock-free edge");
+  }
+
+  // Let the other thread go (it should have been parked).
+  edge->get_datum();
+
+  // Make sure the other thread completes.
+  thread.join();
+
+  if (edge->datum_count() != 1)
+  {
+    TEST_ERROR("The other thread did not push into the lock-free edge");
+  }
+}
+
+IMPLEMENT_TEST(lock_free_try_get_datum)
+{
+  sprokit::edge_t const edge = create_lock_free_edge(1);
+
+  time_point_t const start = time_clock_t::now();
+
+  // This should be blocking.
+  kwiver::vital::optional<sprokit::edge_datum_t> const opt_datum = edge->try_get_datum(WAIT_DURATION);
+
+  time_point_t const end = time_clock_t::now();
+
+  if (opt_datum)
+  {
+    TEST_ERROR("Returned a datum from an empty lock-free edge");
+  }
+
+  duration_t const duration = end - start;
+
+  check_time(duration, WAIT_DURATION, "trying to get a datum from a lock-free edge");
+}
+
+IMPLEMENT_TEST(lock_free_complete)
+{
+  sprokit::edge_t const edge = create_lock_free_edge(2);
+
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+
+  sprokit::datum_t const dat = sprokit::datum::complete_datum();
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(inc);
+
+  sprokit::edge_datum_t const edat = sprokit::edge_datum_t(dat, stamp);
+
+  edge->push_datum(edat);
+  edge->push_datum(edat);
+
+  edge->mark_downstream_as_complete();
+
+  if (edge->datum_count())
+  {
+    TEST_ERROR("A complete lock-free edge did not flush data");
+  }
+
+  // The edge is at capacity, so this would block if it were not ignored.
+  edge->push_datum(edat);
+  edge->push_datum(edat);
+  edge->push_datum(edat);
+
+  if (edge->datum_count())
+  {
+    TEST_ERROR("A complete lock-free edge accepted data");
+  }
+
+  EXPECT_EXCEPTION(sprokit::datum_requested_after_complete,
+                   edge->get_datum(),
+                   "getting data from a complete lock-free edge");
+}
+
+static void push_data(sprokit::edge_t edge, size_t count);
+
+IMPLEMENT_TEST(lock_free_threaded)
+{
+  static size_t const count = 10000;
+
+  sprokit::edge_t const edge = create_lock_free_edge(2);
+
+  boost::thread thread = boost::thread(std::bind(&push_data, edge, count));
+
+  sprokit::stamp_t expect_stamp;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    sprokit::edge_datum_t const edat = edge->get_datum();
+
+    if (expect_stamp && (*edat.stamp != *expect_stamp))
+    {
+      TEST_ERROR("A lock-free edge did not return data in order");
+      break;
+    }
+
+    expect_stamp = sprokit::stamp::incremented_stamp(edat.stamp);
+  }
+
+  thread.join();
+
+  if (edge->has_data())
+  {
+    TEST_ERROR("A lock-free edge has more data than was pushed");
+  }
+}
+
+IMPLEMENT_TEST(lock_free_unbounded)
+{
+  sprokit::edge_t const edge = create_lock_free_edge(0);
+
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+
+  sprokit::datum_t const dat = sprokit::datum::empty_datum();
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(inc);
+
+  sprokit::edge_datum_t const edat = sprokit::edge_datum_t(dat, stamp);
+
+  // Without a capacity, the edge falls back to the unbounded queue.
+  for (size_t i = 0; i < 100; ++i)
+  {
+    edge->push_datum(edat);
+  }
+
+  if (edge->datum_count() != 100)
+  {
+    TEST_ERROR("An unbounded lock-free edge did not accept all data");
+  }
+}
+
+static void check_batches(sprokit::edge_t const& edge, char const* const kind);
+
+IMPLEMENT_TEST(batch_push_get)
+{
+  kwiver::vital::config_block_sptr const config = kwiver::vital::config_block::empty_config();
+
+  sprokit::edge_t const edge = std::make_shared<sprokit::edge>(config);
+
+  check_batches(edge, "an edge");
+}
+
+IMPLEMENT_TEST(lock_free_batch_push_get)
+{
+  check_batches(create_lock_free_edge(10), "a lock-free edge");
+}
+
+IMPLEMENT_TEST(batch_over_capacity)
+{
+  kwiver::vital::config_block_sptr const config = kwiver::vital::config_block::empty_config();
+
+  config->set_value(sprokit::edge::config_capacity, 2);
+
+  sprokit::edge_t const edge = std::make_shared<sprokit::edge>(config);
+
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+
+  sprokit::datum_t const dat = sprokit::datum::new_datum(1);
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(inc);
+
+  sprokit::edge_data_t const batch(5, sprokit::edge_datum_t(dat, stamp));
+
+  boost::thread thread = boost::thread(std::bind(&sprokit::edge::push_data, edge.get(), batch));
+
+  size_t count = 0;
+
+  while (count < batch.size())
+  {
+    count += edge->get_data(batch.size()).size();
+  }
+
+  thread.join();
+
+  if (edge->has_data())
+  {
+    TEST_ERROR("A batch larger than the capacity of an edge was duplicated");
+  }
+}
+
+static void check_statistics(sprokit::edge_t const& edge, char const* const kind);
+
+IMPLEMENT_TEST(statistics)
+{
+  kwiver::vital::config_block_sptr const config = kwiver::vital::config_block::empty_config();
+
+  config->set_value(sprokit::edge::config_capacity, 10);
+
+  sprokit::edge_t const edge = std::make_shared<sprokit::edge>(config);
+
+  check_statistics(edge, "an edge");
+}
+
+IMPLEMENT_TEST(lock_free_statistics)
+{
+  check_statistics(create_lock_free_edge(10), "a lock-free edge");
+}
+
+IMPLEMENT_TEST(statistics_blocked_push)
+{
+  kwiver::vital::config_block_sptr const config = kwiver::vital::config_block::empty_config();
+
+  config->set_value(sprokit::edge::config_capacity, 1);
+
+  sprokit::edge_t const edge = std::make_shared<sprokit::edge>(config);
+
+  boost::thread thread = boost::thread(std::bind(&push_data, edge, 2));
+
+  // Give the pusher time to block on the full edge.
+  boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
+
+  edge->pop_datum();
+
+  thread.join();
+
+  edge->pop_datum();
+
+  sprokit::edge_statistics_t const stats = edge->statistics();
+
+  if (stats.blocked_push_time < boost::chrono::milliseconds(50))
+  {
+    TEST_ERROR("An edge did not record the time spent blocked on a full edge");
+  }
+
+  if (stats.high_water_mark != 1)
+  {
+    TEST_ERROR("The high water mark of an edge exceeded its capacity");
+  }
+
+  if (stats.max_latency < boost::chrono::milliseconds(50))
+  {
+    TEST_ERROR("An edge did not record the latency of a datum left in it");
+  }
+}
+
+sprokit::edge_t
+create_lock_free_edge(size_t capacity)
+{
+  kwiver::vital::config_block_sptr const config = kwiver::vital::config_block::empty_config();
+
+  config->set_value(sprokit::edge::config_capacity, capacity);
+  config->set_value(sprokit::edge::config_lock_free, true);
+
+  return std::make_shared<sprokit::edge>(config);
+}
+
+void
+push_data(sprokit::edge_t edge, size_t count)
+{
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+
+  sprokit::datum_t const dat = sprokit::datum::empty_datum();
+  sprokit::stamp_t stamp = sprokit::stamp::new_stamp(inc);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    edge->push_datum(sprokit::edge_datum_t(dat, stamp));
+
+    stamp = sprokit::stamp::incremented_stamp(stamp);
+  }
+}
+
 void
 push_datum(sprokit::edge_t edge, sprokit::edge_datum_t edat)
 {
@@ -603,3 +937,133 @@ check_time(duration_t const& actual, duration_t const& expected, char const* con
                << actual << " instead");
   }
 }
+
+void
+check_batches(sprokit::edge_t const& edge, char const* const kind)
+{
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+
+  sprokit::datum_t const dat = sprokit::datum::new_datum(1);
+  sprokit::datum_t const flush = sprokit::datum::flush_datum();
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(inc);
+
+  sprokit::edge_datum_t const edat = sprokit::edge_datum_t(dat, stamp);
+  sprokit::edge_datum_t const fdat = sprokit::edge_datum_t(flush, stamp);
+
+  sprokit::edge_data_t batch(4, edat);
+  batch.push_back(fdat);
+  batch.push_back(edat);
+
+  edge->push_data(batch);
+
+  if (edge->datum_count() != batch.size())
+  {
+    TEST_ERROR("Pushing a batch into " << kind << " did not add every datum");
+  }
+
+  if (edge->peek_data(3).size() != 3)
+  {
+    TEST_ERROR("Peeking at a batch from " << kind << " did not return the requested count");
+  }
+
+  if (edge->datum_count() != batch.size())
+  {
+    TEST_ERROR("Peeking at a batch from " << kind << " removed data");
+  }
+
+  if (edge->get_data(3).size() != 3)
+  {
+    TEST_ERROR("Getting a batch from " << kind << " did not return the requested count");
+  }
+
+  if (edge->get_data(10).size() != 1)
+  {
+    TEST_ERROR("Getting a batch from " << kind << " did not stop at a control datum");
+  }
+
+  sprokit::edge_data_t const control = edge->get_data(10);
+
+  if ((control.size() != 1) || (control[0].datum != flush))
+  {
+    TEST_ERROR("Getting a batch from " << kind << " did not return a control datum on its own");
+  }
+
+  if (edge->get_data(10).size() != 1)
+  {
+    TEST_ERROR("Getting a batch from " << kind << " did not return the remaining data");
+  }
+
+  if (edge->has_data())
+  {
+    TEST_ERROR("Getting batches from " << kind << " did not empty it");
+  }
+}
+
+void
+check_statistics(sprokit::edge_t const& edge, char const* const kind)
+{
+  sprokit::edge_statistics_t stats = edge->statistics();
+
+  if (stats.push_count || stats.pop_count || stats.high_water_mark)
+  {
+    TEST_ERROR("A new " << kind << " has non-zero statistics");
+  }
+
+  if (stats.capacity != 10)
+  {
+    TEST_ERROR("The statistics of " << kind << " has the wrong capacity");
+  }
+
+  push_data(edge, 3);
+  edge->pop_datum();
+  push_data(edge, 2);
+
+  stats = edge->statistics();
+
+  if (stats.depth != 4)
+  {
+    TEST_ERROR("The statistics of " << kind << " has the wrong depth");
+  }
+
+  if (stats.high_water_mark != 4)
+  {
+    TEST_ERROR("The statistics of " << kind << " has the wrong high water mark");
+  }
+
+  if (stats.push_count != 5)
+  {
+    TEST_ERROR("The statistics of " << kind << " has the wrong push count");
+  }
+
+  if (stats.pop_count != 1)
+  {
+    TEST_ERROR("The statistics of " << kind << " has the wrong pop count");
+  }
+
+  while (edge->has_data())
+  {
+    edge->get_data(10);
+  }
+
+  stats = edge->statistics();
+
+  if (stats.pop_count != 5)
+  {
+    TEST_ERROR("The statistics of " << kind << " did not count a batched pop");
+  }
+
+  if (stats.depth != 0)
+  {
+    TEST_ERROR("The statistics of " << kind << " has data after being drained");
+  }
+
+  if (stats.max_latency < stats.mean_latency())
+  {
+    TEST_ERROR("The statistics of " << kind << " has a mean latency above the maximum");
+  }
+
+  if (stats.blocked_push_time != sprokit::edge_statistics_t::duration_t::zero())
+  {
+    TEST_ERROR("The statistics of " << kind << " recorded blocking on pushes which had room");
+  }
+}
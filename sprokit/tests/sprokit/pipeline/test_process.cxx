@@ -14,6 +14,8 @@
 #include <sprokit/pipeline/process_factory.h>
 
 #include <memory>
+#include <thread>
+#include <vector>
 
 #define TEST_ARGS ()
 
@@ -64,6 +66,20 @@ class remove_ports_process
     static port_type_t const output_port;
 };
 
+// ------------------------------------------------------------------
+class batch_output_process
+  : public sprokit::process
+{
+  public:
+    batch_output_process(kwiver::vital::config_block_sptr const& config);
+    ~batch_output_process();
+
+    void push_batch(size_t count);
+    size_t output_edge_count() const;
+
+    static port_t const output_port;
+};
+
 // ------------------------------------------------------------------
 class null_config_process
   : public sprokit::process
@@ -895,6 +911,56 @@ IMPLEMENT_TEST(reconfigure_extra_parameters)
   pipeline->reconfigure(new_conf);
 }
 
+// ------------------------------------------------------------------
+IMPLEMENT_TEST(push_batch_full_edge)
+{
+  const auto up_conf = kwiver::vital::config_block::empty_config();
+
+  up_conf->set_value(sprokit::process::config_name, "up");
+
+  auto const up = std::make_shared<batch_output_process>(up_conf);
+  sprokit::process_t const down = create_process(sprokit::process::type_t("sink"),
+                                                 sprokit::process::name_t("down"));
+
+  const auto conf = kwiver::vital::config_block::empty_config();
+
+  conf->set_value("_edge" + kwiver::vital::config_block::block_sep() +
+                  sprokit::edge::config_capacity, "1");
+
+  sprokit::pipeline_t const pipeline = std::make_shared<sprokit::pipeline>(conf);
+
+  pipeline->add_process(up);
+  pipeline->add_process(down);
+  pipeline->connect(up->name(), batch_output_process::output_port,
+                    down->name(), sprokit::process::port_t("sink"));
+  pipeline->setup_pipeline();
+
+  sprokit::edge_t const edge = pipeline->output_edges_for_port(up->name(), batch_output_process::output_port)[0];
+
+  static size_t const count = 3;
+
+  // The batch does not fit, so the push blocks until it is read.
+  std::thread pusher(&batch_output_process::push_batch, up.get(), count);
+
+  while (!edge->full_of_data())
+  {
+    std::this_thread::yield();
+  }
+
+  // This needs the port lock, which must not be held by the blocked push.
+  if (up->output_edge_count() != 1)
+  {
+    TEST_ERROR("The output port did not report its edge");
+  }
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    edge->get_datum();
+  }
+
+  pusher.join();
+}
+
 // ==================================================================
 sprokit::process_t
 create_process(sprokit::process::type_t const& type,
@@ -917,6 +983,42 @@ create_edge()
   return edge;
 }
 
+// ------------------------------------------------------------------
+batch_output_process
+::batch_output_process(kwiver::vital::config_block_sptr const& config)
+  : sprokit::process(config)
+{
+  declare_output_port(
+    output_port,
+    port_type_t("type"),
+    port_flags_t(),
+    port_description_t("output port"));
+}
+
+// ------------------------------------------------------------------
+batch_output_process
+::~batch_output_process()
+{
+}
+
+// ------------------------------------------------------------------
+void
+batch_output_process
+::push_batch(size_t count)
+{
+  push_batch_to_port(output_port, std::vector<sprokit::datum_t>(count, sprokit::datum::empty_datum()));
+}
+
+// ------------------------------------------------------------------
+size_t
+batch_output_process
+::output_edge_count() const
+{
+  return count_output_port_edges(output_port);
+}
+
+sprokit::process::port_t const batch_output_process::output_port = sprokit::process::port_t("output");
+
 // ------------------------------------------------------------------
 null_config_process
 ::null_config_process(kwiver::vital::config_block_sptr const& /*config*/)
@@ -0,0 +1,194 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#include <test_common.h>
+
+#include <sprokit/pipeline_util/export_edge_statistics.h>
+
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/pipeline.h>
+#include <sprokit/pipeline/process.h>
+
+#include <vital/internal/cereal/external/rapidjson/document.h>
+
+#include <sstream>
+#include <string>
+
+#define TEST_ARGS ()
+
+DECLARE_TEST_MAP();
+
+int
+main(int argc, char* argv[])
+{
+  CHECK_ARGS(1);
+
+  testname_t const testname = argv[1];
+
+  RUN_TEST(testname);
+}
+
+static sprokit::pipeline::edge_statistics_map_t create_statistics(sprokit::process::name_t const& upstream);
+
+// Names with characters which must be escaped in JSON.
+static sprokit::process::name_t const upstream_name = sprokit::process::name_t("up\"stream\\\n\t\x01");
+static sprokit::process::port_t const upstream_port = sprokit::process::port_t("out\x1f");
+static sprokit::process::name_t const downstream_name = sprokit::process::name_t("downstream");
+static sprokit::process::port_t const downstream_port = sprokit::process::port_t("in");
+
+// ------------------------------------------------------------------
+IMPLEMENT_TEST(csv)
+{
+  sprokit::pipeline::edge_statistics_map_t const stats = create_statistics("upstream");
+
+  std::ostringstream sstr;
+
+  sprokit::export_edge_statistics_csv(sstr, stats, 1.5, true);
+  sprokit::export_edge_statistics_csv(sstr, stats, 2.5, false);
+
+  std::istringstream istr(sstr.str());
+  std::string line;
+  size_t count = 0;
+
+  std::getline(istr, line);
+
+  if (line.compare(0, 12, "time_s,edge,"))
+  {
+    TEST_ERROR("The CSV export did not start with the header: " << line);
+  }
+
+  while (std::getline(istr, line))
+  {
+    if (line.find(",upstream.out\x1f->downstream.in,2,8,5,12,10,3,0,2,7") == std::string::npos)
+    {
+      TEST_ERROR("Unexpected CSV row: " << line);
+    }
+
+    ++count;
+  }
+
+  if (count != 2)
+  {
+    TEST_ERROR("Expected a row per snapshot, found " << count);
+  }
+}
+
+// ------------------------------------------------------------------
+IMPLEMENT_TEST(json)
+{
+  sprokit::pipeline::edge_statistics_map_t const stats = create_statistics(upstream_name);
+
+  std::ostringstream sstr;
+
+  sprokit::export_edge_statistics_json(sstr, stats, 1.5);
+
+  std::string const output = sstr.str();
+
+  if (output.empty() || (output.find('\n') != output.size() - 1))
+  {
+    TEST_ERROR("The JSON export is not a single line");
+  }
+
+  CEREAL_RAPIDJSON_NAMESPACE::Document doc;
+
+  doc.Parse(output.c_str());
+
+  if (doc.HasParseError())
+  {
+    TEST_ERROR("The JSON export could not be parsed: " << output);
+
+    return;
+  }
+
+  if (!doc.IsObject() || !doc.HasMember("time_s") || (doc["time_s"].GetDouble() != 1.5))
+  {
+    TEST_ERROR("The JSON export has the wrong time");
+  }
+
+  if (!doc.HasMember("edges") || !doc["edges"].IsArray() || (doc["edges"].Size() != 1))
+  {
+    TEST_ERROR("The JSON export does not hold one edge");
+
+    return;
+  }
+
+  CEREAL_RAPIDJSON_NAMESPACE::Value const& e = doc["edges"][0];
+
+  if (std::string(e["upstream"].GetString(), e["upstream"].GetStringLength()) != upstream_name)
+  {
+    TEST_ERROR("The upstream process name did not survive escaping");
+  }
+
+  if (std::string(e["upstream_port"].GetString()) != upstream_port)
+  {
+    TEST_ERROR("The upstream port name did not survive escaping");
+  }
+
+  if (std::string(e["downstream"].GetString()) != downstream_name)
+  {
+    TEST_ERROR("The downstream process name was changed");
+  }
+
+  if ((e["depth"].GetUint64() != 2) ||
+      (e["capacity"].GetUint64() != 8) ||
+      (e["high_water_mark"].GetUint64() != 5) ||
+      (e["push_count"].GetUint64() != 12) ||
+      (e["pop_count"].GetUint64() != 10))
+  {
+    TEST_ERROR("The JSON export has the wrong counts");
+  }
+
+  if ((e["blocked_push_ms"].GetDouble() != 3.0) ||
+      (e["mean_latency_ms"].GetDouble() != 2.0) ||
+      (e["max_latency_ms"].GetDouble() != 7.0))
+  {
+    TEST_ERROR("The JSON export has the wrong times");
+  }
+}
+
+// ------------------------------------------------------------------
+IMPLEMENT_TEST(json_empty)
+{
+  std::ostringstream sstr;
+
+  sprokit::export_edge_statistics_json(sstr, sprokit::pipeline::edge_statistics_map_t(), 0.0);
+
+  CEREAL_RAPIDJSON_NAMESPACE::Document doc;
+
+  doc.Parse(sstr.str().c_str());
+
+  if (doc.HasParseError() || !doc["edges"].IsArray() || doc["edges"].Size())
+  {
+    TEST_ERROR("An empty snapshot did not export an empty edge list: " << sstr.str());
+  }
+}
+
+// ------------------------------------------------------------------
+sprokit::pipeline::edge_statistics_map_t
+create_statistics(sprokit::process::name_t const& upstream)
+{
+  typedef sprokit::edge_statistics_t::duration_t duration_t;
+
+  sprokit::edge_statistics_t s;
+
+  s.depth = 2;
+  s.capacity = 8;
+  s.high_water_mark = 5;
+  s.push_count = 12;
+  s.pop_count = 10;
+  s.blocked_push_time = duration_t(3000000);
+  s.blocked_pop_time = duration_t(0);
+  s.total_latency = duration_t(20000000);
+  s.max_latency = duration_t(7000000);
+
+  sprokit::process::connection_t const connection(
+    sprokit::process::port_addr_t(upstream, upstream_port),
+    sprokit::process::port_addr_t(downstream_name, downstream_port));
+
+  sprokit::pipeline::edge_statistics_map_t stats;
+
+  stats[connection] = s;
+
+  return stats;
+}
@@ -0,0 +1,232 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+#ifndef INCL_ELEMENT_COLUMN_H
+#define INCL_ELEMENT_COLUMN_H
+
+///
+/// Dense, handle-indexed storage for the values of one data column.
+///
+/// Row handles are handed out sequentially by get_next_handle(), so the
+/// values are kept in fixed-size pages indexed directly by the handle
+/// rather than in a node per cell.  Pages are allocated when the first
+/// value in their range is set and released when their last value is
+/// removed; a page never moves once allocated, so references to values
+/// remain valid until that value is removed (the same guarantee std::map
+/// gave the old storage.)  Handles too large to be plausibly dense, such
+/// as INVALID_ROW_HANDLE, go to a sparse overflow map.
+///
+/// The trade-off is memory for sparse columns: a page holds storage for
+/// 1024 values whether or not they are set, so a column costs about
+/// 1024 * sizeof(T) bytes for each 1024-row range holding any value.  A
+/// column set on only a few widely spaced rows (e.g. a track-level field
+/// whose tracks are interleaved with many frames) can therefore use much
+/// more memory than a map would, while densely populated columns use
+/// far less.
+///
+/// Not thread-safe; element_store<T> serializes access.
+///
+
+#include <bitset>
+#include <map>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <track_oracle/core/track_oracle_api_types.h>
+
+namespace kwiver {
+namespace track_oracle {
+
+template< typename T >
+class element_column
+{
+public:
+  element_column(): n_entries(0) {}
+  ~element_column() {}
+
+  // number of rows with a value
+  size_t size() const { return this->n_entries; }
+
+  // return a pointer to the value at the row, or null if not set
+  const T* find( oracle_entry_handle_type h ) const
+  {
+    if ( ! is_dense( h ))
+    {
+      typename std::map< oracle_entry_handle_type, T >::const_iterator p = this->overflow.find( h );
+      return ( p == this->overflow.end() ) ? 0 : &p->second;
+    }
+    size_t pi = h >> page_bits;
+    if ( (pi >= this->pages.size()) || ( ! this->pages[pi] )) return 0;
+    return this->pages[pi]->find( h & page_mask );
+  }
+
+  T* find( oracle_entry_handle_type h )
+  {
+    return const_cast< T* >( static_cast< const element_column<T>* >( this )->find( h ));
+  }
+
+  // return the value at the row, setting it to the default if not set
+  T& get_or_create( oracle_entry_handle_type h, const T& default_value )
+  {
+    if ( ! is_dense( h ))
+    {
+      std::pair< typename std::map< oracle_entry_handle_type, T >::iterator, bool > p =
+        this->overflow.insert( std::make_pair( h, default_value ));
+      if ( p.second ) ++this->n_entries;
+      return p.first->second;
+    }
+    bool created = false;
+    T& ret = this->get_page( h >> page_bits ).get_or_create( h & page_mask, default_value, created );
+    if ( created ) ++this->n_entries;
+    return ret;
+  }
+
+  // set the value at the row, whether or not it was already set
+  void set( oracle_entry_handle_type h, const T& val )
+  {
+    this->get_or_create( h, val ) = val;
+  }
+
+  // remove the value at the row; return true if it was set
+  bool erase( oracle_entry_handle_type h )
+  {
+    if ( ! is_dense( h ))
+    {
+      size_t c = this->overflow.erase( h );
+      this->n_entries -= c;
+      return (c != 0);
+    }
+    size_t pi = h >> page_bits;
+    if ( (pi >= this->pages.size()) || ( ! this->pages[pi] )) return false;
+    if ( ! this->pages[pi]->erase( h & page_mask )) return false;
+    --this->n_entries;
+    if ( this->pages[pi]->empty() )
+    {
+      this->pages[pi].reset();
+    }
+    return true;
+  }
+
+  // call f( handle, value ) on each row in increasing handle order
+  // until it returns false; return false if stopped early
+  template< typename F >
+  bool for_each( F f ) const
+  {
+    for (size_t pi=0; pi<this->pages.size(); ++pi)
+    {
+      const page* pg = this->pages[pi].get();
+      if ( ! pg ) continue;
+      for (size_t i=0; i<page_size; ++i)
+      {
+        const T* v = pg->find( i );
+        if ( v && ( ! f( static_cast< oracle_entry_handle_type >( (pi << page_bits) | i ), *v )))
+        {
+          return false;
+        }
+      }
+    }
+    for (typename std::map< oracle_entry_handle_type, T >::const_iterator p = this->overflow.begin();
+         p != this->overflow.end();
+         ++p)
+    {
+      if ( ! f( p->first, p->second )) return false;
+    }
+    return true;
+  }
+
+private:
+  static const size_t page_bits = 10;
+  static const size_t page_size = size_t(1) << page_bits;
+  static const size_t page_mask = page_size - 1;
+
+  // handles at or above this go to the overflow map; keeps a stray
+  // handle from allocating a huge page table
+  static const size_t max_dense_pages = size_t(1) << 18;
+
+  static bool is_dense( oracle_entry_handle_type h )
+  {
+    return ( h >> page_bits ) < max_dense_pages;
+  }
+
+  // values are constructed in place only for rows which are set
+  class page
+  {
+  public:
+    page(): n_set(0) {}
+    ~page()
+    {
+      for (size_t i=0; i<page_size; ++i)
+      {
+        if ( this->present[i] ) this->cell( i )->~T();
+      }
+    }
+
+    bool empty() const { return this->n_set == 0; }
+
+    const T* find( size_t i ) const
+    {
+      return this->present[i] ? this->cell( i ) : 0;
+    }
+
+    T& get_or_create( size_t i, const T& default_value, bool& created )
+    {
+      created = ! this->present[i];
+      if ( created )
+      {
+        new ( &this->cells[i] ) T( default_value );
+        this->present[i] = true;
+        ++this->n_set;
+      }
+      return *this->cell( i );
+    }
+
+    bool erase( size_t i )
+    {
+      if ( ! this->present[i] ) return false;
+      this->cell( i )->~T();
+      this->present[i] = false;
+      --this->n_set;
+      return true;
+    }
+
+  private:
+    page( const page& ); // no cpctor
+    page& operator=( const page& ); // no op=
+
+    T* cell( size_t i ) { return reinterpret_cast< T* >( &this->cells[i] ); }
+    const T* cell( size_t i ) const { return reinterpret_cast< const T* >( &this->cells[i] ); }
+
+    typename std::aligned_storage< sizeof(T), std::alignment_of<T>::value >::type cells[ page_size ];
+    std::bitset< page_size > present;
+    size_t n_set;
+  };
+
+  page& get_page( size_t pi )
+  {
+    if ( pi >= this->pages.size() )
+    {
+      this->pages.resize( pi+1 );
+    }
+    if ( ! this->pages[pi] )
+    {
+      this->pages[pi].reset( new page() );
+    }
+    return *this->pages[pi];
+  }
+
+  element_column( const element_column& ); // no cpctor
+  element_column& operator=( const element_column& ); // no op=
+
+  std::vector< std::unique_ptr< page > > pages;
+  std::map< oracle_entry_handle_type, T > overflow;
+  size_t n_entries;
+};
+
+} // ...track_oracle
+} // ...kwiver
+
+#endif
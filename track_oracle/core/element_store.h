@@ -10,9 +10,12 @@
 ///
 
 #include <map>
+#include <mutex>
+#include <utility>
 
 #include <track_oracle/core/track_oracle_api_types.h>
 #include <track_oracle/core/element_store_base.h>
+#include <track_oracle/core/element_column.h>
 #include <track_oracle/core/kwiver_io_base.h>
 
 class TiXmlElement;
@@ -47,12 +50,40 @@ class element_store: public element_store_base
   virtual std::vector<std::string> csv_headers() const;
   virtual void set_to_default_value( const oracle_entry_handle_type& h );
 
-  std::map< oracle_entry_handle_type, T> storage;
-  const T& get_default_value() const;
+  // Typed access to the column.  Each call holds the column's lock, so
+  // rows of different columns may be read and written concurrently, but
+  // readers of the same column take turns (the lock is a plain mutex, as
+  // C++11 has no reader/writer lock);
+  // references returned by get_or_create remain valid until the row is
+  // removed, but concurrent writes through them must be coordinated by the
+  // caller.
+
+  // return the value at the row, setting it to the default if not set
+  T& get_or_create( const oracle_entry_handle_type& h );
+
+  // set the value at the row
+  void set( const oracle_entry_handle_type& h, const T& val );
+
+  // return <true, value> if the row is set, <false, default> otherwise
+  std::pair< bool, T > get( const oracle_entry_handle_type& h ) const;
+
+  // return the first row (in handle order) whose value equals val
+  oracle_entry_handle_type lookup( const T& val ) const;
+
+  // return the first row in rows whose value equals val
+  oracle_entry_handle_type lookup( const T& val, const handle_list_type& rows ) const;
+
+  // number of rows with a value
+  size_t size() const;
+
+  T get_default_value() const;
   void set_default_value( const T& val );
 
 private:
+  element_column<T> storage;
+  mutable std::mutex column_lock;
   T* default_value_ptr;
+  const T& unlocked_get_default_value() const;
   kwiver_io_base<T>* io_base_ptr;
   std::ostream& emit_as_XML_typed( std::ostream& os, const oracle_entry_handle_type& h ) const;
 };
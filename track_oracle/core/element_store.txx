@@ -73,8 +73,8 @@ bool
 element_store<T>
 ::exists( const oracle_entry_handle_type& h ) const
 {
-  typename map<oracle_entry_handle_type, T>::const_iterator p = this->storage.find( h );
-  return (p != this->storage.end() );
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  return (this->storage.find( h ) != 0 );
 }
 
 template< typename T >
@@ -82,49 +82,13 @@ vector< bool >
 element_store<T>
 ::exists( const vector< oracle_entry_handle_type>& sorted_hlist ) const
 {
+  // rows are indexed directly, so the list need not actually be sorted
   vector< bool > ret( sorted_hlist.size(), false );
-  if (sorted_hlist.empty())
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  for (size_t i=0; i<sorted_hlist.size(); ++i)
   {
-    return ret;
+    ret[i] = (this->storage.find( sorted_hlist[i] ) != 0 );
   }
-
-  size_t ret_index(0), hlist_size( sorted_hlist.size() );
-  typename map<oracle_entry_handle_type, T>::const_iterator p = this->storage.lower_bound( sorted_hlist[0] );
-  typename map<oracle_entry_handle_type, T>::const_iterator e = this->storage.end();
-
-  bool keep_going = (p != e) && (ret_index < hlist_size);
-  while (keep_going)
-  {
-    //
-    // each time through the loop, we either
-    //
-    // 1) if p->first < sorted_hlist[ret_index], increment p
-    //
-    // or
-    //
-    // 2) if p->first == sorted_hlist[ret_index], set return flag and increment both
-    //
-    // or
-    //
-    // 3) if p->first > sorted_hlist[ret_index], increment ret_index
-
-    oracle_entry_handle_type left(p->first), right( sorted_hlist[ ret_index ]);
-    if (left < right)
-    {
-      keep_going = (++p != e);
-    }
-    else if (left == right)
-    {
-      ret[ ret_index ] = true;
-      keep_going = ((++p != e) && (++ret_index < hlist_size));
-    }
-    else
-    {
-      keep_going = (++ret_index < hlist_size);
-    }
-
-  }
-
   return ret;
 }
 
@@ -145,10 +109,15 @@ ::copy_value( const oracle_entry_handle_type& src,
     return false;
   }
 
-  typename map<oracle_entry_handle_type, T>::iterator p = this->storage.find( src );
-  if ( p == this->storage.end() ) return false;
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  const T* p = this->storage.find( src );
+  if ( ! p ) return false;
 
-  this->storage.insert( make_pair( dst, p->second ));
+  // insert only if absent, as std::map::insert did
+  if ( ! this->storage.find( dst ))
+  {
+    this->storage.set( dst, *p );
+  }
   return true;
 }
 
@@ -173,8 +142,8 @@ bool
 element_store<T>
 ::remove( const oracle_entry_handle_type& h )
 {
-  size_t c = this->storage.erase( h );
-  return (c != 0);
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  return this->storage.erase( h );
 }
 
 template< typename T >
@@ -182,10 +151,11 @@ ostream&
 element_store<T>
 ::emit_as_kwiver( ostream& os, const oracle_entry_handle_type& h, const string& indent ) const
 {
-  typename map<oracle_entry_handle_type, T>::const_iterator p = this->storage.find( h );
-  if ( p != this->storage.end() )
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  const T* p = this->storage.find( h );
+  if ( p )
   {
-    this->io_base_ptr->write_xml( os, indent, p->second );
+    this->io_base_ptr->write_xml( os, indent, *p );
   }
   return os;
 }
@@ -195,16 +165,17 @@ ostream&
 element_store<T>
 ::emit_as_csv( ostream& os, const oracle_entry_handle_type& h, bool emit_default_if_missing ) const
 {
-  typename map<oracle_entry_handle_type, T>::const_iterator p = this->storage.find( h );
-  if ( p != this->storage.end() )
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  const T* p = this->storage.find( h );
+  if ( p )
   {
-    this->io_base_ptr->to_csv( os, p->second );
+    this->io_base_ptr->to_csv( os, *p );
   }
   else
   {
     if ( emit_default_if_missing )
     {
-      this->io_base_ptr->to_csv( os, this->get_default_value() );
+      this->io_base_ptr->to_csv( os, this->unlocked_get_default_value() );
     }
     else
     {
@@ -229,7 +200,8 @@ ::read_kwiver_xml_to_row( const oracle_entry_handle_type& h, const TiXmlElement*
     LOG_ERROR( local_logger, "Couldn't parse instance of " << this->get_descriptor().name << " at row " << e->Row() );
     return false;
   }
-  this->storage[ h ] = val;
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  this->storage.set( h, val );
   return true;
 }
 
@@ -244,7 +216,8 @@ ::read_csv_to_row( const oracle_entry_handle_type& h, const map< string, string>
     LOG_ERROR( local_logger, "Couldn't parse instance of " << this->get_descriptor().name << " from CSV" );
     return false;
   }
-  this->storage[ h ] = val;
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  this->storage.set( h, val );
   return true;
 }
 
@@ -257,9 +230,96 @@ ::csv_headers() const
 }
 
 template< typename T >
-const T&
+T&
+element_store<T>
+::get_or_create( const oracle_entry_handle_type& h )
+{
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  T* p = this->storage.find( h );
+  return
+    p
+    ? *p
+    : this->storage.get_or_create( h, this->unlocked_get_default_value() );
+}
+
+template< typename T >
+void
+element_store<T>
+::set( const oracle_entry_handle_type& h, const T& val )
+{
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  this->storage.set( h, val );
+}
+
+template< typename T >
+std::pair< bool, T >
+element_store<T>
+::get( const oracle_entry_handle_type& h ) const
+{
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  const T* p = this->storage.find( h );
+  return
+    p
+    ? std::make_pair( true, *p )
+    : std::make_pair( false, this->unlocked_get_default_value() );
+}
+
+template< typename T >
+oracle_entry_handle_type
+element_store<T>
+::lookup( const T& val ) const
+{
+  oracle_entry_handle_type ret = INVALID_ROW_HANDLE;
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  this->storage.for_each(
+    [&]( oracle_entry_handle_type h, const T& v )
+    {
+      if ( ! ( v == val )) return true;
+      ret = h;
+      return false;
+    } );
+  return ret;
+}
+
+template< typename T >
+oracle_entry_handle_type
+element_store<T>
+::lookup( const T& val, const handle_list_type& rows ) const
+{
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  for (size_t i=0; i<rows.size(); ++i)
+  {
+    const T* p = this->storage.find( rows[i] );
+    if ( p && ( *p == val ))
+    {
+      return rows[i];
+    }
+  }
+  return INVALID_ROW_HANDLE;
+}
+
+template< typename T >
+size_t
+element_store<T>
+::size() const
+{
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  return this->storage.size();
+}
+
+template< typename T >
+T
 element_store<T>
 ::get_default_value() const
+{
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  return this->unlocked_get_default_value();
+}
+
+template< typename T >
+const T&
+element_store<T>
+::unlocked_get_default_value() const
 {
   if ( ! this->default_value_ptr )
   {
@@ -273,6 +333,7 @@ void
 element_store<T>
 ::set_default_value( const T& val)
 {
+  std::lock_guard< std::mutex > lock( this->column_lock );
   delete this->default_value_ptr;
   this->default_value_ptr = new T(val);
 }
@@ -282,7 +343,8 @@ void
 element_store<T>
 ::set_to_default_value( const oracle_entry_handle_type& h )
 {
-  this->storage[ h ] = this->get_default_value();
+  std::lock_guard< std::mutex > lock( this->column_lock );
+  this->storage.set( h, this->unlocked_get_default_value() );
 }
 
 //
@@ -134,20 +134,22 @@ struct type_has_default_value_member
 };
 
 template< bool T_has_default_value, typename T, typename Type >
-struct set_default_value_handler
+struct data_term_default_handler
 {
-  static void set_handler( element_store<Type>* es_ptr )
+  // return the data term's default value in val; true if there is one
+  static bool get_default( Type& val )
   {
-    es_ptr->set_default_value( T::get_default_value() );
+    val = T::get_default_value();
+    return true;
   }
 };
 
 template< typename T, typename Type >
-struct set_default_value_handler< false, T, Type >
+struct data_term_default_handler< false, T, Type >
 {
-  static void set_handler( element_store<Type>* )
+  static bool get_default( Type& )
   {
-    // do nothing
+    return false;
   }
 };
 
@@ -236,26 +238,23 @@ ::lookup_or_create_element_store( const string& field_name )
   // If we don't find an element_store whose name==field_name, we create
   // one using, for the moment, default fields for e.g. the element role.
   //
+  // The lookup and creation are a single step so that threads constructing
+  // the same schema concurrently (e.g. parallel file loading) all get the
+  // same column, with its default value already set.
+  //
 
   string my_typeid_str = typeid( static_cast<Type*>(0) ).name();
-  field_handle_type f = track_oracle_core::lookup_by_name( field_name );
-
-  if ( f == INVALID_FIELD_HANDLE )
-  {
-    // no column by that name; create one
-    f = track_oracle_core::create_element<Type>(
-                       element_descriptor(
-                         field_name,
-                         "no description",
-                         my_typeid_str,
-                         element_descriptor::ADHOC));
-    // if the type is a data term with a default value, set it
-    element_store<Type>* es_ptr = get_element_store<Type>( f );
-    set_default_value_handler< type_has_default_value_member<T>::value, T, Type >::set_handler( es_ptr );
-    return f;
-  }
-
-  // we have a column by that name; check the type
+  Type default_value = Type();
+  bool has_default = data_term_default_handler< type_has_default_value_member<T>::value, T, Type >::get_default( default_value );
+  field_handle_type f = track_oracle_core::lookup_or_create_element<Type>(
+                          element_descriptor(
+                            field_name,
+                            "no description",
+                            my_typeid_str,
+                            element_descriptor::ADHOC),
+                          has_default ? &default_value : 0 );
+
+  // check the type, in case the column already existed
   element_descriptor e = track_oracle_core::get_element_descriptor( f );
 
   if (e.typeid_str != my_typeid_str)
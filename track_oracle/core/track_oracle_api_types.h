@@ -15,6 +15,7 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <utility>
 
 namespace kwiver {
 namespace track_oracle {
@@ -39,6 +40,9 @@ const field_handle_type INVALID_FIELD_HANDLE = static_cast<field_handle_type>( -
 // special row for system bookkeeping
 const oracle_entry_handle_type SYSTEM_ROW_HANDLE = 0;
 
+// a run of row handles: [first, second)
+typedef std::pair< oracle_entry_handle_type, oracle_entry_handle_type > handle_range_type;
+
 //
 // The only structure track oracle imposes on the data is the abstract
 // structure of a moving object track:
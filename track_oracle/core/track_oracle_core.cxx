@@ -97,6 +97,20 @@ ::get_next_handle()
   return track_oracle_core::get_instance().get_next_handle();
 }
 
+handle_range_type
+track_oracle_core
+::reserve_handles( size_t n )
+{
+  return track_oracle_core::get_instance().reserve_handles( n );
+}
+
+handle_range_type
+track_oracle_core
+::set_handle_range( const handle_range_type& r )
+{
+  return track_oracle_core::get_instance().set_handle_range( r );
+}
+
 handle_list_type
 track_oracle_core
 ::get_domain( domain_handle_type domain )
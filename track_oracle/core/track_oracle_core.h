@@ -46,10 +46,27 @@ class TRACK_ORACLE_EXPORT track_oracle_core
   static element_store_base* get_mutable_element_store_base( field_handle_type f );
   template< typename T > static field_handle_type create_element( const element_descriptor& e );
 
+  // Atomically return the field named e.name, creating it if it doesn't exist
+  // with default_value (or the type's zero / default-constructed value if null)
+  // as the default.  Safe to call from several threads at once; the caller
+  // should check the type of an existing field.
+  template< typename T > static field_handle_type lookup_or_create_element( const element_descriptor& e, const T* default_value );
+
   static bool field_has_row( oracle_entry_handle_type row, field_handle_type field );
   template< typename T > static T& get_field( oracle_entry_handle_type track, field_handle_type field );
   template< typename T > static oracle_entry_handle_type lookup( field_handle_type field, const T& val, domain_handle_type domain );
   static oracle_entry_handle_type get_next_handle();
+
+  // Reserve n consecutive row handles which the shared counter will
+  // never hand out.
+  static handle_range_type reserve_handles( size_t n );
+
+  // Have get_next_handle() on the calling thread take handles from the
+  // range, in order, before falling back to the shared counter; returns
+  // the unused part of the thread's previous range so it can be restored.
+  // Readers running concurrently in reserved ranges get the same handles
+  // from run to run.
+  static handle_range_type set_handle_range( const handle_range_type& r );
   template< typename T > static std::pair< bool, T > get( const oracle_entry_handle_type& row, const field_handle_type& field );
 
   template< typename T > static void remove_field( oracle_entry_handle_type row, field_handle_type field );
@@ -22,6 +22,14 @@ ::create_element( const element_descriptor& e )
   return track_oracle_core::get_instance().create_element<T>( e );
 }
 
+template< typename T >
+field_handle_type
+track_oracle_core
+::lookup_or_create_element( const element_descriptor& e, const T* default_value )
+{
+  return track_oracle_core::get_instance().lookup_or_create_element<T>( e, default_value );
+}
+
 template< typename T >
 T&
 track_oracle_core
@@ -117,9 +117,17 @@ ::remap_from_existing_headers(
 namespace kwiver {
 namespace track_oracle {
 
+namespace // anon
+{
+// handles reserved for get_next_handle() on this thread; empty by default
+thread_local handle_range_type thread_handle_range( 0, 0 );
+} // anon
+
 track_oracle_core_impl
 ::track_oracle_core_impl()
-  : field_count(0), row_count(1000), last_domain_allocated( DOMAIN_ALL )
+  : field_count(0), row_count(1000),
+    frame_list_store(0), parent_track_store(0),
+    last_domain_allocated( DOMAIN_ALL )
 {
   // create some system tables: __parent_track, __frame_list
   {
@@ -139,13 +147,18 @@ ::track_oracle_core_impl()
       element_descriptor::SYSTEM );
     this->unlocked_create_element< oracle_entry_handle_type >( e );
   }
+
+  this->frame_list_store =
+    dynamic_cast< element_store< frame_handle_list_type >* >( this->element_pool[ this->lookup_required_field( "__frame_list" ) ] );
+  this->parent_track_store =
+    dynamic_cast< element_store< oracle_entry_handle_type >* >( this->element_pool[ this->lookup_required_field( "__parent_track" ) ] );
 }
 
 vector< field_handle_type >
 track_oracle_core_impl
 ::get_all_field_handles() const
 {
- std::lock_guard< std::mutex > lock( this->api_lock );
+ std::lock_guard< std::mutex > lock( this->schema_lock );
  vector< field_handle_type > ret;
  for (auto const& p: this->name_pool)
  {
@@ -170,7 +183,7 @@ field_handle_type
 track_oracle_core_impl
 ::lookup_by_name( const string& name ) const
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
+  std::lock_guard< std::mutex > lock( this->schema_lock );
   return this->unlocked_lookup_by_name( name );
 }
 
@@ -183,15 +196,26 @@ ::lookup_required_field( const string& fn ) const
   return probe->second;
 }
 
-element_descriptor
+element_store_base*
 track_oracle_core_impl
-::get_element_descriptor( field_handle_type f ) const
+::find_store( field_handle_type f ) const
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
+  std::lock_guard< std::mutex > lock( this->schema_lock );
   map< field_handle_type, element_store_base* >::const_iterator probe = this->element_pool.find( f );
   return
     ( probe != this->element_pool.end() )
-    ? probe->second->get_descriptor()
+    ? probe->second
+    : 0;
+}
+
+element_descriptor
+track_oracle_core_impl
+::get_element_descriptor( field_handle_type f ) const
+{
+  const element_store_base* b = this->find_store( f );
+  return
+    b
+    ? b->get_descriptor()
     : element_descriptor();
 }
 
@@ -199,52 +223,34 @@ const element_store_base*
 track_oracle_core_impl
 ::get_element_store_base( field_handle_type f ) const
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
-  map< field_handle_type, element_store_base* >::const_iterator probe = this->element_pool.find( f );
-  return
-    ( probe != this->element_pool.end() )
-    ? probe->second
-    : 0;
+  return this->find_store( f );
 }
 
 element_store_base*
 track_oracle_core_impl
 ::get_mutable_element_store_base( field_handle_type f ) const
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
-  map< field_handle_type, element_store_base* >::const_iterator probe = this->element_pool.find( f );
-  return
-    ( probe != this->element_pool.end() )
-    ? probe->second
-    : 0;
+  return this->find_store( f );
 }
 
 bool
 track_oracle_core_impl
-::unlocked_field_has_row( oracle_entry_handle_type row, field_handle_type field ) const
+::field_has_row( oracle_entry_handle_type row, field_handle_type field )
 {
   if ( field == INVALID_FIELD_HANDLE ) return false;
-  map< field_handle_type, element_store_base* >::const_iterator probe = this->element_pool.find( field );
-  if ( probe == this->element_pool.end() )
+  const element_store_base* b = this->find_store( field );
+  if ( ! b )
   {
     throw runtime_error( "Attempted field_has_row on non-existent field" );
   }
-  return probe->second->exists( row );
-}
-
-bool
-track_oracle_core_impl
-::field_has_row( oracle_entry_handle_type row, field_handle_type field )
-{
-  std::lock_guard< std::mutex > lock( this->api_lock );
-  return this->unlocked_field_has_row( row, field );
+  return b->exists( row );
 }
 
 vector< field_handle_type >
 track_oracle_core_impl
 ::fields_at_row( oracle_entry_handle_type row ) const
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
+  std::lock_guard< std::mutex > lock( this->schema_lock );
   vector< field_handle_type > ret;
   for (map< field_handle_type, element_store_base* >::const_iterator i = this->element_pool.begin();
        i != this->element_pool.end();
@@ -262,12 +268,9 @@ vector< vector< field_handle_type > >
 track_oracle_core_impl
 ::fields_at_rows( const vector<oracle_entry_handle_type>& rows ) const
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
+  std::lock_guard< std::mutex > lock( this->schema_lock );
   vector< vector< field_handle_type > > ret( rows.size() );
 
-  vector< oracle_entry_handle_type > sorted_rows( rows );
-  std::sort( sorted_rows.begin(), sorted_rows.end() );
-
   for (map< field_handle_type, element_store_base* >::const_iterator i = this->element_pool.begin();
        i != this->element_pool.end();
        ++i)
@@ -288,10 +291,34 @@ oracle_entry_handle_type
 track_oracle_core_impl
 ::get_next_handle()
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
+  handle_range_type& r = thread_handle_range;
+  if ( r.first < r.second ) return r.first++;
+  if ( r.second != 0 )
+  {
+    LOG_WARN( main_logger, "Used up a reserved range of handles ending at " << r.second
+              << "; further handles on this thread will depend on thread timing" );
+    r = handle_range_type( 0, 0 );
+  }
   return ++this->row_count;
 }
 
+handle_range_type
+track_oracle_core_impl
+::reserve_handles( size_t n )
+{
+  oracle_entry_handle_type last = ( this->row_count += n );
+  return handle_range_type( last - n + 1, last + 1 );
+}
+
+handle_range_type
+track_oracle_core_impl
+::set_handle_range( const handle_range_type& r )
+{
+  handle_range_type old = thread_handle_range;
+  thread_handle_range = r;
+  return old;
+}
+
 handle_list_type
 track_oracle_core_impl
 ::get_domain( domain_handle_type domain )
@@ -395,6 +422,7 @@ track_oracle_core_impl
 ::release_domain( const domain_handle_type& domain )
 {
   std::lock_guard< std::mutex > lock( this->api_lock );
+  std::lock_guard< std::mutex > schema( this->schema_lock );
 
   map< domain_handle_type, handle_list_type >::iterator probe = this->domain_pool.find( domain );
   if (probe == this->domain_pool.end())
@@ -403,12 +431,6 @@ ::release_domain( const domain_handle_type& domain )
     return false;
   }
 
-  field_handle_type flh = this->unlocked_lookup_by_name( "__frame_list" );
-  if ( flh == INVALID_FIELD_HANDLE ) throw runtime_error( "Lost __frame_list" );
-  const pair< map< oracle_entry_handle_type, frame_handle_list_type >*, frame_handle_list_type >& frame_list_lookup
-    = this->lookup_table< frame_handle_list_type >( flh );
-  const map<oracle_entry_handle_type, frame_handle_list_type>& frame_lists = *frame_list_lookup.first;
-
   handle_list_type rows_to_delete;
 
   // get the list of handles to be deleted
@@ -418,10 +440,10 @@ ::release_domain( const domain_handle_type& domain )
   {
     rows_to_delete.push_back( handles[i] );
     // get the frame list (if any)
-    map< oracle_entry_handle_type, frame_handle_list_type >::const_iterator frame_probe = frame_lists.find( handles[i] );
-    if (frame_probe != frame_lists.end() )
+    pair< bool, frame_handle_list_type > frame_probe = this->frame_list_store->get( handles[i] );
+    if ( frame_probe.first )
     {
-      const frame_handle_list_type& frames = frame_probe->second;
+      const frame_handle_list_type& frames = frame_probe.second;
       for (size_t j=0; j<frames.size(); ++j)
       {
         rows_to_delete.push_back( frames[j].row );
@@ -489,14 +511,13 @@ frame_handle_list_type
 track_oracle_core_impl
 ::unlocked_get_frames( const track_handle_type& t )
 {
-  return this->unlocked_get_field<frame_handle_list_type>( t.row, this->lookup_required_field( "__frame_list" ));
+  return this->frame_list_store->get_or_create( t.row );
 }
 
 frame_handle_list_type
 track_oracle_core_impl
 ::get_frames( const track_handle_type& t )
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
   return this->unlocked_get_frames( t );
 }
 
@@ -504,16 +525,14 @@ void
 track_oracle_core_impl
 ::set_frames( const track_handle_type& t, const frame_handle_list_type& frames )
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
-  this->unlocked_get_field< frame_handle_list_type >( t.row, this->lookup_required_field( "__frame_list" )) = frames;
+  this->frame_list_store->set( t.row, frames );
 }
 
 size_t
 track_oracle_core_impl
 ::get_n_frames( const track_handle_type& t )
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
-  return this->unlocked_get_field< frame_handle_list_type >( t.row, this->lookup_required_field( "__frame_list" )).size();
+  return this->frame_list_store->get_or_create( t.row ).size();
 }
 
 bool
@@ -532,7 +551,7 @@ ::clone_nonsystem_fields( const oracle_entry_handle_type& src,
     return false;
   }
 
-  std::lock_guard< std::mutex > lock( this->api_lock );
+  std::lock_guard< std::mutex > lock( this->schema_lock );
   bool all_okay = true;
   for ( map< field_handle_type, element_store_base* >::iterator i = this->element_pool.begin();
         i != this->element_pool.end();
@@ -601,14 +620,9 @@ ::emit_pool_as_csv( ostream& os,
            && csv_v1_semantics
            && (target_fh == external_id_fh))
       {
-        // all this because we don't have a const lookup?
-        field_handle_type pt_fh = this->unlocked_lookup_by_name( "__parent_track" );
-        map< field_handle_type, element_store_base* >::const_iterator pt_probe = this->element_pool.find( pt_fh );
-        element_store<oracle_entry_handle_type>* es_ptr = dynamic_cast< element_store<oracle_entry_handle_type>*>( pt_probe->second );
-        if ( ! es_ptr ) throw runtime_error ("Bad column cast looking for external id" );
-        map< oracle_entry_handle_type, oracle_entry_handle_type >::const_iterator pt_row_probe = es_ptr->storage.find( row );
-        if ( pt_row_probe == es_ptr->storage.end() ) throw runtime_error( "Frame has no parent track?" );
-        emitted_row = pt_row_probe->second;
+        pair< bool, oracle_entry_handle_type > pt_row_probe = this->parent_track_store->get( row );
+        if ( ! pt_row_probe.first ) throw runtime_error( "Frame has no parent track?" );
+        emitted_row = pt_row_probe.second;
       }
 
       p->second->emit_as_csv( os, emitted_row, output_order[i].emit_default_if_absent );
@@ -628,6 +642,7 @@ track_oracle_core_impl
 ::write_kwiver( ostream& os, const track_handle_list_type& tracks )
 {
   std::lock_guard< std::mutex > lock( this->api_lock );
+  std::lock_guard< std::mutex > schema( this->schema_lock );
   os << "<kwiver>\n"
      << "<!--\n"
      << "  File of " << tracks.size() << " tracks emitted by track_oracle's kwiver writer\n"
@@ -689,6 +704,7 @@ track_oracle_core_impl
 ::write_csv( ostream& os, const track_handle_list_type& tracks, bool csv_v1_semantics )
 {
   std::lock_guard< std::mutex > lock( this->api_lock );
+  std::lock_guard< std::mutex > schema( this->schema_lock );
 
   field_handle_type world_gcs_fh = this->unlocked_lookup_by_name( "world_gcs" );
   if ( world_gcs_fh == INVALID_FIELD_HANDLE )
@@ -928,7 +944,7 @@ csv_handler_map_type
 track_oracle_core_impl
 ::get_csv_handler_map( const vector< string >& headers )
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
+  std::lock_guard< std::mutex > lock( this->schema_lock );
 
   map< string, field_handle_type > header_map;
   map< size_t, size_t > header_claimed_map;
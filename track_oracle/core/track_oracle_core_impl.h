@@ -8,6 +8,7 @@
 #include <vital/vital_config.h>
 #include <track_oracle/core/track_oracle_export.h>
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <mutex>
@@ -60,10 +61,24 @@ class TRACK_ORACLE_EXPORT track_oracle_core_impl
   // ctor does a lookup on name only to see if it has to then create
   // with a full element_descriptor.
 
+  //
+  // Locking: schema_lock guards element_pool, name_pool, and field_count;
+  // each element_store guards its own rows, so threads working on different
+  // columns don't contend.  api_lock guards the domains and is held across
+  // whole-oracle operations (writing, releasing domains) so they see a
+  // stable set of rows.  Locks are always taken in the order api_lock,
+  // schema_lock, column lock.  Element stores are never deleted, so a
+  // pointer to one remains valid after schema_lock is released.
+  //
+
   std::map< field_handle_type, element_store_base* > element_pool;
   std::map< std::string, field_handle_type > name_pool;
   unsigned field_count;
-  unsigned row_count;
+  std::atomic< oracle_entry_handle_type > row_count;
+
+  // the system columns, cached to avoid a name lookup on every access
+  element_store< frame_handle_list_type >* frame_list_store;
+  element_store< oracle_entry_handle_type >* parent_track_store;
 
   std::map< domain_handle_type, handle_list_type > domain_pool;
   std::map< std::string, domain_handle_type > domain_names;
@@ -72,22 +87,28 @@ class TRACK_ORACLE_EXPORT track_oracle_core_impl
   track_oracle_core_impl( const track_oracle_core_impl& ); // no cpctor
   track_oracle_core_impl operator=( const track_oracle_core_impl& ); // no op=
 
-  // Given a field (column) index, return the map of that column's data
-  // Always create if not found; also return the table's default value
-  template< typename T > std::pair< std::map<oracle_entry_handle_type, T>*, T > lookup_table( field_handle_type field );
+  // Given a field (column) index, return that column's typed store;
+  // throws if the field doesn't exist or has a different type.
+  // Takes schema_lock.
+  template< typename T > element_store<T>* lookup_table( field_handle_type field );
+
+  // Given a field (column) index, return that column's store, or null
+  // if not found.  Takes schema_lock.
+  element_store_base* find_store( field_handle_type field ) const;
 
-  // giant mutex for a blunt approach to thread safety
   mutable std::mutex api_lock;
+  mutable std::mutex schema_lock;
 
-  // throws if the field doesn't exist
+  // throws if the field doesn't exist; caller holds schema_lock
   field_handle_type lookup_required_field( const std::string& fn ) const;
 
-  // unlocked versions of API calls which are also called internally
+  // versions of API calls which are also called internally: these don't
+  // take api_lock, and those which touch the pool expect the caller to
+  // hold schema_lock
   template< typename T > field_handle_type unlocked_create_element( const element_descriptor& e );
   field_handle_type unlocked_lookup_by_name( const std::string& name ) const;
   template< typename T > T& unlocked_get_field( oracle_entry_handle_type track, field_handle_type field );
   frame_handle_list_type unlocked_get_frames( const track_handle_type& t );
-  bool unlocked_field_has_row( oracle_entry_handle_type row, field_handle_type field ) const;
   void emit_pool_as_kwiver( std::ostream& os, const std::string& indent, oracle_entry_handle_type row ) const;
   void emit_pool_as_csv( std::ostream& os,
                          const std::vector< csv_element >& output_order,
@@ -105,6 +126,7 @@ class TRACK_ORACLE_EXPORT track_oracle_core_impl
   track_oracle_core_impl();
 
   template< typename T > field_handle_type create_element( const element_descriptor& e );
+  template< typename T > field_handle_type lookup_or_create_element( const element_descriptor& e, const T* default_value );
 
   std::vector< field_handle_type > get_all_field_handles() const;
   field_handle_type lookup_by_name( const std::string& name ) const;
@@ -118,17 +140,25 @@ class TRACK_ORACLE_EXPORT track_oracle_core_impl
   // Given a field handle, does the row (track or frame) have an entry?
   bool field_has_row( oracle_entry_handle_type track, field_handle_type field );
 
-  // Given a {track,frame}/field (row/column) location, return a ref to the value
-  // Type T must have a default constructor in case the value doesn't exist, hmm
-  // ...this will be tricky to make thread safe.
+  // Given a {track,frame}/field (row/column) location, return a ref to the value,
+  // setting it to the column's default if it doesn't exist.  The reference
+  // remains valid until the value is removed, but concurrent writes through
+  // it to the same row must be coordinated by the caller.
   template< typename T > T& get_field( oracle_entry_handle_type track, field_handle_type field );
 
   // return a pair <bool, T>; bool is true if T exists, false otherwise
   template< typename T > std::pair< bool, T > get( oracle_entry_handle_type row, field_handle_type field );
 
-  // Get the handle for the next track or frame
+  // Get the handle for the next track or frame, from the calling
+  // thread's handle range if it has one
   oracle_entry_handle_type get_next_handle();
 
+  // reserve n consecutive handles
+  handle_range_type reserve_handles( size_t n );
+
+  // set the calling thread's handle range, returning the previous one
+  handle_range_type set_handle_range( const handle_range_type& r );
+
   // delete the track (including frames and __frame_list)
   bool remove_track( const track_handle_type& track );
 
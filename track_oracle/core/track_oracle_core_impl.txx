@@ -93,33 +93,51 @@ field_handle_type
 track_oracle_core_impl
 ::create_element( const element_descriptor& e )
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
+  std::lock_guard< std::mutex > lock( this->schema_lock );
   return this->unlocked_create_element<T>( e );
 }
 
 template< typename T >
-pair< map<oracle_entry_handle_type, T>*, T >
+field_handle_type
+track_oracle_core_impl
+::lookup_or_create_element( const element_descriptor& e, const T* default_value )
+{
+  // the new store isn't visible to other threads until schema_lock is
+  // released, so they never see it without its default
+  std::lock_guard< std::mutex > lock( this->schema_lock );
+  field_handle_type f = this->unlocked_lookup_by_name( e.name );
+  if ( f != INVALID_FIELD_HANDLE ) return f;
+
+  f = this->unlocked_create_element<T>( e );
+  if ( default_value )
+  {
+    dynamic_cast< element_store<T>* >( this->element_pool[ f ] )->set_default_value( *default_value );
+  }
+  return f;
+}
+
+template< typename T >
+element_store<T>*
 track_oracle_core_impl
 ::lookup_table( field_handle_type field )
 {
-  map< field_handle_type, element_store_base* >::iterator probe = this->element_pool.find( field );
-  if (probe == this->element_pool.end())
+  element_store_base* b = this->find_store( field );
+  if ( ! b )
   {
     throw runtime_error( "Lost an element pool for a field?" );
   }
-  element_store<T>* es_ptr = dynamic_cast< element_store<T>* >( probe->second );
+  element_store<T>* es_ptr = dynamic_cast< element_store<T>* >( b );
   if ( ! es_ptr )
   {
     ostringstream oss;
-    const element_descriptor& d = probe->second->get_descriptor();
+    const element_descriptor& d = b->get_descriptor();
     string my_typeid_str = typeid( static_cast<T*>(0) ).name();
     oss << "Table lookup type mismatch: field " << field << " is '" << d.name << "' type "
         << d.typeid_str << " but requested as a " << my_typeid_str << "\n";
     LOG_ERROR( main_logger, "About to throw exception '" << oss.str() << "'" );
     throw runtime_error( oss.str() );
   }
-  pair< map< oracle_entry_handle_type, T>*, T> ret( &es_ptr->storage, es_ptr->get_default_value() );
-  return ret;
+  return es_ptr;
 }
 
 template< typename T >
@@ -127,9 +145,7 @@ void
 track_oracle_core_impl
 ::remove_field( oracle_entry_handle_type row, field_handle_type field )
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
-  pair< map< oracle_entry_handle_type, T >*, T > probe = this->lookup_table<T>( field );
-  probe.first->erase( row );
+  this->lookup_table<T>( field )->remove( row );
 }
 
 template< typename T >
@@ -137,15 +153,7 @@ T&
 track_oracle_core_impl
 ::unlocked_get_field( oracle_entry_handle_type track, field_handle_type field )
 {
-  pair< map< oracle_entry_handle_type, T >*, T > probe = this->lookup_table<T>( field );
-  map< oracle_entry_handle_type, T >& data_column = *(probe.first);
-  size_t before = data_column.size();
-  T& ref = data_column[ track ];
-  if ( before != data_column.size() )
-  {
-    ref = probe.second;
-  }
-  return ref;
+  return this->lookup_table<T>( field )->get_or_create( track );
 }
 
 template< typename T >
@@ -153,7 +161,6 @@ T&
 track_oracle_core_impl
 ::get_field( oracle_entry_handle_type track, field_handle_type field )
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
   return this->unlocked_get_field<T>( track, field );
 }
 
@@ -162,13 +169,7 @@ pair< bool, T >
 track_oracle_core_impl
 ::get( oracle_entry_handle_type row, field_handle_type field )
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
-  const pair< map< oracle_entry_handle_type, T >*, T> f_probe = this->lookup_table<T>( field );
-  typename map< oracle_entry_handle_type, T >::const_iterator probe = f_probe.first->find( row );
-  return
-    ( probe == f_probe.first->end() )
-    ? make_pair( false, f_probe.second )
-    : make_pair( true, probe->second );
+  return this->lookup_table<T>( field )->get( row );
 }
 
 template< typename T >
@@ -176,40 +177,18 @@ oracle_entry_handle_type
 track_oracle_core_impl
 ::lookup( field_handle_type field, const T& val, domain_handle_type domain )
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
-  pair< map< oracle_entry_handle_type, T >*, T > probe = this->lookup_table<T>( field );
-  map< oracle_entry_handle_type, T >& data_column = *(probe.first);
+  element_store<T>* es_ptr = this->lookup_table<T>( field );
   if ( domain == DOMAIN_ALL )
   {
-    for (typename map< oracle_entry_handle_type, T>::const_iterator i = data_column.begin();
-         i != data_column.end();
-         ++i )
-    {
-      if ( i->second == val )
-      {
-        return i->first;
-      }
-    }
+    return es_ptr->lookup( val );
   }
-  else
-  {
-    map< domain_handle_type, handle_list_type >::iterator i = domain_pool.find( domain );
-    if ( i != domain_pool.end() )
-    {
-      const handle_list_type& handle_list = i->second;
-      for (unsigned j=0; j < handle_list.size(); ++j )
-      {
-        typename map< oracle_entry_handle_type, T>::const_iterator h_probe
-          = data_column.find( handle_list[j] );
-        if ( ( h_probe != data_column.end() ) && ( h_probe->second == val ))
-        {
-          return handle_list[j];
-        }
-      } // ...all the domain handles
-    } // ...if the domain is valid
-  } // ... for the domain
-
-  return INVALID_ROW_HANDLE;
+
+  std::lock_guard< std::mutex > lock( this->api_lock );
+  map< domain_handle_type, handle_list_type >::iterator i = domain_pool.find( domain );
+  return
+    ( i != domain_pool.end() )
+    ? es_ptr->lookup( val, i->second )
+    : INVALID_ROW_HANDLE;
 }
 
 } // ...track_oracle
@@ -11,13 +11,15 @@
 #define TRACK_ORACLE_INSTANCES(T) \
   template TRACK_ORACLE_CORE_EXPORT kwiver::track_oracle::field_handle_type kwiver::track_oracle::track_oracle_core_impl::unlocked_create_element<T>( const kwiver::track_oracle::element_descriptor& e ); \
   template TRACK_ORACLE_CORE_EXPORT kwiver::track_oracle::field_handle_type kwiver::track_oracle::track_oracle_core::create_element<T>( const kwiver::track_oracle::element_descriptor& e ); \
+  template TRACK_ORACLE_CORE_EXPORT kwiver::track_oracle::field_handle_type kwiver::track_oracle::track_oracle_core::lookup_or_create_element<T>( const kwiver::track_oracle::element_descriptor& e, const T* default_value ); \
+  template TRACK_ORACLE_CORE_EXPORT kwiver::track_oracle::field_handle_type kwiver::track_oracle::track_oracle_core_impl::lookup_or_create_element<T>( const kwiver::track_oracle::element_descriptor& e, const T* default_value ); \
   template TRACK_ORACLE_CORE_EXPORT T& kwiver::track_oracle::track_oracle_core_impl::unlocked_get_field<T>( kwiver::track_oracle::oracle_entry_handle_type track, kwiver::track_oracle::field_handle_type field ); \
   template TRACK_ORACLE_CORE_EXPORT T& kwiver::track_oracle::track_oracle_core::get_field<T>( kwiver::track_oracle::oracle_entry_handle_type track, kwiver::track_oracle::field_handle_type field ); \
   template TRACK_ORACLE_CORE_EXPORT std::pair< bool, T > kwiver::track_oracle::track_oracle_core::get<T>( const kwiver::track_oracle::oracle_entry_handle_type& track, const kwiver::track_oracle::field_handle_type& field ); \
   template TRACK_ORACLE_CORE_EXPORT std::pair< bool, T > kwiver::track_oracle::track_oracle_core_impl::get<T>( kwiver::track_oracle::oracle_entry_handle_type track, kwiver::track_oracle::field_handle_type field ); \
   template TRACK_ORACLE_CORE_EXPORT kwiver::track_oracle::oracle_entry_handle_type kwiver::track_oracle::track_oracle_core::lookup<T>( kwiver::track_oracle::field_handle_type field, const T& val, kwiver::track_oracle::domain_handle_type domain ); \
   template TRACK_ORACLE_CORE_EXPORT void kwiver::track_oracle::track_oracle_core::remove_field<T>( kwiver::track_oracle::oracle_entry_handle_type row, kwiver::track_oracle::field_handle_type field );\
-  template TRACK_ORACLE_CORE_EXPORT std::pair< std::map<kwiver::track_oracle::oracle_entry_handle_type, T>*, T> kwiver::track_oracle::track_oracle_core_impl::lookup_table<T>( kwiver::track_oracle::field_handle_type field ); \
+  template TRACK_ORACLE_CORE_EXPORT kwiver::track_oracle::element_store<T>* kwiver::track_oracle::track_oracle_core_impl::lookup_table<T>( kwiver::track_oracle::field_handle_type field ); \
   template TRACK_ORACLE_CORE_EXPORT T& kwiver::track_oracle::track_oracle_core_impl::get_field<T>( kwiver::track_oracle::oracle_entry_handle_type track, kwiver::track_oracle::field_handle_type field ); \
   template TRACK_ORACLE_CORE_EXPORT void kwiver::track_oracle::track_oracle_core_impl::remove_field<T>( kwiver::track_oracle::oracle_entry_handle_type row, kwiver::track_oracle::field_handle_type field ); \
   template TRACK_ORACLE_CORE_EXPORT kwiver::track_oracle::oracle_entry_handle_type kwiver::track_oracle::track_oracle_core_impl::lookup<T>( kwiver::track_oracle::field_handle_type field, const T& val, kwiver::track_oracle::domain_handle_type domain );
@@ -9,16 +9,22 @@
 #include <stdexcept>
 #include <sstream>
 #include <mutex>
+#include <algorithm>
+#include <exception>
+#include <future>
 #include <vul/vul_string.h>
 #include <vul/vul_file.h>
+#include <vul/vul_file_iterator.h>
 
 #include <vital/types/timestamp.h>
+#include <vital/util/thread_pool.h>
 
 #include <track_oracle/file_formats/file_format_schema.h>
 #include <track_oracle/file_formats/file_format_base.h>
 
 #include <track_oracle/core/state_flags.h>
 #include <track_oracle/core/element_store_base.h>
+#include <track_oracle/core/track_oracle_core.h>
 
 #include <track_oracle/file_formats/track_kw18/file_format_kw18.h>
 #ifdef SHAPELIB_ENABLED
@@ -60,6 +66,24 @@ ::kwiver::track_oracle::file_format_manager_impl* ::kwiver::track_oracle::file_f
 namespace // anon
 {
 std::mutex instance_lock;
+
+// Handles reserved per byte of each file in a batch read.  Every format
+// spends well over this many bytes on each track or frame it creates; a
+// file which needs more handles gets the rest from the shared counter.
+const double batch_handles_per_byte = 1.0 / 8;
+
+// use a handle range on this thread until destroyed
+struct handle_range_scope
+{
+  ::kwiver::track_oracle::handle_range_type old_range;
+  explicit handle_range_scope( const ::kwiver::track_oracle::handle_range_type& r )
+    : old_range( ::kwiver::track_oracle::track_oracle_core::set_handle_range( r ))
+  {}
+  ~handle_range_scope()
+  {
+    ::kwiver::track_oracle::track_oracle_core::set_handle_range( this->old_range );
+  }
+};
 };
 
 namespace kwiver {
@@ -86,6 +110,9 @@ struct file_format_manager_impl
   // get a pointer to the format
   file_format_base* get_format( file_format_enum fmt ) const;
 
+  // detect the format and read the tracks, without recording the source
+  bool read_tracks( const string& fn, track_handle_list_type& tracks, file_format_enum& fmt );
+
   file_format_manager_impl();
   ~file_format_manager_impl();
 };
@@ -161,8 +188,9 @@ file_format_enum
 file_format_manager_impl
 ::detect_format( const string& fn )
 {
-  std::lock_guard< std::mutex > lock( this->api_lock );
-
+  // The format map is fixed after construction, so no lock is held
+  // here; files may be inspected concurrently when batch loading.
+  //
   // the assumption here is that multiple formats may match a glob,
   // but only one should pass inspection.  Add a check to verify this.
   // If it ends up that multiple files pass inspection, we may need
@@ -244,6 +272,38 @@ ::get_format( file_format_enum fmt ) const
     : probe->second;
 }
 
+bool
+file_format_manager_impl
+::read_tracks( const string& fn, track_handle_list_type& tracks, file_format_enum& fmt )
+{
+  fmt = TF_INVALID_TYPE;
+  {
+    ifstream is_check( fn.c_str() );
+    if ( ! is_check )
+    {
+      LOG_ERROR( main_logger, "FileFormatManager: File not found: '" << fn << "'" );
+      return false;
+    }
+  }
+  if ( vul_file::size( fn ) == 0)
+  {
+    LOG_WARN( main_logger, "File '" << fn << "' is empty" );
+    return true;
+  }
+
+  fmt = this->detect_format( fn );
+  if (fmt == TF_INVALID_TYPE) return false;
+
+  file_format_base* b = this->get_format( fmt );
+  if (! b)
+  {
+    LOG_ERROR( main_logger, "Logic error: no reader for format " << fmt << " for '" << fn << "'?");
+    return false;
+  }
+
+  return b->read( fn, tracks );
+}
+
 file_format_manager_impl
 ::~file_format_manager_impl()
 {
@@ -347,34 +407,122 @@ bool
 file_format_manager
 ::read( const string& fn, track_handle_list_type& tracks )
 {
+  file_format_enum f = TF_INVALID_TYPE;
+  bool rc = get_instance().read_tracks( fn, tracks, f );
+  if (rc && (f != TF_INVALID_TYPE))
   {
-    ifstream is_check( fn.c_str() );
-    if ( ! is_check )
+    file_format_schema_type::record_track_source( tracks, fn, f );
+  }
+  return rc;
+}
+
+bool
+file_format_manager
+::read_files( const vector< string >& patterns,
+              vector< string >& filenames,
+              vector< track_handle_list_type >& tracks )
+{
+  // expand the globs, sorting each expansion so the order is repeatable
+  filenames.clear();
+  for (size_t i=0; i<patterns.size(); ++i)
+  {
+    const string& p = patterns[i];
+    if ( p.find_first_of( "*?[" ) == string::npos )
     {
-      LOG_ERROR( main_logger, "FileFormatManager: File not found: '" << fn << "'" );
-      return false;
+      filenames.push_back( p );
+      continue;
+    }
+    vector< string > matches;
+    for (vul_file_iterator fi( p ); fi; ++fi)
+    {
+      if ( ! vul_file::is_directory( fi() ))
+      {
+        matches.push_back( fi() );
+      }
     }
+    if ( matches.empty() )
+    {
+      LOG_WARN( main_logger, "FileFormatManager: no files match '" << p << "'" );
+    }
+    std::sort( matches.begin(), matches.end() );
+    filenames.insert( filenames.end(), matches.begin(), matches.end() );
   }
-  if ( vul_file::size( fn ) == 0)
+
+  size_t n = filenames.size();
+  tracks.assign( n, track_handle_list_type() );
+  vector< char > read_okay( n, 0 );
+  vector< file_format_enum > formats( n, TF_INVALID_TYPE );
+
+  // Reserve each file's handles in file order, so each reader gets the
+  // handles it would get reading alone, whatever order the threads run.
+  vector< handle_range_type > ranges( n );
+  for (size_t i=0; i<n; ++i)
   {
-    LOG_WARN( main_logger, "File '" << fn << "' is empty" );
-    return true;
+    size_t n_bytes = vul_file::exists( filenames[i] ) ? vul_file::size( filenames[i] ) : 0;
+    ranges[i] = track_oracle_core::reserve_handles(
+      static_cast< size_t >( n_bytes * batch_handles_per_byte ) + 1 );
+  }
+
+  // Parse each file on the thread pool into its own track list.  The
+  // oracle creates columns safely across threads, and the formats keep
+  // no per-read state, so the readers share nothing else.
+  file_format_manager_impl& ffm = get_instance();
+  vector< std::future< void > > jobs;
+  jobs.reserve( n );
+  for (size_t i=0; i<n; ++i)
+  {
+    jobs.push_back( kwiver::vital::thread_pool::instance().enqueue(
+      [&, i]()
+      {
+        handle_range_scope scope( ranges[i] );
+        read_okay[i] = ffm.read_tracks( filenames[i], tracks[i], formats[i] );
+      } ));
   }
 
-  file_format_enum f = get_instance().detect_format( fn );
-  if (f == TF_INVALID_TYPE) return false;
+  // wait for every job before rethrowing, since they use our locals
+  std::exception_ptr first_error;
+  for (size_t i=0; i<n; ++i)
+  {
+    try
+    {
+      jobs[i].get();
+    }
+    catch (...)
+    {
+      if ( ! first_error ) first_error = std::current_exception();
+    }
+  }
+  if ( first_error ) std::rethrow_exception( first_error );
 
-  file_format_base* b = get_instance().get_format( f );
-  if (! b)
+  // Merge: the source file bookkeeping isn't thread safe, so record it
+  // here in file order, giving the same source ids as sequential reads.
+  bool all_okay = true;
+  for (size_t i=0; i<n; ++i)
   {
-    LOG_ERROR( main_logger, "Logic error: no reader for format " << f << " for '" << fn << "'?");
-    return false;
+    if ( ! read_okay[i] )
+    {
+      LOG_ERROR( main_logger, "FileFormatManager: couldn't read '" << filenames[i] << "'" );
+      all_okay = false;
+    }
+    else if ( formats[i] != TF_INVALID_TYPE )
+    {
+      file_format_schema_type::record_track_source( tracks[i], filenames[i], formats[i] );
+    }
   }
+  return all_okay;
+}
 
-  bool rc = b->read( fn, tracks );
-  if (rc)
+bool
+file_format_manager
+::read_files( const vector< string >& patterns,
+              track_handle_list_type& tracks )
+{
+  vector< string > filenames;
+  vector< track_handle_list_type > file_tracks;
+  bool rc = file_format_manager::read_files( patterns, filenames, file_tracks );
+  for (size_t i=0; i<file_tracks.size(); ++i)
   {
-    file_format_schema_type::record_track_source( tracks, fn, f );
+    tracks.insert( tracks.end(), file_tracks[i].begin(), file_tracks[i].end() );
   }
   return rc;
 }
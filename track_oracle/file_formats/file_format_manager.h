@@ -124,6 +124,22 @@ class TRACK_ORACLE_FILE_FORMATS_EXPORT file_format_manager
   // stored in each of the file_format_base derived objects
   static bool read( const std::string& fn, track_handle_list_type& tracks );
 
+  // Read the tracks from many files concurrently on the vital thread pool,
+  // using the current state of the options as in read().  Each pattern is
+  // a filename or a glob (e.g. "gt/*.kw18"); filenames receives the
+  // expanded list, and tracks[i] the tracks read from filenames[i].
+  // Each file is read into its own range of handles, reserved in file
+  // order, so the handles don't depend on thread timing, and source files
+  // are recorded in file order.  Returns false if any file couldn't be
+  // read; the tracks from the others are still loaded.
+  static bool read_files( const std::vector< std::string >& patterns,
+                          std::vector< std::string >& filenames,
+                          std::vector< track_handle_list_type >& tracks );
+
+  // as above, appending all the tracks in file order
+  static bool read_files( const std::vector< std::string >& patterns,
+                          track_handle_list_type& tracks );
+
   // write the tracks to the file.  If explicit_format is not TF_INVALID_TYPE,
   // use that format regardless of filename; if it is TF_INVALID_TYPE, deduce the
   // format from the filename (failing unless we get exactly one matching format.)
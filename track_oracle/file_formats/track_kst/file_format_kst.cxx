@@ -371,7 +371,8 @@ void
 parse_kst_node( istream& is,
                 kst_node* this_node )
 {
-  static unsigned int depth = 0;
+  // per thread, since files may be read concurrently
+  thread_local unsigned int depth = 0;
   string dbg_spacing;
   for (unsigned i=0; i<depth; ++i) dbg_spacing += "..";
   while (is.good())
@@ -251,7 +251,7 @@ extract_viper_frame_data( const named_nodes_t& named_nodes,
                           ::kwiver::track_oracle::track_handle_type& this_track,
                           map< unsigned int, ::kwiver::track_oracle::frame_handle_type>& xgtf_frame_map )
 {
-  static ::kwiver::track_oracle::track_xgtf_type xgtf_schema;
+  ::kwiver::track_oracle::track_xgtf_type xgtf_schema;
   xgtf_frame_map.clear();
 
   // first, pull the bounding boxes from "Location"
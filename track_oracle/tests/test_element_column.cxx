@@ -0,0 +1,221 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Test the paged column storage
+ */
+
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <track_oracle/core/element_column.h>
+
+namespace to = ::kwiver::track_oracle;
+
+using std::string;
+using std::vector;
+
+namespace { //anon
+
+// rows per page of element_column
+const to::oracle_entry_handle_type page_size = 1024;
+
+typedef vector< std::pair< to::oracle_entry_handle_type, int > > row_list;
+
+row_list
+all_rows( const to::element_column< int >& c )
+{
+  row_list rows;
+  c.for_each( [&rows]( to::oracle_entry_handle_type h, int v )
+              {
+                rows.push_back( std::make_pair( h, v ));
+                return true;
+              } );
+  return rows;
+}
+
+} // ...anon
+
+// ----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
+
+// ------------------------------------------------------------------
+TEST(element_column, set_get_erase)
+{
+  to::element_column< string > c;
+  EXPECT_EQ( 0, c.size() );
+  EXPECT_EQ( nullptr, c.find( 5 ));
+
+  // get_or_create only uses the default for rows without a value
+  EXPECT_EQ( "a", c.get_or_create( 5, "a" ));
+  EXPECT_EQ( "a", c.get_or_create( 5, "b" ));
+  EXPECT_EQ( 1, c.size() );
+
+  c.set( 5, "c" );
+  c.set( 3 * page_size + 1, "d" );
+  EXPECT_EQ( 2, c.size() );
+  ASSERT_NE( nullptr, c.find( 5 ));
+  EXPECT_EQ( "c", *c.find( 5 ));
+  ASSERT_NE( nullptr, c.find( 3 * page_size + 1 ));
+  EXPECT_EQ( "d", *c.find( 3 * page_size + 1 ));
+
+  // rows in an unallocated page, and past the last page, are unset
+  EXPECT_EQ( nullptr, c.find( page_size ));
+  EXPECT_EQ( nullptr, c.find( 100 * page_size ));
+
+  EXPECT_TRUE( c.erase( 5 ));
+  EXPECT_FALSE( c.erase( 5 ));
+  EXPECT_FALSE( c.erase( 6 ));
+  EXPECT_FALSE( c.erase( 100 * page_size ));
+  EXPECT_EQ( nullptr, c.find( 5 ));
+  EXPECT_EQ( 1, c.size() );
+
+  // a row can be set again after being erased
+  EXPECT_EQ( "e", c.get_or_create( 5, "e" ));
+  EXPECT_EQ( 2, c.size() );
+}
+
+// ------------------------------------------------------------------
+TEST(element_column, page_release_keeps_references)
+{
+  to::element_column< vector< int > > c;
+  vector< int >& first = c.get_or_create( 1, vector< int >( 3, 7 ));
+  const vector< int >* first_addr = &first;
+
+  // fill and release a second page, and grow the page table well past it
+  c.set( page_size + 2, vector< int >( 1, 1 ));
+  EXPECT_TRUE( c.erase( page_size + 2 ));
+  EXPECT_EQ( nullptr, c.find( page_size + 2 ));
+  for (to::oracle_entry_handle_type p=2; p<64; ++p)
+  {
+    c.set( p * page_size, vector< int >( 1, static_cast< int >( p )));
+  }
+
+  // erasing a neighbour in the same page leaves the page in place
+  c.set( 2, vector< int >( 2, 2 ));
+  EXPECT_TRUE( c.erase( 2 ));
+
+  EXPECT_EQ( first_addr, c.find( 1 ));
+  ASSERT_EQ( 3, first.size() );
+  EXPECT_EQ( 7, first[2] );
+  first.push_back( 8 );
+  EXPECT_EQ( 4, c.find( 1 )->size() );
+
+  // releasing and re-creating the first page only affects its own rows
+  EXPECT_TRUE( c.erase( 1 ));
+  EXPECT_EQ( nullptr, c.find( 1 ));
+  EXPECT_EQ( 63 - 1, c.size() );
+  ASSERT_NE( nullptr, c.find( 63 * page_size ));
+  EXPECT_EQ( 63, c.find( 63 * page_size )->front() );
+}
+
+// ------------------------------------------------------------------
+TEST(element_column, overflow_handles)
+{
+  to::element_column< int > c;
+  const to::oracle_entry_handle_type large =
+    to::INVALID_ROW_HANDLE / 2;
+
+  c.set( to::INVALID_ROW_HANDLE, -1 );
+  c.set( large, 4 );
+  c.set( 3, 3 );
+  EXPECT_EQ( 3, c.size() );
+  ASSERT_NE( nullptr, c.find( to::INVALID_ROW_HANDLE ));
+  EXPECT_EQ( -1, *c.find( to::INVALID_ROW_HANDLE ));
+  EXPECT_EQ( -1, c.get_or_create( to::INVALID_ROW_HANDLE, 0 ));
+  ASSERT_NE( nullptr, c.find( large ));
+  EXPECT_EQ( 4, *c.find( large ));
+  EXPECT_EQ( nullptr, c.find( large + 1 ));
+
+  EXPECT_TRUE( c.erase( to::INVALID_ROW_HANDLE ));
+  EXPECT_FALSE( c.erase( to::INVALID_ROW_HANDLE ));
+  EXPECT_EQ( nullptr, c.find( to::INVALID_ROW_HANDLE ));
+  EXPECT_EQ( 2, c.size() );
+}
+
+// ------------------------------------------------------------------
+TEST(element_column, for_each_order)
+{
+  to::element_column< int > c;
+  const to::oracle_entry_handle_type large =
+    to::INVALID_ROW_HANDLE / 2;
+
+  // set out of order, across pages and in the overflow map
+  c.set( to::INVALID_ROW_HANDLE, 6 );
+  c.set( 5 * page_size + 3, 4 );
+  c.set( large, 5 );
+  c.set( 7, 1 );
+  c.set( page_size, 3 );
+  c.set( page_size - 1, 2 );
+  c.set( 0, 0 );
+
+  row_list expected;
+  expected.push_back( std::make_pair( to::oracle_entry_handle_type( 0 ), 0 ));
+  expected.push_back( std::make_pair( to::oracle_entry_handle_type( 7 ), 1 ));
+  expected.push_back( std::make_pair( page_size - 1, 2 ));
+  expected.push_back( std::make_pair( page_size, 3 ));
+  expected.push_back( std::make_pair( 5 * page_size + 3, 4 ));
+  expected.push_back( std::make_pair( large, 5 ));
+  expected.push_back( std::make_pair( to::INVALID_ROW_HANDLE, 6 ));
+  EXPECT_EQ( expected, all_rows( c ));
+
+  // stopping early
+  size_t n = 0;
+  EXPECT_FALSE( c.for_each( [&n]( to::oracle_entry_handle_type, int v )
+                            {
+                              ++n;
+                              return v < 2;
+                            } ));
+  EXPECT_EQ( 3, n );
+}
+
+// ------------------------------------------------------------------
+TEST(element_column, concurrent_columns)
+{
+  // columns are independent, so each may be used by its own thread
+  const size_t n_threads = 4;
+  const int n_rows = 20000;
+  vector< to::element_column< int > > columns( n_threads );
+  vector< std::thread > threads;
+  for (size_t t=0; t<n_threads; ++t)
+  {
+    threads.push_back( std::thread( [&columns, t, n_rows]()
+      {
+        to::element_column< int >& c = columns[t];
+        for (int i=0; i<n_rows; ++i)
+        {
+          c.set( static_cast< to::oracle_entry_handle_type >( i ),
+                 i * static_cast< int >( t + 1 ));
+        }
+        for (int i=0; i<n_rows; i+=2)
+        {
+          c.erase( static_cast< to::oracle_entry_handle_type >( i ));
+        }
+      } ));
+  }
+  for (size_t t=0; t<n_threads; ++t)
+  {
+    threads[t].join();
+  }
+
+  for (size_t t=0; t<n_threads; ++t)
+  {
+    const to::element_column< int >& c = columns[t];
+    EXPECT_EQ( n_rows / 2, c.size() );
+    EXPECT_EQ( nullptr, c.find( 0 ));
+    ASSERT_NE( nullptr, c.find( 1 ));
+    EXPECT_EQ( static_cast< int >( t + 1 ), *c.find( 1 ));
+    ASSERT_NE( nullptr, c.find( n_rows - 1 ));
+    EXPECT_EQ( ( n_rows - 1 ) * static_cast< int >( t + 1 ), *c.find( n_rows - 1 ));
+  }
+}
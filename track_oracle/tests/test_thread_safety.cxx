@@ -7,6 +7,7 @@
  * \brief Test thread safety
  */
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <thread>
@@ -20,6 +21,7 @@
 
 #include <track_oracle/core/track_oracle_core.h>
 #include <track_oracle/core/track_base.h>
+#include <track_oracle/core/track_field.h>
 #include <track_oracle/data_terms/data_terms.h>
 #include <track_oracle/file_formats/file_format_manager.h>
 
@@ -97,6 +99,33 @@ load_test_tracks( const string& tag, const string& fn, const track_stats& refere
   reference.compare( s, tag );
 }
 
+//
+// the rows of each track and its frames, in order, relative to the
+// lowest of those rows
+//
+
+vector< to::oracle_entry_handle_type >
+handle_layout( const to::track_handle_list_type& tracks )
+{
+  vector< to::oracle_entry_handle_type > layout;
+  for (size_t i=0; i<tracks.size(); ++i)
+  {
+    layout.push_back( tracks[i].row );
+    auto frames = to::track_oracle_core::get_frames( tracks[i] );
+    for (size_t j=0; j<frames.size(); ++j)
+    {
+      layout.push_back( frames[j].row );
+    }
+  }
+  if ( layout.empty() ) return layout;
+  to::oracle_entry_handle_type base = *std::min_element( layout.begin(), layout.end() );
+  for (size_t i=0; i<layout.size(); ++i)
+  {
+    layout[i] -= base;
+  }
+  return layout;
+}
+
 }; // ...anon
 
 // ----------------------------------------------------------------------------
@@ -152,3 +181,169 @@ TEST( track_oracle, track_oracle_threadsafe )
     }
   } // ...for up to max_threads
 }
+
+TEST( track_oracle, concurrent_field_access )
+{
+  // rows read throughout while the writers run
+  to::track_field< int > value( "concurrent_value" );
+  const int n_fixed = 5000;
+  vector< to::oracle_entry_handle_type > fixed_rows;
+  for (int i=0; i<n_fixed; ++i)
+  {
+    fixed_rows.push_back( to::track_oracle_core::get_next_handle() );
+    value( fixed_rows.back() ) = i;
+  }
+
+  // writers allocate rows, fill a shared column and a per-thread column
+  // (created while the others run), and attach frames; readers check the
+  // fixed rows and count the writers' rows they can see
+  const size_t n_writers = 4;
+  const size_t n_readers = 2;
+  const int n_tracks = 2000;
+  vector< to::track_handle_list_type > written( n_writers );
+  vector< size_t > errors( n_readers, 0 );
+  vector< thread > threads;
+  for (size_t w=0; w<n_writers; ++w)
+  {
+    threads.push_back( thread( [&value, &written, w, n_tracks]()
+      {
+        ostringstream oss;
+        oss << "concurrent_writer_" << w;
+        to::track_field< int > own( oss.str() );
+        for (int i=0; i<n_tracks; ++i)
+        {
+          to::track_handle_type t( to::track_oracle_core::get_next_handle() );
+          to::frame_handle_type f( to::track_oracle_core::get_next_handle() );
+          value( t.row ) = i;
+          value( f.row ) = -i;
+          own( t.row ) = static_cast< int >( w );
+          to::track_oracle_core::set_frames( t, to::frame_handle_list_type( 1, f ));
+          written[w].push_back( t );
+        }
+      } ));
+  }
+  for (size_t r=0; r<n_readers; ++r)
+  {
+    threads.push_back( thread( [&value, &fixed_rows, &errors, r]()
+      {
+        for (int pass=0; pass<10; ++pass)
+        {
+          for (size_t i=0; i<fixed_rows.size(); ++i)
+          {
+            std::pair< bool, int > p = value.get( fixed_rows[i] );
+            if ( ( ! p.first ) || ( p.second != static_cast< int >( i )))
+            {
+              ++errors[r];
+            }
+          }
+        }
+      } ));
+  }
+  for (auto& t: threads)
+  {
+    t.join();
+  }
+
+  for (size_t r=0; r<n_readers; ++r)
+  {
+    EXPECT_EQ( 0, errors[r] ) << " reader " << r;
+  }
+
+  // every row was handed out once and holds what its writer set
+  vector< to::oracle_entry_handle_type > rows( fixed_rows );
+  for (size_t w=0; w<n_writers; ++w)
+  {
+    ostringstream oss;
+    oss << "concurrent_writer_" << w;
+    to::track_field< int > own( oss.str() );
+    ASSERT_EQ( n_tracks, written[w].size() );
+    for (int i=0; i<n_tracks; ++i)
+    {
+      const to::track_handle_type& t = written[w][i];
+      auto frames = to::track_oracle_core::get_frames( t );
+      ASSERT_EQ( 1, frames.size() ) << " writer " << w << " track " << i;
+      EXPECT_EQ( i, value( t.row ));
+      EXPECT_EQ( -i, value( frames[0].row ));
+      EXPECT_EQ( static_cast< int >( w ), own( t.row ));
+      rows.push_back( t.row );
+      rows.push_back( frames[0].row );
+    }
+  }
+  std::sort( rows.begin(), rows.end() );
+  EXPECT_TRUE( std::adjacent_find( rows.begin(), rows.end() ) == rows.end() );
+}
+
+TEST( track_oracle, read_files_batch )
+{
+  string track_file = g_data_dir+"/generic_tracks.kw18";
+  track_stats reference;
+  vector< to::oracle_entry_handle_type > reference_layout;
+  {
+    to::track_handle_list_type tracks;
+    bool rc = to::file_format_manager::read( track_file, tracks );
+    EXPECT_TRUE( rc ) << " reading from '" << track_file << "'";
+    reference.set( tracks );
+    reference_layout = handle_layout( tracks );
+  }
+
+  // the same file several times, once through a glob
+  vector< string > patterns( 3, track_file );
+  patterns.push_back( g_data_dir+"/generic_tracks.kw1?" );
+
+  vector< string > filenames;
+  vector< to::track_handle_list_type > tracks;
+  bool rc = to::file_format_manager::read_files( patterns, filenames, tracks );
+  EXPECT_TRUE( rc ) << " batch reading from '" << track_file << "'";
+  ASSERT_EQ( patterns.size(), filenames.size() );
+  ASSERT_EQ( patterns.size(), tracks.size() );
+
+  // each file is laid out as when read alone, after the previous file
+  to::oracle_entry_handle_type last_row = 0;
+  for (size_t i=0; i<tracks.size(); ++i)
+  {
+    ostringstream oss;
+    oss << "Batch file " << i;
+    reference.compare( track_stats( tracks[i] ), oss.str() );
+    EXPECT_EQ( reference_layout, handle_layout( tracks[i] )) << oss.str();
+
+    vector< to::oracle_entry_handle_type > rows;
+    for (const auto& t: tracks[i])
+    {
+      rows.push_back( t.row );
+      for (const auto& f: to::track_oracle_core::get_frames( t ))
+      {
+        rows.push_back( f.row );
+      }
+    }
+    ASSERT_FALSE( rows.empty() );
+    EXPECT_LT( last_row, *std::min_element( rows.begin(), rows.end() )) << oss.str();
+    last_row = *std::max_element( rows.begin(), rows.end() );
+  }
+
+  // every batch track has its own handle, and a second batch lays out
+  // its handles the same way
+  to::track_handle_list_type all_tracks;
+  EXPECT_TRUE( to::file_format_manager::read_files( patterns, all_tracks ));
+  EXPECT_EQ( patterns.size() * reference.n_tracks, all_tracks.size() );
+  for (size_t i=0; i<patterns.size(); ++i)
+  {
+    to::track_handle_list_type file_tracks(
+      all_tracks.begin() + i * reference.n_tracks,
+      all_tracks.begin() + ( i+1 ) * reference.n_tracks );
+    EXPECT_EQ( reference_layout, handle_layout( file_tracks )) << " second batch file " << i;
+  }
+  vector< to::oracle_entry_handle_type > rows;
+  for (const auto& t: all_tracks)
+  {
+    rows.push_back( t.row );
+  }
+  std::sort( rows.begin(), rows.end() );
+  EXPECT_TRUE( std::adjacent_find( rows.begin(), rows.end() ) == rows.end() );
+
+  // a missing file fails the batch but not the other files
+  patterns.push_back( g_data_dir+"/no_such_tracks.kw18" );
+  EXPECT_FALSE( to::file_format_manager::read_files( patterns, filenames, tracks ));
+  ASSERT_EQ( patterns.size(), tracks.size() );
+  EXPECT_EQ( reference.n_tracks, tracks[0].size() );
+  EXPECT_TRUE( tracks.back().empty() );
+}
@@ -26,6 +26,14 @@ ::data_serializer()
   attach_logger( "data_serializer" );
 }
 
+// ----------------------------------------------------------------------------
+void
+data_serializer
+::serialize_to( const vital::any& element, std::string& out )
+{
+  out.append( *serialize( element ) );
+}
+
 } } }
 
 /// \cond DoxygenSuppress
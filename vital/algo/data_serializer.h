@@ -77,6 +77,24 @@ class VITAL_ALGO_EXPORT data_serializer
    */
   virtual std::shared_ptr< std::string > serialize( const vital::any& element ) = 0;
 
+  /// Serialize the item onto the end of a byte string.
+  /**
+   * This method appends the bytes \c serialize() would return to \p
+   * out, leaving what is already there untouched. Callers assembling
+   * a larger message can serialize each item straight into it.
+   *
+   * The default implementation appends a copy of the string returned
+   * by \c serialize(). Implementations which produce large messages
+   * should override it to write into \p out directly.
+   *
+   * @param element Data item to be serialized.
+   * @param out Byte string the serialized data item is appended to.
+   *
+   * @throws kwiver::vital::bad_any_cast
+   * @throws kwiver::vital::serialization - for unexpected element name
+   */
+  virtual void serialize_to( const vital::any& element, std::string& out );
+
   /// Deserialize byte string into data type.
   /**
    * Deserialize the supplied string of bytes into new data
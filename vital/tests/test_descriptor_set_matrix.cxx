@@ -0,0 +1,150 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Tests for descriptor_matrix_set.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vital/types/descriptor_matrix_set.h>
+
+#include <cstdint>
+
+using namespace kwiver::vital;
+
+// ----------------------------------------------------------------------------
+int
+main( int argc, char* argv[] )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
+
+// ----------------------------------------------------------------------------
+TEST( descriptor_set_matrix, construct_default )
+{
+  descriptor_matrix_set< float > ds;
+  EXPECT_TRUE( ds.empty() );
+  EXPECT_EQ( 0, ds.size() );
+
+  int i = 0;
+  for( descriptor_sptr const d : ds )
+  {
+    ++i;
+  }
+  EXPECT_EQ( 0, i );
+}
+
+// ----------------------------------------------------------------------------
+TEST( descriptor_set_matrix, aligned_rows )
+{
+  descriptor_matrix_set< uint8_t > ds( 5, 32 );
+  EXPECT_EQ( 5, ds.rows() );
+  EXPECT_EQ( 32, ds.cols() );
+  EXPECT_EQ( 0, ds.stride() % image_memory::alignment );
+
+  for( size_t r = 0; r < ds.rows(); ++r )
+  {
+    auto const addr = reinterpret_cast< std::uintptr_t >( ds.row( r ) );
+    EXPECT_EQ( 0, addr % image_memory::alignment );
+  }
+
+  descriptor_matrix_set< double > dd( 3, 9 );
+  EXPECT_EQ( 16, dd.stride() );
+  EXPECT_EQ( dd.data() + 32, dd.row( 2 ) );
+}
+
+// ----------------------------------------------------------------------------
+TEST( descriptor_set_matrix, from_descriptors )
+{
+  std::vector< descriptor_sptr > dsptr_vec;
+  for( int i = 0; i < 4; ++i )
+  {
+    auto d = std::make_shared< descriptor_dynamic< int > >( 3 );
+    for( int j = 0; j < 3; ++j )
+    {
+      d->raw_data()[j] = 10 * i + j;
+    }
+    d->set_node_id( i );
+    dsptr_vec.push_back( d );
+  }
+
+  descriptor_matrix_set< int > ds( dsptr_vec );
+  ASSERT_EQ( 4, ds.size() );
+  ASSERT_EQ( 3, ds.cols() );
+
+  for( size_t i = 0; i < ds.size(); ++i )
+  {
+    EXPECT_EQ( 10 * static_cast< int >( i ) + 2, ds.row( i )[2] );
+    EXPECT_TRUE( *dsptr_vec[i] == *ds.at( i ) );
+    EXPECT_EQ( i, ds.at( i )->node_id() );
+  }
+
+  // Descriptors of the wrong type are rejected
+  dsptr_vec.push_back( std::make_shared< descriptor_dynamic< float > >( 3 ) );
+  EXPECT_THROW( descriptor_matrix_set< int >{ dsptr_vec }, invalid_value );
+}
+
+// ----------------------------------------------------------------------------
+TEST( descriptor_set_matrix, rows_share_storage )
+{
+  descriptor_sptr d;
+  {
+    descriptor_matrix_set< float > ds( 2, 4 );
+    std::fill( ds.row( 0 ), ds.row( 0 ) + 4, 1.0f );
+    std::fill( ds.row( 1 ), ds.row( 1 ) + 4, 2.0f );
+
+    d = ds.at( 1 );
+    auto row = std::dynamic_pointer_cast< descriptor_array_of< float > >( d );
+    ASSERT_TRUE( row );
+    EXPECT_EQ( ds.row( 1 ), row->raw_data() );
+
+    row->raw_data()[3] = 5.0f;
+    EXPECT_EQ( 5.0f, ds.row( 1 )[3] );
+
+    d->set_node_id( 7 );
+    EXPECT_EQ( 7, ds.at( 1 )->node_id() );
+
+    // Rows are created once and then reused
+    EXPECT_EQ( d.get(), ds.at( 1 ).get() );
+    EXPECT_EQ( d.get(), ds.descriptors()[1].get() );
+
+    EXPECT_THROW( ds.at( 2 ), std::out_of_range );
+  }
+
+  // The row remains valid after the set is gone
+  auto const values = d->as_double();
+  ASSERT_EQ( 4, values.size() );
+  EXPECT_EQ( 2.0, values[0] );
+  EXPECT_EQ( 5.0, values[3] );
+
+  // Clones own their data
+  auto c = d->clone();
+  EXPECT_TRUE( *d == *c );
+  EXPECT_NE( d->as_bytes(), c->as_bytes() );
+}
+
+// ----------------------------------------------------------------------------
+TEST( descriptor_set_matrix, range_based_loop )
+{
+  descriptor_matrix_set< int > ds( 3, 2 );
+  for( size_t i = 0; i < 3; ++i )
+  {
+    ds.row( i )[0] = static_cast< int >( i );
+    ds.row( i )[1] = static_cast< int >( i );
+  }
+
+  size_t i = 0;
+  for( descriptor_sptr const d : ds )
+  {
+    EXPECT_EQ( d->size(), 2 );
+    EXPECT_EQ( d->as_double()[0], i );
+    EXPECT_EQ( d->as_double()[1], i );
+    ++i;
+  }
+  EXPECT_EQ( i, 3 );
+  EXPECT_EQ( 3, ds.descriptors().size() );
+}
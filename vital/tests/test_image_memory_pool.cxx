@@ -0,0 +1,175 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief image_memory_pool tests
+ */
+
+#include <vital/types/image_memory_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+using namespace kwiver::vital;
+
+// ----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
+
+namespace // anonymous
+{
+
+bool
+is_aligned( void const* p )
+{
+  return reinterpret_cast< uintptr_t >( p ) % image_memory::alignment == 0;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+TEST(image_memory_pool, alignment)
+{
+  for ( size_t n : { 1, 3, 63, 64, 65, 1000 } )
+  {
+    image_memory mem{ n };
+    EXPECT_TRUE( is_aligned( mem.data() ) ) << "Size " << n;
+
+    image_memory copy{ mem };
+    EXPECT_TRUE( is_aligned( copy.data() ) ) << "Size " << n;
+  }
+
+  image_memory_pool pool;
+  EXPECT_TRUE( is_aligned( pool.allocate( 17 )->data() ) );
+}
+
+// ----------------------------------------------------------------------------
+TEST(image_memory_pool, reuse)
+{
+  image_memory_pool pool;
+
+  void* first = nullptr;
+  {
+    auto const mem = pool.allocate( 1024 );
+    EXPECT_EQ( 1024, mem->size() );
+    first = mem->data();
+  }
+  EXPECT_EQ( 1024, pool.cached_bytes() );
+
+  // Steady state: every request after the first is served from the pool
+  for ( int i = 0; i < 10; ++i )
+  {
+    auto const mem = pool.allocate( 1024 );
+    EXPECT_EQ( first, mem->data() );
+    EXPECT_EQ( 0, pool.cached_bytes() );
+  }
+  EXPECT_EQ( 1, pool.allocation_count() );
+
+  // A different size needs a new buffer
+  auto const other = pool.allocate( 2048 );
+  EXPECT_EQ( 2, pool.allocation_count() );
+
+  // Buffers in use are never handed out twice
+  auto const a = pool.allocate( 1024 );
+  auto const b = pool.allocate( 1024 );
+  EXPECT_NE( a->data(), b->data() );
+  EXPECT_EQ( 3, pool.allocation_count() );
+}
+
+// ----------------------------------------------------------------------------
+TEST(image_memory_pool, max_cached_bytes)
+{
+  image_memory_pool pool{ 3000 };
+
+  {
+    auto const a = pool.allocate( 1000 );
+    auto const b = pool.allocate( 1000 );
+    auto const c = pool.allocate( 2000 );
+  }
+  EXPECT_LE( pool.cached_bytes(), 3000 );
+  EXPECT_GE( pool.cached_bytes(), 2000 );
+
+  pool.set_max_cached_bytes( 1000 );
+  EXPECT_LE( pool.cached_bytes(), 1000 );
+
+  pool.clear();
+  EXPECT_EQ( 0, pool.cached_bytes() );
+}
+
+// ----------------------------------------------------------------------------
+TEST(image_memory_pool, outlive_pool)
+{
+  image_memory_sptr mem;
+  {
+    image_memory_pool pool;
+    mem = pool.allocate( 100 );
+  }
+
+  // The memory must remain valid after the pool is gone
+  auto* const data = static_cast< byte* >( mem->data() );
+  data[0] = 1;
+  data[99] = 2;
+  mem.reset();
+}
+
+// ----------------------------------------------------------------------------
+TEST(image_memory_pool, copy_pooled_memory)
+{
+  image_memory_pool pool;
+  image_memory_sptr mem = pool.allocate( 100 );
+  auto* const data = static_cast< byte* >( mem->data() );
+  for ( size_t i = 0; i < 100; ++i )
+  {
+    data[i] = static_cast< byte >( i );
+  }
+
+  // Copies own their memory, and leave the pooled buffer alone
+  image_memory copy{ *mem };
+  ASSERT_EQ( 100, copy.size() );
+  EXPECT_NE( mem->data(), copy.data() );
+  EXPECT_EQ( 99, static_cast< byte* >( copy.data() )[99] );
+
+  image_memory assigned{ 10 };
+  assigned = *mem;
+  ASSERT_EQ( 100, assigned.size() );
+  EXPECT_NE( mem->data(), assigned.data() );
+  EXPECT_EQ( 42, static_cast< byte* >( assigned.data() )[42] );
+
+  // The buffer goes back to the pool, intact, exactly once
+  void* const first = mem->data();
+  mem.reset();
+  EXPECT_EQ( 100, pool.cached_bytes() );
+  auto const again = pool.allocate( 100 );
+  EXPECT_EQ( first, again->data() );
+  EXPECT_EQ( 99, static_cast< byte* >( again->data() )[99] );
+  EXPECT_EQ( 1, pool.allocation_count() );
+}
+
+// ----------------------------------------------------------------------------
+TEST(image_memory_pool, create_image)
+{
+  image_memory_pool pool;
+
+  image const planar =
+    pool.create_image( 20, 30, 3, false, image_pixel_traits_of< uint16_t >() );
+  EXPECT_EQ( 20, planar.width() );
+  EXPECT_EQ( 30, planar.height() );
+  EXPECT_EQ( 3, planar.depth() );
+  EXPECT_EQ( 1, planar.w_step() );
+  EXPECT_EQ( 20, planar.h_step() );
+  EXPECT_EQ( 20 * 30, planar.d_step() );
+  EXPECT_EQ( 20 * 30 * 3 * 2, planar.memory()->size() );
+  EXPECT_TRUE( planar.is_contiguous() );
+
+  image const interleaved = pool.create_image( 20, 30, 3, true );
+  EXPECT_EQ( 3, interleaved.w_step() );
+  EXPECT_EQ( 60, interleaved.h_step() );
+  EXPECT_EQ( 1, interleaved.d_step() );
+  EXPECT_TRUE( interleaved.is_contiguous() );
+}
@@ -0,0 +1,288 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief descriptor_set stored as a dense, row-major matrix
+ */
+
+#ifndef VITAL_DESCRIPTOR_MATRIX_SET_H_
+#define VITAL_DESCRIPTOR_MATRIX_SET_H_
+
+#include "descriptor_set.h"
+#include "image.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+namespace kwiver {
+namespace vital {
+
+// ------------------------------------------------------------------
+/// Storage shared by a descriptor_matrix_set and the rows it hands out
+struct descriptor_matrix_storage
+{
+  explicit descriptor_matrix_storage( size_t bytes, size_t rows )
+    : memory( bytes ),
+      node_ids( rows, std::numeric_limits< unsigned int >::max() ) { }
+
+  /// The matrix elements, allocated in one aligned block
+  image_memory memory;
+
+  /// The node id of each row
+  std::vector< unsigned int > node_ids;
+
+  /// Descriptors referring to each row, built once when first needed
+  std::vector< std::unique_ptr< descriptor > > row_views;
+  std::once_flag row_views_built;
+};
+
+// ------------------------------------------------------------------
+/// A descriptor which refers to one row of a descriptor_matrix_set
+/**
+ * Rows are owned by the matrix storage and handed out by shared pointers
+ * which share ownership of that storage, so a row stays valid after the
+ * set that produced it is destroyed.  Writing through raw_data() or
+ * set_node_id() modifies the matrix.
+ */
+template < typename T >
+class descriptor_matrix_row :
+  public descriptor_array_of< T >
+{
+public:
+  /// Constructor
+  descriptor_matrix_row( descriptor_matrix_storage* storage,
+                         T* data, size_t length, size_t row )
+    : storage_( storage ),
+      data_( data ),
+      length_( length ),
+      row_( row ) { }
+
+  /// The number of elements of the underlying type
+  std::size_t size() const { return length_; }
+
+  /// Return an pointer to the raw data array
+  T* raw_data() { return data_; }
+
+  /// Return an pointer to the raw data array
+  const T* raw_data() const { return data_; }
+
+  /// Return a copy of this descriptor which owns its data
+  virtual descriptor_sptr clone() const
+  {
+    auto ptr = std::make_shared< descriptor_dynamic< T > >( length_ );
+    std::copy( data_, data_ + length_, ptr->raw_data() );
+    ptr->set_node_id( this->node_id() );
+    return ptr;
+  }
+
+  virtual unsigned int node_id() const { return storage_->node_ids[ row_ ]; }
+  virtual bool set_node_id( unsigned int node_id )
+  {
+    storage_->node_ids[ row_ ] = node_id;
+    return true;
+  }
+
+protected:
+  descriptor_matrix_storage* storage_;
+  T* data_;
+  size_t length_;
+  size_t row_;
+};
+
+// ============================================================================
+/// A descriptor set stored as one dense, row-major matrix of type T
+/**
+ * All descriptors live in a single allocation.  Each row starts on a
+ * multiple of image_memory::alignment bytes, so matchers can use aligned
+ * vector loads on the pointer returned by row().  Algorithms which know
+ * about this class should use data(), row() and stride() directly.  The
+ * descriptor_sptr interface is still provided; the descriptors it returns
+ * refer to matrix rows rather than copying them.  They are created for
+ * every row on first use and reused after that, so handing one out does
+ * not allocate.
+ */
+template < typename T >
+class descriptor_matrix_set :
+  public descriptor_set
+{
+  static_assert( image_memory::alignment % sizeof( T ) == 0,
+                 "element size must divide the row alignment" );
+
+public:
+  /// Default Constructor
+  descriptor_matrix_set()
+    : rows_( 0 ), cols_( 0 ), stride_( 0 ), data_( nullptr ) { }
+
+  /// Constructor allocating an uninitialized \p rows x \p cols matrix
+  descriptor_matrix_set( size_t rows, size_t cols )
+  {
+    allocate( rows, cols );
+  }
+
+  /// Constructor copying a vector of descriptors
+  /**
+   * \throws invalid_value if a descriptor is null, does not hold elements
+   *         of type T, or differs in size from the first one.
+   */
+  explicit descriptor_matrix_set( std::vector< descriptor_sptr > const& desc )
+  {
+    allocate( desc.size(), ( desc.empty() || !desc[0] ) ? 0 : desc[0]->size() );
+    for( size_t i = 0; i < rows_; ++i )
+    {
+      auto const* d =
+        dynamic_cast< descriptor_array_of< T > const* >( desc[i].get() );
+      if( !d || d->size() != cols_ )
+      {
+        VITAL_THROW( invalid_value,
+                     "mismatch type or size when building descriptor matrix" );
+      }
+      std::copy( d->raw_data(), d->raw_data() + cols_, this->row( i ) );
+      storage_->node_ids[i] = d->node_id();
+    }
+  }
+
+  /// Get the number of descriptors in this set.
+  size_t size() const override { return rows_; }
+
+  /// Whether or not this set is empty.
+  bool empty() const override { return rows_ == 0; }
+
+  /// The number of descriptors (rows)
+  size_t rows() const { return rows_; }
+
+  /// The number of elements in each descriptor (columns)
+  size_t cols() const { return cols_; }
+
+  /// The number of elements between the starts of consecutive rows
+  size_t stride() const { return stride_; }
+
+  //@{
+  /// Return a pointer to the first element of the matrix
+  T* data() { return data_; }
+  T const* data() const { return data_; }
+  //@}
+
+  //@{
+  /// Return a pointer to the first element of row \p r
+  T* row( size_t r ) { return data_ + r * stride_; }
+  T const* row( size_t r ) const { return data_ + r * stride_; }
+  //@}
+
+  //@{
+  /**
+   * Return the descriptor at the specified index.
+   * @param index 0-based index to access.
+   * @return A descriptor referring to the matrix row at the specified index.
+   * @throws std::out_of_range If position is now within the range of objects
+   *                           in container.
+   */
+  descriptor_sptr at( size_t index ) override
+  {
+    check_index( index );
+    return make_row( index );
+  }
+  descriptor_sptr const at( size_t index ) const override
+  {
+    check_index( index );
+    return make_row( index );
+  }
+  //@}
+
+  /// Return a vector of descriptors referring to the matrix rows
+  std::vector< descriptor_sptr > descriptors() const override
+  {
+    std::vector< descriptor_sptr > desc;
+    desc.reserve( rows_ );
+    for( size_t i = 0; i < rows_; ++i )
+    {
+      desc.push_back( make_row( i ) );
+    }
+    return desc;
+  }
+
+protected:
+  /// Next value function for non-const iteration.
+  iterator::next_value_func_t get_iter_next_func() override
+  {
+    size_t row_counter = 0;
+    descriptor_sptr d_sptr;
+    return [row_counter, d_sptr, this] () mutable ->iterator::reference {
+      if( row_counter >= rows_ )
+      {
+        VITAL_THROW( stop_iteration_exception, "descriptor_set" );
+      }
+      d_sptr = make_row( row_counter++ );
+      return d_sptr;
+    };
+  }
+
+  /// Next value function for const iteration.
+  const_iterator::next_value_func_t get_const_iter_next_func() const override
+  {
+    size_t row_counter = 0;
+    descriptor_sptr d_sptr;
+    return [row_counter, d_sptr, this] () mutable ->const_iterator::reference {
+      if( row_counter >= rows_ )
+      {
+        VITAL_THROW( stop_iteration_exception, "descriptor_set" );
+      }
+      d_sptr = make_row( row_counter++ );
+      return d_sptr;
+    };
+  }
+
+private:
+  void allocate( size_t rows, size_t cols )
+  {
+    constexpr size_t align = image_memory::alignment;
+    size_t const row_bytes = ( cols * sizeof( T ) + align - 1 ) / align * align;
+    rows_ = rows;
+    cols_ = cols;
+    stride_ = row_bytes / sizeof( T );
+    storage_ = std::make_shared< descriptor_matrix_storage >( rows * row_bytes,
+                                                              rows );
+    data_ = static_cast< T* >( storage_->memory.data() );
+  }
+
+  void check_index( size_t index ) const
+  {
+    if( index >= rows_ )
+    {
+      std::stringstream ss;
+      ss << index;
+      throw std::out_of_range( ss.str() );
+    }
+  }
+
+  descriptor_sptr make_row( size_t r ) const
+  {
+    auto* const storage = storage_.get();
+    std::call_once( storage->row_views_built, [ this, storage ]() {
+      storage->row_views.reserve( rows_ );
+      for( size_t i = 0; i < rows_; ++i )
+      {
+        storage->row_views.emplace_back(
+          new descriptor_matrix_row< T >( storage, data_ + i * stride_,
+                                          cols_, i ) );
+      }
+    } );
+
+    // share ownership of the storage, which owns the row
+    return descriptor_sptr( storage_, storage->row_views[ r ].get() );
+  }
+
+  size_t rows_;
+  size_t cols_;
+  size_t stride_;
+  std::shared_ptr< descriptor_matrix_storage > storage_;
+  T* data_;
+};
+
+} } // end namespace vital
+
+#endif // VITAL_DESCRIPTOR_MATRIX_SET_H_
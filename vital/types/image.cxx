@@ -8,12 +8,53 @@
  */
 
 #include "image.h"
+#include <cstdint>
 #include <cstring>
 #include <utility>
 
 namespace kwiver {
 namespace vital {
 
+namespace {
+
+/// Allocate n bytes aligned to image_memory::alignment
+/**
+ * The address of the underlying block is stored just before the aligned
+ * address so that it can be recovered by aligned_free().
+ */
+void*
+aligned_allocate( size_t n )
+{
+  if ( n == 0 )
+  {
+    return 0;
+  }
+
+  size_t const a = image_memory::alignment;
+  char* const block = new char[n + a + sizeof( char* )];
+
+  uintptr_t const start = reinterpret_cast< uintptr_t >( block + sizeof( char* ) );
+  char* const aligned =
+    reinterpret_cast< char* >( ( start + a - 1 ) & ~static_cast< uintptr_t >( a - 1 ) );
+
+  reinterpret_cast< char** >( aligned )[-1] = block;
+  return aligned;
+}
+
+/// Free memory allocated by aligned_allocate()
+void
+aligned_free( void* p )
+{
+  if ( p )
+  {
+    delete [] reinterpret_cast< char** >( p )[-1];
+  }
+}
+
+} // end anonymous namespace
+
+constexpr size_t image_memory::alignment;
+
 template <typename T> VITAL_EXPORT
 image_pixel_traits::pixel_type const image_pixel_traits_of<T>::static_type;
 
@@ -81,7 +122,7 @@ ::image_memory()
 /// Constructor - allocated n bytes
 image_memory
 ::image_memory( size_t n )
-  : data_( new char[n] ),
+  : data_( aligned_allocate( n ) ),
     size_( n )
 {
 }
@@ -89,17 +130,18 @@ ::image_memory( size_t n )
 /// Copy Constructor
 image_memory
 ::image_memory( const image_memory& other )
-  : data_( new char[other.size()] ),
+  : data_( aligned_allocate( other.size() ) ),
     size_( other.size() )
 {
-  std::memcpy( data_, other.data_, size_ );
+  // other may be a derived class which keeps its memory elsewhere
+  std::memcpy( data_, const_cast< image_memory& >( other ).data(), size_ );
 }
 
 /// Destructor
 image_memory
 ::~image_memory()
 {
-  delete [] reinterpret_cast< char* > ( data_ );
+  aligned_free( data_ );
 }
 
 /// Assignment operator
@@ -114,16 +156,12 @@ ::operator=( const image_memory& other )
 
   if ( size_ != other.size_ )
   {
-    delete [] reinterpret_cast< char* > ( data_ );
-    data_ = 0;
-    if ( other.size_ > 0 )
-    {
-      data_ = new char[other.size_];
-    }
+    aligned_free( data_ );
+    data_ = aligned_allocate( other.size_ );
     size_ = other.size_;
   }
 
-  std::memcpy( data_, other.data_, size_ );
+  std::memcpy( data_, const_cast< image_memory& >( other ).data(), size_ );
   return *this;
 }
 
@@ -198,6 +198,13 @@ class VITAL_EXPORT image_memory
   /// The number of bytes allocated
   size_t size() const { return size_; }
 
+  /// The alignment, in bytes, of memory allocated by this class
+  /**
+   * This is large enough for any SIMD instruction set in use, so pixel
+   * rows which start on a multiple of it may use aligned loads.
+   */
+  static constexpr size_t alignment = 64;
+
 protected:
   /// The image data
   void* data_;
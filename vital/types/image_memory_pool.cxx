@@ -0,0 +1,239 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Implementation of a pool of recycled image memory
+ */
+
+#include "image_memory_pool.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace kwiver {
+namespace vital {
+
+constexpr size_t image_memory_pool::default_max_cached_bytes;
+
+// ---------------------------------------------------------------------------
+class image_memory_pool::priv
+{
+public:
+  using buffer_t = std::unique_ptr< image_memory >;
+
+  class memory;
+
+  explicit priv( size_t max_bytes )
+    : max_cached_bytes( max_bytes ),
+      cached_bytes( 0 ),
+      allocation_count( 0 )
+  {
+  }
+
+  buffer_t acquire( size_t n );
+  void release( buffer_t buffer );
+  void trim( size_t max_bytes );
+
+  mutable std::mutex mutex;
+  std::map< size_t, std::vector< buffer_t > > idle;
+  size_t max_cached_bytes;
+  size_t cached_bytes;
+  std::atomic< size_t > allocation_count;
+};
+
+// ---------------------------------------------------------------------------
+/// Image memory which returns its buffer to a pool when destroyed
+class image_memory_pool::priv::memory
+  : public image_memory
+{
+public:
+  memory( buffer_t&& buffer, std::shared_ptr< priv > const& pool )
+    : buffer_( std::move( buffer ) ),
+      pool_( pool )
+  {
+    // The buffer owns the memory, so the base class data_ stays null.
+    size_ = buffer_->size();
+  }
+
+  // The buffer belongs to the pool, so it can't be copied or reallocated.
+  memory( memory const& ) = delete;
+  memory& operator=( memory const& ) = delete;
+
+  ~memory()
+  {
+    if ( auto pool = pool_.lock() )
+    {
+      pool->release( std::move( buffer_ ) );
+    }
+  }
+
+  /// Return a pointer to the pooled memory
+  virtual void* data() { return buffer_->data(); }
+
+private:
+  buffer_t buffer_;
+  std::weak_ptr< priv > pool_;
+};
+
+// ---------------------------------------------------------------------------
+image_memory_pool::priv::buffer_t
+image_memory_pool::priv
+::acquire( size_t n )
+{
+  {
+    std::lock_guard< std::mutex > lock( mutex );
+
+    auto const i = idle.find( n );
+    if ( i != idle.end() && !i->second.empty() )
+    {
+      buffer_t buffer = std::move( i->second.back() );
+      i->second.pop_back();
+      cached_bytes -= n;
+      return buffer;
+    }
+  }
+
+  ++allocation_count;
+  return buffer_t( new image_memory( n ) );
+}
+
+// ---------------------------------------------------------------------------
+void
+image_memory_pool::priv
+::release( buffer_t buffer )
+{
+  size_t const n = buffer->size();
+
+  std::lock_guard< std::mutex > lock( mutex );
+
+  if ( cached_bytes + n > max_cached_bytes )
+  {
+    // Let the buffer be freed.
+    return;
+  }
+
+  idle[n].push_back( std::move( buffer ) );
+  cached_bytes += n;
+}
+
+// ---------------------------------------------------------------------------
+/// Free idle buffers, largest first, until at most max_bytes remain
+/**
+ * The caller must hold the mutex.
+ */
+void
+image_memory_pool::priv
+::trim( size_t max_bytes )
+{
+  for ( auto i = idle.rbegin(); i != idle.rend() && cached_bytes > max_bytes; ++i )
+  {
+    while ( !i->second.empty() && cached_bytes > max_bytes )
+    {
+      i->second.pop_back();
+      cached_bytes -= i->first;
+    }
+  }
+}
+
+// ===========================================================================
+image_memory_pool
+::image_memory_pool( size_t max_cached_bytes )
+  : d_( std::make_shared< priv >( max_cached_bytes ) )
+{
+}
+
+// ---------------------------------------------------------------------------
+image_memory_pool
+::~image_memory_pool()
+{
+}
+
+// ---------------------------------------------------------------------------
+image_memory_pool&
+image_memory_pool
+::instance()
+{
+  static image_memory_pool pool;
+  return pool;
+}
+
+// ---------------------------------------------------------------------------
+image_memory_sptr
+image_memory_pool
+::allocate( size_t n )
+{
+  return std::make_shared< priv::memory >( d_->acquire( n ), d_ );
+}
+
+// ---------------------------------------------------------------------------
+image
+image_memory_pool
+::create_image( size_t width, size_t height, size_t depth,
+                bool interleave, const image_pixel_traits& pt )
+{
+  image_memory_sptr const mem = allocate( width * height * depth * pt.num_bytes );
+
+  if ( interleave )
+  {
+    return image( mem, mem->data(), width, height, depth,
+                  depth, depth * width, 1, pt );
+  }
+
+  return image( mem, mem->data(), width, height, depth,
+                1, width, width * height, pt );
+}
+
+// ---------------------------------------------------------------------------
+void
+image_memory_pool
+::set_max_cached_bytes( size_t n )
+{
+  std::lock_guard< std::mutex > lock( d_->mutex );
+
+  d_->max_cached_bytes = n;
+  d_->trim( n );
+}
+
+// ---------------------------------------------------------------------------
+size_t
+image_memory_pool
+::max_cached_bytes() const
+{
+  std::lock_guard< std::mutex > lock( d_->mutex );
+
+  return d_->max_cached_bytes;
+}
+
+// ---------------------------------------------------------------------------
+size_t
+image_memory_pool
+::cached_bytes() const
+{
+  std::lock_guard< std::mutex > lock( d_->mutex );
+
+  return d_->cached_bytes;
+}
+
+// ---------------------------------------------------------------------------
+size_t
+image_memory_pool
+::allocation_count() const
+{
+  return d_->allocation_count;
+}
+
+// ---------------------------------------------------------------------------
+void
+image_memory_pool
+::clear()
+{
+  std::lock_guard< std::mutex > lock( d_->mutex );
+
+  d_->trim( 0 );
+}
+
+} } // end namespaces
@@ -0,0 +1,107 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Interface for a pool of recycled image memory
+ */
+
+#ifndef VITAL_IMAGE_MEMORY_POOL_H_
+#define VITAL_IMAGE_MEMORY_POOL_H_
+
+#include <vital/types/image.h>
+
+#include <vital/vital_export.h>
+#include <vital/noncopyable.h>
+
+#include <memory>
+
+namespace kwiver {
+namespace vital {
+
+// ===========================================================================
+/// A pool which recycles image memory buffers.
+/**
+ * Memory allocated from the pool is an ordinary image_memory object, but
+ * when the last reference to it is released its buffer returns to the
+ * pool instead of being freed.  Later requests for the same number of
+ * bytes reuse the buffer, so a stream of equally sized frames (e.g. from
+ * a video) reaches a steady state where no frame buffers are allocated.
+ *
+ * Buffers are keyed by their size in bytes, which is determined by the
+ * width, height, depth and pixel traits of the images stored in them.
+ * Like all image_memory, pooled buffers are aligned to
+ * image_memory::alignment bytes.
+ *
+ * The total size of the idle buffers held by the pool is bounded by
+ * max_cached_bytes(); buffers released beyond that are freed.  Memory
+ * may outlive the pool which allocated it; it is then freed normally.
+ *
+ * All member functions are thread-safe.
+ */
+class VITAL_EXPORT image_memory_pool
+  : private noncopyable
+{
+public:
+  /// The default bound on the size of idle buffers
+  static constexpr size_t default_max_cached_bytes = size_t( 512 ) << 20;
+
+  /// Constructor
+  /**
+   * \param max_cached_bytes The largest total size of idle buffers to keep.
+   */
+  explicit image_memory_pool( size_t max_cached_bytes = default_max_cached_bytes );
+
+  /// Destructor
+  ~image_memory_pool();
+
+  /// Access the process-wide pool
+  static image_memory_pool& instance();
+
+  /// Allocate n bytes of image memory
+  /**
+   * \param n bytes to allocate
+   */
+  image_memory_sptr allocate( size_t n );
+
+  /// Create an image whose memory comes from the pool
+  /**
+   * The memory layout matches that of the equivalent image constructor.
+   *
+   * \param width The width of the image in pixels
+   * \param height The height of the image in pixels
+   * \param depth The depth of the image (i.e. number of channels)
+   * \param interleave Set if the pixels are interleaved
+   * \param pt Change the pixel traits of the image
+   */
+  image create_image( size_t width, size_t height, size_t depth = 1,
+                      bool interleave = false,
+                      const image_pixel_traits& pt = image_pixel_traits() );
+
+  /// Set the largest total size of idle buffers to keep
+  /**
+   * Idle buffers beyond the new bound are freed immediately.
+   */
+  void set_max_cached_bytes( size_t n );
+
+  /// The largest total size of idle buffers to keep
+  size_t max_cached_bytes() const;
+
+  /// The total size of the idle buffers currently held
+  size_t cached_bytes() const;
+
+  /// The number of buffers which had to be allocated rather than reused
+  size_t allocation_count() const;
+
+  /// Free all idle buffers
+  void clear();
+
+private:
+  class priv;
+  std::shared_ptr< priv > d_;
+};
+
+} } // end namespaces
+
+#endif // VITAL_IMAGE_MEMORY_POOL_H_
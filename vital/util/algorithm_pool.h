@@ -0,0 +1,98 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief A pool of nested algorithm instances for concurrent tasks
+ */
+
+#ifndef KWIVER_VITAL_UTIL_ALGORITHM_POOL_H_
+#define KWIVER_VITAL_UTIL_ALGORITHM_POOL_H_
+
+#include <vital/config/config_block.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace kwiver {
+namespace vital {
+
+/// A pool of identically configured nested algorithms
+/**
+ * Algorithms are not generally safe to call from several threads at once,
+ * so each concurrent task takes its own instance with acquire() and returns
+ * it with release().  Instances are created on demand from the
+ * configuration, so the pool grows to the number of concurrent tasks.
+ */
+template <typename Algo>
+class algorithm_pool
+{
+public:
+  typedef std::shared_ptr<Algo> algo_sptr;
+
+  /// Set the configuration of new instances and drop existing ones
+  /**
+   * \param name    the nested algorithm name within \p config
+   * \param config  the configuration holding the nested algorithm
+   */
+  void configure(std::string const& name, config_block_sptr config)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    name_ = name;
+    config_ = config_block::empty_config();
+    config_->merge_config(config);
+    free_.clear();
+  }
+
+  /// Take an instance, creating one if none are free
+  /**
+   * \returns an instance, or nullptr if the configuration does not define
+   *          a valid algorithm
+   */
+  algo_sptr acquire()
+  {
+    config_block_sptr config;
+    std::string name;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!free_.empty())
+      {
+        algo_sptr algo = free_.back();
+        free_.pop_back();
+        return algo;
+      }
+      config = config_;
+      name = name_;
+    }
+    algo_sptr algo;
+    if (config)
+    {
+      Algo::set_nested_algo_configuration(name, config, algo);
+    }
+    return algo;
+  }
+
+  /// Return an instance taken with acquire()
+  void release(algo_sptr const& algo)
+  {
+    if (algo)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_.push_back(algo);
+    }
+  }
+
+private:
+  std::mutex mutex_;
+  std::string name_;
+  config_block_sptr config_;
+  std::vector<algo_sptr> free_;
+};
+
+} // end namespace vital
+} // end namespace kwiver
+
+#endif // KWIVER_VITAL_UTIL_ALGORITHM_POOL_H_
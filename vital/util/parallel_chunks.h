@@ -0,0 +1,105 @@
+// This file is part of KWIVER, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/kwiver/blob/master/LICENSE for details.
+
+/**
+ * \file
+ * \brief Split a loop into chunks processed on the thread pool
+ */
+
+#ifndef KWIVER_VITAL_UTIL_PARALLEL_CHUNKS_H_
+#define KWIVER_VITAL_UTIL_PARALLEL_CHUNKS_H_
+
+#include <vital/util/thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace kwiver {
+namespace vital {
+
+/// Call \p func over consecutive chunks of [0, \p n) on the thread pool
+/**
+ * \p func is called as func(begin, end) once for each chunk of at most
+ * \p chunk_size indices.  Chunks may run concurrently and in any order.
+ * The call returns once every chunk has been processed.  If any call to
+ * \p func throws, the first exception is rethrown here after the other
+ * chunks have finished.
+ *
+ * The calling thread works through chunks alongside the pool and then only
+ * waits for chunks that are already running, never for queued tasks, so
+ * this is safe to call from code which is itself running on the thread
+ * pool.
+ */
+template < typename Func >
+void
+parallel_chunks( size_t n, size_t chunk_size, Func const& func )
+{
+  struct state_t
+  {
+    std::atomic< size_t > next{ 0 };
+    size_t num_done = 0;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable cv;
+  };
+
+  chunk_size = std::max< size_t >( chunk_size, 1 );
+  size_t const num_chunks = ( n + chunk_size - 1 ) / chunk_size;
+  if( num_chunks == 0 )
+  {
+    return;
+  }
+
+  // Tasks which only start after all chunks are claimed return without
+  // touching func, so it is safe for them to outlive this call
+  auto const state = std::make_shared< state_t >();
+  auto const work = [ state, n, chunk_size, num_chunks, &func ]()
+  {
+    for( size_t c = state->next++; c < num_chunks; c = state->next++ )
+    {
+      std::exception_ptr error;
+      try
+      {
+        func( c * chunk_size, std::min( n, ( c + 1 ) * chunk_size ) );
+      }
+      catch( ... )
+      {
+        error = std::current_exception();
+      }
+
+      std::lock_guard< std::mutex > lock( state->mutex );
+      if( error && !state->error )
+      {
+        state->error = error;
+      }
+      if( ++state->num_done == num_chunks )
+      {
+        state->cv.notify_all();
+      }
+    }
+  };
+
+  auto& pool = thread_pool::instance();
+  size_t const num_tasks = std::min( pool.num_threads(), num_chunks - 1 );
+  for( size_t i = 0; i < num_tasks; ++i )
+  {
+    pool.enqueue( work );
+  }
+  work();
+
+  std::unique_lock< std::mutex > lock( state->mutex );
+  state->cv.wait( lock, [ & ]{ return state->num_done == num_chunks; } );
+  if( state->error )
+  {
+    std::rethrow_exception( state->error );
+  }
+}
+
+} } // end namespace
+
+#endif // KWIVER_VITAL_UTIL_PARALLEL_CHUNKS_H_
@@ -7,10 +7,13 @@
  * \brief test Vital thread pool class
  */
 
+#include <vital/util/parallel_chunks.h>
 #include <vital/util/thread_pool.h>
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <stdexcept>
 #include <vector>
 
 using namespace kwiver::vital;
@@ -68,3 +71,66 @@ INSTANTIATE_TEST_CASE_P(
   ,
   thread_pool_backend,
   ::testing::ValuesIn( thread_pool::available_backends() ) );
+
+// ----------------------------------------------------------------------------
+TEST(thread_pool, parallel_chunks)
+{
+  std::vector< std::atomic< int > > visits( 1000 );
+  for( auto& v : visits )
+  {
+    v = 0;
+  }
+
+  parallel_chunks( visits.size(), 7,
+    [&]( size_t begin, size_t end )
+    {
+      for( size_t i = begin; i < end; ++i )
+      {
+        ++visits[ i ];
+      }
+    } );
+
+  for( size_t i = 0; i < visits.size(); ++i )
+  {
+    EXPECT_EQ( 1, visits[ i ] ) << "index " << i;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Calling from inside pool tasks does not wait on tasks which can not run
+TEST(thread_pool, parallel_chunks_nested)
+{
+  auto& pool = thread_pool::instance();
+  std::atomic< size_t > total{ 0 };
+
+  std::vector< std::future< void > > futures;
+  for( size_t t = 0; t < 4 * pool.num_threads(); ++t )
+  {
+    futures.push_back( pool.enqueue( [&]()
+      {
+        parallel_chunks( 100, 10,
+          [&]( size_t begin, size_t end ) { total += end - begin; } );
+      } ) );
+  }
+  for( auto& f : futures )
+  {
+    f.get();
+  }
+
+  EXPECT_EQ( 400 * pool.num_threads(), total );
+}
+
+// ----------------------------------------------------------------------------
+TEST(thread_pool, parallel_chunks_exception)
+{
+  EXPECT_THROW(
+    parallel_chunks( 100, 10,
+      []( size_t begin, size_t )
+      {
+        if( begin == 50 )
+        {
+          throw std::runtime_error( "chunk failed" );
+        }
+      } ),
+    std::runtime_error );
+}